@@ -8,15 +8,22 @@
 #ifndef zego_queue_runner_hpp
 #define zego_queue_runner_hpp
 
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <zegoasyncall.h>
 #include <zegolock.h>
 #include <zegostd.h>
 #include <zegotask.h>
 
+#include "ZegoSmallJob.hpp"
+#include "ZegoTimerWheel.hpp"
+#include "ZegoTraceHook.hpp"
+
 #undef __MODULE__
 #define __MODULE__ "QueueRunner"
 
@@ -32,6 +39,145 @@ namespace BASE {
 
 using ZegoRunnable = std::function<void()>;
 
+/**
+ Completion state of CZegoQueueRunner::SyncRunLight, recycled through a small pool so a
+ synchronous call does not allocate its event. It stays alive until both the caller and every
+ copy of the posted job are gone, so a timed out wait never leaves the job with a dangling event.
+ */
+class CZegoSyncWaiter {
+  public:
+    /**
+     job handed to the target task, one pointer with a noexcept move so libc++ keeps it in
+     the std::function small buffer
+     */
+    struct Token {
+        explicit Token(CZegoSyncWaiter *waiter) : waiter_(waiter) {}
+        Token(const Token &other) : waiter_(other.waiter_) { waiter_->AddToken(); }
+        Token(Token &&other) noexcept : waiter_(other.waiter_) { other.waiter_ = nullptr; }
+        Token &operator=(const Token &) = delete;
+        ~Token() {
+            if (waiter_) {
+                waiter_->ReleaseToken();
+            }
+        }
+        void operator()() const { waiter_->Execute(); }
+
+      private:
+        CZegoSyncWaiter *waiter_;
+    };
+
+    static CZegoSyncWaiter *Acquire(ZegoRunnable &&job) {
+        CZegoSyncWaiter *waiter = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(PoolMutex());
+            std::vector<CZegoSyncWaiter *> &pool = Pool();
+            if (!pool.empty()) {
+                waiter = pool.back();
+                pool.pop_back();
+            }
+        }
+        if (!waiter) {
+            waiter = new CZegoSyncWaiter();
+        }
+        waiter->job_ = std::move(job);
+        waiter->tokens_ = 1;
+        waiter->waiting_ = true;
+        waiter->executed_ = false;
+        return waiter;
+    }
+
+    /**
+     wait until the job ran or was dropped by the task, then give up the caller reference
+
+     @param waitTimeInMiliseconds < 0 wait forever
+     @return true if the job ran
+     */
+    bool WaitAndRelease(int64 waitTimeInMiliseconds) {
+        bool executed = false;
+        bool recycle = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto finished = [this]() { return executed_ || tokens_ == 0; };
+            if (waitTimeInMiliseconds < 0) {
+                cv_.wait(lock, finished);
+            } else {
+                cv_.wait_for(lock, std::chrono::milliseconds(waitTimeInMiliseconds), finished);
+            }
+            executed = executed_;
+            waiting_ = false;
+            recycle = tokens_ == 0;
+        }
+        if (recycle) {
+            Recycle();
+        }
+        return executed;
+    }
+
+  private:
+    static const size_t kPoolCapacity = 32;
+
+    static std::mutex &PoolMutex() {
+        static std::mutex *mutex = new std::mutex();
+        return *mutex;
+    }
+
+    static std::vector<CZegoSyncWaiter *> &Pool() {
+        static std::vector<CZegoSyncWaiter *> *pool = new std::vector<CZegoSyncWaiter *>();
+        return *pool;
+    }
+
+    void Execute() {
+        if (job_) {
+            job_();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        executed_ = true;
+        cv_.notify_all();
+    }
+
+    void AddToken() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tokens_++;
+    }
+
+    void ReleaseToken() {
+        bool recycle = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--tokens_ == 0) {
+                if (waiting_) {
+                    cv_.notify_all();
+                } else {
+                    recycle = true;
+                }
+            }
+        }
+        if (recycle) {
+            Recycle();
+        }
+    }
+
+    void Recycle() {
+        job_ = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(PoolMutex());
+            std::vector<CZegoSyncWaiter *> &pool = Pool();
+            if (pool.size() < kPoolCapacity) {
+                pool.push_back(this);
+                return;
+            }
+        }
+        delete this;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    ZegoRunnable job_;
+    int tokens_ = 0;
+    bool waiting_ = false;
+    bool executed_ = false;
+};
+
 class CZegoQueueRunner {
   public:
     task_id AsyncRun(ZegoRunnable &&job, CZEGOTaskDefault *pTask,
@@ -50,6 +196,80 @@ class CZegoQueueRunner {
          */
     task_id Dispatch(ZegoRunnable &&job, CZEGOTaskDefault *pTask);
 
+    /**
+     AsyncRun that reports the job to CZegoTraceHook, with the time it waited in pTask's queue
+     and the time it ran. Same as AsyncRun while no trace sink is installed.
+
+     @param name job name in the trace, a string literal
+     */
+    task_id AsyncRunTraced(const char *name, ZegoRunnable &&job, CZEGOTaskDefault *pTask,
+                           task_priority priority = task_priority::task_priority_normal) {
+        if (CZegoTraceHook::Enabled()) {
+            return AsyncRun(CZegoTraceHook::Wrap(TraceCategory(), name, std::move(job)), pTask,
+                            priority);
+        }
+        return AsyncRun(std::move(job), pTask, priority);
+    }
+
+    /**
+     DelayRun on the shared timer wheel, for retry and heartbeat timers that are mostly cancelled
+     before they fire. Scheduling and cancelling are O(1) and never touch pTask; jobs up to
+     CZegoSmallJob::kInlineSize bytes do not allocate until they fire.
+     Call CancelDelayRuns() before this runner is destroyed.
+
+     @param job job to execute
+     @param pTask thread on which job execute
+     @param delayInMiliseconds delay before the job is posted to pTask
+     @return timer id for CancelDelayRun, never CZegoTimerWheel::kInvalidTimer
+     */
+    CZegoTimerWheel::TimerID DelayRunCancelable(CZegoSmallJob &&job, CZEGOTaskDefault *pTask,
+                                                int64 delayInMiliseconds) {
+        return CZegoTimerWheel::GetInstance()->Schedule(delayInMiliseconds, std::move(job),
+                                                        &CZegoQueueRunner::fire_timer, this, pTask);
+    }
+
+    /**
+     @return false if the timer already fired or was cancelled
+     */
+    bool CancelDelayRun(CZegoTimerWheel::TimerID timerID) {
+        return CZegoTimerWheel::GetInstance()->Cancel(timerID);
+    }
+
+    /**
+     cancel every pending DelayRunCancelable of this runner, and wait for one that is being
+     posted right now, so the wheel never touches this runner after it returns
+
+     @return number of timers cancelled
+     */
+    size_t CancelDelayRuns() { return CZegoTimerWheel::GetInstance()->CancelAll(this); }
+
+    /**
+     SyncRun without the per call shared event: the completion state comes from a pool and the
+     posted functor is a single pointer, small enough for the std::function buffer. Runs the
+     job in place when called on pTask thread. On timeout the job still runs later, like SyncRun.
+
+     @return true if the job ran before the wait ended
+     */
+    bool SyncRunLight(ZegoRunnable &&job, CZEGOTaskDefault *pTask,
+                      int64 waitTimeInMiliseconds = -1) {
+        if (CZegoTraceHook::Enabled()) {
+            job = CZegoTraceHook::Wrap(TraceCategory(), "sync_run", std::move(job));
+        }
+        CZegoSyncWaiter *waiter = CZegoSyncWaiter::Acquire(std::move(job));
+        Dispatch(CZegoSyncWaiter::Token(waiter), pTask);
+        return waiter->WaitAndRelease(waitTimeInMiliseconds);
+    }
+
+  private:
+    static const char *TraceCategory() { return "queue_runner"; }
+
+    static void fire_timer(void *context, void *target, CZegoSmallJob &&job) {
+        // std::function needs a copyable functor, the fired job is shared with it
+        std::shared_ptr<CZegoSmallJob> fired = std::make_shared<CZegoSmallJob>(std::move(job));
+        static_cast<CZegoQueueRunner *>(context)->AsyncRunTraced(
+            "delay_run", [fired]() { (*fired)(); }, static_cast<CZEGOTaskDefault *>(target));
+    }
+
   private:
     struct zego_functor_task : public zego_task_call_base {
         std::shared_ptr<void> _event;
@@ -0,0 +1,126 @@
+//
+//  ZegoSmallJob.hpp
+//  ZegoConnection
+//
+
+#ifndef zego_small_job_hpp
+#define zego_small_job_hpp
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ZEGO {
+namespace BASE {
+
+/**
+ Move-only void() callable. Lambdas up to kInlineSize bytes are stored in place, so posting
+ one does not allocate; bigger or throwing-move callables fall back to the heap.
+ */
+class CZegoSmallJob {
+  public:
+    static const size_t kInlineSize = 48;
+
+    CZegoSmallJob() : ops_(nullptr) {}
+
+    template <typename F, typename = typename std::enable_if<
+                              !std::is_same<typename std::decay<F>::type, CZegoSmallJob>::value>::type>
+    CZegoSmallJob(F &&f) : ops_(nullptr) {
+        typedef typename std::decay<F>::type Fn;
+        if (Fits<Fn>::value) {
+            new (storage_) Fn(std::forward<F>(f));
+            ops_ = &InlineOps<Fn>::ops;
+        } else {
+            *reinterpret_cast<Fn **>(storage_) = new Fn(std::forward<F>(f));
+            ops_ = &HeapOps<Fn>::ops;
+        }
+    }
+
+    CZegoSmallJob(CZegoSmallJob &&other) : ops_(nullptr) { MoveFrom(other); }
+
+    CZegoSmallJob &operator=(CZegoSmallJob &&other) {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    CZegoSmallJob(const CZegoSmallJob &) = delete;
+    CZegoSmallJob &operator=(const CZegoSmallJob &) = delete;
+
+    ~CZegoSmallJob() { Reset(); }
+
+    explicit operator bool() const { return ops_ != nullptr; }
+
+    void operator()() { ops_->invoke(storage_); }
+
+    void Reset() {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    bool IsInline() const { return ops_ && ops_->isInline; }
+
+  private:
+    struct Ops {
+        void (*invoke)(void *);
+        void (*move)(void *dst, void *src);
+        void (*destroy)(void *);
+        bool isInline;
+    };
+
+    template <typename Fn> struct Fits {
+        static const bool value = sizeof(Fn) <= kInlineSize &&
+                                  alignof(Fn) <= alignof(std::max_align_t) &&
+                                  std::is_nothrow_move_constructible<Fn>::value;
+    };
+
+    template <typename Fn> struct InlineOps {
+        static void Invoke(void *p) { (*static_cast<Fn *>(p))(); }
+        static void Move(void *dst, void *src) {
+            new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+            static_cast<Fn *>(src)->~Fn();
+        }
+        static void Destroy(void *p) { static_cast<Fn *>(p)->~Fn(); }
+        static const Ops ops;
+    };
+
+    template <typename Fn> struct HeapOps {
+        static void Invoke(void *p) { (**static_cast<Fn **>(p))(); }
+        static void Move(void *dst, void *src) {
+            *static_cast<Fn **>(dst) = *static_cast<Fn **>(src);
+        }
+        static void Destroy(void *p) { delete *static_cast<Fn **>(p); }
+        static const Ops ops;
+    };
+
+    void MoveFrom(CZegoSmallJob &other) {
+        if (other.ops_) {
+            other.ops_->move(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+    const Ops *ops_;
+};
+
+template <typename Fn>
+const CZegoSmallJob::Ops CZegoSmallJob::InlineOps<Fn>::ops = {
+    &CZegoSmallJob::InlineOps<Fn>::Invoke, &CZegoSmallJob::InlineOps<Fn>::Move,
+    &CZegoSmallJob::InlineOps<Fn>::Destroy, true};
+
+template <typename Fn>
+const CZegoSmallJob::Ops CZegoSmallJob::HeapOps<Fn>::ops = {
+    &CZegoSmallJob::HeapOps<Fn>::Invoke, &CZegoSmallJob::HeapOps<Fn>::Move,
+    &CZegoSmallJob::HeapOps<Fn>::Destroy, false};
+
+} // namespace BASE
+} // namespace ZEGO
+
+#endif /* zego_small_job_hpp */
@@ -0,0 +1,386 @@
+//
+//  ZegoTimerWheel.hpp
+//  ZegoConnection
+//
+
+#ifndef zego_timer_wheel_hpp
+#define zego_timer_wheel_hpp
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ZegoSmallJob.hpp"
+
+namespace ZEGO {
+namespace BASE {
+
+/**
+ Hierarchical timer wheel: 5 levels of 64 slots with a 1 ms tick, covering about 12 days.
+ Insert and cancel are O(1); cancel unlinks the node from its slot through a handle carrying
+ a generation, so a stale handle never cancels a reused node. Nodes live in a slab and the
+ jobs are stored inline, so a timer that is cancelled before it fires never allocates.
+
+ Due timers are handed to their dispatcher on the wheel thread, outside the wheel lock.
+ CancelAll(context) also waits for a dispatch of that context in progress, so the owner can
+ be destroyed once it returns.
+ */
+class CZegoTimerWheel {
+  public:
+    typedef uint64_t TimerID;
+    typedef void (*Dispatcher)(void *context, void *target, CZegoSmallJob &&job);
+
+    static const TimerID kInvalidTimer = 0;
+
+    static CZegoTimerWheel *GetInstance() {
+        // Intentionally leaked: timers may be cancelled during static destruction
+        static CZegoTimerWheel *instance = new CZegoTimerWheel();
+        return instance;
+    }
+
+    CZegoTimerWheel() {
+        for (int i = 0; i < kLevels; i++) {
+            occupied_[i] = 0;
+            for (int j = 0; j < kSlots; j++) {
+                slots_[i][j] = kNil;
+            }
+        }
+        start_ = std::chrono::steady_clock::now();
+        thread_ = std::thread([this]() { Run(); });
+    }
+
+    ~CZegoTimerWheel() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    /**
+     Schedule [job] to be dispatched after [delayMs]. A null dispatcher runs the job on the
+     wheel thread, which is only suitable for short jobs.
+     */
+    TimerID Schedule(int64_t delayMs, CZegoSmallJob &&job, Dispatcher dispatcher = nullptr,
+                     void *context = nullptr, void *target = nullptr) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint32_t index = AllocNode();
+        Node &node = nodes_[index];
+        node.job = std::move(job);
+        node.dispatcher = dispatcher;
+        node.context = context;
+        node.target = target;
+        uint64_t now = NowTick();
+        // The tick clock is floored, one extra tick keeps timers from firing early.
+        // Ticks the wheel has not processed yet are still ahead of current_
+        node.expires = (now > current_ ? now : current_) + (delayMs > 0 ? delayMs : 0) + 1;
+        Link(index);
+        TimerID id = MakeID(index, node.generation);
+        bool wake = node.expires < wake_tick_;
+        if (wake) {
+            // Later timers scheduled before the thread wakes up need no extra notify
+            wake_tick_ = node.expires;
+        }
+        lock.unlock();
+        if (wake) {
+            cv_.notify_one();
+        }
+        return id;
+    }
+
+    /**
+     Cancel a pending timer. Returns false if it already fired or was cancelled.
+     */
+    bool Cancel(TimerID id) {
+        CZegoSmallJob job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+            uint32_t generation = static_cast<uint32_t>(id >> 32);
+            if (index >= nodes_.size() || nodes_[index].generation != generation ||
+                !nodes_[index].linked) {
+                return false;
+            }
+            Unlink(index);
+            job = std::move(nodes_[index].job);
+            FreeNode(index);
+        }
+        // The job and what it captured are destroyed outside the lock
+        return true;
+    }
+
+    /**
+     Cancel every pending timer scheduled with [context], including due timers not dispatched
+     yet, and wait until a dispatch of [context] in progress has returned. No dispatcher is
+     called with [context] after this returns. O(pending timers), meant for owner teardown.
+     Called from a dispatcher on the wheel thread it does not wait for that dispatch.
+     */
+    size_t CancelAll(void *context) {
+        std::vector<CZegoSmallJob> jobs;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (uint32_t i = 0; i < nodes_.size(); i++) {
+                if (nodes_[i].linked && nodes_[i].context == context) {
+                    Unlink(i);
+                    jobs.push_back(std::move(nodes_[i].job));
+                    FreeNode(i);
+                }
+            }
+            for (auto &item : due_) {
+                if (!item.done && item.context == context) {
+                    jobs.push_back(std::move(item.job));
+                    item.done = true;
+                }
+            }
+            if (std::this_thread::get_id() != thread_.get_id()) {
+                cancel_waiters_++;
+                dispatch_cv_.wait(lock, [this, context]() {
+                    return !dispatching_ || dispatching_context_ != context;
+                });
+                cancel_waiters_--;
+            }
+        }
+        return jobs.size();
+    }
+
+    size_t PendingCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pending_;
+    }
+
+  private:
+    static const int kLevels = 5;
+    static const int kSlotBits = 6;
+    static const int kSlots = 1 << kSlotBits;
+    static const uint32_t kNil = 0xFFFFFFFFu;
+
+    struct Node {
+        CZegoSmallJob job;
+        Dispatcher dispatcher = nullptr;
+        void *context = nullptr;
+        void *target = nullptr;
+        uint64_t expires = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t generation = 1;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool linked = false;
+    };
+
+    struct Due {
+        CZegoSmallJob job;
+        Dispatcher dispatcher;
+        void *context;
+        void *target;
+        bool done;
+    };
+
+    static TimerID MakeID(uint32_t index, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | index;
+    }
+
+    uint64_t NowTick() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::steady_clock::now() - start_)
+                                         .count());
+    }
+
+    uint32_t AllocNode() {
+        if (free_ != kNil) {
+            uint32_t index = free_;
+            free_ = nodes_[index].next;
+            return index;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void FreeNode(uint32_t index) {
+        Node &node = nodes_[index];
+        node.generation = node.generation + 1 == 0 ? 1 : node.generation + 1;
+        node.dispatcher = nullptr;
+        node.context = nullptr;
+        node.target = nullptr;
+        node.next = free_;
+        free_ = index;
+    }
+
+    void Link(uint32_t index) {
+        Node &node = nodes_[index];
+        const uint64_t range = 1ull << (kSlotBits * kLevels);
+        uint64_t at = node.expires;
+        uint64_t delta = at - current_;
+        if (delta >= range) {
+            // Beyond the wheel range, parked in the farthest slot and re-cascaded later
+            delta = range - 1;
+            at = current_ + delta;
+        }
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (1ull << (kSlotBits * (level + 1)))) {
+            level++;
+        }
+        int slot = static_cast<int>((at >> (kSlotBits * level)) & (kSlots - 1));
+        node.level = static_cast<uint8_t>(level);
+        node.slot = static_cast<uint8_t>(slot);
+        node.prev = kNil;
+        node.next = slots_[level][slot];
+        if (node.next != kNil) {
+            nodes_[node.next].prev = index;
+        }
+        slots_[level][slot] = index;
+        occupied_[level] |= 1ull << slot;
+        node.linked = true;
+        pending_++;
+    }
+
+    void Unlink(uint32_t index) {
+        Node &node = nodes_[index];
+        if (node.prev != kNil) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            slots_[node.level][node.slot] = node.next;
+            if (node.next == kNil) {
+                occupied_[node.level] &= ~(1ull << node.slot);
+            }
+        }
+        if (node.next != kNil) {
+            nodes_[node.next].prev = node.prev;
+        }
+        node.prev = node.next = kNil;
+        node.linked = false;
+        pending_--;
+    }
+
+    // Re-insert every timer of an upper level slot, they land in lower levels now
+    void Cascade(int level, int slot) {
+        uint32_t index = slots_[level][slot];
+        slots_[level][slot] = kNil;
+        occupied_[level] &= ~(1ull << slot);
+        while (index != kNil) {
+            uint32_t next = nodes_[index].next;
+            nodes_[index].linked = false;
+            pending_--;
+            Link(index);
+            index = next;
+        }
+    }
+
+    void AdvanceTo(uint64_t now, std::vector<Due> &due) {
+        while (current_ < now) {
+            if (pending_ == 0) {
+                current_ = now;
+                break;
+            }
+            current_++;
+            int slot = static_cast<int>(current_ & (kSlots - 1));
+            for (int level = 1; slot == 0 && level < kLevels; level++) {
+                slot = static_cast<int>((current_ >> (kSlotBits * level)) & (kSlots - 1));
+                Cascade(level, slot);
+            }
+            slot = static_cast<int>(current_ & (kSlots - 1));
+            uint32_t index = slots_[0][slot];
+            while (index != kNil) {
+                uint32_t next = nodes_[index].next;
+                Node &node = nodes_[index];
+                Unlink(index);
+                if (node.expires > current_) {
+                    // Parked beyond the wheel range
+                    Link(index);
+                } else {
+                    due.push_back(Due{std::move(node.job), node.dispatcher, node.context,
+                                      node.target, false});
+                    FreeNode(index);
+                }
+                index = next;
+            }
+        }
+    }
+
+    // Ticks until the next level 0 slot that may hold a timer, or the next cascade
+    uint64_t NextWakeTick() const {
+        if (pending_ == 0) {
+            return UINT64_MAX;
+        }
+        if (occupied_[0] != 0) {
+            for (uint64_t t = current_ + 1; t <= current_ + kSlots; t++) {
+                if (occupied_[0] & (1ull << (t & (kSlots - 1)))) {
+                    return t;
+                }
+            }
+        }
+        return (current_ | (kSlots - 1)) + 1;
+    }
+
+    // Due timers stay in due_ until dispatched, CancelAll can still take them out meanwhile
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            AdvanceTo(NowTick(), due_);
+            wake_tick_ = NextWakeTick();
+            if (!due_.empty()) {
+                for (size_t i = 0; i < due_.size(); i++) {
+                    Due &item = due_[i];
+                    if (item.done) {
+                        continue;
+                    }
+                    item.done = true;
+                    CZegoSmallJob job = std::move(item.job);
+                    Dispatcher dispatcher = item.dispatcher;
+                    void *context = item.context;
+                    void *target = item.target;
+                    dispatching_ = true;
+                    dispatching_context_ = context;
+                    lock.unlock();
+                    if (dispatcher) {
+                        dispatcher(context, target, std::move(job));
+                    } else {
+                        job();
+                    }
+                    job.Reset();
+                    lock.lock();
+                    dispatching_ = false;
+                    dispatching_context_ = nullptr;
+                    if (cancel_waiters_ > 0) {
+                        dispatch_cv_.notify_all();
+                    }
+                }
+                due_.clear();
+                continue;
+            }
+            if (wake_tick_ == UINT64_MAX) {
+                cv_.wait(lock);
+            } else {
+                cv_.wait_until(lock, start_ + std::chrono::milliseconds(wake_tick_));
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable dispatch_cv_;
+    std::thread thread_;
+    bool stop_ = false;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t current_ = 0;
+    uint64_t wake_tick_ = UINT64_MAX;
+    size_t pending_ = 0;
+    std::vector<Due> due_;
+    bool dispatching_ = false;
+    void *dispatching_context_ = nullptr;
+    int cancel_waiters_ = 0;
+    std::vector<Node> nodes_;
+    uint32_t free_ = kNil;
+    uint32_t slots_[kLevels][kSlots];
+    uint64_t occupied_[kLevels];
+};
+
+} // namespace BASE
+} // namespace ZEGO
+
+#endif /* zego_timer_wheel_hpp */
@@ -0,0 +1,90 @@
+//
+//  ZegoTraceHook.hpp
+//  ZegoConnection
+//
+
+#ifndef zego_trace_hook_hpp
+#define zego_trace_hook_hpp
+
+#include <atomic>
+#include <chrono>
+#include <utility>
+
+namespace ZEGO {
+namespace BASE {
+
+/**
+ Optional trace output for CZegoQueueRunner jobs and ZegoConnectionThreadPool tasks. Nothing is
+ measured until a sink is installed; after that every traced job reports one complete event
+ with std::chrono::steady_clock nanosecond timestamps. The signature matches
+ ZegoExpressSDK::addCallbackTraceEvent, so installing it puts the jobs on the same Perfetto
+ timeline as the Express callbacks.
+
+ category and name are kept by the sink, pass string literals.
+ */
+class CZegoTraceHook {
+  public:
+    typedef void (*Sink)(const char *category, const char *name, long long beginNs,
+                         long long durationNs, long long queueNs);
+
+    /**
+     @param sink nullptr to stop tracing
+     */
+    static void SetSink(Sink sink) { SinkSlot().store(sink, std::memory_order_release); }
+
+    static bool Enabled() { return SinkSlot().load(std::memory_order_relaxed) != nullptr; }
+
+    static long long NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     @param queueNs time the job waited before it started, < 0 if unknown
+     */
+    static void Complete(const char *category, const char *name, long long beginNs,
+                         long long endNs, long long queueNs) {
+        Sink sink = SinkSlot().load(std::memory_order_acquire);
+        if (sink) {
+            sink(category, name, beginNs, endNs - beginNs, queueNs);
+        }
+    }
+
+    /**
+     job wrapper that remembers when it was created and reports its queueing delay and run time
+     */
+    template <typename Job> class Traced {
+      public:
+        Traced(const char *category, const char *name, Job job)
+            : category_(category), name_(name), posted_(NowNs()), job_(std::move(job)) {}
+
+        void operator()() {
+            long long begin = NowNs();
+            job_();
+            Complete(category_, name_, begin, NowNs(), begin - posted_);
+        }
+
+      private:
+        const char *category_;
+        const char *name_;
+        long long posted_;
+        Job job_;
+    };
+
+    template <typename Job>
+    static Traced<Job> Wrap(const char *category, const char *name, Job job) {
+        return Traced<Job>(category, name, std::move(job));
+    }
+
+  private:
+    static std::atomic<Sink> &SinkSlot() {
+        static std::atomic<Sink> sink{nullptr};
+        return sink;
+    }
+};
+
+} // namespace BASE
+} // namespace ZEGO
+
+#endif /* zego_trace_hook_hpp */
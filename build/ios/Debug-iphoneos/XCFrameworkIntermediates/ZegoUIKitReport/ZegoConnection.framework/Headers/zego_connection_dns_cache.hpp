@@ -0,0 +1,796 @@
+#ifndef zego_connection_dns_cache_hpp
+#define zego_connection_dns_cache_hpp
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "leveldb/db.h"
+#include "leveldb/iterator.h"
+#include "leveldb/options.h"
+#include "zego_connection_dns.hpp"
+#include "zego_connection_thread_pool.hpp"
+
+/*
+  ZegoDNSCache: ZegoConnectionDNS 之上的持久化解析缓存
+  1、解析结果写入 leveldb，重启后直接使用，冷启动不再等待 DNS
+  2、stale-while-revalidate: freshTTL 内直接返回；过期但在 staleTTL 内先返回旧结果，同时在阻塞线程后台刷新；
+     刷新失败保留旧结果。同一域名同时只有一个解析，其他调用等待该结果
+  3、ZegoHappyEyeballs 按 RFC 8305 交替 IPv6/IPv4 发起非阻塞 TCP 连接，间隔 attemptDelayMs 错峰，先连上的胜出
+*/
+namespace ZEGO
+{
+
+namespace CONNECTION
+{
+    class ZegoHappyEyeballs
+    {
+    public:
+        /**
+        按协议族交替排列地址，各协议族内保持原有顺序
+
+        @param ips 候选地址
+        @param preferIPv6 首个地址的协议族
+        @return 排列后的地址
+        */
+        static std::vector<IP2Type> Interleave(const std::vector<IP2Type>& ips, bool preferIPv6)
+        {
+            std::vector<IP2Type> v4, v6, ordered;
+            for (const auto& ip : ips)
+            {
+                (IsIPv6(ip.first) ? v6 : v4).push_back(ip);
+            }
+            const std::vector<IP2Type>& first = preferIPv6 ? v6 : v4;
+            const std::vector<IP2Type>& second = preferIPv6 ? v4 : v6;
+            for (size_t i = 0; i < first.size() || i < second.size(); i++)
+            {
+                if (i < first.size())
+                {
+                    ordered.push_back(first[i]);
+                }
+                if (i < second.size())
+                {
+                    ordered.push_back(second[i]);
+                }
+            }
+            return ordered;
+        }
+
+        /**
+        对候选地址做 TCP 连接竞速
+
+        @param ips 候选地址，按 Interleave 之后的顺序依次发起
+        @param port 目标端口
+        @param config 竞速配置
+        @return 竞速结果，error 为 kZCSuccess 时 ip 为最先连上的地址
+        @notce 阻塞调用，最长 config.timeoutMs，应在 JOB_MAYBE_BLOCK 任务中调用
+        */
+        static HappyEyeballsResult Connect(const std::vector<IP2Type>& ips, uint16 port, const HappyEyeballsConfig& config = HappyEyeballsConfig())
+        {
+            using Clock = std::chrono::steady_clock;
+            HappyEyeballsResult result;
+            if (ips.empty() || port == 0)
+            {
+                result.error = kZCEInvalidParams;
+                return result;
+            }
+
+            std::vector<IP2Type> order = Interleave(ips, config.preferIPv6);
+            std::vector<Attempt> active;
+            const Clock::time_point start = Clock::now();
+            const Clock::time_point deadline = start + std::chrono::milliseconds(config.timeoutMs);
+            Clock::time_point nextStart = start;
+            size_t next = 0;
+            int winner = -1;
+
+            while (winner < 0)
+            {
+                Clock::time_point now = Clock::now();
+                if (now >= deadline)
+                {
+                    result.error = kZCETCPDetectTimeout;
+                    break;
+                }
+                if (next < order.size() && (active.empty() || now >= nextStart))
+                {
+                    Attempt attempt;
+                    attempt.ip = order[next++];
+                    result.attempts++;
+                    bool connected = false;
+                    if (StartConnect(attempt, port, connected))
+                    {
+                        active.push_back(attempt);
+                        if (connected)
+                        {
+                            winner = static_cast<int>(active.size()) - 1;
+                            break;
+                        }
+                        nextStart = now + std::chrono::milliseconds(config.attemptDelayMs);
+                    }
+                    // 发起失败时立即尝试下一个地址
+                    continue;
+                }
+                if (active.empty())
+                {
+                    result.error = kZCETCPDetectConnectFailed;
+                    break;
+                }
+
+                Clock::time_point wakeup = deadline;
+                if (next < order.size() && nextStart < wakeup)
+                {
+                    wakeup = nextStart;
+                }
+                int waitMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(wakeup - now).count()) + 1;
+
+                std::vector<pollfd> fds(active.size());
+                for (size_t i = 0; i < active.size(); i++)
+                {
+                    fds[i].fd = active[i].sock;
+                    fds[i].events = POLLOUT;
+                    fds[i].revents = 0;
+                }
+                if (PollSockets(fds.data(), fds.size(), waitMs) <= 0)
+                {
+                    continue;
+                }
+                bool failed = false;
+                for (size_t i = fds.size(); i-- > 0;)
+                {
+                    if (fds[i].revents == 0)
+                    {
+                        continue;
+                    }
+                    if ((fds[i].revents & POLLOUT) && SocketError(active[i].sock) == 0)
+                    {
+                        winner = static_cast<int>(i);
+                        break;
+                    }
+                    CloseSocket(active[i].sock);
+                    active.erase(active.begin() + i);
+                    failed = true;
+                }
+                if (failed && winner < 0)
+                {
+                    // 有连接失败时不必等满间隔
+                    nextStart = Clock::now();
+                }
+            }
+
+            for (size_t i = 0; i < active.size(); i++)
+            {
+                if (static_cast<int>(i) == winner)
+                {
+                    result.error = kZCSuccess;
+                    result.ip = active[i].ip;
+                    if (config.keepSocket)
+                    {
+                        result.socket = static_cast<int64>(active[i].sock);
+                        continue;
+                    }
+                }
+                CloseSocket(active[i].sock);
+            }
+            result.costMs = static_cast<uint32>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+            return result;
+        }
+
+        static bool IsIPv6(const std::string& ip)
+        {
+            return ip.find(':') != std::string::npos;
+        }
+
+    private:
+#if defined(_WIN32)
+        using SocketHandle = SOCKET;
+        static const SocketHandle kInvalidSocket = INVALID_SOCKET;
+#else
+        using SocketHandle = int;
+        static const SocketHandle kInvalidSocket = -1;
+#endif
+
+        struct Attempt
+        {
+            IP2Type ip;
+            SocketHandle sock = kInvalidSocket;
+        };
+
+        static void CloseSocket(SocketHandle sock)
+        {
+#if defined(_WIN32)
+            closesocket(sock);
+#else
+            close(sock);
+#endif
+        }
+
+        static int PollSockets(pollfd* fds, size_t count, int waitMs)
+        {
+#if defined(_WIN32)
+            return WSAPoll(fds, static_cast<ULONG>(count), waitMs);
+#else
+            return poll(fds, static_cast<nfds_t>(count), waitMs);
+#endif
+        }
+
+        static int SocketError(SocketHandle sock)
+        {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            if (getsockopt(sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &len) != 0)
+            {
+                return -1;
+            }
+            return error;
+        }
+
+        static bool StartConnect(Attempt& attempt, uint16 port, bool& connected)
+        {
+            sockaddr_storage addr;
+            memset(&addr, 0, sizeof(addr));
+            socklen_t addrLen = 0;
+            int family = IsIPv6(attempt.ip.first) ? AF_INET6 : AF_INET;
+            if (family == AF_INET6)
+            {
+                sockaddr_in6* sin6 = reinterpret_cast<sockaddr_in6*>(&addr);
+                sin6->sin6_family = AF_INET6;
+                sin6->sin6_port = htons(port);
+                if (inet_pton(AF_INET6, attempt.ip.first.c_str(), &sin6->sin6_addr) != 1)
+                {
+                    return false;
+                }
+                addrLen = sizeof(sockaddr_in6);
+            }
+            else
+            {
+                sockaddr_in* sin = reinterpret_cast<sockaddr_in*>(&addr);
+                sin->sin_family = AF_INET;
+                sin->sin_port = htons(port);
+                if (inet_pton(AF_INET, attempt.ip.first.c_str(), &sin->sin_addr) != 1)
+                {
+                    return false;
+                }
+                addrLen = sizeof(sockaddr_in);
+            }
+
+            SocketHandle sock = socket(family, SOCK_STREAM, IPPROTO_TCP);
+            if (sock == kInvalidSocket)
+            {
+                return false;
+            }
+#if defined(_WIN32)
+            u_long nonBlocking = 1;
+            ioctlsocket(sock, FIONBIO, &nonBlocking);
+#else
+            fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+            int ret = connect(sock, reinterpret_cast<sockaddr*>(&addr), addrLen);
+            if (ret == 0)
+            {
+                connected = true;
+            }
+            else
+            {
+#if defined(_WIN32)
+                bool inProgress = WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+                bool inProgress = errno == EINPROGRESS;
+#endif
+                if (!inProgress)
+                {
+                    CloseSocket(sock);
+                    return false;
+                }
+            }
+            attempt.sock = sock;
+            return true;
+        }
+    };
+
+    class ZegoDNSCache : public std::enable_shared_from_this<ZegoDNSCache>
+    {
+    public:
+        using Resolver = std::function<DNSData(const std::string& domain, int32 timeout)>;
+        using Executor = std::function<bool(std::function<void()>&& job)>;
+
+        static std::shared_ptr<ZegoDNSCache> GetInstance()
+        {
+            static std::shared_ptr<ZegoDNSCache> instance(new ZegoDNSCache());
+            return instance;
+        }
+
+        /**
+        创建独立的缓存实例，不与 GetInstance 共享数据
+        */
+        static std::shared_ptr<ZegoDNSCache> Create()
+        {
+            return std::shared_ptr<ZegoDNSCache>(new ZegoDNSCache());
+        }
+
+        ~ZegoDNSCache()
+        {
+            UnInit();
+        }
+
+        /**
+        初始化，打开磁盘缓存并载入仍在 staleTTL 内的结果
+
+        @param config 缓存配置
+        @param resolver 实际解析函数，为空时使用 ZegoConnectionDNS::DNSResolve(domain, timeout, true)
+        @param executor 后台刷新的执行器，返回任务是否投递成功，为空时投递到 ZegoConnectionThreadPool 的阻塞任务
+        @return 返回错误码，磁盘缓存打开失败时返回 kZCEOpenFileFailed，此时仍可作为内存缓存使用
+        */
+        ZCError Init(const DNSCacheConfig& config, const Resolver& resolver = nullptr, const Executor& executor = nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            CloseDBLocked();
+            config_ = config;
+            resolver_ = resolver ? resolver : DefaultResolver();
+            executor_ = executor ? executor : DefaultExecutor();
+            if (config_.path.empty())
+            {
+                return kZCSuccess;
+            }
+
+            leveldb::Options options;
+            options.create_if_missing = true;
+            leveldb::Status status = leveldb::DB::Open(options, config_.path, &db_);
+            if (!status.ok())
+            {
+                // 缓存可以丢弃，损坏时重建
+                leveldb::DestroyDB(config_.path, options);
+                status = leveldb::DB::Open(options, config_.path, &db_);
+            }
+            if (!status.ok())
+            {
+                db_ = nullptr;
+                return kZCEOpenFileFailed;
+            }
+            LoadLocked();
+            return kZCSuccess;
+        }
+
+        void UnInit()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            CloseDBLocked();
+        }
+
+        /**
+        解析域名
+
+        @param domain 域名
+        @return DNS解析结果，命中缓存时 localEvent->isMemoryCache 为 true
+        @notce 有可用缓存时不会阻塞；没有时与 DNSResolve 一样同步等待，同一域名的并发调用只解析一次，
+               等待其他调用的解析最多 resolveTimeoutMs。未 Init 时按默认配置解析，不使用磁盘缓存
+        */
+        DNSData Resolve(const std::string& domain)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            uint64 now = NowMs();
+            auto it = entries_.find(domain);
+            if (it != entries_.end())
+            {
+                uint64 age = now > it->second.resolvedAt ? now - it->second.resolvedAt : 0;
+                if (age <= config_.freshTTLMs)
+                {
+                    stats_.freshHits++;
+                    return ToDNSData(domain, it->second, now);
+                }
+                if (age <= static_cast<uint64>(config_.freshTTLMs) + config_.staleTTLMs)
+                {
+                    stats_.staleHits++;
+                    DNSData data = ToDNSData(domain, it->second, now);
+                    StartRefresh(lock, domain);
+                    return data;
+                }
+            }
+
+            std::shared_ptr<Inflight> inflight;
+            auto running = inflight_.find(domain);
+            if (running != inflight_.end())
+            {
+                stats_.coalesced++;
+                inflight = running->second;
+                auto done = [&inflight]() { return inflight->done; };
+                if (config_.resolveTimeoutMs <= 0)
+                {
+                    inflight->cv.wait(lock, done);
+                }
+                else if (!inflight->cv.wait_for(lock, std::chrono::milliseconds(config_.resolveTimeoutMs), done))
+                {
+                    // 正在进行的解析超时未返回，有超过 staleTTL 的旧结果时返回旧结果
+                    auto stale = entries_.find(domain);
+                    if (stale != entries_.end())
+                    {
+                        return ToDNSData(domain, stale->second, NowMs());
+                    }
+                    DNSData data;
+                    data.domain = domain;
+                    return data;
+                }
+                return inflight->data;
+            }
+
+            stats_.misses++;
+            inflight = std::make_shared<Inflight>();
+            inflight_[domain] = inflight;
+            Resolver resolver = resolver_;
+            int32 timeout = config_.resolveTimeoutMs;
+            lock.unlock();
+
+            DNSData data = resolver(domain, timeout);
+
+            lock.lock();
+            CompleteLocked(domain, inflight, data, false);
+            return inflight->data;
+        }
+
+        /**
+        解析域名并对结果做 Happy Eyeballs 连接竞速
+
+        @param domain 域名
+        @param port 目标端口
+        @param config 竞速配置，上次连通的地址所在协议族优先
+        @return 竞速结果，成功时胜出地址排到缓存结果的最前面
+        @notce 阻塞调用，应在 JOB_MAYBE_BLOCK 任务中调用
+        */
+        HappyEyeballsResult ResolveAndConnect(const std::string& domain, uint16 port, const HappyEyeballsConfig& config = HappyEyeballsConfig())
+        {
+            DNSData data = Resolve(domain);
+            std::vector<IP2Type> ips;
+            HappyEyeballsConfig raceConfig = config;
+            for (const auto& item : data.ipList)
+            {
+                if (item.category == DNSCategory::Reached && ips.empty())
+                {
+                    raceConfig.preferIPv6 = ZegoHappyEyeballs::IsIPv6(item.ip.first);
+                }
+                if (item.category != DNSCategory::UnReached && item.category != DNSCategory::UnTrust)
+                {
+                    ips.push_back(item.ip);
+                }
+            }
+            if (ips.empty())
+            {
+                // 全部不可达时仍然全部尝试
+                for (const auto& item : data.ipList)
+                {
+                    ips.push_back(item.ip);
+                }
+            }
+            if (ips.empty())
+            {
+                HappyEyeballsResult result;
+                result.error = kZCEDNSResolve;
+                return result;
+            }
+
+            HappyEyeballsResult result = ZegoHappyEyeballs::Connect(ips, port, raceConfig);
+            if (result.error == kZCSuccess)
+            {
+                Feedback(domain, result.ip.first, DNSUpdateType::Reached);
+            }
+            return result;
+        }
+
+        /**
+        更新地址的连通结果，Reached 的地址排到最前面，Unreach/Untrust 的地址排到最后面
+
+        @param domain 域名
+        @param ip 地址
+        @param type 连通结果
+        */
+        void Feedback(const std::string& domain, const std::string& ip, DNSUpdateType type)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(domain);
+            if (it == entries_.end())
+            {
+                return;
+            }
+            std::vector<DNSIP>& ips = it->second.ips;
+            auto found = std::find_if(ips.begin(), ips.end(), [&ip](const DNSIP& item) { return item.ip.first == ip; });
+            if (found == ips.end())
+            {
+                return;
+            }
+            DNSIP item = *found;
+            ips.erase(found);
+            if (type == DNSUpdateType::Reached)
+            {
+                item.category = DNSCategory::Reached;
+                ips.insert(ips.begin(), item);
+            }
+            else
+            {
+                item.category = type == DNSUpdateType::Untrust ? DNSCategory::UnTrust : DNSCategory::UnReached;
+                ips.push_back(item);
+            }
+            PersistLocked(domain, it->second);
+        }
+
+        /**
+        删除域名的缓存结果
+        */
+        void Invalidate(const std::string& domain)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_.erase(domain);
+            if (db_)
+            {
+                db_->Delete(leveldb::WriteOptions(), KeyOf(domain));
+            }
+        }
+
+        DNSCacheStats GetStats()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return stats_;
+        }
+
+    private:
+        ZegoDNSCache() : resolver_(DefaultResolver()), executor_(DefaultExecutor()) {}
+
+        struct Entry
+        {
+            uint64 resolvedAt = 0;  // 系统时间，单位ms，重启后仍然有效
+            std::vector<DNSIP> ips;
+        };
+
+        struct Inflight
+        {
+            bool done = false;
+            DNSData data;
+            std::condition_variable cv;
+        };
+
+        static Resolver DefaultResolver()
+        {
+            return [](const std::string& domain, int32 timeout) {
+                return ZegoConnectionDNS::GetInstance()->DNSResolve(domain, timeout, true);
+            };
+        }
+
+        static Executor DefaultExecutor()
+        {
+            return [](std::function<void()>&& job) {
+                return ZegoConnectionThreadPool::GetInstance()->RunTask(std::move(job), JOB_MAYBE_BLOCK) != 0;
+            };
+        }
+
+        static uint64 NowMs()
+        {
+            return static_cast<uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        static std::string KeyOf(const std::string& domain)
+        {
+            return "dns:" + domain;
+        }
+
+        static DNSData ToDNSData(const std::string& domain, const Entry& entry, uint64 now)
+        {
+            DNSData data;
+            data.domain = domain;
+            data.ipList = entry.ips;
+            data.startTime = now;
+            data.finishTime = now;
+            data.localEvent = std::make_shared<LocalDNSEventData>();
+            data.localEvent->startTime = now;
+            data.localEvent->finishTime = now;
+            data.localEvent->isMemoryCache = true;
+            return data;
+        }
+
+        // 协议族按 4/6 落盘，AF_INET6 的取值各平台不同
+        static std::string Serialize(const Entry& entry)
+        {
+            std::ostringstream out;
+            out << "v1 " << entry.resolvedAt << "\n";
+            for (const auto& item : entry.ips)
+            {
+                out << static_cast<int>(item.souce) << " " << static_cast<int>(item.category) << " "
+                    << (ZegoHappyEyeballs::IsIPv6(item.ip.first) ? 6 : 4) << " " << item.ip.first << "\n";
+            }
+            return out.str();
+        }
+
+        static bool Deserialize(const std::string& value, Entry& entry)
+        {
+            std::istringstream in(value);
+            std::string version;
+            if (!(in >> version >> entry.resolvedAt) || version != "v1")
+            {
+                return false;
+            }
+            int source = 0, category = 0, family = 0;
+            std::string ip;
+            while (in >> source >> category >> family >> ip)
+            {
+                DNSIP item;
+                item.souce = static_cast<DNSSource>(source);
+                item.category = static_cast<DNSCategory>(category);
+                item.ip = IP2Type(ip, family == 6 ? AF_INET6 : AF_INET);
+                entry.ips.push_back(item);
+            }
+            return !entry.ips.empty();
+        }
+
+        void LoadLocked()
+        {
+            uint64 now = NowMs();
+            uint64 maxAge = static_cast<uint64>(config_.freshTTLMs) + config_.staleTTLMs;
+            std::vector<std::string> expired;
+            std::unique_ptr<leveldb::Iterator> iter(db_->NewIterator(leveldb::ReadOptions()));
+            for (iter->Seek("dns:"); iter->Valid() && iter->key().starts_with("dns:"); iter->Next())
+            {
+                std::string domain = iter->key().ToString().substr(4);
+                Entry entry;
+                if (!Deserialize(iter->value().ToString(), entry) || (now > entry.resolvedAt && now - entry.resolvedAt > maxAge))
+                {
+                    expired.push_back(iter->key().ToString());
+                    continue;
+                }
+                entries_[domain] = entry;
+                stats_.diskLoaded++;
+            }
+            iter.reset();
+            for (const auto& key : expired)
+            {
+                db_->Delete(leveldb::WriteOptions(), key);
+            }
+        }
+
+        void PersistLocked(const std::string& domain, const Entry& entry)
+        {
+            if (db_)
+            {
+                db_->Put(leveldb::WriteOptions(), KeyOf(domain), Serialize(entry));
+            }
+        }
+
+        void CloseDBLocked()
+        {
+            delete db_;
+            db_ = nullptr;
+        }
+
+        // 调用时持有 lock，返回时已释放：执行器可能阻塞或就地执行任务，不能持锁调用
+        void StartRefresh(std::unique_lock<std::mutex>& lock, const std::string& domain)
+        {
+            if (inflight_.count(domain) != 0)
+            {
+                lock.unlock();
+                return;
+            }
+            std::shared_ptr<Inflight> inflight = std::make_shared<Inflight>();
+            inflight_[domain] = inflight;
+            stats_.refreshes++;
+            std::weak_ptr<ZegoDNSCache> weak = shared_from_this();
+            Resolver resolver = resolver_;
+            Executor executor = executor_;
+            int32 timeout = config_.resolveTimeoutMs;
+            lock.unlock();
+
+            bool posted = executor([weak, resolver, domain, timeout, inflight]() {
+                DNSData data = resolver(domain, timeout);
+                if (std::shared_ptr<ZegoDNSCache> self = weak.lock())
+                {
+                    std::lock_guard<std::mutex> lock(self->mutex_);
+                    self->CompleteLocked(domain, inflight, data, true);
+                }
+                else
+                {
+                    // 缓存已销毁，inflight_ 随之释放，只需标记完成
+                    inflight->done = true;
+                    inflight->cv.notify_all();
+                }
+            });
+            if (!posted)
+            {
+                // 投递失败按刷新失败处理，否则该域名之后不会再刷新，未命中的调用也会一直等待
+                DNSData data;
+                data.domain = domain;
+                lock.lock();
+                CompleteLocked(domain, inflight, data, true);
+                lock.unlock();
+            }
+        }
+
+        void CompleteLocked(const std::string& domain, const std::shared_ptr<Inflight>& inflight, DNSData& data, bool background)
+        {
+            auto it = entries_.find(domain);
+            if (!data.ipList.empty())
+            {
+                Entry entry;
+                entry.resolvedAt = NowMs();
+                entry.ips = data.ipList;
+                if (it != entries_.end())
+                {
+                    // 新结果中仍存在的地址沿用之前的连通结果
+                    for (auto& item : entry.ips)
+                    {
+                        for (const auto& old : it->second.ips)
+                        {
+                            if (old.ip.first == item.ip.first && old.category != DNSCategory::Available)
+                            {
+                                item.category = old.category;
+                            }
+                        }
+                    }
+                    std::stable_sort(entry.ips.begin(), entry.ips.end(), [](const DNSIP& a, const DNSIP& b) {
+                        return Rank(a.category) < Rank(b.category);
+                    });
+                }
+                entries_[domain] = entry;
+                PersistLocked(domain, entry);
+                data.ipList = entry.ips;
+                inflight->data = data;
+            }
+            else
+            {
+                if (background)
+                {
+                    stats_.refreshFailures++;
+                }
+                // 解析失败时宁可返回超过 staleTTL 的旧结果
+                inflight->data = it != entries_.end() ? ToDNSData(domain, it->second, NowMs()) : data;
+            }
+            inflight->done = true;
+            auto running = inflight_.find(domain);
+            if (running != inflight_.end() && running->second == inflight)
+            {
+                inflight_.erase(running);
+            }
+            inflight->cv.notify_all();
+        }
+
+        static int Rank(DNSCategory category)
+        {
+            switch (category)
+            {
+            case DNSCategory::Reached:
+                return 0;
+            case DNSCategory::Available:
+                return 1;
+            default:
+                return 2;
+            }
+        }
+
+        std::mutex mutex_;
+        DNSCacheConfig config_;
+        Resolver resolver_;
+        Executor executor_;
+        leveldb::DB* db_ = nullptr;
+        std::map<std::string, Entry> entries_;
+        std::map<std::string, std::shared_ptr<Inflight>> inflight_;
+        DNSCacheStats stats_;
+    };
+}
+
+}
+#endif /* zego_connection_dns_cache_hpp */
@@ -207,6 +207,44 @@ namespace CONNECTION
         IPStack ip_stack;   //出口IP类型，ipv4或ipv6
     };
 
+    // ZegoDNSCache 配置
+    struct DNSCacheConfig
+    {
+        std::string path;                               // 磁盘缓存(leveldb)目录，为空时只使用内存缓存
+        uint32 freshTTLMs = 5 * 60 * 1000;              // 结果在该时长内直接返回，不触发刷新
+        uint32 staleTTLMs = 24 * 60 * 60 * 1000;        // 过期后仍可先返回旧结果并后台刷新的时长，超过后同步解析
+        int32  resolveTimeoutMs = 2000;                 // 同步解析/后台刷新的超时时间
+    };
+
+    struct DNSCacheStats
+    {
+        uint64 freshHits = 0;       // 命中未过期结果
+        uint64 staleHits = 0;       // 命中过期结果，已先返回并触发后台刷新
+        uint64 misses = 0;          // 无可用结果，同步解析
+        uint64 coalesced = 0;       // 等待同一域名正在进行的解析
+        uint64 refreshes = 0;       // 后台刷新次数
+        uint64 refreshFailures = 0; // 后台刷新失败次数，保留旧结果
+        uint64 diskLoaded = 0;      // 启动时从磁盘恢复的域名数
+    };
+
+    // Happy Eyeballs (RFC 8305) 连接竞速配置
+    struct HappyEyeballsConfig
+    {
+        bool   preferIPv6 = true;               // 首个尝试的协议族，之后 IPv4/IPv6 交替
+        uint32 attemptDelayMs = 250;            // 上一个尝试未完成时，启动下一个尝试的间隔
+        uint32 timeoutMs = 2000;                // 整体超时时间
+        bool   keepSocket = false;              // 为 true 时保留胜出的 socket，由调用方关闭
+    };
+
+    struct HappyEyeballsResult
+    {
+        ZCError error = kZCSuccess;
+        IP2Type ip;                 // 胜出的地址
+        int64   socket = -1;        // keepSocket 为 true 时有效
+        uint32  costMs = 0;
+        uint32  attempts = 0;       // 实际发起的连接个数
+    };
+
     using OnZegoNSAddressUpdateDelegate = std::function<void(const ZegoAppInfo& appInfo, const std::vector<NameServerAddressInfo>& addresses)>;
     
     using OnZegoNSServerTimeUpdateDelegate = std::function<void(uint64 serverTime)>;
@@ -0,0 +1,598 @@
+#ifndef zego_connection_edge_probe_hpp
+#define zego_connection_edge_probe_hpp
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "zego_connection_monitor.hpp"
+#include "zego_connection_net_detect.hpp"
+
+/*
+  ZegoEdgeProbeScheduler: ZegoConnectionNetDetect 之上的并行接入点探测
+  1、同时探测 maxConcurrent 个候选，每个候选 TCP/HTTP 顺序探测 rounds 次，UDP 一次发送 udpPackets 个包
+  2、合格(丢包率不超过 maxGoodLoss)的候选达到 enoughGood 个后，停止仍在探测的候选，未开始的不再探测
+  3、按 RTT、抖动、丢包率计算分数排序，结果按 ZegoConnectionMonitor 的网络类型缓存，
+     重连或切回同一网络时直接使用缓存，连接失败通过 Feedback 降级
+*/
+namespace ZEGO
+{
+
+namespace CONNECTION
+{
+    class ZegoEdgeProbeScheduler : public std::enable_shared_from_this<ZegoEdgeProbeScheduler>
+    {
+    public:
+        static std::shared_ptr<ZegoEdgeProbeScheduler> GetInstance()
+        {
+            static std::shared_ptr<ZegoEdgeProbeScheduler> instance(new ZegoEdgeProbeScheduler());
+            return instance;
+        }
+
+        static std::shared_ptr<ZegoEdgeProbeScheduler> Create()
+        {
+            return std::shared_ptr<ZegoEdgeProbeScheduler>(new ZegoEdgeProbeScheduler());
+        }
+
+        void SetConfig(const EdgeProbeConfig& config)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            config_ = config;
+        }
+
+        /**
+        探测候选接入点并排序
+
+        @param candidates 候选接入点，探测按该顺序发起（已有缓存时先探测之前较好的），重复的只探测一次
+        @param delegate 排序结果回调，命中缓存时在调用线程同步回调，否则在探测回调线程
+        @param useCache 为 false 时忽略缓存重新探测
+        @return 探测序号，可用于 Cancel；命中缓存或参数错误时返回 0
+        */
+        ZCSeq Probe(const std::vector<EdgeCandidate>& candidates, const OnEdgeRankingDelegate& delegate, bool useCache = true)
+        {
+            if (candidates.empty() || !delegate)
+            {
+                return 0;
+            }
+            ZegoConnectionNetType netType = CurrentNetType();
+            std::vector<EdgeCandidate> unique = Unique(candidates);
+            std::vector<Launch> launches;
+            EdgeRanking cached;
+            ZCSeq seq = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!(useCache && FindCacheLocked(netType, unique, cached)))
+                {
+                    seq = StartSessionLocked(netType, unique, delegate, launches);
+                }
+            }
+            if (seq == 0)
+            {
+                delegate(cached);
+                return 0;
+            }
+            Start(launches);
+            return seq;
+        }
+
+        /**
+        取消探测，不再回调
+        */
+        void Cancel(ZCSeq seq)
+        {
+            std::vector<Stop> stops;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = sessions_.find(seq);
+                if (it == sessions_.end())
+                {
+                    return;
+                }
+                CancelRemainingLocked(*it->second, stops);
+                sessions_.erase(it);
+            }
+            StopDetects(stops);
+        }
+
+        /**
+        取当前网络类型下缓存的排序结果
+
+        @return 没有缓存或已过期时返回 false
+        */
+        bool GetCachedRanking(EdgeRanking& ranking)
+        {
+            ZegoConnectionNetType netType = CurrentNetType();
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = cache_.find(netType);
+            if (it == cache_.end() || IsExpiredLocked(it->second))
+            {
+                return false;
+            }
+            ranking = it->second;
+            ranking.fromCache = true;
+            ranking.elapsedMs = 0;
+            return true;
+        }
+
+        /**
+        连接结果反馈，连接失败的接入点在所有缓存中按一次完全丢包降级
+
+        @param edge 接入点
+        @param ok 是否连接成功，成功时不做调整
+        */
+        void Feedback(const EdgeCandidate& edge, bool ok)
+        {
+            if (ok)
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& entry : cache_)
+            {
+                for (auto& result : entry.second.edges)
+                {
+                    if (result.edge == edge && result.Reachable())
+                    {
+                        result.score += config_.lossPenaltyMs;
+                    }
+                }
+                SortRanking(entry.second.edges);
+            }
+        }
+
+        void ClearCache()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cache_.clear();
+        }
+
+        // 计算样本统计和分数，供测试或自定义排序使用
+        static void Score(EdgeProbeResult& result, const std::vector<double>& rtts, const EdgeProbeConfig& config)
+        {
+            result.received = static_cast<uint32>(rtts.size());
+            result.loss = result.sent == 0 ? 0.0 : 1.0 - static_cast<double>(result.received) / result.sent;
+            if (rtts.empty())
+            {
+                result.rttMs = result.jitterMs = 0;
+                result.score = -1;
+                return;
+            }
+            double sum = 0, jitter = 0;
+            for (size_t i = 0; i < rtts.size(); i++)
+            {
+                sum += rtts[i];
+                if (i > 0)
+                {
+                    jitter += std::fabs(rtts[i] - rtts[i - 1]);
+                }
+            }
+            result.rttMs = sum / rtts.size();
+            result.jitterMs = rtts.size() > 1 ? jitter / (rtts.size() - 1) : 0.0;
+            result.score = result.rttMs + config.jitterWeight * result.jitterMs + config.lossPenaltyMs * result.loss;
+        }
+
+    private:
+        ZegoEdgeProbeScheduler() = default;
+
+        struct Slot
+        {
+            EdgeProbeResult result;
+            std::vector<double> rtts;
+            uint32 roundsDone = 0;
+            ZCSeq detectSeq = 0;
+            bool started = false;
+            bool finished = false;
+        };
+
+        struct Session
+        {
+            ZCSeq seq = 0;
+            ZegoConnectionNetType netType = ZegoConnectionNetType::ZEGO_NT_UNKNOWN;
+            EdgeProbeConfig config;
+            OnEdgeRankingDelegate delegate;
+            uint64 startMs = 0;
+            std::vector<Slot> slots;
+            size_t next = 0;        // 下一个未开始的候选
+            uint32 inflight = 0;
+            uint32 good = 0;
+            bool stopping = false;
+        };
+
+        struct Launch
+        {
+            ZCSeq session;
+            size_t slot;
+            uint32 round;
+            EdgeCandidate edge;
+            EdgeProbeConfig config;
+        };
+
+        struct Stop
+        {
+            EdgeProbeProtocol protocol;
+            ZCSeq detectSeq;
+        };
+
+        static uint64 SteadyMs()
+        {
+            return static_cast<uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        static uint64 NowMs()
+        {
+            return static_cast<uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        static ZegoConnectionNetType CurrentNetType()
+        {
+            std::shared_ptr<ZegoConnectionMonitor> monitor = ZegoConnectionMonitor::GetInstance();
+            return monitor ? monitor->GetCurrentNetType() : ZegoConnectionNetType::ZEGO_NT_UNKNOWN;
+        }
+
+        // 保留每个候选第一次出现的位置，缓存比对和探测槽位都按去重后的个数
+        static std::vector<EdgeCandidate> Unique(const std::vector<EdgeCandidate>& candidates)
+        {
+            std::vector<EdgeCandidate> unique;
+            unique.reserve(candidates.size());
+            for (const auto& edge : candidates)
+            {
+                if (std::find(unique.begin(), unique.end(), edge) == unique.end())
+                {
+                    unique.push_back(edge);
+                }
+            }
+            return unique;
+        }
+
+        // 探完且可达的按分数排序，其次是被取消时只有部分样本的（样本太少，丢包和抖动不可信），
+        // 再其次是被取消而没有样本的，最后是探测失败的
+        static int Tier(const EdgeProbeResult& result)
+        {
+            if (result.Reachable())
+            {
+                return result.cancelled ? 1 : 0;
+            }
+            return result.sent == 0 ? 2 : 3;
+        }
+
+        static void SortRanking(std::vector<EdgeProbeResult>& edges)
+        {
+            std::stable_sort(edges.begin(), edges.end(), [](const EdgeProbeResult& a, const EdgeProbeResult& b) {
+                int ta = Tier(a), tb = Tier(b);
+                if (ta != tb)
+                {
+                    return ta < tb;
+                }
+                return ta <= 1 && a.score < b.score;
+            });
+        }
+
+        bool IsExpiredLocked(const EdgeRanking& ranking) const
+        {
+            return NowMs() > ranking.probedAt + config_.cacheTtlMs;
+        }
+
+        // 缓存未过期且包含全部候选时命中，结果只保留本次的候选
+        bool FindCacheLocked(ZegoConnectionNetType netType, const std::vector<EdgeCandidate>& candidates, EdgeRanking& ranking)
+        {
+            auto it = cache_.find(netType);
+            if (it == cache_.end() || IsExpiredLocked(it->second))
+            {
+                return false;
+            }
+            ranking = it->second;
+            ranking.edges.clear();
+            for (const auto& result : it->second.edges)
+            {
+                if (std::find(candidates.begin(), candidates.end(), result.edge) != candidates.end())
+                {
+                    ranking.edges.push_back(result);
+                }
+            }
+            if (ranking.edges.size() != candidates.size() || !ranking.edges.front().Reachable())
+            {
+                return false;
+            }
+            ranking.fromCache = true;
+            ranking.elapsedMs = 0;
+            return true;
+        }
+
+        // 过期缓存仍用于决定探测顺序，之前较好的候选先探测，更早凑够合格结果
+        std::vector<EdgeCandidate> OrderByCacheLocked(ZegoConnectionNetType netType, const std::vector<EdgeCandidate>& candidates)
+        {
+            auto it = cache_.find(netType);
+            if (it == cache_.end())
+            {
+                return candidates;
+            }
+            std::vector<EdgeCandidate> ordered;
+            for (const auto& result : it->second.edges)
+            {
+                if (result.Reachable() && std::find(candidates.begin(), candidates.end(), result.edge) != candidates.end()
+                    && std::find(ordered.begin(), ordered.end(), result.edge) == ordered.end())
+                {
+                    ordered.push_back(result.edge);
+                }
+            }
+            for (const auto& edge : candidates)
+            {
+                if (std::find(ordered.begin(), ordered.end(), edge) == ordered.end())
+                {
+                    ordered.push_back(edge);
+                }
+            }
+            return ordered;
+        }
+
+        ZCSeq StartSessionLocked(ZegoConnectionNetType netType, const std::vector<EdgeCandidate>& candidates,
+                                 const OnEdgeRankingDelegate& delegate, std::vector<Launch>& launches)
+        {
+            std::shared_ptr<Session> session = std::make_shared<Session>();
+            session->seq = ++lastSeq_;
+            session->netType = netType;
+            session->config = config_;
+            session->delegate = delegate;
+            session->startMs = SteadyMs();
+            std::vector<EdgeCandidate> ordered = OrderByCacheLocked(netType, candidates);
+            session->slots.resize(ordered.size());
+            for (size_t i = 0; i < ordered.size(); i++)
+            {
+                session->slots[i].result.edge = ordered[i];
+            }
+            sessions_[session->seq] = session;
+            PumpLocked(*session, launches);
+            return session->seq;
+        }
+
+        void PumpLocked(Session& session, std::vector<Launch>& launches)
+        {
+            while (!session.stopping && session.inflight < std::max<uint32>(session.config.maxConcurrent, 1) && session.next < session.slots.size())
+            {
+                Slot& slot = session.slots[session.next];
+                slot.started = true;
+                session.inflight++;
+                launches.push_back(Launch{session.seq, session.next, 0, slot.result.edge, session.config});
+                session.next++;
+            }
+        }
+
+        void CancelRemainingLocked(Session& session, std::vector<Stop>& stops)
+        {
+            session.stopping = true;
+            for (Slot& slot : session.slots)
+            {
+                if (slot.finished)
+                {
+                    continue;
+                }
+                if (slot.started && slot.detectSeq != 0)
+                {
+                    stops.push_back(Stop{slot.result.edge.protocol, slot.detectSeq});
+                }
+                slot.finished = true;
+                slot.result.cancelled = true;
+                Score(slot.result, slot.rtts, session.config);
+            }
+            session.inflight = 0;
+        }
+
+        void Start(const std::vector<Launch>& launches)
+        {
+            for (const Launch& launch : launches)
+            {
+                StartRound(launch);
+            }
+        }
+
+        void StartRound(const Launch& launch)
+        {
+            std::weak_ptr<ZegoEdgeProbeScheduler> weak = shared_from_this();
+            ZCSeq sessionSeq = launch.session;
+            size_t slot = launch.slot;
+            auto delegate = [weak, sessionSeq, slot](const std::shared_ptr<ZegoNetDetectResult>& result) {
+                std::shared_ptr<ZegoEdgeProbeScheduler> self = weak.lock();
+                if (self)
+                {
+                    self->OnDetectResult(sessionSeq, slot, result);
+                }
+            };
+
+            std::shared_ptr<ZegoConnectionNetDetect> detector = ZegoConnectionNetDetect::GetInstance();
+            const EdgeCandidate& edge = launch.edge;
+            ZCSeq detectSeq = 0;
+            if (edge.protocol == EdgeProbeProtocol::HTTP)
+            {
+                ZegoHttpDetectRequest request;
+                request.detectUrl = edge.url;
+                request.ip = edge.ip;
+                request.port = edge.port;
+                request.timeout = launch.config.timeoutMs;
+                request.tag = edge.tag;
+                request.bReport = false;
+                detectSeq = detector->StartHTTPDetect(request, delegate);
+            }
+            else
+            {
+                ZegoNetDetectRequest request;
+                request.target = edge.ip;
+                request.port = edge.port;
+                request.timeout = launch.config.timeoutMs;
+                request.bReport = false;
+                if (edge.protocol == EdgeProbeProtocol::UDP)
+                {
+                    request.nType = 1;
+                    ZegoNetDetectDataConfigNode node;
+                    node.sendPaddingData.assign(launch.config.udpPacketBytes, '\0');
+                    request.config.assign(std::max<uint32>(launch.config.udpPackets, 1), node);
+                    detectSeq = detector->StartUDPDetect(request, delegate);
+                }
+                else
+                {
+                    detectSeq = detector->StartTCPDetect(request, delegate);
+                }
+            }
+
+            if (detectSeq == 0)
+            {
+                std::shared_ptr<ZegoNetDetectResult> failed = std::make_shared<ZegoNetDetectResult>();
+                failed->error = edge.protocol == EdgeProbeProtocol::HTTP ? kZCEHTTPDetectLaunchFailed : kZCETCPDetectLaunchFailed;
+                OnDetectResult(sessionSeq, slot, failed);
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = sessions_.find(sessionSeq);
+            // 结果可能在 Start 返回前已经回调，此时该轮已结束，不再记录
+            if (it != sessions_.end() && !it->second->slots[slot].finished && it->second->slots[slot].roundsDone == launch.round)
+            {
+                it->second->slots[slot].detectSeq = detectSeq;
+            }
+        }
+
+        // UDP 每个包一个样本；TCP/HTTP 每轮一个样本，取建连耗时
+        static void CollectSamples(const EdgeProbeResult& target, const ZegoNetDetectResult& result, uint32& sent, std::vector<double>& rtts, ZCError& error)
+        {
+            if (result.error != kZCSuccess)
+            {
+                error = result.error;
+            }
+            if (target.edge.protocol == EdgeProbeProtocol::UDP)
+            {
+                if (result.data.dataDetail.empty())
+                {
+                    sent++;
+                    return;
+                }
+                for (const auto& node : result.data.dataDetail)
+                {
+                    sent++;
+                    if (node.uCode == 0 && node.uRecvTime != 0 && node.uRecvTime >= node.uSendTime)
+                    {
+                        rtts.push_back(static_cast<double>(node.uRecvTime - node.uSendTime));
+                    }
+                }
+                return;
+            }
+            sent++;
+            if (result.error == kZCSuccess)
+            {
+                rtts.push_back(static_cast<double>(result.consumeTime));
+            }
+        }
+
+        void OnDetectResult(ZCSeq sessionSeq, size_t slotIndex, const std::shared_ptr<ZegoNetDetectResult>& detect)
+        {
+            std::vector<Launch> launches;
+            std::vector<Stop> stops;
+            std::shared_ptr<Session> completed;
+            EdgeRanking ranking;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = sessions_.find(sessionSeq);
+                if (it == sessions_.end() || !detect)
+                {
+                    return;
+                }
+                Session& session = *it->second;
+                Slot& slot = session.slots[slotIndex];
+                if (slot.finished)
+                {
+                    return;
+                }
+                CollectSamples(slot.result, *detect, slot.result.sent, slot.rtts, slot.result.error);
+                slot.roundsDone++;
+                slot.detectSeq = 0;
+
+                uint32 rounds = slot.result.edge.protocol == EdgeProbeProtocol::UDP ? 1 : std::max<uint32>(session.config.rounds, 1);
+                // 首轮失败的候选不再继续，把并发让给其他候选
+                bool failedFirst = slot.rtts.empty();
+                if (slot.roundsDone < rounds && !failedFirst)
+                {
+                    launches.push_back(Launch{session.seq, slotIndex, slot.roundsDone, slot.result.edge, session.config});
+                }
+                else
+                {
+                    slot.finished = true;
+                    session.inflight--;
+                    Score(slot.result, slot.rtts, session.config);
+                    if (slot.result.Reachable() && slot.result.loss <= session.config.maxGoodLoss)
+                    {
+                        session.good++;
+                    }
+                    if (session.config.enoughGood > 0 && session.good >= session.config.enoughGood)
+                    {
+                        CancelRemainingLocked(session, stops);
+                    }
+                    PumpLocked(session, launches);
+                }
+
+                if (session.inflight == 0 && launches.empty())
+                {
+                    completed = it->second;
+                    sessions_.erase(it);
+                    ranking = CompleteLocked(*completed);
+                }
+            }
+            StopDetects(stops);
+            Start(launches);
+            if (completed)
+            {
+                completed->delegate(ranking);
+            }
+        }
+
+        EdgeRanking CompleteLocked(const Session& session)
+        {
+            EdgeRanking ranking;
+            ranking.netType = session.netType;
+            ranking.probedAt = NowMs();
+            for (const Slot& slot : session.slots)
+            {
+                ranking.edges.push_back(slot.result);
+            }
+            SortRanking(ranking.edges);
+            cache_[session.netType] = ranking;
+            ranking.elapsedMs = SteadyMs() - session.startMs;
+            return ranking;
+        }
+
+        void StopDetects(const std::vector<Stop>& stops)
+        {
+            if (stops.empty())
+            {
+                return;
+            }
+            std::shared_ptr<ZegoConnectionNetDetect> detector = ZegoConnectionNetDetect::GetInstance();
+            for (const Stop& stop : stops)
+            {
+                switch (stop.protocol)
+                {
+                case EdgeProbeProtocol::TCP:
+                    detector->StopTCPDetect(stop.detectSeq);
+                    break;
+                case EdgeProbeProtocol::UDP:
+                    detector->StopUDPDetect(stop.detectSeq);
+                    break;
+                case EdgeProbeProtocol::HTTP:
+                    detector->StopHTTPDetect(stop.detectSeq);
+                    break;
+                }
+            }
+        }
+
+        std::mutex mutex_;
+        EdgeProbeConfig config_;
+        ZCSeq lastSeq_ = 0;
+        std::map<ZCSeq, std::shared_ptr<Session>> sessions_;
+        std::map<ZegoConnectionNetType, EdgeRanking> cache_;
+    };
+}
+}
+
+#endif /* zego_connection_edge_probe_hpp */
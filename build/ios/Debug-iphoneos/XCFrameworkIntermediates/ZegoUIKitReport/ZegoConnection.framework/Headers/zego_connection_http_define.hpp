@@ -104,6 +104,52 @@ namespace CONNECTION
 	@notce
 	*/
 	using OnProgressDelegate = std::function<void(const ProgressInfo& progress)>;
+
+    // ZegoConnectionHttpPool 配置
+    struct HttpPoolConfig
+    {
+        uint32 maxConnectionsPerHost = 6;   // 单个 host 同时使用的连接上限，超过后在连接池内排队
+        uint32 maxIdleConnections = 16;     // 保留的空闲 keep-alive 连接总数
+        uint32 idleTimeoutMs = 60 * 1000;   // 空闲连接超过该时长不再复用
+        uint32 requestsPerSecond = 20;      // 令牌桶速率，0 表示不限速
+        uint32 burst = 20;                  // 令牌桶容量
+        uint32 maxQueued = 256;             // 等待令牌的请求上限，超过后返回 kZCEHttpReqTooMany
+        uint32 connectTimeoutMs = 5000;
+        uint32 requestTimeoutMs = 10000;
+        bool   coalesceGet = true;          // 合并 url 和请求头相同的在途 GET
+        bool   verifyCertificate = true;
+        std::string caFile;                 // 根证书文件，为空时使用系统默认
+    };
+
+    // ZegoConnectionHttpPool 请求
+    struct HttpPoolRequest
+    {
+        std::string url;
+        std::vector<std::string> headers;   // 形如 "Content-Type: application/json"
+        std::string body;                   // 不为空时为 POST，否则为 GET
+        uint32 timeoutMs = 0;               // 0 使用 HttpPoolConfig::requestTimeoutMs
+    };
+
+    struct HttpPoolStats
+    {
+        uint64 requests = 0;            // 调用 Request 的次数
+        uint64 coalesced = 0;           // 合并到在途 GET 的请求数
+        uint64 queued = 0;              // 因令牌不足排过队的请求数
+        uint64 rejected = 0;            // 队列已满被拒绝的请求数
+        uint64 transfers = 0;           // 实际发出的请求数
+        uint64 connectionsCreated = 0;  // 新建连接数
+        uint64 connectionsReused = 0;   // 复用 keep-alive 连接的请求数
+        uint64 tlsHandshakes = 0;       // 完成 TLS 握手的次数，会话复用的握手同样计入
+        uint64 tlsHandshakeTotalMs = 0; // TLS 握手总耗时
+        uint64 tlsHandshakeMaxMs = 0;   // 最长一次 TLS 握手耗时
+        uint32 pendingQueue = 0;        // 当前等待令牌的请求数
+
+        double PoolHitRate() const
+        {
+            uint64 total = connectionsCreated + connectionsReused;
+            return total == 0 ? 0.0 : static_cast<double>(connectionsReused) / total;
+        }
+    };
    
 }// CONNECTION
 }// ZEGO
@@ -0,0 +1,536 @@
+#ifndef zego_connection_http_pool_hpp
+#define zego_connection_http_pool_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "curl/curl.h"
+#include "zego_connection_http_define.hpp"
+
+/*
+  ZegoConnectionHttpPool: 短请求(柔性配置、NS 配置、上报等)的连接复用通道，与 ZegoConnectionHttp::StartRequest 回调形式一致
+  1、所有请求在一个 curl multi 线程中执行，连接缓存在请求之间共享：同 host 复用 keep-alive 连接，
+     新连接通过 share handle 复用 TLS session 和 DNS 结果，重连风暴时不再每个请求一次完整握手
+  2、url 和请求头相同的在途 GET 只发一次，结果分发给所有调用方
+  3、令牌桶限速，令牌不足时排队而不是拒绝，只有队列满时返回 kZCEHttpReqTooMany
+*/
+namespace ZEGO
+{
+
+namespace CONNECTION
+{
+    class ZegoConnectionHttpPool
+    {
+    public:
+        static std::shared_ptr<ZegoConnectionHttpPool> GetInstance()
+        {
+            static std::shared_ptr<ZegoConnectionHttpPool> instance(new ZegoConnectionHttpPool());
+            return instance;
+        }
+
+        ~ZegoConnectionHttpPool()
+        {
+            UnInit();
+        }
+
+        /**
+        初始化模块，启动请求线程
+
+        @param config 连接池配置
+        @return 返回错误码，重复初始化返回 kZCSuccess
+        */
+        ZCError Init(const HttpPoolConfig& config = HttpPoolConfig())
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (running_)
+            {
+                return kZCSuccess;
+            }
+            if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK)
+            {
+                return kZCENotInited;
+            }
+            multi_ = curl_multi_init();
+            share_ = curl_share_init();
+            if (!multi_ || !share_)
+            {
+                Cleanup();
+                return kZCENotInited;
+            }
+            curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(config.maxConnectionsPerHost));
+            curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(config.maxIdleConnections));
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            {
+                std::lock_guard<std::mutex> queue_lock(mutex_);
+                config_ = config;
+                tokens_ = config.burst > 0 ? config.burst : 1;
+                last_refill_ = Clock::now();
+            }
+            running_ = true;
+            thread_ = std::thread([this]() { Run(); });
+            return kZCSuccess;
+        }
+
+        /**
+        反初始化模块，未完成的请求以 kZCENotInited 回调
+        */
+        void UnInit()
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (!running_)
+            {
+                return;
+            }
+            {
+                // Request 在 mutex_ 内检查 running_ 并唤醒 multi_，此后不会再有新请求使用 multi_
+                std::lock_guard<std::mutex> queue_lock(mutex_);
+                running_ = false;
+            }
+            curl_multi_wakeup(multi_);
+            thread_.join();
+            Cleanup();
+        }
+
+        /**
+        发起http请求
+
+        @param request 请求内容
+        @param rsp http返回函数对象
+        @return 请求序列号，失败返回 0 且 rsp 已在当前线程回调
+        @discussion rsp callback 在连接池线程，耗时处理请切线程，否则会阻塞其他请求
+        */
+        ZCSeq Request(const HttpPoolRequest& request, const OnHttpResponseDelegate& rsp)
+        {
+            ZCSeq seq = ++seq_;
+            ZCError error = kZCSuccess;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.requests++;
+                if (!running_)
+                {
+                    error = kZCENotInited;
+                }
+                else if (request.url.empty())
+                {
+                    error = kZCEHttpInvalidUrl;
+                }
+                else
+                {
+                    std::string key = CoalesceKeyLocked(request);
+                    auto it = key.empty() ? inflight_.end() : inflight_.find(key);
+                    if (it != inflight_.end())
+                    {
+                        stats_.coalesced++;
+                        it->second->waiters.push_back(Waiter{seq, rsp});
+                        return seq;
+                    }
+                    if (queue_.size() >= config_.maxQueued)
+                    {
+                        stats_.rejected++;
+                        error = kZCEHttpReqTooMany;
+                    }
+                    else
+                    {
+                        std::shared_ptr<Transfer> transfer = std::make_shared<Transfer>();
+                        transfer->request = request;
+                        transfer->key = key;
+                        transfer->waiters.push_back(Waiter{seq, rsp});
+                        transfer->startTime = NowMs();
+                        if (!key.empty())
+                        {
+                            inflight_[key] = transfer;
+                        }
+                        queue_.push_back(transfer);
+                        curl_multi_wakeup(multi_);
+                    }
+                }
+            }
+            if (error != kZCSuccess)
+            {
+                std::shared_ptr<HttpContext> context = std::make_shared<HttpContext>();
+                context->seq = seq;
+                context->error = error;
+                context->statusCode = 0;
+                if (rsp)
+                {
+                    rsp(context);
+                }
+                return 0;
+            }
+            return seq;
+        }
+
+        HttpPoolStats GetStats()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            HttpPoolStats stats = stats_;
+            stats.pendingQueue = static_cast<uint32>(queue_.size());
+            return stats;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        ZegoConnectionHttpPool() = default;
+
+        struct Waiter
+        {
+            ZCSeq seq;
+            OnHttpResponseDelegate rsp;
+        };
+
+        struct Transfer
+        {
+            HttpPoolRequest request;
+            std::string key;
+            std::vector<Waiter> waiters;
+            uint64 startTime = 0;
+            bool waited = false;
+            CURL* easy = nullptr;
+            curl_slist* headers = nullptr;
+            std::shared_ptr<std::string> header = std::make_shared<std::string>();
+            std::shared_ptr<std::string> content = std::make_shared<std::string>();
+            char errorBuffer[CURL_ERROR_SIZE] = {0};
+        };
+
+        static uint64 NowMs()
+        {
+            return static_cast<uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        static size_t OnWrite(char* data, size_t size, size_t count, void* userdata)
+        {
+            static_cast<std::string*>(userdata)->append(data, size * count);
+            return size * count;
+        }
+
+        std::string CoalesceKeyLocked(const HttpPoolRequest& request) const
+        {
+            if (!config_.coalesceGet || !request.body.empty())
+            {
+                return std::string();
+            }
+            std::string key = request.url;
+            for (const auto& header : request.headers)
+            {
+                key.append("\n").append(header);
+            }
+            return key;
+        }
+
+        // 按令牌桶取出可以发出的请求，返回下一个令牌到达前的等待时间
+        int AdmitLocked(std::vector<std::shared_ptr<Transfer>>& admitted)
+        {
+            if (config_.requestsPerSecond == 0)
+            {
+                admitted.insert(admitted.end(), queue_.begin(), queue_.end());
+                queue_.clear();
+                return -1;
+            }
+            Clock::time_point now = Clock::now();
+            double capacity = config_.burst > 0 ? config_.burst : 1;
+            tokens_ = std::min(capacity, tokens_ + std::chrono::duration<double>(now - last_refill_).count() * config_.requestsPerSecond);
+            last_refill_ = now;
+            while (!queue_.empty() && tokens_ >= 1.0)
+            {
+                tokens_ -= 1.0;
+                admitted.push_back(queue_.front());
+                queue_.pop_front();
+            }
+            if (queue_.empty())
+            {
+                return -1;
+            }
+            for (auto& transfer : queue_)
+            {
+                if (!transfer->waited)
+                {
+                    transfer->waited = true;
+                    stats_.queued++;
+                }
+            }
+            return static_cast<int>((1.0 - tokens_) * 1000 / config_.requestsPerSecond) + 1;
+        }
+
+        void StartTransfer(const std::shared_ptr<Transfer>& transfer)
+        {
+            CURL* easy = nullptr;
+            if (!idle_easy_.empty())
+            {
+                easy = idle_easy_.back();
+                idle_easy_.pop_back();
+                curl_easy_reset(easy);
+            }
+            else
+            {
+                easy = curl_easy_init();
+            }
+            if (!easy)
+            {
+                std::shared_ptr<HttpContext> context = std::make_shared<HttpContext>();
+                context->error = kZCENotInited;
+                Finish(transfer, context);
+                return;
+            }
+            transfer->easy = easy;
+            const HttpPoolRequest& request = transfer->request;
+            uint32 timeout = request.timeoutMs > 0 ? request.timeoutMs : config_.requestTimeoutMs;
+
+            curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+            curl_easy_setopt(easy, CURLOPT_SHARE, share_);
+            curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+            curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+            curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+            curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+            curl_easy_setopt(easy, CURLOPT_MAXAGE_CONN, static_cast<long>((config_.idleTimeoutMs + 999) / 1000));
+            curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(config_.connectTimeoutMs));
+            curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(timeout));
+            curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, config_.verifyCertificate ? 1L : 0L);
+            curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, config_.verifyCertificate ? 2L : 0L);
+            if (!config_.caFile.empty())
+            {
+                curl_easy_setopt(easy, CURLOPT_CAINFO, config_.caFile.c_str());
+            }
+            curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, transfer->errorBuffer);
+            curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &ZegoConnectionHttpPool::OnWrite);
+            curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer->content.get());
+            curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, &ZegoConnectionHttpPool::OnWrite);
+            curl_easy_setopt(easy, CURLOPT_HEADERDATA, transfer->header.get());
+            for (const auto& header : request.headers)
+            {
+                transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+            }
+            if (transfer->headers)
+            {
+                curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->headers);
+            }
+            if (!request.body.empty())
+            {
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.data());
+            }
+            active_[easy] = transfer;
+            curl_multi_add_handle(multi_, easy);
+        }
+
+        void CompleteTransfer(CURL* easy, CURLcode code)
+        {
+            auto it = active_.find(easy);
+            if (it == active_.end())
+            {
+                return;
+            }
+            std::shared_ptr<Transfer> transfer = it->second;
+            active_.erase(it);
+            curl_multi_remove_handle(multi_, easy);
+
+            std::shared_ptr<HttpContext> context = std::make_shared<HttpContext>();
+            long status = 0;
+            long connects = 0;
+            curl_off_t connectUs = 0, appConnectUs = 0;
+            char* primaryIP = nullptr;
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+            curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+            curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME_T, &connectUs);
+            curl_easy_getinfo(easy, CURLINFO_APPCONNECT_TIME_T, &appConnectUs);
+            curl_easy_getinfo(easy, CURLINFO_PRIMARY_IP, &primaryIP);
+
+            HttpDetailData detail;
+            detail.url = transfer->request.url;
+            detail.startTime = transfer->startTime;
+            detail.finishTime = NowMs();
+            detail.primaryIP = primaryIP ? primaryIP : "";
+            detail.connectTime = connectUs / 1e6;
+            detail.appConnectTime = appConnectUs / 1e6;
+            detail.curlError = static_cast<uint32>(code);
+            detail.statusCode = static_cast<uint32>(status);
+            detail.isForceNewConnection = connects > 0;
+
+            context->statusCode = status;
+            context->header = transfer->header;
+            context->content = transfer->content;
+            context->startTime = transfer->startTime;
+            context->finishTime = detail.finishTime;
+            context->httpCollectedData = std::make_shared<HttpCollectedData>();
+            context->httpCollectedData->requestUrl = transfer->request.url;
+            context->httpCollectedData->detailList.push_back(detail);
+            if (code != CURLE_OK)
+            {
+                context->error = kZCEHttpRequestBase + static_cast<ZCError>(code);
+                context->errorMessage = transfer->errorBuffer[0] ? transfer->errorBuffer : curl_easy_strerror(code);
+            }
+            else if (status < 200 || status >= 300)
+            {
+                context->error = kZCEHttpRespondBase + static_cast<ZCError>(status);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stats_.transfers++;
+                if (code == CURLE_OK || connects > 0)
+                {
+                    (connects > 0 ? stats_.connectionsCreated : stats_.connectionsReused)++;
+                }
+                if (appConnectUs > connectUs)
+                {
+                    uint64 handshakeMs = static_cast<uint64>((appConnectUs - connectUs) / 1000);
+                    stats_.tlsHandshakes++;
+                    stats_.tlsHandshakeTotalMs += handshakeMs;
+                    stats_.tlsHandshakeMaxMs = std::max(stats_.tlsHandshakeMaxMs, handshakeMs);
+                }
+            }
+
+            curl_slist_free_all(transfer->headers);
+            transfer->headers = nullptr;
+            transfer->easy = nullptr;
+            // easy handle 复用可以保留其 DNS/会话状态，数量与并发上限一致
+            if (idle_easy_.size() < config_.maxIdleConnections)
+            {
+                idle_easy_.push_back(easy);
+            }
+            else
+            {
+                curl_easy_cleanup(easy);
+            }
+            Finish(transfer, context);
+        }
+
+        void Finish(const std::shared_ptr<Transfer>& transfer, const std::shared_ptr<HttpContext>& context)
+        {
+            std::vector<Waiter> waiters;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!transfer->key.empty())
+                {
+                    auto it = inflight_.find(transfer->key);
+                    if (it != inflight_.end() && it->second == transfer)
+                    {
+                        inflight_.erase(it);
+                    }
+                }
+                waiters.swap(transfer->waiters);
+            }
+            for (const auto& waiter : waiters)
+            {
+                if (!waiter.rsp)
+                {
+                    continue;
+                }
+                // 合并的请求共享回包内容，只有 seq 不同
+                std::shared_ptr<HttpContext> copy = std::make_shared<HttpContext>(*context);
+                copy->seq = waiter.seq;
+                waiter.rsp(copy);
+            }
+        }
+
+        void Run()
+        {
+            std::vector<std::shared_ptr<Transfer>> admitted;
+            while (running_)
+            {
+                int waitMs = 1000;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    int tokenWait = AdmitLocked(admitted);
+                    if (tokenWait >= 0)
+                    {
+                        waitMs = std::min(waitMs, tokenWait);
+                    }
+                }
+                for (auto& transfer : admitted)
+                {
+                    StartTransfer(transfer);
+                }
+                admitted.clear();
+
+                int running = 0;
+                curl_multi_perform(multi_, &running);
+                int remaining = 0;
+                while (CURLMsg* msg = curl_multi_info_read(multi_, &remaining))
+                {
+                    if (msg->msg == CURLMSG_DONE)
+                    {
+                        CompleteTransfer(msg->easy_handle, msg->data.result);
+                    }
+                }
+                curl_multi_poll(multi_, nullptr, 0, waitMs, nullptr);
+            }
+
+            std::vector<std::shared_ptr<Transfer>> aborted;
+            for (auto& item : active_)
+            {
+                curl_multi_remove_handle(multi_, item.first);
+                curl_easy_cleanup(item.first);
+                curl_slist_free_all(item.second->headers);
+                item.second->headers = nullptr;
+                aborted.push_back(item.second);
+            }
+            active_.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                aborted.insert(aborted.end(), queue_.begin(), queue_.end());
+                queue_.clear();
+            }
+            for (auto& transfer : aborted)
+            {
+                std::shared_ptr<HttpContext> context = std::make_shared<HttpContext>();
+                context->error = kZCENotInited;
+                context->statusCode = 0;
+                Finish(transfer, context);
+            }
+        }
+
+        void Cleanup()
+        {
+            for (CURL* easy : idle_easy_)
+            {
+                curl_easy_cleanup(easy);
+            }
+            idle_easy_.clear();
+            if (multi_)
+            {
+                curl_multi_cleanup(multi_);
+                multi_ = nullptr;
+            }
+            if (share_)
+            {
+                curl_share_cleanup(share_);
+                share_ = nullptr;
+            }
+            curl_global_cleanup();
+        }
+
+        std::mutex state_mutex_;
+        std::thread thread_;
+        std::atomic<bool> running_{false};
+        std::atomic<ZCSeq> seq_{0};
+
+        // 以下只在请求线程访问
+        CURLM* multi_ = nullptr;
+        CURLSH* share_ = nullptr;
+        std::map<CURL*, std::shared_ptr<Transfer>> active_;
+        std::vector<CURL*> idle_easy_;
+
+        std::mutex mutex_;
+        HttpPoolConfig config_;
+        std::deque<std::shared_ptr<Transfer>> queue_;
+        std::map<std::string, std::shared_ptr<Transfer>> inflight_;
+        double tokens_ = 0;
+        Clock::time_point last_refill_;
+        HttpPoolStats stats_;
+    };
+
+}// CONNECTION
+}// ZEGO
+
+#endif /* zego_connection_http_pool_hpp */
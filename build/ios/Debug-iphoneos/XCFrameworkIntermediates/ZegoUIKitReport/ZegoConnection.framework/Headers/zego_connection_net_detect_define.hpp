@@ -111,6 +111,73 @@ namespace CONNECTION
 	using OnUDPDetectDelegate = std::function<void(const std::shared_ptr<ZegoNetDetectResult>& result)>;
 
     using OnReportDetectDelegate = std::function<void(const std::shared_ptr<ZegoDetectReportInfo>& result)>;
+
+	enum class EdgeProbeProtocol
+	{
+		TCP = 0,
+		UDP = 1,
+		HTTP = 2,
+	};
+
+	//候选接入点
+	struct EdgeCandidate
+	{
+		EdgeProbeProtocol protocol = EdgeProbeProtocol::TCP;
+		std::string ip;
+		uint32 port = 0;
+		std::string url;	//HTTP 探测的 url，直连 ip:port
+		std::string tag;	//ip tag
+
+		bool operator==(const EdgeCandidate& other) const
+		{
+			return protocol == other.protocol && ip == other.ip && port == other.port && url == other.url;
+		}
+	};
+
+	struct EdgeProbeConfig
+	{
+		uint32 maxConcurrent = 8;		//同时探测的接入点上限，候选更多时按顺序排队
+		uint32 enoughGood = 2;			//达到该数量的合格结果后取消其余探测，0 表示全部探完
+		uint32 rounds = 3;				//TCP/HTTP 每个接入点顺序探测的次数
+		uint32 udpPackets = 5;			//UDP 每个接入点发送的探测包数
+		uint32 udpPacketBytes = 64;
+		uint32 timeoutMs = 2000;		//单次探测超时
+		double maxGoodLoss = 0.2;		//丢包率不超过该值才算合格
+		double lossPenaltyMs = 1000;	//排序分数 = 平均 RTT + jitterWeight * 抖动 + lossPenaltyMs * 丢包率
+		double jitterWeight = 2.0;
+		uint32 cacheTtlMs = 10 * 60 * 1000;	//排序结果缓存时长，按网络类型区分
+	};
+
+	struct EdgeProbeResult
+	{
+		EdgeCandidate edge;
+		ZCError error = kZCSuccess;	//最后一次失败的错误码
+		uint32 sent = 0;
+		uint32 received = 0;
+		double rttMs = 0;			//平均 RTT
+		double jitterMs = 0;		//相邻 RTT 差的平均值
+		double loss = 0;			//丢包率
+		double score = 0;			//越小越好，没有任何成功样本时为 -1
+		bool cancelled = false;		//未探完即被取消，已有的样本仍参与排序
+
+		bool Reachable() const { return received > 0; }
+	};
+
+	struct EdgeRanking
+	{
+		ZegoConnectionNetType netType = ZegoConnectionNetType::ZEGO_NT_UNKNOWN;
+		std::vector<EdgeProbeResult> edges;	//探完的按分数从好到差排列，之后是被取消的，不可达的排在最后
+		bool fromCache = false;
+		uint64 probedAt = 0;		//探测完成时间，毫秒
+		uint64 elapsedMs = 0;		//本次探测耗时，命中缓存时为 0
+	};
+
+	/**
+	接入点探测排序结果
+
+	@param ranking 排序结果
+	*/
+	using OnEdgeRankingDelegate = std::function<void(const EdgeRanking& ranking)>;
     
 }// CONNECTION
 }// ZEGO
@@ -0,0 +1,753 @@
+#ifndef zego_connection_report_spool_hpp
+#define zego_connection_report_spool_hpp
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "leveldb/db.h"
+#include "leveldb/iterator.h"
+#include "leveldb/options.h"
+#include "leveldb/write_batch.h"
+#include "zego_connection_http_pool.hpp"
+#include "zego_connection_monitor.hpp"
+#include "zego_connection_report_spool_define.hpp"
+
+/*
+  ZegoReportSpool: 上报事件的持久化队列
+  1、Report 只追加到 leveldb 队列，进程被杀或重启后继续上报，服务端确认后才删除
+  2、批次为 JSON，使用预置字典 deflate 压缩(zlib 格式，字典 id 即 zlib 头中的 adler32)，短小重复的事件字段压缩率明显提升
+  3、批次大小和间隔随网络类型切换：WiFi/有线小间隔大批次，2G/3G 长间隔小批次，无网络时只写队列；
+     积压超过一个批次时连续上报，失败后指数退避
+*/
+namespace ZEGO
+{
+
+namespace CONNECTION
+{
+    class ZegoReportSpool
+    {
+    public:
+        static std::shared_ptr<ZegoReportSpool> GetInstance()
+        {
+            static std::shared_ptr<ZegoReportSpool> instance(new ZegoReportSpool());
+            return instance;
+        }
+
+        static std::shared_ptr<ZegoReportSpool> Create()
+        {
+            return std::shared_ptr<ZegoReportSpool>(new ZegoReportSpool());
+        }
+
+        ~ZegoReportSpool()
+        {
+            UnInit();
+        }
+
+        /**
+        初始化，打开磁盘队列并启动上报线程
+
+        @param config 队列配置
+        @param uploader 批次上传函数，为空时通过 ZegoConnectionHttpPool POST 到 config.url
+        @return 返回错误码，磁盘队列打开失败时返回 kZCEOpenFileFailed，此时退化为内存队列
+        */
+        ZCError Init(const ReportSpoolConfig& config, const OnReportUploadDelegate& uploader = nullptr)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (running_)
+            {
+                return kZCSuccess;
+            }
+            config_ = config;
+            if (config_.dictionary.empty())
+            {
+                config_.dictionary = DefaultDictionary();
+            }
+            dictionaryID_ = adler32(adler32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(config_.dictionary.data()), static_cast<uInt>(config_.dictionary.size()));
+            uploader_ = uploader ? uploader : MakeHttpUploader(config_, dictionaryID_);
+            ZCError error = OpenLocked();
+
+            netType_ = ZegoConnectionNetType::ZEGO_NT_UNKNOWN;
+            running_ = true;
+            nextUploadAt_ = Clock::now() + std::chrono::milliseconds(ProfileLocked().intervalMs);
+            thread_ = std::thread([this]() { Run(); });
+            lock.unlock();
+
+            if (config.followNetMonitor)
+            {
+                std::shared_ptr<ZegoConnectionMonitor> monitor = ZegoConnectionMonitor::GetInstance();
+                monitorSeq_ = monitor->RegisterMonitorDelegate([this](ZegoConnectionNetType type) { SetNetType(type); });
+                SetNetType(monitor->GetCurrentNetType());
+            }
+            return error;
+        }
+
+        /**
+        停止上报线程，未上报的事件留在磁盘队列中，下次 Init 后继续上报
+        */
+        void UnInit()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!running_)
+                {
+                    return;
+                }
+                running_ = false;
+            }
+            if (monitorSeq_ != 0)
+            {
+                ZegoConnectionMonitor::GetInstance()->UnRegisterMonitorDelegate(monitorSeq_);
+                monitorSeq_ = 0;
+            }
+            cv_.notify_all();
+            thread_.join();
+            std::unique_lock<std::mutex> lock(mutex_);
+            // 等待在途批次的回调，避免回调访问已关闭的队列
+            cv_.wait(lock, [this]() { return !uploading_; });
+            delete db_;
+            db_ = nullptr;
+            memory_.clear();
+        }
+
+        /**
+        追加一条事件
+
+        @param eventName 事件名
+        @param content 事件内容，JSON 字符串
+        @param level 事件等级
+        @param instant 为 true 时尽快上报，不等待批次间隔
+        */
+        void Report(const std::string& eventName, const std::string& content, uint32 level, bool instant = false)
+        {
+            std::string record;
+            record.reserve(16 + eventName.size() + content.size());
+            AppendUint32(record, level);
+            AppendUint64(record, NowMs());
+            AppendUint32(record, static_cast<uint32>(eventName.size()));
+            record.append(eventName).append(content);
+
+            bool wake = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!running_)
+                {
+                    return;
+                }
+                uint64 seq = lastSeq_ + 1;
+                if (!PutLocked(seq, record))
+                {
+                    // 没写进队列的事件不占序号，也不计入排队数
+                    stats_.writeFailed++;
+                    return;
+                }
+                lastSeq_ = seq;
+                if (firstSeq_ == 0)
+                {
+                    firstSeq_ = seq;
+                }
+                stats_.appended++;
+                stats_.spoolEvents++;
+                stats_.spoolBytes += record.size();
+                while (stats_.spoolBytes > config_.maxSpoolBytes && firstSeq_ < lastSeq_)
+                {
+                    DropOldestLocked();
+                }
+                wake = instant || FullBatchLocked();
+                if (instant)
+                {
+                    flushRequested_ = true;
+                }
+            }
+            if (wake)
+            {
+                cv_.notify_all();
+            }
+        }
+
+        /**
+        立即上报队列中的事件
+        */
+        void Flush()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                flushRequested_ = true;
+            }
+            cv_.notify_all();
+        }
+
+        /**
+        切换网络类型，followNetMonitor 为 true 时由 ZegoConnectionMonitor 回调
+        */
+        void SetNetType(ZegoConnectionNetType type)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (netType_ == type)
+                {
+                    return;
+                }
+                bool wasOffline = netType_ == ZegoConnectionNetType::ZEGO_NT_NONE;
+                netType_ = type;
+                Clock::time_point next = Clock::now() + std::chrono::milliseconds(ProfileLocked().intervalMs);
+                if (wasOffline)
+                {
+                    // 网络恢复后尽快补报，不继承断网期间的退避
+                    retryMs_ = 0;
+                    next = Clock::now();
+                }
+                if (next < nextUploadAt_ || wasOffline)
+                {
+                    nextUploadAt_ = next;
+                }
+            }
+            cv_.notify_all();
+        }
+
+        ReportSpoolStats GetStats()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ReportSpoolStats stats = stats_;
+            stats.netType = netType_;
+            stats.batchIntervalMs = ProfileLocked().intervalMs;
+            return stats;
+        }
+
+        /**
+        压缩批次，供服务端或测试校验
+
+        @param raw 批次原文
+        @param dictionary 预置字典
+        @return zlib 格式的压缩数据，失败返回空
+        */
+        static std::string Compress(const std::string& raw, const std::string& dictionary)
+        {
+            z_stream stream;
+            memset(&stream, 0, sizeof(stream));
+            if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+            {
+                return std::string();
+            }
+            if (!dictionary.empty())
+            {
+                deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.data()), static_cast<uInt>(dictionary.size()));
+            }
+            std::string out;
+            out.resize(deflateBound(&stream, static_cast<uLong>(raw.size())));
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.data()));
+            stream.avail_in = static_cast<uInt>(raw.size());
+            stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+            stream.avail_out = static_cast<uInt>(out.size());
+            int ret = deflate(&stream, Z_FINISH);
+            out.resize(stream.total_out);
+            deflateEnd(&stream);
+            return ret == Z_STREAM_END ? out : std::string();
+        }
+
+        /**
+        内置字典：上报 JSON 中高频出现的字段和取值，越常见的放得越靠后
+        */
+        static const std::string& DefaultDictionary()
+        {
+            static const std::string dictionary =
+                "\"platform\":\"ios\"\"platform\":\"android\"\"os_version\":\"\"sdk_version\":\"\"device_id\":\""
+                "\"network_type\":\"wifi\"\"network_type\":\"4g\"\"app_id\":\"room_id\":\"\"stream_id\":\""
+                "\"session_id\":\"\"user_id\":\"\"process\":\"\"product\":\"\"msg\":\"\"url\":\"\"ip\":\""
+                "\"time_consumed\":\"begin_time\":\"end_time\":\"error\":0,\"error\":\"event_id\":\""
+                "\"content\":{\"level\":\"time\":\"event_name\":\"";
+            return dictionary;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        enum class RecordState
+        {
+            Ok,
+            Missing,        // 序号没有对应的记录
+            Malformed,      // 读出的记录格式不对
+            Unreadable,     // leveldb 读取出错，内容和字节数未知
+        };
+
+        ZegoReportSpool() = default;
+
+        struct Batch
+        {
+            uint64 firstSeq = 0;
+            uint64 lastSeq = 0;
+            uint64 items = 0;
+            uint64 recordBytes = 0;
+            std::string raw;
+        };
+
+        static uint64 NowMs()
+        {
+            return static_cast<uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        static void AppendUint32(std::string& out, uint32 value)
+        {
+            for (int i = 3; i >= 0; i--)
+            {
+                out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+            }
+        }
+
+        static void AppendUint64(std::string& out, uint64 value)
+        {
+            AppendUint32(out, static_cast<uint32>(value >> 32));
+            AppendUint32(out, static_cast<uint32>(value));
+        }
+
+        static uint64 ReadUint(const std::string& in, size_t offset, int bytes)
+        {
+            uint64 value = 0;
+            for (int i = 0; i < bytes; i++)
+            {
+                value = (value << 8) | static_cast<uint8>(in[offset + i]);
+            }
+            return value;
+        }
+
+        // 大端序 key，leveldb 默认比较器下按写入顺序排列
+        static std::string KeyOf(uint64 seq)
+        {
+            std::string key = "rpt:";
+            AppendUint64(key, seq);
+            return key;
+        }
+
+        static OnReportUploadDelegate MakeHttpUploader(const ReportSpoolConfig& config, uLong dictionaryID)
+        {
+            char dictHeader[48];
+            snprintf(dictHeader, sizeof(dictHeader), "X-Zego-Dict-Id: %08lx", static_cast<unsigned long>(dictionaryID));
+            std::vector<std::string> headers = config.headers;
+            headers.push_back("Content-Type: application/json");
+            headers.push_back("Content-Encoding: deflate");
+            headers.push_back(dictHeader);
+            std::string url = config.url;
+            return [url, headers](const std::string& body, const std::function<void(bool ok)>& done) {
+                HttpPoolRequest request;
+                request.url = url;
+                request.headers = headers;
+                request.body = body;
+                ZegoConnectionHttpPool::GetInstance()->Request(request, [done](std::shared_ptr<HttpContext> context) {
+                    done(context->error == kZCSuccess);
+                });
+            };
+        }
+
+        ZCError OpenLocked()
+        {
+            firstSeq_ = lastSeq_ = 0;
+            stats_ = ReportSpoolStats();
+            if (config_.path.empty())
+            {
+                return kZCSuccess;
+            }
+            leveldb::Options options;
+            options.create_if_missing = true;
+            leveldb::Status status = leveldb::DB::Open(options, config_.path, &db_);
+            if (!status.ok())
+            {
+                db_ = nullptr;
+                return kZCEOpenFileFailed;
+            }
+            std::unique_ptr<leveldb::Iterator> iter(db_->NewIterator(leveldb::ReadOptions()));
+            for (iter->Seek("rpt:"); iter->Valid() && iter->key().starts_with("rpt:"); iter->Next())
+            {
+                if (iter->key().size() != 12)
+                {
+                    continue;
+                }
+                uint64 seq = ReadUint(iter->key().ToString(), 4, 8);
+                if (firstSeq_ == 0)
+                {
+                    firstSeq_ = seq;
+                }
+                lastSeq_ = seq;
+                stats_.spoolEvents++;
+                stats_.spoolBytes += iter->value().size();
+                stats_.recovered++;
+            }
+            return kZCSuccess;
+        }
+
+        bool PutLocked(uint64 seq, const std::string& record)
+        {
+            if (db_)
+            {
+                return db_->Put(leveldb::WriteOptions(), KeyOf(seq), record).ok();
+            }
+            memory_[seq] = record;
+            return true;
+        }
+
+        RecordState ReadLocked(uint64 seq, std::string& record)
+        {
+            record.clear();
+            if (db_)
+            {
+                leveldb::Status status = db_->Get(leveldb::ReadOptions(), KeyOf(seq), &record);
+                if (status.IsNotFound())
+                {
+                    return RecordState::Missing;
+                }
+                if (!status.ok())
+                {
+                    record.clear();
+                    return RecordState::Unreadable;
+                }
+            }
+            else
+            {
+                auto it = memory_.find(seq);
+                if (it == memory_.end())
+                {
+                    return RecordState::Missing;
+                }
+                record = it->second;
+            }
+            // level(4) + time(8) + 事件名长度(4) + 事件名 + 内容
+            if (record.size() < 16 || 16 + ReadUint(record, 12, 4) > record.size())
+            {
+                return RecordState::Malformed;
+            }
+            return RecordState::Ok;
+        }
+
+        // 删除一条排队中的事件并扣减计数；record 为空表示内容读不出来，按剩余记录重新统计
+        void EraseLocked(uint64 seq, const std::string* record)
+        {
+            if (db_)
+            {
+                db_->Delete(leveldb::WriteOptions(), KeyOf(seq));
+            }
+            else
+            {
+                memory_.erase(seq);
+            }
+            if (record)
+            {
+                stats_.spoolEvents -= std::min<uint64>(stats_.spoolEvents, 1);
+                stats_.spoolBytes -= std::min<uint64>(stats_.spoolBytes, record->size());
+            }
+            else
+            {
+                RecountLocked();
+            }
+        }
+
+        // 按 [firstSeq_, lastSeq_] 内实际存在的记录重新统计排队的事件数和字节数
+        void RecountLocked()
+        {
+            stats_.spoolEvents = 0;
+            stats_.spoolBytes = 0;
+            if (firstSeq_ == 0)
+            {
+                return;
+            }
+            if (!db_)
+            {
+                for (auto it = memory_.lower_bound(firstSeq_); it != memory_.end() && it->first <= lastSeq_; ++it)
+                {
+                    stats_.spoolEvents++;
+                    stats_.spoolBytes += it->second.size();
+                }
+                return;
+            }
+            std::string last = KeyOf(lastSeq_);
+            std::unique_ptr<leveldb::Iterator> iter(db_->NewIterator(leveldb::ReadOptions()));
+            for (iter->Seek(KeyOf(firstSeq_)); iter->Valid() && iter->key().compare(last) <= 0; iter->Next())
+            {
+                if (iter->key().size() == 12)
+                {
+                    stats_.spoolEvents++;
+                    stats_.spoolBytes += iter->value().size();
+                }
+            }
+        }
+
+        // 跳过 next 之前的序号，队列空了时 firstSeq_ 归 0
+        void AdvanceLocked(uint64 next)
+        {
+            firstSeq_ = std::max(firstSeq_, next);
+            if (firstSeq_ > lastSeq_)
+            {
+                firstSeq_ = 0;
+            }
+        }
+
+        void BackoffLocked(Clock::time_point now)
+        {
+            retryMs_ = retryMs_ == 0 ? config_.retryMinMs : std::min(retryMs_ * 2, config_.retryMaxMs);
+            nextUploadAt_ = now + std::chrono::milliseconds(retryMs_);
+        }
+
+        void DropOldestLocked()
+        {
+            std::string record;
+            RecordState state = ReadLocked(firstSeq_, record);
+            // 缺失的序号没有计入队列，直接跳过；其余的无论能否读出都删除并扣减计数
+            if (state != RecordState::Missing)
+            {
+                EraseLocked(firstSeq_, state == RecordState::Unreadable ? nullptr : &record);
+                stats_.dropped++;
+            }
+            firstSeq_++;
+        }
+
+        const ReportBatchProfile& ProfileLocked() const
+        {
+            switch (netType_)
+            {
+            case ZegoConnectionNetType::ZEGO_NT_LINE:
+            case ZegoConnectionNetType::ZEGO_NT_WIFI:
+                return config_.wifi;
+            case ZegoConnectionNetType::ZEGO_NT_2G:
+            case ZegoConnectionNetType::ZEGO_NT_3G:
+                return config_.slow;
+            default:
+                return config_.cellular;
+            }
+        }
+
+        bool FullBatchLocked() const
+        {
+            const ReportBatchProfile& profile = ProfileLocked();
+            return stats_.spoolBytes >= profile.maxBatchBytes || stats_.spoolEvents >= profile.maxBatchItems;
+        }
+
+        static void AppendJsonString(std::string& out, const std::string& value)
+        {
+            out.push_back('"');
+            for (char c : value)
+            {
+                switch (c)
+                {
+                case '"': out.append("\\\""); break;
+                case '\\': out.append("\\\\"); break;
+                case '\n': out.append("\\n"); break;
+                case '\r': out.append("\\r"); break;
+                case '\t': out.append("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                    {
+                        char escaped[8];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        out.append(escaped);
+                    }
+                    else
+                    {
+                        out.push_back(c);
+                    }
+                }
+            }
+            out.push_back('"');
+        }
+
+        // 批次格式: {"events":[{"event_name":"x","level":1,"time":1700000000000,"content":{...}},...]}
+        bool BuildBatchLocked(Batch& batch)
+        {
+            const ReportBatchProfile& profile = ProfileLocked();
+            batch.raw = "{\"events\":[";
+            std::string record;
+            for (uint64 seq = firstSeq_; seq != 0 && seq <= lastSeq_; seq++)
+            {
+                if (batch.items >= profile.maxBatchItems || (batch.items > 0 && batch.raw.size() >= profile.maxBatchBytes))
+                {
+                    break;
+                }
+                RecordState state = ReadLocked(seq, record);
+                if (state != RecordState::Ok)
+                {
+                    // 缺失的序号跳过，读不出或格式不对的记录删除，都不能挡住后面的事件
+                    if (state != RecordState::Missing)
+                    {
+                        EraseLocked(seq, state == RecordState::Unreadable ? nullptr : &record);
+                        stats_.corrupted++;
+                    }
+                    if (batch.items == 0)
+                    {
+                        AdvanceLocked(seq + 1);
+                    }
+                    continue;
+                }
+                uint32 nameSize = static_cast<uint32>(ReadUint(record, 12, 4));
+                if (batch.items == 0)
+                {
+                    batch.firstSeq = seq;
+                }
+                batch.lastSeq = seq;
+                batch.items++;
+                batch.recordBytes += record.size();
+                if (batch.items > 1)
+                {
+                    batch.raw.push_back(',');
+                }
+                batch.raw.append("{\"event_name\":");
+                AppendJsonString(batch.raw, record.substr(16, nameSize));
+                batch.raw.append(",\"level\":").append(std::to_string(ReadUint(record, 0, 4)));
+                batch.raw.append(",\"time\":").append(std::to_string(ReadUint(record, 4, 8)));
+                batch.raw.append(",\"content\":");
+                std::string content = record.substr(16 + nameSize);
+                if (!content.empty() && (content[0] == '{' || content[0] == '['))
+                {
+                    batch.raw.append(content);
+                }
+                else
+                {
+                    AppendJsonString(batch.raw, content);
+                }
+                batch.raw.push_back('}');
+            }
+            batch.raw.append("]}");
+            return batch.items > 0;
+        }
+
+        void OnUploaded(const Batch& batch, size_t compressedSize, bool ok)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                uploading_ = false;
+                Clock::time_point now = Clock::now();
+                if (ok)
+                {
+                    leveldb::WriteBatch deletes;
+                    bool unreadable = false;
+                    for (uint64 seq = std::max(batch.firstSeq, firstSeq_); seq <= batch.lastSeq; seq++)
+                    {
+                        std::string record;
+                        RecordState state = ReadLocked(seq, record);
+                        if (state == RecordState::Missing)
+                        {
+                            continue;
+                        }
+                        if (db_)
+                        {
+                            deletes.Delete(KeyOf(seq));
+                        }
+                        else
+                        {
+                            memory_.erase(seq);
+                        }
+                        if (state == RecordState::Unreadable)
+                        {
+                            unreadable = true;
+                            continue;
+                        }
+                        stats_.spoolEvents -= std::min<uint64>(stats_.spoolEvents, 1);
+                        stats_.spoolBytes -= std::min<uint64>(stats_.spoolBytes, record.size());
+                    }
+                    if (db_)
+                    {
+                        db_->Write(leveldb::WriteOptions(), &deletes);
+                    }
+                    AdvanceLocked(batch.lastSeq + 1);
+                    if (unreadable)
+                    {
+                        RecountLocked();
+                    }
+                    stats_.uploadedEvents += batch.items;
+                    stats_.uploadedBatches++;
+                    stats_.rawBytes += batch.raw.size();
+                    stats_.compressedBytes += compressedSize;
+                    retryMs_ = 0;
+                    nextUploadAt_ = FullBatchLocked() ? now : now + std::chrono::milliseconds(ProfileLocked().intervalMs);
+                }
+                else
+                {
+                    stats_.failedBatches++;
+                    BackoffLocked(now);
+                }
+                // 持锁通知：UnInit 等到 uploading_ 为 false 后可能立即析构
+                cv_.notify_all();
+            }
+        }
+
+        void Run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (running_)
+            {
+                // 攒满一个批次即上报，失败退避期间除外
+                bool due = flushRequested_ || Clock::now() >= nextUploadAt_ || (retryMs_ == 0 && FullBatchLocked());
+                bool online = netType_ != ZegoConnectionNetType::ZEGO_NT_NONE;
+                if (!due || !online || uploading_ || stats_.spoolEvents == 0)
+                {
+                    if (online && !uploading_ && stats_.spoolEvents > 0 && !flushRequested_)
+                    {
+                        cv_.wait_until(lock, nextUploadAt_);
+                    }
+                    else
+                    {
+                        if (stats_.spoolEvents == 0)
+                        {
+                            flushRequested_ = false;
+                        }
+                        cv_.wait(lock);
+                    }
+                    continue;
+                }
+                flushRequested_ = false;
+                std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+                if (!BuildBatchLocked(*batch))
+                {
+                    // 计数里有事件却一条也读不出：按磁盘重新统计；仍有删不掉的记录时按失败退避，不空转
+                    RecountLocked();
+                    if (stats_.spoolEvents > 0)
+                    {
+                        BackoffLocked(Clock::now());
+                    }
+                    continue;
+                }
+                uploading_ = true;
+                std::string dictionary = config_.dictionary;
+                OnReportUploadDelegate uploader = uploader_;
+                lock.unlock();
+
+                std::string body = Compress(batch->raw, dictionary);
+                size_t compressedSize = body.size();
+                uploader(body, [this, batch, compressedSize](bool ok) { OnUploaded(*batch, compressedSize, ok); });
+
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::thread thread_;
+        bool running_ = false;
+        bool uploading_ = false;
+        bool flushRequested_ = false;
+        ZCSeq monitorSeq_ = 0;
+
+        ReportSpoolConfig config_;
+        uLong dictionaryID_ = 0;
+        OnReportUploadDelegate uploader_;
+        ZegoConnectionNetType netType_ = ZegoConnectionNetType::ZEGO_NT_UNKNOWN;
+        Clock::time_point nextUploadAt_;
+        uint32 retryMs_ = 0;
+
+        leveldb::DB* db_ = nullptr;
+        std::map<uint64, std::string> memory_;  // 没有磁盘队列时使用
+        uint64 firstSeq_ = 0;                   // 队列中最早的事件，0 表示队列为空
+        uint64 lastSeq_ = 0;
+        ReportSpoolStats stats_;
+    };
+}
+
+}
+#endif /* zego_connection_report_spool_hpp */
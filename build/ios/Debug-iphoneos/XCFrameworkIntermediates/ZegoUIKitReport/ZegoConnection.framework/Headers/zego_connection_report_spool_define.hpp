@@ -0,0 +1,74 @@
+#ifndef zego_connection_report_spool_define_hpp
+#define zego_connection_report_spool_define_hpp
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "zego_connection_define.hpp"
+
+namespace ZEGO
+{
+
+namespace CONNECTION
+{
+    // 不同网络类型下的批量上报参数
+    struct ReportBatchProfile
+    {
+        uint32 intervalMs = 30 * 1000;      // 两次上报的间隔，积压超过一个批次时连续上报
+        uint32 maxBatchBytes = 128 * 1024;  // 单个批次压缩前的最大字节数
+        uint32 maxBatchItems = 500;         // 单个批次的最大事件数
+
+        ReportBatchProfile() = default;
+        ReportBatchProfile(uint32 interval, uint32 bytes, uint32 items) : intervalMs(interval), maxBatchBytes(bytes), maxBatchItems(items) {}
+    };
+
+    struct ReportSpoolConfig
+    {
+        std::string path;                               // 磁盘队列(leveldb)目录，为空时只在内存中排队，重启后丢失
+        std::string url;                                // 上报地址
+        std::vector<std::string> headers;               // 附加请求头，如鉴权 token
+        uint64 maxSpoolBytes = 16 * 1024 * 1024;        // 队列上限，超过后丢弃最早的事件
+        uint32 retryMinMs = 5 * 1000;                   // 上报失败后的首次重试间隔，之后翻倍
+        uint32 retryMaxMs = 10 * 60 * 1000;             // 重试间隔上限
+        std::string dictionary;                         // deflate 预置字典，为空时使用内置的上报字段字典
+        bool followNetMonitor = true;                   // 根据 ZegoConnectionMonitor 的网络类型切换批量参数
+
+        ReportBatchProfile wifi = ReportBatchProfile(10 * 1000, 256 * 1024, 1000);
+        ReportBatchProfile cellular = ReportBatchProfile(30 * 1000, 128 * 1024, 500);   // 4G/5G/未知
+        ReportBatchProfile slow = ReportBatchProfile(120 * 1000, 32 * 1024, 200);       // 2G/3G
+    };
+
+    struct ReportSpoolStats
+    {
+        uint64 appended = 0;            // 写入队列的事件数
+        uint64 dropped = 0;             // 因超过 maxSpoolBytes 丢弃的事件数
+        uint64 writeFailed = 0;         // 写入磁盘队列失败、没有入队的事件数
+        uint64 corrupted = 0;           // 读不出或格式错误、从队列中删除的事件数
+        uint64 uploadedEvents = 0;      // 上报成功的事件数
+        uint64 uploadedBatches = 0;     // 上报成功的批次数
+        uint64 failedBatches = 0;       // 上报失败的批次数
+        uint64 rawBytes = 0;            // 上报成功批次压缩前的字节数
+        uint64 compressedBytes = 0;     // 上报成功批次压缩后的字节数
+        uint64 spoolEvents = 0;         // 当前排队的事件数
+        uint64 spoolBytes = 0;          // 当前排队的字节数
+        uint64 recovered = 0;           // 启动时从磁盘恢复的事件数
+        ZegoConnectionNetType netType = ZegoConnectionNetType::ZEGO_NT_UNKNOWN;
+        uint32 batchIntervalMs = 0;     // 当前生效的上报间隔
+
+        double CompressionRatio() const
+        {
+            return compressedBytes == 0 ? 0.0 : static_cast<double>(rawBytes) / compressedBytes;
+        }
+    };
+
+    /**
+    批次上传函数
+
+    @param body deflate 压缩后的批次
+    @param done 上传完成回调，true 表示服务端已接收，队列中的事件随即删除
+    */
+    using OnReportUploadDelegate = std::function<void(const std::string& body, const std::function<void(bool ok)>& done)>;
+}
+}
+
+#endif /* zego_connection_report_spool_define_hpp */
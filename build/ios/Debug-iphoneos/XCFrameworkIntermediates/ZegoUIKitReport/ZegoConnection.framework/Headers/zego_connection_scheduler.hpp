@@ -0,0 +1,565 @@
+#ifndef zego_connection_scheduler_hpp
+#define zego_connection_scheduler_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <zegotask.h>
+#include "zego_connection_thread_pool_define.hpp"
+#include "utility/ZegoTraceHook.hpp"
+
+/*
+  ZegoConnectionThreadPool 的 WorkStealing 调度模式:
+  1、JOB_NO_BLOCK 任务: 每个工作线程一个双端队列，线程数默认等于核数。工作线程投递的任务进入自己的队列，
+     外部线程投递的任务进入公共注入队列；空闲的工作线程先取公共队列，再从其他线程的队列头部窃取。
+     投递时唤醒一个休眠的工作线程，取到任务后队列里还有任务时再唤醒下一个，休眠不设超时
+  2、JOB_MAYBE_BLOCK 任务: 独立的弹性线程，没有空闲线程时按需扩容到上限，空闲超时后缩回常驻个数。
+     dns、系统 api 等阻塞调用只会占用这一组线程，不会让短任务排队
+*/
+namespace ZEGO
+{
+
+namespace CONNECTION
+{
+    class ZegoConnectionScheduler
+    {
+    public:
+        using Job = std::function<void()>;
+
+        static std::shared_ptr<ZegoConnectionScheduler> GetInstance()
+        {
+            static std::shared_ptr<ZegoConnectionScheduler> instance(new ZegoConnectionScheduler());
+            return instance;
+        }
+
+        ~ZegoConnectionScheduler()
+        {
+            UnInit();
+        }
+
+        /**
+        启动调度线程
+
+        @param config 线程配置
+        @return 返回错误码，重复初始化返回 kZCSuccess
+        @notce
+        */
+        ZCError Init(const ThreadPoolSchedulerConfig& config)
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (inited_.load(std::memory_order_acquire))
+            {
+                return kZCSuccess;
+            }
+            if (config.blockingMaxThreads <= 0 || config.blockingMinThreads < 0 || config.blockingMinThreads > config.blockingMaxThreads)
+            {
+                return kZCEInvalidParams;
+            }
+            config_ = config;
+            int cpuWorkers = config.cpuWorkers > 0 ? config.cpuWorkers : static_cast<int>(std::thread::hardware_concurrency());
+            cpuWorkers = std::max(cpuWorkers, 1);
+
+            stopping_.store(false, std::memory_order_relaxed);
+            blocking_stop_ = false;
+            ResetStats();
+
+            workers_.clear();
+            for (int i = 0; i < cpuWorkers; i++)
+            {
+                workers_.emplace_back(new Worker());
+            }
+            for (int i = 0; i < cpuWorkers; i++)
+            {
+                workers_[i]->thread = std::thread([this, i]() { WorkerLoop(i); });
+            }
+            cpu_.threads = cpuWorkers;
+            cpu_.peakThreads = cpuWorkers;
+            {
+                std::lock_guard<std::mutex> blockingLock(blocking_mutex_);
+                for (int i = 0; i < config.blockingMinThreads; i++)
+                {
+                    SpawnBlockingThreadLocked();
+                }
+            }
+            inited_.store(true, std::memory_order_release);
+            return kZCSuccess;
+        }
+
+        /**
+        停止调度线程，已投递的任务执行完后返回
+
+        @notce 不能在调度线程中调用
+        */
+        void UnInit()
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (!inited_.exchange(false, std::memory_order_acq_rel))
+            {
+                return;
+            }
+            // 等待正在投递的调用完成，之后不会再有新任务
+            while (posting_.load(std::memory_order_acquire) > 0)
+            {
+                std::this_thread::yield();
+            }
+
+            stopping_.store(true, std::memory_order_seq_cst);
+            {
+                std::lock_guard<std::mutex> parkLock(park_mutex_);
+                park_cv_.notify_all();
+            }
+            for (auto& worker : workers_)
+            {
+                worker->thread.join();
+            }
+            workers_.clear();
+            cpu_.threads = 0;
+
+            std::unique_lock<std::mutex> blockingLock(blocking_mutex_);
+            blocking_stop_ = true;
+            blocking_cv_.notify_all();
+            blocking_exit_cv_.wait(blockingLock, [this]() { return blocking_threads_ == 0; });
+        }
+
+        bool IsInited() const
+        {
+            return inited_.load(std::memory_order_acquire);
+        }
+
+        /**
+        异步投递任务
+
+        @param job 需要投递的任务
+        @param job_type JOB_NO_BLOCK 进入 work-stealing 队列，JOB_MAYBE_BLOCK 进入阻塞线程
+        @param trace_name 安装了 CZegoTraceHook 时任务在 trace 中的名字，需为字符串常量，为空时用通道名 cpu/blocking
+        @return 任务 id，未初始化时返回 INVALID_TASKID，任务不会执行
+        @notce
+        */
+        task_id Post(Job&& job, JOB_RUNNABLE_TYPE job_type, const char* trace_name = nullptr)
+        {
+            posting_.fetch_add(1, std::memory_order_acq_rel);
+            task_id id = INVALID_TASKID;
+            if (inited_.load(std::memory_order_acquire))
+            {
+                id = NextTaskId();
+                Task task{std::move(job), std::chrono::steady_clock::now(), trace_name};
+                if (job_type == JOB_RUNNABLE_TYPE::JOB_NO_BLOCK)
+                {
+                    PostCpu(std::move(task));
+                }
+                else
+                {
+                    PostBlocking(std::move(task));
+                }
+            }
+            posting_.fetch_sub(1, std::memory_order_acq_rel);
+            return id;
+        }
+
+        /**
+        同步执行任务
+
+        @param waitMs 同步等待的时间 -1 默认无限等待 单位ms
+        @return 超时或未初始化返回 false
+        @notce 在工作线程上同步执行 JOB_NO_BLOCK 任务时直接在当前线程执行，避免等待自己
+        */
+        bool SyncRun(Job&& job, int waitMs, JOB_RUNNABLE_TYPE job_type)
+        {
+            if (job_type == JOB_RUNNABLE_TYPE::JOB_NO_BLOCK && CurrentWorker().owner == this)
+            {
+                job();
+                return true;
+            }
+            struct SyncState
+            {
+                std::mutex mutex;
+                std::condition_variable cv;
+                bool done = false;
+            };
+            auto state = std::make_shared<SyncState>();
+            auto task = std::make_shared<Job>(std::move(job));
+            task_id id = Post([state, task]() {
+                (*task)();
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done = true;
+                state->cv.notify_all();
+            }, job_type);
+            if (id == INVALID_TASKID)
+            {
+                return false;
+            }
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (waitMs < 0)
+            {
+                state->cv.wait(lock, [&]() { return state->done; });
+                return true;
+            }
+            return state->cv.wait_for(lock, std::chrono::milliseconds(waitMs), [&]() { return state->done; });
+        }
+
+        ThreadPoolSchedulerStats GetStats()
+        {
+            ThreadPoolSchedulerStats stats;
+            stats.mode = IsInited() ? ThreadPoolSchedulerMode::WorkStealing : ThreadPoolSchedulerMode::Default;
+            stats.cpu = cpu_.Snapshot();
+            stats.steals = steals_.load(std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(blocking_mutex_);
+                blocking_.threads = blocking_threads_;
+            }
+            stats.blocking = blocking_.Snapshot();
+            return stats;
+        }
+
+    private:
+        struct Task
+        {
+            Job job;
+            std::chrono::steady_clock::time_point enqueued;
+            const char* name;
+        };
+
+        struct alignas(64) Worker
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+            std::thread thread;
+        };
+
+        struct LaneCounters
+        {
+            std::atomic<uint32> threads{0};
+            std::atomic<uint32> peakThreads{0};
+            std::atomic<uint64> queueDepth{0};
+            std::atomic<uint64> peakQueueDepth{0};
+            std::atomic<uint64> completed{0};
+            std::atomic<uint64> totalLatencyUs{0};
+            std::atomic<uint64> maxLatencyUs{0};
+
+            void Reset()
+            {
+                peakThreads = 0;
+                queueDepth = 0;
+                peakQueueDepth = 0;
+                completed = 0;
+                totalLatencyUs = 0;
+                maxLatencyUs = 0;
+            }
+
+            void OnEnqueue()
+            {
+                uint64 depth = queueDepth.fetch_add(1, std::memory_order_seq_cst) + 1;
+                StoreMax(peakQueueDepth, depth);
+            }
+
+            void OnStart(const Task& task)
+            {
+                queueDepth.fetch_sub(1, std::memory_order_relaxed);
+                uint64 latency = static_cast<uint64>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - task.enqueued).count());
+                totalLatencyUs.fetch_add(latency, std::memory_order_relaxed);
+                completed.fetch_add(1, std::memory_order_relaxed);
+                StoreMax(maxLatencyUs, latency);
+            }
+
+            ThreadPoolLaneStats Snapshot() const
+            {
+                ThreadPoolLaneStats stats;
+                stats.threads = threads.load(std::memory_order_relaxed);
+                stats.peakThreads = peakThreads.load(std::memory_order_relaxed);
+                stats.queueDepth = queueDepth.load(std::memory_order_relaxed);
+                stats.peakQueueDepth = peakQueueDepth.load(std::memory_order_relaxed);
+                stats.completed = completed.load(std::memory_order_relaxed);
+                stats.avgLatencyUs = stats.completed > 0 ? totalLatencyUs.load(std::memory_order_relaxed) / stats.completed : 0;
+                stats.maxLatencyUs = maxLatencyUs.load(std::memory_order_relaxed);
+                return stats;
+            }
+
+            template <typename T>
+            static void StoreMax(std::atomic<T>& target, T value)
+            {
+                T current = target.load(std::memory_order_relaxed);
+                while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+                {
+                }
+            }
+        };
+
+        struct WorkerContext
+        {
+            ZegoConnectionScheduler* owner = nullptr;
+            int index = -1;
+        };
+
+        ZegoConnectionScheduler() = default;
+
+        static WorkerContext& CurrentWorker()
+        {
+            static thread_local WorkerContext context;
+            return context;
+        }
+
+        // 与 default task 一样从 1 开始递增，回绕时跳过 INVALID_TASKID
+        task_id NextTaskId()
+        {
+            task_id id = next_task_id_.fetch_add(1, std::memory_order_relaxed);
+            while (id == INVALID_TASKID)
+            {
+                id = next_task_id_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return id;
+        }
+
+        void ResetStats()
+        {
+            cpu_.Reset();
+            blocking_.Reset();
+            steals_ = 0;
+        }
+
+        void PostCpu(Task&& task)
+        {
+            WorkerContext& context = CurrentWorker();
+            cpu_.OnEnqueue();
+            if (context.owner == this)
+            {
+                Worker& worker = *workers_[context.index];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                worker.tasks.push_back(std::move(task));
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(inject_mutex_);
+                inject_.push_back(std::move(task));
+            }
+            // 与 Park 中 sleepers_ 自增后检查 queueDepth 配对，保证不会漏唤醒
+            WakeOne();
+        }
+
+        void WakeOne()
+        {
+            if (sleepers_.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard<std::mutex> lock(park_mutex_);
+                park_cv_.notify_one();
+            }
+        }
+
+        bool PopLocal(int index, Task& task)
+        {
+            Worker& worker = *workers_[index];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.tasks.empty())
+            {
+                return false;
+            }
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+
+        bool PopInject(Task& task)
+        {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            if (inject_.empty())
+            {
+                return false;
+            }
+            task = std::move(inject_.front());
+            inject_.pop_front();
+            return true;
+        }
+
+        // 先 try_lock 跳过正忙的队列；有队列没抢到锁时再阻塞地试一轮，返回 false 时确实没有可窃取的任务
+        bool Steal(int index, Task& task)
+        {
+            size_t count = workers_.size();
+            bool contended = false;
+            for (size_t i = 1; i < count; i++)
+            {
+                Worker& victim = *workers_[(index + i) % count];
+                std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+                if (!lock.owns_lock())
+                {
+                    contended = true;
+                    continue;
+                }
+                if (StealFrom(victim, task))
+                {
+                    return true;
+                }
+            }
+            for (size_t i = 1; contended && i < count; i++)
+            {
+                Worker& victim = *workers_[(index + i) % count];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (StealFrom(victim, task))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool StealFrom(Worker& victim, Task& task)
+        {
+            if (victim.tasks.empty())
+            {
+                return false;
+            }
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        void WorkerLoop(int index)
+        {
+            WorkerContext& context = CurrentWorker();
+            context.owner = this;
+            context.index = index;
+            Task task;
+            while (true)
+            {
+                if (PopLocal(index, task) || PopInject(task) || Steal(index, task))
+                {
+                    cpu_.OnStart(task);
+                    // 还有任务在排队时接力唤醒下一个休眠的线程，一次投递多个任务时不会只有一个线程在跑
+                    if (cpu_.queueDepth.load(std::memory_order_seq_cst) > 0)
+                    {
+                        WakeOne();
+                    }
+                    Execute(task, "cpu");
+                    continue;
+                }
+                if (stopping_.load(std::memory_order_acquire) && cpu_.queueDepth.load(std::memory_order_acquire) == 0)
+                {
+                    break;
+                }
+                Park();
+            }
+            context.owner = nullptr;
+            context.index = -1;
+        }
+
+        static void Execute(Task& task, const char* lane)
+        {
+            if (!BASE::CZegoTraceHook::Enabled())
+            {
+                task.job();
+                task.job = nullptr;
+                return;
+            }
+            long long posted = std::chrono::duration_cast<std::chrono::nanoseconds>(task.enqueued.time_since_epoch()).count();
+            long long begin = BASE::CZegoTraceHook::NowNs();
+            task.job();
+            task.job = nullptr;
+            BASE::CZegoTraceHook::Complete("thread_pool", task.name ? task.name : lane, begin, BASE::CZegoTraceHook::NowNs(), begin - posted);
+        }
+
+        void Park()
+        {
+            std::unique_lock<std::mutex> lock(park_mutex_);
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            // 投递方先增加 queueDepth 再检查 sleepers_，这里先增加 sleepers_ 再检查 queueDepth，两边至少有一方看到对方
+            park_cv_.wait(lock, [this]() {
+                return cpu_.queueDepth.load(std::memory_order_seq_cst) > 0 || stopping_.load(std::memory_order_seq_cst);
+            });
+            sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+
+        void PostBlocking(Task&& task)
+        {
+            std::lock_guard<std::mutex> lock(blocking_mutex_);
+            blocking_queue_.push_back(std::move(task));
+            blocking_.OnEnqueue();
+            if (blocking_queue_.size() > static_cast<size_t>(blocking_idle_) && blocking_threads_ < config_.blockingMaxThreads)
+            {
+                SpawnBlockingThreadLocked();
+            }
+            else
+            {
+                blocking_cv_.notify_one();
+            }
+        }
+
+        void SpawnBlockingThreadLocked()
+        {
+            blocking_threads_++;
+            LaneCounters::StoreMax(blocking_.peakThreads, static_cast<uint32>(blocking_threads_));
+            // 空闲退出的线程无法被 join，退出时通过 blocking_exit_cv_ 通知 UnInit
+            std::thread([this]() { BlockingLoop(); }).detach();
+        }
+
+        void BlockingLoop()
+        {
+            std::unique_lock<std::mutex> lock(blocking_mutex_);
+            while (true)
+            {
+                if (!blocking_queue_.empty())
+                {
+                    Task task = std::move(blocking_queue_.front());
+                    blocking_queue_.pop_front();
+                    lock.unlock();
+                    blocking_.OnStart(task);
+                    Execute(task, "blocking");
+                    lock.lock();
+                    continue;
+                }
+                if (blocking_stop_)
+                {
+                    break;
+                }
+                blocking_idle_++;
+                bool woken = blocking_cv_.wait_for(lock, std::chrono::milliseconds(config_.blockingIdleExitMs),
+                    [this]() { return blocking_stop_ || !blocking_queue_.empty(); });
+                blocking_idle_--;
+                if (!woken && blocking_threads_ > config_.blockingMinThreads)
+                {
+                    break;
+                }
+            }
+            blocking_threads_--;
+            blocking_exit_cv_.notify_all();
+        }
+
+    private:
+        ThreadPoolSchedulerConfig config_;
+        std::mutex state_mutex_;
+        std::atomic<bool> inited_{false};
+        std::atomic<int> posting_{0};
+        std::atomic<bool> stopping_{false};
+
+        // JOB_NO_BLOCK
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::mutex inject_mutex_;
+        std::deque<Task> inject_;
+        std::mutex park_mutex_;
+        std::condition_variable park_cv_;
+        std::atomic<int> sleepers_{0};
+        std::atomic<uint64> steals_{0};
+        std::atomic<task_id> next_task_id_{1};
+        LaneCounters cpu_;
+
+        // JOB_MAYBE_BLOCK
+        std::mutex blocking_mutex_;
+        std::condition_variable blocking_cv_;
+        std::condition_variable blocking_exit_cv_;
+        std::deque<Task> blocking_queue_;
+        int blocking_threads_ = 0;
+        int blocking_idle_ = 0;
+        bool blocking_stop_ = false;
+        LaneCounters blocking_;
+    };
+}// CONNECTION
+}// ZEGO
+
+
+#endif /* zego_connection_scheduler_hpp */
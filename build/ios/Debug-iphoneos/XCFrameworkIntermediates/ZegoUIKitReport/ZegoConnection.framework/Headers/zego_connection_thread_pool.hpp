@@ -4,11 +4,13 @@
 #include <memory>
 #include <zegotask.h>
 #include "zego_connection_thread_pool_define.hpp"
+#include "zego_connection_scheduler.hpp"
 
 /*
   ThreadPool 内部功能分为2部分: 
   1、threadpool 中会外部需要调用CreateTask 中来获取线程 用户需要使用ReleaseTask来归还线程给线程池
   2、defaulthreadpool 中是线程池中提供 一组独立的thread, 外部只需要 投递 任务即可，可能thread中的随机空闲线程执行
+  3、SetSchedulerMode(WorkStealing) 后 RunTask/SyncRunTask 改由 ZegoConnectionScheduler 执行，见 zego_connection_scheduler.hpp
 */
 namespace ZEGO
 {
@@ -84,12 +86,85 @@ namespace CONNECTION
         */
         bool SyncRunTaskInDefaultTask(ZegoJobRunnable&& job, int waitMs = -1, JOB_RUNNABLE_TYPE job_type = JOB_RUNNABLE_TYPE::JOB_MAYBE_BLOCK);
 
+        /**
+        切换 RunTask/SyncRunTask 的调度模式
+
+        @param mode Default 时走 default task；WorkStealing 时启动独立的 cpu 线程与弹性阻塞线程
+        @param config WorkStealing 模式的线程配置
+        @return 返回错误码
+        @notce 切回 Default 时会等待 WorkStealing 中已投递的任务执行完，不能在任务中调用
+        */
+        ZCError SetSchedulerMode(ThreadPoolSchedulerMode mode, const ThreadPoolSchedulerConfig& config = ThreadPoolSchedulerConfig());
+
+        /**
+        按当前调度模式异步投递任务，参数同 AnsycRunTaskInDefaultTask
+
+        @param trace_name 安装了 BASE::CZegoTraceHook 时任务在 trace 中的名字，需为字符串常量
+        @return 任务的 task_id，投递失败返回 INVALID_TASKID
+        @notce 两种模式下都会向 trace 报告任务的排队与执行耗时
+        */
+        task_id RunTask(ZegoJobRunnable&& job, JOB_RUNNABLE_TYPE job_type = JOB_RUNNABLE_TYPE::JOB_MAYBE_BLOCK, const char* trace_name = nullptr);
+
+        /**
+        按当前调度模式同步执行任务，参数同 SyncRunTaskInDefaultTask
+
+        @notce
+        */
+        bool SyncRunTask(ZegoJobRunnable&& job, int waitMs = -1, JOB_RUNNABLE_TYPE job_type = JOB_RUNNABLE_TYPE::JOB_MAYBE_BLOCK);
+
+        /**
+        获取调度统计：各通道线程数、排队深度、窃取次数、投递到执行的延迟
+
+        @notce Default 模式下统计为空
+        */
+        ThreadPoolSchedulerStats GetSchedulerStats();
+
     private:
         ZegoConnectionThreadPool();
 
     private:
         std::shared_ptr<CThreadPoolImpl> thread_pool_impl_;
     };
+
+    inline ZCError ZegoConnectionThreadPool::SetSchedulerMode(ThreadPoolSchedulerMode mode, const ThreadPoolSchedulerConfig& config)
+    {
+        auto scheduler = ZegoConnectionScheduler::GetInstance();
+        if (mode == ThreadPoolSchedulerMode::WorkStealing)
+        {
+            return scheduler->Init(config);
+        }
+        scheduler->UnInit();
+        return kZCSuccess;
+    }
+
+    inline task_id ZegoConnectionThreadPool::RunTask(ZegoJobRunnable&& job, JOB_RUNNABLE_TYPE job_type, const char* trace_name)
+    {
+        auto scheduler = ZegoConnectionScheduler::GetInstance();
+        if (scheduler->IsInited())
+        {
+            return scheduler->Post(std::move(job), job_type, trace_name);
+        }
+        if (BASE::CZegoTraceHook::Enabled())
+        {
+            return AnsycRunTaskInDefaultTask(BASE::CZegoTraceHook::Wrap("thread_pool", trace_name ? trace_name : "default_task", std::move(job)), job_type);
+        }
+        return AnsycRunTaskInDefaultTask(std::move(job), job_type);
+    }
+
+    inline bool ZegoConnectionThreadPool::SyncRunTask(ZegoJobRunnable&& job, int waitMs, JOB_RUNNABLE_TYPE job_type)
+    {
+        auto scheduler = ZegoConnectionScheduler::GetInstance();
+        if (scheduler->IsInited())
+        {
+            return scheduler->SyncRun(std::move(job), waitMs, job_type);
+        }
+        return SyncRunTaskInDefaultTask(std::move(job), waitMs, job_type);
+    }
+
+    inline ThreadPoolSchedulerStats ZegoConnectionThreadPool::GetSchedulerStats()
+    {
+        return ZegoConnectionScheduler::GetInstance()->GetStats();
+    }
 }// CONNECTION
 }// ZEGO
 
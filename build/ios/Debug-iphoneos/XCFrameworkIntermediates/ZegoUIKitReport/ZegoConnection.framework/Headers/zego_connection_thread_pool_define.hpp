@@ -21,6 +21,39 @@ namespace CONNECTION
         JOB_MAYBE_BLOCK = 0, 
         JOB_NO_BLOCK = 1, 
     };
+
+    enum class ThreadPoolSchedulerMode
+    {
+        Default = 0,        // 任务交给 default task 中的随机空闲线程
+        WorkStealing = 1,   // JOB_NO_BLOCK 走按核数分配的 work-stealing 队列，JOB_MAYBE_BLOCK 走独立的弹性阻塞线程
+    };
+
+    struct ThreadPoolSchedulerConfig
+    {
+        int cpuWorkers = 0;                 // JOB_NO_BLOCK 工作线程数，<=0 时取 CPU 核数
+        int blockingMinThreads = 1;         // 阻塞线程常驻个数
+        int blockingMaxThreads = 16;        // 阻塞线程上限，超过后任务排队
+        int blockingIdleExitMs = 60 * 1000; // 多于常驻个数的阻塞线程空闲多久退出
+    };
+
+    struct ThreadPoolLaneStats
+    {
+        uint32 threads = 0;            // 当前线程数
+        uint32 peakThreads = 0;        // 线程数峰值
+        uint64 queueDepth = 0;         // 等待执行的任务数
+        uint64 peakQueueDepth = 0;     // 等待任务数峰值
+        uint64 completed = 0;          // 已执行任务数
+        uint64 avgLatencyUs = 0;       // 投递到开始执行的平均耗时
+        uint64 maxLatencyUs = 0;       // 投递到开始执行的最大耗时
+    };
+
+    struct ThreadPoolSchedulerStats
+    {
+        ThreadPoolSchedulerMode mode = ThreadPoolSchedulerMode::Default;
+        ThreadPoolLaneStats cpu;
+        ThreadPoolLaneStats blocking;
+        uint64 steals = 0;             // 工作线程从其他线程队列窃取的任务数
+    };
     
 }// CONNECTION
 }// ZEGO
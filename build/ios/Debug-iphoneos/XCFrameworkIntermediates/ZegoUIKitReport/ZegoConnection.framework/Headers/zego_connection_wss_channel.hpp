@@ -0,0 +1,733 @@
+#ifndef zego_connection_wss_channel_hpp
+#define zego_connection_wss_channel_hpp
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_wss.hpp"
+
+/*
+  ZegoConnectionWssChannel: ZegoConnectionWssManage 实例之上的批量收发通道
+  1、Send 接收引用计数的 WssBuffer/WssBufferChain，入队只持有引用，发送时才拼接
+  2、大房间信令多为短小 JSON，合并后一帧发送，并按 permessage-deflate 方式保持上下文压缩，帧格式见 WssChannelConfig
+  3、接收时解压到池化缓冲区，逐条以 WssBufferView 回调，不为每条消息分配 string
+*/
+namespace ZEGO
+{
+
+namespace CONNECTION
+{
+    class ZegoConnectionWssChannel : public IWssInstanceCallback, public std::enable_shared_from_this<ZegoConnectionWssChannel>
+    {
+    public:
+        /**
+        创建通道及其 wss 实例
+
+        @param instance_config wss 实例配置
+        @param config 通道配置
+        @return 创建实例失败时返回 nullptr
+        */
+        static std::shared_ptr<ZegoConnectionWssChannel> Create(const WssInstanceConfig& instance_config, const WssChannelConfig& config = WssChannelConfig())
+        {
+            WssInstanceId id = ZegoConnectionWssManage::GetInstance()->CreateWssInstance(instance_config);
+            if (id == WssInstanceInvaildId)
+            {
+                return nullptr;
+            }
+            return std::shared_ptr<ZegoConnectionWssChannel>(new ZegoConnectionWssChannel(id, config));
+        }
+
+        ~ZegoConnectionWssChannel()
+        {
+            Close();
+            deflateEnd(&deflater_);
+            inflateEnd(&inflater_);
+        }
+
+        WssInstanceId GetInstanceId() const { return instanceId_; }
+
+        /**
+        链接服务
+
+        @param timeout 超时时间
+        @param callback 通道回调
+        @return 返回 false 时 wss 实例已被删除，通道不可再用
+        */
+        bool Connect(int timeout, std::weak_ptr<IWssChannelCallback> callback)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (closed_)
+                {
+                    return false;
+                }
+                callback_ = callback;
+            }
+            bool ok = ZegoConnectionWssManage::GetInstance()->ConnectWssServer(instanceId_, timeout, shared_from_this());
+            if (!ok)
+            {
+                // 实例已被删除，按 Close 的流程停止发送线程，不再断开和销毁实例
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    closed_ = true;
+                    connected_ = false;
+                    instanceId_ = WssInstanceInvaildId;
+                    cv_.notify_all();
+                }
+                JoinThread();
+            }
+            return ok;
+        }
+
+        /**
+        发送一条消息
+
+        @param chain 消息的各段，按顺序拼接
+        @return 未连接、已关闭或发送失败时返回 false
+        @attention OnConnect 成功后调用；开启 coalesce 时消息先入队，最迟 coalesceDelayMs 后发送。
+                   入队的消息发送失败，或压缩帧发送失败时通道断开，以 OnClosed 通知
+        */
+        bool Send(const WssBufferChain& chain)
+        {
+            size_t size = 0;
+            for (const WssBuffer& buffer : chain)
+            {
+                size += buffer.Size();
+            }
+
+            if (!config_.coalesce)
+            {
+                bool ok = false;
+                uint32 error = kZCSuccess;
+                {
+                    std::lock_guard<std::mutex> sendLock(sendMutex_);
+                    std::vector<WssBufferChain> batch(1, chain);
+                    ok = SendBatchLocked(batch, size, false, error);
+                }
+                if (error != kZCSuccess)
+                {
+                    OnSendError(error);
+                }
+                return ok;
+            }
+
+            bool full = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!connected_)
+                {
+                    return false;
+                }
+                if (pending_.empty())
+                {
+                    flushAt_ = Clock::now() + std::chrono::milliseconds(config_.coalesceDelayMs);
+                }
+                pending_.push_back(chain);
+                pendingBytes_ += size;
+                full = pendingBytes_ >= config_.maxFrameBytes;
+                if (pending_.size() == 1 && !full)
+                {
+                    cv_.notify_one();
+                }
+            }
+            if (full)
+            {
+                Flush();
+            }
+            return true;
+        }
+
+        bool Send(const WssBuffer& buffer)
+        {
+            return Send(WssBufferChain(1, buffer));
+        }
+
+        bool Send(std::string&& data)
+        {
+            return Send(WssBuffer::FromString(std::move(data)));
+        }
+
+        /**
+        立即发送已入队的消息
+        */
+        void Flush()
+        {
+            uint32 error = kZCSuccess;
+            {
+                std::lock_guard<std::mutex> sendLock(sendMutex_);
+                std::vector<WssBufferChain> batch;
+                size_t size = 0;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    batch.swap(pending_);
+                    size = pendingBytes_;
+                    pendingBytes_ = 0;
+                }
+                if (!batch.empty())
+                {
+                    SendBatchLocked(batch, size, true, error);
+                }
+            }
+            if (error != kZCSuccess)
+            {
+                OnSendError(error);
+            }
+        }
+
+        /**
+        发送剩余消息后断开并销毁 wss 实例
+        */
+        void Close()
+        {
+            Flush();
+            WssInstanceId id = WssInstanceInvaildId;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!closed_)
+                {
+                    closed_ = true;
+                    connected_ = false;
+                    id = instanceId_;
+                    cv_.notify_all();
+                }
+            }
+            // 已关闭时(如 Connect 失败)也要回收发送线程，否则析构时 std::thread 仍可 join
+            JoinThread();
+            if (id != WssInstanceInvaildId)
+            {
+                ZegoConnectionWssManage::GetInstance()->DisConnectWssServer(id);
+                ZegoConnectionWssManage::GetInstance()->DestroyWssInstance(id);
+            }
+        }
+
+        WssChannelStats GetStats()
+        {
+            std::lock_guard<std::mutex> sendLock(sendMutex_);
+            std::lock_guard<std::mutex> recvLock(recvMutex_);
+            WssChannelStats stats = sendStats_;
+            stats.messagesRecv = recvStats_.messagesRecv;
+            stats.framesRecv = recvStats_.framesRecv;
+            stats.bytesRecv = recvStats_.bytesRecv;
+            stats.wireBytesRecv = recvStats_.wireBytesRecv;
+            stats.decodeErrors = recvStats_.decodeErrors;
+            stats.poolHits = recvStats_.poolHits;
+            stats.poolMisses = recvStats_.poolMisses;
+            return stats;
+        }
+
+        /**
+        解析批量帧，供服务端或测试使用
+
+        @param data 批量帧头部之后的数据，压缩帧需先解压
+        @param visitor 每条消息回调一次
+        @return 格式错误返回 false
+        */
+        template <typename Visitor>
+        static bool ParseBatch(const char* data, size_t size, Visitor visitor)
+        {
+            size_t offset = 0;
+            while (offset < size)
+            {
+                uint64 length = 0;
+                int shift = 0;
+                while (true)
+                {
+                    if (offset >= size || shift > 35)
+                    {
+                        return false;
+                    }
+                    uint8 byte = static_cast<uint8>(data[offset++]);
+                    length |= static_cast<uint64>(byte & 0x7F) << shift;
+                    if ((byte & 0x80) == 0)
+                    {
+                        break;
+                    }
+                    shift += 7;
+                }
+                if (length > size - offset)
+                {
+                    return false;
+                }
+                visitor(data + offset, static_cast<size_t>(length));
+                offset += static_cast<size_t>(length);
+            }
+            return true;
+        }
+
+        static const char kBatchMagic0 = 'Z';
+        static const char kBatchMagic1 = 'W';
+        static const char kBatchVersion = 0x01;
+        static const uint8 kBatchFlagDeflate = 0x01;
+
+        // IWssInstanceCallback
+        void OnConnect(WssInstanceId instance_id, uint32 code, const std::string& message, bool local_net_connected) override
+        {
+            if (code == kZCSuccess)
+            {
+                // 新连接上双方从空的压缩上下文开始
+                std::lock_guard<std::mutex> sendLock(sendMutex_);
+                std::lock_guard<std::mutex> recvLock(recvMutex_);
+                deflateReset(&deflater_);
+                inflateReset(&inflater_);
+                std::lock_guard<std::mutex> lock(mutex_);
+                connected_ = !closed_;
+                closeReported_ = false;
+            }
+            std::shared_ptr<IWssChannelCallback> callback = GetCallback();
+            if (callback)
+            {
+                callback->OnConnect(instance_id, code, message, local_net_connected);
+            }
+        }
+
+        void OnClosed(WssInstanceId instance_id, uint32 code, const std::string& message) override
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!connected_ && closeReported_)
+                {
+                    // 解码或发送失败时已经通知过
+                    return;
+                }
+                connected_ = false;
+                pending_.clear();
+                pendingBytes_ = 0;
+            }
+            std::shared_ptr<IWssChannelCallback> callback = GetCallback();
+            if (callback)
+            {
+                callback->OnClosed(instance_id, code, message);
+            }
+        }
+
+        void OnRecv(WssInstanceId instance_id, const std::string& recv_data) override
+        {
+            std::shared_ptr<IWssChannelCallback> callback = GetCallback();
+            std::unique_lock<std::mutex> recvLock(recvMutex_);
+            recvStats_.framesRecv++;
+            recvStats_.wireBytesRecv += recv_data.size();
+
+            const char* data = recv_data.data();
+            size_t size = recv_data.size();
+            if (!IsBatchFrame(data, size))
+            {
+                recvStats_.messagesRecv++;
+                recvStats_.bytesRecv += size;
+                recvLock.unlock();
+                if (callback)
+                {
+                    WssBufferView view;
+                    view.data = data;
+                    view.size = size;
+                    callback->OnRecv(instance_id, view);
+                }
+                return;
+            }
+
+            std::shared_ptr<std::string> inflated;
+            const char* body = data + 4;
+            size_t bodySize = size - 4;
+            if (static_cast<uint8>(data[3]) & kBatchFlagDeflate)
+            {
+                inflated = AcquireBuffer();
+                if (!InflateLocked(body, bodySize, *inflated))
+                {
+                    OnDecodeErrorLocked(recvLock, instance_id, callback);
+                    return;
+                }
+                body = inflated->data();
+                bodySize = inflated->size();
+            }
+
+            std::vector<WssBufferView> views;
+            bool ok = ParseBatch(body, bodySize, [&](const char* message, size_t length) {
+                WssBufferView view;
+                view.data = message;
+                view.size = length;
+                view.owner = inflated;
+                views.push_back(view);
+            });
+            if (!ok)
+            {
+                OnDecodeErrorLocked(recvLock, instance_id, callback);
+                return;
+            }
+            recvStats_.messagesRecv += views.size();
+            for (const WssBufferView& view : views)
+            {
+                recvStats_.bytesRecv += view.size;
+            }
+            recvLock.unlock();
+
+            if (callback)
+            {
+                for (const WssBufferView& view : views)
+                {
+                    callback->OnRecv(instance_id, view);
+                }
+            }
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        // 接收缓冲池，缓冲区释放时连同容量一起放回，通道销毁后仍被持有的缓冲区正常释放
+        struct BufferPool
+        {
+            std::mutex mutex;
+            std::vector<std::string*> free;
+            size_t limit = 0;
+
+            ~BufferPool()
+            {
+                for (std::string* buffer : free)
+                {
+                    delete buffer;
+                }
+            }
+        };
+
+        static const size_t kPoolMaxCapacity = 1024 * 1024;
+
+        ZegoConnectionWssChannel(WssInstanceId id, const WssChannelConfig& config)
+            : instanceId_(id), config_(config), pool_(std::make_shared<BufferPool>())
+        {
+            pool_->limit = config_.poolBuffers;
+            memset(&deflater_, 0, sizeof(deflater_));
+            memset(&inflater_, 0, sizeof(inflater_));
+            // 负的 windowBits 为不带 zlib 头的 raw deflate，与 permessage-deflate 一致
+            deflateInit2(&deflater_, config_.deflateLevel, Z_DEFLATED, -config_.deflateWindowBits, 8, Z_DEFAULT_STRATEGY);
+            inflateInit2(&inflater_, -config_.deflateWindowBits);
+            if (config_.coalesce)
+            {
+                thread_ = std::thread([this]() { Run(); });
+            }
+        }
+
+        // closed_ 置位后调用，Connect 失败与 Close 可能并发，只由一方 join
+        void JoinThread()
+        {
+            std::lock_guard<std::mutex> joinLock(joinMutex_);
+            if (thread_.joinable())
+            {
+                thread_.join();
+            }
+        }
+
+        std::shared_ptr<IWssChannelCallback> GetCallback()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return callback_.lock();
+        }
+
+        static bool IsBatchFrame(const char* data, size_t size)
+        {
+            return size >= 4 && data[0] == kBatchMagic0 && data[1] == kBatchMagic1 && data[2] == kBatchVersion;
+        }
+
+        static void AppendVarint(std::string& out, uint64 value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        std::shared_ptr<std::string> AcquireBuffer()
+        {
+            std::string* buffer = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(pool_->mutex);
+                if (!pool_->free.empty())
+                {
+                    buffer = pool_->free.back();
+                    pool_->free.pop_back();
+                }
+            }
+            if (buffer)
+            {
+                recvStats_.poolHits++;
+                buffer->clear();
+            }
+            else
+            {
+                recvStats_.poolMisses++;
+                buffer = new std::string();
+            }
+            std::weak_ptr<BufferPool> weakPool = pool_;
+            return std::shared_ptr<std::string>(buffer, [weakPool](std::string* released) {
+                std::shared_ptr<BufferPool> pool = weakPool.lock();
+                if (pool && released->capacity() <= kPoolMaxCapacity)
+                {
+                    std::lock_guard<std::mutex> lock(pool->mutex);
+                    if (pool->free.size() < pool->limit)
+                    {
+                        pool->free.push_back(released);
+                        return;
+                    }
+                }
+                delete released;
+            });
+        }
+
+        // 持有 sendMutex_ 调用，保证压缩上下文和发送顺序一致。
+        // 发送失败时，若消息已入队(Send 已返回 true)或压缩上下文已前进，error 置为需要断开的错误码
+        bool SendBatchLocked(const std::vector<WssBufferChain>& batch, size_t size, bool queued, uint32& error)
+        {
+            WssInstanceId id = WssInstanceInvaildId;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!connected_)
+                {
+                    return false;
+                }
+                id = instanceId_;
+            }
+
+            const WssBufferChain& first = batch.front();
+            bool compress = config_.deflate && size >= config_.deflateMinBytes;
+            bool single = batch.size() == 1 && !compress;
+            if (single && first.size() == 1 && first.front().IsWhole() && !IsBatchFrame(first.front().Data(), first.front().Size()))
+            {
+                // 单条完整消息直接发送已有的 string，不做任何拼接
+                return Sent(ZegoConnectionWssManage::GetInstance()->SendWssData(id, *first.front().Storage()), 1, size, size, queued, error);
+            }
+
+            std::string& frame = frame_;
+            frame.clear();
+            if (single)
+            {
+                for (const WssBuffer& buffer : first)
+                {
+                    frame.append(buffer.Data(), buffer.Size());
+                }
+                if (!IsBatchFrame(frame.data(), frame.size()))
+                {
+                    return Sent(ZegoConnectionWssManage::GetInstance()->SendWssData(id, frame), 1, size, frame.size(), queued, error);
+                }
+                frame.clear();
+            }
+
+            std::string& body = compress ? scratch_ : frame;
+            body.clear();
+            if (!compress)
+            {
+                AppendHeader(body, 0);
+            }
+            for (const WssBufferChain& chain : batch)
+            {
+                size_t length = 0;
+                for (const WssBuffer& buffer : chain)
+                {
+                    length += buffer.Size();
+                }
+                AppendVarint(body, length);
+                for (const WssBuffer& buffer : chain)
+                {
+                    body.append(buffer.Data(), buffer.Size());
+                }
+            }
+            if (compress)
+            {
+                AppendHeader(frame, kBatchFlagDeflate);
+                if (!DeflateLocked(body, frame))
+                {
+                    sendStats_.sendErrors++;
+                    sendStats_.messagesLost += batch.size();
+                    error = kZCEAgentTCPNetReportWssEncodeError;
+                    return false;
+                }
+            }
+            return Sent(ZegoConnectionWssManage::GetInstance()->SendWssData(id, frame), batch.size(), size, frame.size(), queued || compress, error);
+        }
+
+        static void AppendHeader(std::string& out, uint8 flags)
+        {
+            const char header[4] = {kBatchMagic0, kBatchMagic1, kBatchVersion, static_cast<char>(flags)};
+            out.append(header, sizeof(header));
+        }
+
+        bool Sent(bool ok, size_t messages, size_t bytes, size_t wireBytes, bool fatal, uint32& error)
+        {
+            if (ok)
+            {
+                sendStats_.messagesSent += messages;
+                sendStats_.framesSent++;
+                sendStats_.bytesSent += bytes;
+                sendStats_.wireBytesSent += wireBytes;
+            }
+            else
+            {
+                sendStats_.sendErrors++;
+                sendStats_.messagesLost += messages;
+                if (fatal)
+                {
+                    error = kZCEAgentTCPWSocketSendFail;
+                }
+            }
+            return ok;
+        }
+
+        // RFC 7692 7.2.1: Z_SYNC_FLUSH 后去掉尾部的 00 00 ff ff
+        bool DeflateLocked(const std::string& in, std::string& out)
+        {
+            size_t start = out.size();
+            deflater_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+            deflater_.avail_in = static_cast<uInt>(in.size());
+            do
+            {
+                size_t used = out.size();
+                out.resize(used + deflateBound(&deflater_, deflater_.avail_in) + 16);
+                deflater_.next_out = reinterpret_cast<Bytef*>(&out[used]);
+                deflater_.avail_out = static_cast<uInt>(out.size() - used);
+                int ret = deflate(&deflater_, Z_SYNC_FLUSH);
+                out.resize(out.size() - deflater_.avail_out);
+                if (ret != Z_OK && ret != Z_BUF_ERROR)
+                {
+                    return false;
+                }
+            } while (deflater_.avail_in > 0 || deflater_.avail_out == 0);
+            if (out.size() - start >= 4 && memcmp(out.data() + out.size() - 4, "\x00\x00\xff\xff", 4) == 0)
+            {
+                out.resize(out.size() - 4);
+            }
+            return true;
+        }
+
+        bool InflateLocked(const char* in, size_t size, std::string& out)
+        {
+            static const char kTail[4] = {'\x00', '\x00', '\xff', '\xff'};
+            return InflateChunkLocked(in, size, out) && InflateChunkLocked(kTail, sizeof(kTail), out);
+        }
+
+        bool InflateChunkLocked(const char* in, size_t size, std::string& out)
+        {
+            inflater_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+            inflater_.avail_in = static_cast<uInt>(size);
+            while (inflater_.avail_in > 0)
+            {
+                size_t used = out.size();
+                out.resize(used + std::max<size_t>(size * 4, 1024));
+                inflater_.next_out = reinterpret_cast<Bytef*>(&out[used]);
+                inflater_.avail_out = static_cast<uInt>(out.size() - used);
+                int ret = inflate(&inflater_, Z_SYNC_FLUSH);
+                out.resize(out.size() - inflater_.avail_out);
+                if (ret != Z_OK && ret != Z_BUF_ERROR)
+                {
+                    return false;
+                }
+                if (ret == Z_BUF_ERROR && inflater_.avail_in > 0 && out.size() == used)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // 解压或解析失败后上下文已不可用，断开连接由上层重连
+        void OnDecodeErrorLocked(std::unique_lock<std::mutex>& recvLock, WssInstanceId instance_id, const std::shared_ptr<IWssChannelCallback>& callback)
+        {
+            recvStats_.decodeErrors++;
+            recvLock.unlock();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                connected_ = false;
+                closeReported_ = true;
+                pending_.clear();
+                pendingBytes_ = 0;
+            }
+            ZegoConnectionWssManage::GetInstance()->DisConnectWssServer(instance_id);
+            if (callback)
+            {
+                callback->OnClosed(instance_id, kZCEAgentTCPNetReportWssDecodeError, "wss batch frame decode error");
+            }
+        }
+
+        // 对端的解压上下文已与本端不一致，或 Send 已为丢失的消息返回 true，断开连接由上层重连，
+        // 重连后双方从空的压缩上下文开始。不持有任何锁调用
+        void OnSendError(uint32 error)
+        {
+            WssInstanceId id = WssInstanceInvaildId;
+            {
+                std::lock_guard<std::mutex> sendLock(sendMutex_);
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!connected_)
+                {
+                    return;
+                }
+                connected_ = false;
+                closeReported_ = true;
+                sendStats_.messagesLost += pending_.size();
+                pending_.clear();
+                pendingBytes_ = 0;
+                id = instanceId_;
+            }
+            ZegoConnectionWssManage::GetInstance()->DisConnectWssServer(id);
+            std::shared_ptr<IWssChannelCallback> callback = GetCallback();
+            if (callback)
+            {
+                callback->OnClosed(id, error, "wss channel send error");
+            }
+        }
+
+        void Run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!closed_)
+            {
+                if (pending_.empty())
+                {
+                    cv_.wait(lock);
+                    continue;
+                }
+                if (Clock::now() < flushAt_)
+                {
+                    cv_.wait_until(lock, flushAt_);
+                    continue;
+                }
+                lock.unlock();
+                Flush();
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex_;                  // 连接状态、回调和发送队列
+        std::condition_variable cv_;
+        std::thread thread_;
+        std::mutex joinMutex_;              // 只保护 thread_ 的 join
+        WssInstanceId instanceId_ = WssInstanceInvaildId;
+        WssChannelConfig config_;
+        std::weak_ptr<IWssChannelCallback> callback_;
+        bool connected_ = false;
+        bool closed_ = false;
+        bool closeReported_ = false;       // 解码或发送失败时已断开并通知，不再转发实例的 OnClosed
+        std::vector<WssBufferChain> pending_;
+        size_t pendingBytes_ = 0;
+        Clock::time_point flushAt_;
+
+        std::mutex sendMutex_;              // 压缩上下文、发送缓冲区和发送统计，先于 mutex_ 加锁
+        z_stream deflater_;
+        std::string frame_;
+        std::string scratch_;
+        WssChannelStats sendStats_;
+
+        std::mutex recvMutex_;              // 解压上下文和接收统计
+        z_stream inflater_;
+        std::shared_ptr<BufferPool> pool_;
+        WssChannelStats recvStats_;
+    };
+}
+}
+
+#endif /* zego_connection_wss_channel_hpp */
@@ -29,6 +29,104 @@ namespace CONNECTION
         virtual void OnRecv(WssInstanceId instance_id, const std::string&  recv_data) = 0;
     };
 
+    //引用计数的只读缓冲区，发送时只持有引用，不复制数据
+    class WssBuffer
+    {
+      public:
+        WssBuffer() {}
+        WssBuffer(const std::shared_ptr<const std::string>& storage) : storage_(storage), size_(storage ? storage->size() : 0) {}
+        WssBuffer(const std::shared_ptr<const std::string>& storage, size_t offset, size_t size) : storage_(storage), offset_(offset), size_(size) {}
+
+        static WssBuffer FromString(std::string&& data) { return WssBuffer(std::make_shared<const std::string>(std::move(data))); }
+        static WssBuffer Copy(const char* data, size_t size) { return WssBuffer(std::make_shared<const std::string>(data, size)); }
+
+        const char* Data() const { return storage_ ? storage_->data() + offset_ : nullptr; }
+        size_t Size() const { return size_; }
+        bool Empty() const { return size_ == 0; }
+        bool IsWhole() const { return storage_ && offset_ == 0 && size_ == storage_->size(); }
+        const std::shared_ptr<const std::string>& Storage() const { return storage_; }
+
+      private:
+        std::shared_ptr<const std::string> storage_;
+        size_t offset_ = 0;
+        size_t size_ = 0;
+    };
+
+    //一条消息由多段缓冲区顺序拼接而成，如协议头 + 消息体
+    using WssBufferChain = std::vector<WssBuffer>;
+
+    //收到的消息，只在回调期间有效，需要保留时调用 Retain
+    struct WssBufferView
+    {
+        const char* data = nullptr;
+        size_t size = 0;
+        std::shared_ptr<const std::string> owner;   //所在的池化缓冲区，为空时指向传输层的临时数据
+
+        std::string ToString() const { return std::string(data, size); }
+
+        //池化缓冲区上只增加引用计数，否则复制一份
+        WssBuffer Retain() const
+        {
+            if (owner)
+            {
+                return WssBuffer(owner, static_cast<size_t>(data - owner->data()), size);
+            }
+            return WssBuffer::Copy(data, size);
+        }
+    };
+
+    /*
+    批量帧格式，需要服务端同样开启，因此 coalesce、deflate 默认关闭，由各端点按服务端支持情况开启
+    'Z' 'W' 0x01 flags | varint(len) 消息 | varint(len) 消息 ...
+    flags bit0: 头部之后的数据经过 deflate 压缩，算法同 RFC 7692 permessage-deflate：
+                raw deflate，保持上下文(context takeover)，Z_SYNC_FLUSH 后去掉尾部 00 00 ff ff，
+                压缩上下文在每次连接成功后重置
+    不以该头部开始的帧按单条消息处理
+    */
+    struct WssChannelConfig
+    {
+        bool coalesce = false;                  //合并小消息为一帧发送
+        uint32 coalesceDelayMs = 5;             //首条消息入队后最多等待的时间
+        uint32 maxFrameBytes = 64 * 1024;       //单帧消息总字节数上限，达到后立即发送
+        bool deflate = false;                   //压缩批量帧
+        uint32 deflateMinBytes = 128;           //小于该字节数的帧不压缩
+        int deflateLevel = 6;
+        int deflateWindowBits = 15;             //收发双方需一致
+        uint32 poolBuffers = 32;                //接收缓冲池保留的缓冲区数量
+    };
+
+    struct WssChannelStats
+    {
+        uint64 messagesSent = 0;
+        uint64 framesSent = 0;          //实际调用 SendWssData 的次数
+        uint64 bytesSent = 0;           //消息原始字节数
+        uint64 wireBytesSent = 0;       //封装、压缩后的字节数
+        uint64 messagesRecv = 0;
+        uint64 framesRecv = 0;
+        uint64 bytesRecv = 0;
+        uint64 wireBytesRecv = 0;
+        uint64 decodeErrors = 0;
+        uint64 sendErrors = 0;          //SendWssData 或压缩失败的帧数
+        uint64 messagesLost = 0;        //失败帧中的消息数，以及因此断开时队列中未发送的消息数
+        uint64 poolHits = 0;            //接收时复用池化缓冲区的次数
+        uint64 poolMisses = 0;
+
+        double SendCompressionRatio() const
+        {
+            return wireBytesSent == 0 ? 0.0 : static_cast<double>(bytesSent) / wireBytesSent;
+        }
+    };
+
+    //ZegoConnectionWssChannel 回调，OnRecv 中的 view 指向池化缓冲区，回调返回后失效
+    class IWssChannelCallback
+    {
+      public:
+        virtual ~IWssChannelCallback(){};
+        virtual void OnConnect(WssInstanceId instance_id, uint32 code, const std::string& message, bool local_net_connected) = 0;
+        virtual void OnClosed(WssInstanceId instance_id, uint32 code, const std::string& message) = 0;
+        virtual void OnRecv(WssInstanceId instance_id, const WssBufferView& view) = 0;
+    };
+
     }
 }
 
@@ -0,0 +1,1135 @@
+#pragma once
+
+// stl
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// inner
+#include "../zlogger-interface.h"
+#include "../../utility/aes.h"
+
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief    内存映射的压缩二进制日志段
+ *
+ *   目录下的文件：
+ *     <base>.000001.zseg   预分配的段文件，由若干压缩块组成，写满后截断到实际长度再换下一个
+ *     <base>.tail          当前未封块的暂存区（明文经CTR加密后直接写入映射），进程崩溃后由下次启动或解码器恢复
+ *
+ *   块的处理顺序：文本行 -> LZ4 block 格式压缩 -> AES-CTR 加密（设置了 encrypt_key 时） -> CRC32
+ *   超过 block_size 的行拆到连续的多个块中，解码时按块顺序拼接还原
+ *   解码：zlogger::segment::decode_file，或 tools/zlog_decode 命令行工具，输出与文本 sink 相同的行格式
+ */
+
+namespace zlogger
+{
+namespace segment
+{
+    static const char     kSegmentMagic[8] = {'Z', 'L', 'O', 'G', 'S', 'E', 'G', '1'};
+    static const char     kTailMagic[8]    = {'Z', 'L', 'O', 'G', 'T', 'A', 'L', '1'};
+    static const uint32_t kBlockMagic      = 0x4B4C425A;  // "ZBLK"
+    static const uint32_t kFileHeaderSize  = 64;
+    static const uint32_t kFileVersion     = 2;
+    static const size_t   kMaxBlockSize    = size_t(16) << 24;  // CTR 计数器中块内序号占 3 字节
+
+    enum block_flags : uint32_t
+    {
+        block_compressed = 1,
+        block_encrypted  = 2,
+    };
+
+    struct file_header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint64_t seq;         // 段序号 或 暂存区对应的块序号
+        uint32_t flags;       // block_encrypted
+        uint32_t block_size;  // 暂存区：已提交的明文长度
+        uint64_t create_ms;
+        uint64_t nonce;  // 每个文件（暂存区每次重置）随机生成，同一密钥下各文件的密钥流互不相同
+        uint8_t  reserved[16];
+    };
+
+    struct block_header
+    {
+        uint32_t magic;
+        uint32_t raw_len;
+        uint32_t stored_len;
+        uint32_t flags;
+        uint64_t block_seq;
+        uint32_t crc;  // stored 字节的 CRC32
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(file_header) == kFileHeaderSize, "file_header size");
+    static_assert(sizeof(block_header) == 32, "block_header size");
+
+    inline uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0)
+    {
+        static uint32_t table[256];
+        static bool     init = [] {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++)
+                {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                table[i] = c;
+            }
+            return true;
+        }();
+        (void)init;
+        crc = ~crc;
+        for (size_t i = 0; i < len; i++)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    /**
+     * @brief    LZ4 block 格式压缩，压缩后不小于原文时返回 0（调用方原样存储）
+     */
+    inline size_t compress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap)
+    {
+        static const int    kHashBits     = 12;
+        static const size_t kLastLiterals = 5;
+        static const size_t kMatchLimit   = 12;
+
+        uint32_t table[1 << kHashBits];
+        memset(table, 0, sizeof(table));
+
+        auto read32 = [](const uint8_t* p) {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        };
+        uint8_t*       op     = dst;
+        uint8_t* const oend   = dst + cap;
+        size_t         anchor = 0;
+        auto write_length = [&](size_t v) {
+            while (v >= 255)
+            {
+                *op++ = 255;
+                v -= 255;
+            }
+            *op++ = static_cast<uint8_t>(v);
+        };
+
+        if (n > kMatchLimit)
+        {
+            size_t limit = n - kMatchLimit;
+            size_t ip    = 0;
+            while (ip < limit)
+            {
+                uint32_t seq = read32(src + ip);
+                uint32_t h   = (seq * 2654435761u) >> (32 - kHashBits);
+                size_t   ref = table[h];
+                table[h]     = static_cast<uint32_t>(ip);
+                if (ref >= ip || ip - ref > 65535 || read32(src + ref) != seq)
+                {
+                    ip++;
+                    continue;
+                }
+
+                size_t match     = 4;
+                size_t max_match = n - kLastLiterals - ip;
+                while (match < max_match && src[ref + match] == src[ip + match])
+                {
+                    match++;
+                }
+                size_t literals = ip - anchor;
+                if (op + 1 + literals / 255 + 1 + literals + 2 + (match - 4) / 255 + 1 > oend)
+                {
+                    return 0;
+                }
+                uint8_t* token = op++;
+                *token         = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+                if (literals >= 15)
+                {
+                    write_length(literals - 15);
+                }
+                memcpy(op, src + anchor, literals);
+                op += literals;
+                uint16_t offset = static_cast<uint16_t>(ip - ref);
+                *op++           = static_cast<uint8_t>(offset);
+                *op++           = static_cast<uint8_t>(offset >> 8);
+                size_t rest     = match - 4;
+                *token |= static_cast<uint8_t>(rest >= 15 ? 15 : rest);
+                if (rest >= 15)
+                {
+                    write_length(rest - 15);
+                }
+                ip += match;
+                anchor = ip;
+            }
+        }
+
+        size_t literals = n - anchor;
+        if (op + 1 + literals / 255 + 1 + literals > oend)
+        {
+            return 0;
+        }
+        *op++ = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+        if (literals >= 15)
+        {
+            write_length(literals - 15);
+        }
+        memcpy(op, src + anchor, literals);
+        op += literals;
+        size_t size = op - dst;
+        return size < n ? size : 0;
+    }
+
+    /**
+     * @brief    LZ4 block 解压，输入损坏时返回 false
+     */
+    inline bool decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_len)
+    {
+        size_t ip = 0;
+        size_t op = 0;
+        auto read_length = [&](size_t& v) {
+            uint8_t b;
+            do
+            {
+                if (ip >= n)
+                {
+                    return false;
+                }
+                b = src[ip++];
+                v += b;
+            } while (b == 255);
+            return true;
+        };
+        while (ip < n)
+        {
+            uint8_t token    = src[ip++];
+            size_t  literals = token >> 4;
+            if (literals == 15 && !read_length(literals))
+            {
+                return false;
+            }
+            if (literals > n - ip || literals > raw_len - op)
+            {
+                return false;
+            }
+            memcpy(dst + op, src + ip, literals);
+            ip += literals;
+            op += literals;
+            if (ip == n)
+            {
+                break;
+            }
+            if (n - ip < 2)
+            {
+                return false;
+            }
+            size_t offset = src[ip] | (src[ip + 1] << 8);
+            ip += 2;
+            size_t match = token & 15;
+            if (match == 15 && !read_length(match))
+            {
+                return false;
+            }
+            match += 4;
+            if (offset == 0 || offset > op || match > raw_len - op)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < match; i++, op++)
+            {
+                dst[op] = dst[op - offset];
+            }
+        }
+        return op == raw_len;
+    }
+
+    /**
+     * @brief    AES-CTR，计数器块 = nonce(8) | block_seq 低 32 位(4) | domain(1) | 块内16字节序号(3)，可从任意偏移加解密
+     *
+     *   nonce 取自文件头，block_seq 在文件内不重复，所以同一密钥下任意两个文件、两个块都不会复用密钥流
+     */
+    class ctr_cipher
+    {
+      public:
+        explicit ctr_cipher(const std::string& key)
+        {
+            enabled_ = !key.empty();
+            if (!enabled_)
+            {
+                return;
+            }
+            ZEGO::BASE::BYTE key_bytes[32] = {0};
+            memcpy(key_bytes, key.data(), std::min<size_t>(key.size(), sizeof(key_bytes)));
+            keysize_ = key.size() > 24 ? 256 : (key.size() > 16 ? 192 : 128);
+            ZEGO::BASE::aes_key_setup(key_bytes, schedule_, keysize_);
+        }
+
+        bool enabled() const { return enabled_; }
+
+        void apply(uint64_t nonce, uint64_t block_seq, uint32_t domain, size_t offset, uint8_t* data, size_t len) const
+        {
+            if (!enabled_)
+            {
+                return;
+            }
+            ZEGO::BASE::BYTE counter[AES_BLOCK_SIZE];
+            ZEGO::BASE::BYTE stream[AES_BLOCK_SIZE];
+            uint32_t         seq = static_cast<uint32_t>(block_seq);
+            memcpy(counter, &nonce, sizeof(nonce));
+            memcpy(counter + 8, &seq, sizeof(seq));
+            counter[12] = static_cast<ZEGO::BASE::BYTE>(domain);
+            size_t done = 0;
+            while (done < len)
+            {
+                size_t   position = offset + done;
+                uint32_t index    = static_cast<uint32_t>(position / AES_BLOCK_SIZE);
+                counter[13]       = static_cast<ZEGO::BASE::BYTE>(index);
+                counter[14]       = static_cast<ZEGO::BASE::BYTE>(index >> 8);
+                counter[15]       = static_cast<ZEGO::BASE::BYTE>(index >> 16);
+                ZEGO::BASE::aes_encrypt(counter, stream, schedule_, keysize_);
+                size_t skip = position % AES_BLOCK_SIZE;
+                size_t n    = std::min(len - done, AES_BLOCK_SIZE - skip);
+                for (size_t i = 0; i < n; i++)
+                {
+                    data[done + i] ^= stream[skip + i];
+                }
+                done += n;
+            }
+        }
+
+      private:
+        bool                 enabled_ = false;
+        int                  keysize_ = 0;
+        ZEGO::BASE::AES_WORD schedule_[60];
+    };
+
+    enum cipher_domain : uint32_t
+    {
+        domain_tail  = 0,
+        domain_block = 1,
+    };
+
+    inline const char* level_name(zlogger::level_enum lvl)
+    {
+        static const char* names[] = {"D", "I", "W", "E", "C", "O"};
+        int index = static_cast<int>(lvl);
+        return index >= 0 && index < static_cast<int>(zlogger::level_enum::n_levels) ? names[index] : "?";
+    }
+
+    /**
+     * @brief    解码一个 .zseg 或 .tail 文件，追加文本到 out
+     *
+     * @param    min_block_seq   只输出序号不小于此值的块，用于跳过已封入段文件的暂存区
+     * @param    last_block_seq  输出读到的最大块序号
+     * @return   false 表示文件无法识别；块损坏时停止解码，并在 error 中说明
+     */
+    inline bool decode_buffer(const uint8_t* data, size_t size, const std::string& key, uint64_t min_block_seq, std::string& out,
+      uint64_t& last_block_seq, std::string& error)
+    {
+        if (size < kFileHeaderSize)
+        {
+            error = "file too small";
+            return false;
+        }
+        file_header header;
+        memcpy(&header, data, sizeof(header));
+        ctr_cipher cipher(key);
+        if ((header.flags & block_encrypted) && !cipher.enabled())
+        {
+            error = "file is encrypted, key required";
+            return false;
+        }
+        if (header.version != kFileVersion)
+        {
+            error = "unsupported file version " + std::to_string(header.version);
+            return false;
+        }
+
+        if (memcmp(header.magic, kTailMagic, sizeof(kTailMagic)) == 0)
+        {
+            size_t len = std::min<size_t>(header.block_size, size - kFileHeaderSize);
+            if (len == 0 || header.seq < min_block_seq)
+            {
+                return true;
+            }
+            std::vector<uint8_t> plain(data + kFileHeaderSize, data + kFileHeaderSize + len);
+            if (header.flags & block_encrypted)
+            {
+                cipher.apply(header.nonce, header.seq, domain_tail, 0, plain.data(), plain.size());
+            }
+            out.append(reinterpret_cast<const char*>(plain.data()), plain.size());
+            last_block_seq = std::max(last_block_seq, header.seq);
+            return true;
+        }
+        if (memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0)
+        {
+            error = "unknown file magic";
+            return false;
+        }
+
+        std::vector<uint8_t> stored;
+        std::vector<uint8_t> raw;
+        size_t               offset = kFileHeaderSize;
+        while (offset + sizeof(block_header) <= size)
+        {
+            block_header block;
+            memcpy(&block, data + offset, sizeof(block));
+            if (block.magic != kBlockMagic)
+            {
+                break;  // 预分配的空白区
+            }
+            offset += sizeof(block);
+            if (block.stored_len > size - offset || crc32(data + offset, block.stored_len) != block.crc)
+            {
+                error = "corrupt block " + std::to_string(block.block_seq);
+                break;
+            }
+            if (block.block_seq >= min_block_seq)
+            {
+                stored.assign(data + offset, data + offset + block.stored_len);
+                if (block.flags & block_encrypted)
+                {
+                    cipher.apply(header.nonce, block.block_seq, domain_block, 0, stored.data(), stored.size());
+                }
+                if (block.flags & block_compressed)
+                {
+                    raw.resize(block.raw_len);
+                    if (!decompress(stored.data(), stored.size(), raw.data(), raw.size()))
+                    {
+                        error = "bad key or corrupt block " + std::to_string(block.block_seq);
+                        break;
+                    }
+                    out.append(reinterpret_cast<const char*>(raw.data()), raw.size());
+                }
+                else
+                {
+                    out.append(reinterpret_cast<const char*>(stored.data()), stored.size());
+                }
+            }
+            last_block_seq = std::max(last_block_seq, block.block_seq);
+            offset += (block.stored_len + 7) & ~7u;
+        }
+        return true;
+    }
+
+#if !defined(_WIN32)
+
+    inline bool decode_file(const std::string& path, const std::string& key, uint64_t min_block_seq, std::string& out,
+      uint64_t& last_block_seq, std::string& error)
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::vector<uint8_t> data;
+        uint8_t              chunk[65536];
+        size_t               n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            data.insert(data.end(), chunk, chunk + n);
+        }
+        fclose(file);
+        return decode_buffer(data.data(), data.size(), key, min_block_seq, out, last_block_seq, error);
+    }
+
+    /**
+     * @brief    可读写的共享文件映射
+     */
+    class mapped_file
+    {
+      public:
+        ~mapped_file() { close(); }
+
+        bool open(const std::string& path, size_t size)
+        {
+            close();
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (fd_ < 0)
+            {
+                return false;
+            }
+            struct stat st;
+            if (fstat(fd_, &st) != 0)
+            {
+                close();
+                return false;
+            }
+            if (static_cast<size_t>(st.st_size) < size)
+            {
+#if defined(__linux__) || defined(__ANDROID__)
+                // 真正分配磁盘块，避免写映射时才因空间不足收到 SIGBUS
+                if (posix_fallocate(fd_, 0, size) != 0 && ftruncate(fd_, size) != 0)
+#else
+                if (ftruncate(fd_, size) != 0)
+#endif
+                {
+                    close();
+                    return false;
+                }
+            }
+            else
+            {
+                size = static_cast<size_t>(st.st_size);
+            }
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (data == MAP_FAILED)
+            {
+                close();
+                return false;
+            }
+            data_ = static_cast<uint8_t*>(data);
+            size_ = size;
+            path_ = path;
+            return true;
+        }
+
+        // truncate_to 非0时关闭后把文件截断到实际使用长度
+        void close(size_t truncate_to = 0)
+        {
+            if (data_)
+            {
+                munmap(data_, size_);
+                data_ = nullptr;
+            }
+            if (fd_ >= 0)
+            {
+                if (truncate_to > 0 && ftruncate(fd_, truncate_to) != 0)
+                {
+                    // 截断失败只是浪费空间，解码器会跳过空白区
+                }
+                ::close(fd_);
+                fd_ = -1;
+            }
+            size_ = 0;
+        }
+
+        void sync(bool wait)
+        {
+            if (data_)
+            {
+                msync(data_, size_, wait ? MS_SYNC : MS_ASYNC);
+            }
+        }
+
+        uint8_t*           data() const { return data_; }
+        size_t             size() const { return size_; }
+        const std::string& path() const { return path_; }
+
+      private:
+        int         fd_   = -1;
+        uint8_t*    data_ = nullptr;
+        size_t      size_ = 0;
+        std::string path_;
+    };
+
+    /**
+     * @brief    把日志行写入内存映射段文件的 logger
+     *
+     *   文本行先写入 .tail 暂存区映射（进程崩溃不丢），暂存满 block_size 或 flush 时压缩加密后追加到段文件。
+     *   写入全程无 write/fsync 系统调用，落盘由内核回写完成。
+     */
+    class segment_logger : public ILogger
+    {
+      public:
+        segment_logger(const std::string& directory, const std::string& base_name, std::size_t segment_size, std::size_t max_segments,
+          const std::string& encrypt_key, std::size_t block_size)
+            : directory_(directory), base_name_(base_name), segment_size_(segment_size), max_segments_(max_segments),
+              block_size_(std::max<std::size_t>(std::min(block_size, kMaxBlockSize), 1)), cipher_(encrypt_key)
+        {
+            // nonce 只要求不重复，不要求不可预测
+            std::random_device device;
+            nonce_rng_.seed((static_cast<uint64_t>(device()) << 32) ^ device() ^
+                            static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+            // 段内至少能放下两个未压缩的块
+            segment_size_ = std::max(segment_size_, min_segment_size());
+            staging_.reserve(block_size_);
+            scratch_.resize(block_size_ + block_size_ / 255 + 16);
+            open_locked();
+        }
+
+        ~segment_logger() override
+        {
+            std::function<void(void)> on_logfull;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                seal_locked();
+                close_segment_locked();
+                tail_.close();
+                on_logfull = take_logfull_locked();
+            }
+            notify_logfull(on_logfull);
+        }
+
+        // set functions
+        void set_level(zlogger::level_enum log_level) override { level_.store(log_level, std::memory_order_relaxed); }
+
+        void set_headinfo(const std::string& headinfo) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            headinfo_ = headinfo;
+        }
+
+        void set_encrypt_key(const std::string& encrypt_key) override
+        {
+            std::function<void(void)> on_logfull;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                // 新密钥从下一个段文件开始生效，段内所有块使用同一密钥
+                seal_locked();
+                cipher_ = ctr_cipher(encrypt_key);
+                rotate_locked(false);
+                reset_tail_locked();
+                on_logfull = take_logfull_locked();
+            }
+            notify_logfull(on_logfull);
+        }
+
+        void set_limitlog_cfg(int64_t limit_ms) override { limit_ms_.store(limit_ms, std::memory_order_relaxed); }
+
+        void set_callback_logfull(std::function<void(void)> on_logfull) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            on_logfull_ = std::move(on_logfull);
+        }
+
+        zlogger::level_enum level() const override { return level_.load(std::memory_order_relaxed); }
+
+        // write functions
+        void write(std::vector<std::string> tag, zlogger::level_enum lvl, const char* module, int line, const std::string& msg) override
+        {
+            if (lvl < level_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            std::string text = format_line(tag, lvl, module, line, msg);
+            std::function<void(void)> on_logfull;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                append_locked(text);
+                if (lvl >= flush_level_.load(std::memory_order_relaxed))
+                {
+                    seal_locked();
+                    segment_.sync(false);
+                }
+                on_logfull = take_logfull_locked();
+            }
+            notify_logfull(on_logfull);
+        }
+
+        void write(std::vector<std::string> tag, zlogger::level_enum lvl, const char* module, int line, std::string&& msg) override
+        {
+            write(std::move(tag), lvl, module, line, static_cast<const std::string&>(msg));
+        }
+
+        void write_raw(zlogger::level_enum lvl, const std::string& msg) override
+        {
+            if (lvl < level_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            if (msg.empty())
+            {
+                return;
+            }
+            std::function<void(void)> on_logfull;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                append_locked(msg.back() == '\n' ? msg : msg + "\n");
+                on_logfull = take_logfull_locked();
+            }
+            notify_logfull(on_logfull);
+        }
+
+        void write_raw(zlogger::level_enum lvl, std::string&& msg) override { write_raw(lvl, static_cast<const std::string&>(msg)); }
+
+        void write_limit(const std::string& limit_key, std::vector<std::string> tag, zlogger::level_enum lvl, const char* module, int line,
+          const std::string& msg) override
+        {
+            int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            {
+                std::lock_guard<std::mutex> lock(limit_mutex_);
+                auto                        it = limit_last_.find(limit_key);
+                if (it != limit_last_.end() && now - it->second < limit_ms_.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+                limit_last_[limit_key] = now;
+            }
+            write(std::move(tag), lvl, module, line, msg);
+        }
+
+        // debug_buffer 由库内实现，本 logger 不支持
+        void debug_buffer_dump(ILogbuffer_ptr, size_t) override {}
+
+        // flush functions
+        void flush() override
+        {
+            std::function<void(void)> on_logfull;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                seal_locked();
+                segment_.sync(false);
+                on_logfull = take_logfull_locked();
+            }
+            notify_logfull(on_logfull);
+        }
+
+        void flush_on(zlogger::level_enum log_level) override { flush_level_.store(log_level, std::memory_order_relaxed); }
+
+        zlogger::level_enum flush_level() const override { return flush_level_.load(std::memory_order_relaxed); }
+
+        // full_name 为新的 <目录>/<base>，扩展名会被忽略
+        void change_file(const std::string& full_name) override
+        {
+            std::function<void(void)> on_logfull;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                seal_locked();
+                close_segment_locked();
+                tail_.close();
+                size_t slash = full_name.find_last_of("/\\");
+                directory_   = slash == std::string::npos ? "." : full_name.substr(0, slash);
+                base_name_   = slash == std::string::npos ? full_name : full_name.substr(slash + 1);
+                size_t dot   = base_name_.find('.');
+                if (dot != std::string::npos)
+                {
+                    base_name_.resize(dot);
+                }
+                open_locked();
+                on_logfull = take_logfull_locked();
+            }
+            notify_logfull(on_logfull);
+        }
+
+        void change_limit(std::size_t max_size, std::size_t max_files) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            segment_size_ = std::max(max_size, min_segment_size());
+            max_segments_ = max_files;
+        }
+
+        void set_threadname_callback(std::function<std::string(void)> callback) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            threadname_ = std::move(callback);
+        }
+
+      private:
+        std::size_t min_segment_size() const { return kFileHeaderSize + 2 * (sizeof(block_header) + block_size_ + 8); }
+
+        std::string segment_path(uint64_t seq) const
+        {
+            char name[32];
+            snprintf(name, sizeof(name), ".%06llu.zseg", static_cast<unsigned long long>(seq));
+            return directory_ + "/" + base_name_ + name;
+        }
+
+        std::string tail_path() const { return directory_ + "/" + base_name_ + ".tail"; }
+
+        std::string format_line(const std::vector<std::string>& tag, zlogger::level_enum lvl, const char* module, int line,
+          const std::string& msg)
+        {
+            auto    now = std::chrono::system_clock::now();
+            time_t  t   = std::chrono::system_clock::to_time_t(now);
+            int     ms  = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000);
+            struct tm tm_now;
+            localtime_r(&t, &tm_now);
+
+            std::string thread;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (threadname_)
+                {
+                    thread = threadname_();
+                }
+            }
+            if (thread.empty())
+            {
+                thread = std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000);
+            }
+
+            char head[64];
+            snprintf(head, sizeof(head), "[%04d-%02d-%02d %02d:%02d:%02d.%03d][%s][%s]", tm_now.tm_year + 1900, tm_now.tm_mon + 1,
+              tm_now.tm_mday, tm_now.tm_hour, tm_now.tm_min, tm_now.tm_sec, ms, level_name(lvl), thread.c_str());
+            std::string text(head);
+            for (const auto& t : tag)
+            {
+                text.append("[").append(t).append("]");
+            }
+            text.append("[").append(module ? module : "").append(":").append(std::to_string(line)).append("] ");
+            text.append(msg);
+            text.push_back('\n');
+            return text;
+        }
+
+        void open_locked()
+        {
+            // 找到已有的段文件，继续写最新一个
+            segments_.clear();
+            std::string prefix = base_name_ + ".";
+            if (DIR* dir = opendir(directory_.c_str()))
+            {
+                while (struct dirent* entry = readdir(dir))
+                {
+                    std::string name = entry->d_name;
+                    if (name.size() == prefix.size() + 11 && name.compare(0, prefix.size(), prefix) == 0 &&
+                        name.compare(name.size() - 5, 5, ".zseg") == 0)
+                    {
+                        segments_.push_back(strtoull(name.c_str() + prefix.size(), nullptr, 10));
+                    }
+                }
+                closedir(dir);
+            }
+            std::sort(segments_.begin(), segments_.end());
+
+            next_block_seq_ = 1;
+            if (!segments_.empty())
+            {
+                segment_seq_ = segments_.back();
+                scan_segment_locked();
+            }
+            else
+            {
+                segment_seq_ = 1;
+                segments_.push_back(segment_seq_);
+                create_segment_locked();
+            }
+            recover_tail_locked();
+        }
+
+        // 打开最新的段文件，定位到最后一个有效块之后
+        void scan_segment_locked()
+        {
+            // 按现有大小映射，不扩展
+            if (!segment_.open(segment_path(segment_seq_), 0))
+            {
+                rotate_locked(false);
+                return;
+            }
+            file_header header;
+            memcpy(&header, segment_.data(), sizeof(header));
+            bool encrypted = (header.flags & block_encrypted) != 0;
+            if (memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 || header.version != kFileVersion ||
+                encrypted != cipher_.enabled())
+            {
+                // 无法识别或密钥状态改变，另起一个段
+                rotate_locked(false);
+                return;
+            }
+            segment_nonce_ = header.nonce;
+            segment_offset_ = kFileHeaderSize;
+            while (segment_offset_ + sizeof(block_header) <= segment_.size())
+            {
+                block_header block;
+                memcpy(&block, segment_.data() + segment_offset_, sizeof(block));
+                if (block.magic != kBlockMagic || block.stored_len > segment_.size() - segment_offset_ - sizeof(block) ||
+                    crc32(segment_.data() + segment_offset_ + sizeof(block), block.stored_len) != block.crc)
+                {
+                    break;
+                }
+                next_block_seq_ = block.block_seq + 1;
+                segment_offset_ += sizeof(block) + ((block.stored_len + 7) & ~7u);
+            }
+            if (segment_.size() < segment_size_)
+            {
+                // 上次正常关闭时截断过，已经写满
+                rotate_locked(false);
+            }
+        }
+
+        void create_segment_locked()
+        {
+            if (!segment_.open(segment_path(segment_seq_), segment_size_))
+            {
+                return;
+            }
+            file_header header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+            header.version     = kFileVersion;
+            header.header_size = kFileHeaderSize;
+            header.seq         = segment_seq_;
+            header.nonce       = segment_nonce_ = nonce_rng_();
+            header.flags       = cipher_.enabled() ? block_encrypted : 0;
+            header.block_size  = static_cast<uint32_t>(block_size_);
+            header.create_ms   = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            memcpy(segment_.data(), &header, sizeof(header));
+            segment_offset_ = kFileHeaderSize;
+            if (!headinfo_.empty())
+            {
+                pending_headinfo_ = true;
+            }
+        }
+
+        void close_segment_locked()
+        {
+            if (segment_.data())
+            {
+                segment_.sync(false);
+                segment_.close(segment_offset_);
+            }
+        }
+
+        void rotate_locked(bool full)
+        {
+            close_segment_locked();
+            segment_seq_++;
+            segments_.push_back(segment_seq_);
+            while (max_segments_ > 0 && segments_.size() > max_segments_)
+            {
+                ::unlink(segment_path(segments_.front()).c_str());
+                segments_.erase(segments_.begin());
+            }
+            create_segment_locked();
+            // 回调可能再写日志，由持锁的调用方在解锁后调用
+            if (full && on_logfull_)
+            {
+                logfull_pending_ = true;
+            }
+        }
+
+        // 取出待调用的写满回调，调用方解锁后交给 notify_logfull
+        std::function<void(void)> take_logfull_locked()
+        {
+            if (!logfull_pending_)
+            {
+                return nullptr;
+            }
+            logfull_pending_ = false;
+            return on_logfull_;
+        }
+
+        static void notify_logfull(const std::function<void(void)>& on_logfull)
+        {
+            if (on_logfull)
+            {
+                on_logfull();
+            }
+        }
+
+        // 上次进程退出前未封块的暂存内容，补封进段文件
+        void recover_tail_locked()
+        {
+            size_t tail_size = kFileHeaderSize + block_size_;
+            if (!tail_.open(tail_path(), tail_size) || tail_.size() < tail_size)
+            {
+                return;
+            }
+            file_header header;
+            memcpy(&header, tail_.data(), sizeof(header));
+            bool valid = memcmp(header.magic, kTailMagic, sizeof(kTailMagic)) == 0;
+            if (valid && header.version == kFileVersion && header.seq >= next_block_seq_ && header.block_size > 0 &&
+                header.block_size <= block_size_)
+            {
+                bool encrypted = (header.flags & block_encrypted) != 0;
+                if (encrypted == cipher_.enabled())
+                {
+                    staging_.assign(tail_.data() + kFileHeaderSize, tail_.data() + kFileHeaderSize + header.block_size);
+                    cipher_.apply(header.nonce, header.seq, domain_tail, 0, staging_.data(), staging_.size());
+                    next_block_seq_ = header.seq;
+                    seal_locked();
+                }
+            }
+            reset_tail_locked();
+        }
+
+        void reset_tail_locked()
+        {
+            staging_.clear();
+            if (!tail_.data())
+            {
+                return;
+            }
+            file_header header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, kTailMagic, sizeof(kTailMagic));
+            header.version     = kFileVersion;
+            header.header_size = kFileHeaderSize;
+            header.seq         = next_block_seq_;
+            header.nonce       = tail_nonce_ = nonce_rng_();
+            header.flags       = cipher_.enabled() ? block_encrypted : 0;
+            header.block_size  = 0;
+            memcpy(tail_.data(), &header, sizeof(header));
+        }
+
+        void append_locked(const std::string& text)
+        {
+            if (pending_headinfo_)
+            {
+                pending_headinfo_ = false;
+                append_locked(headinfo_.back() == '\n' ? headinfo_ : headinfo_ + "\n");
+            }
+            // 放得进一个块的行不跨块，更长的行先填满当前块再依次写入后续的块
+            if (staging_.size() + text.size() > block_size_ && text.size() <= block_size_)
+            {
+                seal_locked();
+            }
+            size_t done = 0;
+            while (done < text.size())
+            {
+                if (staging_.size() == block_size_)
+                {
+                    seal_locked();
+                }
+                size_t len = std::min(text.size() - done, block_size_ - staging_.size());
+                stage_locked(text.data() + done, len);
+                done += len;
+            }
+        }
+
+        void stage_locked(const char* data, size_t len)
+        {
+            size_t offset = staging_.size();
+            staging_.insert(staging_.end(), data, data + len);
+            if (!tail_.data())
+            {
+                return;
+            }
+            uint8_t* dst = tail_.data() + kFileHeaderSize + offset;
+            memcpy(dst, data, len);
+            cipher_.apply(tail_nonce_, next_block_seq_, domain_tail, offset, dst, len);
+            // 长度最后更新，崩溃时最多丢失正在写的这一行
+            std::atomic_thread_fence(std::memory_order_release);
+            uint32_t committed = static_cast<uint32_t>(staging_.size());
+            memcpy(tail_.data() + offsetof(file_header, block_size), &committed, sizeof(committed));
+        }
+
+        void seal_locked()
+        {
+            if (staging_.empty())
+            {
+                return;
+            }
+            size_t  stored_len = compress(staging_.data(), staging_.size(), scratch_.data(), scratch_.size());
+            uint32_t flags     = block_compressed;
+            if (stored_len == 0)
+            {
+                stored_len = staging_.size();
+                memcpy(scratch_.data(), staging_.data(), stored_len);
+                flags = 0;
+            }
+
+            size_t need = sizeof(block_header) + ((stored_len + 7) & ~size_t(7));
+            if (!segment_.data() || segment_offset_ + need > segment_.size())
+            {
+                rotate_locked(true);
+            }
+            // 换段之后再加密，使用新段的 nonce
+            if (cipher_.enabled())
+            {
+                cipher_.apply(segment_nonce_, next_block_seq_, domain_block, 0, scratch_.data(), stored_len);
+                flags |= block_encrypted;
+            }
+            if (segment_.data() && segment_offset_ + need <= segment_.size())
+            {
+                block_header block;
+                block.magic      = kBlockMagic;
+                block.raw_len    = static_cast<uint32_t>(staging_.size());
+                block.stored_len = static_cast<uint32_t>(stored_len);
+                block.flags      = flags;
+                block.block_seq  = next_block_seq_;
+                block.crc        = crc32(scratch_.data(), stored_len);
+                block.reserved   = 0;
+                memcpy(segment_.data() + segment_offset_ + sizeof(block), scratch_.data(), stored_len);
+                // 块头最后写入，崩溃时不完整的块因 magic/crc 不符被忽略，内容仍在暂存区
+                std::atomic_thread_fence(std::memory_order_release);
+                memcpy(segment_.data() + segment_offset_, &block, sizeof(block));
+                segment_offset_ += need;
+            }
+            next_block_seq_++;
+            reset_tail_locked();
+        }
+
+        std::string directory_;
+        std::string base_name_;
+        std::size_t segment_size_;
+        std::size_t max_segments_;
+        std::size_t block_size_;
+        ctr_cipher  cipher_;
+
+        std::atomic<zlogger::level_enum> level_{zlogger::level_enum::info};
+        std::atomic<zlogger::level_enum> flush_level_{zlogger::level_enum::err};
+        std::atomic<int64_t>             limit_ms_{500};
+
+        std::mutex                                mutex_;
+        mapped_file                               segment_;
+        mapped_file                               tail_;
+        std::vector<uint64_t>                     segments_;
+        uint64_t                                  segment_seq_    = 0;
+        size_t                                    segment_offset_ = kFileHeaderSize;
+        uint64_t                                  next_block_seq_ = 1;
+        uint64_t                                  segment_nonce_  = 0;
+        uint64_t                                  tail_nonce_     = 0;
+        std::mt19937_64                           nonce_rng_;
+        std::vector<uint8_t>                      staging_;
+        std::vector<uint8_t>                      scratch_;
+        std::string                               headinfo_;
+        bool                                      pending_headinfo_ = false;
+        std::function<void(void)>                 on_logfull_;
+        bool                                      logfull_pending_ = false;
+        std::function<std::string(void)>          threadname_;
+
+        std::mutex                     limit_mutex_;
+        std::map<std::string, int64_t> limit_last_;
+    };
+
+#endif  // !defined(_WIN32)
+
+}  // namespace segment
+
+namespace factory
+{
+    namespace sync_logger
+    {
+        /**
+         * @brief    内存映射压缩段文件 logger，写满 max_segments 个段后删除最旧的段
+         *
+         * @param    directory       日志目录
+         * @param    base_name       文件名前缀
+         * @param    segment_size    单个段文件的预分配大小
+         * @param    max_segments    保留的段文件个数，0 为不限
+         * @param    encrypt_key     AES 密钥（16/24/32字节），传空则不加密
+         * @param    block_size      压缩块大小，也是崩溃时暂存区的大小
+         * @return   不支持的平台（windows）返回 nullptr
+         */
+        inline std::shared_ptr<ILogger> mmap_segment(const std::string& directory, const std::string& base_name,
+          std::size_t segment_size = 4 * 1024 * 1024, std::size_t max_segments = 10, const std::string& encrypt_key = "",
+          std::size_t block_size = 64 * 1024)
+        {
+#if !defined(_WIN32)
+            return std::make_shared<segment::segment_logger>(directory, base_name, segment_size, max_segments, encrypt_key, block_size);
+#else
+            return nullptr;
+#endif
+        }
+    }  // namespace sync_logger
+
+}  // namespace factory
+
+}  // namespace zlogger
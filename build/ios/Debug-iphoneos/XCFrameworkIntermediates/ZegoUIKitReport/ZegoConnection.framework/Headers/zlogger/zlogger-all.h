@@ -24,3 +24,9 @@
  *
  */
 #include "zlogger-macro.h"
+
+/**
+ * @brief    延迟格式化日志：调用线程只写二进制参数，格式化与sink在后台线程完成
+ *
+ */
+#include "zlogger-deferred.h"
@@ -0,0 +1,945 @@
+#pragma once
+
+// stl
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// inner
+#include "zlogger-interface.h"
+
+/**
+ * @brief    延迟格式化日志（deferred logger）
+ *
+ *   调用线程只做三件事：按level过滤、把 fmt 指针与参数的二进制值写入本线程独占的无锁环形缓冲、返回。
+ *   不分配内存、不调用 vsnprintf、不构造 tag 的 std::vector<std::string>。
+ *   后台线程按时间戳归并各线程的记录，完成格式化后调用内部 ILogger 的 write，
+ *   内部 ILogger 可以是任意现有工厂创建的 logger（rotating_file / daily_file / multi_sink ...）。
+ *
+ *    auto inner  = zlogger::factory::async_logger::rotating_file(path, 5 * 1024 * 1024, 3, "");
+ *    auto logger = zlogger::factory::deferred_logger::wrap(inner);
+ *    zlog_dfr_info(logger, ztag_id("room", "login"), "login seq:%u code:%d", seq, code);
+ *
+ *   限制：
+ *    1. fmt 必须是字符串字面量，__MODULE__ 必须是静态存储期的字符串（只保存指针）
+ *    2. 参数只支持 整型/枚举/浮点/指针/C字符串，与 zlogger_fmt 相同（std::string 需传 c_str()）
+ *    3. 环形缓冲写满时丢弃新日志并计数，不阻塞调用线程；丢弃数会定期以 warn 日志输出
+ *    4. 内部 logger 打印的时间为后台线程格式化的时间，最多滞后一个 flush_interval_ms
+ */
+
+namespace zlogger
+{
+namespace deferred
+{
+    using tag_id = uint16_t;
+
+    /**
+     * @brief    tag 集合注册表，每个调用点注册一次，之后只传递整型 id
+     */
+    class tag_registry
+    {
+      public:
+        static tag_registry& instance()
+        {
+            // 故意不释放：静态析构期间仍可能有日志
+            static tag_registry* inst = new tag_registry();
+            return *inst;
+        }
+
+        tag_id intern(std::initializer_list<const char*> tags)
+        {
+            std::vector<std::string> key;
+            key.reserve(tags.size());
+            for (const char* tag : tags)
+            {
+                key.emplace_back(tag ? tag : "");
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < tags_.size(); i++)
+            {
+                if (tags_[i] == key)
+                {
+                    return static_cast<tag_id>(i);
+                }
+            }
+            if (tags_.size() >= 0xFFFF)
+            {
+                return 0;
+            }
+            tags_.push_back(std::move(key));
+            return static_cast<tag_id>(tags_.size() - 1);
+        }
+
+        // deque 扩容不移动已有元素，返回的引用一直有效
+        const std::vector<std::string>& tags(tag_id id)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return id < tags_.size() ? tags_[id] : tags_[0];
+        }
+
+      private:
+        tag_registry() { tags_.emplace_back(); }  // id 0 为空tag
+
+        std::mutex                            mutex_;
+        std::deque<std::vector<std::string>> tags_;
+    };
+
+    /**
+     * @brief    单生产者单消费者字节环形缓冲，记录按8字节对齐，尾部放不下时写入长度为0的回绕标记
+     */
+    class spsc_ring
+    {
+      public:
+        explicit spsc_ring(size_t capacity) : buffer_(round_up_pow2(capacity)), mask_(buffer_.size() - 1) {}
+
+        size_t capacity() const { return buffer_.size(); }
+
+        // 生产者：预留 size 字节（size 已按8字节对齐），满时返回 nullptr
+        uint8_t* reserve(uint32_t size)
+        {
+            size_t head   = head_.load(std::memory_order_relaxed);
+            size_t offset = head & mask_;
+            size_t to_end = buffer_.size() - offset;
+            size_t need   = to_end < size ? to_end + size : size;
+            if (need > buffer_.size() - (head - cached_tail_))
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (need > buffer_.size() - (head - cached_tail_))
+                {
+                    return nullptr;
+                }
+            }
+            if (to_end < size)
+            {
+                uint32_t wrap = 0;
+                memcpy(&buffer_[offset], &wrap, sizeof(wrap));
+                head += to_end;
+                offset = 0;
+            }
+            reserved_head_ = head + size;
+            return &buffer_[offset];
+        }
+
+        void commit() { head_.store(reserved_head_, std::memory_order_release); }
+
+        // 生产者视角的已用字节数，可能偏大
+        size_t used() const { return head_.load(std::memory_order_relaxed) - cached_tail_; }
+
+        // 任意线程读取的待消费字节数，近似值；先读 tail_，保证结果不会为负
+        size_t pending() const
+        {
+            size_t tail = tail_.load(std::memory_order_acquire);
+            return head_.load(std::memory_order_acquire) - tail;
+        }
+
+        // 消费者：返回队首记录，空时返回 nullptr
+        const uint8_t* front()
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            while (tail != head_.load(std::memory_order_acquire))
+            {
+                size_t   offset = tail & mask_;
+                uint32_t size   = 0;
+                memcpy(&size, &buffer_[offset], sizeof(size));
+                if (size != 0)
+                {
+                    return &buffer_[offset];
+                }
+                tail += buffer_.size() - offset;
+                tail_.store(tail, std::memory_order_release);
+            }
+            return nullptr;
+        }
+
+        void pop(uint32_t size) { tail_.store(tail_.load(std::memory_order_relaxed) + size, std::memory_order_release); }
+
+        std::atomic<bool> orphaned{false};  // 所属线程已退出，排空后可回收
+        std::atomic<bool> closed{false};    // 所属 logger 已销毁
+
+      private:
+        static size_t round_up_pow2(size_t v)
+        {
+            size_t n = 1024;
+            while (n < v)
+            {
+                n <<= 1;
+            }
+            return n;
+        }
+
+        std::vector<uint8_t> buffer_;
+        size_t               mask_;
+        alignas(64) std::atomic<size_t> head_{0};
+        size_t reserved_head_ = 0;
+        size_t cached_tail_   = 0;
+        alignas(64) std::atomic<size_t> tail_{0};
+    };
+
+    struct record_header
+    {
+        uint32_t    size;  // 含头部与参数，0 为回绕标记
+        uint8_t     level;
+        uint8_t     reserved;
+        tag_id      tag;
+        int32_t     line;
+        int64_t     time;
+        const char* fmt;
+        const char* module;
+    };
+
+    enum arg_type : uint8_t
+    {
+        arg_i32,
+        arg_u32,
+        arg_i64,
+        arg_u64,
+        arg_f64,
+        arg_ptr,
+        arg_str,
+    };
+
+    static const uint32_t kMaxStringArg = 4096;
+
+    /**
+     * @brief    参数编码：1字节类型 + 值，字符串为 4字节长度 + 内容（不含'\0'）
+     */
+    template <typename T, typename Enable = void>
+    struct arg_codec;
+
+    template <typename T>
+    struct arg_codec<T, typename std::enable_if<std::is_integral<T>::value>::type>
+    {
+        static const bool big = sizeof(T) > 4;
+        typedef typename std::conditional<std::is_signed<T>::value, typename std::conditional<big, int64_t, int32_t>::type,
+          typename std::conditional<big, uint64_t, uint32_t>::type>::type stored;
+
+        static size_t size(T) { return 1 + sizeof(stored); }
+
+        static void write(uint8_t*& p, T v)
+        {
+            *p++     = std::is_signed<T>::value ? (big ? arg_i64 : arg_i32) : (big ? arg_u64 : arg_u32);
+            stored s = static_cast<stored>(v);
+            memcpy(p, &s, sizeof(s));
+            p += sizeof(s);
+        }
+    };
+
+    template <typename T>
+    struct arg_codec<T, typename std::enable_if<std::is_enum<T>::value>::type>
+    {
+        typedef arg_codec<typename std::underlying_type<T>::type> base;
+
+        static size_t size(T v) { return base::size(static_cast<typename std::underlying_type<T>::type>(v)); }
+        static void   write(uint8_t*& p, T v) { base::write(p, static_cast<typename std::underlying_type<T>::type>(v)); }
+    };
+
+    template <typename T>
+    struct arg_codec<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+    {
+        static size_t size(T) { return 1 + sizeof(double); }
+
+        static void write(uint8_t*& p, T v)
+        {
+            *p++     = arg_f64;
+            double d = static_cast<double>(v);
+            memcpy(p, &d, sizeof(d));
+            p += sizeof(d);
+        }
+    };
+
+    template <typename T>
+    struct arg_codec<T*, typename std::enable_if<!std::is_same<typename std::remove_cv<T>::type, char>::value>::type>
+    {
+        static size_t size(const T*) { return 1 + sizeof(uint64_t); }
+
+        static void write(uint8_t*& p, const T* v)
+        {
+            *p++       = arg_ptr;
+            uint64_t u = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(v));
+            memcpy(p, &u, sizeof(u));
+            p += sizeof(u);
+        }
+    };
+
+    struct string_codec
+    {
+        static uint32_t length(const char* v)
+        {
+            if (!v)
+            {
+                return 6;  // "(null)"
+            }
+            size_t n = strlen(v);
+            return n < kMaxStringArg ? static_cast<uint32_t>(n) : kMaxStringArg;
+        }
+
+        static size_t size(const char* v) { return 1 + sizeof(uint32_t) + length(v); }
+
+        static void write(uint8_t*& p, const char* v)
+        {
+            uint32_t n = length(v);
+            *p++       = arg_str;
+            memcpy(p, &n, sizeof(n));
+            p += sizeof(n);
+            memcpy(p, v ? v : "(null)", n);
+            p += n;
+        }
+    };
+
+    template <>
+    struct arg_codec<char*> : string_codec
+    {};
+    template <>
+    struct arg_codec<const char*> : string_codec
+    {};
+
+    template <typename T>
+    using arg_codec_of = arg_codec<typename std::decay<T>::type>;
+
+    inline size_t args_size() { return 0; }
+
+    template <typename T, typename... Args>
+    inline size_t args_size(const T& v, const Args&... args)
+    {
+        return arg_codec_of<T>::size(v) + args_size(args...);
+    }
+
+    inline void args_write(uint8_t*&) {}
+
+    template <typename T, typename... Args>
+    inline void args_write(uint8_t*& p, const T& v, const Args&... args)
+    {
+        arg_codec_of<T>::write(p, v);
+        args_write(p, args...);
+    }
+
+    /**
+     * @brief    只用于编译期格式检查，不会被调用
+     */
+    inline void check_fmt(ZLOGGER_ATTR_CHECK_FMTVAR const char* fmt, ...) ZLOGGER_ATTR_CHECK_FMT(1, 2);
+    inline void check_fmt(const char*, ...) {}
+
+    /**
+     * @brief    按 fmt 逐个转换说明符解码参数并格式化，长度修饰符按参数实际宽度重写
+     */
+    class record_formatter
+    {
+      public:
+        void format(const char* fmt, const uint8_t* args, const uint8_t* end, std::string& out)
+        {
+            out.clear();
+            const char* p = fmt;
+            while (*p)
+            {
+                const char* percent = strchr(p, '%');
+                if (!percent)
+                {
+                    out.append(p);
+                    break;
+                }
+                out.append(p, percent - p);
+                p = percent + 1;
+                if (*p == '%')
+                {
+                    out.push_back('%');
+                    p++;
+                    continue;
+                }
+
+                char   spec[spec_size];
+                size_t n  = 0;
+                spec[n++] = '%';
+                while (*p && strchr("-+ #0", *p) && n < 8)
+                {
+                    spec[n++] = *p++;
+                }
+                if (!read_field(p, args, end, spec, n, false))
+                {
+                    break;
+                }
+                if (*p == '.')
+                {
+                    spec[n++] = *p++;
+                    if (!read_field(p, args, end, spec, n, true))
+                    {
+                        break;
+                    }
+                }
+                while (*p && strchr("hlLqjzt", *p))
+                {
+                    p++;
+                }
+                char conv = *p;
+                if (!conv)
+                {
+                    break;
+                }
+                p++;
+                append_arg(spec, n, conv, args, end, out);
+            }
+        }
+
+      private:
+        // 最长的转换说明：'%' + 7 个标志 + '*' 宽度 (11) + '.' + '*' 精度 (11) + 长度修饰 (2) + 转换符 + '\0' = 35
+        static const size_t spec_size = 48;
+
+        // 宽度/精度：数字原样拷贝，'*' 从参数中取；与 printf 相同，负的精度视为未指定，连同 '.' 一起去掉
+        bool read_field(const char*& p, const uint8_t*& args, const uint8_t* end, char* spec, size_t& n, bool precision)
+        {
+            if (*p == '*')
+            {
+                p++;
+                int64_t value = 0;
+                if (!read_integer(args, end, value))
+                {
+                    return false;
+                }
+                if (precision && static_cast<int>(value) < 0)
+                {
+                    n--;
+                    return true;
+                }
+                int written = snprintf(spec + n, spec_size - n, "%d", static_cast<int>(value));
+                if (written > 0)
+                {
+                    n += static_cast<size_t>(written) < spec_size - n ? static_cast<size_t>(written) : spec_size - n - 1;
+                }
+                return true;
+            }
+            size_t digits = 0;
+            while (*p >= '0' && *p <= '9')
+            {
+                if (digits++ < 6)
+                {
+                    spec[n++] = *p;
+                }
+                p++;
+            }
+            return true;
+        }
+
+        static bool read_integer(const uint8_t*& args, const uint8_t* end, int64_t& value)
+        {
+            if (args >= end)
+            {
+                return false;
+            }
+            uint8_t type = *args++;
+            if (type == arg_i32 || type == arg_u32)
+            {
+                int32_t v = 0;
+                memcpy(&v, args, sizeof(v));
+                args += sizeof(v);
+                value = v;
+                return true;
+            }
+            if (type == arg_i64 || type == arg_u64)
+            {
+                memcpy(&value, args, sizeof(value));
+                args += sizeof(value);
+                return true;
+            }
+            return false;
+        }
+
+        void append_arg(char* spec, size_t n, char conv, const uint8_t*& args, const uint8_t* end, std::string& out)
+        {
+            if (args >= end)
+            {
+                out.append("<?>");
+                return;
+            }
+            uint8_t type = *args++;
+            switch (type)
+            {
+                case arg_i32:
+                case arg_u32: {
+                    uint32_t v = 0;
+                    memcpy(&v, args, sizeof(v));
+                    args += sizeof(v);
+                    if (!is_integer_conv(conv))
+                    {
+                        out.append("<?>");
+                        return;
+                    }
+                    finish(spec, n, "", conv);
+                    if (type == arg_i32)
+                        append(out, spec, static_cast<int32_t>(v));
+                    else
+                        append(out, spec, v);
+                    return;
+                }
+                case arg_i64:
+                case arg_u64: {
+                    uint64_t v = 0;
+                    memcpy(&v, args, sizeof(v));
+                    args += sizeof(v);
+                    if (!is_integer_conv(conv) || conv == 'c')
+                    {
+                        out.append("<?>");
+                        return;
+                    }
+                    finish(spec, n, "ll", conv);
+                    if (type == arg_i64)
+                        append(out, spec, static_cast<long long>(v));
+                    else
+                        append(out, spec, static_cast<unsigned long long>(v));
+                    return;
+                }
+                case arg_f64: {
+                    double v = 0;
+                    memcpy(&v, args, sizeof(v));
+                    args += sizeof(v);
+                    if (!strchr("eEfFgGaA", conv))
+                    {
+                        out.append("<?>");
+                        return;
+                    }
+                    finish(spec, n, "", conv);
+                    append(out, spec, v);
+                    return;
+                }
+                case arg_ptr: {
+                    uint64_t v = 0;
+                    memcpy(&v, args, sizeof(v));
+                    args += sizeof(v);
+                    finish(spec, n, "", 'p');
+                    append(out, spec, reinterpret_cast<void*>(static_cast<uintptr_t>(v)));
+                    return;
+                }
+                case arg_str: {
+                    uint32_t len = 0;
+                    memcpy(&len, args, sizeof(len));
+                    args += sizeof(len);
+                    const char* s = reinterpret_cast<const char*>(args);
+                    args += len;
+                    if (conv != 's')
+                    {
+                        out.append("<?>");
+                        return;
+                    }
+                    if (n == 1)
+                    {
+                        out.append(s, len);
+                        return;
+                    }
+                    string_.assign(s, len);
+                    finish(spec, n, "", 's');
+                    append(out, spec, string_.c_str());
+                    return;
+                }
+                default:
+                    // 编码损坏，丢弃剩余参数
+                    args = end;
+                    out.append("<?>");
+                    return;
+            }
+        }
+
+        static bool is_integer_conv(char conv) { return strchr("diouxXc", conv) != nullptr; }
+
+        static void finish(char* spec, size_t n, const char* length, char conv)
+        {
+            while (*length)
+            {
+                spec[n++] = *length++;
+            }
+            spec[n++] = conv;
+            spec[n]   = '\0';
+        }
+
+        template <typename T>
+        static void append(std::string& out, const char* spec, T value)
+        {
+            char buf[128];
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#endif
+            int len = snprintf(buf, sizeof(buf), spec, value);
+            if (len < 0)
+            {
+                return;
+            }
+            if (static_cast<size_t>(len) < sizeof(buf))
+            {
+                out.append(buf, len);
+                return;
+            }
+            size_t old = out.size();
+            out.resize(old + len + 1);
+            snprintf(&out[old], len + 1, spec, value);
+            out.resize(old + len);
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+        }
+
+        std::string string_;
+    };
+
+    /**
+     * @brief    延迟格式化 logger，通过 factory::deferred_logger::wrap 创建
+     */
+    class logger
+    {
+      public:
+        logger(ILogger_ptr inner, size_t ring_size, int64_t flush_interval_ms)
+            : inner_(std::move(inner)), ring_size_(ring_size), flush_interval_(std::chrono::milliseconds(flush_interval_ms)),
+              id_(next_id()), level_(inner_ ? inner_->level() : zlogger::level_enum::info)
+        {
+            worker_ = std::thread([this]() { run(); });
+        }
+
+        ~logger()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            worker_.join();
+
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            for (auto& ring : rings_)
+            {
+                ring->closed.store(true, std::memory_order_release);
+            }
+        }
+
+        logger(const logger&) = delete;
+        logger& operator=(const logger&) = delete;
+
+        ILogger_ptr inner() const { return inner_; }
+
+        void set_level(zlogger::level_enum log_level)
+        {
+            level_.store(log_level, std::memory_order_relaxed);
+            if (inner_)
+            {
+                inner_->set_level(log_level);
+            }
+        }
+
+        zlogger::level_enum level() const { return level_.load(std::memory_order_relaxed); }
+
+        // 环形缓冲满而丢弃的日志条数
+        uint64_t dropped_count() const { return dropped_.load(std::memory_order_relaxed); }
+
+        // 各线程缓冲中尚未交给内部 logger 的字节数，供性能采样读取队列深度
+        size_t pending_bytes()
+        {
+            size_t bytes = 0;
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            for (auto& ring : rings_)
+            {
+                bytes += ring->pending();
+            }
+            return bytes;
+        }
+
+        /**
+         * @brief    等待此前写入的日志全部交给内部 logger，再 flush 内部 logger
+         */
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            uint64_t                     target = ++flush_requested_;
+            cv_.notify_all();
+            flushed_cv_.wait(lock, [&]() { return flush_done_ >= target || stop_; });
+            lock.unlock();
+            if (inner_)
+            {
+                inner_->flush();
+            }
+        }
+
+        template <typename... Args>
+        void log(tag_id tag, zlogger::level_enum lvl, const char* module, int line, const char* fmt, const Args&... args)
+        {
+            if (lvl < level_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            spsc_ring* ring = local_ring();
+            size_t     size = (sizeof(record_header) + args_size(args...) + 7) & ~size_t(7);
+            uint8_t*   p    = size <= ring->capacity() / 4 ? ring->reserve(static_cast<uint32_t>(size)) : nullptr;
+            if (!p)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            record_header header;
+            header.size     = static_cast<uint32_t>(size);
+            header.level    = static_cast<uint8_t>(lvl);
+            header.reserved = 0;
+            header.tag      = tag;
+            header.line     = line;
+            header.time     = std::chrono::steady_clock::now().time_since_epoch().count();
+            header.fmt      = fmt;
+            header.module   = module;
+            memcpy(p, &header, sizeof(header));
+            uint8_t* cursor = p + sizeof(header);
+            args_write(cursor, args...);
+            ring->commit();
+
+            // 过半时提前唤醒后台线程，平时靠定时轮询，避免每条日志都触发 notify
+            if (ring->used() > ring->capacity() / 2 && !wake_.exchange(true, std::memory_order_relaxed))
+            {
+                cv_.notify_one();
+            }
+        }
+
+      private:
+        struct thread_rings
+        {
+            uint64_t                                                       last_id   = 0;
+            spsc_ring*                                                     last_ring = nullptr;
+            std::vector<std::pair<uint64_t, std::shared_ptr<spsc_ring>>> entries;
+
+            ~thread_rings()
+            {
+                for (auto& entry : entries)
+                {
+                    entry.second->orphaned.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        static uint64_t next_id()
+        {
+            static std::atomic<uint64_t> id{0};
+            return ++id;
+        }
+
+        spsc_ring* local_ring()
+        {
+            static thread_local thread_rings local;
+            if (local.last_id == id_)
+            {
+                return local.last_ring;
+            }
+            for (auto& entry : local.entries)
+            {
+                if (entry.first == id_)
+                {
+                    local.last_id   = id_;
+                    local.last_ring = entry.second.get();
+                    return local.last_ring;
+                }
+            }
+
+            // 首次在本线程写日志，顺便清理已销毁 logger 的缓冲
+            for (size_t i = 0; i < local.entries.size();)
+            {
+                if (local.entries[i].second->closed.load(std::memory_order_acquire))
+                {
+                    local.entries[i] = std::move(local.entries.back());
+                    local.entries.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            auto ring = std::make_shared<spsc_ring>(ring_size_);
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings_.push_back(ring);
+            }
+            local.entries.emplace_back(id_, ring);
+            local.last_id   = id_;
+            local.last_ring = ring.get();
+            return local.last_ring;
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true)
+            {
+                cv_.wait_for(lock, flush_interval_, [this]() {
+                    return stop_ || flush_requested_ > flush_done_ || wake_.load(std::memory_order_relaxed);
+                });
+                bool     stop   = stop_;
+                uint64_t target = flush_requested_;
+                lock.unlock();
+
+                wake_.store(false, std::memory_order_relaxed);
+                drain();
+
+                lock.lock();
+                flush_done_ = target;
+                flushed_cv_.notify_all();
+                if (stop)
+                {
+                    return;
+                }
+            }
+        }
+
+        // 按时间戳归并各线程记录，保证跨线程日志顺序
+        void drain()
+        {
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                snapshot_.assign(rings_.begin(), rings_.end());
+            }
+            while (true)
+            {
+                spsc_ring*           best        = nullptr;
+                const record_header* best_header = nullptr;
+                record_header        headers[2];
+                int                  current = 0;
+                for (auto& ring : snapshot_)
+                {
+                    const uint8_t* p = ring->front();
+                    if (!p)
+                    {
+                        continue;
+                    }
+                    memcpy(&headers[current], p, sizeof(record_header));
+                    if (!best_header || headers[current].time < best_header->time)
+                    {
+                        best        = ring.get();
+                        best_header = &headers[current];
+                        current ^= 1;
+                    }
+                }
+                if (!best)
+                {
+                    break;
+                }
+                const uint8_t* p = best->front();
+                emit(*best_header, p + sizeof(record_header), p + best_header->size);
+                best->pop(best_header->size);
+            }
+
+            uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (dropped != reported_dropped_ && inner_)
+            {
+                inner_->write({}, zlogger::level_enum::warn, "zlogger", __LINE__,
+                  zlogger_fmt("deferred logger dropped %llu records", static_cast<unsigned long long>(dropped - reported_dropped_)));
+                reported_dropped_ = dropped;
+            }
+
+            // 回收已退出线程的空缓冲
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            for (size_t i = 0; i < rings_.size();)
+            {
+                if (rings_[i]->orphaned.load(std::memory_order_acquire) && !rings_[i]->front())
+                {
+                    rings_[i] = std::move(rings_.back());
+                    rings_.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+            snapshot_.clear();
+        }
+
+        void emit(const record_header& header, const uint8_t* args, const uint8_t* end)
+        {
+            if (!inner_)
+            {
+                return;
+            }
+            formatter_.format(header.fmt, args, end, line_);
+            inner_->write(tag_registry::instance().tags(header.tag), static_cast<zlogger::level_enum>(header.level), header.module,
+              header.line, line_);
+        }
+
+        ILogger_ptr                              inner_;
+        size_t                                   ring_size_;
+        std::chrono::milliseconds                flush_interval_;
+        uint64_t                                 id_;
+        std::atomic<zlogger::level_enum>         level_;
+        std::atomic<uint64_t>                    dropped_{0};
+        std::atomic<bool>                        wake_{false};
+        std::mutex                               rings_mutex_;
+        std::vector<std::shared_ptr<spsc_ring>> rings_;
+
+        // 以下只在后台线程访问
+        std::vector<std::shared_ptr<spsc_ring>> snapshot_;
+        record_formatter                         formatter_;
+        std::string                              line_;
+        uint64_t                                 reported_dropped_ = 0;
+
+        std::mutex              mutex_;
+        std::condition_variable cv_;
+        std::condition_variable flushed_cv_;
+        bool                    stop_            = false;
+        uint64_t                flush_requested_ = 0;
+        uint64_t                flush_done_      = 0;
+        std::thread             worker_;
+    };
+
+    using logger_ptr = std::shared_ptr<logger>;
+
+}  // namespace deferred
+
+namespace factory
+{
+    namespace deferred_logger
+    {
+        /**
+         * @brief    用延迟格式化包装一个现有 logger
+         *
+         * @param    inner               负责落盘的 logger，如 async_logger::rotating_file / multi_sink
+         * @param    ring_size           每个写日志线程的环形缓冲大小（字节）
+         * @param    flush_interval_ms   后台线程的轮询间隔
+         */
+        inline std::shared_ptr<deferred::logger> wrap(ILogger_ptr inner, size_t ring_size = 64 * 1024, int64_t flush_interval_ms = 5)
+        {
+            return std::make_shared<deferred::logger>(std::move(inner), ring_size, flush_interval_ms);
+        }
+    }  // namespace deferred_logger
+
+}  // namespace factory
+
+}  // namespace zlogger
+
+/**
+ * @brief    注册 tag 集合，每个调用点只在首次执行时注册
+ *
+ *    zlog_dfr_info(logger, ztag_id("room", "login"), "info %d", 100);
+ */
+#define ztag_id(...)                                                                                                                       \
+    ([]() -> zlogger::deferred::tag_id {                                                                                                   \
+        static const zlogger::deferred::tag_id id = zlogger::deferred::tag_registry::instance().intern({__VA_ARGS__});                    \
+        return id;                                                                                                                         \
+    }())
+
+/**
+ * @brief    延迟格式化日志宏，用法同 zlog_info，tag 需用 ztag_id 传入
+ *
+ *   "" fmt 使非字面量 fmt 编译失败；check_fmt 只参与格式检查，不会执行
+ */
+#define zlog_dfr_debug(logger, tag, fmt, ...)    zlog_dfr(logger, tag, zlogger::level_enum::debug, fmt, ##__VA_ARGS__)
+#define zlog_dfr_info(logger, tag, fmt, ...)     zlog_dfr(logger, tag, zlogger::level_enum::info, fmt, ##__VA_ARGS__)
+#define zlog_dfr_warn(logger, tag, fmt, ...)     zlog_dfr(logger, tag, zlogger::level_enum::warn, fmt, ##__VA_ARGS__)
+#define zlog_dfr_error(logger, tag, fmt, ...)    zlog_dfr(logger, tag, zlogger::level_enum::err, fmt, ##__VA_ARGS__)
+#define zlog_dfr_critical(logger, tag, fmt, ...) zlog_dfr(logger, tag, zlogger::level_enum::critical, fmt, ##__VA_ARGS__)
+
+#define zlog_dfr(logger, tag, lvl, fmt, ...)                                                                                               \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        if (false)                                                                                                                         \
+            zlogger::deferred::check_fmt("" fmt, ##__VA_ARGS__);                                                                           \
+        (logger)->log(tag, lvl, __MODULE__, __LINE__, "" fmt, ##__VA_ARGS__);                                                              \
+    } while (0)
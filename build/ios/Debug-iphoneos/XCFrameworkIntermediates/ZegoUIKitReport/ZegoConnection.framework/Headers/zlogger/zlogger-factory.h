@@ -6,6 +6,7 @@
 #include "factory/factory_callback.h"
 #include "factory/factory_daily_file.h"
 #include "factory/factory_msvc.h"
+#include "factory/factory_mmap_segment.h"
 #include "factory/factory_rotating_file.h"
 #include "factory/factory_stdout.h"
 #include "factory/multisink.h"
@@ -36,6 +36,12 @@ namespace zegosetting
 
         bool operator==(const env_condition &other) const 
         {
+            // 先比较条件参数，不一致时不必解析配置；批量匹配使用 zsetting_condition.h 中的 env_condition_index
+            if (env_condition_value_list != other.env_condition_value_list)
+            {
+                return false;
+            }
+
             ZegoJson src_json(condition_config);
             if (!src_json.IsObject())
             {
@@ -50,8 +56,7 @@ namespace zegosetting
                 return false;
             }
             
-            return env_condition_value_list == other.env_condition_value_list &&
-                   ((nlohmann::json)src_json == (nlohmann::json)other_src_json);
+            return (nlohmann::json)src_json == (nlohmann::json)other_src_json;
         }
 
         bool operator!=(const env_condition &other) const { return !(*this == other); }
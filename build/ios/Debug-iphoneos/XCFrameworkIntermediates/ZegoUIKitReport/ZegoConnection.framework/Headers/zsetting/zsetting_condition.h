@@ -0,0 +1,315 @@
+#pragma once
+
+#include "zsetting.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace zego
+{
+namespace zegosetting
+{
+    /*
+    * 云控环境变量条件的预编译索引
+    * env_condition::operator== 每次比较都要把两份 condition_config 解析成 json，
+    * set_env_list 的结果匹配和轮询时的变更判断都是两两比较，启动和每次轮询都耗在 json 解析上。
+    * 这里把每个条件解析一次：条件参数按 key/value 排序（条件参数是“且”的关系，与顺序无关），
+    * 配置解析后按结构计算哈希，匹配当前环境变量时只需一次哈希查找。
+    */
+    namespace detail
+    {
+        inline uint64_t fnv1a(uint64_t hash, const void* data, size_t size)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= 0x100000001b3ULL;
+            }
+            return hash;
+        }
+
+        inline uint64_t fnv1a(uint64_t hash, const std::string& value)
+        {
+            uint64_t size = value.size();
+            hash = fnv1a(hash, &size, sizeof(size));
+            return fnv1a(hash, value.data(), value.size());
+        }
+
+        inline uint64_t mix(uint64_t value)
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdULL;
+            value ^= value >> 33;
+            value *= 0xc4ceb33fe1a85ec9ULL;
+            value ^= value >> 33;
+            return value;
+        }
+
+        const uint64_t kHashSeed = 0xcbf29ce484222325ULL;
+
+        // 与 nlohmann::json 的 operator== 保持一致：相等的 json 哈希必然相同。
+        // 整数与浮点数可以相等比较，所以数值统一按 double 计算
+        inline uint64_t json_hash(const nlohmann::json& json, uint64_t hash = kHashSeed)
+        {
+            unsigned char type = static_cast<unsigned char>(json.type());
+            switch (json.type()) {
+                case nlohmann::json::value_t::number_integer:
+                case nlohmann::json::value_t::number_unsigned:
+                case nlohmann::json::value_t::number_float:
+                    type = static_cast<unsigned char>(nlohmann::json::value_t::number_float);
+                    break;
+                default:
+                    break;
+            }
+            hash = fnv1a(hash, &type, sizeof(type));
+
+            switch (json.type()) {
+                case nlohmann::json::value_t::object:
+                    // object_t 为 std::map，遍历即按 key 排序
+                    for (auto it = json.begin(); it != json.end(); ++it) {
+                        hash = fnv1a(hash, it.key());
+                        hash = json_hash(it.value(), hash);
+                    }
+                    break;
+                case nlohmann::json::value_t::array:
+                    for (const auto& item : json) {
+                        hash = json_hash(item, hash);
+                    }
+                    break;
+                case nlohmann::json::value_t::string:
+                    hash = fnv1a(hash, json.get_ref<const std::string&>());
+                    break;
+                case nlohmann::json::value_t::boolean: {
+                    unsigned char value = json.get<bool>() ? 1 : 0;
+                    hash = fnv1a(hash, &value, sizeof(value));
+                    break;
+                }
+                case nlohmann::json::value_t::number_integer:
+                case nlohmann::json::value_t::number_unsigned:
+                case nlohmann::json::value_t::number_float: {
+                    double value = json.get<double>();
+                    if (value == 0) {
+                        value = 0;  // -0.0 == 0.0
+                    }
+                    uint64_t bits = 0;
+                    memcpy(&bits, &value, sizeof(bits));
+                    hash = fnv1a(hash, &bits, sizeof(bits));
+                    break;
+                }
+                default:
+                    break;
+            }
+            return hash;
+        }
+
+        inline bool value_less(const env_condition_value& a, const env_condition_value& b)
+        {
+            return a.key < b.key || (a.key == b.key && a.value < b.value);
+        }
+
+        // 条件参数与顺序无关，单项哈希相加
+        inline uint64_t condition_key_hash(const std::string& env_name, const std::vector<env_condition_value>& values)
+        {
+            uint64_t hash = mix(fnv1a(kHashSeed, env_name));
+            for (const auto& value : values) {
+                hash += mix(fnv1a(fnv1a(kHashSeed, value.key), value.value));
+            }
+            return hash;
+        }
+    }  // namespace detail
+
+    struct compiled_env_condition {
+        std::string env_name;
+        std::vector<env_condition_value> values;        // 按 key、value 排序
+        uint64_t key_hash = 0;                          // env_name 和条件参数的哈希
+        std::string config_text;                        // 原始 condition_config
+        std::shared_ptr<const nlohmann::json> config;   // 解析后的配置，为空或不是 json 对象时为 nullptr
+        uint64_t config_hash = 0;
+
+        static compiled_env_condition compile(const std::string& env_name, const env_condition& condition)
+        {
+            compiled_env_condition compiled;
+            compiled.env_name = env_name;
+            compiled.values = condition.env_condition_value_list;
+            std::stable_sort(compiled.values.begin(), compiled.values.end(), detail::value_less);
+            compiled.key_hash = detail::condition_key_hash(env_name, compiled.values);
+            compiled.config_text = condition.condition_config;
+            if (!condition.condition_config.empty()) {
+                ZegoJson json(condition.condition_config);
+                if (json.IsObject()) {
+                    compiled.config = std::make_shared<const nlohmann::json>((nlohmann::json)json);
+                    compiled.config_hash = detail::json_hash(*compiled.config);
+                }
+            }
+            return compiled;
+        }
+
+        // 条件参数是否一致，sorted_values 需已排序
+        bool same_condition(const std::string& name, const std::vector<env_condition_value>& sorted_values) const
+        {
+            return env_name == name && values == sorted_values;
+        }
+
+        // 配置是否一致，先比较原文和哈希，只有哈希相同时才比较解析后的 json
+        bool same_config(const compiled_env_condition& other) const
+        {
+            if (config_text == other.config_text) {
+                return true;
+            }
+            if (!config || !other.config || config_hash != other.config_hash) {
+                return false;
+            }
+            return *config == *other.config;
+        }
+    };
+
+    class env_condition_index
+    {
+      public:
+        env_condition_index() = default;
+        explicit env_condition_index(const std::vector<cloud_env>& cloud_env_list) { build(cloud_env_list); }
+
+        // 编译云控返回的环境变量列表，同一条件重复出现时以先出现的为准
+        void build(const std::vector<cloud_env>& cloud_env_list)
+        {
+            clear();
+            for (const auto& env : cloud_env_list) {
+                for (const auto& condition : env.env_condition_list) {
+                    compiled_env_condition compiled = compiled_env_condition::compile(env.env_name, condition);
+                    if (find_sorted(compiled.key_hash, compiled.env_name, compiled.values) != nullptr) {
+                        continue;
+                    }
+                    digest_ += detail::mix(compiled.key_hash ^ compiled.config_hash);
+                    by_key_.emplace(compiled.key_hash, entries_.size());
+                    entries_.push_back(std::move(compiled));
+                }
+            }
+        }
+
+        void clear()
+        {
+            entries_.clear();
+            by_key_.clear();
+            digest_ = 0;
+        }
+
+        size_t size() const { return entries_.size(); }
+        const std::vector<compiled_env_condition>& entries() const { return entries_; }
+
+        /**
+        查找条件参数一致的配置，条件参数与顺序无关
+
+        @return 未命中返回 nullptr，指针在下次 build/clear 前有效
+        */
+        const compiled_env_condition* find(const std::string& env_name, const std::vector<env_condition_value>& values) const
+        {
+            uint64_t key_hash = detail::condition_key_hash(env_name, values);
+            if (by_key_.find(key_hash) == by_key_.end()) {
+                return nullptr;
+            }
+            std::vector<env_condition_value> sorted = values;
+            std::stable_sort(sorted.begin(), sorted.end(), detail::value_less);
+            return find_sorted(key_hash, env_name, sorted);
+        }
+
+        /**
+        按 set_env_list 设置的环境变量匹配配置
+
+        @return 与请求中的条件一一对应，未命中的位置为 nullptr
+        */
+        std::vector<const compiled_env_condition*> match(const std::vector<cloud_env>& request_env_list) const
+        {
+            std::vector<const compiled_env_condition*> result;
+            for (const auto& env : request_env_list) {
+                for (const auto& condition : env.env_condition_list) {
+                    result.push_back(find(env.env_name, condition.env_condition_value_list));
+                }
+            }
+            return result;
+        }
+
+        // 两份索引的条件和配置是否完全一致（与条件顺序无关），用于轮询时判断环境配置是否变化
+        bool equals(const env_condition_index& other) const
+        {
+            if (entries_.size() != other.entries_.size() || digest_ != other.digest_) {
+                return false;
+            }
+            for (const auto& entry : entries_) {
+                const compiled_env_condition* found = other.find_sorted(entry.key_hash, entry.env_name, entry.values);
+                if (found == nullptr || !entry.same_config(*found)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+      private:
+        const compiled_env_condition* find_sorted(uint64_t key_hash, const std::string& env_name,
+                                                  const std::vector<env_condition_value>& sorted_values) const
+        {
+            auto range = by_key_.equal_range(key_hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                const compiled_env_condition& entry = entries_[it->second];
+                if (entry.same_condition(env_name, sorted_values)) {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        std::vector<compiled_env_condition> entries_;
+        std::unordered_multimap<uint64_t, size_t> by_key_;
+        uint64_t digest_ = 0;  // 各条目哈希之和，与顺序无关
+    };
+
+    /*
+    * 云控缓存的共享只读快照
+    * local_cache()/get_request_kv() 每次调用都会复制整个 map，高频读取的模块在 polling_notify
+    * 中 refresh 一次，之后读取方共享同一份快照，持有期间快照内容不变
+    */
+    class setting_snapshot
+    {
+      public:
+        using map_t   = std::map<std::string, std::string>;
+        using map_ptr = std::shared_ptr<const map_t>;
+
+        void refresh(const ISetting_ptr& setting)
+        {
+            if (!setting) {
+                return;
+            }
+            map_ptr cache = std::make_shared<const map_t>(setting->local_cache());
+            map_ptr request_kv = std::make_shared<const map_t>(setting->get_request_kv());
+            std::lock_guard<std::mutex> lock(mutex_);
+            cache_.swap(cache);
+            request_kv_.swap(request_kv);
+        }
+
+        map_ptr local_cache() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return cache_ ? cache_ : empty();
+        }
+
+        map_ptr request_kv() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return request_kv_ ? request_kv_ : empty();
+        }
+
+      private:
+        static const map_ptr& empty()
+        {
+            static const map_ptr empty_map = std::make_shared<const map_t>();
+            return empty_map;
+        }
+
+        mutable std::mutex mutex_;
+        map_ptr cache_;
+        map_ptr request_kv_;
+    };
+
+}  // namespace zegosetting
+}  // namespace zego
@@ -3,6 +3,7 @@
 #define __ZEGOEXPRESSDEFINES_H__
 
 #include "internal/ZegoInternalDefines.hpp"
+#include "internal/ZegoInternalPayload.hpp"
 
 namespace ZEGO {
 namespace EXPRESS {
@@ -2229,6 +2230,141 @@ enum ZegoDummyCaptureImageMode {
 
 };
 
+/// Callback dispatcher overflow policy.
+enum ZegoCallbackOverflowPolicy {
+    /// When the callback queue is full, the SDK internal thread waits until the callback thread has made room. No callback is lost or reordered, but a slow handler will stall the SDK until the queue drains. Callbacks posted from the callback thread itself are queued without waiting.
+    ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK = 0,
+
+    /// When the callback queue is full, the newest callback is discarded and counted in [ZegoCallbackDispatcherStats.droppedCount].
+    ZEGO_CALLBACK_OVERFLOW_POLICY_DROP_NEWEST = 1
+
+};
+
+/// Symbol binding mode of an explicitly loaded SDK dynamic library.
+enum ZegoLibraryBindingMode {
+    /// Every SDK function is resolved when the library is loaded. Loading fails if any of them is missing.
+    ZEGO_LIBRARY_BINDING_MODE_EAGER = 0,
+
+    /// SDK functions are resolved on their first call. A function missing from the library returns [ZEGO_ERROR_CODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND] when called.
+    ZEGO_LIBRARY_BINDING_MODE_LAZY = 1
+
+};
+
+/// Queues sampled by the extended performance status.
+enum ZegoPerformanceQueue {
+    /// Callbacks waiting for the callback thread. Always sampled.
+    ZEGO_PERFORMANCE_QUEUE_CALLBACK = 0,
+
+    /// JOB_NO_BLOCK tasks waiting in the ZegoConnectionThreadPool work-stealing scheduler.
+    ZEGO_PERFORMANCE_QUEUE_THREAD_POOL_CPU = 1,
+
+    /// JOB_MAYBE_BLOCK tasks waiting in the ZegoConnectionThreadPool scheduler.
+    ZEGO_PERFORMANCE_QUEUE_THREAD_POOL_BLOCKING = 2,
+
+    /// Bytes waiting in the rings of the deferred zlogger.
+    ZEGO_PERFORMANCE_QUEUE_LOGGER = 3
+
+};
+
+/// Quality metric kept by the quality metrics store.
+///
+/// Description: Publish metrics are recorded per published stream from [onPublisherQualityUpdate], play metrics per played stream from [onPlayerQualityUpdate], and network metrics per user from [onNetworkQuality]. Quality levels are stored as their [ZegoStreamQualityLevel] value.
+enum ZegoQualityMetric {
+    /// Publish: video send frame rate, in fps.
+    ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS = 0,
+
+    /// Publish: video bit rate, in kbps.
+    ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_KBPS = 1,
+
+    /// Publish: audio bit rate, in kbps.
+    ZEGO_QUALITY_METRIC_PUBLISH_AUDIO_KBPS = 2,
+
+    /// Publish: round-trip time to the server, in ms.
+    ZEGO_QUALITY_METRIC_PUBLISH_RTT = 3,
+
+    /// Publish: packet loss rate, in the range [0, 1].
+    ZEGO_QUALITY_METRIC_PUBLISH_PACKET_LOST_RATE = 4,
+
+    /// Publish: comprehensive quality level.
+    ZEGO_QUALITY_METRIC_PUBLISH_LEVEL = 5,
+
+    /// Play: video receive frame rate, in fps.
+    ZEGO_QUALITY_METRIC_PLAY_VIDEO_RECV_FPS = 6,
+
+    /// Play: video render frame rate, in fps.
+    ZEGO_QUALITY_METRIC_PLAY_VIDEO_RENDER_FPS = 7,
+
+    /// Play: video bit rate, in kbps.
+    ZEGO_QUALITY_METRIC_PLAY_VIDEO_KBPS = 8,
+
+    /// Play: audio bit rate, in kbps.
+    ZEGO_QUALITY_METRIC_PLAY_AUDIO_KBPS = 9,
+
+    /// Play: video break rate, in breaks per minute.
+    ZEGO_QUALITY_METRIC_PLAY_VIDEO_BREAK_RATE = 10,
+
+    /// Play: audio break rate, in breaks per minute.
+    ZEGO_QUALITY_METRIC_PLAY_AUDIO_BREAK_RATE = 11,
+
+    /// Play: audio MOS score.
+    ZEGO_QUALITY_METRIC_PLAY_MOS = 12,
+
+    /// Play: round-trip time to the server, in ms.
+    ZEGO_QUALITY_METRIC_PLAY_RTT = 13,
+
+    /// Play: packet loss rate, in the range [0, 1].
+    ZEGO_QUALITY_METRIC_PLAY_PACKET_LOST_RATE = 14,
+
+    /// Play: delay between the publisher and the player, in ms.
+    ZEGO_QUALITY_METRIC_PLAY_PEER_TO_PEER_DELAY = 15,
+
+    /// Play: delay after the data is received by the local end, in ms.
+    ZEGO_QUALITY_METRIC_PLAY_DELAY = 16,
+
+    /// Play: comprehensive quality level.
+    ZEGO_QUALITY_METRIC_PLAY_LEVEL = 17,
+
+    /// Network: upstream quality level.
+    ZEGO_QUALITY_METRIC_NETWORK_UPSTREAM_LEVEL = 18,
+
+    /// Network: downstream quality level.
+    ZEGO_QUALITY_METRIC_NETWORK_DOWNSTREAM_LEVEL = 19
+
+};
+
+/// Resolution of a quality metrics query.
+enum ZegoQualityMetricsResolution {
+    /// Every sample as delivered by the quality callback.
+    ZEGO_QUALITY_METRICS_RESOLUTION_RAW = 0,
+
+    /// One point per wall clock minute.
+    ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE = 1,
+
+    /// One point per ten wall clock minutes.
+    ZEGO_QUALITY_METRICS_RESOLUTION_TEN_MINUTES = 2
+
+};
+
+/// Media player frame delivery mode.
+enum ZegoMediaPlayerFrameDeliveryMode {
+    /// Video and audio frames are delivered on the media player decoding thread. A slow handler slows down decoding.
+    ZEGO_MEDIA_PLAYER_FRAME_DELIVERY_MODE_SYNC = 0,
+
+    /// Frames are copied into a bounded queue and delivered on a dedicated thread. A slow handler causes frames to be dropped instead of slowing down decoding.
+    ZEGO_MEDIA_PLAYER_FRAME_DELIVERY_MODE_QUEUED = 1
+
+};
+
+/// Media player frame drop policy, used when the frame queue is full.
+enum ZegoMediaPlayerFrameDropPolicy {
+    /// Drop the oldest queued frame to make room for the new one. Recommended for video, the handler always gets the latest picture.
+    ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_OLDEST = 0,
+
+    /// Drop the new frame and keep the queued ones.
+    ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_NEWEST = 1
+
+};
+
 /// Log config.
 ///
 /// Description: This parameter is required when calling [setlogconfig] to customize log configuration.
@@ -2316,6 +2452,258 @@ struct ZegoEngineConfig {
     ZegoEngineConfig() { logConfig = nullptr; }
 };
 
+/// Callback dispatcher configuration.
+///
+/// Description: Controls how event callbacks are queued when they are switched from the SDK internal thread to the callback thread.
+/// Caution: [taskPoolSize] only takes effect if it is set before the first callback is dispatched.
+struct ZegoCallbackDispatcherConfig {
+    /// Number of preallocated callback tasks. When the pool is exhausted, tasks fall back to heap allocation. The default is 1024.
+    unsigned int taskPoolSize;
+
+    /// Maximum number of callbacks waiting in the queue. The default is 4096.
+    unsigned int maxQueueDepth;
+
+    /// Maximum number of callbacks executed per wakeup when the callback thread is the UI thread, so that the message loop is not starved. The default is 64.
+    unsigned int maxBatchSize;
+
+    /// What to do with a callback when the queue is full. The default is [ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK].
+    ZegoCallbackOverflowPolicy overflowPolicy;
+
+    ZegoCallbackDispatcherConfig()
+        : taskPoolSize(1024), maxQueueDepth(4096), maxBatchSize(64),
+          overflowPolicy(ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK) {}
+};
+
+/// Callback dispatcher statistics.
+struct ZegoCallbackDispatcherStats {
+    /// Total number of callbacks posted to the dispatcher.
+    unsigned long long postedCount;
+
+    /// Total number of callbacks executed on the callback thread.
+    unsigned long long executedCount;
+
+    /// Total number of callbacks whose SDK thread had to wait for room because the queue was full.
+    unsigned long long blockedCount;
+
+    /// Total number of callbacks discarded because the queue was full or the engine was destroyed.
+    unsigned long long droppedCount;
+
+    /// Total number of tasks that had to be heap allocated because the task pool was exhausted or the callback did not fit in the inline buffer.
+    unsigned long long poolMissCount;
+
+    /// Total number of callback thread wakeups. [executedCount] / [wakeupCount] is the average batch size.
+    unsigned long long wakeupCount;
+
+    /// Current number of callbacks waiting in the queue.
+    unsigned int queueDepth;
+
+    /// Highest queue depth observed.
+    unsigned int maxQueueDepth;
+
+    ZegoCallbackDispatcherStats()
+        : postedCount(0), executedCount(0), blockedCount(0), droppedCount(0), poolMissCount(0),
+          wakeupCount(0), queueDepth(0), maxQueueDepth(0) {}
+};
+
+/// Callback profiler configuration.
+///
+/// Description: Controls the latency statistics and the trace file of [ZegoExpressSDK::setCallbackProfilerConfig].
+struct ZegoCallbackProfilerConfig {
+    /// Whether to record the queueing delay and handler runtime of every callback in per callback histograms, read them with [ZegoExpressSDK::getCallbackLatencyStats] or [onCallbackLatencyStatsUpdate]. The default is false.
+    bool enableLatencyStats;
+
+    /// Path of a Chrome trace event (JSON) file that every callback is written to, open it in https://ui.perfetto.dev or chrome://tracing. The file is completed when the path changes or tracing stops. Empty means no trace, the default is empty.
+    std::string traceFilePath;
+
+    /// Number of trace events buffered between two writes of the trace file, rounded up to a power of two. Events are dropped when the buffer is full. The default is 16384.
+    unsigned int traceBufferSize;
+
+    ZegoCallbackProfilerConfig() : enableLatencyStats(false), traceBufferSize(16384) {}
+};
+
+/// Latency distribution, all values are in microseconds.
+///
+/// Description: Percentiles are read from a log-linear histogram and are rounded up to the upper bound of their bucket, at most 6.25% above the recorded value.
+struct ZegoLatencyDistribution {
+    /// Mean value.
+    double mean;
+
+    /// 50th percentile.
+    double p50;
+
+    /// 90th percentile.
+    double p90;
+
+    /// 99th percentile.
+    double p99;
+
+    /// 99.9th percentile.
+    double p999;
+
+    /// Highest value.
+    double max;
+
+    ZegoLatencyDistribution() : mean(0), p50(0), p90(0), p99(0), p999(0), max(0) {}
+};
+
+/// Latency statistics of one callback type.
+struct ZegoCallbackLatencyStats {
+    /// Name of the SDK callback function, e.g. "zego_on_room_stream_update".
+    std::string callbackName;
+
+    /// Number of callbacks measured.
+    unsigned long long count;
+
+    /// Time from the SDK thread posting the callback to the handler starting. A high value with a low [handlerRuntime] means the callback queue is flooded or the callback thread is busy with something else.
+    ZegoLatencyDistribution queueDelay;
+
+    /// Time spent in the handler.
+    ZegoLatencyDistribution handlerRuntime;
+
+    ZegoCallbackLatencyStats() : count(0) {}
+};
+
+/// Integer handle of a stream ID, stable while the stream is in the room, see [ZegoExpressSDK::getStreamHandle].
+typedef unsigned int ZegoStreamHandle;
+
+/// Invalid stream handle.
+#define ZEGO_STREAM_HANDLE_INVALID 0xFFFFFFFFu
+
+/// Sound level snapshot.
+///
+/// Struct-of-arrays view of the latest remote sound level, VAD, audio spectrum and mixer sound level updates, filled by [ZegoExpressSDK::readSoundLevelSnapshot]. Per-stream arrays are indexed by [ZegoStreamHandle]. Reuse the same object for every read so that its arrays are not reallocated.
+struct ZegoSoundLevelSnapshot {
+    /// Sequence number of the sound level update, unchanged if no new update has arrived since the last read.
+    unsigned long long sequence;
+
+    /// Remote sound level indexed by stream handle, value range [0.0, 100.0]. Streams absent from the last update read 0.
+    std::vector<float> soundLevels;
+
+    /// Voice activity flag indexed by stream handle, 1 if voice is detected. Only filled when the sound level monitor has VAD enabled.
+    std::vector<int> vad;
+
+    /// Sequence number of the audio spectrum update.
+    unsigned long long spectrumSequence;
+
+    /// Number of spectrum bins reserved per stream in [spectrums].
+    unsigned int spectrumStride;
+
+    /// Remote audio spectrum, the bins of the stream with handle `h` start at `h * spectrumStride`.
+    std::vector<float> spectrums;
+
+    /// Sequence number of the mixer sound level update.
+    unsigned long long mixerSequence;
+
+    /// Sound level IDs of the mixer input streams, parallel to [mixerSoundLevels].
+    std::vector<unsigned int> mixerSoundLevelIDs;
+
+    /// Sound levels of the mixer input streams.
+    std::vector<float> mixerSoundLevels;
+
+    /// Number of stream IDs that got no handle because the table already held its maximum number of streams. Their sound levels and spectra are missing from this snapshot.
+    unsigned long long overflowCount;
+
+    ZegoSoundLevelSnapshot()
+        : sequence(0), spectrumSequence(0), spectrumStride(0), mixerSequence(0),
+          overflowCount(0) {}
+};
+
+/// Load library config.
+///
+/// Description: Configures how [ZegoExpressSDK::loadLibrary] binds the functions of the SDK dynamic library.
+struct ZegoLoadLibraryConfig {
+    /// Symbol binding mode, the default is [ZEGO_LIBRARY_BINDING_MODE_EAGER].
+    ZegoLibraryBindingMode bindingMode;
+
+    /// Only valid in lazy mode. Whether to resolve the functions needed to create the engine, log in, publish and play when the library is loaded, so that an incompatible library is rejected up front. The default is true.
+    bool preloadCoreSymbols;
+
+    ZegoLoadLibraryConfig()
+        : bindingMode(ZEGO_LIBRARY_BINDING_MODE_EAGER), preloadCoreSymbols(true) {}
+};
+
+/// Library load report.
+///
+/// Description: Startup timing of the SDK, all times are in microseconds.
+struct ZegoLibraryLoadReport {
+    /// Time spent opening the SDK dynamic library.
+    unsigned long long loadLibraryTime;
+
+    /// Time spent resolving symbols while loading the library.
+    unsigned long long resolveSymbolsTime;
+
+    /// Cumulative time spent resolving symbols on their first call, lazy mode only.
+    unsigned long long lazyResolveTime;
+
+    /// Time spent in the last successful [createEngine].
+    unsigned long long createEngineTime;
+
+    /// Number of SDK functions known to the wrapper.
+    unsigned int totalSymbolCount;
+
+    /// Number of SDK functions resolved so far.
+    unsigned int resolvedSymbolCount;
+
+    /// Functions that were looked up but are not exported by the loaded library.
+    std::vector<std::string> missingSymbols;
+
+    ZegoLibraryLoadReport()
+        : loadLibraryTime(0), resolveSymbolsTime(0), lazyResolveTime(0), createEngineTime(0),
+          totalSymbolCount(0), resolvedSymbolCount(0) {}
+};
+
+/// Media player frame delivery config.
+///
+/// Description: Configures how the media player delivers frames to [IZegoMediaPlayerVideoHandler] and [IZegoMediaPlayerAudioHandler].
+struct ZegoMediaPlayerFrameDeliveryConfig {
+    /// Frame delivery mode, the default is [ZEGO_MEDIA_PLAYER_FRAME_DELIVERY_MODE_SYNC].
+    ZegoMediaPlayerFrameDeliveryMode mode;
+
+    /// Queued mode only. Maximum number of queued video frames, the default is 3.
+    unsigned int videoQueueCapacity;
+
+    /// Queued mode only. Maximum number of queued audio frames, the default is 16.
+    unsigned int audioQueueCapacity;
+
+    /// Queued mode only. What to drop when a queue is full, the default is [ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_OLDEST].
+    ZegoMediaPlayerFrameDropPolicy dropPolicy;
+
+    /// Queued mode only. A frame that waited longer than this in the queue is counted as late, in milliseconds. 0 disables the check. The default is 100.
+    unsigned int lateThreshold;
+
+    ZegoMediaPlayerFrameDeliveryConfig()
+        : mode(ZEGO_MEDIA_PLAYER_FRAME_DELIVERY_MODE_SYNC), videoQueueCapacity(3),
+          audioQueueCapacity(16), dropPolicy(ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_OLDEST),
+          lateThreshold(100) {}
+};
+
+/// Media player frame delivery statistics.
+///
+/// Description: Counters accumulated since the last call to [setFrameDeliveryConfig].
+struct ZegoMediaPlayerFrameDeliveryStats {
+    /// Number of video frames delivered to the video handler.
+    unsigned long long videoFrameCount;
+
+    /// Number of video frames dropped because the queue was full.
+    unsigned long long droppedVideoFrameCount;
+
+    /// Number of delivered video frames that waited longer than [ZegoMediaPlayerFrameDeliveryConfig.lateThreshold].
+    unsigned long long lateVideoFrameCount;
+
+    /// Number of audio frames delivered to the audio handler.
+    unsigned long long audioFrameCount;
+
+    /// Number of audio frames dropped because the queue was full.
+    unsigned long long droppedAudioFrameCount;
+
+    /// Number of delivered audio frames that waited longer than [ZegoMediaPlayerFrameDeliveryConfig.lateThreshold].
+    unsigned long long lateAudioFrameCount;
+
+    ZegoMediaPlayerFrameDeliveryStats()
+        : videoFrameCount(0), droppedVideoFrameCount(0), lateVideoFrameCount(0),
+          audioFrameCount(0), droppedAudioFrameCount(0), lateAudioFrameCount(0) {}
+};
+
 /// Proxy config.
 ///
 /// Set proxy config.
@@ -3062,6 +3450,139 @@ struct ZegoPerformanceStatus {
     double memoryUsedApp;
 };
 
+/// Number of queues in [ZegoExtendedPerformanceStatus.queueDepths].
+#define ZEGO_PERFORMANCE_QUEUE_COUNT 4
+
+/// Maximum number of threads in [ZegoExtendedPerformanceStatus.threads].
+#define ZEGO_PERFORMANCE_MAX_THREADS 32
+
+/// Maximum number of streams in [ZegoExtendedPerformanceStatus.streams].
+#define ZEGO_PERFORMANCE_MAX_STREAMS 32
+
+/// Returns the current depth of a queue, see [ZegoExpressSDK::setQueueDepthProvider].
+typedef unsigned long long (*ZegoQueueDepthProvider)();
+
+/// CPU time of one thread.
+struct ZegoThreadCpuSample {
+    /// Kernel thread ID.
+    int threadID;
+
+    /// Thread name, at most 15 characters, NUL terminated.
+    char name[16];
+
+    /// CPU usage of the thread over the period, 1.0 is one full core.
+    float cpuUsage;
+
+    /// CPU time the thread has used since it started, in microseconds.
+    unsigned long long cpuTime;
+};
+
+/// Frame rates of one playing stream.
+struct ZegoStreamFpsSample {
+    /// Stream handle, see [ZegoExpressSDK::getStreamIDByHandle].
+    ZegoStreamHandle streamHandle;
+
+    /// Video decode frame rate, in fps.
+    float decodeFPS;
+
+    /// Video render frame rate, in fps.
+    float renderFPS;
+};
+
+/// Extended system performance status.
+///
+/// Description: Fixed size samples that break [ZegoPerformanceStatus] down by thread, queue and stream, so that a CPU spike can be attributed to video decoding, logging, networking or the app's own handlers. Filled without allocating or formatting strings.
+struct ZegoExtendedPerformanceStatus {
+    /// Length of the period the rates and CPU usages cover, in microseconds.
+    unsigned long long period;
+
+    /// Number of threads in the process. Only available on Linux and Android, 0 elsewhere.
+    unsigned int totalThreadCount;
+
+    /// Number of valid entries in [threads].
+    unsigned int threadCount;
+
+    /// The threads that used the most CPU over the period, busiest first.
+    ZegoThreadCpuSample threads[ZEGO_PERFORMANCE_MAX_THREADS];
+
+    /// Whether the allocation hook is compiled in, see ZEGOEXP_ALLOCATION_HOOK. The allocation fields are 0 without it.
+    bool allocationHookInstalled;
+
+    /// Allocations per second over the period.
+    double allocationRate;
+
+    /// Bytes allocated per second over the period.
+    double allocationBytesRate;
+
+    /// Bytes currently allocated and not yet freed, counted since the hook was installed.
+    long long bytesInFlight;
+
+    /// Queue depths indexed by [ZegoPerformanceQueue]. A queue without a provider reads 0.
+    unsigned long long queueDepths[ZEGO_PERFORMANCE_QUEUE_COUNT];
+
+    /// Number of valid entries in [streams].
+    unsigned int streamCount;
+
+    /// Frame rates of the playing streams, from their latest [onPlayerQualityUpdate].
+    ZegoStreamFpsSample streams[ZEGO_PERFORMANCE_MAX_STREAMS];
+};
+
+/// Quality metrics store configuration.
+///
+/// Description: Every series, i.e. one published stream, played stream or user, keeps three ring buffers of fixed capacity. The oldest entries are overwritten, so memory does not grow with the call length. A play series takes about (8 + 4 * 12) * rawCapacity + (12 + 16 * 12) * (minuteCapacity + tenMinuteCapacity) bytes, about 170 KB with the defaults, publish and network series take less.
+struct ZegoQualityMetricsStoreConfig {
+    /// Whether to record quality metrics. The default is false.
+    bool enable;
+
+    /// Maximum number of series. When all are in use, the series updated longest ago is dropped for a new one. The default is 16.
+    unsigned int maxSeries;
+
+    /// Number of raw samples kept per series. The default is 600, about 30 minutes at the 3 s quality callback period.
+    unsigned int rawCapacity;
+
+    /// Number of one minute points kept per series. The default is 360, 6 hours.
+    unsigned int minuteCapacity;
+
+    /// Number of ten minute points kept per series. The default is 288, 48 hours.
+    unsigned int tenMinuteCapacity;
+
+    ZegoQualityMetricsStoreConfig()
+        : enable(false), maxSeries(16), rawCapacity(600), minuteCapacity(360),
+          tenMinuteCapacity(288) {}
+};
+
+/// A point of a quality metrics query.
+///
+/// Description: Raw points carry the sample in every statistic. Downsampled points summarize the samples of their minute or ten minutes, the point of the period in progress is included. The p95 of a period with more than 64 samples is estimated from a uniform sample of 64 of them.
+struct ZegoQualityMetricsPoint {
+    /// Sample time, or start of the period, in ms since the Unix epoch.
+    long long timestamp;
+
+    /// Number of samples summarized.
+    unsigned int count;
+
+    /// Minimum value.
+    float min;
+
+    /// Mean value.
+    float avg;
+
+    /// Maximum value.
+    float max;
+
+    /// 95th percentile.
+    float p95;
+};
+
+/// A message of a real-time sequential data batch.
+struct ZegoRealTimeSequentialDataMessage {
+    /// Message content, only read during [sendRealTimeSequentialDataBatch].
+    const unsigned char *data;
+
+    /// Message content length.
+    unsigned int dataLength;
+};
+
 /// Beauty configuration param.
 ///
 /// Configure the whiten, rosy, smooth, and sharpen parameters for beauty.
@@ -4505,6 +5026,13 @@ using ZegoMixerStopCallback = std::function<void(int errorCode)>;
 /// @param errorCode Error code, please refer to the error codes document https://docs.zegocloud.com/en/5548.html for details.
 using ZegoRealTimeSequentialDataSentCallback = std::function<void(int errorCode)>;
 
+/// Callback for sending a batch of real-time sequential data.
+///
+/// @param errorCode Error code of a failed message, 0 if every message was sent, please refer to the error codes document https://docs.zegocloud.com/en/5548.html for details.
+/// @param failedCount Number of messages that failed.
+using ZegoRealTimeSequentialDataBatchSentCallback =
+    std::function<void(int errorCode, unsigned int failedCount)>;
+
 /// Callback for sending broadcast messages.
 ///
 /// @param errorCode Error code, please refer to the error codes document https://docs.zegocloud.com/en/5548.html for details.
@@ -548,6 +548,26 @@ class IZegoEventHandler {
     /// @param info SEI Callback info.
     virtual void onPlayerRecvMediaSideInfo(const ZegoMediaSideInfo & /*info*/) {}
 
+    /// The callback triggered when Supplemental Enhancement Information is received synchronously, delivered as a shared payload.
+    ///
+    /// Description: Same trigger as [onPlayerSyncRecvSEI]. The SEI content is copied once into a pooled, reference-counted buffer that is shared with [onPlayerRecvSEIPayload].
+    /// Caution: This callback runs on the SDK internal thread, do not perform time-consuming operations in it. Keep a copy of [payload] to use the data after the callback returns; no bytes are copied.
+    ///
+    /// @param streamID Stream ID.
+    /// @param payload SEI content.
+    virtual void onPlayerSyncRecvSEIPayload(const std::string & /*streamID*/,
+                                            const ZegoPayloadRef & /*payload*/) {}
+
+    /// The callback triggered when Supplemental Enhancement Information is received, delivered as a shared payload.
+    ///
+    /// Description: Same trigger as [onPlayerSyncRecvSEI], but called on the callback thread. The payload is the same buffer that was passed to [onPlayerSyncRecvSEIPayload].
+    /// Caution: Keep a copy of [payload] to use the data after the callback returns; no bytes are copied.
+    ///
+    /// @param streamID Stream ID.
+    /// @param payload SEI content.
+    virtual void onPlayerRecvSEIPayload(const std::string & /*streamID*/,
+                                        const ZegoPayloadRef & /*payload*/) {}
+
     /// Receive the audio side information content of the remote stream.
     ///
     /// Available since: 2.19.0
@@ -563,6 +583,16 @@ class IZegoEventHandler {
                                            const unsigned char * /*data*/,
                                            unsigned int /*dataLength*/) {}
 
+    /// Receive the audio side information content of the remote stream, delivered as a shared payload.
+    ///
+    /// Description: Same trigger as [onPlayerRecvAudioSideInfo]. The content is copied once into a pooled, reference-counted buffer.
+    /// Caution: This callback runs on the SDK internal thread. Keep a copy of [payload] to use the data after the callback returns; no bytes are copied.
+    ///
+    /// @param streamID Stream ID.
+    /// @param payload Audio side information content.
+    virtual void onPlayerRecvAudioSideInfoPayload(const std::string & /*streamID*/,
+                                                  const ZegoPayloadRef & /*payload*/) {}
+
     /// Playing stream low frame rate warning.
     ///
     /// Available since: 2.14.0
@@ -910,6 +940,28 @@ class IZegoEventHandler {
     /// @param status System performance monitoring status.
     virtual void onPerformanceStatusUpdate(const ZegoPerformanceStatus & /*status*/) {}
 
+    /// Callback latency statistics callback.
+    ///
+    /// Description: Queueing delay and handler runtime of every callback type that fired since the previous notification, delivered right after [onPerformanceStatusUpdate].
+    /// Use cases: Telling a slow handler from a flooded callback queue when the UI lags, without attaching a profiler.
+    /// When to trigger: After [startPerformanceMonitor], on every [onPerformanceStatusUpdate] while [ZegoCallbackProfilerConfig.enableLatencyStats] is set through [ZegoExpressSDK::setCallbackProfilerConfig].
+    /// Restrictions: None.
+    ///
+    /// @param statsList Statistics of the callback types that fired in the last period.
+    virtual void
+    onCallbackLatencyStatsUpdate(const std::vector<ZegoCallbackLatencyStats> & /*statsList*/) {}
+
+    /// Extended performance status callback.
+    ///
+    /// Description: Per thread CPU usage, allocation rates, queue depths and per stream frame rates sampled over the last [startPerformanceMonitor] period, delivered right after [onPerformanceStatusUpdate].
+    /// Use cases: Finding which thread, queue or stream is responsible when [onPerformanceStatusUpdate] reports high CPU or memory usage.
+    /// When to trigger: After [startPerformanceMonitor], on every [onPerformanceStatusUpdate] while enabled through [ZegoExpressSDK::enableExtendedPerformanceStatus].
+    /// Restrictions: Per thread CPU usage is only available on Linux and Android.
+    ///
+    /// @param status Extended performance status.
+    virtual void
+    onExtendedPerformanceStatusUpdate(const ZegoExtendedPerformanceStatus & /*status*/) {}
+
     /// Network mode changed callback.
     ///
     /// Available since: 1.20.0
@@ -1089,6 +1141,19 @@ class IZegoRealTimeSequentialDataEventHandler {
                                                  const unsigned char * /*data*/,
                                                  unsigned int /*dataLength*/,
                                                  const std::string & /*streamID*/) {}
+
+    /// Callback for receiving real-time sequential data, delivered as a shared payload.
+    ///
+    /// Description: Same trigger as [onReceiveRealTimeSequentialData]. The data is copied once into a pooled, reference-counted buffer.
+    /// Caution: Keep a copy of [payload] to use the data after the callback returns; no bytes are copied.
+    ///
+    /// @param manager The real-time sequential data manager instance that triggers this callback.
+    /// @param payload The received real-time sequential data.
+    /// @param streamID Subscribed stream ID
+    virtual void
+    onReceiveRealTimeSequentialDataPayload(IZegoRealTimeSequentialDataManager * /*manager*/,
+                                           const ZegoPayloadRef & /*payload*/,
+                                           const std::string & /*streamID*/) {}
 };
 
 class IZegoMediaPlayerEventHandler {
@@ -1256,7 +1321,7 @@ class IZegoMediaPlayerVideoHandler {
     /// Available since: 2.16.0
     /// Description: The callback triggered when the media player throws out video frame data.
     /// Trigger: The callback is generated when the media player starts playing.
-    /// Caution: The callback does not actually take effect until call [setVideoHandler] to set.
+    /// Caution: The callback does not actually take effect until call [setVideoHandler] to set. The SDK calls this overload once per frame, its default implementation forwards to the overload without [extraInfo], so override only one of the two.
     /// Restrictions: When playing copyrighted music, this callback will be disabled by default. If necessary, please contact ZEGO technical support.
     ///
     /// @param mediaPlayer Callback player object.
@@ -1264,9 +1329,11 @@ class IZegoMediaPlayerVideoHandler {
     /// @param dataLength Data length (eg: RGBA only needs to consider dataLength[0], I420 needs to consider dataLength[0,1,2]).
     /// @param param video data frame param.
     /// @param extraInfo Video frame extra info. json format data.
-    virtual void onVideoFrame(IZegoMediaPlayer * /*mediaPlayer*/, const unsigned char ** /*data*/,
-                              unsigned int * /*dataLength*/, ZegoVideoFrameParam /*param*/,
-                              const char * /*extraInfo*/) {}
+    virtual void onVideoFrame(IZegoMediaPlayer *mediaPlayer, const unsigned char **data,
+                              unsigned int *dataLength, ZegoVideoFrameParam param,
+                              const char * /*extraInfo*/) {
+        onVideoFrame(mediaPlayer, data, dataLength, param);
+    }
 };
 
 class IZegoMediaPlayerAudioHandler {
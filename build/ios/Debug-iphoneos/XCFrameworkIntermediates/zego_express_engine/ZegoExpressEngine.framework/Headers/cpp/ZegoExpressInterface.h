@@ -3664,6 +3664,23 @@ class IZegoRealTimeSequentialDataManager {
                                             const std::string &streamID,
                                             ZegoRealTimeSequentialDataSentCallback callback) = 0;
 
+    /// Send a batch of real-time sequential data to the broadcasting stream ID.
+    ///
+    /// Description: Sends every message of [messages] in order, as [sendRealTimeSequentialData] would, and reports their results in a single callback once the last one completed.
+    /// Use cases: Streaming high rate state such as cursor positions, annotations or sensor data, where the cost per message rather than the bandwidth is the limit.
+    /// When to call: After calling [startBroadcasting].
+    /// Restrictions: None.
+    /// Caution: The messages are still delivered one by one, the receiver gets one [onReceiveRealTimeSequentialData] per message.
+    ///
+    /// @param messages The messages to be sent, their data is copied before this function returns.
+    /// @param count Number of messages.
+    /// @param streamID The stream ID to which the real-time sequential data is sent.
+    /// @param callback Result callback of the whole batch.
+    virtual void
+    sendRealTimeSequentialDataBatch(const ZegoRealTimeSequentialDataMessage *messages,
+                                    unsigned int count, const std::string &streamID,
+                                    ZegoRealTimeSequentialDataBatchSentCallback callback) = 0;
+
     /// Start subscribing real-time sequential data stream.
     ///
     /// Available since: 2.14.0
@@ -4187,6 +4204,24 @@ class IZegoMediaPlayer {
     ZEGO_DEPRECATED
     virtual void setVoiceChangerParam(ZegoMediaPlayerAudioChannel audioChannel,
                                       ZegoVoiceChangerParam param) = 0;
+
+    /// Set the frame delivery config.
+    ///
+    /// Description: Chooses whether video and audio frames are delivered on the decoding thread or copied into bounded queues and delivered on a dedicated thread, and how frames are dropped when a queue is full.
+    /// When to call: After the [ZegoMediaPlayer] instance created.
+    /// Restrictions: None.
+    /// Caution: Calling this function resets the frame delivery statistics. Frames still queued when the mode changes are discarded.
+    ///
+    /// @param config Frame delivery config.
+    virtual void setFrameDeliveryConfig(const ZegoMediaPlayerFrameDeliveryConfig &config) = 0;
+
+    /// Get the frame delivery statistics.
+    ///
+    /// Description: Number of video and audio frames delivered, dropped and delivered late since the last call to [setFrameDeliveryConfig].
+    /// When to call: After the [ZegoMediaPlayer] instance created.
+    ///
+    /// @return Frame delivery statistics.
+    virtual ZegoMediaPlayerFrameDeliveryStats getFrameDeliveryStats() = 0;
 };
 
 class IZegoAudioEffectPlayer {
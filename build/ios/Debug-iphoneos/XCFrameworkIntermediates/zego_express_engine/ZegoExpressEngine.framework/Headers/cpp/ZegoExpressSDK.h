@@ -197,6 +197,193 @@ class ZegoExpressSDK {
         ZegoExpressSDKInternal::setApiCalledCallback(callback);
     }
 
+    /// Set the callback dispatcher configuration.
+    ///
+    /// Description: Event callbacks are moved from the SDK internal threads to the callback thread through a pooled, batched queue. This function configures the task pool size, the queue depth limit, the batch size and what happens when the queue is full.
+    /// When to call: Any time. [taskPoolSize] only takes effect before the first callback is dispatched, so it is recommended to call it before [createEngine].
+    /// Restrictions: None.
+    ///
+    /// @param config Callback dispatcher configuration.
+    static void setCallbackDispatcherConfig(const ZegoCallbackDispatcherConfig &config) {
+        ZegoExpressSDKInternal::setCallbackDispatcherConfig(config);
+    }
+
+    /// Get the callback dispatcher statistics.
+    ///
+    /// Description: Returns the cumulative counters of the callback dispatcher, such as the number of callbacks executed, dropped or executed inline, and the queue depth.
+    /// When to call: Any time.
+    /// Restrictions: None.
+    ///
+    /// @return Callback dispatcher statistics.
+    static ZegoCallbackDispatcherStats getCallbackDispatcherStats() {
+        return ZegoExpressSDKInternal::getCallbackDispatcherStats();
+    }
+
+    /// Set the callback profiler configuration.
+    ///
+    /// Description: Measures how long every event callback waits between the SDK internal thread posting it and the handler starting (queueing delay), and how long the handler runs. The values are kept in a histogram per callback type and/or written as trace events to a Chrome trace file, so a slow handler can be told from a flooded callback queue without attaching a profiler.
+    /// When to call: Any time. Changing [traceFilePath] completes the current trace file and starts a new one, an empty path completes it and stops tracing.
+    /// Restrictions: Only callbacks switched to the callback thread are measured. Audio and video frame callbacks, which run on the SDK internal threads, are not.
+    /// Caution: While both latency statistics and tracing are off, the profiler costs one atomic load per callback.
+    ///
+    /// @param config Callback profiler configuration.
+    static void setCallbackProfilerConfig(const ZegoCallbackProfilerConfig &config) {
+        ZegoExpressSDKInternal::setCallbackProfilerConfig(config);
+    }
+
+    /// Get the callback latency statistics.
+    ///
+    /// Description: Queueing delay and handler runtime percentiles of every callback type measured since latency statistics were enabled or last reset. [onCallbackLatencyStatsUpdate] delivers the same statistics per [startPerformanceMonitor] period.
+    /// When to call: Any time after [setCallbackProfilerConfig] enabled [ZegoCallbackProfilerConfig.enableLatencyStats].
+    /// Restrictions: None.
+    ///
+    /// @return Statistics of the callback types that fired at least once.
+    static std::vector<ZegoCallbackLatencyStats> getCallbackLatencyStats() {
+        return ZegoExpressSDKInternal::getCallbackLatencyStats();
+    }
+
+    /// Reset the callback latency statistics.
+    ///
+    /// Description: Clears the histograms read by [getCallbackLatencyStats] and [onCallbackLatencyStatsUpdate].
+    /// When to call: Any time.
+    /// Restrictions: None.
+    static void resetCallbackLatencyStats() { ZegoExpressSDKInternal::resetCallbackLatencyStats(); }
+
+    /// Add an event to the callback trace file.
+    ///
+    /// Description: Writes a complete event into the trace file started by [setCallbackProfilerConfig], so work of other components, e.g. ZegoConnection queue runner jobs and thread pool tasks, shows up on the same timeline as the callbacks. Timestamps are std::chrono::steady_clock nanoseconds. The signature matches the ZegoConnection trace sink, so this function can be installed with CZegoTraceHook::SetSink.
+    /// When to call: Any time, the event is ignored while tracing is off.
+    /// Restrictions: [category] and [name] are written out later on the trace writer thread, they must be string literals or otherwise stay valid until tracing stops.
+    ///
+    /// @param category Event category.
+    /// @param name Event name.
+    /// @param beginNs Start time.
+    /// @param durationNs Duration.
+    /// @param queueNs Time the work waited before it started, negative if unknown.
+    static void addCallbackTraceEvent(const char *category, const char *name, long long beginNs,
+                                      long long durationNs, long long queueNs) {
+        ZegoExpressSDKInternal::addCallbackTraceEvent(category, name, beginNs, durationNs,
+                                                      queueNs);
+    }
+
+    /// Enable or disable the extended performance status.
+    ///
+    /// Description: When enabled, [onExtendedPerformanceStatusUpdate] is triggered after every [onPerformanceStatusUpdate] with the CPU usage of the busiest threads, the allocation rate and bytes in flight, the depth of the callback queue and of the queues registered with [setQueueDepthProvider], and the latest decode and render frame rate of every playing stream. The allocation fields are only filled when one translation unit of the app defines ZEGOEXP_ALLOCATION_HOOK before including ZegoExpressSDK.h, which replaces the global operator new and delete with counting versions.
+    /// When to call: Any time, the first report after enabling covers a full [startPerformanceMonitor] period.
+    /// Restrictions: Per thread CPU usage is only available on Linux and Android, where it is read from /proc/self/task.
+    /// Caution: Sampling runs on the SDK internal thread once per period and costs well under 0.1% CPU at the default period.
+    ///
+    /// @param enable Whether to enable the extended performance status.
+    static void enableExtendedPerformanceStatus(bool enable) {
+        ZegoExpressSDKInternal::enableExtendedPerformanceStatus(enable);
+    }
+
+    /// Set the depth provider of a queue reported by the extended performance status.
+    ///
+    /// Description: The provider is called on the SDK internal thread on every extended performance status sample, its result is reported in [ZegoExtendedPerformanceStatus.queueDepths]. Typical providers return ZegoConnectionThreadPool::Instance().PendingTasks(...) or zlogger::logger::pending_bytes().
+    /// When to call: Any time.
+    /// Restrictions: The depth of ZEGO_PERFORMANCE_QUEUE_CALLBACK is measured by the SDK and cannot be replaced.
+    ///
+    /// @param queue Queue whose depth the provider returns.
+    /// @param provider Depth provider, nullptr to report 0.
+    static void setQueueDepthProvider(ZegoPerformanceQueue queue,
+                                      ZegoQueueDepthProvider provider) {
+        ZegoExpressSDKInternal::setQueueDepthProvider(queue, provider);
+    }
+
+    /// Set the quality metrics store configuration.
+    ///
+    /// Description: When enabled, every [onPublisherQualityUpdate], [onPlayerQualityUpdate] and [onNetworkQuality] sample is kept in fixed size ring buffers per stream or user, together with min/avg/max/p95 summaries per minute and per ten minutes, so the quality history of the whole call can be queried with [queryQualityMetrics] or attached to a log upload with [exportQualityMetrics].
+    /// When to call: Any time, it is recommended to call it before [loginRoom]. Disabling the store or changing a capacity drops the recorded history.
+    /// Restrictions: None.
+    /// Caution: Memory is allocated once per series and does not grow with the call length, see [ZegoQualityMetricsStoreConfig] for the budget. Recording a sample does not allocate.
+    ///
+    /// @param config Quality metrics store configuration.
+    static void setQualityMetricsStoreConfig(const ZegoQualityMetricsStoreConfig &config) {
+        ZegoExpressSDKInternal::setQualityMetricsStoreConfig(config);
+    }
+
+    /// Query the recorded history of a quality metric.
+    ///
+    /// Description: Copies the points of [metric] in [beginTime, endTime) into [points], oldest first. The range is found by binary search, the cost depends on the number of points returned, not on the length of the call.
+    /// When to call: Any time after [setQualityMetricsStoreConfig] enabled the store.
+    /// Restrictions: None.
+    ///
+    /// @param id Stream ID for publish and play metrics, user ID for network metrics, empty for the local user.
+    /// @param metric Metric to query.
+    /// @param resolution Raw samples or one of the downsampled tiers.
+    /// @param beginTime Start of the range, in ms since the Unix epoch. Downsampled points whose period contains it are included.
+    /// @param endTime End of the range, exclusive, in ms since the Unix epoch.
+    /// @param points Output array.
+    /// @param maxPoints Capacity of [points].
+    /// @return Number of points written.
+    static unsigned int queryQualityMetrics(const std::string &id, ZegoQualityMetric metric,
+                                            ZegoQualityMetricsResolution resolution,
+                                            long long beginTime, long long endTime,
+                                            ZegoQualityMetricsPoint *points,
+                                            unsigned int maxPoints) {
+        return ZegoExpressSDKInternal::queryQualityMetrics(id, metric, resolution, beginTime,
+                                                           endTime, points, maxPoints);
+    }
+
+    /// Export the quality metrics store.
+    ///
+    /// Description: Serializes every series with all three tiers into a compact binary blob that can be attached to a log upload. Timestamps are delta and varint encoded, values are little endian float32 stored column by column. The layout is described in ZegoInternalMetricsStore.hpp.
+    /// When to call: Any time after [setQualityMetricsStoreConfig] enabled the store.
+    /// Restrictions: None.
+    ///
+    /// @return Binary blob, empty series list if the store is disabled.
+    static std::vector<unsigned char> exportQualityMetrics() {
+        return ZegoExpressSDKInternal::exportQualityMetrics();
+    }
+
+    /// Enable or disable the sound level table.
+    ///
+    /// Description: When enabled, remote sound level, VAD, audio spectrum and mixer sound level updates are written into a preallocated struct-of-arrays table indexed by stream handle instead of being delivered as maps through [onRemoteSoundLevelUpdate], [onRemoteSoundLevelInfoUpdate], [onRemoteAudioSpectrumUpdate] and [onMixerSoundLevelUpdate]. Read the table with [readSoundLevelSnapshot] at the UI refresh rate.
+    /// When to call: Any time, it is recommended to call it before [startSoundLevelMonitor].
+    /// Restrictions: The table holds at most 512 streams at a time and 64 spectrum bins per stream, and 64 mixer sound levels. Streams beyond that are counted in [ZegoSoundLevelSnapshot.overflowCount].
+    /// Caution: While enabled, the map based callbacks listed above are not triggered.
+    ///
+    /// @param enable Whether to enable the sound level table.
+    static void enableSoundLevelTable(bool enable) {
+        ZegoExpressSDKInternal::enableSoundLevelTable(enable);
+    }
+
+    /// Get the handle of a stream ID.
+    ///
+    /// Description: Stream IDs are interned when they are added to the room or first appear in a sound level update. The handle stays the same until the stream is deleted from the room and indexes the arrays of [ZegoSoundLevelSnapshot]. After that it may be given to a later stream.
+    /// When to call: After [enableSoundLevelTable], typically in [onRoomStreamUpdate].
+    /// Restrictions: None.
+    ///
+    /// @param streamID Stream ID.
+    /// @return Stream handle, [ZEGO_STREAM_HANDLE_INVALID] if the stream ID has not been seen yet.
+    static ZegoStreamHandle getStreamHandle(const std::string &streamID) {
+        return ZegoExpressSDKInternal::getStreamHandle(streamID);
+    }
+
+    /// Get the stream ID of a stream handle.
+    ///
+    /// Description: Reverse lookup of [getStreamHandle].
+    /// When to call: After [enableSoundLevelTable].
+    /// Restrictions: None.
+    ///
+    /// @param handle Stream handle.
+    /// @return Stream ID, empty if the handle is unknown.
+    static std::string getStreamIDByHandle(ZegoStreamHandle handle) {
+        return ZegoExpressSDKInternal::getStreamIDByHandle(handle);
+    }
+
+    /// Read the latest sound level snapshot.
+    ///
+    /// Description: Copies the latest sound level table into [snapshot] without taking a lock, so it can be called from the UI thread on every frame. Compare the sequence numbers with the previous read to skip unchanged sections.
+    /// When to call: After [enableSoundLevelTable].
+    /// Restrictions: None.
+    ///
+    /// @param snapshot Snapshot to fill, reuse the same object between reads.
+    static void readSoundLevelSnapshot(ZegoSoundLevelSnapshot &snapshot) {
+        ZegoExpressSDKInternal::readSoundLevelSnapshot(snapshot);
+    }
+
     /// Query whether the current SDK supports the specified feature.
     ///
     /// Available since: 2.22.0
@@ -235,6 +422,32 @@ class ZegoExpressSDK {
     /// Caution: When developers need to display the SDK dynamic library, they must add the preprocessing macro ZEGOEXP_EXPLICIT to the project to enable display loading. When the SDK function is not needed, call this interface to unload the dynamic library.
     static void unLoadLibrary() { ZegoExpressSDKInternal::unLoadLibrary(); }
 
+    /// Show loading SDK dynamic library with a binding config.
+    ///
+    /// Description: Same as [loadLibrary], but lets the SDK functions be resolved on their first call instead of all at load time, which shortens the time to the first engine call.
+    /// When to call: When a dynamic SDK library needs to be loaded explicitly, the SDK is the first interface called. Other SDK interfaces can be called only after the loading is successful.
+    /// Restrictions: When the SDK dynamic library needs to be loaded explicitly, this interface or [loadLibrary] must be called first.
+    /// Caution: Requires the preprocessing macro ZEGOEXP_EXPLICIT.
+    ///
+    /// @param sdk_library_full_path SDK dynamic library absolute path.
+    /// @param config Load library config.
+    /// @return Error code.
+    static int loadLibrary(const std::string &sdk_library_full_path,
+                           const ZegoLoadLibraryConfig &config) {
+        return ZegoExpressSDKInternal::loadLibrary(sdk_library_full_path, config);
+    }
+
+    /// Get the SDK startup timing report.
+    ///
+    /// Description: Breaks the startup time down into opening the dynamic library, resolving symbols and creating the engine, and lists the symbols the loaded library does not export.
+    /// When to call: Any time, typically after [createEngine].
+    /// Restrictions: The library and symbol fields are only filled when the preprocessing macro ZEGOEXP_EXPLICIT is enabled.
+    ///
+    /// @return Library load report.
+    static ZegoLibraryLoadReport getLibraryLoadReport() {
+        return ZegoExpressSDKInternal::getLibraryLoadReport();
+    }
+
     /// Uploads logs to the ZEGO server.
     ///
     /// Available since: 3.7.0
@@ -25,7 +25,7 @@ class ZegoExpressAudioEffectPlayerImp : public IZegoAudioEffectPlayer {
                       ZegoAudioEffectPlayerLoadResourceCallback callback) override {
         int seq = oInternalOriginBridge->audioEffectPlayerLoadResource(
             audioEffectID, path.c_str(), zego_audio_effect_player_instance_index(instanceIndex));
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(audioEffectEventMutex);
             aepLoadResourceCallbacks.insert({seq, callback});
         }
@@ -84,7 +84,7 @@ class ZegoExpressAudioEffectPlayerImp : public IZegoAudioEffectPlayer {
                 ZegoAudioEffectPlayerSeekToCallback callback) override {
         int seq = oInternalOriginBridge->audioEffectPlayerSeekTo(
             audioEffectID, millisecond, zego_audio_effect_player_instance_index(instanceIndex));
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(audioEffectEventMutex);
             aepSeekToCallbacks.insert({seq, callback});
         }
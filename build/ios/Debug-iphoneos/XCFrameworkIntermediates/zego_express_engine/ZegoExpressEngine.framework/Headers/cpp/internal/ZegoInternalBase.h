@@ -4,6 +4,9 @@
 #include "../ZegoExpressErrorCode.h"
 #include "../ZegoExpressEventHandler.h"
 #include "ZegoInternalBridge.h"
+#include "ZegoInternalDispatcher.hpp"
+#include "ZegoInternalRcu.hpp"
+#include "ZegoInternalSoundLevelTable.hpp"
 
 namespace ZEGO {
 namespace EXPRESS {
@@ -23,18 +26,14 @@ namespace EXPRESS {
     }
 
 #define declearSingleShareMember(MemberType)                                                       \
-    std::shared_ptr<MemberType> m##MemberType;                                                     \
-    std::recursive_mutex m##MemberType##Mutex;                                                     \
+    ZegoRcuSharedSlot<MemberType> m##MemberType;                                                   \
                                                                                                    \
-    void set##MemberType(std::shared_ptr<MemberType> member) {                                     \
-        std::lock_guard<std::recursive_mutex> lock(m##MemberType##Mutex);                          \
-        m##MemberType = member;                                                                    \
-    }                                                                                              \
+    void set##MemberType(std::shared_ptr<MemberType> member) { m##MemberType.set(member); }        \
                                                                                                    \
-    std::shared_ptr<MemberType> get##MemberType() {                                                \
-        std::lock_guard<std::recursive_mutex> lock(m##MemberType##Mutex);                          \
-        return m##MemberType;                                                                      \
-    }
+    std::shared_ptr<MemberType> get##MemberType() { return m##MemberType.get(); }                  \
+                                                                                                   \
+    /* Caller must hold a ZegoRcuReadGuard */                                                      \
+    MemberType *peek##MemberType() { return m##MemberType.peek(); }
 
 #define declearMultiRawMember(KeyType, MemberType)                                                 \
     std::unordered_map<KeyType, MemberType> m##MemberType;                                         \
@@ -62,29 +61,37 @@ namespace EXPRESS {
     }
 
 #define declearMultiShareMember(MemberType)                                                        \
-    std::unordered_map<zego_seq, std::shared_ptr<MemberType>> m##MemberType;                       \
-    std::recursive_mutex m##MemberType##Mutex;                                                     \
+    ZegoRcuSharedMap<zego_seq, MemberType> m##MemberType;                                          \
                                                                                                    \
     void insert##MemberType(zego_seq seq, std::shared_ptr<MemberType> member) {                    \
-        std::lock_guard<std::recursive_mutex> lock(m##MemberType##Mutex);                          \
-        m##MemberType.insert({seq, member});                                                       \
+        m##MemberType.insert(seq, member);                                                         \
     }                                                                                              \
                                                                                                    \
-    std::shared_ptr<MemberType> get##MemberType(zego_seq seq) {                                    \
-        std::lock_guard<std::recursive_mutex> lock(m##MemberType##Mutex);                          \
-        std::shared_ptr<MemberType> member = nullptr;                                              \
-        if (m##MemberType.count(seq) > 0) {                                                        \
-            member = m##MemberType[seq];                                                           \
-        }                                                                                          \
-        return member;                                                                             \
-    }                                                                                              \
+    std::shared_ptr<MemberType> get##MemberType(zego_seq seq) { return m##MemberType.get(seq); }   \
+                                                                                                   \
+    /* Caller must hold a ZegoRcuReadGuard */                                                      \
+    MemberType *peek##MemberType(zego_seq seq) { return m##MemberType.peek(seq); }                 \
                                                                                                    \
     std::shared_ptr<MemberType> erase##MemberType(zego_seq seq) {                                  \
-        std::lock_guard<std::recursive_mutex> lock(m##MemberType##Mutex);                          \
-        std::shared_ptr<MemberType> member = get##MemberType(seq);                                 \
-        m##MemberType.erase(seq);                                                                  \
-        return member;                                                                             \
+        return m##MemberType.erase(seq);                                                           \
+    }
+
+// Callbacks of calls that got ZEGOEXP_MISSING_SEQ from the bridge, which no completion will ever
+// reach. fail() reports the error of the missing function to such a callback right away, its other
+// arguments left empty, and returns false for any other seq so the caller registers the callback.
+struct ZegoMissingSeq {
+    template <typename... Args>
+    static bool fail(zego_seq seq, const std::function<void(int, Args...)> &callback) {
+        if (seq != ZEGOEXP_MISSING_SEQ) {
+            return false;
+        }
+        ZEGO_SWITCH_THREAD_PRE_STATIC
+        callback(ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND,
+                 typename std::decay<Args>::type()...);
+        ZEGO_SWITCH_THREAD_ING
+        return true;
     }
+};
 
 using ZegoVoidPtr = void *;
 using ZegoUInt = unsigned int;
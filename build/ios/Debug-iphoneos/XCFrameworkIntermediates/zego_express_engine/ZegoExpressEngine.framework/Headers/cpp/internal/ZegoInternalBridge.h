@@ -88,17 +88,42 @@ class ZegoExpressEngineBridge {
 
     void setLicense(const char *license) { zego_express_set_license(license); }
 
-    int loadLibrary(const std::string &sdk_library_full_path) {
+    int loadLibrary(const std::string &sdk_library_full_path, bool lazy = false,
+                    bool preload_core = true) {
         int error_code = 0;
 #ifdef ZEGOEXP_EXPLICIT
-        error_code = loadLibraryInternal(sdk_library_full_path);
+        error_code = loadLibraryInternal(sdk_library_full_path, lazy, preload_core);
         library_ready = (error_code == 0);
 #else
+        ZEGO_UNUSED_VARIABLE(sdk_library_full_path);
+        ZEGO_UNUSED_VARIABLE(lazy);
+        ZEGO_UNUSED_VARIABLE(preload_core);
         error_code = ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_NOT_SUPPORT;
 #endif
         return error_code;
     }
 
+    void setCreateEngineTime(unsigned long long time_us) { create_engine_time_us = time_us; }
+
+    ZegoLibraryLoadReport getLibraryLoadReport() {
+        ZegoLibraryLoadReport report;
+        report.createEngineTime = create_engine_time_us;
+#ifdef ZEGOEXP_EXPLICIT
+        report.loadLibraryTime = explicit_registry.loadLibraryTimeUs;
+        report.resolveSymbolsTime = explicit_registry.resolveSymbolsTimeUs;
+        report.lazyResolveTime = explicit_registry.lazyResolveTimeUs;
+        for (auto symbol = explicit_registry.head; symbol; symbol = symbol->next) {
+            report.totalSymbolCount++;
+            if (symbol->resolved()) {
+                report.resolvedSymbolCount++;
+            } else if (symbol->missing()) {
+                report.missingSymbols.push_back(symbol->name);
+            }
+        }
+#endif
+        return report;
+    }
+
     void unLoadLibrary() {
 #ifdef ZEGOEXP_EXPLICIT
         unLoadLibraryInternal();
@@ -182,8 +207,8 @@ class ZegoExpressEngineBridge {
 
     int uploadLog() {
         int seq = 0;
-        zego_express_upload_log(&seq);
-        return seq;
+        int error_code = zego_express_upload_log(&seq);
+        return seqOf(error_code, seq);
     }
 
     void enableDebugAssistant(bool enable) { zego_express_enable_debug_assistant(enable); }
@@ -196,8 +221,8 @@ class ZegoExpressEngineBridge {
 
     int loginRoomWithCallback(const char *room_id, zego_user user, zego_room_config *room_config) {
         int seq = 0;
-        zego_express_login_room_with_callback(room_id, user, room_config, &seq);
-        return seq;
+        int error_code = zego_express_login_room_with_callback(room_id, user, room_config, &seq);
+        return seqOf(error_code, seq);
     }
 
     void logoutRoom() { zego_express_logout_all_room(); }
@@ -206,14 +231,14 @@ class ZegoExpressEngineBridge {
 
     int logoutRoomWithCallback() {
         int seq = 0;
-        zego_express_logout_all_room_with_callback(&seq);
-        return seq;
+        int error_code = zego_express_logout_all_room_with_callback(&seq);
+        return seqOf(error_code, seq);
     }
 
     int logoutRoomWithCallback(const char *room_id) {
         int seq = 0;
-        zego_express_logout_room_with_callback(room_id, &seq);
-        return seq;
+        int error_code = zego_express_logout_room_with_callback(room_id, &seq);
+        return seqOf(error_code, seq);
     }
 
     void switchRoom(const char *from_room_id, const char *to_room_id,
@@ -242,8 +267,8 @@ class ZegoExpressEngineBridge {
 
     int setRoomExtraInfo(const char *extraInfo, const char *key, const char *value) {
         int seq = 0;
-        zego_express_set_room_extra_info(extraInfo, key, value, &seq);
-        return seq;
+        int error_code = zego_express_set_room_extra_info(extraInfo, key, value, &seq);
+        return seqOf(error_code, seq);
     }
 
     void setVideoMirrorMode(zego_video_mirror_mode mirrorMode, zego_publish_channel channel) {
@@ -301,8 +326,8 @@ class ZegoExpressEngineBridge {
 
     int setStreamExtraInfo(const char *extraInfo, zego_publish_channel channel) {
         int seq = 0;
-        zego_express_set_stream_extra_info(extraInfo, channel, &seq);
-        return seq;
+        int error_code = zego_express_set_stream_extra_info(extraInfo, channel, &seq);
+        return seqOf(error_code, seq);
     }
 
     void setPublishStreamEncryptionKey(const char *key, zego_publish_channel channel) {
@@ -339,14 +364,14 @@ class ZegoExpressEngineBridge {
 
     int addPublishCdnUrl(const char *streamID, const char *targetURL, int timeout) {
         int seq = 0;
-        zego_express_add_publish_cdn_url_v2(streamID, targetURL, timeout, &seq);
-        return seq;
+        int error_code = zego_express_add_publish_cdn_url_v2(streamID, targetURL, timeout, &seq);
+        return seqOf(error_code, seq);
     }
 
     int removePublishCdnUrl(const char *streamID, const char *targetURL) {
         int seq = 0;
-        zego_express_remove_publish_cdn_url(streamID, targetURL, &seq);
-        return seq;
+        int error_code = zego_express_remove_publish_cdn_url(streamID, targetURL, &seq);
+        return seqOf(error_code, seq);
     }
 
     void enablePublishDirectToCDN(bool enable, zego_cdn_config *config,
@@ -876,9 +901,9 @@ class ZegoExpressEngineBridge {
     int realTimeSequentialDataSendData(const unsigned char *data, unsigned int data_length,
                                        const char *stream_id, int instance_index) {
         int seq = 0;
-        zego_express_send_real_time_sequential_data(data, data_length, stream_id, instance_index,
-                                                    &seq);
-        return seq;
+        int error_code = zego_express_send_real_time_sequential_data(
+            data, data_length, stream_id, instance_index, &seq);
+        return seqOf(error_code, seq);
     }
 
     int realTimeSequentialDataStartSubscribing(const char *stream_id, int_fast16_t instance_index) {
@@ -895,52 +920,53 @@ class ZegoExpressEngineBridge {
 
     int sendBroadcastMessage(const char *room_id, const char *content) {
         int seq = 0;
-        zego_express_send_broadcast_message(room_id, content, &seq);
-        return seq;
+        int error_code = zego_express_send_broadcast_message(room_id, content, &seq);
+        return seqOf(error_code, seq);
     }
 
     int sendBarrageMessage(const char *room_id, const char *content) {
         int seq = 0;
-        zego_express_send_barrage_message(room_id, content, &seq);
-        return seq;
+        int error_code = zego_express_send_barrage_message(room_id, content, &seq);
+        return seqOf(error_code, seq);
     }
 
     int sendCustomCommand(const char *room_id, const char *content, struct zego_user *to_user_list,
                           unsigned int to_user_count) {
         int seq = 0;
-        zego_express_send_custom_command(room_id, content, to_user_list, to_user_count, &seq);
-        return seq;
+        int error_code = zego_express_send_custom_command(
+            room_id, content, to_user_list, to_user_count, &seq);
+        return seqOf(error_code, seq);
     }
 
     int sendTransparentMessage(const char *room_id,
                                struct zego_room_send_transparent_message *message) {
         int seq = 0;
-        zego_express_send_transparent_message(room_id, message, &seq);
-        return seq;
+        int error_code = zego_express_send_transparent_message(room_id, message, &seq);
+        return seqOf(error_code, seq);
     }
 
     int startMixerTask(zego_mixer_task task) {
         int seq = 0;
-        zego_express_start_mixer_task(task, &seq);
-        return seq;
+        int error_code = zego_express_start_mixer_task(task, &seq);
+        return seqOf(error_code, seq);
     }
 
     int stopMixerTask(zego_mixer_task task) {
         int seq = 0;
-        zego_express_stop_mixer_task(task, &seq);
-        return seq;
+        int error_code = zego_express_stop_mixer_task(task, &seq);
+        return seqOf(error_code, seq);
     }
 
     int startAutoMixerTask(zego_auto_mixer_task task) {
         int seq = 0;
-        zego_express_start_auto_mixer_task(task, &seq);
-        return seq;
+        int error_code = zego_express_start_auto_mixer_task(task, &seq);
+        return seqOf(error_code, seq);
     }
 
     int stopAutoMixerTask(zego_auto_mixer_task task) {
         int seq = 0;
-        zego_express_stop_auto_mixer_task(task, &seq);
-        return seq;
+        int error_code = zego_express_stop_auto_mixer_task(task, &seq);
+        return seqOf(error_code, seq);
     }
 
     zego_media_player_instance_index createMediaPlayer() {
@@ -1286,8 +1312,9 @@ class ZegoExpressEngineBridge {
     int audioEffectPlayerLoadResource(unsigned int audio_effect_id, const char *path,
                                       zego_audio_effect_player_instance_index instance_index) {
         int seq = 0;
-        zego_express_audio_effect_player_load_resource(audio_effect_id, path, instance_index, &seq);
-        return seq;
+        int error_code = zego_express_audio_effect_player_load_resource(
+            audio_effect_id, path, instance_index, &seq);
+        return seqOf(error_code, seq);
     }
 
     int audioEffectPlayerUnloadResource(unsigned int audio_effect_id,
@@ -1341,9 +1368,9 @@ class ZegoExpressEngineBridge {
     int audioEffectPlayerSeekTo(unsigned int audio_effect_id, unsigned long long millisecond,
                                 zego_audio_effect_player_instance_index instance_index) {
         int seq = 0;
-        zego_express_audio_effect_player_seek_to(audio_effect_id, millisecond, instance_index,
-                                                 &seq);
-        return seq;
+        int error_code = zego_express_audio_effect_player_seek_to(
+            audio_effect_id, millisecond, instance_index, &seq);
+        return seqOf(error_code, seq);
     }
 
     int audioEffectPlayerSetVolume(unsigned int audio_effect_id, int volume,
@@ -1565,8 +1592,8 @@ class ZegoExpressEngineBridge {
 
     int testNetworkConnectivity() {
         int seq = 0;
-        zego_express_test_network_connectivity(&seq);
-        return seq;
+        int error_code = zego_express_test_network_connectivity(&seq);
+        return seqOf(error_code, seq);
     }
 
     void startNetworkSpeedTest(zego_network_speed_test_config config, unsigned int interval) {
@@ -1583,8 +1610,8 @@ class ZegoExpressEngineBridge {
 
     int startNetworkProbe(zego_network_probe_config config) {
         int seq = 0;
-        zego_express_start_network_probe(config, &seq);
-        return seq;
+        int error_code = zego_express_start_network_probe(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     void stopNetworkProbe() { zego_express_stop_network_probe(); }
@@ -1693,8 +1720,8 @@ class ZegoExpressEngineBridge {
 
     int copyrightedMusicInitCopyrightedMusic(zego_copyrighted_music_config config) {
         int seq = 0;
-        zego_express_copyrighted_music_init(config, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_init(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     unsigned long long copyrightedMusicGetCacheSize() {
@@ -1707,89 +1734,91 @@ class ZegoExpressEngineBridge {
 
     int copyrightedMusicSendExtendedRequest(const char *command, const char *params) {
         int seq = 0;
-        zego_express_copyrighted_music_send_extended_request(command, params, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_send_extended_request(
+            command, params, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicGetLrcLyric(const char *song_id) {
         int seq = 0;
-        zego_express_copyrighted_music_get_lrc_lyric(song_id, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_lrc_lyric(song_id, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicGetLrcLyric(const char *song_id,
                                     zego_copyrighted_music_vendor_id vendor_id) {
         int seq = 0;
-        zego_express_copyrighted_music_get_lrc_lyric_with_vendor(song_id, vendor_id, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_lrc_lyric_with_vendor(
+            song_id, vendor_id, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicGetLrcLyric(zego_copyrighted_music_get_lyric_config config) {
         int seq = 0;
-        zego_express_copyrighted_music_get_lrc_lyric_with_config(config, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_lrc_lyric_with_config(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicGetKrcLyricByToken(const char *krc_token) {
         int seq = 0;
-        zego_express_copyrighted_music_get_krc_lyric_by_token(krc_token, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_krc_lyric_by_token(krc_token, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicRequestSong(zego_copyrighted_music_request_config config) {
         int seq = 0;
-        zego_express_copyrighted_music_request_song(config, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_request_song(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicRequestAccompaniment(zego_copyrighted_music_request_config config) {
         int seq = 0;
-        zego_express_copyrighted_music_request_accompaniment(config, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_request_accompaniment(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicRequestAccompanimentClip(zego_copyrighted_music_request_config config) {
         int seq = 0;
-        zego_express_copyrighted_music_request_accompaniment_clip(config, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_request_accompaniment_clip(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicGetMusicByToken(const char *song_token) {
         int seq = 0;
-        zego_express_copyrighted_music_get_music_by_token(song_token, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_music_by_token(song_token, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicRequestResource(zego_copyrighted_music_request_config config,
                                         zego_copyrighted_music_resource_type type) {
         int seq = 0;
-        zego_express_copyrighted_music_request_resource(config, type, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_request_resource(config, type, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicRequestResource(zego_copyrighted_music_request_config_v2 config) {
         int seq = 0;
-        zego_express_copyrighted_music_request_resource_v2(config, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_request_resource_v2(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicGetSharedResource(zego_copyrighted_music_get_shared_config config,
                                           zego_copyrighted_music_resource_type type) {
         int seq = 0;
-        zego_express_copyrighted_music_get_shared_resource(config, type, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_shared_resource(config, type, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicGetSharedResource(zego_copyrighted_music_get_shared_config_v2 config) {
         int seq = 0;
-        zego_express_copyrighted_music_get_shared_resource_v2(config, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_shared_resource_v2(config, &seq);
+        return seqOf(error_code, seq);
     }
 
     int copyrightedMusicDownload(const char *resource_id) {
         int seq = 0;
-        zego_express_copyrighted_music_download(resource_id, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_download(resource_id, &seq);
+        return seqOf(error_code, seq);
     }
 
     void copyrightedMusicCancelDownload(const char *resource_id) {
@@ -1888,8 +1917,8 @@ class ZegoExpressEngineBridge {
 
     int copyrightedMusicGetStandardPitch(const char *resource_id) {
         int seq = 0;
-        zego_express_copyrighted_music_get_standard_pitch(resource_id, &seq);
-        return seq;
+        int error_code = zego_express_copyrighted_music_get_standard_pitch(resource_id, &seq);
+        return seqOf(error_code, seq);
     }
 
     struct zego_screen_capture_source_info *getScreenCaptureSources(int thumbnail_width,
@@ -3214,12 +3243,20 @@ class ZegoExpressEngineBridge {
 
     ZegoExpressEngineBridgePri *pri = nullptr;
 
+    // The seq a call handed out, or ZEGOEXP_MISSING_SEQ when the loaded library lacks the function
+    // and the seq was never set
+    static int seqOf(int error_code, int seq) {
+        return error_code == ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND ? ZEGOEXP_MISSING_SEQ
+                                                                             : seq;
+    }
+
 #ifdef ZEGOEXP_EXPLICIT
     bool library_ready = false;
     ZEGOEXP_DECLARE_FUNC
 #else
     bool library_ready = true;
 #endif
+    std::atomic<unsigned long long> create_engine_time_us = {0};
 
 #if defined(_WIN32) || TARGET_OS_OSX
     std::atomic<bool> callback_switch_to_main_thread_ = {true}; //only win and mac
@@ -12,6 +12,8 @@
 #include "ZegoInternalCopyrightedMusic.hpp"
 #include "ZegoInternalMediaDataPublisher.hpp"
 #include "ZegoInternalMediaPlayer.hpp"
+#include "ZegoInternalMetricsStore.hpp"
+#include "ZegoInternalPerfSampler.hpp"
 #include "ZegoInternalRangeAudio.hpp"
 #include "ZegoInternalRangeScene.hpp"
 #include "ZegoInternalRealTimeSequentialDataManager.hpp"
@@ -1007,6 +1009,10 @@ class ZegoInternalCallbackCenter {
         ZEGO_UNUSED_VARIABLE(hWnd);
         ZEGO_UNUSED_VARIABLE(lParam);
         if (uMsg == (WM_APP + 10086)) {
+            if (oInternalCallbackDispatcher->isDrainToken((void *)wParam)) {
+                oInternalCallbackDispatcher->drain();
+                return;
+            }
             std::function<void(void)> *pFunc = (std::function<void(void)> *)wParam;
             (*pFunc)();
             delete pFunc;
@@ -1020,6 +1026,11 @@ class ZegoInternalCallbackCenter {
             return;
         }
 
+        if (oInternalCallbackDispatcher->isDrainToken(call_back_task)) {
+            oInternalCallbackDispatcher->drain(excute);
+            return;
+        }
+
         std::function<void(void)> *pFunc = (std::function<void(void)> *)call_back_task;
         if (excute) {
             (*pFunc)();
@@ -1091,6 +1102,15 @@ class ZegoInternalCallbackCenter {
                                            unsigned int stream_info_count,
                                            const char *extended_data, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
+        if (oInternalSoundLevelTable->isEnabled()) {
+            for (unsigned int i = 0; i < stream_info_count; i++) {
+                if (update_type == zego_update_type_add) {
+                    oInternalSoundLevelTable->retain(stream_info_list[i].stream_id);
+                } else {
+                    oInternalSoundLevelTable->release(stream_info_list[i].stream_id);
+                }
+            }
+        }
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
         std::string roomID = room_id;
         std::string extendedData = extended_data;
@@ -1294,6 +1314,9 @@ class ZegoInternalCallbackCenter {
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
         ZegoPublishStreamQuality pushlishQuality = ZegoExpressConvert::I2OPushlishQuality(quality);
         std::string streamID = stream_id;
+        if (oInternalQualityMetricsStore->isEnabled()) {
+            oInternalQualityMetricsStore->addPublishQuality(stream_id, quality);
+        }
 
         auto weakHandler = std::weak_ptr<IZegoEventHandler>(handler);
         ZEGO_SWITCH_THREAD_PRE_STATIC
@@ -1563,6 +1586,13 @@ class ZegoInternalCallbackCenter {
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
         std::string streamID = stream_id;
         ZegoPlayStreamQuality playQuality = ZegoExpressConvert::I2OPlayQuality(quality);
+        if (oInternalPerformanceSampler->isEnabled()) {
+            oInternalPerformanceSampler->updateStreamFps(stream_id, quality.video_decode_fps,
+                                                         quality.video_render_fps);
+        }
+        if (oInternalQualityMetricsStore->isEnabled()) {
+            oInternalQualityMetricsStore->addPlayQuality(stream_id, quality);
+        }
 
         auto weakHandler = std::weak_ptr<IZegoEventHandler>(handler);
         ZEGO_SWITCH_THREAD_PRE_STATIC
@@ -1664,26 +1694,26 @@ class ZegoInternalCallbackCenter {
     static void zego_on_player_recv_sei(struct zego_media_side_info info, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
+        if (!handler) {
+            return;
+        }
 
         ZegoMediaSideInfo mediaSideInfo = ZegoExpressConvert::I2OMediaSideInfo(info);
+        ZegoPayloadRef payload = ZegoPayloadRef::copyFrom(info.sei_data, info.sei_data_length);
 
-        if (handler) {
-            handler->onPlayerSyncRecvSEI(mediaSideInfo.streamID, mediaSideInfo.SEIData,
-                                         mediaSideInfo.SEIDataLength);
-            handler->onPlayerRecvMediaSideInfo(mediaSideInfo);
-        }
+        handler->onPlayerSyncRecvSEI(mediaSideInfo.streamID, mediaSideInfo.SEIData,
+                                     mediaSideInfo.SEIDataLength);
+        handler->onPlayerRecvMediaSideInfo(mediaSideInfo);
+        handler->onPlayerSyncRecvSEIPayload(mediaSideInfo.streamID, payload);
 
         auto weakHandler = std::weak_ptr<IZegoEventHandler>(handler);
-        std::vector<unsigned char> seiData;
-        seiData.reserve(info.sei_data_length);
-        for (unsigned int i = 0; i < info.sei_data_length; i++) {
-            seiData.push_back(info.sei_data[i]);
-        }
+        std::string streamID = mediaSideInfo.streamID;
         ZEGO_SWITCH_THREAD_PRE_STATIC
         auto handlerInMain = weakHandler.lock();
-        if (handlerInMain)
-            handlerInMain->onPlayerRecvSEI(mediaSideInfo.streamID, seiData.data(),
-                                           ZegoUInt(seiData.size()));
+        if (handlerInMain) {
+            handlerInMain->onPlayerRecvSEI(streamID, payload.data(), payload.size());
+            handlerInMain->onPlayerRecvSEIPayload(streamID, payload);
+        }
         ZEGO_SWITCH_THREAD_ING
     }
 
@@ -1692,16 +1722,11 @@ class ZegoInternalCallbackCenter {
                                                     unsigned int data_length, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
-        std::string streamID = stream_id;
-        std::vector<unsigned char> audioSideData;
-        audioSideData.reserve(data_length);
-        for (unsigned int i = 0; i < data_length; i++) {
-            audioSideData.push_back(data[i]);
-        }
-
         if (handler) {
-            handler->onPlayerRecvAudioSideInfo(streamID, audioSideData.data(),
-                                               ZegoUInt(audioSideData.size()));
+            std::string streamID = stream_id;
+            ZegoPayloadRef payload = ZegoPayloadRef::copyFrom(data, data_length);
+            handler->onPlayerRecvAudioSideInfo(streamID, payload.data(), payload.size());
+            handler->onPlayerRecvAudioSideInfoPayload(streamID, payload);
         }
     }
     //#endif
@@ -1911,6 +1936,10 @@ class ZegoInternalCallbackCenter {
     zego_on_remote_sound_level_update(const zego_sound_level_info *sound_level_info_list,
                                       unsigned int info_count, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
+        if (oInternalSoundLevelTable->isEnabled()) {
+            oInternalSoundLevelTable->updateSoundLevels(sound_level_info_list, info_count, false);
+            return;
+        }
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
 
         std::unordered_map<std::string, float> soundLevels;
@@ -1933,6 +1962,10 @@ class ZegoInternalCallbackCenter {
     zego_on_remote_sound_level_info_update(const zego_sound_level_info *sound_level_info_list,
                                            unsigned int info_count, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
+        if (oInternalSoundLevelTable->isEnabled()) {
+            oInternalSoundLevelTable->updateSoundLevels(sound_level_info_list, info_count, true);
+            return;
+        }
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
 
         std::unordered_map<std::string, ZegoSoundLevelInfo> info;
@@ -1988,6 +2021,10 @@ class ZegoInternalCallbackCenter {
     zego_on_remote_audio_spectrum_update(const zego_audio_spectrum_info *audio_spectrum_info_list,
                                          unsigned int info_count, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
+        if (oInternalSoundLevelTable->isEnabled()) {
+            oInternalSoundLevelTable->updateSpectrums(audio_spectrum_info_list, info_count);
+            return;
+        }
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
         std::unordered_map<std::string, ZegoAudioSpectrum> audioSpectrums;
         for (unsigned int j = 0; j < info_count; j++) {
@@ -2206,6 +2243,10 @@ class ZegoInternalCallbackCenter {
         const struct zego_mixer_sound_level_info *sound_level_info_list, unsigned int info_count,
         void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
+        if (oInternalSoundLevelTable->isEnabled()) {
+            oInternalSoundLevelTable->updateMixerSoundLevels(sound_level_info_list, info_count);
+            return;
+        }
         auto handler = oInternalCallbackCenter->getIZegoEventHandler();
 
         std::unordered_map<unsigned int, float> soundLevels;
@@ -2279,7 +2320,8 @@ class ZegoInternalCallbackCenter {
                                                   zego_media_player_instance_index instance_index,
                                                   void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_state_update(state, error_code);
         }
@@ -2289,7 +2331,8 @@ class ZegoInternalCallbackCenter {
                                                    zego_media_player_instance_index instance_index,
                                                    void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_network_event(event);
         }
@@ -2300,7 +2343,8 @@ class ZegoInternalCallbackCenter {
                                           zego_media_player_instance_index instance_index,
                                           void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_playing_progress(millisecond);
         }
@@ -2311,7 +2355,8 @@ class ZegoInternalCallbackCenter {
                                             zego_media_player_instance_index instance_index,
                                             void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_rendering_progress(millisecond);
         }
@@ -2322,7 +2367,8 @@ class ZegoInternalCallbackCenter {
                                             zego_media_player_instance_index instance_index,
                                             void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_video_size_changed(width, height);
         }
@@ -2332,7 +2378,8 @@ class ZegoInternalCallbackCenter {
                                               enum zego_media_player_instance_index instance_index,
                                               void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_recv_sei(data, data_length);
         }
@@ -2343,7 +2390,8 @@ class ZegoInternalCallbackCenter {
                                             enum zego_media_player_instance_index instance_index,
                                             void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_sound_level_update(sound_level);
         }
@@ -2353,7 +2401,8 @@ class ZegoInternalCallbackCenter {
         float *spectrum_list, unsigned int spectrum_count,
         enum zego_media_player_instance_index instance_index, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_frequency_spectrum_update(spectrum_list,
                                                                         spectrum_count);
@@ -2364,7 +2413,8 @@ class ZegoInternalCallbackCenter {
                                              enum zego_media_player_instance_index instance_index,
                                              void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_mediaplayer_seek_to_result(seq, error_code);
         }
@@ -2375,7 +2425,8 @@ class ZegoInternalCallbackCenter {
                                          zego_media_player_instance_index instance_index,
                                          void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_mediaplayer_load_file_result(error_code);
         }
@@ -2387,7 +2438,8 @@ class ZegoInternalCallbackCenter {
                                      enum zego_media_player_instance_index instance_index,
                                      void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_audio_frame(data, data_length, param);
         }
@@ -2398,7 +2450,8 @@ class ZegoInternalCallbackCenter {
                                            enum zego_media_player_instance_index instance_index,
                                            void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_first_frame_event(event);
         }
@@ -2408,7 +2461,8 @@ class ZegoInternalCallbackCenter {
         zego_error error, const char *resource, const char *cached_file,
         enum zego_media_player_instance_index instance_index, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_local_cache(error, resource, cached_file);
         }
@@ -2419,7 +2473,8 @@ class ZegoInternalCallbackCenter {
         const struct zego_video_frame_param param, const char *extra_info,
         enum zego_media_player_instance_index instance_index, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_video_frame(data, data_length, param, extra_info);
         }
@@ -2430,7 +2485,8 @@ class ZegoInternalCallbackCenter {
                                               enum zego_media_player_instance_index instance_index,
                                               void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_take_snapshot_result(error_code, image,
                                                                    instance_index);
@@ -2442,7 +2498,8 @@ class ZegoInternalCallbackCenter {
                                      enum zego_media_player_instance_index instance_index,
                                      void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             mediaPlayer->zego_on_media_player_block_begin(path);
         }
@@ -2453,7 +2510,8 @@ class ZegoInternalCallbackCenter {
                                     enum zego_media_player_instance_index instance_index,
                                     void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto mediaPlayer = oInternalCallbackCenter->getZegoExpressMediaPlayerImp(instance_index);
+        ZegoRcuReadGuard guard;
+        auto mediaPlayer = oInternalCallbackCenter->peekZegoExpressMediaPlayerImp(instance_index);
         if (mediaPlayer) {
             return mediaPlayer->zego_on_media_player_block_data(buffer, buffer_size);
         }
@@ -2512,7 +2570,8 @@ class ZegoInternalCallbackCenter {
         enum zego_video_flip_mode flip_mode, enum zego_publish_channel channel,
         void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomVideoRenderHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomVideoRenderHandler();
         if (handler) {
             auto param = ZegoExpressConvert::I2OVideoFrameParam(_param);
             ZegoVideoFlipMode flipMode = ZegoVideoFlipMode(flip_mode);
@@ -2525,7 +2584,8 @@ class ZegoInternalCallbackCenter {
         const char *stream_id, unsigned char **data, unsigned int *data_length,
         const struct zego_video_frame_param _param, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomVideoRenderHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomVideoRenderHandler();
         if (handler) {
             std::string streamID = stream_id;
             auto param = ZegoExpressConvert::I2OVideoFrameParam(_param);
@@ -2538,7 +2598,8 @@ class ZegoInternalCallbackCenter {
         const struct zego_video_encoded_frame_param _param,
         unsigned long long reference_time_millisecond, const char *stream_id, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomVideoRenderHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomVideoRenderHandler();
         if (handler) {
             std::string streamID = stream_id;
             auto param = ZegoExpressConvert::I2OVideoEncodedFrameParam(_param);
@@ -2552,7 +2613,8 @@ class ZegoInternalCallbackCenter {
         const struct zego_video_frame_param _param, unsigned long long reference_time_millisecond,
         enum zego_publish_channel channel, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomVideoProcessHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomVideoProcessHandler();
         if (handler) {
             auto param = ZegoExpressConvert::I2OVideoFrameParam(_param);
             handler->onCapturedUnprocessedRawData(
@@ -2564,7 +2626,8 @@ class ZegoInternalCallbackCenter {
         void *buffer, unsigned long long reference_time_millisecond,
         enum zego_publish_channel channel, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomVideoProcessHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomVideoProcessHandler();
         if (handler) {
             handler->onCapturedUnprocessedCVPixelBuffer(buffer, reference_time_millisecond,
                                                         ZegoPublishChannel(channel));
@@ -2618,7 +2681,8 @@ class ZegoInternalCallbackCenter {
     static void zego_on_audio_mixing_copy_data(struct zego_audio_mixing_data *data,
                                                void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoAudioMixingHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoAudioMixingHandler();
         if (handler) {
             ZegoAudioMixingData audioMixingData;
             audioMixingData.audioData = data->audio_data;
@@ -2638,7 +2702,8 @@ class ZegoInternalCallbackCenter {
     static void zego_on_captured_audio_data(const unsigned char *data, unsigned int data_length,
                                             zego_audio_frame_param _param, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoAudioDataHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoAudioDataHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(_param);
             handler->onCapturedAudioData(data, data_length, param);
@@ -2648,7 +2713,8 @@ class ZegoInternalCallbackCenter {
     static void zego_on_playback_audio_data(const unsigned char *data, unsigned int data_length,
                                             zego_audio_frame_param _param, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoAudioDataHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoAudioDataHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(_param);
             handler->onPlaybackAudioData(data, data_length, param);
@@ -2658,7 +2724,8 @@ class ZegoInternalCallbackCenter {
     static void zego_on_mixed_audio_data(const unsigned char *data, unsigned int data_length,
                                          zego_audio_frame_param _param, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoAudioDataHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoAudioDataHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(_param);
             handler->onMixedAudioData(data, data_length, param);
@@ -2669,7 +2736,8 @@ class ZegoInternalCallbackCenter {
                                           struct zego_audio_frame_param _param,
                                           const char *stream_id, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoAudioDataHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoAudioDataHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(_param);
             handler->onPlayerAudioData(data, data_length, param, stream_id);
@@ -2717,7 +2785,8 @@ class ZegoInternalCallbackCenter {
                                                     struct zego_audio_frame_param *_param,
                                                     double timestamp, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomAudioProcessHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomAudioProcessHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(*_param);
             handler->onProcessCapturedAudioData(data, data_length, &param, timestamp);
@@ -2729,7 +2798,8 @@ class ZegoInternalCallbackCenter {
         unsigned char *data, unsigned int data_length, struct zego_audio_frame_param *_param,
         double timestamp, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomAudioProcessHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomAudioProcessHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(*_param);
             handler->onProcessCapturedAudioDataAfterUsedHeadphoneMonitor(data, data_length, &param,
@@ -2743,7 +2813,8 @@ class ZegoInternalCallbackCenter {
                                                      struct zego_audio_frame_param _param,
                                                      void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomAudioProcessHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomAudioProcessHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(_param);
             handler->onBeforeAudioPrepAudioData(data, data_length, param);
@@ -2755,7 +2826,8 @@ class ZegoInternalCallbackCenter {
                                                   const char *stream_id, double timestamp,
                                                   void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomAudioProcessHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomAudioProcessHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(*_param);
             handler->onProcessRemoteAudioData(data, data_length, &param, stream_id, timestamp);
@@ -2767,7 +2839,8 @@ class ZegoInternalCallbackCenter {
                                                     struct zego_audio_frame_param *_param,
                                                     double timestamp, void *user_context) {
         ZEGO_UNUSED_VARIABLE(user_context);
-        auto handler = oInternalCallbackCenter->getIZegoCustomAudioProcessHandler();
+        ZegoRcuReadGuard guard;
+        auto handler = oInternalCallbackCenter->peekIZegoCustomAudioProcessHandler();
         if (handler) {
             ZegoAudioFrameParam param = ZegoExpressConvert::I2OAudioFrameParam(*_param);
             handler->onProcessPlaybackAudioData(data, data_length, &param, timestamp);
@@ -2788,6 +2861,25 @@ class ZegoInternalCallbackCenter {
         if (handlerInMain)
             handlerInMain->onPerformanceStatusUpdate(status);
         ZEGO_SWITCH_THREAD_ING
+
+        if (oInternalCallbackProfiler->latencyStatsEnabled()) {
+            auto statsList = oInternalCallbackProfiler->getIntervalStats();
+            ZEGO_SWITCH_THREAD_PRE_STATIC
+            auto handlerInMain = weakHandler.lock();
+            if (handlerInMain)
+                handlerInMain->onCallbackLatencyStatsUpdate(statsList);
+            ZEGO_SWITCH_THREAD_ING
+        }
+
+        if (oInternalPerformanceSampler->isEnabled()) {
+            ZegoExtendedPerformanceStatus extendedStatus;
+            oInternalPerformanceSampler->sample(extendedStatus);
+            ZEGO_SWITCH_THREAD_PRE_STATIC
+            auto handlerInMain = weakHandler.lock();
+            if (handlerInMain)
+                handlerInMain->onExtendedPerformanceStatusUpdate(extendedStatus);
+            ZEGO_SWITCH_THREAD_ING
+        }
     }
 
     static void zego_on_network_mode_changed(enum zego_network_mode mode, void *user_context) {
@@ -2984,6 +3076,10 @@ class ZegoInternalCallbackCenter {
         }
         ZegoStreamQualityLevel upstreamQuality = (ZegoStreamQualityLevel)upstream_quality;
         ZegoStreamQualityLevel downstreamQuality = (ZegoStreamQualityLevel)downstream_quality;
+        if (oInternalQualityMetricsStore->isEnabled()) {
+            oInternalQualityMetricsStore->addNetworkQuality(user_id, upstream_quality,
+                                                            downstream_quality);
+        }
         ZEGO_SWITCH_THREAD_PRE_STATIC
         auto handler = weakHandler.lock();
         if (handler) {
@@ -30,7 +30,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
                     ZEGO_EXPRESS_MAX_USERNAME_LEN);
 
         int seq = oInternalOriginBridge->copyrightedMusicInitCopyrightedMusic(_config);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             initCallbacks.insert({seq, callback});
         }
@@ -48,7 +48,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         const char *_params = params.empty() ? nullptr : params.c_str();
 
         int seq = oInternalOriginBridge->copyrightedMusicSendExtendedRequest(_command, _params);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             sendExtendedRequestCallbacks.insert({seq, callback});
         }
@@ -59,7 +59,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         const char *_songID = songID.empty() ? nullptr : songID.c_str();
 
         int seq = oInternalOriginBridge->copyrightedMusicGetLrcLyric(_songID);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getLrcLyricCallbacks.insert({seq, callback});
         }
@@ -71,7 +71,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
 
         int seq = oInternalOriginBridge->copyrightedMusicGetLrcLyric(
             _songID, (zego_copyrighted_music_vendor_id)vendorID);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getLrcLyricCallbacks.insert({seq, callback});
         }
@@ -83,7 +83,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         toGetLyricConfig(_config, config);
 
         int seq = oInternalOriginBridge->copyrightedMusicGetLrcLyric(_config);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getLrcLyricCallbacks.insert({seq, callback});
         }
@@ -94,7 +94,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         const char *_krcToken = krcToken.empty() ? nullptr : krcToken.c_str();
 
         int seq = oInternalOriginBridge->copyrightedMusicGetKrcLyricByToken(_krcToken);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getKrcLyricByTokenCallbacks.insert({seq, callback});
         }
@@ -106,7 +106,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         toRequestConfig(_config, config);
 
         int seq = oInternalOriginBridge->copyrightedMusicRequestSong(_config);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             requestSongCallbacks.insert({seq, callback});
         }
@@ -118,7 +118,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         toRequestConfig(_config, config);
 
         int seq = oInternalOriginBridge->copyrightedMusicRequestAccompaniment(_config);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             requestAccompanimentCallbacks.insert({seq, callback});
         }
@@ -131,7 +131,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         toRequestConfig(_config, config);
 
         int seq = oInternalOriginBridge->copyrightedMusicRequestAccompanimentClip(_config);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             requestAccompanimentClipCallbacks.insert({seq, callback});
         }
@@ -142,7 +142,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         const char *_songToken = songToken.empty() ? nullptr : songToken.c_str();
 
         int seq = oInternalOriginBridge->copyrightedMusicGetMusicByToken(_songToken);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getMusicByTokenCallbacks.insert({seq, callback});
         }
@@ -158,7 +158,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         _type = (zego_copyrighted_music_resource_type)type;
 
         int seq = oInternalOriginBridge->copyrightedMusicRequestResource(_config, _type);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             requestResourceCallbacks.insert({seq, callback});
         }
@@ -171,7 +171,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         toRequestConfigV2(_config, config);
 
         int seq = oInternalOriginBridge->copyrightedMusicRequestResource(_config);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             requestResourceCallbacks.insert({seq, callback});
         }
@@ -187,7 +187,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         _type = (zego_copyrighted_music_resource_type)type;
 
         int seq = oInternalOriginBridge->copyrightedMusicGetSharedResource(_config, _type);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getSharedResourceCallbacks.insert({seq, callback});
         }
@@ -200,7 +200,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         toGetSharedConfigV2(_config, config);
 
         int seq = oInternalOriginBridge->copyrightedMusicGetSharedResource(_config);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getSharedResourceCallbacks.insert({seq, callback});
         }
@@ -211,7 +211,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         const char *_resourceID = resourceID.empty() ? nullptr : resourceID.c_str();
 
         int seq = oInternalOriginBridge->copyrightedMusicDownload(_resourceID);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             loadCallbacks.insert({seq, callback});
         }
@@ -344,7 +344,7 @@ class ZegoExpressCopyrightedMusicImp : public IZegoCopyrightedMusic {
         const char *_resourceID = resourceID.empty() ? nullptr : resourceID.c_str();
 
         int seq = oInternalOriginBridge->copyrightedMusicGetStandardPitch(_resourceID);
-        if (callback) {
+        if (callback && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(copyrightedMusicEventMutex);
             getStandardPitchCallbacks.insert({seq, callback});
         }
@@ -35,52 +35,30 @@
 #define ZEGO_SWITCH_THREAD_PRE ZEGO_SWITCH_THREAD_PRE_STATIC
 #define ZEGO_SWITCH_THREAD_ING }
 #else
-#if defined(_WIN32)
+#if TARGET_OS_IPHONE || TARGET_OS_OSX
+#import <Foundation/Foundation.h>
+#endif
+// Callbacks are queued on ZegoExpressCallbackDispatcher (ZegoInternalDispatcher.hpp), which
+// decides per platform which thread runs them. Each call site registers itself once with
+// ZegoCallbackProfiler under the name of the enclosing zego_on_* function.
+#define ZEGO_CALLBACK_SITE                                                                         \
+    static ZegoCallbackSite *zegoCallbackSite = oInternalCallbackProfiler->site(__func__);
 #define ZEGO_SWITCH_THREAD_PRE_STATIC                                                              \
-    std::function<void(void)> *pFunc = new std::function<void(void)>;                              \
-    *pFunc = [=](void) {
+    {                                                                                              \
+        ZEGO_CALLBACK_SITE                                                                         \
+        oInternalCallbackDispatcher->post(zegoCallbackSite, [=](void) {
 #if defined(_MSVC_LANG) && _MSVC_LANG >= 202002L
 #define ZEGO_SWITCH_THREAD_PRE                                                                     \
-    std::function<void(void)> *pFunc = new std::function<void(void)>;                              \
-    *pFunc = [=, this](void) {                                                                     \
-    (void)(this);
+    {                                                                                              \
+        ZEGO_CALLBACK_SITE                                                                         \
+        oInternalCallbackDispatcher->post(zegoCallbackSite, [=, this](void) {                      \
+        (void)(this);
 #else
 #define ZEGO_SWITCH_THREAD_PRE ZEGO_SWITCH_THREAD_PRE_STATIC
 #endif
 #define ZEGO_SWITCH_THREAD_ING                                                                     \
-    }                                                                                              \
-    ;                                                                                              \
-    if (oInternalOriginBridge->isCallbackSwitchToMainThread()) {                                   \
-        oInternalOriginBridge->postWindowsMessage(pFunc);                                          \
-    } else {                                                                                       \
-        oInternalOriginBridge->postZegoCallbackTask(pFunc);                                        \
-    }
-#elif TARGET_OS_IPHONE
-#import <Foundation/Foundation.h>
-#define ZEGO_SWITCH_THREAD_PRE_STATIC dispatch_async(dispatch_get_main_queue(), ^{
-#define ZEGO_SWITCH_THREAD_PRE ZEGO_SWITCH_THREAD_PRE_STATIC
-#define ZEGO_SWITCH_THREAD_ING                                                                     \
-    });
-#elif TARGET_OS_OSX
-#import <Foundation/Foundation.h>
-#include <functional>
-#define ZEGO_SWITCH_THREAD_PRE_STATIC auto task = [=]() {
-#define ZEGO_SWITCH_THREAD_PRE ZEGO_SWITCH_THREAD_PRE_STATIC
-#define ZEGO_SWITCH_THREAD_ING                                                                     \
-    }                                                                                              \
-    ;                                                                                              \
-    if (oInternalOriginBridge->isCallbackSwitchToMainThread()) {                                   \
-        dispatch_async(dispatch_get_main_queue(), ^{                                               \
-          task();                                                                                  \
-        });                                                                                        \
-    } else {                                                                                       \
-        oInternalOriginBridge->postZegoCallbackTask(new std::function<void(void)>(task));          \
+    });                                                                                            \
     }
-#else
-#define ZEGO_SWITCH_THREAD_PRE_STATIC {
-#define ZEGO_SWITCH_THREAD_PRE ZEGO_SWITCH_THREAD_PRE_STATIC
-#define ZEGO_SWITCH_THREAD_ING }
-#endif
 #endif
 
 #ifdef __GNUC__
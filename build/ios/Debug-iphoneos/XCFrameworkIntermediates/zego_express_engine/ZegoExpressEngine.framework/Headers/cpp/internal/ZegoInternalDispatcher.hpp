@@ -0,0 +1,495 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "../ZegoExpressDefines.h"
+#include "ZegoInternalBridge.h"
+#include "ZegoInternalProfiler.hpp"
+
+#if TARGET_OS_IPHONE || TARGET_OS_OSX
+#include <dispatch/dispatch.h>
+#endif
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Captures of the largest closures posted on a hot path: the publisher and player quality updates
+// that arrive for every stream every few seconds. kInlineSize is derived from them so these stay
+// in the pooled node.
+struct ZegoPublisherQualityCaptures {
+    std::weak_ptr<void> handler;
+    std::string streamID;
+    ZegoPublishStreamQuality quality;
+};
+
+struct ZegoPlayerQualityCaptures {
+    std::weak_ptr<void> handler;
+    std::string streamID;
+    ZegoPlayStreamQuality quality;
+};
+
+// A callback closure stored in a pooled node. Closures up to kInlineSize bytes live inside the
+// node, larger ones are moved to the heap.
+class ZegoCallbackTask {
+  public:
+    static const size_t kMinInlineSize = 192;
+    static const size_t kHotClosureSize =
+        sizeof(ZegoPlayerQualityCaptures) > sizeof(ZegoPublisherQualityCaptures)
+            ? sizeof(ZegoPlayerQualityCaptures)
+            : sizeof(ZegoPublisherQualityCaptures);
+    // Rounded up to a cache line, the compiler is free to order and pad lambda captures
+    static const size_t kInlineSize =
+        ((kHotClosureSize > kMinInlineSize ? kHotClosureSize : kMinInlineSize) + 63) & ~size_t(63);
+    static const unsigned int kHeapIndex = 0xFFFFFFFFu;
+
+    template <typename F> void bind(F &&func) {
+        typedef typename std::decay<F>::type Func;
+        typedef std::integral_constant<bool, sizeof(Func) <= kInlineSize &&
+                                                 alignof(Func) <= alignof(std::max_align_t)>
+            FitsInline;
+        bindImpl<Func>(std::forward<F>(func), FitsInline());
+    }
+
+    void run() { invoke(target); }
+
+    void reset() {
+        if (target) {
+            destroy(target);
+            target = nullptr;
+        }
+    }
+
+    std::atomic<ZegoCallbackTask *> next{nullptr};
+    ZegoCallbackSite *site = nullptr;
+    // Profiler timestamp of the post, -1 when the profiler was off
+    int64_t postedNs = -1;
+    unsigned int poolIndex = kHeapIndex;
+    bool inlineStorage = false;
+
+  private:
+    template <typename Func, typename F> void bindImpl(F &&func, std::true_type) {
+        target = new (storage) Func(std::forward<F>(func));
+        inlineStorage = true;
+        invoke = [](void *p) { (*static_cast<Func *>(p))(); };
+        destroy = [](void *p) { static_cast<Func *>(p)->~Func(); };
+    }
+
+    template <typename Func, typename F> void bindImpl(F &&func, std::false_type) {
+        target = new Func(std::forward<F>(func));
+        inlineStorage = false;
+        invoke = [](void *p) { (*static_cast<Func *>(p))(); };
+        destroy = [](void *p) { delete static_cast<Func *>(p); };
+    }
+
+    void *target = nullptr;
+    void (*invoke)(void *) = nullptr;
+    void (*destroy)(void *) = nullptr;
+    alignas(std::max_align_t) unsigned char storage[kInlineSize];
+};
+
+static_assert(sizeof(ZegoPlayerQualityCaptures) <= ZegoCallbackTask::kInlineSize &&
+                  sizeof(ZegoPublisherQualityCaptures) <= ZegoCallbackTask::kInlineSize,
+              "quality update closures must fit in ZegoCallbackTask inline storage");
+
+// Moves event callbacks from the SDK internal threads to the callback thread.
+//
+// Producers (any SDK thread) take a task from a preallocated pool and push it onto an intrusive
+// lock-free MPSC queue. Only the transition from idle to pending wakes the consumer, which then
+// drains every queued task in one go. The consumer is the UI thread (Windows message / main
+// dispatch queue), the SDK callback thread, or on platforms without either a dedicated thread.
+class ZegoExpressCallbackDispatcher {
+  public:
+    static ZegoExpressCallbackDispatcher *GetInstance() {
+        static ZegoExpressCallbackDispatcher oInstance;
+        return &oInstance;
+    }
+
+    void setConfig(const ZegoCallbackDispatcherConfig &config) {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (!pool_) {
+            config_.taskPoolSize = config.taskPoolSize;
+        }
+        config_.maxQueueDepth = config.maxQueueDepth > 0 ? config.maxQueueDepth : 1;
+        config_.maxBatchSize = config.maxBatchSize > 0 ? config.maxBatchSize : 1;
+        config_.overflowPolicy = config.overflowPolicy;
+        max_queue_depth_.store(config_.maxQueueDepth, std::memory_order_relaxed);
+        max_batch_size_.store(config_.maxBatchSize, std::memory_order_relaxed);
+        overflow_policy_.store(config_.overflowPolicy, std::memory_order_relaxed);
+        // A larger queue or the drop policy may let waiting posts through
+        std::lock_guard<std::mutex> roomLock(room_mutex_);
+        room_cv_.notify_all();
+    }
+
+    ZegoCallbackDispatcherStats getStats() {
+        ZegoCallbackDispatcherStats stats;
+        stats.postedCount = posted_count_.load(std::memory_order_relaxed);
+        stats.executedCount = executed_count_.load(std::memory_order_relaxed);
+        stats.blockedCount = blocked_count_.load(std::memory_order_relaxed);
+        stats.droppedCount = dropped_count_.load(std::memory_order_relaxed);
+        stats.poolMissCount = pool_miss_count_.load(std::memory_order_relaxed);
+        stats.wakeupCount = wakeup_count_.load(std::memory_order_relaxed);
+        stats.queueDepth = depth_.load(std::memory_order_relaxed);
+        stats.maxQueueDepth = depth_high_water_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    template <typename F> void post(ZegoCallbackSite *site, F &&func) {
+        posted_count_.fetch_add(1, std::memory_order_relaxed);
+        bool profiled = oInternalCallbackProfiler->active();
+
+        unsigned int depth = depth_.fetch_add(1) + 1;
+        bool waited = false;
+        // The callback thread never waits for itself, its posts go past the limit in order
+        while (depth > max_queue_depth_.load(std::memory_order_relaxed) &&
+               !onConsumerThread()) {
+            depth_.fetch_sub(1);
+            if (overflow_policy_.load(std::memory_order_relaxed) ==
+                ZEGO_CALLBACK_OVERFLOW_POLICY_DROP_NEWEST) {
+                dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (!waited) {
+                blocked_count_.fetch_add(1, std::memory_order_relaxed);
+                waited = true;
+            }
+            waitForRoom();
+            depth = depth_.fetch_add(1) + 1;
+        }
+        updateHighWater(depth);
+
+        ZegoCallbackTask *task = acquireTask();
+        task->bind(std::forward<F>(func));
+        task->site = site;
+        task->postedNs = profiled ? ZegoCallbackProfiler::now() : -1;
+        if (task->poolIndex == ZegoCallbackTask::kHeapIndex || !task->inlineStorage) {
+            pool_miss_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        enqueue(task);
+
+        if (!scheduled_.exchange(true)) {
+            wakeup();
+        }
+    }
+
+    // The token posted through the bridge instead of a per-event std::function.
+    void *drainToken() { return &drain_task_; }
+
+    bool isDrainToken(void *message) { return message == &drain_task_; }
+
+    // Runs queued callbacks on the consumer thread.
+    void drain(bool execute = true) {
+        ZegoConsumerScope consumer(this);
+        unsigned int batch = 0;
+        unsigned int maxBatch = (execute && hostDriven())
+                                    ? max_batch_size_.load(std::memory_order_relaxed)
+                                    : 0xFFFFFFFFu;
+        while (true) {
+            ZegoCallbackTask *task = dequeue();
+            if (task) {
+                if (execute) {
+                    run(task);
+                    executed_count_.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                }
+                releaseTask(task);
+                depth_.fetch_sub(1);
+                if (room_waiters_.load() > 0) {
+                    std::lock_guard<std::mutex> lock(room_mutex_);
+                    room_cv_.notify_all();
+                }
+                if (++batch >= maxBatch) {
+                    // Yield back to the host message loop, the pending flag stays set
+                    wakeup();
+                    return;
+                }
+                continue;
+            }
+            if (depth_.load() > 0) {
+                // A producer is between the exchange and the link store
+                std::this_thread::yield();
+                continue;
+            }
+            scheduled_.store(false);
+            if (depth_.load() == 0 || scheduled_.exchange(true)) {
+                return;
+            }
+        }
+    }
+
+  private:
+    ZegoExpressCallbackDispatcher() {
+        head_.store(&stub_, std::memory_order_relaxed);
+        tail_ = &stub_;
+        drain_task_ = [this]() { drain(); };
+    }
+
+    ~ZegoExpressCallbackDispatcher() {
+        stopWorker();
+        drain(false);
+        delete[] pool_;
+        delete[] free_next_;
+    }
+
+    ZegoExpressCallbackDispatcher(const ZegoExpressCallbackDispatcher &) = delete;
+    ZegoExpressCallbackDispatcher &operator=(const ZegoExpressCallbackDispatcher &) = delete;
+
+    void run(ZegoCallbackTask *task) {
+        if (task->postedNs < 0) {
+            task->run();
+            return;
+        }
+        int64_t start = ZegoCallbackProfiler::now();
+        task->run();
+        oInternalCallbackProfiler->onCallback(task->site, task->postedNs, start,
+                                              ZegoCallbackProfiler::now());
+    }
+
+    // Marks the calling thread as the consumer while it drains, so its own posts do not wait
+    class ZegoConsumerScope {
+      public:
+        explicit ZegoConsumerScope(ZegoExpressCallbackDispatcher *dispatcher)
+            : dispatcher_(dispatcher),
+              previous_(dispatcher->consumer_thread_.exchange(std::this_thread::get_id())) {}
+        ~ZegoConsumerScope() { dispatcher_->consumer_thread_.store(previous_); }
+
+      private:
+        ZegoExpressCallbackDispatcher *dispatcher_;
+        std::thread::id previous_;
+    };
+
+    bool onConsumerThread() {
+        return consumer_thread_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+    // The waiter count is published before the depth is rechecked under room_mutex_, and drain
+    // decrements the depth before it reads the count, so one of the two always sees the other.
+    void waitForRoom() {
+        std::unique_lock<std::mutex> lock(room_mutex_);
+        room_waiters_.fetch_add(1);
+        room_cv_.wait(lock, [this]() {
+            return depth_.load() < max_queue_depth_.load(std::memory_order_relaxed) ||
+                   overflow_policy_.load(std::memory_order_relaxed) ==
+                       ZEGO_CALLBACK_OVERFLOW_POLICY_DROP_NEWEST;
+        });
+        room_waiters_.fetch_sub(1);
+    }
+
+    void updateHighWater(unsigned int depth) {
+        unsigned int high = depth_high_water_.load(std::memory_order_relaxed);
+        while (depth > high &&
+               !depth_high_water_.compare_exchange_weak(high, depth, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Task pool: a Treiber stack of node indices, tagged against ABA.
+    void ensurePool() {
+        if (pool_ready_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (pool_) {
+            return;
+        }
+        unsigned int size = config_.taskPoolSize;
+        if (size > 0) {
+            pool_ = new ZegoCallbackTask[size];
+            free_next_ = new std::atomic<uint32_t>[size];
+            for (unsigned int i = 0; i < size; i++) {
+                pool_[i].poolIndex = i;
+                free_next_[i].store(i + 1 < size ? i + 2 : 0, std::memory_order_relaxed);
+            }
+            free_head_.store(1, std::memory_order_relaxed);
+        }
+        pool_ready_.store(true, std::memory_order_release);
+    }
+
+    ZegoCallbackTask *acquireTask() {
+        ensurePool();
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == 0) {
+                return new ZegoCallbackTask();
+            }
+            uint64_t next = free_next_[index - 1].load(std::memory_order_relaxed);
+            uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+            if (free_head_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+                return &pool_[index - 1];
+            }
+        }
+    }
+
+    void releaseTask(ZegoCallbackTask *task) {
+        task->reset();
+        if (task->poolIndex == ZegoCallbackTask::kHeapIndex) {
+            delete task;
+            return;
+        }
+        uint32_t index = task->poolIndex + 1;
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        while (true) {
+            free_next_[index - 1].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            uint64_t newHead = (((head >> 32) + 1) << 32) | index;
+            if (free_head_.compare_exchange_weak(head, newHead, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    // Intrusive MPSC queue (Vyukov). enqueue is wait-free, dequeue is consumer-only.
+    void enqueue(ZegoCallbackTask *task) {
+        task->next.store(nullptr, std::memory_order_relaxed);
+        ZegoCallbackTask *prev = head_.exchange(task, std::memory_order_acq_rel);
+        prev->next.store(task, std::memory_order_release);
+    }
+
+    ZegoCallbackTask *dequeue() {
+        ZegoCallbackTask *tail = tail_;
+        ZegoCallbackTask *next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        enqueue(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    bool hostDriven() {
+#if defined(_WIN32) || TARGET_OS_IPHONE || TARGET_OS_OSX
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void wakeup() {
+        wakeup_count_.fetch_add(1, std::memory_order_relaxed);
+#if defined(_WIN32)
+        if (oInternalOriginBridge->isCallbackSwitchToMainThread()) {
+            oInternalOriginBridge->postWindowsMessage(drainToken());
+        } else {
+            oInternalOriginBridge->postZegoCallbackTask(drainToken());
+        }
+#elif TARGET_OS_IPHONE
+        dispatch_async_f(dispatch_get_main_queue(), this, &ZegoExpressCallbackDispatcher::onDrain);
+#elif TARGET_OS_OSX
+        if (oInternalOriginBridge->isCallbackSwitchToMainThread()) {
+            dispatch_async_f(dispatch_get_main_queue(), this,
+                             &ZegoExpressCallbackDispatcher::onDrain);
+        } else {
+            oInternalOriginBridge->postZegoCallbackTask(drainToken());
+        }
+#else
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        if (!worker_.joinable()) {
+            worker_stop_ = false;
+            worker_ = std::thread([this]() { workerLoop(); });
+        }
+        worker_signaled_ = true;
+        worker_cv_.notify_one();
+#endif
+    }
+
+    static void onDrain(void *context) {
+        static_cast<ZegoExpressCallbackDispatcher *>(context)->drain();
+    }
+
+    void workerLoop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(worker_mutex_);
+                worker_cv_.wait(lock, [this]() { return worker_signaled_ || worker_stop_; });
+                if (worker_stop_) {
+                    return;
+                }
+                worker_signaled_ = false;
+            }
+            drain();
+        }
+    }
+
+    void stopWorker() {
+        {
+            std::lock_guard<std::mutex> lock(worker_mutex_);
+            worker_stop_ = true;
+            worker_cv_.notify_one();
+        }
+        if (worker_.joinable() && worker_.get_id() != std::this_thread::get_id()) {
+            worker_.join();
+        } else if (worker_.joinable()) {
+            worker_.detach();
+        }
+    }
+
+  private:
+    ZegoCallbackDispatcherConfig config_;
+    std::atomic<unsigned int> max_queue_depth_{4096};
+    std::atomic<unsigned int> max_batch_size_{64};
+    std::atomic<int> overflow_policy_{ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK};
+
+    std::mutex pool_mutex_;
+    std::atomic<bool> pool_ready_{false};
+    ZegoCallbackTask *pool_ = nullptr;
+    std::atomic<uint32_t> *free_next_ = nullptr;
+    std::atomic<uint64_t> free_head_{0};
+
+    ZegoCallbackTask stub_;
+    std::atomic<ZegoCallbackTask *> head_{nullptr};
+    ZegoCallbackTask *tail_ = nullptr;
+
+    std::atomic<unsigned int> depth_{0};
+    std::atomic<bool> scheduled_{false};
+    std::atomic<std::thread::id> consumer_thread_{};
+
+    std::mutex room_mutex_;
+    std::condition_variable room_cv_;
+    std::atomic<unsigned int> room_waiters_{0};
+    std::function<void(void)> drain_task_;
+
+    std::mutex worker_mutex_;
+    std::condition_variable worker_cv_;
+    std::thread worker_;
+    bool worker_signaled_ = false;
+    bool worker_stop_ = false;
+
+    std::atomic<unsigned long long> posted_count_{0};
+    std::atomic<unsigned long long> executed_count_{0};
+    std::atomic<unsigned long long> blocked_count_{0};
+    std::atomic<unsigned long long> dropped_count_{0};
+    std::atomic<unsigned long long> pool_miss_count_{0};
+    std::atomic<unsigned long long> wakeup_count_{0};
+    std::atomic<unsigned int> depth_high_water_{0};
+};
+#define oInternalCallbackDispatcher ZegoExpressCallbackDispatcher::GetInstance()
+
+} // namespace EXPRESS
+} // namespace ZEGO
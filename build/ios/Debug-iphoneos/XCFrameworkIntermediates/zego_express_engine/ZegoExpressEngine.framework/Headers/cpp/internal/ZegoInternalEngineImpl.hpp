@@ -38,7 +38,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
 
     void uploadLog(ZegoUploadLogResultCallback callback) override {
         int seq = oInternalOriginBridge->uploadLog();
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoUploadLogResultCallback(seq, callback);
         }
     }
@@ -78,7 +78,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         zego_room_config _config = ZegoExpressConvert::O2IRoomConfig(config);
 
         int seq = oInternalOriginBridge->loginRoomWithCallback(_roomId, _user, &_config);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoRoomLoginCallback(seq, callback);
         }
     }
@@ -86,7 +86,9 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
     void logoutRoom(ZegoRoomLogoutCallback callback) override {
         if (callback != nullptr) {
             int seq = oInternalOriginBridge->logoutRoomWithCallback();
-            oInternalCallbackCenter->insertZegoRoomLogoutCallback(seq, callback);
+            if (!ZegoMissingSeq::fail(seq, callback)) {
+                oInternalCallbackCenter->insertZegoRoomLogoutCallback(seq, callback);
+            }
         } else {
             oInternalOriginBridge->logoutRoom();
         }
@@ -95,7 +97,9 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
     void logoutRoom(const std::string &roomID, ZegoRoomLogoutCallback callback) override {
         if (callback != nullptr) {
             int seq = oInternalOriginBridge->logoutRoomWithCallback(roomID.c_str());
-            oInternalCallbackCenter->insertZegoRoomLogoutCallback(seq, callback);
+            if (!ZegoMissingSeq::fail(seq, callback)) {
+                oInternalCallbackCenter->insertZegoRoomLogoutCallback(seq, callback);
+            }
         } else {
             const char *_roomId = roomID.c_str();
             oInternalOriginBridge->logoutRoom(_roomId);
@@ -123,7 +127,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
                           ZegoRoomSetRoomExtraInfoCallback callback) override {
         int seq =
             oInternalOriginBridge->setRoomExtraInfo(roomID.c_str(), key.c_str(), value.c_str());
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoRoomSetRoomExtraInfoCallback(seq, callback);
         }
     }
@@ -173,7 +177,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         const char *_extraInfo = extraInfo.c_str();
         int seq =
             oInternalOriginBridge->setStreamExtraInfo(_extraInfo, zego_publish_channel(channel));
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoPublisherSetStreamExtraInfoCallback(seq, callback);
         }
     }
@@ -392,7 +396,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         const char *target_url = targetURL.c_str();
 
         int seq = oInternalOriginBridge->addPublishCdnUrl(stream_id, target_url, timeout);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoPublisherUpdateCdnUrlCallback(seq, callback);
         }
     }
@@ -403,7 +407,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         const char *target_url = targetURL.c_str();
 
         int seq = oInternalOriginBridge->removePublishCdnUrl(stream_id, target_url);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoPublisherUpdateCdnUrlCallback(seq, callback);
         }
     }
@@ -1183,7 +1187,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         const char *_message = message.c_str();
 
         int seq = oInternalOriginBridge->sendBroadcastMessage(_roomID, _message);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoIMSendBroadcastMessageCallback(seq, callback);
         }
     }
@@ -1194,7 +1198,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         const char *_message = message.c_str();
 
         int seq = oInternalOriginBridge->sendBarrageMessage(_roomID, _message);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoIMSendBarrageMessageCallback(seq, callback);
         }
     }
@@ -1213,7 +1217,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
 
         int seq = oInternalOriginBridge->sendCustomCommand(_roomID, _command, users,
                                                            ZegoUInt(_userList.size()));
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoIMSendCustomCommandCallback(seq, callback);
         }
     }
@@ -1239,7 +1243,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         message_.recv_user_list_count = ZegoUInt(_userList.size());
 
         int seq = oInternalOriginBridge->sendTransparentMessage(roomID.c_str(), &message_);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoRoomSendTransparentMessageCallback(seq, callback);
         }
     }
@@ -1353,12 +1357,12 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
 
         if (isStart) {
             int seq = oInternalOriginBridge->startMixerTask(_task);
-            if (startCallback != nullptr) {
+            if (startCallback != nullptr && !ZegoMissingSeq::fail(seq, startCallback)) {
                 oInternalCallbackCenter->insertZegoMixerStartCallback(seq, startCallback);
             }
         } else {
             int seq = oInternalOriginBridge->stopMixerTask(_task);
-            if (stopCallback != nullptr) {
+            if (stopCallback != nullptr && !ZegoMissingSeq::fail(seq, stopCallback)) {
                 oInternalCallbackCenter->insertZegoMixerStopCallback(seq, stopCallback);
             }
         }
@@ -1400,12 +1404,12 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
 
         if (isStart) {
             int seq = oInternalOriginBridge->startAutoMixerTask(_task);
-            if (startCallback != nullptr) {
+            if (startCallback != nullptr && !ZegoMissingSeq::fail(seq, startCallback)) {
                 oInternalCallbackCenter->insertZegoMixerStartCallback(seq, startCallback);
             }
         } else {
             int seq = oInternalOriginBridge->stopAutoMixerTask(_task);
-            if (stopCallback != nullptr) {
+            if (stopCallback != nullptr && !ZegoMissingSeq::fail(seq, stopCallback)) {
                 oInternalCallbackCenter->insertZegoMixerStopCallback(seq, stopCallback);
             }
         }
@@ -1941,7 +1945,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         zego_network_probe_config _config;
         _config.enable_traceroute = config.enableTraceroute;
         int seq = oInternalOriginBridge->startNetworkProbe(_config);
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             oInternalCallbackCenter->insertZegoNetworkProbeResultCallback(seq, callback);
         }
     }
@@ -2176,6 +2180,13 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         return oInternalOriginBridge->loadLibrary(sdk_library_full_path);
     }
 
+    static int loadLibrary(const std::string &sdk_library_full_path,
+                           const ZegoLoadLibraryConfig &config) {
+        return oInternalOriginBridge->loadLibrary(
+            sdk_library_full_path, config.bindingMode == ZEGO_LIBRARY_BINDING_MODE_LAZY,
+            config.preloadCoreSymbols);
+    }
+
     static void unLoadLibrary() { oInternalOriginBridge->unLoadLibrary(); }
 
     // static void setAdaptiveVideoConfig(const ZegoAdaptiveVideoConfig &config) {
@@ -2231,6 +2242,7 @@ class ZegoExpressEngineImp : public IZegoExpressEngine {
         oInternalCallbackCenter->unregisterCallback();
         oInternalCallbackCenter->clearHandlerData();
         oInternalCallbackCenter->clearContainerData();
+        oInternalSoundLevelTable->reset();
         oInternalOriginBridge->uninitAsync();
         oInternalCallbackCenter->unRegisterApiCalledResultCallback();
     }
@@ -2268,9 +2280,14 @@ class ZegoExpressSDKInternal {
                                             std::shared_ptr<IZegoEventHandler> eventHandler) {
         std::lock_guard<std::recursive_mutex> locker(oEngineContainer->engineMutex);
         if (oEngineContainer->engineInstance == nullptr) {
+            auto begin = std::chrono::steady_clock::now();
             auto newEngineInstance = std::make_shared<ZegoExpressEngineImp>();
             if (newEngineInstance->init(profile, eventHandler)) {
                 oEngineContainer->engineInstance = newEngineInstance;
+                oInternalOriginBridge->setCreateEngineTime(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count());
             }
         }
         return oEngineContainer->engineInstance.get();
@@ -2281,10 +2298,15 @@ class ZegoExpressSDKInternal {
                                             std::shared_ptr<IZegoEventHandler> eventHandler) {
         std::lock_guard<std::recursive_mutex> locker(oEngineContainer->engineMutex);
         if (oEngineContainer->engineInstance == nullptr) {
+            auto begin = std::chrono::steady_clock::now();
             auto newEngineInstance = std::make_shared<ZegoExpressEngineImp>();
             if (newEngineInstance->init(appID, appSign, isTestEnvironment, scenario,
                                         eventHandler)) {
                 oEngineContainer->engineInstance = newEngineInstance;
+                oInternalOriginBridge->setCreateEngineTime(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count());
             }
         }
         return oEngineContainer->engineInstance.get();
@@ -2319,6 +2341,69 @@ class ZegoExpressSDKInternal {
         ZegoExpressEngineImp::setApiCalledCallback(callback);
     }
 
+    static void setCallbackDispatcherConfig(const ZegoCallbackDispatcherConfig &config) {
+        oInternalCallbackDispatcher->setConfig(config);
+    }
+
+    static ZegoCallbackDispatcherStats getCallbackDispatcherStats() {
+        return oInternalCallbackDispatcher->getStats();
+    }
+
+    static void setCallbackProfilerConfig(const ZegoCallbackProfilerConfig &config) {
+        oInternalCallbackProfiler->setConfig(config);
+    }
+
+    static std::vector<ZegoCallbackLatencyStats> getCallbackLatencyStats() {
+        return oInternalCallbackProfiler->getStats();
+    }
+
+    static void resetCallbackLatencyStats() { oInternalCallbackProfiler->reset(); }
+
+    static void addCallbackTraceEvent(const char *category, const char *name, long long beginNs,
+                                      long long durationNs, long long queueNs) {
+        oInternalCallbackProfiler->addTraceEvent(category, name, beginNs, durationNs, queueNs);
+    }
+
+    static void enableExtendedPerformanceStatus(bool enable) {
+        oInternalPerformanceSampler->enable(enable);
+    }
+
+    static void setQueueDepthProvider(ZegoPerformanceQueue queue,
+                                      ZegoQueueDepthProvider provider) {
+        oInternalPerformanceSampler->setQueueDepthProvider(queue, provider);
+    }
+
+    static void setQualityMetricsStoreConfig(const ZegoQualityMetricsStoreConfig &config) {
+        oInternalQualityMetricsStore->setConfig(config);
+    }
+
+    static unsigned int queryQualityMetrics(const std::string &id, ZegoQualityMetric metric,
+                                            ZegoQualityMetricsResolution resolution,
+                                            long long beginTime, long long endTime,
+                                            ZegoQualityMetricsPoint *points,
+                                            unsigned int maxPoints) {
+        return oInternalQualityMetricsStore->query(id.c_str(), metric, resolution, beginTime,
+                                                   endTime, points, maxPoints);
+    }
+
+    static std::vector<unsigned char> exportQualityMetrics() {
+        return oInternalQualityMetricsStore->exportBlob();
+    }
+
+    static void enableSoundLevelTable(bool enable) { oInternalSoundLevelTable->enable(enable); }
+
+    static ZegoStreamHandle getStreamHandle(const std::string &streamID) {
+        return oInternalSoundLevelTable->find(streamID.c_str());
+    }
+
+    static std::string getStreamIDByHandle(ZegoStreamHandle handle) {
+        return oInternalSoundLevelTable->streamID(handle);
+    }
+
+    static void readSoundLevelSnapshot(ZegoSoundLevelSnapshot &snapshot) {
+        oInternalSoundLevelTable->read(snapshot);
+    }
+
     static void setLocalProxyConfig(const std::vector<ZegoProxyInfo> &proxyList, bool enable) {
         std::lock_guard<std::recursive_mutex> locker(oEngineContainer->engineMutex);
         ZegoExpressEngineImp::setLocalProxyConfig(proxyList, enable);
@@ -2344,6 +2429,15 @@ class ZegoExpressSDKInternal {
         return ZegoExpressEngineImp::loadLibrary(sdk_library_full_path);
     }
 
+    static int loadLibrary(const std::string &sdk_library_full_path,
+                           const ZegoLoadLibraryConfig &config) {
+        return ZegoExpressEngineImp::loadLibrary(sdk_library_full_path, config);
+    }
+
+    static ZegoLibraryLoadReport getLibraryLoadReport() {
+        return oInternalOriginBridge->getLibraryLoadReport();
+    }
+
     static void unLoadLibrary() { ZegoExpressEngineImp::unLoadLibrary(); }
 
     // static void setAdaptiveVideoConfig(const ZegoAdaptiveVideoConfig &config) {
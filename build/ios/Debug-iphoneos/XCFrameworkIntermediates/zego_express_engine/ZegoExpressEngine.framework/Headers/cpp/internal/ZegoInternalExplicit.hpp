@@ -2,6 +2,10 @@
 #ifndef __ZEGOEXPRESSEXPLICIT_HPP__
 #define __ZEGOEXPRESSEXPLICIT_HPP__
 
+// Seq handed out for a call whose function the loaded library does not export. The SDK hands out
+// no negative seqs, so no completion ever arrives for it and the caller fails the call at once.
+#define ZEGOEXP_MISSING_SEQ (-1)
+
 #ifdef ZEGOEXP_EXPLICIT
 
 #ifdef _WIN32
@@ -10,7 +14,142 @@
 #include <dlfcn.h>
 #endif
 
-#define ZEGOEXP_DECLARE_FUNC_PTR(type, ptr) type ptr = nullptr;
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ZEGO {
+namespace EXPRESS {
+
+class ZegoExplicitSymbolBase;
+
+// Shared state of every symbol of the loaded library, owned by the bridge.
+struct ZegoExplicitRegistry {
+    explicit ZegoExplicitRegistry(void *const *libraryHandle) : handle(libraryHandle) {}
+
+    static unsigned long long nowUs() {
+        return static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    void *const *handle;
+    ZegoExplicitSymbolBase *head = nullptr;
+    std::atomic<unsigned long long> loadLibraryTimeUs{0};
+    std::atomic<unsigned long long> resolveSymbolsTimeUs{0};
+    std::atomic<unsigned long long> lazyResolveTimeUs{0};
+};
+
+// One exported function of the SDK library. The address is looked up on first use unless it
+// was resolved eagerly by loadLibraryInternal; concurrent first calls may both look it up, which
+// is harmless since they store the same address. A failed lookup is remembered until the library
+// is unloaded, so calls to a missing function do not repeat it.
+class ZegoExplicitSymbolBase {
+  public:
+    ZegoExplicitSymbolBase(const char *symbolName, ZegoExplicitRegistry *symbolRegistry)
+        : name(symbolName), registry(symbolRegistry), next(symbolRegistry->head) {
+        symbolRegistry->head = this;
+    }
+
+    void *resolve() {
+        void *address = address_.load(std::memory_order_acquire);
+        if (address != nullptr || missing_.load(std::memory_order_relaxed) ||
+            *registry->handle == nullptr) {
+            return address;
+        }
+#ifdef _WIN32
+        address = (void *)::GetProcAddress((HMODULE)*registry->handle, name);
+#else
+        address = dlsym(*registry->handle, name);
+#endif
+        missing_.store(address == nullptr, std::memory_order_relaxed);
+        address_.store(address, std::memory_order_release);
+        return address;
+    }
+
+    bool resolved() const { return address_.load(std::memory_order_relaxed) != nullptr; }
+
+    bool missing() const { return missing_.load(std::memory_order_relaxed); }
+
+    void reset() {
+        address_.store(nullptr, std::memory_order_relaxed);
+        missing_.store(false, std::memory_order_relaxed);
+    }
+
+    const char *const name;
+    ZegoExplicitRegistry *const registry;
+    ZegoExplicitSymbolBase *const next;
+
+  protected:
+    void *cached() const { return address_.load(std::memory_order_acquire); }
+
+    void *lazyResolve() {
+        unsigned long long begin = ZegoExplicitRegistry::nowUs();
+        void *address = resolve();
+        registry->lazyResolveTimeUs.fetch_add(ZegoExplicitRegistry::nowUs() - begin,
+                                              std::memory_order_relaxed);
+        return address;
+    }
+
+  private:
+    std::atomic<void *> address_{nullptr};
+    std::atomic<bool> missing_{false};
+};
+
+// Value returned by a call to a symbol the loaded library does not export.
+template <typename R> struct ZegoExplicitMissingResult {
+    static R value() { return R(); }
+};
+
+template <> struct ZegoExplicitMissingResult<int> {
+    static int value() { return ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND; }
+};
+
+template <> struct ZegoExplicitMissingResult<void> {
+    static void value() {}
+};
+
+// zego_seq is an int as well, so a function returning a seq gets ZEGOEXP_MISSING_SEQ instead of an
+// error code that would pass for a valid seq.
+template <typename R> struct ZegoExplicitMissingSeq {
+    static R value() { return R(ZEGOEXP_MISSING_SEQ); }
+};
+
+// Callable stand-in for a `pfnzego_*` function pointer of type T.
+template <typename T, template <typename> class Missing = ZegoExplicitMissingResult>
+class ZegoExplicitSymbol : public ZegoExplicitSymbolBase {
+  public:
+    ZegoExplicitSymbol(const char *symbolName, ZegoExplicitRegistry *symbolRegistry)
+        : ZegoExplicitSymbolBase(symbolName, symbolRegistry) {}
+
+    template <typename... Args>
+    auto operator()(Args &&...args) -> decltype(std::declval<T>()(std::forward<Args>(args)...)) {
+        typedef decltype(std::declval<T>()(std::forward<Args>(args)...)) Result;
+        void *address = cached();
+        if (address == nullptr) {
+            if (missing()) {
+                return Missing<Result>::value();
+            }
+            address = lazyResolve();
+            if (address == nullptr) {
+                return Missing<Result>::value();
+            }
+        }
+        return ((T)address)(std::forward<Args>(args)...);
+    }
+};
+
+} // namespace EXPRESS
+} // namespace ZEGO
+
+#define ZEGOEXP_DECLARE_FUNC_PTR(type, ptr)                                                        \
+    ZEGO::EXPRESS::ZegoExplicitSymbol<type> ptr{#ptr, &explicit_registry};
+#define ZEGOEXP_DECLARE_SEQ_FUNC_PTR(type, ptr)                                                    \
+    ZEGO::EXPRESS::ZegoExplicitSymbol<type, ZEGO::EXPRESS::ZegoExplicitMissingSeq> ptr{            \
+        #ptr, &explicit_registry};
 #ifdef _WIN32
 #define ZEGOEXP_LOAD_LIBRARY()                                                                     \
     handle = (void *)::LoadLibraryA(full_path.c_str());                                            \
@@ -18,13 +157,6 @@
         return ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FAILED;                                            \
     }
 
-#define ZEGOEXP_LOAD_FUNC_PTR(type, ptr)                                                           \
-    ptr = (type)::GetProcAddress((HMODULE)handle, #ptr);                                           \
-    if (ptr == nullptr) {                                                                          \
-        unLoadLibraryInternal();                                                                   \
-        return ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND;                                    \
-    }
-
 #define ZEGOEXP_FREE_LIBRARY() ::FreeLibrary((HMODULE)handle);
 #else
 #define ZEGOEXP_LOAD_LIBRARY()                                                                     \
@@ -33,19 +165,51 @@
         return ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FAILED;                                            \
     }
 
+#define ZEGOEXP_FREE_LIBRARY() dlclose(handle);
+
+#endif
+
 #define ZEGOEXP_LOAD_FUNC_PTR(type, ptr)                                                           \
-    ptr = (type)dlsym(handle, #ptr);                                                               \
-    if (ptr == nullptr) {                                                                          \
+    if (ptr.resolve() == nullptr) {                                                                \
         unLoadLibraryInternal();                                                                   \
         return ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND;                                    \
     }
 
-#define ZEGOEXP_FREE_LIBRARY() dlclose(handle);
-
-#endif
+// Symbols needed to create the engine, log in, publish and play. They are resolved at load time
+// in lazy mode so that a library missing one of them is still rejected up front.
+#define ZEGOEXP_LOAD_CORE_FUNC_PTR                                                                 \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_get_version, zego_express_get_version)                   \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_set_platform_language,                                   \
+                          zego_express_set_platform_language)                                      \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_set_engine_config, zego_express_set_engine_config)       \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_set_log_config, zego_express_set_log_config)             \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_set_room_mode, zego_express_set_room_mode)               \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_handle_api_call_result,                                  \
+                          zego_express_handle_api_call_result)                                     \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_engine_init, zego_express_engine_init)                   \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_engine_init_with_profile,                                \
+                          zego_express_engine_init_with_profile)                                   \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_engine_uninit_async, zego_express_engine_uninit_async)   \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_login_room, zego_express_login_room)                     \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_login_room_with_callback,                                \
+                          zego_express_login_room_with_callback)                                   \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_logout_room, zego_express_logout_room)                   \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_start_preview, zego_express_start_preview)               \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_stop_preview, zego_express_stop_preview)                 \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_start_publishing_stream,                                 \
+                          zego_express_start_publishing_stream)                                    \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_start_publishing_stream_with_config,                     \
+                          zego_express_start_publishing_stream_with_config)                        \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_stop_publishing_stream,                                  \
+                          zego_express_stop_publishing_stream)                                     \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_start_playing_stream, zego_express_start_playing_stream) \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_start_playing_stream_with_config,                        \
+                          zego_express_start_playing_stream_with_config)                           \
+    ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_stop_playing_stream, zego_express_stop_playing_stream)
 
 #define ZEGOEXP_DECLARE_FUNC                                                                        \
     void *handle = nullptr;                                                                         \
+    ZEGO::EXPRESS::ZegoExplicitRegistry explicit_registry{&handle};                                 \
     ZEGOEXP_DECLARE_FUNC_PTR(pfnzego_express_add_publish_cdn_url,                                   \
                              zego_express_add_publish_cdn_url)                                      \
     ZEGOEXP_DECLARE_FUNC_PTR(pfnzego_express_add_publish_cdn_url_v2,                                \
@@ -337,7 +501,7 @@
                              zego_express_get_default_audio_device_id)                              \
     ZEGOEXP_DECLARE_FUNC_PTR(pfnzego_express_get_default_video_device_id,                           \
                              zego_express_get_default_video_device_id)                              \
-    ZEGOEXP_DECLARE_FUNC_PTR(pfnzego_express_get_increase_seq, zego_express_get_increase_seq)       \
+    ZEGOEXP_DECLARE_SEQ_FUNC_PTR(pfnzego_express_get_increase_seq, zego_express_get_increase_seq)   \
     ZEGOEXP_DECLARE_FUNC_PTR(pfnzego_express_get_network_time_info,                                 \
                              zego_express_get_network_time_info)                                    \
     ZEGOEXP_DECLARE_FUNC_PTR(pfnzego_express_get_room_stream_list,                                  \
@@ -1366,11 +1530,23 @@
                              zego_register_video_device_state_changed_callback)                     \
     ZEGOEXP_DECLARE_FUNC_PTR(pfnzego_register_video_object_segmentation_state_changed_callback,     \
                              zego_register_video_object_segmentation_state_changed_callback)        \
-    int loadLibraryInternal(const std::string &full_path) {                                         \
+    int loadLibraryInternal(const std::string &full_path, bool lazy, bool preload_core) {           \
         if (nullptr != handle) {                                                                    \
             return 0;                                                                               \
         }                                                                                           \
+        unsigned long long begin = ZEGO::EXPRESS::ZegoExplicitRegistry::nowUs();                    \
         ZEGOEXP_LOAD_LIBRARY()                                                                      \
+        unsigned long long loaded = ZEGO::EXPRESS::ZegoExplicitRegistry::nowUs();                   \
+        explicit_registry.loadLibraryTimeUs = loaded - begin;                                       \
+        explicit_registry.lazyResolveTimeUs = 0;                                                    \
+        if (lazy) {                                                                                 \
+            if (preload_core) {                                                                     \
+                ZEGOEXP_LOAD_CORE_FUNC_PTR                                                          \
+            }                                                                                       \
+            explicit_registry.resolveSymbolsTimeUs =                                                \
+                ZEGO::EXPRESS::ZegoExplicitRegistry::nowUs() - loaded;                              \
+            return 0;                                                                               \
+        }                                                                                           \
         do {                                                                                        \
             ZEGOEXP_LOAD_FUNC_PTR(pfnzego_express_add_publish_cdn_url,                              \
                                   zego_express_add_publish_cdn_url)                                 \
@@ -2722,6 +2898,8 @@
                 pfnzego_register_video_object_segmentation_state_changed_callback,                  \
                 zego_register_video_object_segmentation_state_changed_callback)                     \
         } while (false);                                                                            \
+        explicit_registry.resolveSymbolsTimeUs =                                                    \
+            ZEGO::EXPRESS::ZegoExplicitRegistry::nowUs() - loaded;                                  \
         return 0;                                                                                   \
     }                                                                                               \
     void unLoadLibraryInternal() {                                                                  \
@@ -2730,6 +2908,9 @@
         }                                                                                           \
         ZEGOEXP_FREE_LIBRARY()                                                                      \
         handle = nullptr;                                                                           \
+        for (auto symbol = explicit_registry.head; symbol; symbol = symbol->next) {                 \
+            symbol->reset();                                                                        \
+        }                                                                                           \
     }
 
 #endif // ZEGOEXP_EXPLICIT
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ZegoExpressDefines.h"
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Copy of a media player video frame. Buffers are reused from frame to frame.
+struct ZegoQueuedVideoFrame {
+    std::vector<unsigned char> planes[4];
+    const unsigned char *data[4] = {nullptr, nullptr, nullptr, nullptr};
+    unsigned int dataLength[4] = {0, 0, 0, 0};
+    ZegoVideoFrameParam param;
+    std::string extraInfo;
+    std::chrono::steady_clock::time_point enqueueTime;
+
+    void bind() {
+        for (int i = 0; i < 4; i++) {
+            data[i] = dataLength[i] > 0 ? planes[i].data() : nullptr;
+        }
+    }
+
+    static int planeCount(ZegoVideoFrameFormat format) {
+        switch (format) {
+        case ZEGO_VIDEO_FRAME_FORMAT_I420:
+        case ZEGO_VIDEO_FRAME_FORMAT_I422:
+            return 3;
+        case ZEGO_VIDEO_FRAME_FORMAT_NV12:
+        case ZEGO_VIDEO_FRAME_FORMAT_NV21:
+            return 2;
+        default:
+            return 1;
+        }
+    }
+};
+
+// Copy of a media player audio frame.
+struct ZegoQueuedAudioFrame {
+    std::vector<unsigned char> data;
+    ZegoAudioFrameParam param;
+    std::chrono::steady_clock::time_point enqueueTime;
+
+    void bind() {}
+};
+
+// Bounded frame queue drained by a dedicated consumer thread, so that a slow frame handler does
+// not stall the decoder. The producer copies each frame into a spare slot outside the queue lock
+// and swaps it in; the consumer swaps the oldest slot out and delivers it without any lock held.
+template <typename Frame>
+class ZegoMediaFrameQueue : public std::enable_shared_from_this<ZegoMediaFrameQueue<Frame>> {
+  public:
+    typedef std::function<void(Frame &)> Sink;
+
+    ZegoMediaFrameQueue(unsigned int capacity, ZegoMediaPlayerFrameDropPolicy dropPolicy,
+                        unsigned int lateThresholdMs, Sink sink)
+        : ring_(capacity > 0 ? capacity : 1), dropPolicy_(dropPolicy),
+          lateThreshold_(std::chrono::milliseconds(lateThresholdMs)), sink_(std::move(sink)) {}
+
+    ~ZegoMediaFrameQueue() {
+        if (worker_.joinable()) {
+            worker_.detach();
+        }
+    }
+
+    void start() {
+        auto self = this->shared_from_this();
+        worker_ = std::thread([self]() { self->run(); });
+    }
+
+    // Stops delivery, the sink is not called again once this returns (unless called by the sink)
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+        if (!worker_.joinable()) {
+            return;
+        }
+        if (worker_.get_id() == std::this_thread::get_id()) {
+            worker_.detach();
+        } else {
+            worker_.join();
+        }
+    }
+
+    // Copies a frame in through [fill], a callable taking `Frame &`
+    template <typename Fill> void push(Fill fill) {
+        std::lock_guard<std::mutex> producerLock(producer_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopped_) {
+                return;
+            }
+            if (count_ == ring_.size() &&
+                dropPolicy_ == ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_NEWEST) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        fill(spare_);
+        spare_.enqueueTime = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (count_ == ring_.size()) {
+                // Drop oldest, its buffers become the next spare
+                head_ = (head_ + 1) % ring_.size();
+                count_--;
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            std::swap(ring_[(head_ + count_) % ring_.size()], spare_);
+            count_++;
+        }
+        cv_.notify_one();
+    }
+
+    unsigned long long deliveredCount() const { return delivered_.load(std::memory_order_relaxed); }
+
+    unsigned long long droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    unsigned long long lateCount() const { return late_.load(std::memory_order_relaxed); }
+
+  private:
+    void run() {
+        Frame current;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopped_ || count_ > 0; });
+                if (stopped_) {
+                    return;
+                }
+                std::swap(current, ring_[head_]);
+                head_ = (head_ + 1) % ring_.size();
+                count_--;
+            }
+            if (lateThreshold_.count() > 0 &&
+                std::chrono::steady_clock::now() - current.enqueueTime > lateThreshold_) {
+                late_.fetch_add(1, std::memory_order_relaxed);
+            }
+            current.bind();
+            sink_(current);
+            delivered_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<Frame> ring_;
+    Frame spare_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    bool stopped_ = false;
+    ZegoMediaPlayerFrameDropPolicy dropPolicy_;
+    std::chrono::steady_clock::duration lateThreshold_;
+    Sink sink_;
+    std::mutex mutex_;
+    std::mutex producer_mutex_;
+    std::condition_variable cv_;
+    std::thread worker_;
+    std::atomic<unsigned long long> delivered_{0};
+    std::atomic<unsigned long long> dropped_{0};
+    std::atomic<unsigned long long> late_{0};
+};
+
+} // namespace EXPRESS
+} // namespace ZEGO
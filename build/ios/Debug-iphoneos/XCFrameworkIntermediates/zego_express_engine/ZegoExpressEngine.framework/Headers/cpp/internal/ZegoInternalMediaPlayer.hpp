@@ -6,6 +6,7 @@
 
 #include "ZegoInternalBase.h"
 #include "ZegoInternalBridge.h"
+#include "ZegoInternalMediaFrameQueue.hpp"
 
 ZEGO_DISABLE_DEPRECATION_WARNINGS
 
@@ -17,6 +18,15 @@ class ZegoExpressMediaPlayerImp : public IZegoMediaPlayer,
   public:
     ZegoExpressMediaPlayerImp(int index) : instanceIndex(index) {}
 
+    ~ZegoExpressMediaPlayerImp() {
+        if (mpVideoFrameQueue) {
+            mpVideoFrameQueue->stop();
+        }
+        if (mpAudioFrameQueue) {
+            mpAudioFrameQueue->stop();
+        }
+    }
+
     void setEventHandler(std::shared_ptr<IZegoMediaPlayerEventHandler> handler) override {
         std::lock_guard<std::mutex> lock(mediaEventMutex);
         mpEventHandler = handler;
@@ -131,7 +141,7 @@ class ZegoExpressMediaPlayerImp : public IZegoMediaPlayer,
 
     void seekTo(unsigned long long millisecond, ZegoMediaPlayerSeekToCallback callback) override {
         auto seq = oInternalOriginBridge->getIncreaseSeq();
-        if (callback != nullptr) {
+        if (callback != nullptr && !ZegoMissingSeq::fail(seq, callback)) {
             std::lock_guard<std::mutex> lock(mediaEventMutex);
             mpSeekToCallbacks.insert({seq, callback});
         }
@@ -566,15 +576,86 @@ class ZegoExpressMediaPlayerImp : public IZegoMediaPlayer,
         ZEGO_SWITCH_THREAD_ING
     }
 
+    void setFrameDeliveryConfig(const ZegoMediaPlayerFrameDeliveryConfig &config) override {
+        std::shared_ptr<ZegoMediaFrameQueue<ZegoQueuedVideoFrame>> videoQueue;
+        std::shared_ptr<ZegoMediaFrameQueue<ZegoQueuedAudioFrame>> audioQueue;
+        if (config.mode == ZEGO_MEDIA_PLAYER_FRAME_DELIVERY_MODE_QUEUED) {
+            videoQueue = std::make_shared<ZegoMediaFrameQueue<ZegoQueuedVideoFrame>>(
+                config.videoQueueCapacity, config.dropPolicy, config.lateThreshold,
+                [this](ZegoQueuedVideoFrame &frame) {
+                    deliverVideoFrame(frame.data, frame.dataLength, frame.param,
+                                      frame.extraInfo.c_str());
+                });
+            audioQueue = std::make_shared<ZegoMediaFrameQueue<ZegoQueuedAudioFrame>>(
+                config.audioQueueCapacity, config.dropPolicy, config.lateThreshold,
+                [this](ZegoQueuedAudioFrame &frame) {
+                    deliverAudioFrame(frame.data.data(), ZegoUInt(frame.data.size()),
+                                      frame.param);
+                });
+            videoQueue->start();
+            audioQueue->start();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mediaEventMutex);
+            std::swap(mpVideoFrameQueue, videoQueue);
+            std::swap(mpAudioFrameQueue, audioQueue);
+            mpSyncVideoFrameCount = 0;
+            mpSyncAudioFrameCount = 0;
+        }
+        // The old consumers may be inside a handler that takes mediaEventMutex
+        if (videoQueue) {
+            videoQueue->stop();
+        }
+        if (audioQueue) {
+            audioQueue->stop();
+        }
+    }
+
+    ZegoMediaPlayerFrameDeliveryStats getFrameDeliveryStats() override {
+        std::lock_guard<std::mutex> lock(mediaEventMutex);
+        ZegoMediaPlayerFrameDeliveryStats stats;
+        stats.videoFrameCount = mpSyncVideoFrameCount;
+        stats.audioFrameCount = mpSyncAudioFrameCount;
+        if (mpVideoFrameQueue) {
+            stats.videoFrameCount += mpVideoFrameQueue->deliveredCount();
+            stats.droppedVideoFrameCount = mpVideoFrameQueue->droppedCount();
+            stats.lateVideoFrameCount = mpVideoFrameQueue->lateCount();
+        }
+        if (mpAudioFrameQueue) {
+            stats.audioFrameCount += mpAudioFrameQueue->deliveredCount();
+            stats.droppedAudioFrameCount = mpAudioFrameQueue->droppedCount();
+            stats.lateAudioFrameCount = mpAudioFrameQueue->lateCount();
+        }
+        return stats;
+    }
+
     void zego_on_media_player_video_frame(const unsigned char **data, unsigned int *data_length,
                                           const struct zego_video_frame_param _param,
                                           const char *extra_info) {
-        std::lock_guard<std::mutex> lock(mediaEventMutex);
-        if (mpVideoHandler) {
-            auto param = ZegoExpressConvert::I2OVideoFrameParam(_param);
-            mpVideoHandler->onVideoFrame(this, data, data_length, param);
-            mpVideoHandler->onVideoFrame(this, data, data_length, param, extra_info);
+        std::shared_ptr<ZegoMediaFrameQueue<ZegoQueuedVideoFrame>> queue;
+        {
+            std::lock_guard<std::mutex> lock(mediaEventMutex);
+            if (!mpVideoHandler) {
+                return;
+            }
+            queue = mpVideoFrameQueue;
         }
+        auto param = ZegoExpressConvert::I2OVideoFrameParam(_param);
+        if (!queue) {
+            deliverVideoFrame(data, data_length, param, extra_info);
+            mpSyncVideoFrameCount++;
+            return;
+        }
+        queue->push([&](ZegoQueuedVideoFrame &frame) {
+            int planeCount = ZegoQueuedVideoFrame::planeCount(param.format);
+            for (int i = 0; i < 4; i++) {
+                unsigned int length = i < planeCount && data[i] ? data_length[i] : 0;
+                frame.planes[i].assign(data[i], data[i] + length);
+                frame.dataLength[i] = length;
+            }
+            frame.param = param;
+            frame.extraInfo = extra_info ? extra_info : "";
+        });
     }
 
     void zego_on_media_player_take_snapshot_result(
@@ -588,13 +669,26 @@ class ZegoExpressMediaPlayerImp : public IZegoMediaPlayer,
 
     void zego_on_media_player_audio_frame(const unsigned char *data, unsigned int data_length,
                                           const struct zego_audio_frame_param _param) {
-        std::lock_guard<std::mutex> lock(mediaEventMutex);
-        if (mpAudioHandler) {
-            ZegoAudioFrameParam param;
-            param.channel = ZegoAudioChannel(_param.channel);
-            param.sampleRate = ZegoAudioSampleRate(_param.sample_rate);
-            mpAudioHandler->onAudioFrame(this, data, data_length, param);
+        std::shared_ptr<ZegoMediaFrameQueue<ZegoQueuedAudioFrame>> queue;
+        {
+            std::lock_guard<std::mutex> lock(mediaEventMutex);
+            if (!mpAudioHandler) {
+                return;
+            }
+            queue = mpAudioFrameQueue;
         }
+        ZegoAudioFrameParam param;
+        param.channel = ZegoAudioChannel(_param.channel);
+        param.sampleRate = ZegoAudioSampleRate(_param.sample_rate);
+        if (!queue) {
+            deliverAudioFrame(data, data_length, param);
+            mpSyncAudioFrameCount++;
+            return;
+        }
+        queue->push([&](ZegoQueuedAudioFrame &frame) {
+            frame.data.assign(data, data + data_length);
+            frame.param = param;
+        });
     }
 
     void zego_on_media_player_block_begin(const char *path) {
@@ -615,6 +709,31 @@ class ZegoExpressMediaPlayerImp : public IZegoMediaPlayer,
     }
 
   private:
+    // Handlers run outside mediaEventMutex so that a slow handler never blocks set*Handler
+    void deliverVideoFrame(const unsigned char **data, unsigned int *data_length,
+                           const ZegoVideoFrameParam &param, const char *extra_info) {
+        std::shared_ptr<IZegoMediaPlayerVideoHandler> handler;
+        {
+            std::lock_guard<std::mutex> lock(mediaEventMutex);
+            handler = mpVideoHandler;
+        }
+        if (handler) {
+            handler->onVideoFrame(this, data, data_length, param, extra_info);
+        }
+    }
+
+    void deliverAudioFrame(const unsigned char *data, unsigned int data_length,
+                           const ZegoAudioFrameParam &param) {
+        std::shared_ptr<IZegoMediaPlayerAudioHandler> handler;
+        {
+            std::lock_guard<std::mutex> lock(mediaEventMutex);
+            handler = mpAudioHandler;
+        }
+        if (handler) {
+            handler->onAudioFrame(this, data, data_length, param);
+        }
+    }
+
     void handleLoadResourceCallback(int errorCode, ZegoMediaPlayerLoadResourceCallback callback) {
         if (errorCode == ZEGO_ERRCODE_COMMON_SUCCESS) {
             std::lock_guard<std::mutex> lock(mediaEventMutex);
@@ -640,6 +759,10 @@ class ZegoExpressMediaPlayerImp : public IZegoMediaPlayer,
     std::list<ZegoMediaPlayerLoadResourceCallback> mpLoadResourceCallbacks;
     ZegoMediaPlayerTakeSnapshotCallback mpTakeSnapshotCallback;
     std::unordered_map<zego_seq, ZegoMediaPlayerSeekToCallback> mpSeekToCallbacks;
+    std::shared_ptr<ZegoMediaFrameQueue<ZegoQueuedVideoFrame>> mpVideoFrameQueue;
+    std::shared_ptr<ZegoMediaFrameQueue<ZegoQueuedAudioFrame>> mpAudioFrameQueue;
+    std::atomic<unsigned long long> mpSyncVideoFrameCount{0};
+    std::atomic<unsigned long long> mpSyncAudioFrameCount{0};
     std::mutex mediaEventMutex;
     int instanceIndex = -1;
 };
@@ -0,0 +1,516 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../ZegoExpressDefines.h"
+#include "ZegoInternalBridge.h"
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Fixed capacity ring of timestamped rows, stored column by column so a range query over one
+// metric reads contiguous memory. Every column holds |stats| values per row: the sample for the
+// raw tier, min/avg/max/p95 for the downsampled tiers.
+class ZegoMetricsRing {
+  public:
+    void allocate(unsigned int capacity, unsigned int columns, unsigned int stats) {
+        capacity_ = capacity;
+        stats_ = stats;
+        size_ = 0;
+        head_ = 0;
+        timestamps_.assign(capacity, 0);
+        counts_.assign(stats > 1 ? capacity : 0, 0);
+        values_.assign(size_t(capacity) * columns * stats, 0.0f);
+    }
+
+    void clear() {
+        size_ = 0;
+        head_ = 0;
+    }
+
+    unsigned int size() const { return size_; }
+
+    unsigned int stats() const { return stats_; }
+
+    // Row |i| counted from the oldest one
+    int64_t timestamp(unsigned int i) const { return timestamps_[physical(i)]; }
+
+    unsigned int count(unsigned int i) const { return stats_ > 1 ? counts_[physical(i)] : 1; }
+
+    float value(unsigned int i, unsigned int column, unsigned int stat) const {
+        return values_[(size_t(column) * stats_ + stat) * capacity_ + physical(i)];
+    }
+
+    // Returns the row to fill, overwriting the oldest one when full
+    unsigned int push(int64_t timestamp, unsigned int count) {
+        if (capacity_ == 0) {
+            return 0;
+        }
+        unsigned int row = head_;
+        timestamps_[row] = timestamp;
+        if (stats_ > 1) {
+            counts_[row] = count;
+        }
+        head_ = head_ + 1 == capacity_ ? 0 : head_ + 1;
+        size_ = size_ < capacity_ ? size_ + 1 : size_;
+        return row;
+    }
+
+    void set(unsigned int row, unsigned int column, unsigned int stat, float value) {
+        values_[(size_t(column) * stats_ + stat) * capacity_ + row] = value;
+    }
+
+    // First row with timestamp >= |timestamp|, timestamps are non-decreasing
+    unsigned int lowerBound(int64_t timestamp) const {
+        unsigned int low = 0, high = size_;
+        while (low < high) {
+            unsigned int mid = low + (high - low) / 2;
+            if (this->timestamp(mid) < timestamp) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+  private:
+    unsigned int physical(unsigned int i) const {
+        unsigned int index = head_ + capacity_ - size_ + i;
+        return index >= capacity_ ? index - capacity_ : index;
+    }
+
+    unsigned int capacity_ = 0;
+    unsigned int stats_ = 1;
+    unsigned int size_ = 0;
+    unsigned int head_ = 0;
+    std::vector<int64_t> timestamps_;
+    std::vector<uint32_t> counts_;
+    std::vector<float> values_;
+};
+
+// Collects the samples of the period in progress of a downsampled tier. The p95 is taken from a
+// reservoir of at most kReservoirSize rows, exact up to that many samples per period.
+class ZegoMetricsAccumulator {
+  public:
+    static const unsigned int kReservoirSize = 64;
+    static const unsigned int kMaxColumns = 12;
+
+    explicit ZegoMetricsAccumulator(int64_t period = 60000) : period_(period) {}
+
+    int64_t period() const { return period_; }
+
+    int64_t start() const { return start_; }
+
+    unsigned int count() const { return count_; }
+
+    void reset(unsigned int columns) {
+        columns_ = columns;
+        count_ = 0;
+        start_ = 0;
+    }
+
+    // Whether |timestamp| starts a new period, the current one has to be flushed first
+    bool rollsOver(int64_t timestamp) const {
+        return count_ > 0 && periodStart(timestamp) != start_;
+    }
+
+    void add(int64_t timestamp, const float *values) {
+        if (count_ == 0) {
+            start_ = periodStart(timestamp);
+            for (unsigned int c = 0; c < columns_; c++) {
+                min_[c] = values[c];
+                max_[c] = values[c];
+                sum_[c] = 0;
+            }
+        }
+        unsigned int slot = count_;
+        if (count_ >= kReservoirSize) {
+            // Reservoir sampling keeps every row with the same probability
+            rng_ ^= rng_ << 13;
+            rng_ ^= rng_ >> 17;
+            rng_ ^= rng_ << 5;
+            slot = rng_ % (count_ + 1);
+        }
+        for (unsigned int c = 0; c < columns_; c++) {
+            min_[c] = std::min(min_[c], values[c]);
+            max_[c] = std::max(max_[c], values[c]);
+            sum_[c] += values[c];
+            if (slot < kReservoirSize) {
+                reservoir_[c][slot] = values[c];
+            }
+        }
+        count_++;
+    }
+
+    void flush(ZegoMetricsRing &ring) {
+        unsigned int row = ring.push(start_, count_);
+        for (unsigned int c = 0; c < columns_; c++) {
+            float stats[4];
+            summarize(c, stats);
+            for (unsigned int s = 0; s < 4; s++) {
+                ring.set(row, c, s, stats[s]);
+            }
+        }
+        count_ = 0;
+    }
+
+    // min, avg, max, p95 of |column|
+    void summarize(unsigned int column, float *stats) const {
+        stats[0] = min_[column];
+        stats[1] = count_ ? static_cast<float>(sum_[column] / count_) : 0.0f;
+        stats[2] = max_[column];
+        float sorted[kReservoirSize];
+        unsigned int n = std::min(count_, kReservoirSize);
+        std::copy(reservoir_[column], reservoir_[column] + n, sorted);
+        unsigned int rank = n ? (n * 95 + 99) / 100 - 1 : 0;
+        std::nth_element(sorted, sorted + rank, sorted + n);
+        stats[3] = n ? sorted[rank] : 0.0f;
+    }
+
+  private:
+    int64_t periodStart(int64_t timestamp) const {
+        int64_t offset = timestamp % period_;
+        return timestamp - (offset < 0 ? offset + period_ : offset);
+    }
+
+    int64_t period_;
+    int64_t start_ = 0;
+    unsigned int columns_ = 0;
+    unsigned int count_ = 0;
+    uint32_t rng_ = 2463534242u;
+    float min_[kMaxColumns];
+    float max_[kMaxColumns];
+    double sum_[kMaxColumns];
+    float reservoir_[kMaxColumns][kReservoirSize];
+};
+
+// Keeps the quality history of every published stream, played stream and user for the whole
+// call. Memory is allocated when a series is first seen and never grows after that: each series
+// has a raw ring plus one minute and ten minute rings with their accumulators. Samples arrive
+// every few seconds per stream on the SDK thread, a single mutex is enough.
+class ZegoQualityMetricsStore {
+  public:
+    enum Kind { KIND_PUBLISH = 0, KIND_PLAY = 1, KIND_NETWORK = 2 };
+
+    static ZegoQualityMetricsStore *GetInstance() {
+        static ZegoQualityMetricsStore oInstance;
+        return &oInstance;
+    }
+
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void setConfig(const ZegoQualityMetricsStoreConfig &config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool resize = config.maxSeries != config_.maxSeries ||
+                      config.rawCapacity != config_.rawCapacity ||
+                      config.minuteCapacity != config_.minuteCapacity ||
+                      config.tenMinuteCapacity != config_.tenMinuteCapacity;
+        if (!config.enable || resize) {
+            std::vector<Series>().swap(series_);
+        }
+        config_ = config;
+        if (config.enable && series_.empty()) {
+            series_.resize(config.maxSeries);
+        }
+        enabled_.store(config.enable, std::memory_order_relaxed);
+    }
+
+    void addPublishQuality(const char *streamID, const zego_publish_stream_quality &quality) {
+        float values[] = {static_cast<float>(quality.video_send_fps),
+                          static_cast<float>(quality.video_kbps),
+                          static_cast<float>(quality.audio_kbps),
+                          static_cast<float>(quality.rtt),
+                          static_cast<float>(quality.packet_lost_rate),
+                          static_cast<float>(quality.level)};
+        add(KIND_PUBLISH, streamID, nowMs(), values);
+    }
+
+    void addPlayQuality(const char *streamID, const zego_play_stream_quality &quality) {
+        float values[] = {static_cast<float>(quality.video_recv_fps),
+                          static_cast<float>(quality.video_render_fps),
+                          static_cast<float>(quality.video_kbps),
+                          static_cast<float>(quality.audio_kbps),
+                          static_cast<float>(quality.video_break_rate),
+                          static_cast<float>(quality.audio_break_rate),
+                          static_cast<float>(quality.mos),
+                          static_cast<float>(quality.rtt),
+                          static_cast<float>(quality.packet_lost_rate),
+                          static_cast<float>(quality.peer_to_peer_delay),
+                          static_cast<float>(quality.delay),
+                          static_cast<float>(quality.level)};
+        add(KIND_PLAY, streamID, nowMs(), values);
+    }
+
+    void addNetworkQuality(const char *userID, int upstreamLevel, int downstreamLevel) {
+        float values[] = {static_cast<float>(upstreamLevel), static_cast<float>(downstreamLevel)};
+        add(KIND_NETWORK, userID ? userID : "", nowMs(), values);
+    }
+
+    // Samples of one series, |values| holds columnCount(kind) values
+    void add(Kind kind, const char *id, int64_t timestamp, const float *values) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Series *series = acquire(kind, id);
+        if (!series) {
+            return;
+        }
+        // Rings are searched by timestamp, keep them ordered if the wall clock steps back
+        timestamp = std::max(timestamp, series->updated);
+        series->updated = timestamp;
+
+        unsigned int row = series->raw.push(timestamp, 1);
+        for (unsigned int c = 0; c < series->columns; c++) {
+            series->raw.set(row, c, 0, values[c]);
+        }
+        for (int t = 0; t < 2; t++) {
+            if (series->accumulators[t].rollsOver(timestamp)) {
+                series->accumulators[t].flush(series->tiers[t]);
+            }
+            series->accumulators[t].add(timestamp, values);
+        }
+    }
+
+    unsigned int query(const char *id, ZegoQualityMetric metric,
+                       ZegoQualityMetricsResolution resolution, int64_t beginTime,
+                       int64_t endTime, ZegoQualityMetricsPoint *points, unsigned int maxPoints) {
+        Kind kind;
+        unsigned int column;
+        if (!locate(metric, kind, column) || !points) {
+            return 0;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        Series *series = find(kind, id);
+        if (!series) {
+            return 0;
+        }
+        unsigned int count = 0;
+        if (resolution == ZEGO_QUALITY_METRICS_RESOLUTION_RAW) {
+            const ZegoMetricsRing &ring = series->raw;
+            for (unsigned int i = ring.lowerBound(beginTime);
+                 i < ring.size() && ring.timestamp(i) < endTime && count < maxPoints; i++) {
+                float value = ring.value(i, column, 0);
+                fill(points[count++], ring.timestamp(i), 1, value, value, value, value);
+            }
+            return count;
+        }
+
+        int tier = resolution == ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE ? 0 : 1;
+        const ZegoMetricsRing &ring = series->tiers[tier];
+        const ZegoMetricsAccumulator &accumulator = series->accumulators[tier];
+        // Include the period |beginTime| falls into
+        int64_t first = beginTime - accumulator.period() + 1;
+        for (unsigned int i = ring.lowerBound(first);
+             i < ring.size() && ring.timestamp(i) < endTime && count < maxPoints; i++) {
+            fill(points[count++], ring.timestamp(i), ring.count(i), ring.value(i, column, 0),
+                 ring.value(i, column, 1), ring.value(i, column, 2), ring.value(i, column, 3));
+        }
+        if (accumulator.count() > 0 && accumulator.start() >= first &&
+            accumulator.start() < endTime && count < maxPoints) {
+            float stats[4];
+            accumulator.summarize(column, stats);
+            fill(points[count++], accumulator.start(), accumulator.count(), stats[0], stats[1],
+                 stats[2], stats[3]);
+        }
+        return count;
+    }
+
+    // Binary export, all integers little endian:
+    //   "ZQM" version:u8 seriesCount:varint
+    //   per series: kind:u8 columns:u8 idLength:varint id
+    //     raw, minute and ten minute tier, each:
+    //       rows:varint, timestamps as zigzag varint deltas from 0 (ms since the Unix epoch),
+    //       downsampled tiers only: per row sample count:varint,
+    //       values as f32 column by column, downsampled tiers write the min, avg, max and p95
+    //       rows of a column one after another
+    // The period in progress is exported as the last row of its tier.
+    std::vector<unsigned char> exportBlob() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<unsigned char> blob = {'Z', 'Q', 'M', 1};
+        unsigned int used = 0;
+        for (const Series &series : series_) {
+            used += series.used ? 1 : 0;
+        }
+        writeVarint(blob, used);
+        for (Series &series : series_) {
+            if (!series.used) {
+                continue;
+            }
+            blob.push_back(static_cast<unsigned char>(series.kind));
+            blob.push_back(static_cast<unsigned char>(series.columns));
+            writeVarint(blob, series.id.size());
+            blob.insert(blob.end(), series.id.begin(), series.id.end());
+            writeRing(blob, series.raw, series.columns, nullptr);
+            for (int t = 0; t < 2; t++) {
+                writeRing(blob, series.tiers[t], series.columns, &series.accumulators[t]);
+            }
+        }
+        return blob;
+    }
+
+    static unsigned int columnCount(Kind kind) {
+        return kind == KIND_PUBLISH ? 6 : kind == KIND_PLAY ? 12 : 2;
+    }
+
+  private:
+    struct Series {
+        bool used = false;
+        Kind kind = KIND_PUBLISH;
+        unsigned int columns = 0;
+        std::string id;
+        int64_t updated = 0;
+        ZegoMetricsRing raw;
+        ZegoMetricsRing tiers[2];
+        ZegoMetricsAccumulator accumulators[2] = {ZegoMetricsAccumulator(60000),
+                                                  ZegoMetricsAccumulator(600000)};
+    };
+
+    ZegoQualityMetricsStore() {}
+
+    ZegoQualityMetricsStore(const ZegoQualityMetricsStore &) = delete;
+    ZegoQualityMetricsStore &operator=(const ZegoQualityMetricsStore &) = delete;
+
+    static int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static bool locate(ZegoQualityMetric metric, Kind &kind, unsigned int &column) {
+        if (metric >= ZEGO_QUALITY_METRIC_NETWORK_UPSTREAM_LEVEL &&
+            metric <= ZEGO_QUALITY_METRIC_NETWORK_DOWNSTREAM_LEVEL) {
+            kind = KIND_NETWORK;
+            column = metric - ZEGO_QUALITY_METRIC_NETWORK_UPSTREAM_LEVEL;
+        } else if (metric >= ZEGO_QUALITY_METRIC_PLAY_VIDEO_RECV_FPS) {
+            kind = KIND_PLAY;
+            column = metric - ZEGO_QUALITY_METRIC_PLAY_VIDEO_RECV_FPS;
+        } else if (metric >= ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS) {
+            kind = KIND_PUBLISH;
+            column = metric - ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    static void fill(ZegoQualityMetricsPoint &point, int64_t timestamp, unsigned int count,
+                     float min, float avg, float max, float p95) {
+        point.timestamp = timestamp;
+        point.count = count;
+        point.min = min;
+        point.avg = avg;
+        point.max = max;
+        point.p95 = p95;
+    }
+
+    Series *find(Kind kind, const char *id) {
+        for (Series &series : series_) {
+            if (series.used && series.kind == kind && series.id == id) {
+                return &series;
+            }
+        }
+        return nullptr;
+    }
+
+    // Finds or creates the series, reusing the one updated longest ago when all are in use
+    Series *acquire(Kind kind, const char *id) {
+        if (series_.empty()) {
+            return nullptr;
+        }
+        Series *series = find(kind, id);
+        if (series) {
+            return series;
+        }
+        series = &series_[0];
+        for (Series &candidate : series_) {
+            if (!candidate.used) {
+                series = &candidate;
+                break;
+            }
+            if (candidate.updated < series->updated) {
+                series = &candidate;
+            }
+        }
+        unsigned int columns = columnCount(kind);
+        if (!series->used || series->columns != columns) {
+            series->raw.allocate(config_.rawCapacity, columns, 1);
+            series->tiers[0].allocate(config_.minuteCapacity, columns, 4);
+            series->tiers[1].allocate(config_.tenMinuteCapacity, columns, 4);
+        } else {
+            series->raw.clear();
+            series->tiers[0].clear();
+            series->tiers[1].clear();
+        }
+        series->accumulators[0].reset(columns);
+        series->accumulators[1].reset(columns);
+        series->used = true;
+        series->kind = kind;
+        series->columns = columns;
+        series->id = id;
+        series->updated = 0;
+        return series;
+    }
+
+    static void writeVarint(std::vector<unsigned char> &blob, uint64_t value) {
+        while (value >= 0x80) {
+            blob.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        blob.push_back(static_cast<unsigned char>(value));
+    }
+
+    static void writeFloat(std::vector<unsigned char> &blob, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; i++) {
+            blob.push_back(static_cast<unsigned char>(bits >> (8 * i)));
+        }
+    }
+
+    static void writeRing(std::vector<unsigned char> &blob, const ZegoMetricsRing &ring,
+                          unsigned int columns, const ZegoMetricsAccumulator *accumulator) {
+        bool partial = accumulator && accumulator->count() > 0;
+        unsigned int rows = ring.size() + (partial ? 1 : 0);
+        writeVarint(blob, rows);
+        int64_t previous = 0;
+        for (unsigned int i = 0; i < rows; i++) {
+            int64_t timestamp = i < ring.size() ? ring.timestamp(i) : accumulator->start();
+            int64_t delta = timestamp - previous;
+            writeVarint(blob, (static_cast<uint64_t>(delta) << 1) ^
+                                  static_cast<uint64_t>(delta >> 63));
+            previous = timestamp;
+        }
+        if (accumulator) {
+            for (unsigned int i = 0; i < rows; i++) {
+                writeVarint(blob, i < ring.size() ? ring.count(i) : accumulator->count());
+            }
+        }
+        unsigned int stats = accumulator ? 4 : 1;
+        for (unsigned int c = 0; c < columns; c++) {
+            float current[4] = {0, 0, 0, 0};
+            if (partial) {
+                accumulator->summarize(c, current);
+            }
+            for (unsigned int s = 0; s < stats; s++) {
+                for (unsigned int i = 0; i < rows; i++) {
+                    writeFloat(blob, i < ring.size() ? ring.value(i, c, s) : current[s]);
+                }
+            }
+        }
+    }
+
+    std::atomic<bool> enabled_{false};
+    std::mutex mutex_;
+    ZegoQualityMetricsStoreConfig config_;
+    std::vector<Series> series_;
+};
+#define oInternalQualityMetricsStore ZegoQualityMetricsStore::GetInstance()
+
+} // namespace EXPRESS
+} // namespace ZEGO
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Header of a payload block, the bytes follow it in the same allocation.
+struct ZegoPayloadBuffer {
+    std::atomic<unsigned int> refCount;
+    unsigned int capacity;
+    unsigned int length;
+    int sizeClass;
+
+    unsigned char *bytes() { return reinterpret_cast<unsigned char *>(this + 1); }
+};
+
+// Recycles payload blocks by size class so that a steady stream of SEI / side info / RTSD
+// packets does not hit the allocator. Blocks bigger than the largest class are not pooled.
+class ZegoPayloadPool {
+  public:
+    static ZegoPayloadPool *GetInstance() {
+        // Intentionally leaked: payloads may still be released during static destruction
+        static ZegoPayloadPool *oInstance = new ZegoPayloadPool();
+        return oInstance;
+    }
+
+    ZegoPayloadBuffer *acquire(unsigned int length) {
+        int sizeClass = classOf(length);
+        ZegoPayloadBuffer *buffer = nullptr;
+        if (sizeClass >= 0) {
+            std::lock_guard<std::mutex> lock(mutex_[sizeClass]);
+            if (!free_[sizeClass].empty()) {
+                buffer = free_[sizeClass].back();
+                free_[sizeClass].pop_back();
+            }
+        }
+        if (buffer == nullptr) {
+            unsigned int capacity = sizeClass >= 0 ? classSize(sizeClass) : length;
+            void *memory = std::malloc(sizeof(ZegoPayloadBuffer) + capacity);
+            if (memory == nullptr) {
+                return nullptr;
+            }
+            buffer = new (memory) ZegoPayloadBuffer();
+            buffer->capacity = capacity;
+            buffer->sizeClass = sizeClass;
+        }
+        buffer->refCount.store(1, std::memory_order_relaxed);
+        buffer->length = length;
+        return buffer;
+    }
+
+    void recycle(ZegoPayloadBuffer *buffer) {
+        int sizeClass = buffer->sizeClass;
+        if (sizeClass >= 0) {
+            std::lock_guard<std::mutex> lock(mutex_[sizeClass]);
+            if (free_[sizeClass].size() < kMaxCachedPerClass) {
+                free_[sizeClass].push_back(buffer);
+                return;
+            }
+        }
+        buffer->~ZegoPayloadBuffer();
+        std::free(buffer);
+    }
+
+  private:
+    static const int kClassCount = 4;
+    static const size_t kMaxCachedPerClass = 64;
+
+    ZegoPayloadPool() {
+        for (int i = 0; i < kClassCount; i++) {
+            free_[i].reserve(kMaxCachedPerClass);
+        }
+    }
+
+    static unsigned int classSize(int sizeClass) {
+        static const unsigned int sizes[kClassCount] = {256, 1024, 4096, 16384};
+        return sizes[sizeClass];
+    }
+
+    static int classOf(unsigned int length) {
+        for (int i = 0; i < kClassCount; i++) {
+            if (length <= classSize(i)) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    std::mutex mutex_[kClassCount];
+    std::vector<ZegoPayloadBuffer *> free_[kClassCount];
+};
+
+/// Read-only, reference-counted callback payload.
+///
+/// The payload is copied once from the SDK into a pooled buffer and shared by every handler that
+/// receives it. Reading it through [data] and [size] inside the callback costs nothing; keeping a
+/// copy of the object retains the buffer after the callback returns, without copying the bytes.
+class ZegoPayloadRef {
+  public:
+    ZegoPayloadRef() : buffer_(nullptr) {}
+
+    ZegoPayloadRef(const ZegoPayloadRef &other) : buffer_(other.buffer_) { retain(); }
+
+    ZegoPayloadRef(ZegoPayloadRef &&other) : buffer_(other.buffer_) { other.buffer_ = nullptr; }
+
+    ZegoPayloadRef &operator=(const ZegoPayloadRef &other) {
+        if (this != &other) {
+            release();
+            buffer_ = other.buffer_;
+            retain();
+        }
+        return *this;
+    }
+
+    ZegoPayloadRef &operator=(ZegoPayloadRef &&other) {
+        if (this != &other) {
+            release();
+            buffer_ = other.buffer_;
+            other.buffer_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~ZegoPayloadRef() { release(); }
+
+    /// Copy [length] bytes from [data] into a pooled buffer. A null [data] gives an empty payload.
+    static ZegoPayloadRef copyFrom(const unsigned char *data, unsigned int length) {
+        ZegoPayloadRef ref;
+        if (data == nullptr && length > 0) {
+            return ref;
+        }
+        ref.buffer_ = ZegoPayloadPool::GetInstance()->acquire(length);
+        if (ref.buffer_ && length > 0) {
+            memcpy(ref.buffer_->bytes(), data, length);
+        }
+        return ref;
+    }
+
+    /// Payload content, valid for as long as this object (or a copy of it) is alive.
+    const unsigned char *data() const { return buffer_ ? buffer_->bytes() : nullptr; }
+
+    /// Payload length in bytes.
+    unsigned int size() const { return buffer_ ? buffer_->length : 0; }
+
+    bool empty() const { return size() == 0; }
+
+  private:
+    void retain() {
+        if (buffer_) {
+            buffer_->refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release() {
+        if (buffer_ && buffer_->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ZegoPayloadPool::GetInstance()->recycle(buffer_);
+        }
+        buffer_ = nullptr;
+    }
+
+    ZegoPayloadBuffer *buffer_;
+};
+
+} // namespace EXPRESS
+} // namespace ZEGO
@@ -0,0 +1,562 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "../ZegoExpressDefines.h"
+#include "ZegoInternalDispatcher.hpp"
+#include "ZegoInternalProfiler.hpp"
+#include "ZegoInternalSoundLevelTable.hpp"
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Process wide allocation counters, fed by the operator new/delete replacements below when a
+// translation unit defines ZEGOEXP_ALLOCATION_HOOK. Counters are striped per thread so that
+// allocating threads do not share a cache line. Sizes are the allocator's usable size, which is
+// what both new and delete can see.
+class ZegoAllocationCounter {
+  public:
+    static const unsigned int kStripes = 16;
+
+    struct Totals {
+        unsigned long long count;
+        unsigned long long bytes;
+        long long inFlight;
+    };
+
+    static void *allocate(std::size_t size) {
+        void *p = std::malloc(size ? size : 1);
+        if (p) {
+            onAllocate(usableSize(p));
+        }
+        return p;
+    }
+
+    static void release(void *p) {
+        if (p) {
+            onFree(usableSize(p));
+            std::free(p);
+        }
+    }
+
+    // For the std::align_val_t forms, |alignment| is a power of two
+    static void *allocateAligned(std::size_t size, std::size_t alignment) {
+        void *p = nullptr;
+#if defined(_WIN32)
+        p = _aligned_malloc(size ? size : 1, alignment);
+#else
+        if (posix_memalign(&p, std::max(alignment, sizeof(void *)), size ? size : 1) != 0) {
+            p = nullptr;
+        }
+#endif
+        if (p) {
+            onAllocate(alignedUsableSize(p, alignment));
+        }
+        return p;
+    }
+
+    static void releaseAligned(void *p, std::size_t alignment) {
+        if (p) {
+            onFree(alignedUsableSize(p, alignment));
+#if defined(_WIN32)
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
+    }
+
+    static void markInstalled() { installed().store(true, std::memory_order_relaxed); }
+
+    static bool isInstalled() { return installed().load(std::memory_order_relaxed); }
+
+    static Totals totals() {
+        Totals totals = {0, 0, 0};
+        Stripe *stripes = stripeArray();
+        for (unsigned int i = 0; i < kStripes; i++) {
+            totals.count += stripes[i].count.load(std::memory_order_relaxed);
+            totals.bytes += stripes[i].bytes.load(std::memory_order_relaxed);
+            totals.inFlight += stripes[i].inFlight.load(std::memory_order_relaxed);
+        }
+        return totals;
+    }
+
+  private:
+    struct alignas(64) Stripe {
+        std::atomic<unsigned long long> count;
+        std::atomic<unsigned long long> bytes;
+        std::atomic<long long> inFlight;
+    };
+
+    // Zero initialized before any dynamic initialization, so the hook works for allocations
+    // made by other static constructors.
+    static Stripe *stripeArray() {
+        static Stripe stripes[kStripes];
+        return stripes;
+    }
+
+    static std::atomic<bool> &installed() {
+        static std::atomic<bool> flag;
+        return flag;
+    }
+
+    static Stripe &localStripe() {
+        static std::atomic<unsigned int> next;
+        static thread_local unsigned int index =
+            next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return stripeArray()[index];
+    }
+
+    static void onAllocate(std::size_t bytes) {
+        Stripe &stripe = localStripe();
+        stripe.count.fetch_add(1, std::memory_order_relaxed);
+        stripe.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        stripe.inFlight.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed);
+    }
+
+    static void onFree(std::size_t bytes) {
+        localStripe().inFlight.fetch_sub(static_cast<long long>(bytes), std::memory_order_relaxed);
+    }
+
+    static std::size_t usableSize(void *p) {
+#if defined(__linux__)
+        return malloc_usable_size(p);
+#elif defined(__APPLE__)
+        return malloc_size(p);
+#elif defined(_WIN32)
+        return _msize(p);
+#else
+        (void)p;
+        return 0;
+#endif
+    }
+
+    static std::size_t alignedUsableSize(void *p, std::size_t alignment) {
+#if defined(_WIN32)
+        return _aligned_msize(p, alignment, 0);
+#else
+        (void)alignment;
+        return usableSize(p);
+#endif
+    }
+};
+
+// Reads the CPU time of every thread of the process from /proc/self/task/<tid>/stat. Other
+// platforms report no threads.
+class ZegoThreadCpuReader {
+  public:
+    // Reads all threads and fills the busiest ones into |status|. Returns false on platforms
+    // without per thread CPU times.
+    bool read(double periodUs, ZegoExtendedPerformanceStatus &status) {
+#if defined(__linux__)
+        current_.clear();
+        DIR *dir = opendir("/proc/self/task");
+        if (!dir) {
+            return false;
+        }
+        while (struct dirent *entry = readdir(dir)) {
+            if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+                continue;
+            }
+            Entry thread;
+            if (readThread(atoi(entry->d_name), thread)) {
+                current_.push_back(thread);
+            }
+        }
+        closedir(dir);
+
+        std::sort(current_.begin(), current_.end(),
+                  [](const Entry &a, const Entry &b) { return a.tid < b.tid; });
+        for (Entry &thread : current_) {
+            auto previous = std::lower_bound(
+                previous_.begin(), previous_.end(), thread.tid,
+                [](const Entry &entry, int tid) { return entry.tid < tid; });
+            if (previous != previous_.end() && previous->tid == thread.tid) {
+                thread.delta = thread.cpuTime >= previous->cpuTime
+                                   ? thread.cpuTime - previous->cpuTime
+                                   : 0;
+            } else {
+                // Started during the period, or the first read
+                thread.delta = primed_ ? thread.cpuTime : 0;
+            }
+        }
+        primed_ = true;
+
+        status.totalThreadCount = static_cast<unsigned int>(current_.size());
+        size_t count = std::min<size_t>(current_.size(), ZEGO_PERFORMANCE_MAX_THREADS);
+        busiest_.assign(current_.begin(), current_.end());
+        std::partial_sort(busiest_.begin(), busiest_.begin() + count, busiest_.end(),
+                          [](const Entry &a, const Entry &b) { return a.delta > b.delta; });
+        status.threadCount = static_cast<unsigned int>(count);
+        for (size_t i = 0; i < count; i++) {
+            ZegoThreadCpuSample &sample = status.threads[i];
+            sample.threadID = busiest_[i].tid;
+            memcpy(sample.name, busiest_[i].name, sizeof(sample.name));
+            sample.cpuTime = busiest_[i].cpuTime;
+            sample.cpuUsage =
+                periodUs > 0 ? static_cast<float>(busiest_[i].delta / periodUs) : 0.0f;
+        }
+        previous_.swap(current_);
+        return true;
+#else
+        (void)periodUs;
+        status.totalThreadCount = 0;
+        status.threadCount = 0;
+        return false;
+#endif
+    }
+
+  private:
+    struct Entry {
+        int tid;
+        char name[16];
+        unsigned long long cpuTime;
+        unsigned long long delta;
+    };
+
+#if defined(__linux__)
+    bool readThread(int tid, Entry &thread) {
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        char buffer[512];
+        ssize_t size = ::read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (size <= 0) {
+            return false;
+        }
+        buffer[size] = '\0';
+
+        // "tid (comm) state ppid ...": comm may contain spaces and parentheses, so split at the
+        // last ')'. utime and stime are fields 14 and 15, state is field 3.
+        char *openParen = strchr(buffer, '(');
+        char *closeParen = strrchr(buffer, ')');
+        if (!openParen || !closeParen || closeParen < openParen) {
+            return false;
+        }
+        size_t nameLength = std::min<size_t>(closeParen - openParen - 1, sizeof(thread.name) - 1);
+        memcpy(thread.name, openParen + 1, nameLength);
+        thread.name[nameLength] = '\0';
+
+        char *cursor = closeParen + 2;
+        for (int field = 3; field < 14 && cursor; field++) {
+            cursor = strchr(cursor, ' ');
+            if (cursor) {
+                cursor++;
+            }
+        }
+        if (!cursor) {
+            return false;
+        }
+        char *end = nullptr;
+        unsigned long long utime = strtoull(cursor, &end, 10);
+        unsigned long long stime = strtoull(end, nullptr, 10);
+        thread.tid = tid;
+        thread.cpuTime = (utime + stime) * 1000000ULL / ticksPerSecond();
+        thread.delta = 0;
+        return true;
+    }
+
+    static unsigned long long ticksPerSecond() {
+        static const long ticks = sysconf(_SC_CLK_TCK);
+        return ticks > 0 ? static_cast<unsigned long long>(ticks) : 100;
+    }
+#endif
+
+    std::vector<Entry> current_;
+    std::vector<Entry> previous_;
+    std::vector<Entry> busiest_;
+    bool primed_ = false;
+};
+
+// Builds ZegoExtendedPerformanceStatus on every performance monitor tick: per thread CPU time,
+// allocation rates, queue depths and the frame rates reported by the latest player quality
+// update of each stream. Sampling runs on the SDK thread that reports the performance status and
+// reuses its buffers, so after the first tick it does not allocate apart from opendir.
+class ZegoPerformanceSampler {
+  public:
+    static const int64_t kStreamExpiryNs = 10LL * 1000 * 1000 * 1000;
+
+    static ZegoPerformanceSampler *GetInstance() {
+        static ZegoPerformanceSampler oInstance;
+        return &oInstance;
+    }
+
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void enable(bool enable) {
+        std::lock_guard<std::mutex> lock(sample_mutex_);
+        if (enable && !enabled_.load(std::memory_order_relaxed)) {
+            // Prime the baselines so the first report covers one full period
+            ZegoExtendedPerformanceStatus scratch;
+            threads_.read(0, scratch);
+            last_sample_ns_ = ZegoCallbackProfiler::now();
+            last_allocations_ = ZegoAllocationCounter::totals();
+        }
+        enabled_.store(enable, std::memory_order_relaxed);
+    }
+
+    void setQueueDepthProvider(ZegoPerformanceQueue queue, ZegoQueueDepthProvider provider) {
+        if (queue >= 0 && queue < ZEGO_PERFORMANCE_QUEUE_COUNT) {
+            providers_[queue].store(provider, std::memory_order_release);
+        }
+    }
+
+    void updateStreamFps(const char *streamID, double decodeFPS, double renderFPS) {
+        int64_t now = ZegoCallbackProfiler::now();
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        ZegoStreamHandle handle = oInternalSoundLevelTable->find(streamID);
+        unsigned int target = 0;
+        bool found = false;
+        for (unsigned int i = 0; i < ZEGO_PERFORMANCE_MAX_STREAMS; i++) {
+            if (handle != ZEGO_STREAM_HANDLE_INVALID && streams_[i].handle == handle) {
+                target = i;
+                found = true;
+                break;
+            }
+            // Otherwise reuse the entry updated longest ago
+            if (streams_[i].updatedNs < streams_[target].updatedNs) {
+                target = i;
+            }
+        }
+        if (!found) {
+            // Each entry holds a reference, so the handle is not reused while it is reported
+            handle = oInternalSoundLevelTable->retain(streamID);
+            if (handle == ZEGO_STREAM_HANDLE_INVALID) {
+                return;
+            }
+            if (streams_[target].handle != ZEGO_STREAM_HANDLE_INVALID) {
+                oInternalSoundLevelTable->release(streams_[target].handle);
+            }
+        }
+        streams_[target].handle = handle;
+        streams_[target].decodeFPS = static_cast<float>(decodeFPS);
+        streams_[target].renderFPS = static_cast<float>(renderFPS);
+        streams_[target].updatedNs = now;
+    }
+
+    void sample(ZegoExtendedPerformanceStatus &status) {
+        std::lock_guard<std::mutex> lock(sample_mutex_);
+        int64_t now = ZegoCallbackProfiler::now();
+        double periodUs = last_sample_ns_ > 0 ? (now - last_sample_ns_) / 1000.0 : 0;
+        double periodSeconds = periodUs / 1000000.0;
+        last_sample_ns_ = now;
+        status.period = static_cast<unsigned long long>(periodUs);
+
+        threads_.read(periodUs, status);
+
+        ZegoAllocationCounter::Totals allocations = ZegoAllocationCounter::totals();
+        status.allocationHookInstalled = ZegoAllocationCounter::isInstalled();
+        status.allocationRate =
+            periodSeconds > 0 ? (allocations.count - last_allocations_.count) / periodSeconds : 0;
+        status.allocationBytesRate =
+            periodSeconds > 0 ? (allocations.bytes - last_allocations_.bytes) / periodSeconds : 0;
+        status.bytesInFlight = allocations.inFlight;
+        last_allocations_ = allocations;
+
+        for (unsigned int i = 0; i < ZEGO_PERFORMANCE_QUEUE_COUNT; i++) {
+            ZegoQueueDepthProvider provider = providers_[i].load(std::memory_order_acquire);
+            status.queueDepths[i] = provider ? provider() : 0;
+        }
+        status.queueDepths[ZEGO_PERFORMANCE_QUEUE_CALLBACK] =
+            oInternalCallbackDispatcher->getStats().queueDepth;
+
+        std::lock_guard<std::mutex> streamsLock(streams_mutex_);
+        status.streamCount = 0;
+        for (unsigned int i = 0; i < ZEGO_PERFORMANCE_MAX_STREAMS; i++) {
+            const StreamEntry &entry = streams_[i];
+            if (entry.updatedNs == 0 || now - entry.updatedNs > kStreamExpiryNs) {
+                continue;
+            }
+            ZegoStreamFpsSample &fps = status.streams[status.streamCount++];
+            fps.streamHandle = entry.handle;
+            fps.decodeFPS = entry.decodeFPS;
+            fps.renderFPS = entry.renderFPS;
+        }
+    }
+
+  private:
+    struct StreamEntry {
+        ZegoStreamHandle handle = ZEGO_STREAM_HANDLE_INVALID;
+        float decodeFPS = 0;
+        float renderFPS = 0;
+        int64_t updatedNs = 0;
+    };
+
+    ZegoPerformanceSampler() {
+        for (unsigned int i = 0; i < ZEGO_PERFORMANCE_QUEUE_COUNT; i++) {
+            providers_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ZegoPerformanceSampler(const ZegoPerformanceSampler &) = delete;
+    ZegoPerformanceSampler &operator=(const ZegoPerformanceSampler &) = delete;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<ZegoQueueDepthProvider> providers_[ZEGO_PERFORMANCE_QUEUE_COUNT];
+
+    std::mutex streams_mutex_;
+    StreamEntry streams_[ZEGO_PERFORMANCE_MAX_STREAMS];
+
+    std::mutex sample_mutex_;
+    ZegoThreadCpuReader threads_;
+    int64_t last_sample_ns_ = 0;
+    ZegoAllocationCounter::Totals last_allocations_ = {0, 0, 0};
+};
+#define oInternalPerformanceSampler ZegoPerformanceSampler::GetInstance()
+
+} // namespace EXPRESS
+} // namespace ZEGO
+
+// Define ZEGOEXP_ALLOCATION_HOOK in exactly one translation unit of the app before including
+// ZegoExpressSDK.h to replace the global operator new and delete with counting versions, which
+// feed the allocation fields of ZegoExtendedPerformanceStatus. The aligned forms are replaced too
+// when the compiler has C++17 aligned new.
+#ifdef ZEGOEXP_ALLOCATION_HOOK
+#if defined(_MSC_VER)
+#define ZEGO_ALLOCATION_HOOK_NOINLINE __declspec(noinline)
+#else
+// Keeps GCC from pairing the inlined malloc and free with new and delete and warning about it
+#define ZEGO_ALLOCATION_HOOK_NOINLINE __attribute__((noinline))
+#endif
+
+static const bool zegoAllocationHookInstalled =
+    (ZEGO::EXPRESS::ZegoAllocationCounter::markInstalled(), true);
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new(std::size_t size) {
+    void *p = ZEGO::EXPRESS::ZegoAllocationCounter::allocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new[](std::size_t size) {
+    void *p = ZEGO::EXPRESS::ZegoAllocationCounter::allocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new(std::size_t size,
+                                                 const std::nothrow_t &) noexcept {
+    return ZEGO::EXPRESS::ZegoAllocationCounter::allocate(size);
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new[](std::size_t size,
+                                                   const std::nothrow_t &) noexcept {
+    return ZEGO::EXPRESS::ZegoAllocationCounter::allocate(size);
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete(void *p) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::release(p);
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete[](void *p) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::release(p);
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete(void *p, const std::nothrow_t &) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::release(p);
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::release(p);
+}
+
+#if defined(__cpp_sized_deallocation)
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete(void *p, std::size_t) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::release(p);
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete[](void *p, std::size_t) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::release(p);
+}
+#endif
+
+#if defined(__cpp_aligned_new)
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new(std::size_t size, std::align_val_t alignment) {
+    void *p = ZEGO::EXPRESS::ZegoAllocationCounter::allocateAligned(
+        size, static_cast<std::size_t>(alignment));
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new[](std::size_t size, std::align_val_t alignment) {
+    void *p = ZEGO::EXPRESS::ZegoAllocationCounter::allocateAligned(
+        size, static_cast<std::size_t>(alignment));
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new(std::size_t size, std::align_val_t alignment,
+                                                 const std::nothrow_t &) noexcept {
+    return ZEGO::EXPRESS::ZegoAllocationCounter::allocateAligned(
+        size, static_cast<std::size_t>(alignment));
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void *operator new[](std::size_t size, std::align_val_t alignment,
+                                                   const std::nothrow_t &) noexcept {
+    return ZEGO::EXPRESS::ZegoAllocationCounter::allocateAligned(
+        size, static_cast<std::size_t>(alignment));
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete(void *p, std::align_val_t alignment) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::releaseAligned(p, static_cast<std::size_t>(alignment));
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete[](void *p, std::align_val_t alignment) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::releaseAligned(p, static_cast<std::size_t>(alignment));
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete(void *p, std::align_val_t alignment,
+                                                   const std::nothrow_t &) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::releaseAligned(p, static_cast<std::size_t>(alignment));
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete[](void *p, std::align_val_t alignment,
+                                                     const std::nothrow_t &) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::releaseAligned(p, static_cast<std::size_t>(alignment));
+}
+
+#if defined(__cpp_sized_deallocation)
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete(void *p, std::size_t,
+                                                   std::align_val_t alignment) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::releaseAligned(p, static_cast<std::size_t>(alignment));
+}
+
+ZEGO_ALLOCATION_HOOK_NOINLINE void operator delete[](void *p, std::size_t,
+                                                     std::align_val_t alignment) noexcept {
+    ZEGO::EXPRESS::ZegoAllocationCounter::releaseAligned(p, static_cast<std::size_t>(alignment));
+}
+#endif
+#endif
+#endif
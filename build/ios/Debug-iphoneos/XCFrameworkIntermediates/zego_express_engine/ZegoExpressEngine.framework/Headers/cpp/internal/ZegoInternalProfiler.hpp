@@ -0,0 +1,542 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ZegoExpressDefines.h"
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Log-linear latency histogram in the style of HdrHistogram. Values are nanoseconds; every power
+// of two is split into 16 linear buckets, so a bucket is at most 1/16 wide relative to its values.
+// Values up to 2^36 ns (about 68 s) are resolved, larger ones land in the last bucket. Recording
+// is a relaxed atomic increment and may happen on any thread.
+class ZegoLatencyHistogram {
+  public:
+    static const unsigned int kSubBucketBits = 4;
+    static const unsigned int kSubBuckets = 1u << kSubBucketBits;
+    static const unsigned int kMaxExponent = 36;
+    static const unsigned int kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    ZegoLatencyHistogram() {
+        for (unsigned int i = 0; i < kBucketCount; i++) {
+            counts_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void record(int64_t valueNs) {
+        uint64_t value = valueNs > 0 ? static_cast<uint64_t>(valueNs) : 0;
+        counts_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void load(std::vector<uint64_t> &counts, uint64_t &sum) const {
+        counts.resize(kBucketCount);
+        for (unsigned int i = 0; i < kBucketCount; i++) {
+            counts[i] = counts_[i].load(std::memory_order_relaxed);
+        }
+        sum = sum_.load(std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (unsigned int i = 0; i < kBucketCount; i++) {
+            counts_[i].store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+    }
+
+    static unsigned int bucketOf(uint64_t value) {
+        if (value < kSubBuckets) {
+            return static_cast<unsigned int>(value);
+        }
+        unsigned int exponent = log2Floor(value);
+        if (exponent >= kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        unsigned int shift = exponent - kSubBucketBits;
+        return (shift + 1) * kSubBuckets +
+               static_cast<unsigned int>((value >> shift) & (kSubBuckets - 1));
+    }
+
+    // Highest value that maps to |bucket|.
+    static uint64_t upperBound(unsigned int bucket) {
+        unsigned int block = bucket / kSubBuckets;
+        uint64_t sub = bucket % kSubBuckets;
+        if (block == 0) {
+            return sub;
+        }
+        unsigned int shift = block - 1;
+        return ((kSubBuckets + sub + 1) << shift) - 1;
+    }
+
+    // Summarizes |counts| (as filled by load, possibly minus an earlier load) in microseconds.
+    static ZegoLatencyDistribution summarize(const std::vector<uint64_t> &counts, uint64_t sum,
+                                             uint64_t total) {
+        ZegoLatencyDistribution distribution;
+        if (total == 0) {
+            return distribution;
+        }
+        const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+        double *targets[] = {&distribution.p50, &distribution.p90, &distribution.p99,
+                             &distribution.p999};
+        unsigned int next = 0;
+        uint64_t seen = 0;
+        for (unsigned int i = 0; i < counts.size(); i++) {
+            if (counts[i] == 0) {
+                continue;
+            }
+            seen += counts[i];
+            while (next < 4 && seen >= quantileRank(kQuantiles[next], total)) {
+                *targets[next++] = upperBound(i) / 1000.0;
+            }
+            distribution.max = upperBound(i) / 1000.0;
+        }
+        distribution.mean = static_cast<double>(sum) / total / 1000.0;
+        return distribution;
+    }
+
+  private:
+    static uint64_t quantileRank(double quantile, uint64_t total) {
+        uint64_t rank = static_cast<uint64_t>(quantile * total + 0.5);
+        return rank > 0 ? rank : 1;
+    }
+
+    static unsigned int log2Floor(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - static_cast<unsigned int>(__builtin_clzll(value));
+#else
+        unsigned int exponent = 0;
+        while (value >>= 1) {
+            exponent++;
+        }
+        return exponent;
+#endif
+    }
+
+    std::atomic<uint64_t> counts_[kBucketCount];
+    std::atomic<uint64_t> sum_{0};
+};
+
+// One SDK callback function. Created once per call site by ZEGO_SWITCH_THREAD_PRE and never freed;
+// the histograms are only allocated once the callback is measured for the first time.
+class ZegoCallbackSite {
+  public:
+    struct Histograms {
+        ZegoLatencyHistogram queueDelay;
+        ZegoLatencyHistogram handlerRuntime;
+    };
+
+    explicit ZegoCallbackSite(const char *name) : name(name) {}
+
+    void record(int64_t queueNs, int64_t runNs) {
+        Histograms *histograms = histograms_.load(std::memory_order_acquire);
+        if (!histograms) {
+            Histograms *created = new Histograms();
+            if (histograms_.compare_exchange_strong(histograms, created,
+                                                    std::memory_order_acq_rel)) {
+                histograms = created;
+            } else {
+                delete created;
+            }
+        }
+        histograms->queueDelay.record(queueNs);
+        histograms->handlerRuntime.record(runNs);
+    }
+
+    Histograms *histograms() const { return histograms_.load(std::memory_order_acquire); }
+
+    const char *const name;
+    ZegoCallbackSite *next = nullptr;
+
+    // Owned by the profiler, guarded by its mutex: the totals of the last periodic report.
+    std::vector<uint64_t> reportedQueue;
+    std::vector<uint64_t> reportedRun;
+    uint64_t reportedQueueSum = 0;
+    uint64_t reportedRunSum = 0;
+
+  private:
+    std::atomic<Histograms *> histograms_{nullptr};
+};
+
+// Writes complete ("X") events to a Chrome trace event JSON file. Producers claim a slot of a
+// bounded ring with one atomic increment (Vyukov's bounded queue) and never block; a writer
+// thread drains the ring into the file every 100 ms. Events that find the ring full are dropped
+// and counted, the count is written at the end of the file.
+class ZegoTraceWriter {
+  public:
+    ~ZegoTraceWriter() {
+        stop();
+        delete[] slots_;
+    }
+
+    bool start(const std::string &path, unsigned int capacity) {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        stopLocked();
+        file_ = fopen(path.c_str(), "wb");
+        if (!file_) {
+            return false;
+        }
+        unsigned int size = 1024;
+        while (size < capacity && size < (1u << 24)) {
+            size <<= 1;
+        }
+        if (size != capacity_) {
+            delete[] slots_;
+            slots_ = new Slot[size];
+            capacity_ = size;
+        }
+        for (unsigned int i = 0; i < capacity_; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_ = 0;
+        dropped_.store(0, std::memory_order_relaxed);
+        fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file_);
+        fputs("{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,"
+              "\"args\":{\"name\":\"ZegoExpress\"}}",
+              file_);
+        {
+            std::lock_guard<std::mutex> writerLock(writer_mutex_);
+            writer_stop_ = false;
+        }
+        running_.store(true, std::memory_order_seq_cst);
+        writer_ = std::thread([this]() { writerLoop(); });
+        return true;
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        stopLocked();
+    }
+
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+    void add(const char *category, const char *name, int64_t beginNs, int64_t durationNs,
+             int64_t queueNs) {
+        producers_.fetch_add(1, std::memory_order_seq_cst);
+        if (running_.load(std::memory_order_seq_cst)) {
+            push(category, name, beginNs, durationNs, queueNs);
+        }
+        producers_.fetch_sub(1, std::memory_order_release);
+    }
+
+  private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        const char *category = nullptr;
+        const char *name = nullptr;
+        unsigned int tid = 0;
+        int64_t beginNs = 0;
+        int64_t durationNs = 0;
+        int64_t queueNs = 0;
+    };
+
+    static unsigned int threadID() {
+        static std::atomic<unsigned int> counter{0};
+        static thread_local unsigned int id = ++counter;
+        return id;
+    }
+
+    void push(const char *category, const char *name, int64_t beginNs, int64_t durationNs,
+              int64_t queueNs) {
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Slot *slot = nullptr;
+        while (true) {
+            slot = &slots_[pos & (capacity_ - 1)];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->category = category;
+        slot->name = name;
+        slot->tid = threadID();
+        slot->beginNs = beginNs;
+        slot->durationNs = durationNs;
+        slot->queueNs = queueNs;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(writer_mutex_);
+        while (!writer_stop_) {
+            writer_cv_.wait_for(lock, std::chrono::milliseconds(100));
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    // Writer thread, or stopLocked once the writer has exited.
+    void drain() {
+        while (true) {
+            Slot &slot = slots_[dequeue_pos_ & (capacity_ - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+                break;
+            }
+            writeEvent(slot);
+            slot.sequence.store(dequeue_pos_ + capacity_, std::memory_order_release);
+            dequeue_pos_++;
+        }
+        fflush(file_);
+    }
+
+    void writeEvent(const Slot &slot) {
+        fputs(",\n{\"ph\":\"X\",\"cat\":", file_);
+        writeString(slot.category);
+        fputs(",\"name\":", file_);
+        writeString(slot.name);
+        fprintf(file_, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", slot.tid,
+                slot.beginNs / 1000.0, slot.durationNs / 1000.0);
+        if (slot.queueNs >= 0) {
+            fprintf(file_, ",\"args\":{\"queue_us\":%.3f}", slot.queueNs / 1000.0);
+        }
+        fputc('}', file_);
+    }
+
+    void writeString(const char *text) {
+        fputc('"', file_);
+        for (const char *p = text ? text : ""; *p; p++) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '"' || c == '\\') {
+                fputc('\\', file_);
+                fputc(c, file_);
+            } else if (c < 0x20) {
+                fprintf(file_, "\\u%04x", c);
+            } else {
+                fputc(c, file_);
+            }
+        }
+        fputc('"', file_);
+    }
+
+    void stopLocked() {
+        if (!running_.exchange(false, std::memory_order_seq_cst)) {
+            return;
+        }
+        // Producers that saw running_ finish their push before the ring is drained for the
+        // last time
+        while (producers_.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+        {
+            std::lock_guard<std::mutex> writerLock(writer_mutex_);
+            writer_stop_ = true;
+            writer_cv_.notify_one();
+        }
+        writer_.join();
+        drain();
+        unsigned long long dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            fprintf(file_,
+                    ",\n{\"ph\":\"M\",\"name\":\"dropped_events\",\"pid\":1,\"tid\":0,"
+                    "\"args\":{\"count\":%llu}}",
+                    dropped);
+        }
+        fputs("\n]}\n", file_);
+        fclose(file_);
+        file_ = nullptr;
+    }
+
+    std::mutex state_mutex_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> producers_{0};
+    FILE *file_ = nullptr;
+
+    Slot *slots_ = nullptr;
+    unsigned int capacity_ = 0;
+    std::atomic<uint64_t> enqueue_pos_{0};
+    uint64_t dequeue_pos_ = 0;
+    std::atomic<unsigned long long> dropped_{0};
+
+    std::mutex writer_mutex_;
+    std::condition_variable writer_cv_;
+    std::thread writer_;
+    bool writer_stop_ = false;
+};
+
+// Queueing delay and handler runtime of the callbacks that go through
+// ZegoExpressCallbackDispatcher, as per callback histograms and/or trace events. While both are
+// off the dispatcher only pays for one relaxed load per callback.
+class ZegoCallbackProfiler {
+  public:
+    static ZegoCallbackProfiler *GetInstance() {
+        static ZegoCallbackProfiler oInstance;
+        return &oInstance;
+    }
+
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Sites with the same name share their histograms.
+    ZegoCallbackSite *site(const char *name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (ZegoCallbackSite *site = sites_; site; site = site->next) {
+            if (strcmp(site->name, name) == 0) {
+                return site;
+            }
+        }
+        ZegoCallbackSite *site = new ZegoCallbackSite(name);
+        site->next = sites_;
+        sites_ = site;
+        return site;
+    }
+
+    bool active() const { return active_.load(std::memory_order_relaxed); }
+
+    bool latencyStatsEnabled() const { return stats_enabled_.load(std::memory_order_relaxed); }
+
+    void setConfig(const ZegoCallbackProfilerConfig &config) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        stats_enabled_.store(config.enableLatencyStats, std::memory_order_relaxed);
+        if (config.traceFilePath != trace_path_ || !trace_.running()) {
+            trace_.stop();
+            trace_path_.clear();
+            if (!config.traceFilePath.empty() &&
+                trace_.start(config.traceFilePath, config.traceBufferSize)) {
+                trace_path_ = config.traceFilePath;
+            }
+        }
+        active_.store(config.enableLatencyStats || trace_.running(), std::memory_order_relaxed);
+    }
+
+    // |postedNs| < 0 for callbacks that ran inline on the SDK thread.
+    void onCallback(ZegoCallbackSite *site, int64_t postedNs, int64_t startNs, int64_t endNs) {
+        int64_t queueNs = postedNs >= 0 ? startNs - postedNs : 0;
+        if (stats_enabled_.load(std::memory_order_relaxed)) {
+            site->record(queueNs, endNs - startNs);
+        }
+        if (trace_.running()) {
+            trace_.add("callback", site->name, startNs, endNs - startNs, queueNs);
+        }
+    }
+
+    void addTraceEvent(const char *category, const char *name, int64_t beginNs,
+                       int64_t durationNs, int64_t queueNs) {
+        trace_.add(category, name, beginNs, durationNs, queueNs);
+    }
+
+    // Cumulative statistics of every callback measured since the last reset.
+    std::vector<ZegoCallbackLatencyStats> getStats() {
+        return collect(false);
+    }
+
+    // Statistics of the callbacks measured since the previous call, for onCallbackLatencyStatsUpdate.
+    std::vector<ZegoCallbackLatencyStats> getIntervalStats() {
+        return collect(true);
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (ZegoCallbackSite *site = sites_; site; site = site->next) {
+            ZegoCallbackSite::Histograms *histograms = site->histograms();
+            if (histograms) {
+                histograms->queueDelay.reset();
+                histograms->handlerRuntime.reset();
+            }
+            site->reportedQueue.clear();
+            site->reportedRun.clear();
+            site->reportedQueueSum = 0;
+            site->reportedRunSum = 0;
+        }
+    }
+
+  private:
+    ZegoCallbackProfiler() = default;
+
+    ZegoCallbackProfiler(const ZegoCallbackProfiler &) = delete;
+    ZegoCallbackProfiler &operator=(const ZegoCallbackProfiler &) = delete;
+
+    std::vector<ZegoCallbackLatencyStats> collect(bool interval) {
+        std::vector<ZegoCallbackLatencyStats> result;
+        std::vector<uint64_t> queue;
+        std::vector<uint64_t> run;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (ZegoCallbackSite *site = sites_; site; site = site->next) {
+            ZegoCallbackSite::Histograms *histograms = site->histograms();
+            if (!histograms) {
+                continue;
+            }
+            uint64_t queueSum = 0;
+            uint64_t runSum = 0;
+            histograms->queueDelay.load(queue, queueSum);
+            histograms->handlerRuntime.load(run, runSum);
+            if (interval) {
+                std::vector<uint64_t> totalQueue = queue;
+                std::vector<uint64_t> totalRun = run;
+                subtract(queue, site->reportedQueue);
+                subtract(run, site->reportedRun);
+                uint64_t totalQueueSum = queueSum;
+                uint64_t totalRunSum = runSum;
+                queueSum -= site->reportedQueueSum;
+                runSum -= site->reportedRunSum;
+                site->reportedQueue.swap(totalQueue);
+                site->reportedRun.swap(totalRun);
+                site->reportedQueueSum = totalQueueSum;
+                site->reportedRunSum = totalRunSum;
+            }
+            // The two histograms are read one after the other, count by the runtime one
+            uint64_t count = 0;
+            for (uint64_t value : run) {
+                count += value;
+            }
+            if (count == 0) {
+                continue;
+            }
+            ZegoCallbackLatencyStats stats;
+            stats.callbackName = site->name;
+            stats.count = count;
+            stats.queueDelay = ZegoLatencyHistogram::summarize(queue, queueSum, total(queue));
+            stats.handlerRuntime = ZegoLatencyHistogram::summarize(run, runSum, count);
+            result.push_back(stats);
+        }
+        return result;
+    }
+
+    static void subtract(std::vector<uint64_t> &counts, const std::vector<uint64_t> &earlier) {
+        for (size_t i = 0; i < earlier.size() && i < counts.size(); i++) {
+            counts[i] = counts[i] >= earlier[i] ? counts[i] - earlier[i] : 0;
+        }
+    }
+
+    static uint64_t total(const std::vector<uint64_t> &counts) {
+        uint64_t sum = 0;
+        for (uint64_t value : counts) {
+            sum += value;
+        }
+        return sum;
+    }
+
+    std::mutex mutex_;
+    ZegoCallbackSite *sites_ = nullptr;
+
+    std::mutex config_mutex_;
+    std::atomic<bool> active_{false};
+    std::atomic<bool> stats_enabled_{false};
+    std::string trace_path_;
+    ZegoTraceWriter trace_;
+};
+#define oInternalCallbackProfiler ZegoCallbackProfiler::GetInstance()
+
+} // namespace EXPRESS
+} // namespace ZEGO
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Object whose destruction is deferred until every reader that could still see it has left its
+// read section.
+class ZegoRcuRetired {
+  public:
+    virtual ~ZegoRcuRetired() {}
+
+    ZegoRcuRetired *retiredNext = nullptr;
+    unsigned long long retiredEpoch = 0;
+};
+
+// Epoch based read-copy-update domain shared by the handler slots of the callback center.
+//
+// Each reading thread owns a cache line holding the epoch it entered its read section with, so
+// readers never write to memory shared with other readers. Writers publish a new version, bump the
+// global epoch and free the old version once no reader of an older epoch is left. Writers never
+// wait for readers: versions still in use are parked and freed by the next writer, or by a
+// reclaimer thread polling until their readers have left. Readers never free anything, so handler
+// destructors do not run on the SDK's media and audio threads.
+class ZegoRcuDomain {
+  public:
+    static ZegoRcuDomain *GetInstance() {
+        // Intentionally leaked: callbacks may still read handlers during static destruction
+        static ZegoRcuDomain *oInstance = new ZegoRcuDomain();
+        return oInstance;
+    }
+
+    void readLock() {
+        ThreadState &state = threadState();
+        if (state.depth++ > 0) {
+            return;
+        }
+        if (state.reader == nullptr) {
+            state.reader = claimReader();
+        }
+        if (state.reader != nullptr) {
+            state.reader->epoch.store(epoch_.load(std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+        } else {
+            overflow_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Orders the epoch announcement before any load of a published pointer
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void readUnlock() {
+        ThreadState &state = threadState();
+        if (--state.depth > 0) {
+            return;
+        }
+        if (state.reader != nullptr) {
+            state.reader->epoch.store(0, std::memory_order_release);
+        } else {
+            overflow_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // Frees [retired] as soon as no reader can reference it.
+    void retire(ZegoRcuRetired *retired) {
+        if (retired == nullptr) {
+            return;
+        }
+        retired->retiredEpoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        {
+            std::lock_guard<std::mutex> lock(retired_mutex_);
+            retired->retiredNext = retired_;
+            retired_ = retired;
+            pending_.store(true, std::memory_order_relaxed);
+        }
+        if (!reclaim()) {
+            wakeReclaimer();
+        }
+    }
+
+  private:
+    struct alignas(64) Reader {
+        std::atomic<unsigned long long> epoch{0};
+        std::atomic<bool> owned{false};
+    };
+
+    struct ThreadState {
+        Reader *reader = nullptr;
+        int depth = 0;
+
+        ~ThreadState() {
+            if (reader != nullptr) {
+                reader->owned.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    static const int kMaxReaders = 128;
+    // Reclaimer polling interval while parked versions are still read, doubled up to the maximum
+    static const int kReclaimMinIntervalMs = 1;
+    static const int kReclaimMaxIntervalMs = 16;
+
+    ZegoRcuDomain() = default;
+
+    static ThreadState &threadState() {
+        static thread_local ThreadState state;
+        return state;
+    }
+
+    Reader *claimReader() {
+        for (int i = 0; i < kMaxReaders; i++) {
+            bool expected = false;
+            if (!readers_[i].owned.load(std::memory_order_relaxed) &&
+                readers_[i].owned.compare_exchange_strong(expected, true,
+                                                          std::memory_order_acquire)) {
+                return &readers_[i];
+            }
+        }
+        // More concurrent reading threads than slots, fall back to a shared counter
+        return nullptr;
+    }
+
+    // Oldest epoch a reader may still be using, 0 if a reader without a slot is active
+    unsigned long long oldestReaderEpoch() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (overflow_.load(std::memory_order_acquire) != 0) {
+            return 0;
+        }
+        unsigned long long oldest = ~0ULL;
+        for (int i = 0; i < kMaxReaders; i++) {
+            unsigned long long epoch = readers_[i].epoch.load(std::memory_order_acquire);
+            if (epoch != 0 && epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+    // Returns true when nothing is left parked
+    bool reclaim() {
+        std::unique_lock<std::mutex> lock(retired_mutex_);
+        if (retired_ == nullptr) {
+            return true;
+        }
+        unsigned long long oldest = oldestReaderEpoch();
+        ZegoRcuRetired *freeList = nullptr;
+        ZegoRcuRetired **link = &retired_;
+        while (*link != nullptr) {
+            ZegoRcuRetired *retired = *link;
+            if (retired->retiredEpoch <= oldest) {
+                *link = retired->retiredNext;
+                retired->retiredNext = freeList;
+                freeList = retired;
+            } else {
+                link = &retired->retiredNext;
+            }
+        }
+        bool drained = retired_ == nullptr;
+        pending_.store(!drained, std::memory_order_relaxed);
+        lock.unlock();
+
+        // Destructors run outside the lock, they may release handlers that set other handlers
+        while (freeList != nullptr) {
+            ZegoRcuRetired *next = freeList->retiredNext;
+            delete freeList;
+            freeList = next;
+        }
+        return drained;
+    }
+
+    void wakeReclaimer() {
+        std::lock_guard<std::mutex> lock(reclaimer_mutex_);
+        if (!reclaimer_started_) {
+            // Detached like the domain is leaked, it only ever waits on the domain's members
+            std::thread([this]() { reclaimerLoop(); }).detach();
+            reclaimer_started_ = true;
+        }
+        reclaimer_cv_.notify_one();
+    }
+
+    void reclaimerLoop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(reclaimer_mutex_);
+                reclaimer_cv_.wait(lock,
+                                   [this]() { return pending_.load(std::memory_order_relaxed); });
+            }
+            int intervalMs = kReclaimMinIntervalMs;
+            while (!reclaim()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+                intervalMs = intervalMs * 2 < kReclaimMaxIntervalMs ? intervalMs * 2
+                                                                     : kReclaimMaxIntervalMs;
+            }
+        }
+    }
+
+    Reader readers_[kMaxReaders];
+    std::atomic<unsigned long long> epoch_{1};
+    std::atomic<unsigned int> overflow_{0};
+    std::atomic<bool> pending_{false};
+    std::mutex retired_mutex_;
+    ZegoRcuRetired *retired_ = nullptr;
+
+    std::mutex reclaimer_mutex_;
+    std::condition_variable reclaimer_cv_;
+    bool reclaimer_started_ = false;
+};
+
+// Read section. Pointers obtained through `peek` stay valid until the guard is destroyed.
+class ZegoRcuReadGuard {
+  public:
+    ZegoRcuReadGuard() { ZegoRcuDomain::GetInstance()->readLock(); }
+    ~ZegoRcuReadGuard() { ZegoRcuDomain::GetInstance()->readUnlock(); }
+
+    ZegoRcuReadGuard(const ZegoRcuReadGuard &) = delete;
+    ZegoRcuReadGuard &operator=(const ZegoRcuReadGuard &) = delete;
+};
+
+// Single shared handler, read without locking.
+template <typename T> class ZegoRcuSharedSlot {
+  public:
+    ZegoRcuSharedSlot() = default;
+
+    ~ZegoRcuSharedSlot() { delete current_.load(std::memory_order_relaxed); }
+
+    ZegoRcuSharedSlot &operator=(std::shared_ptr<T> value) {
+        set(std::move(value));
+        return *this;
+    }
+
+    void set(std::shared_ptr<T> value) {
+        Version *version = value ? new Version(std::move(value)) : nullptr;
+        ZegoRcuDomain::GetInstance()->retire(
+            current_.exchange(version, std::memory_order_acq_rel));
+    }
+
+    std::shared_ptr<T> get() const {
+        ZegoRcuReadGuard guard;
+        Version *version = current_.load(std::memory_order_acquire);
+        return version ? version->value : nullptr;
+    }
+
+    // Caller must hold a ZegoRcuReadGuard
+    T *peek() const {
+        Version *version = current_.load(std::memory_order_acquire);
+        return version ? version->value.get() : nullptr;
+    }
+
+  private:
+    struct Version : ZegoRcuRetired {
+        explicit Version(std::shared_ptr<T> v) : value(std::move(v)) {}
+        std::shared_ptr<T> value;
+    };
+
+    std::atomic<Version *> current_{nullptr};
+};
+
+// Shared objects keyed by index, read without locking. Writers copy the map.
+template <typename Key, typename T> class ZegoRcuSharedMap {
+  public:
+    typedef std::unordered_map<Key, std::shared_ptr<T>> Map;
+
+    ZegoRcuSharedMap() = default;
+
+    ~ZegoRcuSharedMap() { delete current_.load(std::memory_order_relaxed); }
+
+    void insert(const Key &key, std::shared_ptr<T> value) {
+        std::lock_guard<std::recursive_mutex> lock(write_mutex_);
+        Version *version = copy();
+        version->map.insert({key, std::move(value)});
+        publish(version);
+    }
+
+    std::shared_ptr<T> erase(const Key &key) {
+        std::lock_guard<std::recursive_mutex> lock(write_mutex_);
+        Version *version = copy();
+        std::shared_ptr<T> member;
+        auto it = version->map.find(key);
+        if (it != version->map.end()) {
+            member = it->second;
+            version->map.erase(it);
+        }
+        publish(version);
+        return member;
+    }
+
+    void clear() {
+        std::lock_guard<std::recursive_mutex> lock(write_mutex_);
+        publish(nullptr);
+    }
+
+    std::shared_ptr<T> get(const Key &key) const {
+        ZegoRcuReadGuard guard;
+        Version *version = current_.load(std::memory_order_acquire);
+        if (version == nullptr) {
+            return nullptr;
+        }
+        auto it = version->map.find(key);
+        return it != version->map.end() ? it->second : nullptr;
+    }
+
+    // Caller must hold a ZegoRcuReadGuard
+    T *peek(const Key &key) const {
+        Version *version = current_.load(std::memory_order_acquire);
+        if (version == nullptr) {
+            return nullptr;
+        }
+        auto it = version->map.find(key);
+        return it != version->map.end() ? it->second.get() : nullptr;
+    }
+
+  private:
+    struct Version : ZegoRcuRetired {
+        Map map;
+    };
+
+    Version *copy() const {
+        Version *version = new Version();
+        Version *current = current_.load(std::memory_order_acquire);
+        if (current != nullptr) {
+            version->map = current->map;
+        }
+        return version;
+    }
+
+    void publish(Version *version) {
+        ZegoRcuDomain::GetInstance()->retire(
+            current_.exchange(version, std::memory_order_acq_rel));
+    }
+
+    std::atomic<Version *> current_{nullptr};
+    std::recursive_mutex write_mutex_;
+};
+
+} // namespace EXPRESS
+} // namespace ZEGO
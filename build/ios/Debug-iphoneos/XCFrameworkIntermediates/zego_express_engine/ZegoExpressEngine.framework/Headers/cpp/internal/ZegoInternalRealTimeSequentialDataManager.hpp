@@ -1,5 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "../ZegoExpressDefines.h"
 #include "../ZegoExpressEventHandler.h"
 #include "../ZegoExpressInterface.h"
@@ -12,6 +20,248 @@ ZEGO_DISABLE_DEPRECATION_WARNINGS
 namespace ZEGO {
 namespace EXPRESS {
 
+// Completion callbacks of sent real-time sequential data, in a fixed array of slots indexed by
+// seq. The SDK only hands out the seq when the send returns and may report the completion before
+// that, even on the sending thread, so a slot moves through FREE -> CLAIMED -> REGISTERED -> FREE
+// on the sender side and either side can find it ahead of the other: a completion that arrives
+// first leaves its error code in the slot (COMPLETED) and the sender delivers it. Each slot's tag
+// packs seq, error code and state into one atomic word, the seq doubling as the generation.
+//
+// Only when more than kSlots sends are in flight does a seq find its slot held by an older one;
+// those fall back to maps under a mutex, which both sides check before giving up on each other.
+// Sends without a callback are registered too, their completion has to be claimed either way. If
+// it never comes, their entries would pile up in the maps, so once the maps grow past kMaxParked
+// entries that have nothing to deliver and early completions kStaleSeqs behind the newest seq are
+// dropped. Entries holding a callback stay until their completion.
+class ZegoRealTimeSequentialDataSentSlab {
+  public:
+    static const unsigned int kSlots = 1024;
+    static const unsigned int kMaxParked = 4 * kSlots;
+    static const unsigned int kStaleSeqs = 16 * kSlots;
+
+    struct Batch {
+        ZegoRealTimeSequentialDataBatchSentCallback callback;
+        std::atomic<unsigned int> remaining{0};
+        std::atomic<unsigned int> failed{0};
+        std::atomic<int> errorCode{0};
+    };
+
+    struct Entry {
+        ZegoRealTimeSequentialDataSentCallback callback;
+        Batch *batch = nullptr;
+    };
+
+    ZegoRealTimeSequentialDataSentSlab() : slots_(new Slot[kSlots]) {
+        // Start every slot with a generation the SDK does not hand out, so seq 0 is not taken for
+        // a duplicate completion
+        for (unsigned int i = 0; i < kSlots; i++) {
+            slots_[i].tag.store(pack(zego_seq(i | 0x80000000u), 0, kFree),
+                                std::memory_order_relaxed);
+        }
+    }
+
+    // Called by the sender with the seq the SDK returned. Returns true, with |entry| handed back
+    // and |errorCode| set, when the completion arrived first and the caller has to deliver it.
+    bool registerSent(zego_seq seq, Entry &entry, int &errorCode) {
+        Slot &slot = slots_[index(seq)];
+        uint64_t tag = slot.tag.load(std::memory_order_acquire);
+        for (;;) {
+            if (seqOf(tag) == seq && stateOf(tag) == kCompleted) {
+                if (!slot.tag.compare_exchange_weak(tag, pack(seq, 0, kFree))) {
+                    continue;
+                }
+                errorCode = errorOf(tag);
+                return true;
+            }
+            // A completion left in the slot for a seq whose sender never came is dropped
+            bool abandoned = stateOf(tag) == kCompleted && stale(seqOf(tag), seq);
+            if (stateOf(tag) != kFree && !abandoned) {
+                return registerOverflow(seq, slot, entry, errorCode);
+            }
+            if (!slot.tag.compare_exchange_weak(tag, pack(seq, 0, kClaimed))) {
+                continue;
+            }
+            slot.entry = std::move(entry);
+            uint64_t claimed = pack(seq, 0, kClaimed);
+            if (!slot.tag.compare_exchange_strong(claimed, pack(seq, 0, kRegistered))) {
+                // Completed while the entry was written
+                entry = takeEntry(slot, seq);
+                errorCode = errorOf(claimed);
+                return true;
+            }
+            if (early_count_.load() > 0) {
+                return takeEarly(seq, slot, entry, errorCode);
+            }
+            return false;
+        }
+    }
+
+    // Called on completion. Returns true with the entry the caller has to deliver.
+    bool complete(zego_seq seq, int errorCode, Entry &entry) {
+        Slot &slot = slots_[index(seq)];
+        uint64_t tag = slot.tag.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t state = stateOf(tag);
+            if (seqOf(tag) == seq) {
+                if (state == kRegistered) {
+                    if (!slot.tag.compare_exchange_weak(tag, pack(seq, 0, kClaimed))) {
+                        continue;
+                    }
+                    entry = takeEntry(slot, seq);
+                    return true;
+                }
+                if (state == kClaimed) {
+                    if (!slot.tag.compare_exchange_weak(tag, pack(seq, errorCode, kCompleted))) {
+                        continue;
+                    }
+                    return false; // The sender delivers it
+                }
+                return false; // Duplicate completion
+            }
+            if (state == kFree) {
+                if (!slot.tag.compare_exchange_weak(tag, pack(seq, errorCode, kCompleted))) {
+                    continue;
+                }
+                // The sender may have found the slot busy and parked the entry in the map
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = overflow_.find(seq);
+                uint64_t completed = pack(seq, errorCode, kCompleted);
+                if (it != overflow_.end() &&
+                    slot.tag.compare_exchange_strong(completed, pack(seq, 0, kFree))) {
+                    entry = std::move(it->second);
+                    overflow_.erase(it);
+                    return true;
+                }
+                return false;
+            }
+
+            // The slot is held by another seq
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = overflow_.find(seq);
+            if (it != overflow_.end()) {
+                entry = std::move(it->second);
+                overflow_.erase(it);
+                return true;
+            }
+            parkLocked(seq);
+            early_[seq] = errorCode;
+            early_count_.fetch_add(1);
+            tag = slot.tag.load();
+            if (seqOf(tag) != seq) {
+                return false; // The sender finds it in early_
+            }
+            // The sender took the slot meanwhile, complete through it instead
+            early_.erase(seq);
+            early_count_.fetch_sub(1);
+        }
+    }
+
+    // Entries and early completions waiting in the maps
+    size_t parkedCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return overflow_.size() + early_.size();
+    }
+
+  private:
+    enum : uint32_t { kFree = 0, kClaimed = 1, kRegistered = 2, kCompleted = 3 };
+
+    struct Slot {
+        std::atomic<uint64_t> tag;
+        Entry entry;
+    };
+
+    static unsigned int index(zego_seq seq) { return uint32_t(seq) & (kSlots - 1); }
+
+    // seq:32 | error code:30 | state:2, error codes are far below 2^30
+    static uint64_t pack(zego_seq seq, int errorCode, uint32_t state) {
+        return (uint64_t(uint32_t(seq)) << 32) |
+               (uint64_t(uint32_t(errorCode) & 0x3FFFFFFFu) << 2) | state;
+    }
+
+    static zego_seq seqOf(uint64_t tag) { return zego_seq(uint32_t(tag >> 32)); }
+
+    static int errorOf(uint64_t tag) { return int((uint32_t(tag) >> 2) & 0x3FFFFFFFu); }
+
+    static uint32_t stateOf(uint64_t tag) { return uint32_t(tag) & 3u; }
+
+    // Moves the entry out of a slot the caller owns and releases the slot
+    static Entry takeEntry(Slot &slot, zego_seq seq) {
+        Entry entry = std::move(slot.entry);
+        slot.entry.callback = nullptr;
+        slot.entry.batch = nullptr;
+        slot.tag.store(pack(seq, 0, kFree), std::memory_order_release);
+        return entry;
+    }
+
+    bool takeEarly(zego_seq seq, Slot &slot, Entry &entry, int &errorCode) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = early_.find(seq);
+        uint64_t registered = pack(seq, 0, kRegistered);
+        if (it == early_.end() ||
+            !slot.tag.compare_exchange_strong(registered, pack(seq, 0, kClaimed))) {
+            return false;
+        }
+        errorCode = it->second;
+        early_.erase(it);
+        early_count_.fetch_sub(1);
+        entry = takeEntry(slot, seq);
+        return true;
+    }
+
+    bool registerOverflow(zego_seq seq, Slot &slot, Entry &entry, int &errorCode) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto early = early_.find(seq);
+        if (early != early_.end()) {
+            errorCode = early->second;
+            early_.erase(early);
+            early_count_.fetch_sub(1);
+            return true;
+        }
+        // The slot may have been freed and completed for this seq since it was found busy
+        uint64_t tag = slot.tag.load(std::memory_order_acquire);
+        if (seqOf(tag) == seq && stateOf(tag) == kCompleted &&
+            slot.tag.compare_exchange_strong(tag, pack(seq, 0, kFree))) {
+            errorCode = errorOf(tag);
+            return true;
+        }
+        parkLocked(seq);
+        overflow_[seq] = std::move(entry);
+        return false;
+    }
+
+    static bool stale(zego_seq seq, zego_seq newest) {
+        return int32_t(uint32_t(newest) - uint32_t(seq)) > int32_t(kStaleSeqs);
+    }
+
+    // Called under mutex_ before |seq| is parked. Sweeps when the maps reached the next threshold,
+    // which doubles with what the sweep had to keep so a map of callbacks is not swept every time.
+    void parkLocked(zego_seq seq) {
+        if (overflow_.size() + early_.size() < sweep_at_) {
+            return;
+        }
+        for (auto it = overflow_.begin(); it != overflow_.end();) {
+            bool empty = !it->second.callback && it->second.batch == nullptr;
+            it = empty && stale(it->first, seq) ? overflow_.erase(it) : std::next(it);
+        }
+        for (auto it = early_.begin(); it != early_.end();) {
+            if (stale(it->first, seq)) {
+                it = early_.erase(it);
+                early_count_.fetch_sub(1);
+            } else {
+                ++it;
+            }
+        }
+        sweep_at_ = std::max<size_t>(kMaxParked, 2 * (overflow_.size() + early_.size()));
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    std::mutex mutex_;
+    std::unordered_map<zego_seq, Entry> overflow_;
+    std::unordered_map<zego_seq, int> early_;
+    std::atomic<int> early_count_{0};
+    size_t sweep_at_ = kMaxParked;
+};
+
 class ZegoExpressRealTimeSequentialDataManagerImp : public IZegoRealTimeSequentialDataManager {
   public:
     ZegoExpressRealTimeSequentialDataManagerImp(int index) : instance_index_(index) {}
@@ -37,9 +287,42 @@ class ZegoExpressRealTimeSequentialDataManagerImp : public IZegoRealTimeSequenti
                                     ZegoRealTimeSequentialDataSentCallback callback) override {
         int seq = oInternalOriginBridge->realTimeSequentialDataSendData(
             data, dataLength, streamID.c_str(), instance_index_);
-        if (callback != nullptr) {
-            std::lock_guard<std::mutex> lock(event_handler_mutex_);
-            data_sent_callbacks_.insert({seq, callback});
+        // Registered even without a callback, so that an early completion is always claimed
+        ZegoRealTimeSequentialDataSentSlab::Entry entry;
+        entry.callback = std::move(callback);
+        // Without the send function in the library no completion comes, the send fails right here
+        int errorCode = ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND;
+        if (seq == ZEGOEXP_MISSING_SEQ || data_sent_slab_.registerSent(seq, entry, errorCode)) {
+            zego_on_real_time_sequential_data_sent(entry, errorCode);
+        }
+    }
+
+    void sendRealTimeSequentialDataBatch(
+        const ZegoRealTimeSequentialDataMessage *messages, unsigned int count,
+        const std::string &streamID,
+        ZegoRealTimeSequentialDataBatchSentCallback callback) override {
+        if (count == 0) {
+            ZEGO_SWITCH_THREAD_PRE_STATIC
+            if (callback) {
+                callback(0, 0);
+            }
+            ZEGO_SWITCH_THREAD_ING
+            return;
+        }
+        auto batch = new ZegoRealTimeSequentialDataSentSlab::Batch();
+        batch->callback = std::move(callback);
+        // Set before the first send, completions may arrive while the batch is still being sent
+        batch->remaining.store(count, std::memory_order_relaxed);
+        const char *stream_id = streamID.c_str();
+        for (unsigned int i = 0; i < count; i++) {
+            int seq = oInternalOriginBridge->realTimeSequentialDataSendData(
+                messages[i].data, messages[i].dataLength, stream_id, instance_index_);
+            ZegoRealTimeSequentialDataSentSlab::Entry entry;
+            entry.batch = batch;
+            int errorCode = ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND;
+            if (seq == ZEGOEXP_MISSING_SEQ || data_sent_slab_.registerSent(seq, entry, errorCode)) {
+                zego_on_real_time_sequential_data_sent(entry, errorCode);
+            }
         }
     }
 
@@ -58,36 +341,62 @@ class ZegoExpressRealTimeSequentialDataManagerImp : public IZegoRealTimeSequenti
     void zego_on_receive_real_time_sequential_data(const unsigned char *data,
                                                    unsigned int data_length,
                                                    const char *stream_id) {
-        std::lock_guard<std::mutex> lock(event_handler_mutex_);
-        if (event_handler_) {
-            auto weak_event_handler =
-                std::weak_ptr<IZegoRealTimeSequentialDataEventHandler>(event_handler_);
-
+        std::shared_ptr<IZegoRealTimeSequentialDataEventHandler> handler;
+        {
+            std::lock_guard<std::mutex> lock(event_handler_mutex_);
+            handler = event_handler_;
+        }
+        if (handler) {
             std::string streamID = stream_id;
-            std::string buffer((const char *)data, data_length);
-
-            auto handler_in_main = weak_event_handler.lock();
-            if (handler_in_main) {
-                handler_in_main->onReceiveRealTimeSequentialData(
-                    this, (const unsigned char *)buffer.data(), ZegoUInt(buffer.size()), streamID);
-            }
+            ZegoPayloadRef payload = ZegoPayloadRef::copyFrom(data, data_length);
+            handler->onReceiveRealTimeSequentialData(this, payload.data(), payload.size(),
+                                                     streamID);
+            handler->onReceiveRealTimeSequentialDataPayload(this, payload, streamID);
         }
     }
 
     void zego_on_real_time_sequential_data_sent(zego_error error_code, zego_seq seq) {
-        std::lock_guard<std::mutex> lock(event_handler_mutex_);
-        if (data_sent_callbacks_.count(seq) > 0) {
-            auto cb = data_sent_callbacks_[seq];
-            data_sent_callbacks_.erase(seq);
-            ZEGO_SWITCH_THREAD_PRE
-            cb(error_code);
-            ZEGO_SWITCH_THREAD_ING
+        ZegoRealTimeSequentialDataSentSlab::Entry entry;
+        if (data_sent_slab_.complete(seq, error_code, entry)) {
+            zego_on_real_time_sequential_data_sent(entry, error_code);
         }
     }
 
   private:
+    static void
+    zego_on_real_time_sequential_data_sent(ZegoRealTimeSequentialDataSentSlab::Entry &entry,
+                                           int error_code) {
+        if (entry.callback) {
+            auto callback = std::move(entry.callback);
+            ZEGO_SWITCH_THREAD_PRE_STATIC
+            callback(error_code);
+            ZEGO_SWITCH_THREAD_ING
+        }
+        auto batch = entry.batch;
+        if (batch == nullptr) {
+            return;
+        }
+        if (error_code != 0) {
+            batch->failed.fetch_add(1, std::memory_order_relaxed);
+            int none = 0;
+            batch->errorCode.compare_exchange_strong(none, error_code, std::memory_order_relaxed);
+        }
+        // The last completion of the batch reports it
+        if (batch->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            auto callback = std::move(batch->callback);
+            int errorCode = batch->errorCode.load(std::memory_order_relaxed);
+            unsigned int failedCount = batch->failed.load(std::memory_order_relaxed);
+            delete batch;
+            if (callback) {
+                ZEGO_SWITCH_THREAD_PRE_STATIC
+                callback(errorCode, failedCount);
+                ZEGO_SWITCH_THREAD_ING
+            }
+        }
+    }
+
     std::shared_ptr<IZegoRealTimeSequentialDataEventHandler> event_handler_;
-    std::unordered_map<zego_seq, ZegoRealTimeSequentialDataSentCallback> data_sent_callbacks_;
+    ZegoRealTimeSequentialDataSentSlab data_sent_slab_;
     std::mutex event_handler_mutex_;
     int instance_index_ = -1;
 };
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../ZegoExpressDefines.h"
+#include "ZegoInternalBridge.h"
+
+namespace ZEGO {
+namespace EXPRESS {
+
+// Maps stream IDs to small integer handles, at most `capacity` at a time. A handle stays valid
+// until its stream is released, then it goes to a free list and is reused by a later stream, so
+// the UI can index fixed per-stream arrays with them.
+class ZegoStreamIDInterner {
+  public:
+    explicit ZegoStreamIDInterner(unsigned int capacity) : capacity_(capacity) {}
+
+    ZegoStreamHandle intern(const char *streamID) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return internLocked(streamID);
+    }
+
+    // Interns and takes a reference, the handle is kept until every reference is released
+    ZegoStreamHandle retain(const char *streamID) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ZegoStreamHandle handle = internLocked(streamID);
+        if (handle != ZEGO_STREAM_HANDLE_INVALID) {
+            refs_[handle]++;
+        }
+        return handle;
+    }
+
+    // Drops a reference, or frees the handle right away if it was only interned by an update
+    void release(const char *streamID) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        releaseLocked(findLocked(streamID, hash(streamID)));
+    }
+
+    void release(ZegoStreamHandle handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        releaseLocked(handle);
+    }
+
+    ZegoStreamHandle find(const char *streamID) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return findLocked(streamID, hash(streamID));
+    }
+
+    std::string name(ZegoStreamHandle handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return handle < names_.size() ? names_[handle] : std::string();
+    }
+
+    // Stream IDs turned away because `capacity` handles were in use, read without the lock
+    unsigned long long overflowCount() const { return overflow_.load(std::memory_order_relaxed); }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names_.clear();
+        hashes_.clear();
+        refs_.clear();
+        free_.clear();
+        slots_.clear();
+        overflow_.store(0, std::memory_order_relaxed);
+    }
+
+    // Callers hold the lock across a whole sound level tick instead of once per stream
+    std::mutex &mutex() { return mutex_; }
+
+    ZegoStreamHandle internLocked(const char *streamID) {
+        if (streamID == nullptr || *streamID == '\0') {
+            return ZEGO_STREAM_HANDLE_INVALID;
+        }
+        size_t h = hash(streamID);
+        ZegoStreamHandle handle = findLocked(streamID, h);
+        if (handle != ZEGO_STREAM_HANDLE_INVALID) {
+            return handle;
+        }
+        if (!free_.empty()) {
+            handle = free_.back();
+            free_.pop_back();
+            names_[handle] = streamID;
+            hashes_[handle] = h;
+            refs_[handle] = 0;
+        } else if (names_.size() < capacity_) {
+            if ((names_.size() + 1) * 2 > slots_.size()) {
+                rehash(slots_.empty() ? 64 : slots_.size() * 2);
+            }
+            handle = ZegoStreamHandle(names_.size());
+            names_.push_back(streamID);
+            hashes_.push_back(h);
+            refs_.push_back(0);
+        } else {
+            overflow_.fetch_add(1, std::memory_order_relaxed);
+            return ZEGO_STREAM_HANDLE_INVALID;
+        }
+        insertSlot(handle, h);
+        return handle;
+    }
+
+  private:
+    static size_t hash(const char *s) {
+        // FNV-1a, no std::string construction on the lookup path
+        size_t h = static_cast<size_t>(14695981039346656037ULL);
+        for (; *s; ++s) {
+            h ^= static_cast<unsigned char>(*s);
+            h *= static_cast<size_t>(1099511628211ULL);
+        }
+        return h;
+    }
+
+    ZegoStreamHandle findLocked(const char *streamID, size_t h) {
+        if (slots_.empty()) {
+            return ZEGO_STREAM_HANDLE_INVALID;
+        }
+        size_t mask = slots_.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            unsigned int slot = slots_[i];
+            if (slot == 0) {
+                return ZEGO_STREAM_HANDLE_INVALID;
+            }
+            if (hashes_[slot - 1] == h && names_[slot - 1] == streamID) {
+                return slot - 1;
+            }
+        }
+    }
+
+    void releaseLocked(ZegoStreamHandle handle) {
+        if (handle >= names_.size() || names_[handle].empty()) {
+            return;
+        }
+        if (refs_[handle] > 1) {
+            refs_[handle]--;
+            return;
+        }
+        names_[handle].clear();
+        refs_[handle] = 0;
+        free_.push_back(handle);
+        // Linear probing has no cheap delete, streams leave rarely enough to rebuild
+        rehash(slots_.size());
+    }
+
+    void insertSlot(ZegoStreamHandle handle, size_t h) {
+        size_t mask = slots_.size() - 1;
+        size_t i = h & mask;
+        while (slots_[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        slots_[i] = handle + 1;
+    }
+
+    void rehash(size_t capacity) {
+        slots_.assign(capacity, 0);
+        for (size_t i = 0; i < names_.size(); i++) {
+            if (!names_[i].empty()) {
+                insertSlot(ZegoStreamHandle(i), hashes_[i]);
+            }
+        }
+    }
+
+    const unsigned int capacity_;
+    std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::vector<size_t> hashes_;
+    std::vector<unsigned int> refs_;
+    std::vector<ZegoStreamHandle> free_;
+    std::vector<unsigned int> slots_;
+    std::atomic<unsigned long long> overflow_{0};
+};
+
+// Opt-in struct-of-arrays store for remote sound levels, VAD flags, spectra and mixer sound
+// levels. Each section is double buffered behind a sequence counter: the SDK thread writes the
+// back buffer and flips, readers copy the front buffer and retry if it changed under them. The
+// values are relaxed atomics, so a reader racing a writer sees torn data it then discards rather
+// than a data race.
+class ZegoExpressSoundLevelTable {
+  public:
+    static const unsigned int kMaxStreams = 512;
+    static const unsigned int kMaxSpectrumBins = 64;
+    static const unsigned int kMaxMixerEntries = 64;
+
+    static ZegoExpressSoundLevelTable *GetInstance() {
+        static ZegoExpressSoundLevelTable oInstance;
+        return &oInstance;
+    }
+
+    bool isEnabled() { return enabled_.load(std::memory_order_acquire); }
+
+    void enable(bool enable) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (enable && !allocated_) {
+            for (int i = 0; i < 2; i++) {
+                levels_.slot[i].levels.reset(new std::atomic<float>[kMaxStreams]());
+                levels_.slot[i].vad.reset(new std::atomic<int>[kMaxStreams]());
+                spectrums_.slot[i].bins.reset(
+                    new std::atomic<float>[kMaxStreams * kMaxSpectrumBins]());
+                mixer_.slot[i].ids.reset(new std::atomic<unsigned int>[kMaxMixerEntries]());
+                mixer_.slot[i].levels.reset(new std::atomic<float>[kMaxMixerEntries]());
+            }
+            allocated_ = true;
+        }
+        enabled_.store(enable, std::memory_order_release);
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        interner_.reset();
+    }
+
+    ZegoStreamHandle intern(const char *streamID) { return interner_.intern(streamID); }
+
+    ZegoStreamHandle retain(const char *streamID) { return interner_.retain(streamID); }
+
+    void release(const char *streamID) { interner_.release(streamID); }
+
+    void release(ZegoStreamHandle handle) { interner_.release(handle); }
+
+    ZegoStreamHandle find(const char *streamID) { return interner_.find(streamID); }
+
+    std::string streamID(ZegoStreamHandle handle) { return interner_.name(handle); }
+
+    void updateSoundLevels(const zego_sound_level_info *infoList, unsigned int count,
+                           bool withVad) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::lock_guard<std::mutex> internLock(interner_.mutex());
+        publish(levels_, [&](LevelSection &section) {
+            // Everything past a slot's `used` is already 0, so only what it last held is cleared
+            unsigned int used = 0;
+            unsigned int cleared = section.used.load(std::memory_order_relaxed);
+            fill(section.levels.get(), cleared, 0.0f);
+            fill(section.vad.get(), cleared, 0);
+            for (unsigned int i = 0; i < count; i++) {
+                ZegoStreamHandle handle = interner_.internLocked(infoList[i].stream_id);
+                if (handle == ZEGO_STREAM_HANDLE_INVALID) {
+                    continue;
+                }
+                section.levels[handle].store(infoList[i].sound_level, std::memory_order_relaxed);
+                section.vad[handle].store(withVad ? infoList[i].vad : 0,
+                                          std::memory_order_relaxed);
+                used = handle + 1 > used ? handle + 1 : used;
+            }
+            return used;
+        });
+    }
+
+    void updateSpectrums(const zego_audio_spectrum_info *infoList, unsigned int count) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::lock_guard<std::mutex> internLock(interner_.mutex());
+        publish(spectrums_, [&](SpectrumSection &section) {
+            unsigned int used = 0;
+            unsigned int cleared = section.used.load(std::memory_order_relaxed);
+            fill(section.bins.get(), cleared * kMaxSpectrumBins, 0.0f);
+            for (unsigned int i = 0; i < count; i++) {
+                ZegoStreamHandle handle = interner_.internLocked(infoList[i].stream_id);
+                if (handle == ZEGO_STREAM_HANDLE_INVALID) {
+                    continue;
+                }
+                unsigned int bins = infoList[i].spectrum_count < kMaxSpectrumBins
+                                        ? infoList[i].spectrum_count
+                                        : kMaxSpectrumBins;
+                if (infoList[i].spectrum_list) {
+                    std::atomic<float> *dst = &section.bins[handle * kMaxSpectrumBins];
+                    for (unsigned int bin = 0; bin < bins; bin++) {
+                        dst[bin].store(infoList[i].spectrum_list[bin], std::memory_order_relaxed);
+                    }
+                }
+                used = handle + 1 > used ? handle + 1 : used;
+            }
+            return used;
+        });
+    }
+
+    void updateMixerSoundLevels(const zego_mixer_sound_level_info *infoList, unsigned int count) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        publish(mixer_, [&](MixerSection &section) {
+            unsigned int used = count < kMaxMixerEntries ? count : kMaxMixerEntries;
+            for (unsigned int i = 0; i < used; i++) {
+                section.ids[i].store(infoList[i].sound_level_id, std::memory_order_relaxed);
+                section.levels[i].store(infoList[i].sound_level, std::memory_order_relaxed);
+            }
+            return used;
+        });
+    }
+
+    void read(ZegoSoundLevelSnapshot &snapshot) {
+        if (!allocated_) {
+            return;
+        }
+        snapshot.overflowCount = interner_.overflowCount();
+        // The snapshot's vectors are sized for a full table once and reused from then on
+        snapshot.sequence = consume(levels_, [&](const LevelSection &section, unsigned int used) {
+            copy(snapshot.soundLevels, section.levels.get(), used, kMaxStreams);
+            copy(snapshot.vad, section.vad.get(), used, kMaxStreams);
+        });
+        snapshot.spectrumStride = kMaxSpectrumBins;
+        snapshot.spectrumSequence =
+            consume(spectrums_, [&](const SpectrumSection &section, unsigned int used) {
+                copy(snapshot.spectrums, section.bins.get(), used * kMaxSpectrumBins,
+                     kMaxStreams * kMaxSpectrumBins);
+            });
+        snapshot.mixerSequence = consume(mixer_, [&](const MixerSection &section, unsigned int used) {
+            copy(snapshot.mixerSoundLevelIDs, section.ids.get(), used, kMaxMixerEntries);
+            copy(snapshot.mixerSoundLevels, section.levels.get(), used, kMaxMixerEntries);
+        });
+    }
+
+  private:
+    struct SectionBase {
+        std::atomic<unsigned long long> sequence{0};
+        std::atomic<unsigned int> used{0};
+    };
+
+    struct LevelSection : SectionBase {
+        std::unique_ptr<std::atomic<float>[]> levels;
+        std::unique_ptr<std::atomic<int>[]> vad;
+    };
+
+    struct SpectrumSection : SectionBase {
+        std::unique_ptr<std::atomic<float>[]> bins;
+    };
+
+    struct MixerSection : SectionBase {
+        std::unique_ptr<std::atomic<unsigned int>[]> ids;
+        std::unique_ptr<std::atomic<float>[]> levels;
+    };
+
+    template <typename T> static void fill(std::atomic<T> *dst, unsigned int count, T value) {
+        for (unsigned int i = 0; i < count; i++) {
+            dst[i].store(value, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    static void copy(std::vector<T> &dst, const std::atomic<T> *src, unsigned int count,
+                     unsigned int capacity) {
+        if (dst.capacity() < capacity) {
+            dst.reserve(capacity);
+        }
+        dst.resize(count);
+        for (unsigned int i = 0; i < count; i++) {
+            dst[i] = src[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    template <typename Section> struct DoubleBuffer {
+        Section slot[2];
+        std::atomic<int> front{0};
+        unsigned long long generation = 0;
+    };
+
+    // Writer side, serialized by write_mutex_. The sequence is odd while the slot is written.
+    template <typename Section, typename Writer>
+    void publish(DoubleBuffer<Section> &buffer, Writer writer) {
+        if (!allocated_) {
+            return;
+        }
+        int back = 1 - buffer.front.load(std::memory_order_relaxed);
+        Section &section = buffer.slot[back];
+        section.sequence.store(buffer.generation * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        section.used.store(writer(section), std::memory_order_relaxed);
+        buffer.generation++;
+        section.sequence.store(buffer.generation * 2, std::memory_order_release);
+        buffer.front.store(back, std::memory_order_release);
+    }
+
+    // Reader side, lock-free. Returns the generation that was copied.
+    template <typename Section, typename Reader>
+    unsigned long long consume(const DoubleBuffer<Section> &buffer, Reader reader) {
+        while (true) {
+            const Section &section = buffer.slot[buffer.front.load(std::memory_order_acquire)];
+            unsigned long long before = section.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            reader(section, section.used.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (section.sequence.load(std::memory_order_relaxed) == before) {
+                return before / 2;
+            }
+        }
+    }
+
+    ZegoExpressSoundLevelTable() : interner_(kMaxStreams) {}
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> allocated_{false};
+    std::mutex write_mutex_;
+    ZegoStreamIDInterner interner_;
+    DoubleBuffer<LevelSection> levels_;
+    DoubleBuffer<SpectrumSection> spectrums_;
+    DoubleBuffer<MixerSection> mixer_;
+};
+#define oInternalSoundLevelTable ZegoExpressSoundLevelTable::GetInstance()
+
+} // namespace EXPRESS
+} // namespace ZEGO
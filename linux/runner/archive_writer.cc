@@ -0,0 +1,300 @@
+#include "archive_writer.h"
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace call_archive {
+
+uint8_t* AllocateBlocks(size_t bytes) {
+  const size_t size = (bytes + kBlockSize - 1) / kBlockSize * kBlockSize;
+  void* blocks = nullptr;
+  if (posix_memalign(&blocks, kBlockSize, size) != 0) {
+    return nullptr;
+  }
+  return static_cast<uint8_t*>(blocks);
+}
+
+void FreeBlocks(uint8_t* blocks) {
+  free(blocks);
+}
+
+namespace {
+
+void Signal(int event_fd) {
+  const uint64_t one = 1;
+  ssize_t unused = write(event_fd, &one, sizeof(one));
+  (void)unused;
+}
+
+// Submits IORING_OP_WRITE through the raw system calls, so the runner needs
+// neither liburing nor anything newer than the kernel headers. The eventfd
+// registered with the ring fires on every completion.
+class UringWriter : public BlockWriter {
+ public:
+  ~UringWriter() override {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+      close(ring_fd_);
+    }
+    if (event_fd_ >= 0) {
+      close(event_fd_);
+    }
+  }
+
+  bool Init(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring_fd_ < 0) {
+      return false;
+    }
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = Map(sq_ring_size_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == nullptr) {
+      return false;
+    }
+    cq_ring_ = single_mmap ? sq_ring_ : Map(cq_ring_size_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == nullptr) {
+      return false;
+    }
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = static_cast<struct io_uring_sqe*>(Map(sqes_size_, IORING_OFF_SQES));
+    if (sqes_ == nullptr) {
+      return false;
+    }
+
+    uint8_t* sq = static_cast<uint8_t*>(sq_ring_);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    uint8_t* cq = static_cast<uint8_t*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+    capacity_ = params.sq_entries;
+
+    event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (event_fd_ < 0 ||
+        syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) < 0) {
+      return false;
+    }
+    return SupportsWrite();
+  }
+
+  const char* name() const override { return "io_uring"; }
+  int event_fd() const override { return event_fd_; }
+  size_t in_flight() const override { return in_flight_; }
+
+  bool Submit(int fd, const uint8_t* data, size_t size, uint64_t offset,
+              void* cookie) override {
+    if (in_flight_ >= capacity_) {
+      return false;
+    }
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = static_cast<uint32_t>(size);
+    sqe->off = offset;
+    sqe->user_data = reinterpret_cast<uint64_t>(cookie);
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    if (syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0) < 0) {
+      // Take the entry back; the kernel has not consumed it.
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+      return false;
+    }
+    in_flight_++;
+    return true;
+  }
+
+  size_t Reap(std::vector<Completion>* completions) override {
+    unsigned head = *cq_head_;
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    size_t count = 0;
+    for (; head != tail; head++, count++) {
+      const struct io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      completions->push_back({reinterpret_cast<void*>(cqe.user_data), cqe.res});
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    in_flight_ -= count;
+    return count;
+  }
+
+ private:
+  void* Map(size_t size, off_t offset) {
+    void* ring =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, offset);
+    return ring == MAP_FAILED ? nullptr : ring;
+  }
+
+  // IORING_OP_WRITE needs Linux 5.6, the same release as the probe itself.
+  bool SupportsWrite() {
+    const size_t size =
+        sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[size]());
+    struct io_uring_probe* probe = reinterpret_cast<struct io_uring_probe*>(buffer.get());
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe,
+                IORING_OP_LAST) < 0) {
+      return false;
+    }
+    return probe->last_op >= IORING_OP_WRITE &&
+           (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED) != 0;
+  }
+
+  int ring_fd_ = -1;
+  int event_fd_ = -1;
+  void* sq_ring_ = nullptr;
+  void* cq_ring_ = nullptr;
+  size_t sq_ring_size_ = 0;
+  size_t cq_ring_size_ = 0;
+  struct io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  unsigned* sq_tail_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  struct io_uring_cqe* cqes_ = nullptr;
+  size_t capacity_ = 0;
+  size_t in_flight_ = 0;
+};
+
+// Fallback for kernels or sandboxes without io_uring: one thread issuing
+// pwrite() in submission order.
+class ThreadWriter : public BlockWriter {
+ public:
+  explicit ThreadWriter(unsigned queue_depth)
+      : capacity_(queue_depth), event_fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    thread_ = std::thread(&ThreadWriter::Run, this);
+  }
+
+  ~ThreadWriter() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+    close(event_fd_);
+  }
+
+  const char* name() const override { return "thread"; }
+  int event_fd() const override { return event_fd_; }
+  size_t in_flight() const override { return in_flight_; }
+
+  bool Submit(int fd, const uint8_t* data, size_t size, uint64_t offset,
+              void* cookie) override {
+    if (in_flight_ >= capacity_) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back({fd, data, size, offset, cookie});
+    }
+    wakeup_.notify_one();
+    in_flight_++;
+    return true;
+  }
+
+  size_t Reap(std::vector<Completion>* completions) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t count = done_.size();
+    completions->insert(completions->end(), done_.begin(), done_.end());
+    done_.clear();
+    in_flight_ -= count;
+    return count;
+  }
+
+ private:
+  struct Request {
+    int fd;
+    const uint8_t* data;
+    size_t size;
+    uint64_t offset;
+    void* cookie;
+  };
+
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wakeup_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      Request request = queue_.front();
+      queue_.pop_front();
+      lock.unlock();
+      int64_t result = 0;
+      while (static_cast<size_t>(result) < request.size) {
+        ssize_t written = pwrite(request.fd, request.data + result, request.size - result,
+                                 request.offset + result);
+        if (written < 0 && errno == EINTR) {
+          continue;
+        }
+        if (written <= 0) {
+          result = written < 0 ? -errno : -EIO;
+          break;
+        }
+        result += written;
+      }
+      lock.lock();
+      done_.push_back({request.cookie, result});
+      Signal(event_fd_);
+    }
+  }
+
+  const size_t capacity_;
+  const int event_fd_;
+  size_t in_flight_ = 0;  // owner thread only
+  std::mutex mutex_;
+  std::condition_variable wakeup_;
+  std::deque<Request> queue_;
+  std::vector<Completion> done_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace
+
+std::unique_ptr<BlockWriter> BlockWriter::Create(bool prefer_io_uring, unsigned queue_depth) {
+  if (prefer_io_uring) {
+    std::unique_ptr<UringWriter> writer(new UringWriter());
+    if (writer->Init(queue_depth)) {
+      return std::unique_ptr<BlockWriter>(writer.release());
+    }
+  }
+  return std::unique_ptr<BlockWriter>(new ThreadWriter(queue_depth));
+}
+
+}  // namespace call_archive
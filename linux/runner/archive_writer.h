@@ -0,0 +1,52 @@
+#ifndef FLUTTER_ARCHIVE_WRITER_H_
+#define FLUTTER_ARCHIVE_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace call_archive {
+
+// Alignment of every buffer, size and offset handed to a BlockWriter, so the
+// files can be opened with O_DIRECT.
+constexpr size_t kBlockSize = 4096;
+
+// Buffers aligned to kBlockSize. |bytes| is rounded up to a whole block.
+uint8_t* AllocateBlocks(size_t bytes);
+void FreeBlocks(uint8_t* blocks);
+
+// Positional writes that complete asynchronously. Submit() and Reap() must be
+// called from one thread; completions are signalled on event_fd() so that
+// thread can poll() it next to its own wakeups instead of blocking on disk.
+class BlockWriter {
+ public:
+  struct Completion {
+    void* cookie;
+    int64_t result;  // bytes written, or -errno
+  };
+
+  // io_uring when |prefer_io_uring| and the kernel allows it, otherwise a
+  // writer thread doing pwrite(). |queue_depth| bounds the writes in flight.
+  static std::unique_ptr<BlockWriter> Create(bool prefer_io_uring, unsigned queue_depth);
+
+  virtual ~BlockWriter() = default;
+
+  virtual const char* name() const = 0;
+  virtual int event_fd() const = 0;
+  virtual size_t in_flight() const = 0;
+
+  // Queues a write of |size| bytes from |data| at |offset| of |fd|. |data|
+  // must stay valid until its completion is reaped. Returns false when the
+  // queue is full; nothing is submitted then.
+  virtual bool Submit(int fd, const uint8_t* data, size_t size, uint64_t offset,
+                      void* cookie) = 0;
+
+  // Appends finished writes to |completions| without waiting. Returns how
+  // many were added.
+  virtual size_t Reap(std::vector<Completion>* completions) = 0;
+};
+
+}  // namespace call_archive
+
+#endif  // FLUTTER_ARCHIVE_WRITER_H_
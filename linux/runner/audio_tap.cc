@@ -0,0 +1,405 @@
+#include "audio_tap.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+namespace audio_tap {
+
+namespace {
+
+// Zego stream IDs are at most 256 bytes. Player slots reserve that much up
+// front so claiming one on the audio thread never allocates.
+constexpr size_t kMaxStreamIdLength = 256;
+
+constexpr int kDefaultSampleRate = 48000;
+constexpr int kDefaultChannels = 2;
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 2;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32 bit integer");
+
+void FutexWait(std::atomic<uint32_t>* word, uint32_t expected, int64_t timeout_us) {
+  struct timespec timeout;
+  timeout.tv_sec = static_cast<time_t>(timeout_us / 1000000);
+  timeout.tv_nsec = static_cast<long>(timeout_us % 1000000) * 1000;
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected,
+          &timeout, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, 1, nullptr,
+          nullptr, 0);
+}
+
+}  // namespace
+
+struct SlotHeader {
+  uint32_t bytes;
+  int32_t sample_rate;
+  int32_t channels;
+  int64_t timestamp_us;
+  uint64_t sequence;
+};
+
+// Single-producer single-consumer ring of fixed size PCM slots. The producer
+// only writes |head_| and the consumer only writes |tail_|; each keeps a
+// cached copy of the other's index and only reloads it when the ring looks
+// full or empty.
+class PcmRing {
+ public:
+  PcmRing(size_t slot_count, size_t slot_bytes)
+      : mask_(slot_count - 1),
+        slot_bytes_(slot_bytes),
+        data_(new uint8_t[slot_count * slot_bytes]),
+        headers_(new SlotHeader[slot_count]) {}
+
+  // Producer. Returns false if the ring is full and the frame was dropped.
+  bool Push(const uint8_t* data, size_t bytes, int sample_rate, int channels,
+            int64_t timestamp_us) {
+    const uint64_t sequence = frames_.load(std::memory_order_relaxed);
+    frames_.store(sequence + 1, std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - producer_tail_ > mask_) {
+      producer_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - producer_tail_ > mask_) {
+        overruns_.store(overruns_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+        return false;
+      }
+    }
+    if (bytes > slot_bytes_) {
+      bytes = slot_bytes_;
+      truncated_.store(truncated_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    }
+    const size_t index = head & mask_;
+    memcpy(data_.get() + index * slot_bytes_, data, bytes);
+    headers_[index] = {static_cast<uint32_t>(bytes), sample_rate, channels, timestamp_us,
+                       sequence};
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer. The oldest queued frame, or nullptr if the ring is empty.
+  const SlotHeader* Front() {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == consumer_head_) {
+      consumer_head_ = head_.load(std::memory_order_acquire);
+      if (tail == consumer_head_) {
+        return nullptr;
+      }
+    }
+    return &headers_[tail & mask_];
+  }
+
+  // Consumer. Copies the frame returned by Front() out and frees its slot.
+  void Pop(AudioFrame* frame) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t index = tail & mask_;
+    const SlotHeader& header = headers_[index];
+    frame->sample_rate = header.sample_rate;
+    frame->channels = header.channels;
+    frame->timestamp_us = header.timestamp_us;
+    frame->sequence = header.sequence;
+    frame->samples.resize(header.bytes / sizeof(int16_t));
+    memcpy(frame->samples.data(), data_.get() + index * slot_bytes_,
+           frame->samples.size() * sizeof(int16_t));
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+
+  uint64_t pending() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  uint64_t frames() const { return frames_.load(std::memory_order_relaxed); }
+  uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+  uint64_t truncated() const { return truncated_.load(std::memory_order_relaxed); }
+
+  // Empties the ring and its counters. Neither side may be using it.
+  void Reset() {
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    producer_tail_ = 0;
+    consumer_head_ = 0;
+    frames_.store(0, std::memory_order_relaxed);
+    overruns_.store(0, std::memory_order_relaxed);
+    truncated_.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  const uint64_t mask_;
+  const size_t slot_bytes_;
+  std::unique_ptr<uint8_t[]> data_;
+  std::unique_ptr<SlotHeader[]> headers_;
+
+  // Producer side. The counters are only written by the producer; they are
+  // atomic so stats can be read from the consumer.
+  std::atomic<uint64_t> head_{0};
+  uint64_t producer_tail_ = 0;
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> overruns_{0};
+  std::atomic<uint64_t> truncated_{0};
+
+  // Consumer side.
+  std::atomic<uint64_t> tail_{0};
+  uint64_t consumer_head_ = 0;
+};
+
+// A player ring and the stream it is bound to. |stream_id| only changes while
+// the slot is kClaiming, and the consumer only hands a slot back to kFree
+// after it has seen |writers| drop to zero with the slot already kClosing, so
+// a callback that checks the state after raising |writers| can read the ID
+// without a lock.
+struct AudioTap::PlayerSlot {
+  enum State { kFree, kClaiming, kOpen, kClosing };
+
+  std::atomic<int> state{kFree};
+  std::atomic<int> writers{0};
+  std::string stream_id;
+  std::unique_ptr<PcmRing> ring;
+};
+
+AudioTap::AudioTap(const Options& options)
+    : options_(options),
+      player_count_((options.sources & kPlayer) ? options.max_player_streams : 0) {
+  int sample_rate = kDefaultSampleRate;
+  int channels = kDefaultChannels;
+  if (options.param.sampleRate != ZEGO::EXPRESS::ZEGO_AUDIO_SAMPLE_RATE_UNKNOWN) {
+    sample_rate = static_cast<int>(options.param.sampleRate);
+    channels = options.param.channel == ZEGO::EXPRESS::ZEGO_AUDIO_CHANNEL_STEREO ? 2 : 1;
+  }
+  const size_t slot_bytes = static_cast<size_t>(sample_rate) * channels * sizeof(int16_t) *
+                            options.max_frame_ms / 1000;
+  const size_t slot_count = RoundUpToPowerOfTwo(options.buffer_ms / 10);
+
+  const Source fixed[] = {kCaptured, kPlayback, kMixed};
+  for (int i = 0; i < 3; i++) {
+    if (options.sources & fixed[i]) {
+      rings_[i].reset(new PcmRing(slot_count, slot_bytes));
+    }
+  }
+  players_.reset(new PlayerSlot[player_count_]);
+  for (int i = 0; i < player_count_; i++) {
+    players_[i].stream_id.reserve(kMaxStreamIdLength);
+    players_[i].ring.reset(new PcmRing(slot_count, slot_bytes));
+  }
+}
+
+AudioTap::~AudioTap() = default;
+
+void AudioTap::Start(ZEGO::EXPRESS::IZegoExpressEngine* engine) {
+  engine->setAudioDataHandler(shared_from_this());
+  engine->startAudioDataObserver(options_.sources, options_.param);
+}
+
+void AudioTap::Stop(ZEGO::EXPRESS::IZegoExpressEngine* engine) {
+  engine->stopAudioDataObserver();
+  engine->setAudioDataHandler(nullptr);
+}
+
+void AudioTap::onCapturedAudioData(const unsigned char* data, unsigned int data_length,
+                                   ZEGO::EXPRESS::ZegoAudioFrameParam param) {
+  Push(rings_[0].get(), data, data_length, param);
+}
+
+void AudioTap::onPlaybackAudioData(const unsigned char* data, unsigned int data_length,
+                                   ZEGO::EXPRESS::ZegoAudioFrameParam param) {
+  Push(rings_[1].get(), data, data_length, param);
+}
+
+void AudioTap::onMixedAudioData(const unsigned char* data, unsigned int data_length,
+                                ZEGO::EXPRESS::ZegoAudioFrameParam param) {
+  Push(rings_[2].get(), data, data_length, param);
+}
+
+void AudioTap::onPlayerAudioData(const unsigned char* data, unsigned int data_length,
+                                 ZEGO::EXPRESS::ZegoAudioFrameParam param,
+                                 const std::string& stream_id) {
+  for (int i = 0; i < player_count_; i++) {
+    PlayerSlot& slot = players_[i];
+    if (slot.state.load(std::memory_order_relaxed) != PlayerSlot::kOpen) {
+      continue;
+    }
+    // Sequentially consistent with the kClosing store and |writers| load in
+    // PopOldest(): either the slot is still open here, or it is not recycled
+    // until this callback is done with it.
+    slot.writers.fetch_add(1);
+    const bool match = slot.state.load() == PlayerSlot::kOpen && slot.stream_id == stream_id;
+    if (match) {
+      Push(slot.ring.get(), data, data_length, param);
+    }
+    slot.writers.fetch_sub(1, std::memory_order_release);
+    if (match) {
+      return;
+    }
+  }
+
+  // First frame of this stream.
+  if (stream_id.size() <= kMaxStreamIdLength) {
+    for (int i = 0; i < player_count_; i++) {
+      PlayerSlot& slot = players_[i];
+      int expected = PlayerSlot::kFree;
+      if (slot.state.compare_exchange_strong(expected, PlayerSlot::kClaiming,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+        slot.stream_id.assign(stream_id);
+        slot.state.store(PlayerSlot::kOpen, std::memory_order_release);
+        Push(slot.ring.get(), data, data_length, param);
+        return;
+      }
+    }
+  }
+  unmatched_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioTap::Push(PcmRing* ring, const unsigned char* data, unsigned int data_length,
+                    const ZEGO::EXPRESS::ZegoAudioFrameParam& param) {
+  if (ring == nullptr || data == nullptr) {
+    return;
+  }
+  if (!ring->Push(data, data_length, static_cast<int>(param.sampleRate),
+                  static_cast<int>(param.channel), NowUs())) {
+    return;
+  }
+  // Pairs with Read(): either the consumer sees the new value before it
+  // sleeps, or this sees |waiting_| and wakes it. The wake is the only system
+  // call on this path and never blocks.
+  signal_.fetch_add(1);
+  if (waiting_.load()) {
+    FutexWake(&signal_);
+  }
+}
+
+bool AudioTap::PopOldest(AudioFrame* frame) {
+  PcmRing* oldest = nullptr;
+  int64_t oldest_us = 0;
+  Source source = kCaptured;
+  const std::string* stream_id = nullptr;
+
+  const Source fixed[] = {kCaptured, kPlayback, kMixed};
+  for (int i = 0; i < 3; i++) {
+    if (rings_[i] == nullptr) {
+      continue;
+    }
+    const SlotHeader* header = rings_[i]->Front();
+    if (header != nullptr && (oldest == nullptr || header->timestamp_us < oldest_us)) {
+      oldest = rings_[i].get();
+      oldest_us = header->timestamp_us;
+      source = fixed[i];
+      stream_id = nullptr;
+    }
+  }
+  for (int i = 0; i < player_count_; i++) {
+    PlayerSlot& slot = players_[i];
+    const int state = slot.state.load(std::memory_order_acquire);
+    if (state != PlayerSlot::kOpen && state != PlayerSlot::kClosing) {
+      continue;
+    }
+    if (state == PlayerSlot::kClosing && slot.writers.load() == 0 &&
+        slot.ring->pending() == 0) {
+      slot.ring->Reset();
+      slot.state.store(PlayerSlot::kFree, std::memory_order_release);
+      continue;
+    }
+    const SlotHeader* header = slot.ring->Front();
+    if (header != nullptr && (oldest == nullptr || header->timestamp_us < oldest_us)) {
+      oldest = slot.ring.get();
+      oldest_us = header->timestamp_us;
+      source = kPlayer;
+      stream_id = &slot.stream_id;
+    }
+  }
+
+  if (oldest == nullptr) {
+    return false;
+  }
+  frame->source = source;
+  if (stream_id != nullptr) {
+    frame->stream_id = *stream_id;
+  } else {
+    frame->stream_id.clear();
+  }
+  oldest->Pop(frame);
+  return true;
+}
+
+bool AudioTap::TryRead(AudioFrame* frame) {
+  if (PopOldest(frame)) {
+    return true;
+  }
+  underruns_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool AudioTap::Read(AudioFrame* frame, int timeout_ms) {
+  const int64_t deadline_us = NowUs() + static_cast<int64_t>(timeout_ms) * 1000;
+  for (;;) {
+    const uint32_t signal = signal_.load(std::memory_order_acquire);
+    if (PopOldest(frame)) {
+      return true;
+    }
+    const int64_t remaining_us = deadline_us - NowUs();
+    if (remaining_us <= 0) {
+      underruns_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    waiting_.store(true);
+    if (signal_.load() == signal) {
+      FutexWait(&signal_, signal, remaining_us);
+    }
+    waiting_.store(false, std::memory_order_relaxed);
+  }
+}
+
+void AudioTap::ReleasePlayerStream(const std::string& stream_id) {
+  for (int i = 0; i < player_count_; i++) {
+    PlayerSlot& slot = players_[i];
+    if (slot.state.load(std::memory_order_acquire) == PlayerSlot::kOpen &&
+        slot.stream_id == stream_id) {
+      slot.state.store(PlayerSlot::kClosing);
+    }
+  }
+}
+
+Stats AudioTap::GetStats() const {
+  Stats stats;
+  const Source fixed[] = {kCaptured, kPlayback, kMixed};
+  for (int i = 0; i < 3; i++) {
+    const PcmRing* ring = rings_[i].get();
+    if (ring != nullptr) {
+      stats.sources.push_back({fixed[i], std::string(), ring->frames(), ring->overruns(),
+                               ring->truncated(), ring->pending()});
+    }
+  }
+  for (int i = 0; i < player_count_; i++) {
+    const PlayerSlot& slot = players_[i];
+    const int state = slot.state.load(std::memory_order_acquire);
+    if (state == PlayerSlot::kOpen || state == PlayerSlot::kClosing) {
+      const PcmRing* ring = slot.ring.get();
+      stats.sources.push_back({kPlayer, slot.stream_id, ring->frames(), ring->overruns(),
+                               ring->truncated(), ring->pending()});
+    }
+  }
+  stats.underruns = underruns_.load(std::memory_order_relaxed);
+  stats.unmatched = unmatched_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace audio_tap
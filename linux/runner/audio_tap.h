@@ -0,0 +1,134 @@
+#ifndef FLUTTER_AUDIO_TAP_H_
+#define FLUTTER_AUDIO_TAP_H_
+
+#include <ZegoExpressSDK.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace audio_tap {
+
+// Same values as ZegoAudioDataCallbackBitMask.
+enum Source {
+  kCaptured = 1 << 0,
+  kPlayback = 1 << 1,
+  kMixed = 1 << 2,
+  kPlayer = 1 << 3,
+};
+
+// One callback's worth of interleaved 16 bit PCM, owned by the consumer.
+struct AudioFrame {
+  Source source = kCaptured;
+  std::string stream_id;  // only set for kPlayer
+  int sample_rate = 0;
+  int channels = 0;
+  int64_t timestamp_us = 0;  // steady clock, when the SDK delivered it
+  // Counts every callback of this source, including dropped ones, so a gap
+  // means frames were lost to an overrun.
+  uint64_t sequence = 0;
+  std::vector<int16_t> samples;
+};
+
+struct SourceStats {
+  Source source;
+  std::string stream_id;
+  uint64_t frames;     // callbacks received
+  uint64_t overruns;   // frames dropped because the ring was full
+  uint64_t truncated;  // frames longer than a slot, cut to fit
+  uint64_t pending;    // frames waiting to be read
+};
+
+struct Stats {
+  std::vector<SourceStats> sources;
+  uint64_t underruns;  // reads that returned no frame
+  uint64_t unmatched;  // player frames without a free stream slot
+};
+
+class PcmRing;
+
+// Moves PCM from IZegoAudioDataHandler off the SDK's audio thread.
+//
+// Each source gets its own single-producer single-consumer ring of slots that
+// are allocated up front from the ZegoAudioFrameParam, so a callback is one
+// memcpy and two atomic stores: it never allocates, locks or waits for the
+// consumer. A full ring drops the new frame and counts an overrun. Player
+// streams are matched by stream ID to a fixed pool of rings that are claimed
+// on first use and recycled by ReleasePlayerStream().
+//
+// All read and stats calls must come from one consumer thread. Each source's
+// callbacks must not overlap with each other, which is how the SDK calls them.
+class AudioTap : public ZEGO::EXPRESS::IZegoAudioDataHandler,
+                 public std::enable_shared_from_this<AudioTap> {
+ public:
+  struct Options {
+    unsigned int sources = kCaptured | kPlayer;  // Source bits to observe
+    // Format requested from the SDK. Slots are sized for 48 kHz stereo while
+    // the sample rate is left unknown.
+    ZEGO::EXPRESS::ZegoAudioFrameParam param;
+    int buffer_ms = 2000;        // audio each ring holds, assuming 10 ms frames
+    int max_frame_ms = 40;       // longest single callback a slot holds
+    int max_player_streams = 8;  // remote streams tapped at the same time
+  };
+
+  explicit AudioTap(const Options& options);
+  ~AudioTap() override;
+
+  AudioTap(const AudioTap&) = delete;
+  AudioTap& operator=(const AudioTap&) = delete;
+
+  // Installs the tap as the engine's audio data handler and starts the
+  // observer for the configured sources. Stop() undoes both; frames already
+  // queued can still be read afterwards.
+  void Start(ZEGO::EXPRESS::IZegoExpressEngine* engine);
+  void Stop(ZEGO::EXPRESS::IZegoExpressEngine* engine);
+
+  // Moves the oldest queued frame of any source into |frame|, reusing its
+  // sample buffer. Returns false if nothing is queued.
+  bool TryRead(AudioFrame* frame);
+
+  // Like TryRead(), but waits up to |timeout_ms| for a frame to arrive.
+  bool Read(AudioFrame* frame, int timeout_ms);
+
+  // Stops accepting frames for |stream_id|. Its ring is handed back to the
+  // pool once the frames already queued have been read.
+  void ReleasePlayerStream(const std::string& stream_id);
+
+  Stats GetStats() const;
+
+  // IZegoAudioDataHandler, called on the SDK's audio threads.
+  void onCapturedAudioData(const unsigned char* data, unsigned int data_length,
+                           ZEGO::EXPRESS::ZegoAudioFrameParam param) override;
+  void onPlaybackAudioData(const unsigned char* data, unsigned int data_length,
+                           ZEGO::EXPRESS::ZegoAudioFrameParam param) override;
+  void onMixedAudioData(const unsigned char* data, unsigned int data_length,
+                        ZEGO::EXPRESS::ZegoAudioFrameParam param) override;
+  void onPlayerAudioData(const unsigned char* data, unsigned int data_length,
+                         ZEGO::EXPRESS::ZegoAudioFrameParam param,
+                         const std::string& stream_id) override;
+
+ private:
+  struct PlayerSlot;
+
+  void Push(PcmRing* ring, const unsigned char* data, unsigned int data_length,
+            const ZEGO::EXPRESS::ZegoAudioFrameParam& param);
+  bool PopOldest(AudioFrame* frame);
+
+  const Options options_;
+  const int player_count_;
+  std::unique_ptr<PcmRing> rings_[3];  // captured, playback, mixed
+  std::unique_ptr<PlayerSlot[]> players_;
+
+  // Bumped after every push; the consumer sleeps on it with a futex.
+  std::atomic<uint32_t> signal_{0};
+  std::atomic<bool> waiting_{false};
+
+  std::atomic<uint64_t> underruns_{0};
+  std::atomic<uint64_t> unmatched_{0};
+};
+
+}  // namespace audio_tap
+
+#endif  // FLUTTER_AUDIO_TAP_H_
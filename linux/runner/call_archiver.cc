@@ -0,0 +1,562 @@
+#include "call_archiver.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace call_archive {
+
+namespace {
+
+constexpr int kPollIntervalMs = 50;
+
+static_assert(sizeof(SegmentHeader) % 8 == 0 && sizeof(ChunkHeader) % 8 == 0 &&
+                  sizeof(RecordHeader) % 8 == 0 && sizeof(IndexHeader) % 8 == 0 &&
+                  sizeof(TrackEntry) % 8 == 0 && sizeof(IndexEntry) % 8 == 0,
+              "archive structures must keep 8 byte alignment");
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t UnixNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+size_t Align8(size_t value) {
+  return (value + 7) & ~static_cast<size_t>(7);
+}
+
+size_t AlignBlock(size_t value) {
+  return (value + kBlockSize - 1) / kBlockSize * kBlockSize;
+}
+
+// Power of two of at least twice |max_tracks|, so the track table never fills.
+size_t TrackSlotCount(int max_tracks) {
+  size_t count = 2;
+  while (count < 2 * static_cast<size_t>(std::max(max_tracks, 1))) {
+    count <<= 1;
+  }
+  return count;
+}
+
+// FNV-1a of the track kind and stream ID.
+uint64_t TrackHash(TrackKind kind, const char* stream_id, size_t length) {
+  uint64_t hash = 14695981039346656037ull;
+  hash = (hash ^ static_cast<uint8_t>(kind)) * 1099511628211ull;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ static_cast<uint8_t>(stream_id[i])) * 1099511628211ull;
+  }
+  return hash;
+}
+
+void UpdateMax(std::atomic<int64_t>* max, int64_t value) {
+  int64_t current = max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max->compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+void Drain(int event_fd) {
+  uint64_t count;
+  ssize_t unused = read(event_fd, &count, sizeof(count));
+  (void)unused;
+}
+
+const char* AudioStreamId(const audio_tap::AudioFrame& frame) {
+  switch (frame.source) {
+    case audio_tap::kCaptured:
+      return "@capture";
+    case audio_tap::kPlayback:
+      return "@playback";
+    case audio_tap::kMixed:
+      return "@mixed";
+    case audio_tap::kPlayer:
+      break;
+  }
+  return frame.stream_id.c_str();
+}
+
+}  // namespace
+
+struct CallArchiver::Chunk {
+  explicit Chunk(size_t bytes) : data(AllocateBlocks(bytes)) {}
+  ~Chunk() { FreeBlocks(data); }
+
+  uint8_t* data;
+  size_t used = sizeof(ChunkHeader);
+  uint32_t records = 0;
+  uint16_t flags = 0;
+  int64_t first_us = 0;
+  int64_t last_us = 0;
+  int track = -1;  // -1 for a segment header block
+  int64_t opened_us = 0;
+  int64_t submitted_us = 0;
+  Segment* segment = nullptr;
+};
+
+struct CallArchiver::Track {
+  TrackInfo info;
+  std::mutex mutex;
+  Chunk* open = nullptr;
+  std::vector<Chunk*> free;
+  std::vector<std::unique_ptr<Chunk>> chunks;
+};
+
+// A track is published by storing |track| last, with release, so a reader
+// that sees it can compare |hash| and the track's info without the lock.
+struct CallArchiver::TrackSlot {
+  std::atomic<uint64_t> hash{0};
+  std::atomic<int> track{-1};
+};
+
+struct CallArchiver::Segment {
+  uint32_t number = 0;
+  int fd = -1;
+  std::string path;
+  int64_t start_us = 0;
+  uint64_t size = 0;
+  size_t in_flight = 0;
+  std::unique_ptr<Chunk> header;
+  std::vector<IndexEntry> index;
+};
+
+CallArchiver::CallArchiver(const Options& options)
+    : options_(options),
+      tracks_(new std::unique_ptr<Track>[options.max_tracks]),
+      track_slots_(new TrackSlot[TrackSlotCount(options.max_tracks)]),
+      track_slot_mask_(TrackSlotCount(options.max_tracks) - 1) {}
+
+CallArchiver::~CallArchiver() {
+  Stop();
+}
+
+bool CallArchiver::Start(std::string* error) {
+  if (running_) {
+    return true;
+  }
+  if (options_.chunk_bytes < kBlockSize || options_.chunk_bytes % kBlockSize != 0) {
+    *error = "chunk_bytes must be a multiple of 4096";
+    return false;
+  }
+  writer_ = BlockWriter::Create(options_.use_io_uring, options_.queue_depth);
+  writer_name_ = writer_->name();
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ < 0) {
+    *error = std::string("eventfd: ") + strerror(errno);
+    writer_.reset();
+    return false;
+  }
+  if (!OpenSegment(next_segment_++, error)) {
+    close(wake_fd_);
+    wake_fd_ = -1;
+    writer_.reset();
+    return false;
+  }
+  running_ = true;
+  thread_ = std::thread(&CallArchiver::Run, this);
+  return true;
+}
+
+void CallArchiver::Stop() {
+  if (pump_thread_.joinable()) {
+    pumping_ = false;
+    pump_thread_.join();
+  }
+  tap_.reset();
+  if (!thread_.joinable()) {
+    return;
+  }
+  running_ = false;
+  Wake();
+  thread_.join();
+  close(wake_fd_);
+  wake_fd_ = -1;
+  writer_.reset();
+}
+
+int CallArchiver::AddTrack(const TrackInfo& info) {
+  std::lock_guard<std::mutex> lock(tracks_mutex_);
+  const int existing = FindTrack(info.kind, info.stream_id.data(), info.stream_id.size());
+  if (existing >= 0) {
+    return existing;
+  }
+  const int id = track_count_.load(std::memory_order_relaxed);
+  if (id >= options_.max_tracks) {
+    return -1;
+  }
+  std::unique_ptr<Track> track(new Track());
+  track->info = info;
+  for (int i = 0; i < options_.chunks_per_track; i++) {
+    track->chunks.emplace_back(new Chunk(options_.chunk_bytes));
+    track->chunks.back()->track = id;
+    track->free.push_back(track->chunks.back().get());
+  }
+  tracks_[id] = std::move(track);
+  track_count_.store(id + 1, std::memory_order_release);
+
+  const uint64_t hash = TrackHash(info.kind, info.stream_id.data(), info.stream_id.size());
+  size_t index = hash & track_slot_mask_;
+  while (track_slots_[index].track.load(std::memory_order_relaxed) >= 0) {
+    index = (index + 1) & track_slot_mask_;
+  }
+  track_slots_[index].hash.store(hash, std::memory_order_relaxed);
+  track_slots_[index].track.store(id, std::memory_order_release);
+  return id;
+}
+
+int CallArchiver::FindTrack(TrackKind kind, const char* stream_id, size_t length) const {
+  const uint64_t hash = TrackHash(kind, stream_id, length);
+  for (size_t index = hash & track_slot_mask_;; index = (index + 1) & track_slot_mask_) {
+    const TrackSlot& slot = track_slots_[index];
+    const int track = slot.track.load(std::memory_order_acquire);
+    if (track < 0) {
+      return -1;
+    }
+    if (slot.hash.load(std::memory_order_relaxed) != hash) {
+      continue;
+    }
+    const TrackInfo& info = tracks_[track]->info;
+    if (info.kind == kind && info.stream_id.size() == length &&
+        memcmp(info.stream_id.data(), stream_id, length) == 0) {
+      return track;
+    }
+  }
+}
+
+bool CallArchiver::WriteFrame(int track_id, int64_t timestamp_us, int64_t source_time,
+                              uint16_t flags, const uint8_t* data, size_t size) {
+  if (!running_ || track_id < 0 || track_id >= track_count_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  const size_t need = sizeof(RecordHeader) + Align8(size);
+  if (sizeof(ChunkHeader) + need > options_.chunk_bytes) {
+    oversized_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  Track* track = tracks_[track_id].get();
+  bool sealed = false;
+  {
+    std::lock_guard<std::mutex> lock(track->mutex);
+    if (track->open != nullptr && track->open->used + need > options_.chunk_bytes) {
+      SealLocked(track);
+      sealed = true;
+    }
+    if (track->open == nullptr) {
+      if (track->free.empty()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        if (sealed) {
+          Wake();
+        }
+        return false;
+      }
+      track->open = track->free.back();
+      track->free.pop_back();
+      track->open->opened_us = NowUs();
+      track->open->first_us = timestamp_us;
+    }
+    Chunk* chunk = track->open;
+    RecordHeader header = {static_cast<uint32_t>(size), flags, 0, timestamp_us, source_time};
+    memcpy(chunk->data + chunk->used, &header, sizeof(header));
+    memcpy(chunk->data + chunk->used + sizeof(header), data, size);
+    memset(chunk->data + chunk->used + sizeof(header) + size, 0, Align8(size) - size);
+    chunk->used += need;
+    chunk->records++;
+    chunk->flags |= flags;
+    chunk->last_us = timestamp_us;
+  }
+  if (sealed) {
+    Wake();
+  }
+  frames_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(size, std::memory_order_relaxed);
+  return true;
+}
+
+void CallArchiver::AttachAudioTap(std::shared_ptr<audio_tap::AudioTap> tap) {
+  if (pump_thread_.joinable() || tap == nullptr) {
+    return;
+  }
+  tap_ = std::move(tap);
+  pumping_ = true;
+  pump_thread_ = std::thread(&CallArchiver::PumpAudio, this);
+}
+
+ArchiverStats CallArchiver::GetStats() const {
+  ArchiverStats stats;
+  stats.writer = writer_name_;
+  stats.frames = frames_.load(std::memory_order_relaxed);
+  stats.bytes = bytes_.load(std::memory_order_relaxed);
+  stats.dropped = dropped_.load(std::memory_order_relaxed);
+  stats.oversized = oversized_.load(std::memory_order_relaxed);
+  stats.chunks = chunks_.load(std::memory_order_relaxed);
+  stats.segments = segments_.load(std::memory_order_relaxed);
+  stats.write_errors = write_errors_.load(std::memory_order_relaxed);
+  stats.max_write_us = max_write_us_.load(std::memory_order_relaxed);
+  stats.max_frame_latency_us = max_frame_latency_us_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void CallArchiver::onRemoteVideoFrameEncodedData(const unsigned char* data,
+                                                 unsigned int data_length,
+                                                 ZEGO::EXPRESS::ZegoVideoEncodedFrameParam param,
+                                                 unsigned long long reference_time_ms,
+                                                 const std::string& stream_id) {
+  int track = FindTrack(TrackKind::kVideo, stream_id.data(), stream_id.size());
+  if (track < 0) {
+    track = AddTrack({TrackKind::kVideo, stream_id, static_cast<uint32_t>(param.format), 0, 0});
+  }
+  WriteFrame(track, NowUs(), static_cast<int64_t>(reference_time_ms),
+             param.isKeyFrame ? kKeyFrame : 0, data, data_length);
+}
+
+void CallArchiver::PumpAudio() {
+  audio_tap::AudioFrame frame;
+  while (pumping_) {
+    if (!tap_->Read(&frame, kPollIntervalMs)) {
+      continue;
+    }
+    const char* stream_id = AudioStreamId(frame);
+    int track = FindTrack(TrackKind::kAudio, stream_id, strlen(stream_id));
+    if (track < 0) {
+      track = AddTrack({TrackKind::kAudio, stream_id, 0, static_cast<uint32_t>(frame.sample_rate),
+                        static_cast<uint32_t>(frame.channels)});
+    }
+    WriteFrame(track, frame.timestamp_us, static_cast<int64_t>(frame.sequence), 0,
+               reinterpret_cast<const uint8_t*>(frame.samples.data()),
+               frame.samples.size() * sizeof(int16_t));
+  }
+}
+
+void CallArchiver::Wake() {
+  const uint64_t one = 1;
+  ssize_t unused = write(wake_fd_, &one, sizeof(one));
+  (void)unused;
+}
+
+void CallArchiver::SealLocked(Track* track) {
+  Chunk* chunk = track->open;
+  track->open = nullptr;
+  std::lock_guard<std::mutex> lock(sealed_mutex_);
+  sealed_.push_back(chunk);
+}
+
+void CallArchiver::SealTracks(bool idle_only, int64_t now_us) {
+  const int64_t flush_us = static_cast<int64_t>(options_.flush_interval_ms) * 1000;
+  const int count = track_count_.load(std::memory_order_acquire);
+  for (int i = 0; i < count; i++) {
+    Track* track = tracks_[i].get();
+    std::lock_guard<std::mutex> lock(track->mutex);
+    if (track->open != nullptr && (!idle_only || now_us - track->open->opened_us >= flush_us)) {
+      SealLocked(track);
+    }
+  }
+}
+
+// Appends sealed chunks to the current segment, in the order they were sealed.
+// Chunks the writer has no room for stay queued for the next round.
+void CallArchiver::SubmitPending(int64_t now_us) {
+  {
+    std::lock_guard<std::mutex> lock(sealed_mutex_);
+    pending_.insert(pending_.end(), sealed_.begin(), sealed_.end());
+    sealed_.clear();
+  }
+  while (!pending_.empty() && segment_ != nullptr) {
+    Chunk* chunk = pending_.front();
+    const size_t size = AlignBlock(chunk->used);
+    ChunkHeader header = {kChunkMagic,
+                          static_cast<uint16_t>(chunk->track),
+                          chunk->flags,
+                          chunk->records,
+                          static_cast<uint32_t>(chunk->used),
+                          chunk->first_us,
+                          chunk->last_us};
+    memcpy(chunk->data, &header, sizeof(header));
+    memset(chunk->data + chunk->used, 0, size - chunk->used);
+    chunk->segment = segment_.get();
+    chunk->submitted_us = now_us;
+    if (!writer_->Submit(segment_->fd, chunk->data, size, segment_->size, chunk)) {
+      break;
+    }
+    segment_->index.push_back({segment_->size, static_cast<uint32_t>(size),
+                               static_cast<uint16_t>(chunk->track), chunk->flags, chunk->records,
+                               0, chunk->first_us, chunk->last_us});
+    segment_->size += size;
+    segment_->in_flight++;
+    pending_.pop_front();
+  }
+}
+
+void CallArchiver::OnWritten(Chunk* chunk, int64_t result, int64_t now_us) {
+  Segment* segment = chunk->segment;
+  segment->in_flight--;
+  if (result != static_cast<int64_t>(AlignBlock(chunk->used))) {
+    write_errors_.fetch_add(1, std::memory_order_relaxed);
+  }
+  UpdateMax(&max_write_us_, now_us - chunk->submitted_us);
+  if (chunk->track < 0) {
+    return;  // the segment header
+  }
+  chunks_.fetch_add(1, std::memory_order_relaxed);
+  UpdateMax(&max_frame_latency_us_, now_us - chunk->opened_us);
+
+  Track* track = tracks_[chunk->track].get();
+  std::lock_guard<std::mutex> lock(track->mutex);
+  chunk->used = sizeof(ChunkHeader);
+  chunk->records = 0;
+  chunk->flags = 0;
+  chunk->segment = nullptr;
+  track->free.push_back(chunk);
+}
+
+bool CallArchiver::OpenSegment(uint32_t number, std::string* error) {
+  char name[32];
+  snprintf(name, sizeof(name), "-%05u.zarc", number);
+  std::unique_ptr<Segment> segment(new Segment());
+  segment->number = number;
+  segment->path = options_.directory + "/" + options_.prefix + name;
+  const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+  segment->fd = options_.direct_io ? open(segment->path.c_str(), flags | O_DIRECT, 0644) : -1;
+  if (segment->fd < 0) {
+    // tmpfs and some network file systems refuse O_DIRECT.
+    segment->fd = open(segment->path.c_str(), flags, 0644);
+  }
+  if (segment->fd < 0) {
+    *error = segment->path + ": " + strerror(errno);
+    return false;
+  }
+  segment->start_us = NowUs();
+
+  segment->header.reset(new Chunk(kBlockSize));
+  Chunk* header = segment->header.get();
+  SegmentHeader data = {kSegmentMagic, kFormatVersion, number, 0, UnixNowUs(),
+                        segment->start_us};
+  memset(header->data, 0, kBlockSize);
+  memcpy(header->data, &data, sizeof(data));
+  header->used = kBlockSize;
+  header->segment = segment.get();
+  header->submitted_us = segment->start_us;
+  if (!writer_->Submit(segment->fd, header->data, kBlockSize, 0, header)) {
+    *error = "write queue full";
+    close(segment->fd);
+    return false;
+  }
+  segment->size = kBlockSize;
+  segment->in_flight = 1;
+  segment_ = std::move(segment);
+  segments_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+// Closes rotated segments once their last write has completed.
+void CallArchiver::FinishSegments() {
+  auto done = std::remove_if(closing_.begin(), closing_.end(),
+                             [](const std::unique_ptr<Segment>& segment) {
+                               return segment->in_flight == 0;
+                             });
+  for (auto it = done; it != closing_.end(); ++it) {
+    close((*it)->fd);
+    WriteIndex(**it);
+  }
+  closing_.erase(done, closing_.end());
+}
+
+void CallArchiver::WriteIndex(const Segment& segment) {
+  std::vector<uint8_t> index;
+  auto append = [&index](const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    index.insert(index.end(), bytes, bytes + size);
+    index.resize(Align8(index.size()), 0);
+  };
+  const int count = track_count_.load(std::memory_order_acquire);
+  IndexHeader header = {kIndexMagic,
+                        kFormatVersion,
+                        segment.number,
+                        static_cast<uint32_t>(count),
+                        static_cast<uint32_t>(segment.index.size()),
+                        0};
+  append(&header, sizeof(header));
+  for (int i = 0; i < count; i++) {
+    const TrackInfo& info = tracks_[i]->info;
+    TrackEntry entry = {static_cast<uint16_t>(i),
+                        static_cast<uint8_t>(info.kind),
+                        0,
+                        info.codec,
+                        info.sample_rate,
+                        info.channels,
+                        static_cast<uint32_t>(info.stream_id.size()),
+                        0};
+    append(&entry, sizeof(entry));
+    append(info.stream_id.data(), info.stream_id.size());
+  }
+  append(segment.index.data(), segment.index.size() * sizeof(IndexEntry));
+
+  std::string path = segment.path;
+  path.replace(path.size() - 4, 4, "zidx");
+  FILE* file = fopen(path.c_str(), "wb");
+  if (file == nullptr || fwrite(index.data(), 1, index.size(), file) != index.size()) {
+    write_errors_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (file != nullptr) {
+    fclose(file);
+  }
+}
+
+void CallArchiver::Run() {
+  const int64_t segment_us = static_cast<int64_t>(options_.segment_seconds) * 1000000;
+  std::vector<BlockWriter::Completion> completions;
+  struct pollfd fds[2] = {{wake_fd_, POLLIN, 0}, {writer_->event_fd(), POLLIN, 0}};
+  for (;;) {
+    poll(fds, 2, kPollIntervalMs);
+    Drain(wake_fd_);
+    Drain(writer_->event_fd());
+
+    int64_t now_us = NowUs();
+    completions.clear();
+    writer_->Reap(&completions);
+    for (const BlockWriter::Completion& completion : completions) {
+      OnWritten(static_cast<Chunk*>(completion.cookie), completion.result, now_us);
+    }
+
+    const bool stopping = !running_;
+    const bool rotate =
+        stopping || (segment_ != nullptr && now_us - segment_->start_us >= segment_us);
+    SealTracks(!rotate, now_us);
+    SubmitPending(now_us);
+
+    if (rotate && pending_.empty() && segment_ != nullptr) {
+      closing_.push_back(std::move(segment_));
+    }
+    if (!stopping && segment_ == nullptr) {
+      std::string error;
+      if (!OpenSegment(next_segment_, &error)) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        next_segment_++;
+      }
+    }
+    FinishSegments();
+
+    if (stopping && segment_ == nullptr && closing_.empty()) {
+      // Only left over if the last segment could not be opened.
+      for (Chunk* chunk : pending_) {
+        dropped_.fetch_add(chunk->records, std::memory_order_relaxed);
+      }
+      pending_.clear();
+      return;
+    }
+  }
+}
+
+}  // namespace call_archive
@@ -0,0 +1,265 @@
+#ifndef FLUTTER_CALL_ARCHIVER_H_
+#define FLUTTER_CALL_ARCHIVER_H_
+
+#include <ZegoExpressSDK.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "archive_writer.h"
+#include "audio_tap.h"
+
+namespace call_archive {
+
+// On-disk layout. All integers are little endian and every structure is a
+// multiple of 8 bytes.
+//
+//   <prefix>-<segment>.zarc  One 4 KiB block holding a SegmentHeader, then
+//                            chunks. A chunk holds consecutive frames of one
+//                            track: a ChunkHeader, then for every frame a
+//                            RecordHeader and its payload padded to 8 bytes,
+//                            then zeros up to the next 4 KiB boundary.
+//   <prefix>-<segment>.zidx  Written when the segment is closed: an
+//                            IndexHeader, one TrackEntry per track, each
+//                            followed by its stream ID padded to 8 bytes,
+//                            then one IndexEntry per chunk.
+//
+// Audio payloads are interleaved 16 bit PCM and video payloads are encoded
+// frames exactly as the SDK delivered them, so nothing is re-encoded. Chunks
+// are self-describing, so a segment whose index was never written (e.g.
+// after a crash) can still be recovered by scanning it.
+
+constexpr uint32_t kSegmentMagic = 0x4352415a;  // "ZARC"
+constexpr uint32_t kChunkMagic = 0x4b48435a;    // "ZCHK"
+constexpr uint32_t kIndexMagic = 0x5844495a;    // "ZIDX"
+constexpr uint32_t kFormatVersion = 1;
+
+enum class TrackKind : uint8_t {
+  kAudio = 1,
+  kVideo = 2,
+};
+
+enum RecordFlags : uint16_t {
+  kKeyFrame = 1 << 0,
+};
+
+struct SegmentHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t segment;
+  uint32_t reserved;
+  int64_t start_unix_us;
+  int64_t start_steady_us;
+};
+
+struct ChunkHeader {
+  uint32_t magic;
+  uint16_t track;
+  uint16_t flags;  // RecordFlags of all records OR-ed together
+  uint32_t records;
+  uint32_t bytes;  // header and records, without the block padding
+  int64_t first_us;
+  int64_t last_us;
+};
+
+struct RecordHeader {
+  uint32_t size;  // payload bytes
+  uint16_t flags;
+  uint16_t reserved;
+  int64_t timestamp_us;  // steady clock, when the frame reached the archiver
+  int64_t source_time;   // video: referenceTimeMillisecond, audio: tap sequence
+};
+
+struct IndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t segment;
+  uint32_t track_count;
+  uint32_t chunk_count;
+  uint32_t reserved;
+};
+
+struct TrackEntry {
+  uint16_t track;
+  uint8_t kind;  // TrackKind
+  uint8_t reserved;
+  uint32_t codec;  // video: ZegoVideoEncodedFrameFormat, audio: 0 (s16 PCM)
+  uint32_t sample_rate;
+  uint32_t channels;
+  uint32_t stream_id_length;
+  uint32_t reserved2;
+};
+
+struct IndexEntry {
+  uint64_t offset;
+  uint32_t size;  // including the block padding
+  uint16_t track;
+  uint16_t flags;
+  uint32_t records;
+  uint32_t reserved;
+  int64_t first_us;
+  int64_t last_us;
+};
+
+struct TrackInfo {
+  TrackKind kind;
+  // Player stream ID, or "@capture", "@playback" or "@mixed" for local audio.
+  std::string stream_id;
+  uint32_t codec;
+  uint32_t sample_rate;
+  uint32_t channels;
+};
+
+struct ArchiverStats {
+  const char* writer;  // "io_uring" or "thread"
+  uint64_t frames;
+  uint64_t bytes;
+  uint64_t dropped;    // frames refused because their track had no free chunk
+  uint64_t oversized;  // frames larger than a chunk
+  uint64_t chunks;
+  uint64_t segments;
+  uint64_t write_errors;
+  int64_t max_write_us;          // chunk submitted to write completed
+  int64_t max_frame_latency_us;  // frame accepted to its chunk on disk
+};
+
+// Records every participant of a call into time-rotated segment files.
+//
+// Producers copy each frame into the open chunk of its track under a
+// per-track lock. Each track owns |chunks_per_track| aligned chunks, so its
+// memory is fixed; when all of them are queued or being written, new frames
+// of that track are dropped and counted rather than buffered. Full chunks,
+// and partly filled ones after |flush_interval_ms|, are handed to an archiver
+// thread that appends them to the current segment through a BlockWriter,
+// builds the segment's chunk index and rotates segments every
+// |segment_seconds|.
+//
+// Encoded remote video arrives through IZegoCustomVideoRenderHandler, which
+// the engine only calls when custom rendering is enabled with
+// ZEGO_VIDEO_BUFFER_TYPE_ENCODED_DATA; the engine takes a single render
+// handler, so this cannot run next to the video texture bridge. Audio is
+// pulled from an audio_tap::AudioTap.
+class CallArchiver : public ZEGO::EXPRESS::IZegoCustomVideoRenderHandler {
+ public:
+  struct Options {
+    std::string directory;
+    std::string prefix = "call";
+    int segment_seconds = 60;
+    size_t chunk_bytes = 512 * 1024;
+    int chunks_per_track = 4;
+    int flush_interval_ms = 1000;
+    int max_tracks = 32;
+    unsigned queue_depth = 32;  // chunk writes in flight
+    bool use_io_uring = true;
+    bool direct_io = true;  // O_DIRECT where the file system supports it
+  };
+
+  explicit CallArchiver(const Options& options);
+  ~CallArchiver() override;
+
+  CallArchiver(const CallArchiver&) = delete;
+  CallArchiver& operator=(const CallArchiver&) = delete;
+
+  // Opens the first segment in |directory|, which must exist, and starts the
+  // archiver thread. On failure returns false and describes why in |error|.
+  bool Start(std::string* error);
+
+  // Stops the audio pump, writes out everything queued and closes the last
+  // segment. Frames written while Stop() runs may be lost, so detach the
+  // engine handlers first.
+  void Stop();
+
+  // Returns the track for |info.kind| and |info.stream_id|, adding it on first
+  // use. Returns -1 once |max_tracks| tracks exist.
+  int AddTrack(const TrackInfo& info);
+
+  // Returns the track for |kind| and |stream_id| if it exists, or -1. Never
+  // locks, so producers call it for every frame and AddTrack() only for the
+  // first one of a stream.
+  int FindTrack(TrackKind kind, const char* stream_id, size_t length) const;
+
+  // Copies one frame into |track|. Returns false if it was dropped.
+  bool WriteFrame(int track, int64_t timestamp_us, int64_t source_time, uint16_t flags,
+                  const uint8_t* data, size_t size);
+
+  // Archives every frame |tap| delivers, read on a thread of its own, until
+  // Stop(). The archiver becomes the tap's only consumer.
+  void AttachAudioTap(std::shared_ptr<audio_tap::AudioTap> tap);
+
+  ArchiverStats GetStats() const;
+
+  // IZegoCustomVideoRenderHandler, called on the SDK's render threads.
+  void onRemoteVideoFrameEncodedData(const unsigned char* data, unsigned int data_length,
+                                     ZEGO::EXPRESS::ZegoVideoEncodedFrameParam param,
+                                     unsigned long long reference_time_ms,
+                                     const std::string& stream_id) override;
+
+ private:
+  struct Chunk;
+  struct Track;
+  struct Segment;
+  struct TrackSlot;
+
+  void Run();
+  void PumpAudio();
+  void Wake();
+  void SealLocked(Track* track);
+  void SealTracks(bool idle_only, int64_t now_us);
+  void SubmitPending(int64_t now_us);
+  void OnWritten(Chunk* chunk, int64_t result, int64_t now_us);
+  bool OpenSegment(uint32_t number, std::string* error);
+  void FinishSegments();
+  void WriteIndex(const Segment& segment);
+
+  const Options options_;
+  std::unique_ptr<BlockWriter> writer_;
+  const char* writer_name_ = "none";
+  int wake_fd_ = -1;
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+
+  std::shared_ptr<audio_tap::AudioTap> tap_;
+  std::atomic<bool> pumping_{false};
+  std::thread pump_thread_;
+
+  // Tracks are only ever added; |tracks_| is sized for |max_tracks| up front
+  // so readers can index it below |track_count_| without the lock.
+  // |track_slots_| maps stream IDs to tracks by open addressing with twice as
+  // many slots as tracks, so it never fills; slots are only written under
+  // |tracks_mutex_| and read without it.
+  std::mutex tracks_mutex_;
+  std::unique_ptr<std::unique_ptr<Track>[]> tracks_;
+  std::atomic<int> track_count_{0};
+  std::unique_ptr<TrackSlot[]> track_slots_;
+  const size_t track_slot_mask_;
+
+  // Chunks sealed by producers, waiting for the archiver thread.
+  std::mutex sealed_mutex_;
+  std::deque<Chunk*> sealed_;
+
+  // Archiver thread only.
+  std::deque<Chunk*> pending_;
+  std::unique_ptr<Segment> segment_;
+  std::vector<std::unique_ptr<Segment>> closing_;
+  uint32_t next_segment_ = 0;
+
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> oversized_{0};
+  std::atomic<uint64_t> chunks_{0};
+  std::atomic<uint64_t> segments_{0};
+  std::atomic<uint64_t> write_errors_{0};
+  std::atomic<int64_t> max_write_us_{0};
+  std::atomic<int64_t> max_frame_latency_us_{0};
+};
+
+}  // namespace call_archive
+
+#endif  // FLUTTER_CALL_ARCHIVER_H_
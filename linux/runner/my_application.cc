@@ -6,10 +6,16 @@
 #endif
 
 #include "flutter/generated_plugin_registrant.h"
+#ifdef HAVE_VIDEO_TEXTURE_BRIDGE
+#include "video_texture_bridge.h"
+#endif
 
 struct _MyApplication {
   GtkApplication parent_instance;
   char** dart_entrypoint_arguments;
+#ifdef HAVE_VIDEO_TEXTURE_BRIDGE
+  VideoTextureBridge* video_texture_bridge;
+#endif
 };
 
 G_DEFINE_TYPE(MyApplication, my_application, GTK_TYPE_APPLICATION)
@@ -58,6 +64,11 @@ static void my_application_activate(GApplication* application) {
   gtk_container_add(GTK_CONTAINER(window), GTK_WIDGET(view));
 
   fl_register_plugins(FL_PLUGIN_REGISTRY(view));
+#ifdef HAVE_VIDEO_TEXTURE_BRIDGE
+  g_clear_object(&self->video_texture_bridge);
+  self->video_texture_bridge =
+      video_texture_bridge_new(FL_PLUGIN_REGISTRY(view));
+#endif
 
   gtk_widget_grab_focus(GTK_WIDGET(view));
 }
@@ -103,6 +114,9 @@ static void my_application_shutdown(GApplication* application) {
 static void my_application_dispose(GObject* object) {
   MyApplication* self = MY_APPLICATION(object);
   g_clear_pointer(&self->dart_entrypoint_arguments, g_strfreev);
+#ifdef HAVE_VIDEO_TEXTURE_BRIDGE
+  g_clear_object(&self->video_texture_bridge);
+#endif
   G_OBJECT_CLASS(my_application_parent_class)->dispose(object);
 }
 
@@ -0,0 +1,181 @@
+#include "archive_reader.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace call_archive {
+
+namespace {
+
+size_t Align8(size_t value) {
+  return (value + 7) & ~static_cast<size_t>(7);
+}
+
+size_t AlignBlock(size_t value) {
+  return (value + kBlockSize - 1) / kBlockSize * kBlockSize;
+}
+
+bool ReadFile(const std::string& path, std::vector<uint8_t>* data) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t buffer[64 * 1024];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data->insert(data->end(), buffer, buffer + n);
+  }
+  const bool ok = ferror(file) == 0;
+  fclose(file);
+  return ok;
+}
+
+// Copies a T out of |data| at |*offset| and advances past it, 8 byte aligned.
+template <typename T>
+bool Take(const std::vector<uint8_t>& data, size_t* offset, T* value) {
+  if (data.size() < sizeof(T) || *offset > data.size() - sizeof(T)) {
+    return false;
+  }
+  memcpy(value, data.data() + *offset, sizeof(T));
+  *offset += Align8(sizeof(T));
+  return true;
+}
+
+bool ReadIndex(const std::string& path, ArchiveSegment* segment, std::string* error) {
+  std::vector<uint8_t> data;
+  if (!ReadFile(path, &data)) {
+    return true;  // not written, e.g. after a crash
+  }
+  size_t offset = 0;
+  IndexHeader header;
+  if (!Take(data, &offset, &header) || header.magic != kIndexMagic ||
+      header.version != kFormatVersion || header.segment != segment->header.segment) {
+    *error = path + ": bad index header";
+    return false;
+  }
+  for (uint32_t i = 0; i < header.track_count; i++) {
+    TrackEntry entry;
+    if (!Take(data, &offset, &entry) || entry.track != i ||
+        entry.stream_id_length > data.size() - offset) {
+      *error = path + ": bad track entry";
+      return false;
+    }
+    TrackInfo info;
+    info.kind = static_cast<TrackKind>(entry.kind);
+    info.stream_id.assign(reinterpret_cast<const char*>(data.data() + offset),
+                          entry.stream_id_length);
+    info.codec = entry.codec;
+    info.sample_rate = entry.sample_rate;
+    info.channels = entry.channels;
+    segment->tracks.push_back(info);
+    offset += Align8(entry.stream_id_length);
+  }
+  std::vector<IndexEntry> chunks(header.chunk_count);
+  for (IndexEntry& chunk : chunks) {
+    if (!Take(data, &offset, &chunk)) {
+      *error = path + ": index truncated";
+      return false;
+    }
+  }
+  if (offset != data.size()) {
+    *error = path + ": trailing index bytes";
+    return false;
+  }
+  for (size_t i = 0; i < chunks.size(); i++) {
+    const IndexEntry& a = chunks[i];
+    const IndexEntry* b = i < segment->chunks.size() ? &segment->chunks[i] : nullptr;
+    if (b == nullptr || a.offset != b->offset || a.size != b->size || a.track != b->track ||
+        a.flags != b->flags || a.records != b->records || a.first_us != b->first_us ||
+        a.last_us != b->last_us || a.track >= header.track_count) {
+      *error = path + ": index entry " + std::to_string(i) + " does not match its chunk";
+      return false;
+    }
+  }
+  if (chunks.size() != segment->chunks.size()) {
+    *error = path + ": index is missing chunks";
+    return false;
+  }
+  segment->has_index = true;
+  return true;
+}
+
+}  // namespace
+
+bool ReadSegment(const std::string& path, ArchiveSegment* segment, std::string* error) {
+  std::vector<uint8_t> data;
+  if (!ReadFile(path, &data)) {
+    *error = path + ": cannot read";
+    return false;
+  }
+  segment->path = path;
+  size_t offset = 0;
+  if (!Take(data, &offset, &segment->header) || segment->header.magic != kSegmentMagic ||
+      segment->header.version != kFormatVersion || data.size() % kBlockSize != 0) {
+    *error = path + ": bad segment header";
+    return false;
+  }
+
+  for (offset = kBlockSize; offset < data.size();) {
+    const size_t chunk_offset = offset;
+    ChunkHeader chunk;
+    if (!Take(data, &offset, &chunk) || chunk.magic != kChunkMagic ||
+        chunk.bytes > data.size() - chunk_offset || chunk.bytes < sizeof(ChunkHeader)) {
+      *error = path + ": bad chunk at " + std::to_string(chunk_offset);
+      return false;
+    }
+    const size_t end = chunk_offset + chunk.bytes;
+    uint16_t flags = 0;
+    for (uint32_t i = 0; i < chunk.records; i++) {
+      RecordHeader header;
+      if (!Take(data, &offset, &header) || header.size > end - std::min(offset, end)) {
+        *error = path + ": bad record in chunk at " + std::to_string(chunk_offset);
+        return false;
+      }
+      ArchiveRecord record;
+      record.track = chunk.track;
+      record.flags = header.flags;
+      record.timestamp_us = header.timestamp_us;
+      record.source_time = header.source_time;
+      record.payload.assign(data.begin() + offset, data.begin() + offset + header.size);
+      segment->records.push_back(std::move(record));
+      flags |= header.flags;
+      offset += Align8(header.size);
+    }
+    if (offset != end || flags != chunk.flags) {
+      *error = path + ": chunk at " + std::to_string(chunk_offset) + " does not add up";
+      return false;
+    }
+    const uint32_t size = static_cast<uint32_t>(AlignBlock(chunk.bytes));
+    segment->chunks.push_back({chunk_offset, size, chunk.track, chunk.flags, chunk.records, 0,
+                               chunk.first_us, chunk.last_us});
+    offset = chunk_offset + size;
+  }
+
+  std::string index = path;
+  index.replace(index.size() - 4, 4, "zidx");
+  return ReadIndex(index, segment, error);
+}
+
+std::vector<std::string> ListSegments(const std::string& directory, const std::string& prefix) {
+  std::vector<std::string> paths;
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    return paths;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    const std::string name = entry->d_name;
+    if (name.size() > prefix.size() + 5 && name.compare(0, prefix.size() + 1, prefix + "-") == 0 &&
+        name.compare(name.size() - 5, 5, ".zarc") == 0) {
+      paths.push_back(directory + "/" + name);
+    }
+  }
+  closedir(dir);
+  // Segment numbers are zero padded, so names sort in segment order.
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+}  // namespace call_archive
@@ -0,0 +1,39 @@
+#ifndef FLUTTER_ARCHIVE_READER_H_
+#define FLUTTER_ARCHIVE_READER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "call_archiver.h"
+
+namespace call_archive {
+
+struct ArchiveRecord {
+  uint16_t track;
+  uint16_t flags;
+  int64_t timestamp_us;
+  int64_t source_time;
+  std::vector<uint8_t> payload;
+};
+
+struct ArchiveSegment {
+  std::string path;
+  SegmentHeader header;
+  std::vector<IndexEntry> chunks;  // as found by scanning the .zarc
+  std::vector<ArchiveRecord> records;
+  bool has_index = false;
+  std::vector<TrackInfo> tracks;  // from the .zidx, indexed by track
+};
+
+// Reads one .zarc segment by scanning its chunks, and its .zidx when one was
+// written. Fails on anything the CallArchiver would not have produced, and
+// when the index disagrees with the chunks actually found.
+bool ReadSegment(const std::string& path, ArchiveSegment* segment, std::string* error);
+
+// The .zarc segments of |prefix| in |directory|, in segment order.
+std::vector<std::string> ListSegments(const std::string& directory, const std::string& prefix);
+
+}  // namespace call_archive
+
+#endif  // FLUTTER_ARCHIVE_READER_H_
@@ -0,0 +1,302 @@
+// Drives audio_tap::AudioTap the way the SDK does, without an engine: an
+// audio thread calls the IZegoAudioDataHandler callbacks every 10 ms while a
+// consumer thread reads. Every callback is timed and every allocation it
+// makes is counted, so a lock, a wait on the consumer or a heap allocation on
+// the audio thread fails the test.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio_tap.h"
+
+namespace {
+
+// Allocations made by threads that set |tl_count_allocations|.
+thread_local bool tl_count_allocations = false;
+std::atomic<uint64_t> g_audio_thread_allocations{0};
+
+}  // namespace
+
+// Kept out of line, or GCC pairs the malloc and free below with the new and
+// delete expressions they were inlined into and warns.
+__attribute__((noinline)) void* operator new(size_t size) {
+  if (tl_count_allocations) {
+    g_audio_thread_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+  void* block = std::malloc(size == 0 ? 1 : size);
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  return block;
+}
+
+__attribute__((noinline)) void operator delete(void* block) noexcept { std::free(block); }
+
+__attribute__((noinline)) void operator delete(void* block, size_t) noexcept { std::free(block); }
+
+namespace audio_tap {
+namespace {
+
+using ZEGO::EXPRESS::ZegoAudioFrameParam;
+
+constexpr int kSampleRate = 48000;
+constexpr int kChannels = 2;
+constexpr int kFrameSamples = kSampleRate / 100 * kChannels;  // 10 ms
+constexpr int kFrameBytes = kFrameSamples * static_cast<int>(sizeof(int16_t));
+
+// Generous for a memcpy of a few KiB, tight enough to catch a callback that
+// sleeps or waits for the consumer.
+constexpr int64_t kMaxCallbackUs = 2000;
+
+ZegoAudioFrameParam Param() {
+  ZegoAudioFrameParam param;
+  param.sampleRate = ZEGO::EXPRESS::ZEGO_AUDIO_SAMPLE_RATE_48K;
+  param.channel = ZEGO::EXPRESS::ZEGO_AUDIO_CHANNEL_STEREO;
+  return param;
+}
+
+AudioTap::Options TapOptions(int buffer_ms) {
+  AudioTap::Options options;
+  options.sources = kCaptured | kPlayer;
+  options.param = Param();
+  options.buffer_ms = buffer_ms;
+  options.max_player_streams = 2;
+  return options;
+}
+
+// Sample |i| of frame |sequence| of |stream|, so a reader can tell frames apart.
+int16_t Sample(int stream, uint64_t sequence, int i) {
+  return static_cast<int16_t>(stream * 10000 + static_cast<int>(sequence % 1000) * 7 + i % 7);
+}
+
+const SourceStats* FindSource(const Stats& stats, Source source, const std::string& stream_id) {
+  for (const SourceStats& entry : stats.sources) {
+    if (entry.source == source && entry.stream_id == stream_id) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+// Calls the capture callback and one player callback per stream every 10 ms
+// on a thread of its own, like the SDK's audio thread.
+class AudioThread {
+ public:
+  AudioThread(AudioTap* tap, int frames, std::vector<std::string> streams)
+      : tap_(tap), frames_(frames), streams_(std::move(streams)) {}
+
+  void Start() { thread_ = std::thread(&AudioThread::Run, this); }
+  void Join() { thread_.join(); }
+
+  int64_t max_callback_us() const { return max_callback_us_; }
+
+ private:
+  void Run() {
+    // Built before counting starts: the SDK owns its buffers too.
+    std::vector<std::vector<int16_t>> buffers(streams_.size() + 1,
+                                              std::vector<int16_t>(kFrameSamples));
+    const ZegoAudioFrameParam param = Param();
+    tl_count_allocations = true;
+    auto next = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames_; frame++) {
+      std::this_thread::sleep_until(next);
+      for (size_t i = 0; i < buffers.size(); i++) {
+        for (int s = 0; s < kFrameSamples; s++) {
+          buffers[i][s] = Sample(static_cast<int>(i), static_cast<uint64_t>(frame), s);
+        }
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(buffers[i].data());
+        const auto begin = std::chrono::steady_clock::now();
+        if (i == 0) {
+          tap_->onCapturedAudioData(data, kFrameBytes, param);
+        } else {
+          tap_->onPlayerAudioData(data, kFrameBytes, param, streams_[i - 1]);
+        }
+        const int64_t took = std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - begin)
+                                 .count();
+        max_callback_us_ = std::max(max_callback_us_, took);
+      }
+      next += std::chrono::milliseconds(10);
+    }
+    tl_count_allocations = false;
+  }
+
+  AudioTap* const tap_;
+  const int frames_;
+  const std::vector<std::string> streams_;
+  std::thread thread_;
+  int64_t max_callback_us_ = 0;
+};
+
+class AudioTapTest : public ::testing::Test {
+ protected:
+  void SetUp() override { g_audio_thread_allocations.store(0); }
+};
+
+TEST_F(AudioTapTest, ConsumerReadsEveryFrameInOrder) {
+  AudioTap tap(TapOptions(2000));
+  const int frames = 100;
+  AudioThread audio(&tap, frames, {"remote-1", "remote-2"});
+  audio.Start();
+
+  // Sequence expected next, and content checked per source.
+  uint64_t next[3] = {0, 0, 0};
+  int read = 0;
+  AudioFrame frame;
+  while (read < frames * 3 && tap.Read(&frame, 1000)) {
+    int stream = 0;
+    if (frame.source == kPlayer) {
+      ASSERT_TRUE(frame.stream_id == "remote-1" || frame.stream_id == "remote-2");
+      stream = frame.stream_id == "remote-1" ? 1 : 2;
+    } else {
+      ASSERT_EQ(frame.source, kCaptured);
+      EXPECT_TRUE(frame.stream_id.empty());
+    }
+    EXPECT_EQ(frame.sequence, next[stream]);
+    next[stream] = frame.sequence + 1;
+    EXPECT_EQ(frame.sample_rate, kSampleRate);
+    EXPECT_EQ(frame.channels, kChannels);
+    ASSERT_EQ(frame.samples.size(), static_cast<size_t>(kFrameSamples));
+    EXPECT_EQ(frame.samples[0], Sample(stream, frame.sequence, 0));
+    EXPECT_EQ(frame.samples.back(), Sample(stream, frame.sequence, kFrameSamples - 1));
+    read++;
+  }
+  audio.Join();
+
+  EXPECT_EQ(read, frames * 3);
+  for (uint64_t expected : next) {
+    EXPECT_EQ(expected, static_cast<uint64_t>(frames));
+  }
+  const Stats stats = tap.GetStats();
+  for (const SourceStats& source : stats.sources) {
+    EXPECT_EQ(source.frames, static_cast<uint64_t>(frames));
+    EXPECT_EQ(source.overruns, 0u);
+    EXPECT_EQ(source.pending, 0u);
+  }
+  EXPECT_EQ(stats.unmatched, 0u);
+  EXPECT_LT(audio.max_callback_us(), kMaxCallbackUs);
+  EXPECT_EQ(g_audio_thread_allocations.load(), 0u);
+}
+
+TEST_F(AudioTapTest, StalledConsumerDropsInsteadOfBlocking) {
+  // 100 ms of buffering against 500 ms of audio with nobody reading.
+  AudioTap tap(TapOptions(100));
+  const int frames = 50;
+  AudioThread audio(&tap, frames, {"remote-1"});
+  audio.Start();
+  audio.Join();
+
+  const Stats stats = tap.GetStats();
+  const SourceStats* captured = FindSource(stats, kCaptured, "");
+  const SourceStats* player = FindSource(stats, kPlayer, "remote-1");
+  ASSERT_NE(captured, nullptr);
+  ASSERT_NE(player, nullptr);
+  for (const SourceStats* source : {captured, player}) {
+    EXPECT_EQ(source->frames, static_cast<uint64_t>(frames));
+    EXPECT_EQ(source->pending, 16u);
+    EXPECT_EQ(source->overruns, source->frames - source->pending);
+  }
+  EXPECT_LT(audio.max_callback_us(), kMaxCallbackUs);
+  EXPECT_EQ(g_audio_thread_allocations.load(), 0u);
+
+  // The queued frames are the oldest ones; the sequence gap shows the loss.
+  AudioFrame frame;
+  ASSERT_TRUE(tap.TryRead(&frame));
+  EXPECT_EQ(frame.sequence, 0u);
+}
+
+TEST_F(AudioTapTest, SlowConsumerCatchesUpWithoutLoss) {
+  // A consumer that stalls for 150 ms at a time stays within 2 s of buffering.
+  AudioTap tap(TapOptions(2000));
+  const int frames = 60;
+  AudioThread audio(&tap, frames, {"remote-1"});
+  audio.Start();
+  int read = 0;
+  AudioFrame frame;
+  while (read < frames * 2) {
+    if (read % 30 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    }
+    if (!tap.Read(&frame, 1000)) {
+      break;
+    }
+    read++;
+  }
+  audio.Join();
+
+  EXPECT_EQ(read, frames * 2);
+  for (const SourceStats& source : tap.GetStats().sources) {
+    EXPECT_EQ(source.overruns, 0u);
+  }
+  EXPECT_LT(audio.max_callback_us(), kMaxCallbackUs);
+  EXPECT_EQ(g_audio_thread_allocations.load(), 0u);
+}
+
+TEST_F(AudioTapTest, ReadWaitsForTheNextFrame) {
+  AudioTap tap(TapOptions(200));
+  AudioFrame frame;
+  EXPECT_FALSE(tap.TryRead(&frame));
+  EXPECT_FALSE(tap.Read(&frame, 20));
+  EXPECT_EQ(tap.GetStats().underruns, 2u);
+
+  std::vector<int16_t> samples(kFrameSamples, 1);
+  std::thread producer([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    tap.onCapturedAudioData(reinterpret_cast<const unsigned char*>(samples.data()),
+                            kFrameBytes, Param());
+  });
+  const auto begin = std::chrono::steady_clock::now();
+  EXPECT_TRUE(tap.Read(&frame, 5000));
+  EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(1));
+  producer.join();
+}
+
+TEST_F(AudioTapTest, ReleasedPlayerSlotIsReused) {
+  AudioTap tap(TapOptions(200));
+  std::vector<int16_t> samples(kFrameSamples, 1);
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(samples.data());
+
+  tap.onPlayerAudioData(data, kFrameBytes, Param(), "remote-1");
+  tap.onPlayerAudioData(data, kFrameBytes, Param(), "remote-2");
+  tap.onPlayerAudioData(data, kFrameBytes, Param(), "remote-3");
+  EXPECT_EQ(tap.GetStats().unmatched, 1u);
+
+  // Frames of a released stream are still read, then its slot is free.
+  tap.ReleasePlayerStream("remote-1");
+  tap.onPlayerAudioData(data, kFrameBytes, Param(), "remote-1");
+  AudioFrame frame;
+  ASSERT_TRUE(tap.TryRead(&frame));
+  EXPECT_EQ(frame.stream_id, "remote-1");
+  ASSERT_TRUE(tap.TryRead(&frame));
+  EXPECT_EQ(frame.stream_id, "remote-2");
+  EXPECT_FALSE(tap.TryRead(&frame));
+
+  tap.onPlayerAudioData(data, kFrameBytes, Param(), "remote-3");
+  ASSERT_TRUE(tap.TryRead(&frame));
+  EXPECT_EQ(frame.stream_id, "remote-3");
+  EXPECT_EQ(frame.sequence, 0u);
+  EXPECT_EQ(tap.GetStats().unmatched, 2u);
+}
+
+TEST_F(AudioTapTest, LongFramesAreTruncated) {
+  AudioTap::Options options = TapOptions(200);
+  options.max_frame_ms = 10;
+  AudioTap tap(options);
+  std::vector<int16_t> samples(kFrameSamples * 2, 1);
+  tap.onCapturedAudioData(reinterpret_cast<const unsigned char*>(samples.data()),
+                          kFrameBytes * 2, Param());
+  AudioFrame frame;
+  ASSERT_TRUE(tap.TryRead(&frame));
+  EXPECT_EQ(frame.samples.size(), static_cast<size_t>(kFrameSamples));
+  EXPECT_EQ(FindSource(tap.GetStats(), kCaptured, "")->truncated, 1u);
+}
+
+}  // namespace
+}  // namespace audio_tap
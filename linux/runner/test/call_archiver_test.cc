@@ -0,0 +1,309 @@
+// Replays a synthetic call into call_archive::CallArchiver without an engine
+// and reads it back with archive_reader: remote video arrives through
+// onRemoteVideoFrameEncodedData at 30 fps and audio through an AudioTap at
+// 10 ms, for every participant. Every frame must come back intact and in
+// order, with chunks on disk within a bounded time of being filled.
+
+#include <gtest/gtest.h>
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "archive_reader.h"
+#include "audio_tap.h"
+#include "call_archiver.h"
+
+namespace call_archive {
+namespace {
+
+constexpr int kStreams = 3;
+constexpr int kCallMs = 2500;
+constexpr int kVideoFps = 30;
+constexpr int kKeyFrameInterval = 30;
+constexpr int kAudioFrameSamples = 480 * 2;  // 10 ms of 48 kHz stereo
+
+// Generous for a loaded single core, far below anything a blocked writer or
+// a chunk stuck in a queue would show.
+constexpr int64_t kMaxWriteUs = 500 * 1000;
+
+std::string StreamId(int stream) {
+  return "remote-" + std::to_string(stream);
+}
+
+// Keyframes of about 40 KB, other frames between 3 and 6 KB.
+size_t VideoFrameSize(int stream, int frame) {
+  if (frame % kKeyFrameInterval == 0) {
+    return 40000 + static_cast<size_t>(stream) * 1000;
+  }
+  return 3000 + static_cast<size_t>(frame * 997 + stream * 131) % 3000;
+}
+
+uint8_t PayloadByte(int stream, int64_t frame, size_t i) {
+  return static_cast<uint8_t>(stream * 31 + frame * 7 + static_cast<int64_t>(i));
+}
+
+ZEGO::EXPRESS::ZegoAudioFrameParam AudioParam() {
+  ZEGO::EXPRESS::ZegoAudioFrameParam param;
+  param.sampleRate = ZEGO::EXPRESS::ZEGO_AUDIO_SAMPLE_RATE_48K;
+  param.channel = ZEGO::EXPRESS::ZEGO_AUDIO_CHANNEL_STEREO;
+  return param;
+}
+
+int16_t AudioSample(int stream, int64_t frame, int i) {
+  return static_cast<int16_t>(stream * 1000 + frame * 3 + i % 5);
+}
+
+class CallArchiverTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    char directory[] = "/tmp/call_archiver_test.XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    directory_ = directory;
+  }
+
+  void TearDown() override {
+    if (DIR* dir = opendir(directory_.c_str())) {
+      while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+          unlink((directory_ + "/" + entry->d_name).c_str());
+        }
+      }
+      closedir(dir);
+    }
+    rmdir(directory_.c_str());
+  }
+
+  CallArchiver::Options ArchiverOptions() const {
+    CallArchiver::Options options;
+    options.directory = directory_;
+    options.segment_seconds = 1;
+    options.chunk_bytes = 256 * 1024;
+    options.flush_interval_ms = 200;
+    options.use_io_uring = GetParam();
+    return options;
+  }
+
+  std::vector<ArchiveSegment> ReadAll() {
+    std::vector<ArchiveSegment> segments;
+    for (const std::string& path : ListSegments(directory_, "call")) {
+      ArchiveSegment segment;
+      std::string error;
+      EXPECT_TRUE(ReadSegment(path, &segment, &error)) << error;
+      EXPECT_TRUE(segment.has_index) << path;
+      segments.push_back(std::move(segment));
+    }
+    return segments;
+  }
+
+  std::string directory_;
+};
+
+// Renders remote video at 30 fps, one frame per stream per tick.
+void ReplayVideo(CallArchiver* archiver, int frames) {
+  std::vector<uint8_t> buffer(64 * 1024);
+  auto next = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    std::this_thread::sleep_until(next);
+    for (int stream = 0; stream < kStreams; stream++) {
+      const size_t size = VideoFrameSize(stream, frame);
+      for (size_t i = 0; i < size; i++) {
+        buffer[i] = PayloadByte(stream, frame, i);
+      }
+      ZEGO::EXPRESS::ZegoVideoEncodedFrameParam param;
+      param.format = ZEGO::EXPRESS::ZEGO_VIDEO_ENCODED_FRAME_FORMAT_AVCC;
+      param.isKeyFrame = frame % kKeyFrameInterval == 0;
+      archiver->onRemoteVideoFrameEncodedData(buffer.data(), static_cast<unsigned int>(size),
+                                              param, static_cast<unsigned long long>(frame),
+                                              StreamId(stream));
+    }
+    next += std::chrono::microseconds(1000000 / kVideoFps);
+  }
+}
+
+// Captures local audio and plays every remote stream, 10 ms at a time.
+void ReplayAudio(audio_tap::AudioTap* tap, int frames) {
+  std::vector<int16_t> samples(kAudioFrameSamples);
+  const unsigned char* data = reinterpret_cast<const unsigned char*>(samples.data());
+  const unsigned int bytes = static_cast<unsigned int>(samples.size() * sizeof(int16_t));
+  auto next = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; frame++) {
+    std::this_thread::sleep_until(next);
+    for (int stream = -1; stream < kStreams; stream++) {
+      for (int i = 0; i < kAudioFrameSamples; i++) {
+        samples[i] = AudioSample(stream, frame, i);
+      }
+      if (stream < 0) {
+        tap->onCapturedAudioData(data, bytes, AudioParam());
+      } else {
+        tap->onPlayerAudioData(data, bytes, AudioParam(), StreamId(stream));
+      }
+    }
+    next += std::chrono::milliseconds(10);
+  }
+}
+
+TEST_P(CallArchiverTest, ReplayedCallIsArchivedWithoutLoss) {
+  const int video_frames = kCallMs * kVideoFps / 1000;
+  const int audio_frames = kCallMs / 10;
+  const uint64_t total = static_cast<uint64_t>(video_frames * kStreams) +
+                         static_cast<uint64_t>(audio_frames * (kStreams + 1));
+
+  CallArchiver archiver(ArchiverOptions());
+  std::string error;
+  ASSERT_TRUE(archiver.Start(&error)) << error;
+  audio_tap::AudioTap::Options tap_options;
+  tap_options.param = AudioParam();
+  std::shared_ptr<audio_tap::AudioTap> tap = std::make_shared<audio_tap::AudioTap>(tap_options);
+  archiver.AttachAudioTap(tap);
+
+  std::thread video(&ReplayVideo, &archiver, video_frames);
+  std::thread audio(&ReplayAudio, tap.get(), audio_frames);
+  video.join();
+  audio.join();
+  // The pump is still moving the last audio out of the tap.
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (archiver.GetStats().frames < total && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  archiver.Stop();
+
+  const ArchiverStats stats = archiver.GetStats();
+  EXPECT_EQ(stats.frames, total);
+  EXPECT_EQ(stats.dropped, 0u);
+  EXPECT_EQ(stats.oversized, 0u);
+  EXPECT_EQ(stats.write_errors, 0u);
+  EXPECT_GE(stats.segments, 2u);
+  EXPECT_LT(stats.max_write_us, kMaxWriteUs) << stats.writer;
+  // A chunk may wait out the flush interval and one poll before it is sealed.
+  EXPECT_LT(stats.max_frame_latency_us, 200 * 1000 + kMaxWriteUs) << stats.writer;
+
+  std::vector<ArchiveSegment> segments = ReadAll();
+  ASSERT_EQ(segments.size(), stats.segments);
+  // Tracks are numbered once per archiver, so every index lists the same ones.
+  const std::vector<TrackInfo>& tracks = segments.back().tracks;
+  ASSERT_EQ(tracks.size(), static_cast<size_t>(kStreams * 2 + 1));
+
+  std::map<std::pair<int, std::string>, std::vector<const ArchiveRecord*>> by_stream;
+  for (size_t s = 0; s < segments.size(); s++) {
+    EXPECT_EQ(segments[s].header.segment, s);
+    for (const ArchiveRecord& record : segments[s].records) {
+      ASSERT_LT(record.track, tracks.size());
+      const TrackInfo& info = tracks[record.track];
+      by_stream[{static_cast<int>(info.kind), info.stream_id}].push_back(&record);
+    }
+  }
+
+  for (int stream = 0; stream < kStreams; stream++) {
+    const std::vector<const ArchiveRecord*>& records =
+        by_stream[{static_cast<int>(TrackKind::kVideo), StreamId(stream)}];
+    ASSERT_EQ(records.size(), static_cast<size_t>(video_frames)) << StreamId(stream);
+    for (int frame = 0; frame < video_frames; frame++) {
+      const ArchiveRecord& record = *records[frame];
+      ASSERT_EQ(record.source_time, frame);
+      EXPECT_EQ(record.flags, frame % kKeyFrameInterval == 0 ? kKeyFrame : 0);
+      ASSERT_EQ(record.payload.size(), VideoFrameSize(stream, frame));
+      for (size_t i = 0; i < record.payload.size(); i += 97) {
+        ASSERT_EQ(record.payload[i], PayloadByte(stream, frame, i));
+      }
+    }
+  }
+  for (int stream = -1; stream < kStreams; stream++) {
+    const std::string id = stream < 0 ? "@capture" : StreamId(stream);
+    const std::vector<const ArchiveRecord*>& records =
+        by_stream[{static_cast<int>(TrackKind::kAudio), id}];
+    ASSERT_EQ(records.size(), static_cast<size_t>(audio_frames)) << id;
+    for (int frame = 0; frame < audio_frames; frame++) {
+      const ArchiveRecord& record = *records[frame];
+      ASSERT_EQ(record.source_time, frame) << id;
+      ASSERT_EQ(record.payload.size(), kAudioFrameSamples * sizeof(int16_t));
+      int16_t first;
+      memcpy(&first, record.payload.data(), sizeof(first));
+      ASSERT_EQ(first, AudioSample(stream, frame, 0)) << id;
+    }
+  }
+  for (const TrackInfo& info : tracks) {
+    if (info.kind == TrackKind::kAudio) {
+      EXPECT_EQ(info.sample_rate, 48000u);
+      EXPECT_EQ(info.channels, 2u);
+    } else {
+      EXPECT_EQ(info.codec,
+                static_cast<uint32_t>(ZEGO::EXPRESS::ZEGO_VIDEO_ENCODED_FRAME_FORMAT_AVCC));
+    }
+  }
+}
+
+TEST_P(CallArchiverTest, ConcurrentFirstFramesAddEachStreamOnce) {
+  const int streams = 16;
+  CallArchiver::Options options = ArchiverOptions();
+  options.max_tracks = streams;
+  options.chunk_bytes = 16 * 1024;
+  options.chunks_per_track = 2;
+  CallArchiver archiver(options);
+  std::string error;
+  ASSERT_TRUE(archiver.Start(&error)) << error;
+
+  std::vector<std::thread> renderers;
+  for (int t = 0; t < 4; t++) {
+    renderers.emplace_back([&archiver, t]() {
+      const uint8_t frame[64] = {};
+      ZEGO::EXPRESS::ZegoVideoEncodedFrameParam param;
+      for (int i = 0; i < streams * 4; i++) {
+        archiver.onRemoteVideoFrameEncodedData(frame, sizeof(frame), param, 0,
+                                               StreamId((i + t * 5) % streams));
+      }
+    });
+  }
+  for (std::thread& renderer : renderers) {
+    renderer.join();
+  }
+  archiver.Stop();
+
+  EXPECT_EQ(archiver.GetStats().frames, static_cast<uint64_t>(streams * 4 * 4));
+  std::vector<ArchiveSegment> segments = ReadAll();
+  ASSERT_EQ(segments.size(), 1u);
+  ASSERT_EQ(segments[0].tracks.size(), static_cast<size_t>(streams));
+  std::map<std::string, int> frames;
+  for (const ArchiveRecord& record : segments[0].records) {
+    frames[segments[0].tracks[record.track].stream_id]++;
+  }
+  ASSERT_EQ(frames.size(), static_cast<size_t>(streams));
+  for (const auto& stream : frames) {
+    EXPECT_EQ(stream.second, 16) << stream.first;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Writers, CallArchiverTest, ::testing::Values(true, false),
+                         [](const ::testing::TestParamInfo<bool>& info) {
+                           return info.param ? "io_uring" : "thread";
+                         });
+
+TEST(CallArchiverTracksTest, TracksAreKeyedByKindAndStream) {
+  CallArchiver::Options options;
+  options.max_tracks = 3;
+  CallArchiver archiver(options);
+  EXPECT_EQ(archiver.FindTrack(TrackKind::kVideo, "a", 1), -1);
+  EXPECT_EQ(archiver.AddTrack({TrackKind::kVideo, "a", 0, 0, 0}), 0);
+  EXPECT_EQ(archiver.AddTrack({TrackKind::kVideo, "a", 0, 0, 0}), 0);
+  EXPECT_EQ(archiver.AddTrack({TrackKind::kAudio, "a", 0, 48000, 2}), 1);
+  EXPECT_EQ(archiver.FindTrack(TrackKind::kVideo, "a", 1), 0);
+  EXPECT_EQ(archiver.FindTrack(TrackKind::kAudio, "a", 1), 1);
+  EXPECT_EQ(archiver.FindTrack(TrackKind::kVideo, "ab", 1), 0);
+  EXPECT_EQ(archiver.FindTrack(TrackKind::kVideo, "ab", 2), -1);
+  EXPECT_EQ(archiver.AddTrack({TrackKind::kVideo, "", 0, 0, 0}), 2);
+  EXPECT_EQ(archiver.FindTrack(TrackKind::kVideo, "", 0), 2);
+  EXPECT_EQ(archiver.AddTrack({TrackKind::kVideo, "b", 0, 0, 0}), -1);
+  EXPECT_EQ(archiver.FindTrack(TrackKind::kVideo, "b", 1), -1);
+}
+
+}  // namespace
+}  // namespace call_archive
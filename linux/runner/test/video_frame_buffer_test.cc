@@ -0,0 +1,140 @@
+// Drives video_texture::StreamState, the per-stream triple buffer behind the
+// video texture bridge, the way the SDK render thread and the raster thread
+// do, without Flutter: one thread converts and publishes frames while another
+// presents them. Every presented frame must be whole and no older than the
+// one before, and the received, presented, dropped and late counters must
+// add up to what both sides did.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "video_frame_buffer.h"
+
+namespace video_texture {
+namespace {
+
+constexpr uint32_t kWidth = 64;
+constexpr uint32_t kHeight = 36;
+
+// Writes a frame whose every byte is |tag| and whose width tells it apart.
+void WriteFrame(FrameSlot* slot, uint32_t tag) {
+  slot->pixels.assign(static_cast<size_t>(kWidth) * kHeight * 4, static_cast<uint8_t>(tag));
+  slot->width = kWidth + tag;
+  slot->height = kHeight;
+}
+
+TEST(TripleBufferTest, HandsOverTheNewestFrame) {
+  TripleBuffer buffer;
+  EXPECT_FALSE(buffer.Consume());
+
+  buffer.back().width = 1;
+  EXPECT_TRUE(buffer.Publish());
+  EXPECT_TRUE(buffer.Consume());
+  EXPECT_EQ(buffer.front().width, 1u);
+  EXPECT_FALSE(buffer.Consume());
+  EXPECT_EQ(buffer.front().width, 1u);
+
+  // The second publish replaces the first before it was consumed
+  buffer.back().width = 2;
+  EXPECT_TRUE(buffer.Publish());
+  buffer.back().width = 3;
+  EXPECT_FALSE(buffer.Publish());
+  EXPECT_TRUE(buffer.Consume());
+  EXPECT_EQ(buffer.front().width, 3u);
+
+  // The producer never writes into the slot being shown
+  EXPECT_NE(&buffer.back(), &buffer.front());
+}
+
+TEST(StreamStateTest, CountsReceivedPresentedAndDroppedFrames) {
+  StreamState state;
+  EXPECT_EQ(state.Present(0).width, 0u);
+
+  for (uint32_t tag = 1; tag <= 3; tag++) {
+    WriteFrame(state.back(), tag);
+    // Only the first frame since the last present asks for a redraw
+    EXPECT_EQ(state.Publish(1000), tag == 1);
+  }
+  EXPECT_EQ(state.Present(2000).width, kWidth + 3);
+  // Nothing new: the same frame again, not presented twice
+  EXPECT_EQ(state.Present(3000).width, kWidth + 3);
+
+  StreamStats stats = state.stats();
+  EXPECT_EQ(stats.received, 3u);
+  EXPECT_EQ(stats.dropped, 2u);
+  EXPECT_EQ(stats.presented, 1u);
+  EXPECT_EQ(stats.late, 0u);
+  EXPECT_EQ(stats.width, kWidth + 3);
+  EXPECT_EQ(stats.height, kHeight);
+}
+
+TEST(StreamStateTest, CountsFramesPresentedAfterTheThresholdAsLate) {
+  StreamState state;
+  WriteFrame(state.back(), 1);
+  state.Publish(1000);
+  state.Present(1000 + StreamState::kLateThresholdUs);
+  WriteFrame(state.back(), 2);
+  state.Publish(100000);
+  state.Present(100000 + StreamState::kLateThresholdUs + 1);
+
+  StreamStats stats = state.stats();
+  EXPECT_EQ(stats.presented, 2u);
+  EXPECT_EQ(stats.late, 1u);
+}
+
+TEST(StreamStateTest, PresentsWholeFramesWhileTheProducerRuns) {
+  constexpr uint32_t kFrames = 5000;
+  StreamState state;
+  std::atomic<bool> done{false};
+  std::thread producer([&]() {
+    for (uint32_t tag = 1; tag <= kFrames; tag++) {
+      WriteFrame(state.back(), tag);
+      state.Publish(tag);
+      // Paced like a camera, only much faster, so the consumer gets to run
+      if (tag % 16 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    }
+    done.store(true);
+  });
+
+  uint64_t torn = 0;
+  uint64_t backwards = 0;
+  uint32_t last = 0;
+  auto check = [&](const FrameSlot& frame) {
+    if (frame.width == 0) {
+      return;
+    }
+    uint32_t tag = frame.width - kWidth;
+    for (uint8_t byte : frame.pixels) {
+      if (byte != static_cast<uint8_t>(tag)) {
+        torn++;
+        break;
+      }
+    }
+    backwards += tag < last ? 1 : 0;
+    last = tag;
+  };
+  while (!done.load()) {
+    check(state.Present(0));
+  }
+  producer.join();
+  check(state.Present(0));
+
+  EXPECT_EQ(torn, 0u);
+  EXPECT_EQ(backwards, 0u);
+  EXPECT_EQ(last, kFrames);
+  // Every frame was either shown or replaced before it could be
+  StreamStats stats = state.stats();
+  EXPECT_EQ(stats.received, kFrames);
+  EXPECT_EQ(stats.presented + stats.dropped, stats.received);
+  EXPECT_GT(stats.presented, 1u);
+}
+
+}  // namespace
+}  // namespace video_texture
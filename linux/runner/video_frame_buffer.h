@@ -0,0 +1,129 @@
+#ifndef FLUTTER_VIDEO_FRAME_BUFFER_H_
+#define FLUTTER_VIDEO_FRAME_BUFFER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace video_texture {
+
+struct FrameSlot {
+  std::vector<uint8_t> pixels;  // RGBA8888, tightly packed
+  uint32_t width = 0;
+  uint32_t height = 0;
+  int64_t published_us = 0;
+};
+
+// Single-producer single-consumer triple buffer. The producer (the SDK render
+// thread of one stream) owns the back slot, the consumer (the raster thread)
+// owns the front slot, and the middle slot is handed over with one atomic
+// exchange, so neither side ever waits for the other.
+class TripleBuffer {
+ public:
+  FrameSlot& back() { return slots_[state_.load(std::memory_order_acquire) & 3]; }
+  const FrameSlot& front() const {
+    return slots_[(state_.load(std::memory_order_acquire) >> 4) & 3];
+  }
+
+  // Publishes the back slot as the newest frame. Returns false when the frame
+  // it replaces was never presented, i.e. that frame is dropped.
+  bool Publish() {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    uint32_t next;
+    do {
+      uint32_t back = state & 3, middle = (state >> 2) & 3, front = (state >> 4) & 3;
+      next = middle | (back << 2) | (front << 4) | kFresh;
+    } while (!state_.compare_exchange_weak(state, next, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed));
+    return (state & kFresh) == 0;
+  }
+
+  // Moves the newest published frame to the front slot. Returns false when
+  // nothing new was published since the last call.
+  bool Consume() {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    uint32_t next;
+    do {
+      if ((state & kFresh) == 0) {
+        return false;
+      }
+      uint32_t back = state & 3, middle = (state >> 2) & 3, front = (state >> 4) & 3;
+      next = back | (front << 2) | (middle << 4);
+    } while (!state_.compare_exchange_weak(state, next, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed));
+    return true;
+  }
+
+ private:
+  // Bits 0-1: back, bits 2-3: middle, bits 4-5: front, bit 6: the middle slot
+  // holds a frame that has not been presented yet.
+  static constexpr uint32_t kFresh = 1u << 6;
+  std::atomic<uint32_t> state_{0u | (1u << 2) | (2u << 4)};
+  FrameSlot slots_[3];
+};
+
+struct StreamStats {
+  uint64_t received;   // frames published by the producer
+  uint64_t presented;  // frames the consumer displayed
+  uint64_t dropped;    // frames replaced before they were displayed
+  uint64_t late;       // displayed frames older than kLateThresholdUs
+  uint32_t width;
+  uint32_t height;
+};
+
+// The triple buffer of one stream and its frame counters. Publish() is called
+// by the producer after it wrote back(), Present() by the consumer once per
+// displayed frame; stats() may be read from any thread.
+class StreamState {
+ public:
+  // A frame presented more than two 60 Hz vsyncs after it was published is
+  // counted as late.
+  static constexpr int64_t kLateThresholdUs = 34000;
+
+  FrameSlot* back() { return &buffer_.back(); }
+
+  // Publishes the frame written into back(). Returns true when the consumer
+  // has to be told about it; only the first unpresented frame does, later
+  // ones replace it in place and count it as dropped.
+  bool Publish(int64_t now_us) {
+    FrameSlot& slot = buffer_.back();
+    slot.published_us = now_us;
+    received_++;
+    width_ = slot.width;
+    height_ = slot.height;
+    if (buffer_.Publish()) {
+      return true;
+    }
+    dropped_++;
+    return false;
+  }
+
+  // Takes the newest published frame, if any, and returns the frame to show.
+  const FrameSlot& Present(int64_t now_us) {
+    if (buffer_.Consume()) {
+      presented_++;
+      if (now_us - buffer_.front().published_us > kLateThresholdUs) {
+        late_++;
+      }
+    }
+    return buffer_.front();
+  }
+
+  StreamStats stats() const {
+    return {received_.load(), presented_.load(), dropped_.load(),
+            late_.load(),     width_.load(),     height_.load()};
+  }
+
+ private:
+  TripleBuffer buffer_;
+  std::atomic<uint64_t> received_{0};
+  std::atomic<uint64_t> presented_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> late_{0};
+  std::atomic<uint32_t> width_{0};
+  std::atomic<uint32_t> height_{0};
+};
+
+}  // namespace video_texture
+
+#endif  // FLUTTER_VIDEO_FRAME_BUFFER_H_
@@ -0,0 +1,354 @@
+#include "video_texture_bridge.h"
+
+#include <ZegoExpressSDK.h>
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "video_convert.h"
+#include "video_frame_buffer.h"
+
+namespace {
+
+using video_texture::FrameSlot;
+using video_texture::StreamState;
+using video_texture::StreamStats;
+
+constexpr char kChannelName[] = "sleepcall/video_texture";
+constexpr char kCaptureStreamId[] = "@capture";
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Converts one SDK frame straight into |slot|, so each frame is touched once.
+bool WriteFrame(FrameSlot* slot, unsigned char** data,
+                const ZEGO::EXPRESS::ZegoVideoFrameParam& param,
+                ZEGO::EXPRESS::ZegoVideoFlipMode flip_mode) {
+  using namespace ZEGO::EXPRESS;
+  if (param.width <= 0 || param.height <= 0 || data == nullptr) {
+    return false;
+  }
+  video_convert::PixelFormat format;
+  switch (param.format) {
+    case ZEGO_VIDEO_FRAME_FORMAT_I420:
+      format = video_convert::PixelFormat::kI420;
+      break;
+    case ZEGO_VIDEO_FRAME_FORMAT_NV12:
+      format = video_convert::PixelFormat::kNV12;
+      break;
+    case ZEGO_VIDEO_FRAME_FORMAT_NV21:
+      format = video_convert::PixelFormat::kNV21;
+      break;
+    case ZEGO_VIDEO_FRAME_FORMAT_RGBA32:
+      format = video_convert::PixelFormat::kRGBA;
+      break;
+    case ZEGO_VIDEO_FRAME_FORMAT_BGRA32:
+      format = video_convert::PixelFormat::kBGRA;
+      break;
+    case ZEGO_VIDEO_FRAME_FORMAT_ARGB32:
+      format = video_convert::PixelFormat::kARGB;
+      break;
+    case ZEGO_VIDEO_FRAME_FORMAT_ABGR32:
+      format = video_convert::PixelFormat::kABGR;
+      break;
+    default:
+      return false;
+  }
+  video_convert::Frame src = {format, param.width, param.height,
+                              {data[0], data[1], data[2]},
+                              {param.strides[0], param.strides[1], param.strides[2]}};
+
+  uint32_t width = static_cast<uint32_t>(param.width);
+  uint32_t height = static_cast<uint32_t>(param.height);
+  slot->pixels.resize(static_cast<size_t>(width) * height * 4);
+  slot->width = width;
+  slot->height = height;
+  video_convert::Frame dst = video_convert::MakeFrame(
+      video_convert::PixelFormat::kRGBA, param.width, param.height, slot->pixels.data());
+  return video_convert::Convert(src, dst, static_cast<video_convert::FlipMode>(flip_mode));
+}
+
+}  // namespace
+
+G_DECLARE_FINAL_TYPE(StreamTexture, stream_texture, STREAM, TEXTURE,
+                     FlPixelBufferTexture)
+
+struct _StreamTexture {
+  FlPixelBufferTexture parent_instance;
+  StreamState* state;
+};
+
+G_DEFINE_TYPE(StreamTexture, stream_texture, fl_pixel_buffer_texture_get_type())
+
+// Runs on the raster thread, once per displayed frame of this texture.
+static gboolean stream_texture_copy_pixels(FlPixelBufferTexture* texture,
+                                           const uint8_t** out_buffer,
+                                           uint32_t* width, uint32_t* height,
+                                           GError** error) {
+  StreamState* state = STREAM_TEXTURE(texture)->state;
+  const FrameSlot& frame = state->Present(NowUs());
+  if (frame.width == 0) {
+    static const uint8_t kTransparent[4] = {0, 0, 0, 0};
+    *out_buffer = kTransparent;
+    *width = *height = 1;
+    return TRUE;
+  }
+  *out_buffer = frame.pixels.data();
+  *width = frame.width;
+  *height = frame.height;
+  return TRUE;
+}
+
+static void stream_texture_finalize(GObject* object) {
+  delete STREAM_TEXTURE(object)->state;
+  G_OBJECT_CLASS(stream_texture_parent_class)->finalize(object);
+}
+
+static void stream_texture_class_init(StreamTextureClass* klass) {
+  FL_PIXEL_BUFFER_TEXTURE_CLASS(klass)->copy_pixels = stream_texture_copy_pixels;
+  G_OBJECT_CLASS(klass)->finalize = stream_texture_finalize;
+}
+
+static void stream_texture_init(StreamTexture* self) {
+  self->state = new StreamState();
+}
+
+namespace {
+
+// Receives frames on the SDK's render threads. Frames of streams without a
+// texture are ignored before any copy is made.
+class RenderHandler : public ZEGO::EXPRESS::IZegoCustomVideoRenderHandler {
+ public:
+  explicit RenderHandler(FlTextureRegistrar* registrar)
+      : registrar_(FL_TEXTURE_REGISTRAR(g_object_ref(registrar))) {}
+
+  ~RenderHandler() override {
+    Clear();
+    g_object_unref(registrar_);
+  }
+
+  // Main thread.
+  int64_t CreateTexture(const std::string& stream_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = textures_.find(stream_id);
+    if (it != textures_.end()) {
+      return fl_texture_get_id(FL_TEXTURE(it->second));
+    }
+    StreamTexture* texture = STREAM_TEXTURE(g_object_new(stream_texture_get_type(), nullptr));
+    if (!fl_texture_registrar_register_texture(registrar_, FL_TEXTURE(texture))) {
+      g_object_unref(texture);
+      return -1;
+    }
+    textures_[stream_id] = texture;
+    return fl_texture_get_id(FL_TEXTURE(texture));
+  }
+
+  // Main thread.
+  void DestroyTexture(const std::string& stream_id) {
+    StreamTexture* texture = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = textures_.find(stream_id);
+      if (it == textures_.end()) {
+        return;
+      }
+      texture = it->second;
+      textures_.erase(it);
+    }
+    fl_texture_registrar_unregister_texture(registrar_, FL_TEXTURE(texture));
+    g_object_unref(texture);
+  }
+
+  void Clear() {
+    std::map<std::string, StreamTexture*> textures;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      textures.swap(textures_);
+    }
+    for (auto& entry : textures) {
+      fl_texture_registrar_unregister_texture(registrar_, FL_TEXTURE(entry.second));
+      g_object_unref(entry.second);
+    }
+  }
+
+  FlValue* GetStats() {
+    FlValue* result = fl_value_new_map();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : textures_) {
+      StreamStats counts = entry.second->state->stats();
+      FlValue* stats = fl_value_new_map();
+      fl_value_set_string_take(stats, "received", fl_value_new_int(counts.received));
+      fl_value_set_string_take(stats, "presented", fl_value_new_int(counts.presented));
+      fl_value_set_string_take(stats, "dropped", fl_value_new_int(counts.dropped));
+      fl_value_set_string_take(stats, "late", fl_value_new_int(counts.late));
+      fl_value_set_string_take(stats, "width", fl_value_new_int(counts.width));
+      fl_value_set_string_take(stats, "height", fl_value_new_int(counts.height));
+      fl_value_set_string_take(result, entry.first.c_str(), stats);
+    }
+    return result;
+  }
+
+  void onCapturedVideoFrameRawData(unsigned char** data, unsigned int* data_length,
+                                   ZEGO::EXPRESS::ZegoVideoFrameParam param,
+                                   ZEGO::EXPRESS::ZegoVideoFlipMode flip_mode,
+                                   ZEGO::EXPRESS::ZegoPublishChannel channel) override {
+    if (channel == ZEGO::EXPRESS::ZEGO_PUBLISH_CHANNEL_MAIN) {
+      Render(kCaptureStreamId, data, param, flip_mode);
+    }
+  }
+
+  void onRemoteVideoFrameRawData(unsigned char** data, unsigned int* data_length,
+                                 ZEGO::EXPRESS::ZegoVideoFrameParam param,
+                                 const std::string& stream_id) override {
+    Render(stream_id, data, param, ZEGO::EXPRESS::ZEGO_VIDEO_FLIP_MODE_NONE);
+  }
+
+ private:
+  void Render(const std::string& stream_id, unsigned char** data,
+              const ZEGO::EXPRESS::ZegoVideoFrameParam& param,
+              ZEGO::EXPRESS::ZegoVideoFlipMode flip_mode) {
+    StreamTexture* texture = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = textures_.find(stream_id);
+      if (it == textures_.end()) {
+        return;
+      }
+      texture = STREAM_TEXTURE(g_object_ref(it->second));
+    }
+    StreamState* state = texture->state;
+    // Only the first unpresented frame marks the texture, so the engine
+    // uploads at most once per displayed frame.
+    if (WriteFrame(state->back(), data, param, flip_mode) && state->Publish(NowUs())) {
+      fl_texture_registrar_mark_texture_frame_available(registrar_, FL_TEXTURE(texture));
+    }
+    g_object_unref(texture);
+  }
+
+  FlTextureRegistrar* registrar_;
+  std::mutex mutex_;
+  std::map<std::string, StreamTexture*> textures_;
+};
+
+}  // namespace
+
+struct _VideoTextureBridge {
+  GObject parent_instance;
+  FlMethodChannel* channel;
+  std::shared_ptr<RenderHandler>* handler;
+  gboolean enabled;
+};
+
+G_DEFINE_TYPE(VideoTextureBridge, video_texture_bridge, G_TYPE_OBJECT)
+
+static const gchar* lookup_stream_id(FlMethodCall* method_call) {
+  FlValue* args = fl_method_call_get_args(method_call);
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return nullptr;
+  }
+  FlValue* value = fl_value_lookup_string(args, "streamID");
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_STRING) {
+    return nullptr;
+  }
+  return fl_value_get_string(value);
+}
+
+static void method_call_cb(FlMethodChannel* channel, FlMethodCall* method_call,
+                           gpointer user_data) {
+  VideoTextureBridge* self = VIDEO_TEXTURE_BRIDGE(user_data);
+  RenderHandler* handler = self->handler->get();
+  const gchar* method = fl_method_call_get_name(method_call);
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (strcmp(method, "enable") == 0) {
+    ZEGO::EXPRESS::IZegoExpressEngine* engine = ZEGO::EXPRESS::ZegoExpressSDK::getEngine();
+    if (engine == nullptr) {
+      response = FL_METHOD_RESPONSE(
+          fl_method_error_response_new("NO_ENGINE", "ZegoExpressEngine is not created", nullptr));
+    } else {
+      if (!self->enabled) {
+        ZEGO::EXPRESS::ZegoCustomVideoRenderConfig config;
+        config.bufferType = ZEGO::EXPRESS::ZEGO_VIDEO_BUFFER_TYPE_RAW_DATA;
+        config.frameFormatSeries = ZEGO::EXPRESS::ZEGO_VIDEO_FRAME_FORMAT_SERIES_RGB;
+        config.enableEngineRender = false;
+        engine->enableCustomVideoRender(true, &config);
+        engine->setCustomVideoRenderHandler(*self->handler);
+        self->enabled = TRUE;
+      }
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    }
+  } else if (strcmp(method, "createTexture") == 0 || strcmp(method, "destroyTexture") == 0) {
+    const gchar* stream_id = lookup_stream_id(method_call);
+    if (stream_id == nullptr) {
+      response = FL_METHOD_RESPONSE(
+          fl_method_error_response_new("BAD_ARGS", "streamID is required", nullptr));
+    } else if (strcmp(method, "createTexture") == 0) {
+      int64_t texture_id = handler->CreateTexture(stream_id);
+      response = texture_id < 0
+                     ? FL_METHOD_RESPONSE(fl_method_error_response_new(
+                           "REGISTER_FAILED", "Failed to register texture", nullptr))
+                     : FL_METHOD_RESPONSE(
+                           fl_method_success_response_new(fl_value_new_int(texture_id)));
+    } else {
+      handler->DestroyTexture(stream_id);
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    }
+  } else if (strcmp(method, "getStats") == 0) {
+    g_autoptr(FlValue) stats = handler->GetStats();
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(stats));
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send response: %s", error->message);
+  }
+}
+
+static void video_texture_bridge_dispose(GObject* object) {
+  VideoTextureBridge* self = VIDEO_TEXTURE_BRIDGE(object);
+  if (self->enabled) {
+    ZEGO::EXPRESS::IZegoExpressEngine* engine = ZEGO::EXPRESS::ZegoExpressSDK::getEngine();
+    if (engine != nullptr) {
+      engine->setCustomVideoRenderHandler(nullptr);
+    }
+    self->enabled = FALSE;
+  }
+  if (self->handler != nullptr) {
+    (*self->handler)->Clear();
+    delete self->handler;
+    self->handler = nullptr;
+  }
+  g_clear_object(&self->channel);
+  G_OBJECT_CLASS(video_texture_bridge_parent_class)->dispose(object);
+}
+
+static void video_texture_bridge_class_init(VideoTextureBridgeClass* klass) {
+  G_OBJECT_CLASS(klass)->dispose = video_texture_bridge_dispose;
+}
+
+static void video_texture_bridge_init(VideoTextureBridge* self) {}
+
+VideoTextureBridge* video_texture_bridge_new(FlPluginRegistry* registry) {
+  VideoTextureBridge* self =
+      VIDEO_TEXTURE_BRIDGE(g_object_new(video_texture_bridge_get_type(), nullptr));
+
+  g_autoptr(FlPluginRegistrar) registrar =
+      fl_plugin_registry_get_registrar_for_plugin(registry, "VideoTextureBridge");
+  self->handler = new std::shared_ptr<RenderHandler>(
+      std::make_shared<RenderHandler>(fl_plugin_registrar_get_texture_registrar(registrar)));
+
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  self->channel = fl_method_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                                        kChannelName, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(self->channel, method_call_cb, self, nullptr);
+  return self;
+}
@@ -0,0 +1,30 @@
+#ifndef FLUTTER_VIDEO_TEXTURE_BRIDGE_H_
+#define FLUTTER_VIDEO_TEXTURE_BRIDGE_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+G_DECLARE_FINAL_TYPE(VideoTextureBridge, video_texture_bridge, VIDEO,
+                     TEXTURE_BRIDGE, GObject)
+
+/**
+ * video_texture_bridge_new:
+ * @registry: the plugin registry of the #FlView that displays the textures.
+ *
+ * Creates the native render path for ZegoExpressEngine video. Once enabled
+ * from Dart over the "sleepcall/video_texture" method channel, the bridge
+ * installs itself as the engine's custom video render handler and writes
+ * every local preview and remote stream frame into a triple-buffered
+ * #FlPixelBufferTexture registered with the view's texture registrar.
+ *
+ * Method channel calls:
+ *   enable                    -> null, must be called before preview/playing
+ *   createTexture {streamID}  -> texture id, "@capture" for the local preview
+ *   destroyTexture {streamID} -> null
+ *   getStats                  -> {streamID: {received, presented, dropped,
+ *                                 late, width, height}}
+ *
+ * Returns: a new #VideoTextureBridge.
+ */
+VideoTextureBridge* video_texture_bridge_new(FlPluginRegistry* registry);
+
+#endif  // FLUTTER_VIDEO_TEXTURE_BRIDGE_H_
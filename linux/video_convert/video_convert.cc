@@ -0,0 +1,548 @@
+#include "video_convert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "video_convert_row.h"
+
+namespace video_convert {
+
+namespace {
+
+struct Dispatch {
+  row::Kernels kernels[4];
+  bool supported[4];
+  SimdLevel detected;
+  std::atomic<int> level;
+};
+
+Dispatch* CreateDispatch() {
+  Dispatch* dispatch = new Dispatch();
+  for (row::Kernels& kernels : dispatch->kernels) {
+    row::InitScalar(&kernels);
+  }
+  dispatch->supported[static_cast<int>(SimdLevel::kScalar)] = true;
+  dispatch->detected = SimdLevel::kScalar;
+
+#if defined(VIDEO_CONVERT_HAVE_SSE41)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.1")) {
+    row::Kernels* sse41 = &dispatch->kernels[static_cast<int>(SimdLevel::kSSE41)];
+    row::InitSSE41(sse41);
+    dispatch->supported[static_cast<int>(SimdLevel::kSSE41)] = true;
+    dispatch->detected = SimdLevel::kSSE41;
+#if defined(VIDEO_CONVERT_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+      // AVX2 only covers the hottest kernels and keeps SSE4.1 for the rest.
+      row::Kernels* avx2 = &dispatch->kernels[static_cast<int>(SimdLevel::kAVX2)];
+      row::InitSSE41(avx2);
+      row::InitAVX2(avx2);
+      dispatch->supported[static_cast<int>(SimdLevel::kAVX2)] = true;
+      dispatch->detected = SimdLevel::kAVX2;
+    }
+#endif
+  }
+#endif
+
+#if defined(VIDEO_CONVERT_HAVE_NEON)
+  // NEON is part of the AArch64 baseline.
+  row::InitNEON(&dispatch->kernels[static_cast<int>(SimdLevel::kNEON)]);
+  dispatch->supported[static_cast<int>(SimdLevel::kNEON)] = true;
+  dispatch->detected = SimdLevel::kNEON;
+#endif
+
+  dispatch->level = static_cast<int>(dispatch->detected);
+  return dispatch;
+}
+
+Dispatch& GetDispatch() {
+  static Dispatch* dispatch = CreateDispatch();
+  return *dispatch;
+}
+
+const row::Kernels& Kernels() {
+  Dispatch& dispatch = GetDispatch();
+  return dispatch.kernels[dispatch.level.load(std::memory_order_relaxed)];
+}
+
+bool IsPacked(PixelFormat format) {
+  return format != PixelFormat::kI420 && format != PixelFormat::kNV12 &&
+         format != PixelFormat::kNV21;
+}
+
+int PlaneCount(PixelFormat format) {
+  switch (format) {
+    case PixelFormat::kI420:
+      return 3;
+    case PixelFormat::kNV12:
+    case PixelFormat::kNV21:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+int ChromaSize(int size) {
+  return (size + 1) / 2;
+}
+
+// Bytes per row and rows of each plane.
+void PlaneSize(PixelFormat format, int width, int height, int plane, int* row_bytes,
+               int* rows) {
+  if (IsPacked(format)) {
+    *row_bytes = width * 4;
+    *rows = height;
+  } else if (plane == 0) {
+    *row_bytes = width;
+    *rows = height;
+  } else {
+    *row_bytes = ChromaSize(width) * (format == PixelFormat::kI420 ? 1 : 2);
+    *rows = ChromaSize(height);
+  }
+}
+
+bool IsValid(const Frame& frame) {
+  if (frame.width <= 0 || frame.height <= 0) {
+    return false;
+  }
+  for (int plane = 0; plane < PlaneCount(frame.format); plane++) {
+    int row_bytes, rows;
+    PlaneSize(frame.format, frame.width, frame.height, plane, &row_bytes, &rows);
+    if (frame.planes[plane] == nullptr || frame.strides[plane] < row_bytes) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Byte offset of R, G, B and A inside a packed pixel.
+const uint8_t* ChannelOffsets(PixelFormat format) {
+  static const uint8_t kRgba[4] = {0, 1, 2, 3};
+  static const uint8_t kBgra[4] = {2, 1, 0, 3};
+  static const uint8_t kArgb[4] = {1, 2, 3, 0};
+  static const uint8_t kAbgr[4] = {3, 2, 1, 0};
+  switch (format) {
+    case PixelFormat::kBGRA:
+      return kBgra;
+    case PixelFormat::kARGB:
+      return kArgb;
+    case PixelFormat::kABGR:
+      return kAbgr;
+    default:
+      return kRgba;
+  }
+}
+
+// Per-thread row buffers for mirroring and chroma reshuffles.
+uint8_t* Scratch(size_t bytes) {
+  thread_local std::vector<uint8_t> scratch;
+  if (scratch.size() < bytes) {
+    scratch.resize(bytes);
+  }
+  return scratch.data();
+}
+
+class Rows {
+ public:
+  Rows(const Frame& frame, bool flip_y) : frame_(frame), flip_y_(flip_y) {}
+
+  uint8_t* Get(int plane, int row) const {
+    int row_bytes, rows;
+    PlaneSize(frame_.format, frame_.width, frame_.height, plane, &row_bytes, &rows);
+    if (flip_y_) {
+      row = rows - 1 - row;
+    }
+    return frame_.planes[plane] + static_cast<ptrdiff_t>(row) * frame_.strides[plane];
+  }
+
+  bool flipped() const { return flip_y_; }
+
+ private:
+  const Frame& frame_;
+  bool flip_y_;
+};
+
+void PackedToPacked(const Frame& src, const Frame& dst, bool mirror, const Rows& in,
+                    const Rows& out) {
+  const row::Kernels& k = Kernels();
+  const uint8_t* from = ChannelOffsets(src.format);
+  const uint8_t* to = ChannelOffsets(dst.format);
+  uint8_t order[4];
+  for (int c = 0; c < 4; c++) {
+    order[to[c]] = from[c];
+  }
+  bool identity = order[0] == 0 && order[1] == 1 && order[2] == 2 && order[3] == 3;
+  uint8_t* scratch = mirror && !identity ? Scratch(src.width * 4) : nullptr;
+  for (int y = 0; y < src.height; y++) {
+    const uint8_t* s = in.Get(0, y);
+    uint8_t* d = out.Get(0, y);
+    if (identity) {
+      if (mirror) {
+        k.mirror32(s, d, src.width);
+      } else {
+        memcpy(d, s, src.width * 4);
+      }
+    } else if (mirror) {
+      k.shuffle_pixels(s, scratch, src.width, order);
+      k.mirror32(scratch, d, src.width);
+    } else {
+      k.shuffle_pixels(s, d, src.width, order);
+    }
+  }
+}
+
+void YuvToPacked(const Frame& src, const Frame& dst, bool mirror, const Rows& in,
+                 const Rows& out) {
+  const row::Kernels& k = Kernels();
+  bool bgra = dst.format == PixelFormat::kBGRA;
+  uint8_t* scratch = mirror ? Scratch(src.width * 4) : nullptr;
+  for (int y = 0; y < src.height; y++) {
+    uint8_t* d = mirror ? scratch : out.Get(0, y);
+    // Index chroma by the flipped luma row rather than flipping chroma rows on
+    // their own, so odd heights stay aligned.
+    int sy = in.flipped() ? src.height - 1 - y : y;
+    const uint8_t* luma = src.planes[0] + static_cast<ptrdiff_t>(sy) * src.strides[0];
+    const uint8_t* chroma1 = src.planes[1] + static_cast<ptrdiff_t>(sy / 2) * src.strides[1];
+    if (src.format == PixelFormat::kI420) {
+      const uint8_t* chroma2 = src.planes[2] + static_cast<ptrdiff_t>(sy / 2) * src.strides[2];
+      k.i420_to_rgba(luma, chroma1, chroma2, d, src.width, bgra);
+    } else {
+      k.nv_to_rgba(luma, chroma1, d, src.width, bgra, src.format == PixelFormat::kNV21);
+    }
+    if (mirror) {
+      k.mirror32(scratch, out.Get(0, y), src.width);
+    }
+  }
+}
+
+void PackedToYuv(const Frame& src, const Frame& dst, bool mirror, const Rows& in,
+                 const Rows& out) {
+  const row::Kernels& k = Kernels();
+  bool bgra = src.format == PixelFormat::kBGRA;
+  int chroma_width = ChromaSize(src.width);
+  uint8_t* scratch = Scratch(src.width + chroma_width * 4);
+  uint8_t* scratch_u = scratch + src.width;
+  uint8_t* scratch_v = scratch_u + chroma_width;
+  uint8_t* scratch_uv = scratch_v + chroma_width;
+
+  for (int y = 0; y < src.height; y++) {
+    if (mirror) {
+      k.rgba_to_y(in.Get(0, y), scratch, src.width, bgra);
+      k.mirror8(scratch, out.Get(0, y), src.width);
+    } else {
+      k.rgba_to_y(in.Get(0, y), out.Get(0, y), src.width, bgra);
+    }
+  }
+
+  for (int cy = 0; cy < ChromaSize(src.height); cy++) {
+    const uint8_t* s0 = in.Get(0, cy * 2);
+    const uint8_t* s1 = in.Get(0, std::min(cy * 2 + 1, src.height - 1));
+    if (dst.format == PixelFormat::kI420) {
+      if (mirror) {
+        k.rgba_to_uv(s0, s1, scratch_u, scratch_v, src.width, bgra);
+        k.mirror8(scratch_u, out.Get(1, cy), chroma_width);
+        k.mirror8(scratch_v, out.Get(2, cy), chroma_width);
+      } else {
+        k.rgba_to_uv(s0, s1, out.Get(1, cy), out.Get(2, cy), src.width, bgra);
+      }
+      continue;
+    }
+    k.rgba_to_uv(s0, s1, scratch_u, scratch_v, src.width, bgra);
+    bool vu = dst.format == PixelFormat::kNV21;
+    const uint8_t* first = vu ? scratch_v : scratch_u;
+    const uint8_t* second = vu ? scratch_u : scratch_v;
+    if (mirror) {
+      k.merge_uv(first, second, scratch_uv, chroma_width);
+      k.mirror16(scratch_uv, out.Get(1, cy), chroma_width);
+    } else {
+      k.merge_uv(first, second, out.Get(1, cy), chroma_width);
+    }
+  }
+}
+
+void YuvToYuv(const Frame& src, const Frame& dst, bool mirror, const Rows& in,
+              const Rows& out) {
+  const row::Kernels& k = Kernels();
+  for (int y = 0; y < src.height; y++) {
+    if (mirror) {
+      k.mirror8(in.Get(0, y), out.Get(0, y), src.width);
+    } else {
+      memcpy(out.Get(0, y), in.Get(0, y), src.width);
+    }
+  }
+
+  int chroma_width = ChromaSize(src.width);
+  uint8_t* scratch = Scratch(chroma_width * 4);
+  uint8_t* scratch_u = scratch;
+  uint8_t* scratch_v = scratch_u + chroma_width;
+  uint8_t* scratch_uv = scratch_v + chroma_width;
+  bool src_planar = src.format == PixelFormat::kI420;
+  bool dst_planar = dst.format == PixelFormat::kI420;
+
+  for (int cy = 0; cy < ChromaSize(src.height); cy++) {
+    if (src_planar && dst_planar) {
+      for (int plane = 1; plane < 3; plane++) {
+        if (mirror) {
+          k.mirror8(in.Get(plane, cy), out.Get(plane, cy), chroma_width);
+        } else {
+          memcpy(out.Get(plane, cy), in.Get(plane, cy), chroma_width);
+        }
+      }
+      continue;
+    }
+    if (src.format == dst.format) {
+      if (mirror) {
+        k.mirror16(in.Get(1, cy), out.Get(1, cy), chroma_width);
+      } else {
+        memcpy(out.Get(1, cy), in.Get(1, cy), chroma_width * 2);
+      }
+      continue;
+    }
+
+    // Bring chroma to separate U and V rows first.
+    const uint8_t* u;
+    const uint8_t* v;
+    if (src_planar) {
+      u = in.Get(1, cy);
+      v = in.Get(2, cy);
+    } else {
+      bool vu = src.format == PixelFormat::kNV21;
+      k.split_uv(in.Get(1, cy), vu ? scratch_v : scratch_u, vu ? scratch_u : scratch_v,
+                 chroma_width);
+      u = scratch_u;
+      v = scratch_v;
+    }
+
+    if (dst_planar) {
+      if (mirror) {
+        k.mirror8(u, out.Get(1, cy), chroma_width);
+        k.mirror8(v, out.Get(2, cy), chroma_width);
+      } else {
+        memcpy(out.Get(1, cy), u, chroma_width);
+        memcpy(out.Get(2, cy), v, chroma_width);
+      }
+      continue;
+    }
+    bool vu = dst.format == PixelFormat::kNV21;
+    if (mirror) {
+      k.merge_uv(vu ? v : u, vu ? u : v, scratch_uv, chroma_width);
+      k.mirror16(scratch_uv, out.Get(1, cy), chroma_width);
+    } else {
+      k.merge_uv(vu ? v : u, vu ? u : v, out.Get(1, cy), chroma_width);
+    }
+  }
+}
+
+void CopyPlane(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride,
+               int row_bytes, int rows) {
+  for (int y = 0; y < rows; y++) {
+    memcpy(dst + static_cast<ptrdiff_t>(y) * dst_stride,
+           src + static_cast<ptrdiff_t>(y) * src_stride, row_bytes);
+  }
+}
+
+// Pixel centre mapping in 16.16 fixed point: (x + 0.5) * src / dst - 0.5.
+int64_t SourcePosition(int x, int src_size, int dst_size) {
+  int64_t step = (static_cast<int64_t>(src_size) << 16) / dst_size;
+  int64_t position = x * step + step / 2 - 0x8000;
+  return position < 0 ? 0 : position;
+}
+
+template <int kChannels>
+void HorizontalFilter(const uint8_t* src, const int* left, const int* right, const int* weight,
+                      uint8_t* dst, int dst_width) {
+  for (int x = 0; x < dst_width; x++) {
+    const uint8_t* a = src + left[x];
+    const uint8_t* b = src + right[x];
+    const int f = weight[x];
+    for (int c = 0; c < kChannels; c++) {
+      dst[x * kChannels + c] = static_cast<uint8_t>((a[c] * (128 - f) + b[c] * f + 64) >> 7);
+    }
+  }
+}
+
+void BilinearPlane(const uint8_t* src, int src_stride, int src_width, int src_height,
+                   uint8_t* dst, int dst_stride, int dst_width, int dst_height,
+                   int channels) {
+  const row::Kernels& k = Kernels();
+  uint8_t* blended = Scratch(static_cast<size_t>(src_width) * channels);
+
+  std::vector<int> left(dst_width);
+  std::vector<int> right(dst_width);
+  std::vector<int> weight(dst_width);
+  for (int x = 0; x < dst_width; x++) {
+    int64_t position = SourcePosition(x, src_width, dst_width);
+    int index = static_cast<int>(position >> 16);
+    int fraction = static_cast<int>((position >> 9) & 127);
+    if (index >= src_width - 1) {
+      index = src_width - 1;
+      fraction = 0;
+    }
+    left[x] = index * channels;
+    right[x] = std::min(index + 1, src_width - 1) * channels;
+    weight[x] = fraction;
+  }
+
+  for (int y = 0; y < dst_height; y++) {
+    int64_t position = SourcePosition(y, src_height, dst_height);
+    int index = static_cast<int>(position >> 16);
+    int fraction = static_cast<int>((position >> 8) & 255);
+    if (index >= src_height - 1) {
+      index = src_height - 1;
+      fraction = 0;
+    }
+    const uint8_t* row0 = src + static_cast<ptrdiff_t>(index) * src_stride;
+    const uint8_t* row1 =
+        src + static_cast<ptrdiff_t>(std::min(index + 1, src_height - 1)) * src_stride;
+    k.interpolate(row0, row1, blended, src_width * channels, fraction);
+
+    uint8_t* out = dst + static_cast<ptrdiff_t>(y) * dst_stride;
+    switch (channels) {
+      case 1:
+        HorizontalFilter<1>(blended, left.data(), right.data(), weight.data(), out, dst_width);
+        break;
+      case 2:
+        HorizontalFilter<2>(blended, left.data(), right.data(), weight.data(), out, dst_width);
+        break;
+      default:
+        HorizontalFilter<4>(blended, left.data(), right.data(), weight.data(), out, dst_width);
+        break;
+    }
+  }
+}
+
+void ScalePlane(const uint8_t* src, int src_stride, int src_width, int src_height,
+                uint8_t* dst, int dst_stride, int dst_width, int dst_height,
+                int channels) {
+  const row::Kernels& k = Kernels();
+  if (src_width == dst_width && src_height == dst_height) {
+    CopyPlane(src, src_stride, dst, dst_stride, src_width * channels, src_height);
+  } else if (src_width == dst_width * 2 && src_height == dst_height * 2) {
+    for (int y = 0; y < dst_height; y++) {
+      k.down2[channels](src + static_cast<ptrdiff_t>(y) * 2 * src_stride, src_stride,
+                        dst + static_cast<ptrdiff_t>(y) * dst_stride, dst_width);
+    }
+  } else if (src_width == dst_width * 4 && src_height == dst_height * 4) {
+    for (int y = 0; y < dst_height; y++) {
+      k.down4[channels](src + static_cast<ptrdiff_t>(y) * 4 * src_stride, src_stride,
+                        dst + static_cast<ptrdiff_t>(y) * dst_stride, dst_width);
+    }
+  } else {
+    BilinearPlane(src, src_stride, src_width, src_height, dst, dst_stride, dst_width,
+                  dst_height, channels);
+  }
+}
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+  return GetDispatch().detected;
+}
+
+SimdLevel GetSimdLevel() {
+  return static_cast<SimdLevel>(GetDispatch().level.load(std::memory_order_relaxed));
+}
+
+SimdLevel SetSimdLevel(SimdLevel level) {
+  Dispatch& dispatch = GetDispatch();
+  if (!dispatch.supported[static_cast<int>(level)]) {
+    level = SimdLevel::kScalar;
+  }
+  dispatch.level = static_cast<int>(level);
+  return level;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kSSE41:
+      return "sse4.1";
+    case SimdLevel::kAVX2:
+      return "avx2";
+    case SimdLevel::kNEON:
+      return "neon";
+    default:
+      return "scalar";
+  }
+}
+
+size_t FrameSize(PixelFormat format, int width, int height) {
+  size_t size = 0;
+  for (int plane = 0; plane < PlaneCount(format); plane++) {
+    int row_bytes, rows;
+    PlaneSize(format, width, height, plane, &row_bytes, &rows);
+    size += static_cast<size_t>(row_bytes) * rows;
+  }
+  return size;
+}
+
+Frame MakeFrame(PixelFormat format, int width, int height, uint8_t* buffer) {
+  Frame frame = {format, width, height, {nullptr, nullptr, nullptr}, {0, 0, 0}};
+  for (int plane = 0; plane < PlaneCount(format); plane++) {
+    int row_bytes, rows;
+    PlaneSize(format, width, height, plane, &row_bytes, &rows);
+    frame.planes[plane] = buffer;
+    frame.strides[plane] = row_bytes;
+    buffer += static_cast<size_t>(row_bytes) * rows;
+  }
+  return frame;
+}
+
+bool Convert(const Frame& src, const Frame& dst, FlipMode flip) {
+  if (!IsValid(src) || !IsValid(dst) || src.width != dst.width ||
+      src.height != dst.height) {
+    return false;
+  }
+  bool src_packed = IsPacked(src.format);
+  bool dst_packed = IsPacked(dst.format);
+  bool src_rgb = src.format == PixelFormat::kRGBA || src.format == PixelFormat::kBGRA;
+  bool dst_rgb = dst.format == PixelFormat::kRGBA || dst.format == PixelFormat::kBGRA;
+  if ((src_packed && !dst_packed && !src_rgb) || (!src_packed && dst_packed && !dst_rgb)) {
+    return false;
+  }
+
+  bool mirror = (flip & kFlipX) != 0;
+  // Flipping is done on the read side; output rows are always written in order.
+  Rows in(src, (flip & kFlipY) != 0);
+  Rows out(dst, false);
+  if (src_packed && dst_packed) {
+    PackedToPacked(src, dst, mirror, in, out);
+  } else if (src_packed) {
+    PackedToYuv(src, dst, mirror, in, out);
+  } else if (dst_packed) {
+    YuvToPacked(src, dst, mirror, in, out);
+  } else {
+    YuvToYuv(src, dst, mirror, in, out);
+  }
+  return true;
+}
+
+bool Scale(const Frame& src, const Frame& dst) {
+  if (!IsValid(src) || !IsValid(dst) || src.format != dst.format) {
+    return false;
+  }
+  if (IsPacked(src.format)) {
+    ScalePlane(src.planes[0], src.strides[0], src.width, src.height, dst.planes[0],
+               dst.strides[0], dst.width, dst.height, 4);
+    return true;
+  }
+  ScalePlane(src.planes[0], src.strides[0], src.width, src.height, dst.planes[0],
+             dst.strides[0], dst.width, dst.height, 1);
+  int src_width = ChromaSize(src.width);
+  int src_height = ChromaSize(src.height);
+  int dst_width = ChromaSize(dst.width);
+  int dst_height = ChromaSize(dst.height);
+  if (src.format == PixelFormat::kI420) {
+    for (int plane = 1; plane < 3; plane++) {
+      ScalePlane(src.planes[plane], src.strides[plane], src_width, src_height,
+                 dst.planes[plane], dst.strides[plane], dst_width, dst_height, 1);
+    }
+  } else {
+    ScalePlane(src.planes[1], src.strides[1], src_width, src_height, dst.planes[1],
+               dst.strides[1], dst_width, dst_height, 2);
+  }
+  return true;
+}
+
+}  // namespace video_convert
@@ -0,0 +1,80 @@
+#ifndef FLUTTER_VIDEO_CONVERT_H_
+#define FLUTTER_VIDEO_CONVERT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace video_convert {
+
+// Pixel layouts handled by Convert() and Scale(). Packed formats are named by
+// byte order in memory, as in ZegoVideoFrameFormat.
+enum class PixelFormat {
+  kI420,  // Y, U and V planes, chroma subsampled 2x2
+  kNV12,  // Y plane and an interleaved UV plane
+  kNV21,  // Y plane and an interleaved VU plane
+  kRGBA,
+  kBGRA,
+  kARGB,
+  kABGR,
+};
+
+// Same values as ZegoVideoFlipMode.
+enum FlipMode {
+  kFlipNone = 0,
+  kFlipX = 1,  // mirror horizontally
+  kFlipY = 2,  // upside down
+  kFlipXY = 3,
+};
+
+// A frame laid out the way the SDK hands it over: up to three planes, each
+// with its own stride in bytes. Packed formats only use plane 0, NV12/NV21
+// planes 0 and 1. Source frames are never written to.
+struct Frame {
+  PixelFormat format;
+  int width;
+  int height;
+  uint8_t* planes[3];
+  int strides[3];
+};
+
+enum class SimdLevel {
+  kScalar,
+  kSSE41,
+  kAVX2,
+  kNEON,
+};
+
+// Best kernel set supported by both this build and the running CPU.
+SimdLevel DetectSimdLevel();
+
+// Kernel set used by Convert() and Scale(). Defaults to DetectSimdLevel().
+SimdLevel GetSimdLevel();
+
+// Switches the kernel set for all threads, e.g. to compare against the scalar
+// code. Levels the CPU or the build does not support fall back to kScalar.
+// Returns the level actually selected.
+SimdLevel SetSimdLevel(SimdLevel level);
+
+const char* SimdLevelName(SimdLevel level);
+
+// Bytes needed for a tightly packed frame, and a Frame describing one that
+// starts at |buffer|.
+size_t FrameSize(PixelFormat format, int width, int height);
+Frame MakeFrame(PixelFormat format, int width, int height, uint8_t* buffer);
+
+// Converts |src| into |dst| of the same size, flipping on the way. Any pair of
+// formats is supported except YUV to or from ARGB/ABGR. The output is BT.601
+// limited range for YUV, identical for every SimdLevel.
+//
+// Returns false on mismatched sizes, missing planes, short strides or an
+// unsupported pair.
+bool Convert(const Frame& src, const Frame& dst, FlipMode flip = kFlipNone);
+
+// Resizes |src| into |dst| of the same format. Exact 2x and 4x reductions use
+// a box filter, every other size is bilinear. Chroma planes are scaled with
+// their own (rounded up) sizes.
+bool Scale(const Frame& src, const Frame& dst);
+
+}  // namespace video_convert
+
+#endif  // FLUTTER_VIDEO_CONVERT_H_
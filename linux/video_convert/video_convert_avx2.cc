@@ -0,0 +1,175 @@
+// Built with -mavx2 and only called after a runtime CPU check. Covers the
+// kernels that dominate Convert() and Scale(); the rest stay on SSE4.1.
+
+#include <immintrin.h>
+
+#include <cstring>
+
+#include "video_convert_row.h"
+
+namespace video_convert {
+namespace row {
+
+namespace {
+
+__m128i Load64(const uint8_t* p) {
+  return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+}
+
+__m128i Load128(const uint8_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+__m256i Load256(const uint8_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+void Store256(uint8_t* p, __m256i value) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), value);
+}
+
+// Sixteen pixels from 16 bit Y, U and V, one sample per output pixel.
+void YuvToRgba16(__m256i y, __m256i u, __m256i v, uint8_t* dst, bool bgra) {
+  const __m256i yy = _mm256_add_epi16(
+      _mm256_mullo_epi16(_mm256_sub_epi16(y, _mm256_set1_epi16(16)), _mm256_set1_epi16(kYToRgb)),
+      _mm256_set1_epi16(32));
+  const __m256i d = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+  const __m256i e = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+  __m256i r =
+      _mm256_srai_epi16(_mm256_add_epi16(yy, _mm256_mullo_epi16(e, _mm256_set1_epi16(kVToR))), 6);
+  __m256i g = _mm256_srai_epi16(
+      _mm256_sub_epi16(_mm256_sub_epi16(yy, _mm256_mullo_epi16(d, _mm256_set1_epi16(kUToG))),
+                       _mm256_mullo_epi16(e, _mm256_set1_epi16(kVToG))),
+      6);
+  __m256i b =
+      _mm256_srai_epi16(_mm256_adds_epi16(yy, _mm256_mullo_epi16(d, _mm256_set1_epi16(kUToB))), 6);
+  if (bgra) {
+    __m256i t = r;
+    r = b;
+    b = t;
+  }
+  // Per 128 bit lane: pixels 0-7 in the low lane and 8-15 in the high one.
+  const __m256i rb = _mm256_packus_epi16(r, b);
+  const __m256i ga = _mm256_packus_epi16(g, _mm256_set1_epi16(255));
+  const __m256i rg = _mm256_unpacklo_epi8(rb, ga);
+  const __m256i ba = _mm256_unpackhi_epi8(rb, ga);
+  const __m256i lo = _mm256_unpacklo_epi16(rg, ba);  // pixels 0-3 | 8-11
+  const __m256i hi = _mm256_unpackhi_epi16(rg, ba);  // pixels 4-7 | 12-15
+  Store256(dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+  Store256(dst + 32, _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+void I420ToRgba(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst,
+                int width, bool bgra) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m128i u8 = Load64(u + x / 2);
+    const __m128i v8 = Load64(v + x / 2);
+    YuvToRgba16(_mm256_cvtepu8_epi16(Load128(y + x)),
+                _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u8, u8)),
+                _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v8, v8)), dst + x * 4, bgra);
+  }
+  if (x < width) {
+    scalar::I420ToRgba(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, bgra);
+  }
+}
+
+void NvToRgba(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width, bool bgra,
+              bool vu) {
+  const __m128i even = _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14);
+  const __m128i odd = _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15);
+  const __m128i u_mask = vu ? odd : even;
+  const __m128i v_mask = vu ? even : odd;
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m128i chroma = Load128(uv + x);
+    YuvToRgba16(_mm256_cvtepu8_epi16(Load128(y + x)),
+                _mm256_cvtepu8_epi16(_mm_shuffle_epi8(chroma, u_mask)),
+                _mm256_cvtepu8_epi16(_mm_shuffle_epi8(chroma, v_mask)), dst + x * 4, bgra);
+  }
+  if (x < width) {
+    scalar::NvToRgba(y + x, uv + x, dst + x * 4, width - x, bgra, vu);
+  }
+}
+
+void RgbaToY(const uint8_t* src, uint8_t* y, int width, bool bgra) {
+  // Bytes R, G, B, A (or B, G, R, A) of every pixel.
+  const __m256i coeff =
+      _mm256_set1_epi32(bgra ? 13 | (64 << 8) | (33 << 16) : 33 | (64 << 8) | (13 << 16));
+  const __m256i round = _mm256_set1_epi16(64);
+  const __m256i offset = _mm256_set1_epi16(16);
+  // hadd and packus work per lane; this puts the 4 pixel groups back in order.
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  int x = 0;
+  for (; x + 32 <= width; x += 32) {
+    const uint8_t* p = src + x * 4;
+    __m256i lo = _mm256_hadd_epi16(_mm256_maddubs_epi16(Load256(p), coeff),
+                                   _mm256_maddubs_epi16(Load256(p + 32), coeff));
+    __m256i hi = _mm256_hadd_epi16(_mm256_maddubs_epi16(Load256(p + 64), coeff),
+                                   _mm256_maddubs_epi16(Load256(p + 96), coeff));
+    lo = _mm256_add_epi16(_mm256_srli_epi16(_mm256_add_epi16(lo, round), 7), offset);
+    hi = _mm256_add_epi16(_mm256_srli_epi16(_mm256_add_epi16(hi, round), 7), offset);
+    Store256(y + x, _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order));
+  }
+  if (x < width) {
+    scalar::RgbaToY(src + x * 4, y + x, width - x, bgra);
+  }
+}
+
+void Down2Gray(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  const __m256i ones = _mm256_set1_epi8(1);
+  const __m256i two = _mm256_set1_epi16(2);
+  int x = 0;
+  for (; x + 32 <= dst_width; x += 32) {
+    __m256i lo = _mm256_add_epi16(_mm256_maddubs_epi16(Load256(s0 + x * 2), ones),
+                                  _mm256_maddubs_epi16(Load256(s1 + x * 2), ones));
+    __m256i hi = _mm256_add_epi16(_mm256_maddubs_epi16(Load256(s0 + x * 2 + 32), ones),
+                                  _mm256_maddubs_epi16(Load256(s1 + x * 2 + 32), ones));
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, two), 2);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2);
+    Store256(dst + x,
+             _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  if (x < dst_width) {
+    scalar::Down2(src + x * 2, stride, dst + x, dst_width - x, 1);
+  }
+}
+
+void Interpolate(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int bytes,
+                 int fraction) {
+  const int f = fraction >> 1;
+  if (f == 0) {
+    memcpy(dst, src0, bytes);
+    return;
+  }
+  const __m256i coeff = _mm256_set1_epi16(static_cast<int16_t>((f << 8) | (128 - f)));
+  const __m256i round = _mm256_set1_epi16(64);
+  int i = 0;
+  for (; i + 32 <= bytes; i += 32) {
+    const __m256i a = Load256(src0 + i);
+    const __m256i b = Load256(src1 + i);
+    __m256i lo = _mm256_maddubs_epi16(_mm256_unpacklo_epi8(a, b), coeff);
+    __m256i hi = _mm256_maddubs_epi16(_mm256_unpackhi_epi8(a, b), coeff);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, round), 7);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, round), 7);
+    Store256(dst + i, _mm256_packus_epi16(lo, hi));
+  }
+  if (i < bytes) {
+    scalar::Interpolate(src0 + i, src1 + i, dst + i, bytes - i, fraction);
+  }
+}
+
+}  // namespace
+
+void InitAVX2(Kernels* kernels) {
+  kernels->i420_to_rgba = I420ToRgba;
+  kernels->nv_to_rgba = NvToRgba;
+  kernels->rgba_to_y = RgbaToY;
+  kernels->down2[1] = Down2Gray;
+  kernels->interpolate = Interpolate;
+}
+
+}  // namespace row
+}  // namespace video_convert
@@ -0,0 +1,97 @@
+// Compares every SIMD level against the scalar kernels. That every level
+// produces the same bytes is checked by video_convert_test.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "video_convert.h"
+#include "video_convert_test_util.h"
+
+namespace {
+
+using video_convert::FlipMode;
+using video_convert::PixelFormat;
+using video_convert::SimdLevel;
+using video_convert::test_util::FormatName;
+using video_convert::test_util::SupportedLevels;
+using video_convert::test_util::TestFrame;
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+const Resolution kResolutions[] = {
+    {"360p", 640, 360},
+    {"720p", 1280, 720},
+    {"1080p", 1920, 1080},
+};
+
+void RegisterConvert(PixelFormat from, PixelFormat to, FlipMode flip, const char* suffix) {
+  for (const Resolution& resolution : kResolutions) {
+    for (SimdLevel level : SupportedLevels()) {
+      std::string name = std::string(FormatName(from)) + "To" + FormatName(to) + suffix + "/" +
+                         resolution.name + "/" + video_convert::SimdLevelName(level);
+      benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State& state) {
+        video_convert::SetSimdLevel(level);
+        TestFrame src(from, resolution.width, resolution.height, 0, 1);
+        TestFrame dst(to, resolution.width, resolution.height, 0, 2);
+        for (auto _ : state) {
+          video_convert::Convert(src.frame(), dst.frame(), flip);
+          benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() *
+                                static_cast<int64_t>(src.bytes().size() + dst.bytes().size()));
+      });
+    }
+  }
+}
+
+void RegisterScale(PixelFormat format, int numerator, int denominator, const char* suffix) {
+  for (const Resolution& resolution : kResolutions) {
+    for (SimdLevel level : SupportedLevels()) {
+      std::string name = std::string("Scale") + FormatName(format) + suffix + "/" +
+                         resolution.name + "/" + video_convert::SimdLevelName(level);
+      benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State& state) {
+        video_convert::SetSimdLevel(level);
+        TestFrame src(format, resolution.width, resolution.height, 0, 1);
+        TestFrame dst(format, resolution.width * numerator / denominator,
+                      resolution.height * numerator / denominator, 0, 2);
+        for (auto _ : state) {
+          video_convert::Scale(src.frame(), dst.frame());
+          benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() *
+                                static_cast<int64_t>(src.bytes().size() + dst.bytes().size()));
+      });
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  RegisterConvert(PixelFormat::kI420, PixelFormat::kRGBA, video_convert::kFlipNone, "");
+  RegisterConvert(PixelFormat::kNV12, PixelFormat::kBGRA, video_convert::kFlipNone, "");
+  RegisterConvert(PixelFormat::kI420, PixelFormat::kBGRA, video_convert::kFlipX, "Mirror");
+  RegisterConvert(PixelFormat::kBGRA, PixelFormat::kI420, video_convert::kFlipNone, "");
+  RegisterConvert(PixelFormat::kRGBA, PixelFormat::kNV12, video_convert::kFlipNone, "");
+  RegisterConvert(PixelFormat::kI420, PixelFormat::kNV12, video_convert::kFlipNone, "");
+  RegisterConvert(PixelFormat::kBGRA, PixelFormat::kRGBA, video_convert::kFlipNone, "");
+  RegisterScale(PixelFormat::kI420, 1, 2, "Half");
+  RegisterScale(PixelFormat::kBGRA, 1, 2, "Half");
+  RegisterScale(PixelFormat::kBGRA, 1, 4, "Quarter");
+  RegisterScale(PixelFormat::kI420, 2, 3, "TwoThirds");
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
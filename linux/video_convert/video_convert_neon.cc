@@ -0,0 +1,313 @@
+// AArch64 only, where NEON is always available.
+
+#include <arm_neon.h>
+
+#include <cstring>
+
+#include "video_convert_row.h"
+
+namespace video_convert {
+namespace row {
+
+namespace {
+
+// Eight pixels from 16 bit Y, U and V, one sample per output pixel.
+void YuvToRgba8(int16x8_t y, int16x8_t u, int16x8_t v, uint8_t* dst, bool bgra) {
+  const int16x8_t yy =
+      vaddq_s16(vmulq_n_s16(vsubq_s16(y, vdupq_n_s16(16)), kYToRgb), vdupq_n_s16(32));
+  const int16x8_t d = vsubq_s16(u, vdupq_n_s16(128));
+  const int16x8_t e = vsubq_s16(v, vdupq_n_s16(128));
+  const int16x8_t r = vshrq_n_s16(vaddq_s16(yy, vmulq_n_s16(e, kVToR)), 6);
+  const int16x8_t g =
+      vshrq_n_s16(vsubq_s16(vsubq_s16(yy, vmulq_n_s16(d, kUToG)), vmulq_n_s16(e, kVToG)), 6);
+  const int16x8_t b = vshrq_n_s16(vqaddq_s16(yy, vmulq_n_s16(d, kUToB)), 6);
+  uint8x8x4_t px;
+  px.val[bgra ? 2 : 0] = vqmovun_s16(r);
+  px.val[1] = vqmovun_s16(g);
+  px.val[bgra ? 0 : 2] = vqmovun_s16(b);
+  px.val[3] = vdup_n_u8(255);
+  vst4_u8(dst, px);
+}
+
+int16x8_t Widen(uint8x8_t value) {
+  return vreinterpretq_s16_u16(vmovl_u8(value));
+}
+
+void I420ToRgba(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst,
+                int width, bool bgra) {
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    uint32_t u4, v4;
+    memcpy(&u4, u + x / 2, 4);
+    memcpy(&v4, v + x / 2, 4);
+    const uint8x8_t u8 = vreinterpret_u8_u32(vdup_n_u32(u4));
+    const uint8x8_t v8 = vreinterpret_u8_u32(vdup_n_u32(v4));
+    YuvToRgba8(Widen(vld1_u8(y + x)), Widen(vzip_u8(u8, u8).val[0]),
+               Widen(vzip_u8(v8, v8).val[0]), dst + x * 4, bgra);
+  }
+  if (x < width) {
+    scalar::I420ToRgba(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, bgra);
+  }
+}
+
+void NvToRgba(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width, bool bgra,
+              bool vu) {
+  static const uint8_t kEven[8] = {0, 0, 2, 2, 4, 4, 6, 6};
+  static const uint8_t kOdd[8] = {1, 1, 3, 3, 5, 5, 7, 7};
+  const uint8x8_t u_index = vld1_u8(vu ? kOdd : kEven);
+  const uint8x8_t v_index = vld1_u8(vu ? kEven : kOdd);
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const uint8x8_t chroma = vld1_u8(uv + x);
+    YuvToRgba8(Widen(vld1_u8(y + x)), Widen(vtbl1_u8(chroma, u_index)),
+               Widen(vtbl1_u8(chroma, v_index)), dst + x * 4, bgra);
+  }
+  if (x < width) {
+    scalar::NvToRgba(y + x, uv + x, dst + x * 4, width - x, bgra, vu);
+  }
+}
+
+void RgbaToY(const uint8_t* src, uint8_t* y, int width, bool bgra) {
+  const int ri = bgra ? 2 : 0;
+  const int bi = bgra ? 0 : 2;
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const uint8x8x4_t px = vld4_u8(src + x * 4);
+    uint16x8_t sum = vmull_u8(px.val[ri], vdup_n_u8(33));
+    sum = vmlal_u8(sum, px.val[1], vdup_n_u8(64));
+    sum = vmlal_u8(sum, px.val[bi], vdup_n_u8(13));
+    vst1_u8(y + x, vadd_u8(vrshrn_n_u16(sum, 7), vdup_n_u8(16)));
+  }
+  if (x < width) {
+    scalar::RgbaToY(src + x * 4, y + x, width - x, bgra);
+  }
+}
+
+// ((a * ca + b * cb + c * cc + 128) >> 8) + 128 on eight 2x2 averages.
+uint8x8_t Chroma(int16x8_t a, int16_t ca, int16x8_t b, int16_t cb, int16x8_t c, int16_t cc) {
+  int32x4_t lo = vmull_n_s16(vget_low_s16(a), ca);
+  lo = vmlal_n_s16(lo, vget_low_s16(b), cb);
+  lo = vmlal_n_s16(lo, vget_low_s16(c), cc);
+  int32x4_t hi = vmull_n_s16(vget_high_s16(a), ca);
+  hi = vmlal_n_s16(hi, vget_high_s16(b), cb);
+  hi = vmlal_n_s16(hi, vget_high_s16(c), cc);
+  const int16x8_t sum = vcombine_s16(vrshrn_n_s32(lo, 8), vrshrn_n_s32(hi, 8));
+  return vqmovun_s16(vaddq_s16(sum, vdupq_n_s16(128)));
+}
+
+void RgbaToUv(const uint8_t* src0, const uint8_t* src1, uint8_t* u, uint8_t* v, int width,
+              bool bgra) {
+  const int ri = bgra ? 2 : 0;
+  const int bi = bgra ? 0 : 2;
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16x4_t a = vld4q_u8(src0 + x * 4);
+    const uint8x16x4_t b = vld4q_u8(src1 + x * 4);
+    int16x8_t avg[3];
+    const int channels[3] = {ri, 1, bi};
+    for (int c = 0; c < 3; c++) {
+      const uint16x8_t sum =
+          vaddq_u16(vpaddlq_u8(a.val[channels[c]]), vpaddlq_u8(b.val[channels[c]]));
+      avg[c] = vreinterpretq_s16_u16(vrshrq_n_u16(sum, 2));
+    }
+    vst1_u8(u + x / 2, Chroma(avg[2], 112, avg[0], -38, avg[1], -74));
+    vst1_u8(v + x / 2, Chroma(avg[0], 112, avg[1], -94, avg[2], -18));
+  }
+  if (x < width) {
+    scalar::RgbaToUv(src0 + x * 4, src1 + x * 4, u + x / 2, v + x / 2, width - x, bgra);
+  }
+}
+
+void ShufflePixels(const uint8_t* src, uint8_t* dst, int width, const uint8_t order[4]) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16x4_t in = vld4q_u8(src + x * 4);
+    uint8x16x4_t out;
+    for (int c = 0; c < 4; c++) {
+      out.val[c] = in.val[order[c]];
+    }
+    vst4q_u8(dst + x * 4, out);
+  }
+  if (x < width) {
+    scalar::ShufflePixels(src + x * 4, dst + x * 4, width - x, order);
+  }
+}
+
+void SplitUv(const uint8_t* uv, uint8_t* u, uint8_t* v, int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8x16x2_t in = vld2q_u8(uv + x * 2);
+    vst1q_u8(u + x, in.val[0]);
+    vst1q_u8(v + x, in.val[1]);
+  }
+  if (x < width) {
+    scalar::SplitUv(uv + x * 2, u + x, v + x, width - x);
+  }
+}
+
+void MergeUv(const uint8_t* u, const uint8_t* v, uint8_t* uv, int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16x2_t out;
+    out.val[0] = vld1q_u8(u + x);
+    out.val[1] = vld1q_u8(v + x);
+    vst2q_u8(uv + x * 2, out);
+  }
+  if (x < width) {
+    scalar::MergeUv(u + x, v + x, uv + x * 2, width - x);
+  }
+}
+
+uint8x16_t SwapHalves(uint8x16_t value) {
+  return vcombine_u8(vget_high_u8(value), vget_low_u8(value));
+}
+
+void Mirror8(const uint8_t* src, uint8_t* dst, int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    vst1q_u8(dst + x, SwapHalves(vrev64q_u8(vld1q_u8(src + width - x - 16))));
+  }
+  if (x < width) {
+    scalar::Mirror8(src, dst + x, width - x);
+  }
+}
+
+void Mirror16(const uint8_t* src, uint8_t* dst, int width) {
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const uint8x16_t in = vld1q_u8(src + (width - x - 8) * 2);
+    vst1q_u8(dst + x * 2,
+             SwapHalves(vreinterpretq_u8_u16(vrev64q_u16(vreinterpretq_u16_u8(in)))));
+  }
+  if (x < width) {
+    scalar::Mirror16(src, dst + x * 2, width - x);
+  }
+}
+
+void Mirror32(const uint8_t* src, uint8_t* dst, int width) {
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    const uint8x16_t in = vld1q_u8(src + (width - x - 4) * 4);
+    vst1q_u8(dst + x * 4,
+             SwapHalves(vreinterpretq_u8_u32(vrev64q_u32(vreinterpretq_u32_u8(in)))));
+  }
+  if (x < width) {
+    scalar::Mirror32(src, dst + x * 4, width - x);
+  }
+}
+
+void Down2Gray(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  int x = 0;
+  for (; x + 16 <= dst_width; x += 16) {
+    const uint16x8_t lo =
+        vaddq_u16(vpaddlq_u8(vld1q_u8(s0 + x * 2)), vpaddlq_u8(vld1q_u8(s1 + x * 2)));
+    const uint16x8_t hi =
+        vaddq_u16(vpaddlq_u8(vld1q_u8(s0 + x * 2 + 16)), vpaddlq_u8(vld1q_u8(s1 + x * 2 + 16)));
+    vst1q_u8(dst + x, vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2)));
+  }
+  if (x < dst_width) {
+    scalar::Down2(src + x * 2, stride, dst + x, dst_width - x, 1);
+  }
+}
+
+void Down2Uv(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  int x = 0;
+  for (; x + 8 <= dst_width; x += 8) {
+    const uint8x16x2_t a = vld2q_u8(s0 + x * 4);
+    const uint8x16x2_t b = vld2q_u8(s1 + x * 4);
+    uint8x8x2_t out;
+    for (int c = 0; c < 2; c++) {
+      out.val[c] = vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[c]), vpaddlq_u8(b.val[c])), 2);
+    }
+    vst2_u8(dst + x * 2, out);
+  }
+  if (x < dst_width) {
+    scalar::Down2(src + x * 4, stride, dst + x * 2, dst_width - x, 2);
+  }
+}
+
+void Down2Rgba(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  int x = 0;
+  for (; x + 8 <= dst_width; x += 8) {
+    const uint8x16x4_t a = vld4q_u8(s0 + x * 8);
+    const uint8x16x4_t b = vld4q_u8(s1 + x * 8);
+    uint8x8x4_t out;
+    for (int c = 0; c < 4; c++) {
+      out.val[c] = vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[c]), vpaddlq_u8(b.val[c])), 2);
+    }
+    vst4_u8(dst + x * 4, out);
+  }
+  if (x < dst_width) {
+    scalar::Down2(src + x * 8, stride, dst + x * 4, dst_width - x, 4);
+  }
+}
+
+void Down4Gray(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  int x = 0;
+  for (; x + 8 <= dst_width; x += 8) {
+    uint16x8_t lo = vdupq_n_u16(0);
+    uint16x8_t hi = vdupq_n_u16(0);
+    for (int r = 0; r < 4; r++) {
+      const uint8_t* s = src + r * stride + x * 4;
+      lo = vaddq_u16(lo, vpaddlq_u8(vld1q_u8(s)));
+      hi = vaddq_u16(hi, vpaddlq_u8(vld1q_u8(s + 16)));
+    }
+    const uint16x8_t sum = vcombine_u16(vpadd_u16(vget_low_u16(lo), vget_high_u16(lo)),
+                                        vpadd_u16(vget_low_u16(hi), vget_high_u16(hi)));
+    vst1_u8(dst + x, vrshrn_n_u16(sum, 4));
+  }
+  if (x < dst_width) {
+    scalar::Down4(src + x * 4, stride, dst + x, dst_width - x, 1);
+  }
+}
+
+void Interpolate(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int bytes,
+                 int fraction) {
+  const int f = fraction >> 1;
+  if (f == 0) {
+    memcpy(dst, src0, bytes);
+    return;
+  }
+  const uint8x8_t w0 = vdup_n_u8(static_cast<uint8_t>(128 - f));
+  const uint8x8_t w1 = vdup_n_u8(static_cast<uint8_t>(f));
+  int i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    const uint8x16_t a = vld1q_u8(src0 + i);
+    const uint8x16_t b = vld1q_u8(src1 + i);
+    const uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), w0), vget_low_u8(b), w1);
+    const uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), w0), vget_high_u8(b), w1);
+    vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, 7), vrshrn_n_u16(hi, 7)));
+  }
+  if (i < bytes) {
+    scalar::Interpolate(src0 + i, src1 + i, dst + i, bytes - i, fraction);
+  }
+}
+
+}  // namespace
+
+void InitNEON(Kernels* kernels) {
+  kernels->i420_to_rgba = I420ToRgba;
+  kernels->nv_to_rgba = NvToRgba;
+  kernels->rgba_to_y = RgbaToY;
+  kernels->rgba_to_uv = RgbaToUv;
+  kernels->shuffle_pixels = ShufflePixels;
+  kernels->split_uv = SplitUv;
+  kernels->merge_uv = MergeUv;
+  kernels->mirror8 = Mirror8;
+  kernels->mirror16 = Mirror16;
+  kernels->mirror32 = Mirror32;
+  kernels->down2[1] = Down2Gray;
+  kernels->down2[2] = Down2Uv;
+  kernels->down2[4] = Down2Rgba;
+  kernels->down4[1] = Down4Gray;
+  kernels->interpolate = Interpolate;
+}
+
+}  // namespace row
+}  // namespace video_convert
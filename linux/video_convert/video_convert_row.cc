@@ -0,0 +1,217 @@
+#include "video_convert_row.h"
+
+#include <cstring>
+
+namespace video_convert {
+namespace row {
+namespace scalar {
+
+namespace {
+
+uint8_t Clamp255(int value) {
+  return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// Mirrors the int16 saturation of the SIMD blue channel.
+int SaturateInt16(int value) {
+  return value > 32767 ? 32767 : (value < -32768 ? -32768 : value);
+}
+
+void YuvPixel(int y, int u, int v, uint8_t* dst, bool bgra) {
+  int yy = (y - 16) * kYToRgb + 32;
+  int d = u - 128;
+  int e = v - 128;
+  int r = (yy + kVToR * e) >> 6;
+  int g = (yy - kUToG * d - kVToG * e) >> 6;
+  int b = SaturateInt16(yy + kUToB * d) >> 6;
+  dst[bgra ? 2 : 0] = Clamp255(r);
+  dst[1] = Clamp255(g);
+  dst[bgra ? 0 : 2] = Clamp255(b);
+  dst[3] = 255;
+}
+
+template <int kChannels>
+void Down2Channels(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  for (int x = 0; x < dst_width; x++) {
+    for (int c = 0; c < kChannels; c++) {
+      int i = x * 2 * kChannels + c;
+      dst[x * kChannels + c] =
+          static_cast<uint8_t>((s0[i] + s0[i + kChannels] + s1[i] + s1[i + kChannels] + 2) >> 2);
+    }
+  }
+}
+
+template <int kChannels>
+void Down4Channels(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  for (int x = 0; x < dst_width; x++) {
+    for (int c = 0; c < kChannels; c++) {
+      int sum = 0;
+      for (int r = 0; r < 4; r++) {
+        const uint8_t* s = src + r * stride + x * 4 * kChannels + c;
+        sum += s[0] + s[kChannels] + s[2 * kChannels] + s[3 * kChannels];
+      }
+      dst[x * kChannels + c] = static_cast<uint8_t>((sum + 8) >> 4);
+    }
+  }
+}
+
+}  // namespace
+
+void I420ToRgba(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                uint8_t* dst, int width, bool bgra) {
+  for (int x = 0; x < width; x++) {
+    YuvPixel(y[x], u[x / 2], v[x / 2], dst + x * 4, bgra);
+  }
+}
+
+void NvToRgba(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width,
+              bool bgra, bool vu) {
+  int u_offset = vu ? 1 : 0;
+  for (int x = 0; x < width; x++) {
+    const uint8_t* chroma = uv + (x / 2) * 2;
+    YuvPixel(y[x], chroma[u_offset], chroma[1 - u_offset], dst + x * 4, bgra);
+  }
+}
+
+void RgbaToY(const uint8_t* src, uint8_t* y, int width, bool bgra) {
+  int ri = bgra ? 2 : 0;
+  int bi = bgra ? 0 : 2;
+  for (int x = 0; x < width; x++) {
+    const uint8_t* px = src + x * 4;
+    y[x] = static_cast<uint8_t>(((33 * px[ri] + 64 * px[1] + 13 * px[bi] + 64) >> 7) + 16);
+  }
+}
+
+void RgbaToUv(const uint8_t* src0, const uint8_t* src1, uint8_t* u, uint8_t* v,
+              int width, bool bgra) {
+  int ri = bgra ? 2 : 0;
+  int bi = bgra ? 0 : 2;
+  for (int x = 0; x < width; x += 2) {
+    // An odd last column is paired with itself.
+    int next = (x + 1 < width ? 1 : 0) * 4;
+    const uint8_t* a = src0 + x * 4;
+    const uint8_t* b = src1 + x * 4;
+    int r = (a[ri] + a[ri + next] + b[ri] + b[ri + next] + 2) >> 2;
+    int g = (a[1] + a[1 + next] + b[1] + b[1 + next] + 2) >> 2;
+    int bl = (a[bi] + a[bi + next] + b[bi] + b[bi + next] + 2) >> 2;
+    u[x / 2] = static_cast<uint8_t>(((112 * bl - 38 * r - 74 * g + 128) >> 8) + 128);
+    v[x / 2] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * bl + 128) >> 8) + 128);
+  }
+}
+
+void ShufflePixels(const uint8_t* src, uint8_t* dst, int width,
+                   const uint8_t order[4]) {
+  for (int x = 0; x < width; x++) {
+    const uint8_t* px = src + x * 4;
+    uint8_t* out = dst + x * 4;
+    out[0] = px[order[0]];
+    out[1] = px[order[1]];
+    out[2] = px[order[2]];
+    out[3] = px[order[3]];
+  }
+}
+
+void SplitUv(const uint8_t* uv, uint8_t* u, uint8_t* v, int width) {
+  for (int x = 0; x < width; x++) {
+    u[x] = uv[x * 2];
+    v[x] = uv[x * 2 + 1];
+  }
+}
+
+void MergeUv(const uint8_t* u, const uint8_t* v, uint8_t* uv, int width) {
+  for (int x = 0; x < width; x++) {
+    uv[x * 2] = u[x];
+    uv[x * 2 + 1] = v[x];
+  }
+}
+
+void Mirror8(const uint8_t* src, uint8_t* dst, int width) {
+  for (int x = 0; x < width; x++) {
+    dst[x] = src[width - 1 - x];
+  }
+}
+
+void Mirror16(const uint8_t* src, uint8_t* dst, int width) {
+  for (int x = 0; x < width; x++) {
+    memcpy(dst + x * 2, src + (width - 1 - x) * 2, 2);
+  }
+}
+
+void Mirror32(const uint8_t* src, uint8_t* dst, int width) {
+  for (int x = 0; x < width; x++) {
+    memcpy(dst + x * 4, src + (width - 1 - x) * 4, 4);
+  }
+}
+
+void Down2(const uint8_t* src, int stride, uint8_t* dst, int dst_width,
+           int channels) {
+  switch (channels) {
+    case 1:
+      Down2Channels<1>(src, stride, dst, dst_width);
+      break;
+    case 2:
+      Down2Channels<2>(src, stride, dst, dst_width);
+      break;
+    default:
+      Down2Channels<4>(src, stride, dst, dst_width);
+      break;
+  }
+}
+
+void Down4(const uint8_t* src, int stride, uint8_t* dst, int dst_width,
+           int channels) {
+  switch (channels) {
+    case 1:
+      Down4Channels<1>(src, stride, dst, dst_width);
+      break;
+    case 2:
+      Down4Channels<2>(src, stride, dst, dst_width);
+      break;
+    default:
+      Down4Channels<4>(src, stride, dst, dst_width);
+      break;
+  }
+}
+
+void Interpolate(const uint8_t* src0, const uint8_t* src1, uint8_t* dst,
+                 int bytes, int fraction) {
+  int f = fraction >> 1;
+  if (f == 0) {
+    memcpy(dst, src0, bytes);
+    return;
+  }
+  for (int i = 0; i < bytes; i++) {
+    dst[i] = static_cast<uint8_t>((src0[i] * (128 - f) + src1[i] * f + 64) >> 7);
+  }
+}
+
+}  // namespace scalar
+
+void InitScalar(Kernels* kernels) {
+  kernels->i420_to_rgba = scalar::I420ToRgba;
+  kernels->nv_to_rgba = scalar::NvToRgba;
+  kernels->rgba_to_y = scalar::RgbaToY;
+  kernels->rgba_to_uv = scalar::RgbaToUv;
+  kernels->shuffle_pixels = scalar::ShufflePixels;
+  kernels->split_uv = scalar::SplitUv;
+  kernels->merge_uv = scalar::MergeUv;
+  kernels->mirror8 = scalar::Mirror8;
+  kernels->mirror16 = scalar::Mirror16;
+  kernels->mirror32 = scalar::Mirror32;
+  for (int c = 0; c < 5; c++) {
+    kernels->down2[c] = nullptr;
+    kernels->down4[c] = nullptr;
+  }
+  kernels->down2[1] = scalar::Down2Channels<1>;
+  kernels->down2[2] = scalar::Down2Channels<2>;
+  kernels->down2[4] = scalar::Down2Channels<4>;
+  kernels->down4[1] = scalar::Down4Channels<1>;
+  kernels->down4[2] = scalar::Down4Channels<2>;
+  kernels->down4[4] = scalar::Down4Channels<4>;
+  kernels->interpolate = scalar::Interpolate;
+}
+
+}  // namespace row
+}  // namespace video_convert
@@ -0,0 +1,107 @@
+#ifndef FLUTTER_VIDEO_CONVERT_ROW_H_
+#define FLUTTER_VIDEO_CONVERT_ROW_H_
+
+#include <cstdint>
+
+// Row kernels behind Convert() and Scale(). Every SIMD implementation must
+// produce exactly the same bytes as the scalar one, which it also uses for the
+// tail of each row, so the fixed point formulas below are part of the
+// contract.
+//
+// YUV to RGB, BT.601 limited range, 6 bit coefficients:
+//   yy = (Y - 16) * 75 + 32
+//   R = (yy + 102 * (V - 128)) >> 6
+//   G = (yy - 25 * (U - 128) - 52 * (V - 128)) >> 6
+//   B = (yy + 129 * (U - 128)) >> 6, may saturate at int16 before shifting
+// RGB to Y, 7 bit coefficients:
+//   Y = ((33 * R + 64 * G + 13 * B + 64) >> 7) + 16, so 0..255 maps to 16..235
+// RGB to UV on the rounded average of each 2x2 block:
+//   U = ((112 * B - 38 * R - 74 * G + 128) >> 8) + 128
+//   V = ((112 * R - 94 * G - 18 * B + 128) >> 8) + 128
+
+namespace video_convert {
+namespace row {
+
+constexpr int kYToRgb = 75;
+constexpr int kVToR = 102;
+constexpr int kUToG = 25;
+constexpr int kVToG = 52;
+constexpr int kUToB = 129;
+
+struct Kernels {
+  // YUV to 32 bit RGBA, or BGRA when |bgra|. |width| is in pixels, chroma
+  // rows hold (width + 1) / 2 samples. |vu| selects NV21 ordering.
+  void (*i420_to_rgba)(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                       uint8_t* dst, int width, bool bgra);
+  void (*nv_to_rgba)(const uint8_t* y, const uint8_t* uv, uint8_t* dst,
+                     int width, bool bgra, bool vu);
+
+  // RGBA or BGRA to a row of Y, and two rows to one row of U and V.
+  void (*rgba_to_y)(const uint8_t* src, uint8_t* y, int width, bool bgra);
+  void (*rgba_to_uv)(const uint8_t* src0, const uint8_t* src1, uint8_t* u,
+                     uint8_t* v, int width, bool bgra);
+
+  // Reorders the bytes of each 32 bit pixel: dst[i] = src[order[i]].
+  void (*shuffle_pixels)(const uint8_t* src, uint8_t* dst, int width,
+                         const uint8_t order[4]);
+
+  // Chroma (de)interleaving, |width| in samples per plane.
+  void (*split_uv)(const uint8_t* uv, uint8_t* u, uint8_t* v, int width);
+  void (*merge_uv)(const uint8_t* u, const uint8_t* v, uint8_t* uv, int width);
+
+  // Reverses a row of 1, 2 or 4 byte units. |src| and |dst| must not overlap.
+  void (*mirror8)(const uint8_t* src, uint8_t* dst, int width);
+  void (*mirror16)(const uint8_t* src, uint8_t* dst, int width);
+  void (*mirror32)(const uint8_t* src, uint8_t* dst, int width);
+
+  // Box filters producing one row of |dst_width| pixels from two or four rows
+  // starting at |src|, indexed by channel count (1, 2 or 4):
+  //   down2: (sum of 2x2 + 2) >> 2,  down4: (sum of 4x4 + 8) >> 4
+  void (*down2[5])(const uint8_t* src, int stride, uint8_t* dst, int dst_width);
+  void (*down4[5])(const uint8_t* src, int stride, uint8_t* dst, int dst_width);
+
+  // Vertical blend of two rows, |fraction| 0..255 towards |src1|:
+  //   f = fraction >> 1, dst = f ? (src0 * (128 - f) + src1 * f + 64) >> 7 : src0
+  void (*interpolate)(const uint8_t* src0, const uint8_t* src1, uint8_t* dst,
+                      int bytes, int fraction);
+};
+
+// Fills every entry with the portable implementation.
+void InitScalar(Kernels* kernels);
+
+// Override the entries they accelerate. Only linked in when the build has the
+// matching VIDEO_CONVERT_HAVE_* definition.
+void InitSSE41(Kernels* kernels);
+void InitAVX2(Kernels* kernels);
+void InitNEON(Kernels* kernels);
+
+// Portable kernels, also used for the tails of SIMD rows.
+namespace scalar {
+
+void I420ToRgba(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                uint8_t* dst, int width, bool bgra);
+void NvToRgba(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width,
+              bool bgra, bool vu);
+void RgbaToY(const uint8_t* src, uint8_t* y, int width, bool bgra);
+void RgbaToUv(const uint8_t* src0, const uint8_t* src1, uint8_t* u, uint8_t* v,
+              int width, bool bgra);
+void ShufflePixels(const uint8_t* src, uint8_t* dst, int width,
+                   const uint8_t order[4]);
+void SplitUv(const uint8_t* uv, uint8_t* u, uint8_t* v, int width);
+void MergeUv(const uint8_t* u, const uint8_t* v, uint8_t* uv, int width);
+void Mirror8(const uint8_t* src, uint8_t* dst, int width);
+void Mirror16(const uint8_t* src, uint8_t* dst, int width);
+void Mirror32(const uint8_t* src, uint8_t* dst, int width);
+void Down2(const uint8_t* src, int stride, uint8_t* dst, int dst_width,
+           int channels);
+void Down4(const uint8_t* src, int stride, uint8_t* dst, int dst_width,
+           int channels);
+void Interpolate(const uint8_t* src0, const uint8_t* src1, uint8_t* dst,
+                 int bytes, int fraction);
+
+}  // namespace scalar
+
+}  // namespace row
+}  // namespace video_convert
+
+#endif  // FLUTTER_VIDEO_CONVERT_ROW_H_
@@ -0,0 +1,394 @@
+// Built with -msse4.1 and only called after a runtime CPU check.
+
+#include <smmintrin.h>
+
+#include <cstring>
+
+#include "video_convert_row.h"
+
+namespace video_convert {
+namespace row {
+
+namespace {
+
+__m128i Load64(const uint8_t* p) {
+  return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+}
+
+__m128i Load128(const uint8_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+void Store128(uint8_t* p, __m128i value) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), value);
+}
+
+__m128i Load32(const uint8_t* p) {
+  int32_t value;
+  memcpy(&value, p, 4);
+  return _mm_cvtsi32_si128(value);
+}
+
+void Store32(uint8_t* p, __m128i value) {
+  int32_t lane = _mm_cvtsi128_si32(value);
+  memcpy(p, &lane, 4);
+}
+
+// Eight pixels from 16 bit Y, U and V, one sample per output pixel.
+void YuvToRgba8(__m128i y, __m128i u, __m128i v, uint8_t* dst, bool bgra) {
+  const __m128i yy = _mm_add_epi16(
+      _mm_mullo_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)), _mm_set1_epi16(kYToRgb)),
+      _mm_set1_epi16(32));
+  const __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+  const __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+  __m128i r = _mm_srai_epi16(_mm_add_epi16(yy, _mm_mullo_epi16(e, _mm_set1_epi16(kVToR))), 6);
+  __m128i g = _mm_srai_epi16(
+      _mm_sub_epi16(_mm_sub_epi16(yy, _mm_mullo_epi16(d, _mm_set1_epi16(kUToG))),
+                    _mm_mullo_epi16(e, _mm_set1_epi16(kVToG))),
+      6);
+  __m128i b = _mm_srai_epi16(_mm_adds_epi16(yy, _mm_mullo_epi16(d, _mm_set1_epi16(kUToB))), 6);
+  if (bgra) {
+    __m128i t = r;
+    r = b;
+    b = t;
+  }
+  const __m128i rb = _mm_packus_epi16(r, b);
+  const __m128i ga = _mm_packus_epi16(g, _mm_set1_epi16(255));
+  const __m128i rg = _mm_unpacklo_epi8(rb, ga);
+  const __m128i ba = _mm_unpackhi_epi8(rb, ga);
+  Store128(dst, _mm_unpacklo_epi16(rg, ba));
+  Store128(dst + 16, _mm_unpackhi_epi16(rg, ba));
+}
+
+void I420ToRgba(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst,
+                int width, bool bgra) {
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i u8 = Load32(u + x / 2);
+    const __m128i v8 = Load32(v + x / 2);
+    YuvToRgba8(_mm_cvtepu8_epi16(Load64(y + x)), _mm_cvtepu8_epi16(_mm_unpacklo_epi8(u8, u8)),
+               _mm_cvtepu8_epi16(_mm_unpacklo_epi8(v8, v8)), dst + x * 4, bgra);
+  }
+  if (x < width) {
+    scalar::I420ToRgba(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, bgra);
+  }
+}
+
+void NvToRgba(const uint8_t* y, const uint8_t* uv, uint8_t* dst, int width, bool bgra,
+              bool vu) {
+  // Each chroma byte duplicated into two zero-extended 16 bit lanes.
+  const __m128i even = _mm_setr_epi8(0, -1, 0, -1, 2, -1, 2, -1, 4, -1, 4, -1, 6, -1, 6, -1);
+  const __m128i odd = _mm_setr_epi8(1, -1, 1, -1, 3, -1, 3, -1, 5, -1, 5, -1, 7, -1, 7, -1);
+  const __m128i u_mask = vu ? odd : even;
+  const __m128i v_mask = vu ? even : odd;
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i chroma = Load64(uv + x);
+    YuvToRgba8(_mm_cvtepu8_epi16(Load64(y + x)), _mm_shuffle_epi8(chroma, u_mask),
+               _mm_shuffle_epi8(chroma, v_mask), dst + x * 4, bgra);
+  }
+  if (x < width) {
+    scalar::NvToRgba(y + x, uv + x, dst + x * 4, width - x, bgra, vu);
+  }
+}
+
+void RgbaToY(const uint8_t* src, uint8_t* y, int width, bool bgra) {
+  const __m128i coeff = bgra ? _mm_setr_epi8(13, 64, 33, 0, 13, 64, 33, 0, 13, 64, 33, 0, 13, 64, 33, 0)
+                             : _mm_setr_epi8(33, 64, 13, 0, 33, 64, 13, 0, 33, 64, 13, 0, 33, 64, 13, 0);
+  const __m128i round = _mm_set1_epi16(64);
+  const __m128i offset = _mm_set1_epi16(16);
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8_t* p = src + x * 4;
+    __m128i lo = _mm_hadd_epi16(_mm_maddubs_epi16(Load128(p), coeff),
+                                _mm_maddubs_epi16(Load128(p + 16), coeff));
+    __m128i hi = _mm_hadd_epi16(_mm_maddubs_epi16(Load128(p + 32), coeff),
+                                _mm_maddubs_epi16(Load128(p + 48), coeff));
+    lo = _mm_add_epi16(_mm_srli_epi16(_mm_add_epi16(lo, round), 7), offset);
+    hi = _mm_add_epi16(_mm_srli_epi16(_mm_add_epi16(hi, round), 7), offset);
+    Store128(y + x, _mm_packus_epi16(lo, hi));
+  }
+  if (x < width) {
+    scalar::RgbaToY(src + x * 4, y + x, width - x, bgra);
+  }
+}
+
+void RgbaToUv(const uint8_t* src0, const uint8_t* src1, uint8_t* u, uint8_t* v, int width,
+              bool bgra) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i u_coeff = bgra ? _mm_setr_epi16(112, -74, -38, 0, 112, -74, -38, 0)
+                               : _mm_setr_epi16(-38, -74, 112, 0, -38, -74, 112, 0);
+  const __m128i v_coeff = bgra ? _mm_setr_epi16(-18, -94, 112, 0, -18, -94, 112, 0)
+                               : _mm_setr_epi16(112, -94, -18, 0, 112, -94, -18, 0);
+  const __m128i two = _mm_set1_epi16(2);
+  const __m128i round = _mm_set1_epi32(128);
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    const __m128i a0 = Load128(src0 + x * 4);
+    const __m128i a1 = Load128(src0 + x * 4 + 16);
+    const __m128i b0 = Load128(src1 + x * 4);
+    const __m128i b1 = Load128(src1 + x * 4 + 16);
+    // Column sums of pixels 0-1, 2-3, 4-5 and 6-7 as 16 bit channels.
+    const __m128i p01 = _mm_add_epi16(_mm_cvtepu8_epi16(a0), _mm_cvtepu8_epi16(b0));
+    const __m128i p23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+    const __m128i p45 = _mm_add_epi16(_mm_cvtepu8_epi16(a1), _mm_cvtepu8_epi16(b1));
+    const __m128i p67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+    // 2x2 averages of chroma samples 0-1 and 2-3.
+    __m128i c01 = _mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23));
+    __m128i c23 = _mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67));
+    c01 = _mm_srli_epi16(_mm_add_epi16(c01, two), 2);
+    c23 = _mm_srli_epi16(_mm_add_epi16(c23, two), 2);
+
+    __m128i us = _mm_hadd_epi32(_mm_madd_epi16(c01, u_coeff), _mm_madd_epi16(c23, u_coeff));
+    __m128i vs = _mm_hadd_epi32(_mm_madd_epi16(c01, v_coeff), _mm_madd_epi16(c23, v_coeff));
+    us = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(us, round), 8), round);
+    vs = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(vs, round), 8), round);
+    const __m128i packed = _mm_packus_epi16(_mm_packus_epi32(us, vs), zero);
+    Store32(u + x / 2, packed);
+    Store32(v + x / 2, _mm_srli_si128(packed, 4));
+  }
+  if (x < width) {
+    scalar::RgbaToUv(src0 + x * 4, src1 + x * 4, u + x / 2, v + x / 2, width - x, bgra);
+  }
+}
+
+void ShufflePixels(const uint8_t* src, uint8_t* dst, int width, const uint8_t order[4]) {
+  alignas(16) uint8_t mask_bytes[16];
+  for (int i = 0; i < 16; i++) {
+    mask_bytes[i] = static_cast<uint8_t>((i & ~3) + order[i & 3]);
+  }
+  const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(mask_bytes));
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    Store128(dst + x * 4, _mm_shuffle_epi8(Load128(src + x * 4), mask));
+  }
+  if (x < width) {
+    scalar::ShufflePixels(src + x * 4, dst + x * 4, width - x, order);
+  }
+}
+
+void SplitUv(const uint8_t* uv, uint8_t* u, uint8_t* v, int width) {
+  const __m128i mask = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m128i lo = _mm_shuffle_epi8(Load128(uv + x * 2), mask);
+    const __m128i hi = _mm_shuffle_epi8(Load128(uv + x * 2 + 16), mask);
+    Store128(u + x, _mm_unpacklo_epi64(lo, hi));
+    Store128(v + x, _mm_unpackhi_epi64(lo, hi));
+  }
+  if (x < width) {
+    scalar::SplitUv(uv + x * 2, u + x, v + x, width - x);
+  }
+}
+
+void MergeUv(const uint8_t* u, const uint8_t* v, uint8_t* uv, int width) {
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const __m128i us = Load128(u + x);
+    const __m128i vs = Load128(v + x);
+    Store128(uv + x * 2, _mm_unpacklo_epi8(us, vs));
+    Store128(uv + x * 2 + 16, _mm_unpackhi_epi8(us, vs));
+  }
+  if (x < width) {
+    scalar::MergeUv(u + x, v + x, uv + x * 2, width - x);
+  }
+}
+
+// Mirrors whole 16 byte blocks from the end of |src|; |reverse| reverses the
+// units inside one block.
+template <int kUnit, typename Kernel>
+void MirrorBlocks(const uint8_t* src, uint8_t* dst, int width, Kernel reverse,
+                  void (*tail)(const uint8_t*, uint8_t*, int)) {
+  const int per_block = 16 / kUnit;
+  int x = 0;
+  for (; x + per_block <= width; x += per_block) {
+    Store128(dst + x * kUnit, reverse(Load128(src + (width - x - per_block) * kUnit)));
+  }
+  if (x < width) {
+    tail(src, dst + x * kUnit, width - x);
+  }
+}
+
+void Mirror8(const uint8_t* src, uint8_t* dst, int width) {
+  const __m128i mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  MirrorBlocks<1>(src, dst, width, [mask](__m128i v) { return _mm_shuffle_epi8(v, mask); },
+                  scalar::Mirror8);
+}
+
+void Mirror16(const uint8_t* src, uint8_t* dst, int width) {
+  const __m128i mask = _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  MirrorBlocks<2>(src, dst, width, [mask](__m128i v) { return _mm_shuffle_epi8(v, mask); },
+                  scalar::Mirror16);
+}
+
+void Mirror32(const uint8_t* src, uint8_t* dst, int width) {
+  MirrorBlocks<4>(src, dst, width,
+                  [](__m128i v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); },
+                  scalar::Mirror32);
+}
+
+void Down2Gray(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  const __m128i ones = _mm_set1_epi8(1);
+  const __m128i two = _mm_set1_epi16(2);
+  int x = 0;
+  for (; x + 16 <= dst_width; x += 16) {
+    __m128i lo = _mm_add_epi16(_mm_maddubs_epi16(Load128(s0 + x * 2), ones),
+                               _mm_maddubs_epi16(Load128(s1 + x * 2), ones));
+    __m128i hi = _mm_add_epi16(_mm_maddubs_epi16(Load128(s0 + x * 2 + 16), ones),
+                               _mm_maddubs_epi16(Load128(s1 + x * 2 + 16), ones));
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+    Store128(dst + x, _mm_packus_epi16(lo, hi));
+  }
+  if (x < dst_width) {
+    scalar::Down2(src + x * 2, stride, dst + x, dst_width - x, 1);
+  }
+}
+
+// Sums of vertically adjacent 16 bit pixels from 16 source bytes of two rows.
+void ColumnSums(const uint8_t* s0, const uint8_t* s1, __m128i* lo, __m128i* hi) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i a = Load128(s0);
+  const __m128i b = Load128(s1);
+  *lo = _mm_add_epi16(_mm_cvtepu8_epi16(a), _mm_cvtepu8_epi16(b));
+  *hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+}
+
+void Down2Uv(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  const __m128i two = _mm_set1_epi16(2);
+  int x = 0;
+  for (; x + 8 <= dst_width; x += 8) {
+    __m128i out[2];
+    for (int half = 0; half < 2; half++) {
+      __m128i lo, hi;
+      ColumnSums(s0 + x * 4 + half * 16, s1 + x * 4 + half * 16, &lo, &hi);
+      // Gather even and odd 32 bit pairs, then add them.
+      lo = _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0));
+      hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0));
+      const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+      out[half] = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+    }
+    Store128(dst + x * 2, _mm_packus_epi16(out[0], out[1]));
+  }
+  if (x < dst_width) {
+    scalar::Down2(src + x * 4, stride, dst + x * 2, dst_width - x, 2);
+  }
+}
+
+void Down2Rgba(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const uint8_t* s0 = src;
+  const uint8_t* s1 = src + stride;
+  const __m128i two = _mm_set1_epi16(2);
+  int x = 0;
+  for (; x + 4 <= dst_width; x += 4) {
+    __m128i p01, p23, p45, p67;
+    ColumnSums(s0 + x * 8, s1 + x * 8, &p01, &p23);
+    ColumnSums(s0 + x * 8 + 16, s1 + x * 8 + 16, &p45, &p67);
+    __m128i d01 = _mm_add_epi16(_mm_unpacklo_epi64(p01, p23), _mm_unpackhi_epi64(p01, p23));
+    __m128i d23 = _mm_add_epi16(_mm_unpacklo_epi64(p45, p67), _mm_unpackhi_epi64(p45, p67));
+    d01 = _mm_srli_epi16(_mm_add_epi16(d01, two), 2);
+    d23 = _mm_srli_epi16(_mm_add_epi16(d23, two), 2);
+    Store128(dst + x * 4, _mm_packus_epi16(d01, d23));
+  }
+  if (x < dst_width) {
+    scalar::Down2(src + x * 8, stride, dst + x * 4, dst_width - x, 4);
+  }
+}
+
+void Down4Gray(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const __m128i ones = _mm_set1_epi8(1);
+  const __m128i eight = _mm_set1_epi16(8);
+  int x = 0;
+  for (; x + 8 <= dst_width; x += 8) {
+    __m128i lo = _mm_setzero_si128();
+    __m128i hi = _mm_setzero_si128();
+    for (int r = 0; r < 4; r++) {
+      const uint8_t* s = src + r * stride + x * 4;
+      lo = _mm_add_epi16(lo, _mm_maddubs_epi16(Load128(s), ones));
+      hi = _mm_add_epi16(hi, _mm_maddubs_epi16(Load128(s + 16), ones));
+    }
+    __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_hadd_epi16(lo, hi), eight), 4);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(sum, sum));
+  }
+  if (x < dst_width) {
+    scalar::Down4(src + x * 4, stride, dst + x, dst_width - x, 1);
+  }
+}
+
+void Down4Rgba(const uint8_t* src, int stride, uint8_t* dst, int dst_width) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i eight = _mm_set1_epi16(8);
+  // Channel sums of one 4x4 block in the low 64 bits.
+  auto block = [&](const uint8_t* s) {
+    __m128i acc = zero;
+    for (int r = 0; r < 4; r++) {
+      const __m128i v = Load128(s + r * stride);
+      acc = _mm_add_epi16(acc, _mm_add_epi16(_mm_cvtepu8_epi16(v), _mm_unpackhi_epi8(v, zero)));
+    }
+    return _mm_add_epi16(acc, _mm_srli_si128(acc, 8));
+  };
+  int x = 0;
+  for (; x + 4 <= dst_width; x += 4) {
+    const uint8_t* s = src + x * 16;
+    __m128i d01 = _mm_unpacklo_epi64(block(s), block(s + 16));
+    __m128i d23 = _mm_unpacklo_epi64(block(s + 32), block(s + 48));
+    d01 = _mm_srli_epi16(_mm_add_epi16(d01, eight), 4);
+    d23 = _mm_srli_epi16(_mm_add_epi16(d23, eight), 4);
+    Store128(dst + x * 4, _mm_packus_epi16(d01, d23));
+  }
+  if (x < dst_width) {
+    scalar::Down4(src + x * 16, stride, dst + x * 4, dst_width - x, 4);
+  }
+}
+
+void Interpolate(const uint8_t* src0, const uint8_t* src1, uint8_t* dst, int bytes,
+                 int fraction) {
+  const int f = fraction >> 1;
+  if (f == 0) {
+    memcpy(dst, src0, bytes);
+    return;
+  }
+  const __m128i coeff = _mm_set1_epi16(static_cast<int16_t>((f << 8) | (128 - f)));
+  const __m128i round = _mm_set1_epi16(64);
+  int i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    const __m128i a = Load128(src0 + i);
+    const __m128i b = Load128(src1 + i);
+    __m128i lo = _mm_maddubs_epi16(_mm_unpacklo_epi8(a, b), coeff);
+    __m128i hi = _mm_maddubs_epi16(_mm_unpackhi_epi8(a, b), coeff);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 7);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 7);
+    Store128(dst + i, _mm_packus_epi16(lo, hi));
+  }
+  if (i < bytes) {
+    scalar::Interpolate(src0 + i, src1 + i, dst + i, bytes - i, fraction);
+  }
+}
+
+}  // namespace
+
+void InitSSE41(Kernels* kernels) {
+  kernels->i420_to_rgba = I420ToRgba;
+  kernels->nv_to_rgba = NvToRgba;
+  kernels->rgba_to_y = RgbaToY;
+  kernels->rgba_to_uv = RgbaToUv;
+  kernels->shuffle_pixels = ShufflePixels;
+  kernels->split_uv = SplitUv;
+  kernels->merge_uv = MergeUv;
+  kernels->mirror8 = Mirror8;
+  kernels->mirror16 = Mirror16;
+  kernels->mirror32 = Mirror32;
+  kernels->down2[1] = Down2Gray;
+  kernels->down2[2] = Down2Uv;
+  kernels->down2[4] = Down2Rgba;
+  kernels->down4[1] = Down4Gray;
+  kernels->down4[4] = Down4Rgba;
+  kernels->interpolate = Interpolate;
+}
+
+}  // namespace row
+}  // namespace video_convert
@@ -0,0 +1,260 @@
+// Checks Convert() and Scale() at every SIMD level the build and CPU support:
+// known BT.601 values for solid colors, flips against flipped sources, row
+// padding left untouched, and every SIMD level byte for byte against the
+// scalar kernels on odd sized, padded frames.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "video_convert.h"
+#include "video_convert_test_util.h"
+
+namespace video_convert {
+namespace {
+
+using test_util::FormatName;
+using test_util::SupportedLevels;
+using test_util::TestFrame;
+
+struct Rgb {
+  uint8_t r, g, b;
+};
+
+struct Yuv {
+  int y, u, v;
+};
+
+// Wide enough for every SIMD row kernel plus a scalar tail.
+constexpr int kWidth = 70;
+constexpr int kHeight = 6;
+constexpr int kPadding = 9;
+
+class VideoConvertTest : public ::testing::TestWithParam<SimdLevel> {
+ protected:
+  void SetUp() override { ASSERT_EQ(SetSimdLevel(GetParam()), GetParam()); }
+  void TearDown() override { SetSimdLevel(DetectSimdLevel()); }
+};
+
+void Fill(const Frame& frame, Rgb color) {
+  const bool bgra = frame.format == PixelFormat::kBGRA;
+  for (int y = 0; y < frame.height; y++) {
+    uint8_t* row = frame.planes[0] + y * frame.strides[0];
+    for (int x = 0; x < frame.width; x++) {
+      row[x * 4 + 0] = bgra ? color.b : color.r;
+      row[x * 4 + 1] = color.g;
+      row[x * 4 + 2] = bgra ? color.r : color.b;
+      row[x * 4 + 3] = 255;
+    }
+  }
+}
+
+// Every sample of |plane| that is not row padding.
+std::vector<uint8_t> Samples(const Frame& frame, int plane, int row_bytes, int rows) {
+  std::vector<uint8_t> samples;
+  for (int y = 0; y < rows; y++) {
+    const uint8_t* row = frame.planes[plane] + y * frame.strides[plane];
+    samples.insert(samples.end(), row, row + row_bytes);
+  }
+  return samples;
+}
+
+// The padding bytes at the end of every row of |plane|.
+std::vector<uint8_t> Padding(const Frame& frame, int plane, int row_bytes, int rows) {
+  std::vector<uint8_t> padding;
+  for (int y = 0; y < rows; y++) {
+    const uint8_t* row = frame.planes[plane] + y * frame.strides[plane];
+    padding.insert(padding.end(), row + row_bytes, row + frame.strides[plane]);
+  }
+  return padding;
+}
+
+// Converts a solid |color| to I420 and checks every sample is |expected|, within
+// |tolerance| of the reference BT.601 value.
+void ExpectYuv(PixelFormat format, Rgb color, Yuv expected, int tolerance) {
+  TestFrame src(format, kWidth, kHeight, kPadding, 1);
+  TestFrame dst(PixelFormat::kI420, kWidth, kHeight, kPadding, 2);
+  Fill(src.frame(), color);
+  const int chroma_width = (kWidth + 1) / 2;
+  const int chroma_height = (kHeight + 1) / 2;
+  std::vector<uint8_t> padding[3] = {Padding(dst.frame(), 0, kWidth, kHeight),
+                                     Padding(dst.frame(), 1, chroma_width, chroma_height),
+                                     Padding(dst.frame(), 2, chroma_width, chroma_height)};
+  ASSERT_TRUE(Convert(src.frame(), dst.frame()));
+
+  const int values[3] = {expected.y, expected.u, expected.v};
+  for (int plane = 0; plane < 3; plane++) {
+    const int row_bytes = plane == 0 ? kWidth : chroma_width;
+    const int rows = plane == 0 ? kHeight : chroma_height;
+    std::vector<uint8_t> samples = Samples(dst.frame(), plane, row_bytes, rows);
+    for (uint8_t sample : samples) {
+      ASSERT_EQ(sample, samples[0]) << "plane " << plane << " is not uniform";
+    }
+    EXPECT_NEAR(samples[0], values[plane], tolerance) << "plane " << plane;
+    EXPECT_EQ(Padding(dst.frame(), plane, row_bytes, rows), padding[plane])
+        << "plane " << plane << " padding written";
+  }
+}
+
+TEST_P(VideoConvertTest, WhiteAndBlackHitTheLimitedRange) {
+  for (PixelFormat format : {PixelFormat::kRGBA, PixelFormat::kBGRA}) {
+    SCOPED_TRACE(FormatName(format));
+    ExpectYuv(format, {255, 255, 255}, {235, 128, 128}, 0);
+    ExpectYuv(format, {0, 0, 0}, {16, 128, 128}, 0);
+  }
+}
+
+TEST_P(VideoConvertTest, PrimariesMatchBt601) {
+  // Rounded reference values of the BT.601 limited range matrix.
+  for (PixelFormat format : {PixelFormat::kRGBA, PixelFormat::kBGRA}) {
+    SCOPED_TRACE(FormatName(format));
+    ExpectYuv(format, {255, 0, 0}, {81, 90, 240}, 1);
+    ExpectYuv(format, {0, 255, 0}, {145, 54, 34}, 1);
+    ExpectYuv(format, {0, 0, 255}, {41, 240, 110}, 1);
+  }
+}
+
+TEST_P(VideoConvertTest, LimitedRangeDecodesToFullRange) {
+  const uint8_t levels[][3] = {{235, 255, 255}, {16, 0, 0}};
+  for (const auto& level : levels) {
+    TestFrame src(PixelFormat::kNV12, kWidth, kHeight, kPadding, 1);
+    for (int y = 0; y < kHeight; y++) {
+      memset(src.frame().planes[0] + y * src.frame().strides[0], level[0], kWidth);
+    }
+    for (int y = 0; y < (kHeight + 1) / 2; y++) {
+      memset(src.frame().planes[1] + y * src.frame().strides[1], 128, kWidth + 1);
+    }
+    for (PixelFormat format : {PixelFormat::kRGBA, PixelFormat::kBGRA}) {
+      TestFrame dst(format, kWidth, kHeight, kPadding, 2);
+      std::vector<uint8_t> padding = Padding(dst.frame(), 0, kWidth * 4, kHeight);
+      ASSERT_TRUE(Convert(src.frame(), dst.frame()));
+      std::vector<uint8_t> samples = Samples(dst.frame(), 0, kWidth * 4, kHeight);
+      for (size_t i = 0; i < samples.size(); i++) {
+        ASSERT_EQ(samples[i], i % 4 == 3 ? 255 : level[1]) << "Y " << int(level[0]) << " at " << i;
+      }
+      EXPECT_EQ(Padding(dst.frame(), 0, kWidth * 4, kHeight), padding);
+    }
+  }
+}
+
+// A copy of |src| mirrored and/or turned upside down plane by plane. Needs
+// even sizes so chroma flips with luma.
+void FlipInto(const Frame& src, const Frame& dst, FlipMode flip) {
+  const bool packed = src.format != PixelFormat::kI420 && src.format != PixelFormat::kNV12 &&
+                      src.format != PixelFormat::kNV21;
+  const int planes = packed ? 1 : (src.format == PixelFormat::kI420 ? 3 : 2);
+  for (int plane = 0; plane < planes; plane++) {
+    const int unit = packed ? 4 : (plane > 0 && planes == 2 ? 2 : 1);
+    const int width = plane == 0 ? src.width : src.width / 2;
+    const int height = plane == 0 ? src.height : src.height / 2;
+    for (int y = 0; y < height; y++) {
+      const int from_y = (flip & kFlipY) ? height - 1 - y : y;
+      const uint8_t* in = src.planes[plane] + from_y * src.strides[plane];
+      uint8_t* out = dst.planes[plane] + y * dst.strides[plane];
+      for (int x = 0; x < width; x++) {
+        const int from_x = (flip & kFlipX) ? width - 1 - x : x;
+        memcpy(out + x * unit, in + from_x * unit, unit);
+      }
+    }
+  }
+}
+
+TEST_P(VideoConvertTest, FlipsMatchFlippedSources) {
+  const int width = 68;
+  const int height = 10;
+  const PixelFormat sources[] = {PixelFormat::kRGBA, PixelFormat::kBGRA, PixelFormat::kI420,
+                                 PixelFormat::kNV12};
+  const PixelFormat targets[] = {PixelFormat::kRGBA, PixelFormat::kBGRA, PixelFormat::kI420,
+                                 PixelFormat::kNV21};
+  for (PixelFormat from : sources) {
+    TestFrame src(from, width, height, kPadding, 3);
+    for (int flip = kFlipX; flip <= kFlipXY; flip++) {
+      TestFrame flipped(from, width, height, kPadding, 4);
+      FlipInto(src.frame(), flipped.frame(), static_cast<FlipMode>(flip));
+      for (PixelFormat to : targets) {
+        SCOPED_TRACE(std::string(FormatName(from)) + "->" + FormatName(to) + " flip " +
+                     std::to_string(flip));
+        TestFrame actual(to, width, height, kPadding, 5);
+        TestFrame expected(to, width, height, kPadding, 5);
+        ASSERT_TRUE(Convert(src.frame(), actual.frame(), static_cast<FlipMode>(flip)));
+        ASSERT_TRUE(Convert(flipped.frame(), expected.frame()));
+        EXPECT_TRUE(actual.bytes() == expected.bytes());
+      }
+    }
+  }
+}
+
+// Runs |operation| at every level into identically seeded outputs and checks
+// they all match the scalar result.
+void ExpectSameAtEveryLevel(PixelFormat out_format, int out_width, int out_height,
+                            const std::function<bool(const Frame&)>& operation) {
+  std::vector<uint8_t> expected;
+  for (SimdLevel level : SupportedLevels()) {
+    SCOPED_TRACE(SimdLevelName(level));
+    SetSimdLevel(level);
+    TestFrame out(out_format, out_width, out_height, 13, 7);
+    ASSERT_TRUE(operation(out.frame()));
+    if (level == SimdLevel::kScalar) {
+      expected = out.bytes();
+    } else {
+      EXPECT_TRUE(out.bytes() == expected) << "differs from scalar";
+    }
+  }
+  SetSimdLevel(DetectSimdLevel());
+}
+
+TEST(VideoConvertScalarTest, EveryLevelMatchesScalar) {
+  const PixelFormat formats[] = {PixelFormat::kI420, PixelFormat::kNV12, PixelFormat::kNV21,
+                                 PixelFormat::kRGBA, PixelFormat::kBGRA, PixelFormat::kARGB};
+  const int sizes[][2] = {{97, 61}, {128, 36}, {1, 1}};
+  for (const auto& size : sizes) {
+    const int width = size[0];
+    const int height = size[1];
+    for (PixelFormat from : formats) {
+      TestFrame src(from, width, height, 5, 1);
+      for (PixelFormat to : formats) {
+        for (int flip = 0; flip < 4; flip++) {
+          SCOPED_TRACE(std::string(FormatName(from)) + "->" + FormatName(to) + " flip " +
+                       std::to_string(flip) + " " + std::to_string(width) + "x" +
+                       std::to_string(height));
+          TestFrame probe(to, width, height, 0, 0);
+          if (!Convert(src.frame(), probe.frame())) {
+            continue;  // unsupported pair, e.g. YUV to ARGB
+          }
+          ExpectSameAtEveryLevel(to, width, height, [&](const Frame& out) {
+            return Convert(src.frame(), out, static_cast<FlipMode>(flip));
+          });
+        }
+      }
+      const int targets[][2] = {{width / 2, height / 2},
+                                {width / 4, height / 4},
+                                {width * 2 / 3, height * 3 / 5},
+                                {width + 3, height + 2}};
+      for (const auto& target : targets) {
+        if (target[0] <= 0 || target[1] <= 0) {
+          continue;
+        }
+        SCOPED_TRACE(std::string("scale ") + FormatName(from) + " " + std::to_string(width) +
+                     "x" + std::to_string(height) + "->" + std::to_string(target[0]) + "x" +
+                     std::to_string(target[1]));
+        ExpectSameAtEveryLevel(from, target[0], target[1], [&](const Frame& out) {
+          return Scale(src.frame(), out);
+        });
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Levels, VideoConvertTest, ::testing::ValuesIn(SupportedLevels()),
+                         [](const ::testing::TestParamInfo<SimdLevel>& info) {
+                           std::string name = SimdLevelName(info.param);
+                           name.erase(std::remove(name.begin(), name.end(), '.'), name.end());
+                           return name;
+                         });
+
+}  // namespace
+}  // namespace video_convert
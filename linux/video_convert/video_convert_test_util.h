@@ -0,0 +1,91 @@
+#ifndef FLUTTER_VIDEO_CONVERT_TEST_UTIL_H_
+#define FLUTTER_VIDEO_CONVERT_TEST_UTIL_H_
+
+// Frames and SIMD level helpers shared by video_convert_test and
+// video_convert_benchmark.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "video_convert.h"
+
+namespace video_convert {
+namespace test_util {
+
+inline const char* FormatName(PixelFormat format) {
+  switch (format) {
+    case PixelFormat::kI420:
+      return "I420";
+    case PixelFormat::kNV12:
+      return "NV12";
+    case PixelFormat::kNV21:
+      return "NV21";
+    case PixelFormat::kRGBA:
+      return "RGBA";
+    case PixelFormat::kBGRA:
+      return "BGRA";
+    case PixelFormat::kARGB:
+      return "ARGB";
+    case PixelFormat::kABGR:
+      return "ABGR";
+  }
+  return "?";
+}
+
+// A frame with |padding| extra bytes at the end of every row, filled with
+// noise so stride handling and tails are exercised.
+class TestFrame {
+ public:
+  TestFrame(PixelFormat format, int width, int height, int padding, uint32_t seed) {
+    frame_ = {format, width, height, {nullptr, nullptr, nullptr}, {0, 0, 0}};
+    bool packed = format != PixelFormat::kI420 && format != PixelFormat::kNV12 &&
+                  format != PixelFormat::kNV21;
+    int planes = packed ? 1 : (format == PixelFormat::kI420 ? 3 : 2);
+    int chroma_width = (width + 1) / 2;
+    size_t offsets[3] = {0, 0, 0};
+    size_t total = 0;
+    for (int plane = 0; plane < planes; plane++) {
+      int row_bytes = packed ? width * 4 : width;
+      int rows = height;
+      if (plane > 0) {
+        row_bytes = chroma_width * (format == PixelFormat::kI420 ? 1 : 2);
+        rows = (height + 1) / 2;
+      }
+      offsets[plane] = total;
+      frame_.strides[plane] = row_bytes + padding;
+      total += static_cast<size_t>(frame_.strides[plane]) * rows;
+    }
+    buffer_.resize(total);
+    std::mt19937 random(seed);
+    for (uint8_t& byte : buffer_) {
+      byte = static_cast<uint8_t>(random());
+    }
+    for (int plane = 0; plane < planes; plane++) {
+      frame_.planes[plane] = buffer_.data() + offsets[plane];
+    }
+  }
+
+  const Frame& frame() const { return frame_; }
+  const std::vector<uint8_t>& bytes() const { return buffer_; }
+
+ private:
+  Frame frame_;
+  std::vector<uint8_t> buffer_;
+};
+
+inline std::vector<SimdLevel> SupportedLevels() {
+  std::vector<SimdLevel> levels = {SimdLevel::kScalar};
+  for (SimdLevel level : {SimdLevel::kSSE41, SimdLevel::kAVX2, SimdLevel::kNEON}) {
+    if (video_convert::SetSimdLevel(level) == level) {
+      levels.push_back(level);
+    }
+  }
+  video_convert::SetSimdLevel(video_convert::DetectSimdLevel());
+  return levels;
+}
+
+}  // namespace test_util
+}  // namespace video_convert
+
+#endif  // FLUTTER_VIDEO_CONVERT_TEST_UTIL_H_
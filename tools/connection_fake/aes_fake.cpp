@@ -0,0 +1,128 @@
+// aes_key_setup and aes_encrypt of utility/aes.h, the block cipher the mmap segment logger runs
+// in CTR mode, see zego_connection_fake.h.
+//
+// A plain FIPS-197 implementation: the output is that of any AES, so files written against the
+// fake decode with the library and the other way round. Only the key schedule layout is private
+// to this file. The rest of aes.h is not implemented.
+
+#include <cstdint>
+
+#include "utility/aes.h"
+
+namespace ZEGO {
+namespace BASE {
+
+namespace {
+
+uint8_t Multiply(uint8_t a, uint8_t b) {
+    uint8_t product = 0;
+    while (b) {
+        if (b & 1) {
+            product ^= a;
+        }
+        a = static_cast<uint8_t>((a << 1) ^ ((a & 0x80) ? 0x1B : 0));
+        b >>= 1;
+    }
+    return product;
+}
+
+// The S-box from its definition: the inverse in GF(2^8) followed by the affine transform
+struct SBox {
+    uint8_t table[256];
+
+    SBox() {
+        for (int i = 0; i < 256; i++) {
+            uint8_t inverse = 0;
+            for (int j = 1; j < 256 && i != 0; j++) {
+                if (Multiply(static_cast<uint8_t>(i), static_cast<uint8_t>(j)) == 1) {
+                    inverse = static_cast<uint8_t>(j);
+                    break;
+                }
+            }
+            uint8_t s = inverse;
+            for (int shift = 1; shift <= 4; shift++) {
+                s ^= static_cast<uint8_t>((inverse << shift) | (inverse >> (8 - shift)));
+            }
+            table[i] = s ^ 0x63;
+        }
+    }
+};
+
+const uint8_t *Sub() {
+    static const SBox sbox;
+    return sbox.table;
+}
+
+int Rounds(int keysize) { return keysize == 256 ? 14 : (keysize == 192 ? 12 : 10); }
+
+AES_WORD SubWord(AES_WORD word) {
+    const uint8_t *sub = Sub();
+    return (static_cast<AES_WORD>(sub[(word >> 24) & 0xFF]) << 24) |
+           (static_cast<AES_WORD>(sub[(word >> 16) & 0xFF]) << 16) |
+           (static_cast<AES_WORD>(sub[(word >> 8) & 0xFF]) << 8) | sub[word & 0xFF];
+}
+
+} // namespace
+
+void aes_key_setup(const BYTE key[], AES_WORD w[], int keysize) {
+    const int nk = keysize / 32;
+    const int words = 4 * (Rounds(keysize) + 1);
+    for (int i = 0; i < nk; i++) {
+        w[i] = (static_cast<AES_WORD>(key[4 * i]) << 24) |
+               (static_cast<AES_WORD>(key[4 * i + 1]) << 16) |
+               (static_cast<AES_WORD>(key[4 * i + 2]) << 8) | key[4 * i + 3];
+    }
+    uint8_t rcon = 1;
+    for (int i = nk; i < words; i++) {
+        AES_WORD temp = w[i - 1];
+        if (i % nk == 0) {
+            temp = SubWord((temp << 8) | (temp >> 24)) ^ (static_cast<AES_WORD>(rcon) << 24);
+            rcon = Multiply(rcon, 2);
+        } else if (nk > 6 && i % nk == 4) {
+            temp = SubWord(temp);
+        }
+        w[i] = w[i - nk] ^ temp;
+    }
+}
+
+void aes_encrypt(const BYTE in[], BYTE out[], const AES_WORD key[], int keysize) {
+    const uint8_t *sub = Sub();
+    const int rounds = Rounds(keysize);
+    // state[c * 4 + r], column-major as in FIPS-197
+    uint8_t state[16];
+    for (int i = 0; i < 16; i++) {
+        state[i] = in[i] ^ static_cast<uint8_t>(key[i / 4] >> (24 - 8 * (i % 4)));
+    }
+    for (int round = 1; round <= rounds; round++) {
+        uint8_t shifted[16];
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) {
+                shifted[c * 4 + r] = sub[state[((c + r) % 4) * 4 + r]];
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            uint8_t *column = &shifted[c * 4];
+            uint8_t mixed[4];
+            if (round != rounds) {
+                for (int r = 0; r < 4; r++) {
+                    mixed[r] = Multiply(column[r], 2) ^ Multiply(column[(r + 1) % 4], 3) ^
+                               column[(r + 2) % 4] ^ column[(r + 3) % 4];
+                }
+            } else {
+                for (int r = 0; r < 4; r++) {
+                    mixed[r] = column[r];
+                }
+            }
+            const AES_WORD roundKey = key[round * 4 + c];
+            for (int r = 0; r < 4; r++) {
+                state[c * 4 + r] = mixed[r] ^ static_cast<uint8_t>(roundKey >> (24 - 8 * r));
+            }
+        }
+    }
+    for (int i = 0; i < 16; i++) {
+        out[i] = state[i];
+    }
+}
+
+} // namespace BASE
+} // namespace ZEGO
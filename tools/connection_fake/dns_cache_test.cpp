@@ -0,0 +1,657 @@
+// ZegoDNSCache (zego_connection_dns_cache.hpp) against a scripted resolver and the in-memory
+// leveldb of leveldb_fake.cpp.
+//
+// Every test uses its own ZegoDNSCache::Create() instance and its own store path. The
+// ZegoHappyEyeballs::Connect tests race real non-blocking connects against loopback listeners.
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_dns_cache.hpp"
+#include "zego_connection_fake.h"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+DNSData Answer(const std::string &domain, const std::vector<std::string> &ips) {
+    DNSData data;
+    data.domain = domain;
+    for (const auto &ip : ips) {
+        DNSIP item;
+        item.ip = IP2Type(ip, ip.find(':') != std::string::npos ? AF_INET6 : AF_INET);
+        item.category = DNSCategory::Available;
+        data.ipList.push_back(item);
+    }
+    return data;
+}
+
+std::vector<std::string> IPs(const DNSData &data) {
+    std::vector<std::string> ips;
+    for (const auto &item : data.ipList) {
+        ips.push_back(item.ip.first);
+    }
+    return ips;
+}
+
+// Answers with the addresses currently set and counts calls; can be held to keep a resolve in
+// flight
+class ScriptedResolver {
+  public:
+    void Set(const std::vector<std::string> &ips) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ips_ = ips;
+    }
+
+    void Hold() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+    }
+
+    void Release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_ = false;
+        }
+        cv_.notify_all();
+    }
+
+    int Calls() const { return calls_.load(); }
+
+    ZegoDNSCache::Resolver Get() {
+        return [this](const std::string &domain, int32) {
+            calls_++;
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !held_; });
+            return Answer(domain, ips_);
+        };
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::string> ips_;
+    bool held_ = false;
+    std::atomic<int> calls_{0};
+};
+
+// Keeps posted refreshes until the test runs them
+class ManualExecutor {
+  public:
+    ZegoDNSCache::Executor Get() {
+        return [this](std::function<void()> &&job) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+            return true;
+        };
+    }
+
+    size_t Pending() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return jobs_.size();
+    }
+
+    void RunAll() {
+        std::deque<std::function<void()>> jobs;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs.swap(jobs_);
+        }
+        for (auto &job : jobs) {
+            job();
+        }
+    }
+
+  private:
+    std::mutex mutex_;
+    std::deque<std::function<void()>> jobs_;
+};
+
+class DNSCacheTest : public ::testing::Test {
+  protected:
+    void SetUp() override { FAKE::DestroyAllLevelDB(); }
+
+    // Refreshes posted to the thread pool call into resolver_, so they must be done before it goes
+    void TearDown() override {
+        FAKE::SetThreadPoolRejectsJobs(false);
+        ZegoConnectionThreadPool::GetInstance()->SyncRunTaskInDefaultTask([]() {});
+    }
+
+    // Results are stale 1 ms after they were resolved
+    static DNSCacheConfig StaleConfig(const std::string &path = std::string()) {
+        DNSCacheConfig config;
+        config.path = path;
+        config.freshTTLMs = 0;
+        config.staleTTLMs = 60 * 1000;
+        config.resolveTimeoutMs = 200;
+        return config;
+    }
+
+    static void WaitUntilStale() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); }
+
+    ScriptedResolver resolver_;
+    ManualExecutor executor_;
+};
+
+TEST_F(DNSCacheTest, FreshHitDoesNotResolveAgain) {
+    auto cache = ZegoDNSCache::Create();
+    DNSCacheConfig config;
+    ASSERT_EQ(cache->Init(config, resolver_.Get(), executor_.Get()), kZCSuccess);
+    resolver_.Set({"10.0.0.1"});
+
+    DNSData first = cache->Resolve("a.example");
+    DNSData second = cache->Resolve("a.example");
+
+    EXPECT_EQ(IPs(first), std::vector<std::string>({"10.0.0.1"}));
+    EXPECT_EQ(IPs(second), IPs(first));
+    ASSERT_TRUE(second.localEvent);
+    EXPECT_TRUE(second.localEvent->isMemoryCache);
+    EXPECT_EQ(resolver_.Calls(), 1);
+    EXPECT_EQ(cache->GetStats().misses, 1u);
+    EXPECT_EQ(cache->GetStats().freshHits, 1u);
+}
+
+TEST_F(DNSCacheTest, StaleHitReturnsOldAnswerAndRefreshesOnce) {
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(StaleConfig(), resolver_.Get(), executor_.Get());
+    resolver_.Set({"10.0.0.1"});
+    cache->Resolve("a.example");
+    WaitUntilStale();
+    resolver_.Set({"10.0.0.2"});
+
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.1"}));
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.1"}));
+    EXPECT_EQ(executor_.Pending(), 1u);
+    EXPECT_EQ(cache->GetStats().refreshes, 1u);
+
+    executor_.RunAll();
+    EXPECT_EQ(resolver_.Calls(), 2);
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.2"}));
+}
+
+TEST_F(DNSCacheTest, FailedRefreshKeepsOldAnswer) {
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(StaleConfig(), resolver_.Get(), executor_.Get());
+    resolver_.Set({"10.0.0.1"});
+    cache->Resolve("a.example");
+    WaitUntilStale();
+    resolver_.Set({});
+
+    cache->Resolve("a.example");
+    executor_.RunAll();
+
+    EXPECT_EQ(cache->GetStats().refreshFailures, 1u);
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.1"}));
+}
+
+// Executors such as the thread pool in Default mode may run the job before returning
+TEST_F(DNSCacheTest, ExecutorMayRunTheRefreshInline) {
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(StaleConfig(), resolver_.Get(), [](std::function<void()> &&job) {
+        job();
+        return true;
+    });
+    resolver_.Set({"10.0.0.1"});
+    cache->Resolve("a.example");
+    WaitUntilStale();
+    resolver_.Set({"10.0.0.2"});
+
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.1"}));
+    EXPECT_EQ(resolver_.Calls(), 2);
+    EXPECT_EQ(cache->GetStats().refreshes, 1u);
+}
+
+// A refresh that could not be posted must not leave the domain marked as refreshing forever
+TEST_F(DNSCacheTest, RejectedRefreshIsCompletedAsAFailure) {
+    auto cache = ZegoDNSCache::Create();
+    bool accept = false;
+    cache->Init(StaleConfig(), resolver_.Get(), [&accept, this](std::function<void()> &&job) {
+        return accept && executor_.Get()(std::move(job));
+    });
+    resolver_.Set({"10.0.0.1"});
+    cache->Resolve("a.example");
+    WaitUntilStale();
+
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.1"}));
+    EXPECT_EQ(cache->GetStats().refreshFailures, 1u);
+
+    accept = true;
+    resolver_.Set({"10.0.0.2"});
+    cache->Resolve("a.example");
+    EXPECT_EQ(executor_.Pending(), 1u);
+    executor_.RunAll();
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.2"}));
+}
+
+TEST_F(DNSCacheTest, DefaultExecutorHandlesARejectingThreadPool) {
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(StaleConfig(), resolver_.Get());
+    resolver_.Set({"10.0.0.1"});
+    cache->Resolve("a.example");
+    WaitUntilStale();
+
+    FAKE::SetThreadPoolRejectsJobs(true);
+    cache->Resolve("a.example");
+    EXPECT_EQ(cache->GetStats().refreshFailures, 1u);
+
+    FAKE::SetThreadPoolRejectsJobs(false);
+    resolver_.Set({"10.0.0.2"});
+    cache->Resolve("a.example");
+    Clock::time_point deadline = Clock::now() + std::chrono::seconds(2);
+    while (IPs(cache->Resolve("a.example"))[0] != "10.0.0.2" && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.2"}));
+}
+
+// The refresh may outlive the cache; it must neither touch it nor crash
+TEST_F(DNSCacheTest, RefreshAfterTheCacheIsGoneIsDropped) {
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(StaleConfig(), resolver_.Get(), executor_.Get());
+    resolver_.Set({"10.0.0.1"});
+    cache->Resolve("a.example");
+    WaitUntilStale();
+    cache->Resolve("a.example");
+    cache.reset();
+
+    executor_.RunAll();
+    EXPECT_EQ(resolver_.Calls(), 2);
+}
+
+TEST_F(DNSCacheTest, ConcurrentColdLookupsShareOneResolve) {
+    auto cache = ZegoDNSCache::Create();
+    DNSCacheConfig config;
+    config.resolveTimeoutMs = 5000;
+    cache->Init(config, resolver_.Get(), executor_.Get());
+    resolver_.Set({"10.0.0.1"});
+    resolver_.Hold();
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::string>> answers(8);
+    for (size_t i = 0; i < answers.size(); i++) {
+        threads.emplace_back([&cache, &answers, i]() { answers[i] = IPs(cache->Resolve("a.example")); });
+    }
+    Clock::time_point deadline = Clock::now() + std::chrono::seconds(2);
+    while (cache->GetStats().coalesced < answers.size() - 1 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    resolver_.Release();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(resolver_.Calls(), 1);
+    for (const auto &answer : answers) {
+        EXPECT_EQ(answer, std::vector<std::string>({"10.0.0.1"}));
+    }
+}
+
+// A caller joining a resolve that hangs gives up after resolveTimeoutMs
+TEST_F(DNSCacheTest, WaitingForAnotherResolveIsBoundedByTheTimeout) {
+    auto cache = ZegoDNSCache::Create();
+    DNSCacheConfig config;
+    config.resolveTimeoutMs = 100;
+    cache->Init(config, resolver_.Get(), executor_.Get());
+    resolver_.Set({"10.0.0.1"});
+    resolver_.Hold();
+
+    std::thread first([&cache]() { cache->Resolve("a.example"); });
+    while (resolver_.Calls() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    Clock::time_point start = Clock::now();
+    DNSData joined = cache->Resolve("a.example");
+    int64_t waitedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    EXPECT_TRUE(joined.ipList.empty());
+    EXPECT_EQ(joined.domain, "a.example");
+    EXPECT_GE(waitedMs, 90);
+    EXPECT_LT(waitedMs, 1000);
+
+    resolver_.Release();
+    first.join();
+    EXPECT_EQ(IPs(cache->Resolve("a.example")), std::vector<std::string>({"10.0.0.1"}));
+}
+
+TEST_F(DNSCacheTest, ResolveBeforeInitUsesTheDefaultResolver) {
+    auto cache = ZegoDNSCache::Create();
+    unsigned before = FAKE::DNSResolveCount();
+
+    DNSData data = cache->Resolve("a.example");
+
+    EXPECT_EQ(FAKE::DNSResolveCount(), before + 1);
+    EXPECT_EQ(data.domain, "a.example");
+    EXPECT_TRUE(data.ipList.empty());
+}
+
+TEST_F(DNSCacheTest, RestartStartsWarmFromDisk) {
+    {
+        auto cache = ZegoDNSCache::Create();
+        ASSERT_EQ(cache->Init(DNSCacheConfig{"/dns"}, resolver_.Get(), executor_.Get()), kZCSuccess);
+        resolver_.Set({"10.0.0.1", "2001:db8::1"});
+        cache->Resolve("a.example");
+        cache->Feedback("a.example", "2001:db8::1", DNSUpdateType::Reached);
+    }
+
+    auto cache = ZegoDNSCache::Create();
+    ASSERT_EQ(cache->Init(DNSCacheConfig{"/dns"}, resolver_.Get(), executor_.Get()), kZCSuccess);
+    EXPECT_EQ(cache->GetStats().diskLoaded, 1u);
+    DNSData data = cache->Resolve("a.example");
+
+    EXPECT_EQ(resolver_.Calls(), 1);
+    EXPECT_EQ(IPs(data), std::vector<std::string>({"2001:db8::1", "10.0.0.1"}));
+    EXPECT_EQ(data.ipList[0].ip.second, AF_INET6);
+    EXPECT_EQ(data.ipList[0].category, DNSCategory::Reached);
+}
+
+TEST_F(DNSCacheTest, ExpiredEntriesAreNotLoaded) {
+    DNSCacheConfig config = StaleConfig("/dns");
+    config.staleTTLMs = 1;
+    {
+        auto cache = ZegoDNSCache::Create();
+        cache->Init(config, resolver_.Get(), executor_.Get());
+        resolver_.Set({"10.0.0.1"});
+        cache->Resolve("a.example");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(config, resolver_.Get(), executor_.Get());
+    EXPECT_EQ(cache->GetStats().diskLoaded, 0u);
+}
+
+TEST_F(DNSCacheTest, CorruptStoreIsRebuilt) {
+    FAKE::CorruptLevelDB("/dns");
+    auto cache = ZegoDNSCache::Create();
+    EXPECT_EQ(cache->Init(DNSCacheConfig{"/dns"}, resolver_.Get(), executor_.Get()), kZCSuccess);
+    resolver_.Set({"10.0.0.1"});
+    cache->Resolve("a.example");
+    cache->UnInit();
+
+    auto reopened = ZegoDNSCache::Create();
+    reopened->Init(DNSCacheConfig{"/dns"}, resolver_.Get(), executor_.Get());
+    EXPECT_EQ(reopened->GetStats().diskLoaded, 1u);
+}
+
+TEST_F(DNSCacheTest, FeedbackOrdersReachedFirstAndUnreachedLast) {
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(DNSCacheConfig(), resolver_.Get(), executor_.Get());
+    resolver_.Set({"10.0.0.1", "10.0.0.2", "10.0.0.3"});
+    cache->Resolve("a.example");
+
+    cache->Feedback("a.example", "10.0.0.1", DNSUpdateType::Unreach);
+    cache->Feedback("a.example", "10.0.0.3", DNSUpdateType::Reached);
+
+    EXPECT_EQ(IPs(cache->Resolve("a.example")),
+              std::vector<std::string>({"10.0.0.3", "10.0.0.2", "10.0.0.1"}));
+}
+
+// A refresh keeps what Feedback learned about addresses that are still in the answer
+TEST_F(DNSCacheTest, RefreshKeepsReachabilityOfKnownAddresses) {
+    auto cache = ZegoDNSCache::Create();
+    cache->Init(StaleConfig(), resolver_.Get(), executor_.Get());
+    resolver_.Set({"10.0.0.1", "10.0.0.2"});
+    cache->Resolve("a.example");
+    cache->Feedback("a.example", "10.0.0.2", DNSUpdateType::Reached);
+    WaitUntilStale();
+
+    resolver_.Set({"10.0.0.1", "10.0.0.2", "10.0.0.3"});
+    cache->Resolve("a.example");
+    executor_.RunAll();
+
+    DNSData data = cache->Resolve("a.example");
+    EXPECT_EQ(IPs(data), std::vector<std::string>({"10.0.0.2", "10.0.0.1", "10.0.0.3"}));
+    EXPECT_EQ(data.ipList[0].category, DNSCategory::Reached);
+}
+
+TEST(HappyEyeballs, InterleavesFamiliesStartingWithThePreferredOne) {
+    std::vector<IP2Type> ips = {IP2Type("10.0.0.1", AF_INET), IP2Type("10.0.0.2", AF_INET),
+                                IP2Type("2001:db8::1", AF_INET6), IP2Type("10.0.0.3", AF_INET)};
+    std::vector<IP2Type> ordered = ZegoHappyEyeballs::Interleave(ips, true);
+    std::vector<std::string> addresses;
+    for (const auto &ip : ordered) {
+        addresses.push_back(ip.first);
+    }
+    EXPECT_EQ(addresses,
+              std::vector<std::string>({"2001:db8::1", "10.0.0.1", "10.0.0.2", "10.0.0.3"}));
+}
+
+// Open file descriptors of the process, to see that every losing attempt was closed
+int OpenFds() {
+    int count = 0;
+    DIR *dir = opendir("/proc/self/fd");
+    while (struct dirent *entry = dir ? readdir(dir) : nullptr) {
+        count += entry->d_name[0] != '.' ? 1 : 0;
+    }
+    if (dir) {
+        closedir(dir);
+    }
+    return count;
+}
+
+// A TCP listener on a loopback address. Stall() fills its accept queue with connections it never
+// accepts, so the kernel drops further SYNs and connects to it stay pending.
+class Listener {
+  public:
+    Listener(const std::string &ip, uint16 port) : ip_(ip) {
+        int family = ZegoHappyEyeballs::IsIPv6(ip) ? AF_INET6 : AF_INET;
+        fd_ = socket(family, SOCK_STREAM, 0);
+        if (fd_ < 0) {
+            return;
+        }
+        int on = 1;
+        setsockopt(fd_, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on));
+        sockaddr_storage addr;
+        socklen_t length = Address(port, addr);
+        if (bind(fd_, reinterpret_cast<sockaddr *>(&addr), length) != 0 || listen(fd_, 0) != 0 ||
+            getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &length) != 0) {
+            close(fd_);
+            fd_ = -1;
+            return;
+        }
+        port_ = ntohs(family == AF_INET6 ? reinterpret_cast<sockaddr_in6 *>(&addr)->sin6_port
+                                         : reinterpret_cast<sockaddr_in *>(&addr)->sin_port);
+    }
+
+    ~Listener() {
+        for (int fd : clients_) {
+            close(fd);
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool Listening() const { return fd_ >= 0; }
+
+    // Stops listening; connects still pending are refused when they send their SYN again
+    void Close() {
+        close(fd_);
+        fd_ = -1;
+    }
+
+    uint16 Port() const { return port_; }
+
+    bool Stall() {
+        for (int i = 0; i < 8; i++) {
+            sockaddr_storage addr;
+            socklen_t length = Address(port_, addr);
+            int fd = socket(addr.ss_family, SOCK_STREAM, 0);
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            clients_.push_back(fd);
+            connect(fd, reinterpret_cast<sockaddr *>(&addr), length);
+            pollfd pfd = {fd, POLLOUT, 0};
+            if (poll(&pfd, 1, 200) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    socklen_t Address(uint16 port, sockaddr_storage &addr) const {
+        memset(&addr, 0, sizeof(addr));
+        if (ZegoHappyEyeballs::IsIPv6(ip_)) {
+            sockaddr_in6 *sin6 = reinterpret_cast<sockaddr_in6 *>(&addr);
+            sin6->sin6_family = AF_INET6;
+            sin6->sin6_port = htons(port);
+            inet_pton(AF_INET6, ip_.c_str(), &sin6->sin6_addr);
+            return sizeof(sockaddr_in6);
+        }
+        sockaddr_in *sin = reinterpret_cast<sockaddr_in *>(&addr);
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons(port);
+        inet_pton(AF_INET, ip_.c_str(), &sin->sin_addr);
+        return sizeof(sockaddr_in);
+    }
+
+    std::string ip_;
+    int fd_ = -1;
+    uint16 port_ = 0;
+    std::vector<int> clients_;
+};
+
+IP2Type Address(const std::string &ip) {
+    return IP2Type(ip, ZegoHappyEyeballs::IsIPv6(ip) ? AF_INET6 : AF_INET);
+}
+
+TEST(HappyEyeballs, RefusedFamilyFallsThroughAtOnce) {
+    // Nothing listens on ::1 at the port; a refused or impossible IPv6 attempt must not hold up
+    // IPv4 for the whole attempt delay
+    Listener listener("127.0.0.1", 0);
+    ASSERT_TRUE(listener.Listening());
+    HappyEyeballsConfig config;
+    config.attemptDelayMs = 2000;
+    config.timeoutMs = 5000;
+    HappyEyeballsResult result = ZegoHappyEyeballs::Connect(
+        {Address("127.0.0.1"), Address("::1")}, listener.Port(), config);
+    EXPECT_EQ(result.error, kZCSuccess);
+    EXPECT_EQ(result.ip.first, "127.0.0.1");
+    EXPECT_EQ(result.attempts, 2u);
+    EXPECT_LT(result.costMs, 1000u);
+    EXPECT_EQ(result.socket, -1);
+}
+
+TEST(HappyEyeballs, RefusedIPv4FallsThroughToIPv6) {
+    Listener listener("::1", 0);
+    if (!listener.Listening()) {
+        GTEST_SKIP() << "no IPv6 loopback";
+    }
+    HappyEyeballsConfig config;
+    config.preferIPv6 = false;
+    config.attemptDelayMs = 2000;
+    config.timeoutMs = 5000;
+    HappyEyeballsResult result = ZegoHappyEyeballs::Connect(
+        {Address("::1"), Address("127.0.0.1")}, listener.Port(), config);
+    EXPECT_EQ(result.error, kZCSuccess);
+    EXPECT_EQ(result.ip.first, "::1");
+    EXPECT_EQ(result.attempts, 2u);
+    EXPECT_LT(result.costMs, 1000u);
+}
+
+TEST(HappyEyeballs, AttemptRefusedWhilePendingStartsTheNextAtOnce) {
+    // 127.0.0.2 starts at 0 and is refused when its SYN is sent again, after about a second;
+    // 127.0.0.3 starts at 900 ms and hangs. 127.0.0.1 has to start on the refusal, not at 1800 ms
+    Listener refusing("127.0.0.2", 0);
+    ASSERT_TRUE(refusing.Listening());
+    ASSERT_TRUE(refusing.Stall());
+    Listener stalled("127.0.0.3", refusing.Port());
+    ASSERT_TRUE(stalled.Listening());
+    ASSERT_TRUE(stalled.Stall());
+    Listener listener("127.0.0.1", refusing.Port());
+    ASSERT_TRUE(listener.Listening());
+    std::thread closer([&refusing]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        refusing.Close();
+    });
+
+    HappyEyeballsConfig config;
+    config.attemptDelayMs = 900;
+    config.timeoutMs = 5000;
+    HappyEyeballsResult result = ZegoHappyEyeballs::Connect(
+        {Address("127.0.0.2"), Address("127.0.0.3"), Address("127.0.0.1")}, listener.Port(),
+        config);
+    closer.join();
+    EXPECT_EQ(result.error, kZCSuccess);
+    EXPECT_EQ(result.ip.first, "127.0.0.1");
+    EXPECT_EQ(result.attempts, 3u);
+    EXPECT_GE(result.costMs, 900u);
+    EXPECT_LT(result.costMs, 1500u);
+}
+
+TEST(HappyEyeballs, FirstConnectWinsAndTheOthersAreClosed) {
+    // 127.0.0.2 goes first and hangs, 127.0.0.1 starts one attempt delay later and wins
+    Listener stalled("127.0.0.2", 0);
+    ASSERT_TRUE(stalled.Listening());
+    ASSERT_TRUE(stalled.Stall());
+    Listener listener("127.0.0.1", stalled.Port());
+    ASSERT_TRUE(listener.Listening());
+
+    const int fds = OpenFds();
+    HappyEyeballsConfig config;
+    config.attemptDelayMs = 100;
+    config.timeoutMs = 5000;
+    config.keepSocket = true;
+    HappyEyeballsResult result = ZegoHappyEyeballs::Connect(
+        {Address("127.0.0.2"), Address("127.0.0.1"), Address("127.0.0.3")}, listener.Port(),
+        config);
+    EXPECT_EQ(result.error, kZCSuccess);
+    EXPECT_EQ(result.ip.first, "127.0.0.1");
+    EXPECT_EQ(result.attempts, 2u);
+    EXPECT_GE(result.costMs, 100u);
+    ASSERT_GE(result.socket, 0);
+
+    // Only the winner is left open, and it is connected
+    EXPECT_EQ(OpenFds(), fds + 1);
+    sockaddr_storage peer;
+    socklen_t length = sizeof(peer);
+    EXPECT_EQ(getpeername(static_cast<int>(result.socket), reinterpret_cast<sockaddr *>(&peer),
+                          &length),
+              0);
+    close(static_cast<int>(result.socket));
+}
+
+TEST(HappyEyeballs, GivesUpAtTheOverallTimeout) {
+    Listener stalled("127.0.0.2", 0);
+    ASSERT_TRUE(stalled.Listening());
+    ASSERT_TRUE(stalled.Stall());
+
+    const int fds = OpenFds();
+    HappyEyeballsConfig config;
+    config.attemptDelayMs = 50;
+    config.timeoutMs = 300;
+    config.keepSocket = true;
+    Clock::time_point start = Clock::now();
+    HappyEyeballsResult result =
+        ZegoHappyEyeballs::Connect({Address("127.0.0.2")}, stalled.Port(), config);
+    int64_t elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    EXPECT_EQ(result.error, kZCETCPDetectTimeout);
+    EXPECT_EQ(result.attempts, 1u);
+    EXPECT_EQ(result.socket, -1);
+    EXPECT_GE(elapsedMs, 300);
+    EXPECT_LT(elapsedMs, 1500);
+    EXPECT_EQ(OpenFds(), fds);
+}
+
+} // namespace
@@ -0,0 +1,297 @@
+// ZegoEdgeProbeScheduler (zego_connection_edge_probe.hpp) against the simulated edges of
+// zego_connection_net_detect_fake.cpp and the net type of the fake ZegoConnectionMonitor.
+//
+// Edges answer after a few tens of milliseconds, so timings below are loose multiples of their
+// RTTs.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_edge_probe.hpp"
+#include "zego_connection_fake.h"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+EdgeCandidate Edge(const std::string &ip, EdgeProbeProtocol protocol = EdgeProbeProtocol::TCP) {
+    EdgeCandidate edge;
+    edge.protocol = protocol;
+    edge.ip = ip;
+    edge.port = 443;
+    if (protocol == EdgeProbeProtocol::HTTP) {
+        edge.url = "https://" + ip + "/detect";
+    }
+    return edge;
+}
+
+// Edges 10.0.0.<i> with the given RTTs
+std::vector<EdgeCandidate> Edges(const std::vector<uint32> &rtts,
+                                 EdgeProbeProtocol protocol = EdgeProbeProtocol::TCP) {
+    std::vector<EdgeCandidate> edges;
+    for (size_t i = 0; i < rtts.size(); i++) {
+        edges.push_back(Edge("10.0.0." + std::to_string(i + 1), protocol));
+        FAKE::SetEdge(edges.back().ip, edges.back().port, rtts[i]);
+    }
+    return edges;
+}
+
+// Receives one ranking
+class Result {
+  public:
+    OnEdgeRankingDelegate Delegate() {
+        return [this](const EdgeRanking &ranking) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ranking_ = ranking;
+            calls_++;
+            cv_.notify_all();
+        };
+    }
+
+    bool Wait(int timeoutMs = 5000) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return calls_ > 0; });
+    }
+
+    EdgeRanking Ranking() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ranking_;
+    }
+
+    int Calls() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return calls_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    EdgeRanking ranking_;
+    int calls_ = 0;
+};
+
+class EdgeProbeTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FAKE::ClearEdges();
+        FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+        config_.timeoutMs = 300;
+        scheduler_->SetConfig(config_);
+    }
+
+    void TearDown() override {
+        // Stopped or finished, no detect may outlive the test
+        for (int i = 0; i < 1000 && FAKE::DetectsInFlight() != 0; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(FAKE::DetectsInFlight(), 0u);
+    }
+
+    EdgeRanking Probe(const std::vector<EdgeCandidate> &edges, bool useCache = true) {
+        Result result;
+        scheduler_->Probe(edges, result.Delegate(), useCache);
+        EXPECT_TRUE(result.Wait());
+        return result.Ranking();
+    }
+
+    static std::vector<std::string> IPs(const EdgeRanking &ranking) {
+        std::vector<std::string> ips;
+        for (const auto &result : ranking.edges) {
+            ips.push_back(result.edge.ip);
+        }
+        return ips;
+    }
+
+    EdgeProbeConfig config_;
+    std::shared_ptr<ZegoEdgeProbeScheduler> scheduler_ = ZegoEdgeProbeScheduler::Create();
+};
+
+TEST_F(EdgeProbeTest, EnoughGoodEdgesStopTheRest) {
+    std::vector<EdgeCandidate> edges = Edges({80, 60, 40, 10, 20, 70, 50, 30});
+    EdgeRanking ranking = Probe(edges);
+
+    ASSERT_EQ(ranking.edges.size(), 8u);
+    EXPECT_EQ(ranking.edges[0].edge.ip, "10.0.0.4");
+    EXPECT_EQ(ranking.edges[1].edge.ip, "10.0.0.5");
+    EXPECT_FALSE(ranking.edges[0].cancelled);
+    EXPECT_EQ(ranking.edges[0].received, 3u);
+    EXPECT_DOUBLE_EQ(ranking.edges[0].rttMs, 10);
+    for (size_t i = 2; i < ranking.edges.size(); i++) {
+        EXPECT_TRUE(ranking.edges[i].cancelled) << ranking.edges[i].edge.ip;
+    }
+    // Three rounds of the 20 ms edge, long before the 80 ms edge would have finished its first
+    EXPECT_LT(ranking.elapsedMs, 80u * 3);
+    EXPECT_GT(FAKE::DetectsStopped(), 0u);
+    EXPECT_FALSE(ranking.fromCache);
+}
+
+TEST_F(EdgeProbeTest, ZeroEnoughGoodProbesEveryEdge) {
+    config_.enoughGood = 0;
+    scheduler_->SetConfig(config_);
+    EdgeRanking ranking = Probe(Edges({40, 10, 30, 20}));
+    EXPECT_EQ(IPs(ranking), std::vector<std::string>({"10.0.0.2", "10.0.0.4", "10.0.0.3", "10.0.0.1"}));
+    for (const auto &result : ranking.edges) {
+        EXPECT_FALSE(result.cancelled);
+        EXPECT_EQ(result.received, 3u);
+    }
+    EXPECT_EQ(FAKE::DetectsStarted(), 12u);
+    EXPECT_EQ(FAKE::DetectsStopped(), 0u);
+}
+
+TEST_F(EdgeProbeTest, JitterAndLossOutweighRawRtt) {
+    config_.enoughGood = 0;
+    config_.rounds = 4;
+    scheduler_->SetConfig(config_);
+    std::vector<EdgeCandidate> edges = {Edge("10.0.1.1"), Edge("10.0.1.2")};
+    FAKE::SetEdge("10.0.1.1", 443, 20, 60);
+    FAKE::SetEdge("10.0.1.2", 443, 60);
+    EdgeRanking ranking = Probe(edges);
+    EXPECT_EQ(IPs(ranking), std::vector<std::string>({"10.0.1.2", "10.0.1.1"}));
+    EXPECT_DOUBLE_EQ(ranking.edges[1].jitterMs, 60);
+
+    std::vector<EdgeCandidate> udp = {Edge("10.0.2.1", EdgeProbeProtocol::UDP),
+                                      Edge("10.0.2.2", EdgeProbeProtocol::UDP)};
+    FAKE::SetEdge("10.0.2.1", 443, 20, 0, 0.4);
+    FAKE::SetEdge("10.0.2.2", 443, 60);
+    ranking = Probe(udp, false);
+    EXPECT_EQ(IPs(ranking), std::vector<std::string>({"10.0.2.2", "10.0.2.1"}));
+    EXPECT_EQ(ranking.edges[1].sent, config_.udpPackets);
+    EXPECT_DOUBLE_EQ(ranking.edges[1].loss, 0.4);
+}
+
+TEST_F(EdgeProbeTest, UnreachableEdgeGivesUpItsSlotAndRanksLast) {
+    config_.enoughGood = 0;
+    config_.maxConcurrent = 1;
+    scheduler_->SetConfig(config_);
+    std::vector<EdgeCandidate> edges = {Edge("10.0.3.1"), Edge("10.0.3.2", EdgeProbeProtocol::HTTP)};
+    FAKE::SetEdge("10.0.3.2", 443, 10);
+    EdgeRanking ranking = Probe(edges);
+    EXPECT_EQ(IPs(ranking), std::vector<std::string>({"10.0.3.2", "10.0.3.1"}));
+    EXPECT_FALSE(ranking.edges[1].Reachable());
+    EXPECT_EQ(ranking.edges[1].error, kZCETCPDetectConnectFailed);
+    EXPECT_EQ(ranking.edges[1].sent, 1u);
+    EXPECT_EQ(FAKE::DetectsStarted(), 1u + config_.rounds);
+}
+
+TEST_F(EdgeProbeTest, ConcurrencyIsCapped) {
+    config_.enoughGood = 0;
+    config_.maxConcurrent = 2;
+    config_.rounds = 1;
+    scheduler_->SetConfig(config_);
+    Result result;
+    scheduler_->Probe(Edges({15, 15, 15, 15, 15, 15}), result.Delegate());
+    size_t most = 0;
+    while (result.Calls() == 0) {
+        most = std::max(most, FAKE::DetectsInFlight());
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    EXPECT_LE(most, 2u);
+    EXPECT_GE(result.Ranking().elapsedMs, 15u * 3);
+}
+
+TEST_F(EdgeProbeTest, RankingIsCachedPerNetType) {
+    std::vector<EdgeCandidate> edges = Edges({30, 10, 20});
+    EdgeRanking wifi = Probe(edges);
+    unsigned started = FAKE::DetectsStarted();
+
+    // Served synchronously on the calling thread
+    Result cached;
+    EXPECT_EQ(scheduler_->Probe(edges, cached.Delegate()), 0u);
+    ASSERT_EQ(cached.Calls(), 1);
+    EXPECT_TRUE(cached.Ranking().fromCache);
+    EXPECT_EQ(IPs(cached.Ranking()), IPs(wifi));
+    EXPECT_EQ(FAKE::DetectsStarted(), started);
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_4G);
+    EdgeRanking cellular = Probe(edges);
+    EXPECT_FALSE(cellular.fromCache);
+    EXPECT_EQ(cellular.netType, ZegoConnectionNetType::ZEGO_NT_4G);
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+    started = FAKE::DetectsStarted();
+    EXPECT_TRUE(Probe(edges).fromCache);
+    EXPECT_EQ(FAKE::DetectsStarted(), started);
+    EXPECT_FALSE(Probe(edges, false).fromCache);
+}
+
+TEST_F(EdgeProbeTest, ExpiredRankingProbesTheFormerBestFirst) {
+    config_.cacheTtlMs = 0;
+    config_.maxConcurrent = 1;
+    config_.enoughGood = 0;
+    config_.rounds = 1;
+    scheduler_->SetConfig(config_);
+    std::vector<EdgeCandidate> edges = Edges({50, 40, 5});
+    EXPECT_EQ(Probe(edges).edges[0].edge.ip, "10.0.0.3");
+    unsigned started = FAKE::DetectsStarted();
+    EXPECT_EQ(started, 3u);
+
+    // One edge at a time and the first good one ends the probe, so only the order decides
+    config_.enoughGood = 1;
+    scheduler_->SetConfig(config_);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EdgeRanking ranking = Probe(edges);
+    EXPECT_FALSE(ranking.fromCache);
+    EXPECT_EQ(ranking.edges[0].edge.ip, "10.0.0.3");
+    EXPECT_EQ(FAKE::DetectsStarted() - started, 1u);
+}
+
+TEST_F(EdgeProbeTest, DuplicateCandidatesAreProbedOnce) {
+    config_.enoughGood = 0;
+    scheduler_->SetConfig(config_);
+    std::vector<EdgeCandidate> edges = Edges({20, 10});
+    std::vector<EdgeCandidate> repeated = {edges[0], edges[1], edges[0], edges[1], edges[0]};
+    EdgeRanking ranking = Probe(repeated);
+    EXPECT_EQ(IPs(ranking), std::vector<std::string>({"10.0.0.2", "10.0.0.1"}));
+    EXPECT_EQ(FAKE::DetectsStarted(), 2u * config_.rounds);
+
+    // The cache holds each edge once and still matches the repeated list
+    unsigned started = FAKE::DetectsStarted();
+    EXPECT_TRUE(Probe(repeated).fromCache);
+    EXPECT_EQ(FAKE::DetectsStarted(), started);
+
+    // Ordered by the cache, which lists each edge once, while the list repeats them
+    ranking = Probe(repeated, false);
+    EXPECT_EQ(IPs(ranking), std::vector<std::string>({"10.0.0.2", "10.0.0.1"}));
+    for (const auto &result : ranking.edges) {
+        EXPECT_EQ(result.received, config_.rounds);
+    }
+    EXPECT_EQ(FAKE::DetectsStarted() - started, 2u * config_.rounds);
+}
+
+TEST_F(EdgeProbeTest, FailedConnectDemotesTheEdge) {
+    config_.enoughGood = 0;
+    scheduler_->SetConfig(config_);
+    std::vector<EdgeCandidate> edges = Edges({10, 20, 30});
+    Probe(edges);
+    scheduler_->Feedback(edges[0], true);
+    EdgeRanking ranking;
+    ASSERT_TRUE(scheduler_->GetCachedRanking(ranking));
+    EXPECT_EQ(ranking.edges[0].edge.ip, "10.0.0.1");
+
+    scheduler_->Feedback(edges[0], false);
+    ASSERT_TRUE(scheduler_->GetCachedRanking(ranking));
+    EXPECT_EQ(IPs(ranking), std::vector<std::string>({"10.0.0.2", "10.0.0.3", "10.0.0.1"}));
+}
+
+TEST_F(EdgeProbeTest, CancelStopsDetectsAndSuppressesTheCallback) {
+    Result result;
+    ZCSeq seq = scheduler_->Probe(Edges({100, 120, 140}), result.Delegate());
+    ASSERT_NE(seq, 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    scheduler_->Cancel(seq);
+    EXPECT_EQ(FAKE::DetectsInFlight(), 0u);
+    EXPECT_EQ(FAKE::DetectsStopped(), 3u);
+    EXPECT_FALSE(result.Wait(300));
+    EdgeRanking ranking;
+    EXPECT_FALSE(scheduler_->GetCachedRanking(ranking));
+}
+
+} // namespace
@@ -0,0 +1,172 @@
+// ZegoConnectionHttpPool against a fresh curl easy handle per request, the way short requests
+// were sent before the pool, both against LocalHttpServer over plain HTTP.
+//
+//   BM_Get/<client>                 One GET at a time, from the call until the response is
+//                                   back. pool is ZegoConnectionHttpPool::Request; fresh_handle
+//                                   is curl_easy_init + curl_easy_perform + curl_easy_cleanup.
+//                                   connections/op counts the TCP connections the server
+//                                   accepted per request.
+//   BM_Burst/<client>/<n>           |n| distinct GETs issued together, until all responses are
+//                                   back; fresh_handle runs one thread per request.
+//                                   items_per_second is requests per second.
+//
+// Loopback has no TLS and next to no connect cost, so BM_Get understates what keep-alive saves
+// against a real server, and BM_Burst mostly shows the cost of maxConnectionsPerHost (6) against
+// one connection per request.
+//
+// Usage:
+//   http_pool_benchmark [benchmark flags]
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "local_http_server.h"
+#include "zego_connection_http_pool.hpp"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+LocalHttpServer &Server() {
+    // curl_easy_init would otherwise initialise libcurl from several threads at once
+    static CURLcode global = curl_global_init(CURL_GLOBAL_DEFAULT);
+    static LocalHttpServer server;
+    (void)global;
+    return server;
+}
+
+size_t Discard(char *, size_t size, size_t count, void *) { return size * count; }
+
+bool FreshHandleGet(const std::string &url) {
+    CURL *easy = curl_easy_init();
+    curl_easy_setopt(easy, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &Discard);
+    CURLcode code = curl_easy_perform(easy);
+    curl_easy_cleanup(easy);
+    return code == CURLE_OK;
+}
+
+// Blocks until |count| pool responses have arrived
+class Countdown {
+  public:
+    explicit Countdown(int count) : count_(count) {}
+
+    void Done() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--count_ == 0) {
+            cv_.notify_all();
+        }
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return count_ == 0; });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int count_;
+};
+
+void PoolGetAll(const std::vector<std::string> &urls) {
+    Countdown countdown(static_cast<int>(urls.size()));
+    for (const auto &url : urls) {
+        HttpPoolRequest request;
+        request.url = url;
+        ZegoConnectionHttpPool::GetInstance()->Request(
+            request, [&countdown](std::shared_ptr<HttpContext>) { countdown.Done(); });
+    }
+    countdown.Wait();
+}
+
+void StartPool() {
+    HttpPoolConfig config;
+    config.requestsPerSecond = 0;
+    config.coalesceGet = false;
+    ZegoConnectionHttpPool::GetInstance()->Init(config);
+}
+
+void BM_GetPool(benchmark::State &state) {
+    StartPool();
+    std::vector<std::string> url = {Server().Url("/get")};
+    PoolGetAll(url);
+    int connections = Server().Connections();
+    for (auto _ : state) {
+        PoolGetAll(url);
+    }
+    state.counters["connections/op"] =
+        benchmark::Counter(Server().Connections() - connections, benchmark::Counter::kAvgIterations);
+    ZegoConnectionHttpPool::GetInstance()->UnInit();
+}
+
+void BM_GetFreshHandle(benchmark::State &state) {
+    std::string url = Server().Url("/get");
+    int connections = Server().Connections();
+    for (auto _ : state) {
+        if (!FreshHandleGet(url)) {
+            state.SkipWithError("request failed");
+            break;
+        }
+    }
+    state.counters["connections/op"] =
+        benchmark::Counter(Server().Connections() - connections, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_GetPool)->Name("BM_Get/pool")->UseRealTime();
+BENCHMARK(BM_GetFreshHandle)->Name("BM_Get/fresh_handle")->UseRealTime();
+
+std::vector<std::string> BurstUrls(int count) {
+    std::vector<std::string> urls;
+    for (int i = 0; i < count; i++) {
+        urls.push_back(Server().Url("/burst/" + std::to_string(i)));
+    }
+    return urls;
+}
+
+void BM_BurstPool(benchmark::State &state) {
+    StartPool();
+    std::vector<std::string> urls = BurstUrls(static_cast<int>(state.range(0)));
+    PoolGetAll(urls);
+    for (auto _ : state) {
+        PoolGetAll(urls);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    ZegoConnectionHttpPool::GetInstance()->UnInit();
+}
+
+void BM_BurstFreshHandle(benchmark::State &state) {
+    std::vector<std::string> urls = BurstUrls(static_cast<int>(state.range(0)));
+    std::atomic<int> failures{0};
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (const auto &url : urls) {
+            threads.emplace_back([&url, &failures]() {
+                if (!FreshHandleGet(url)) {
+                    failures++;
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+    if (failures.load() != 0) {
+        state.SkipWithError("request failed");
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_BurstPool)->Name("BM_Burst/pool")->Arg(40)->UseRealTime();
+BENCHMARK(BM_BurstFreshHandle)->Name("BM_Burst/fresh_handle")->Arg(40)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,307 @@
+// ZegoConnectionHttpPool (zego_connection_http_pool.hpp) against LocalHttpServer over plain HTTP,
+// and against LocalTlsServer for handshake counting and TLS session resumption.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "local_http_server.h"
+#include "local_tls_server.h"
+#include "zego_connection_http_pool.hpp"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Collects responses and waits for a given number of them
+class Responses {
+  public:
+    OnHttpResponseDelegate Delegate() {
+        return [this](std::shared_ptr<HttpContext> context) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            contexts_.push_back(context);
+            cv_.notify_all();
+        };
+    }
+
+    bool WaitFor(size_t count, int timeoutMs = 5000) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this, count]() { return contexts_.size() >= count; });
+    }
+
+    std::vector<std::shared_ptr<HttpContext>> Get() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return contexts_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<HttpContext>> contexts_;
+};
+
+HttpPoolRequest Get(const std::string &url) {
+    HttpPoolRequest request;
+    request.url = url;
+    return request;
+}
+
+class HttpPoolTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        pool_ = ZegoConnectionHttpPool::GetInstance();
+        baseline_ = pool_->GetStats();
+    }
+
+    void TearDown() override { pool_->UnInit(); }
+
+    // The pool is a singleton whose counters span Init/UnInit, so tests look at their own share
+    HttpPoolStats Stats() {
+        HttpPoolStats stats = pool_->GetStats();
+        stats.requests -= baseline_.requests;
+        stats.coalesced -= baseline_.coalesced;
+        stats.queued -= baseline_.queued;
+        stats.rejected -= baseline_.rejected;
+        stats.transfers -= baseline_.transfers;
+        stats.connectionsCreated -= baseline_.connectionsCreated;
+        stats.connectionsReused -= baseline_.connectionsReused;
+        stats.tlsHandshakes -= baseline_.tlsHandshakes;
+        stats.tlsHandshakeTotalMs -= baseline_.tlsHandshakeTotalMs;
+        return stats;
+    }
+
+    // Unlimited rate unless a test sets one
+    static HttpPoolConfig Config() {
+        HttpPoolConfig config;
+        config.requestsPerSecond = 0;
+        return config;
+    }
+
+    LocalHttpServer server_;
+    std::shared_ptr<ZegoConnectionHttpPool> pool_;
+    HttpPoolStats baseline_;
+    // Outlives TearDown, which fails whatever is still pending into it
+    Responses responses_;
+};
+
+TEST_F(HttpPoolTest, RequestBeforeInitFailsInline) {
+    EXPECT_EQ(pool_->Request(Get(server_.Url("/a")), responses_.Delegate()), 0u);
+    ASSERT_EQ(responses_.Get().size(), 1u);
+    EXPECT_EQ(responses_.Get()[0]->error, kZCENotInited);
+}
+
+TEST_F(HttpPoolTest, EmptyUrlIsRejected) {
+    ASSERT_EQ(pool_->Init(Config()), kZCSuccess);
+    EXPECT_EQ(pool_->Request(Get(""), responses_.Delegate()), 0u);
+    ASSERT_EQ(responses_.Get().size(), 1u);
+    EXPECT_EQ(responses_.Get()[0]->error, kZCEHttpInvalidUrl);
+}
+
+TEST_F(HttpPoolTest, SequentialRequestsReuseOneConnection) {
+    ASSERT_EQ(pool_->Init(Config()), kZCSuccess);
+    for (size_t i = 0; i < 10; i++) {
+        ASSERT_NE(pool_->Request(Get(server_.Url("/seq/" + std::to_string(i))),
+                                 responses_.Delegate()),
+                  0u);
+        ASSERT_TRUE(responses_.WaitFor(i + 1));
+    }
+
+    for (size_t i = 0; i < 10; i++) {
+        std::shared_ptr<HttpContext> context = responses_.Get()[i];
+        EXPECT_EQ(context->error, kZCSuccess);
+        EXPECT_EQ(context->statusCode, 200);
+        EXPECT_EQ(*context->content, "/seq/" + std::to_string(i));
+    }
+    EXPECT_EQ(server_.Connections(), 1);
+    HttpPoolStats stats = Stats();
+    EXPECT_EQ(stats.transfers, 10u);
+    EXPECT_EQ(stats.connectionsCreated, 1u);
+    EXPECT_EQ(stats.connectionsReused, 9u);
+    EXPECT_DOUBLE_EQ(stats.PoolHitRate(), 0.9);
+}
+
+TEST_F(HttpPoolTest, IdenticalGetsInFlightAreSentOnce) {
+    ASSERT_EQ(pool_->Init(Config()), kZCSuccess);
+    server_.SetDelayMs(200);
+    std::set<ZCSeq> seqs;
+    for (int i = 0; i < 20; i++) {
+        seqs.insert(pool_->Request(Get(server_.Url("/same")), responses_.Delegate()));
+    }
+    ASSERT_TRUE(responses_.WaitFor(20));
+
+    EXPECT_EQ(server_.Requests(), 1);
+    EXPECT_EQ(Stats().coalesced, 19u);
+    std::set<ZCSeq> answered;
+    for (const auto &context : responses_.Get()) {
+        EXPECT_EQ(context->error, kZCSuccess);
+        EXPECT_EQ(*context->content, "/same");
+        answered.insert(context->seq);
+    }
+    EXPECT_EQ(seqs.size(), 20u);
+    EXPECT_EQ(answered, seqs);
+}
+
+TEST_F(HttpPoolTest, GetsWithDifferentHeadersAndPostsAreNotCoalesced) {
+    ASSERT_EQ(pool_->Init(Config()), kZCSuccess);
+    server_.SetDelayMs(100);
+    HttpPoolRequest withHeader = Get(server_.Url("/same"));
+    withHeader.headers.push_back("X-Test: 1");
+    HttpPoolRequest post = Get(server_.Url("/same"));
+    post.body = "payload";
+    pool_->Request(Get(server_.Url("/same")), responses_.Delegate());
+    pool_->Request(withHeader, responses_.Delegate());
+    pool_->Request(post, responses_.Delegate());
+    pool_->Request(post, responses_.Delegate());
+    ASSERT_TRUE(responses_.WaitFor(4));
+
+    EXPECT_EQ(server_.Requests(), 4);
+    EXPECT_EQ(Stats().coalesced, 0u);
+}
+
+TEST_F(HttpPoolTest, TokenBucketQueuesInsteadOfRejecting) {
+    HttpPoolConfig config = Config();
+    config.requestsPerSecond = 50;
+    config.burst = 5;
+    ASSERT_EQ(pool_->Init(config), kZCSuccess);
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < 20; i++) {
+        pool_->Request(Get(server_.Url("/rate/" + std::to_string(i))), responses_.Delegate());
+    }
+    ASSERT_TRUE(responses_.WaitFor(20));
+    int64_t elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+    for (const auto &context : responses_.Get()) {
+        EXPECT_EQ(context->error, kZCSuccess);
+    }
+    HttpPoolStats stats = Stats();
+    EXPECT_EQ(stats.rejected, 0u);
+    EXPECT_GE(stats.queued, 10u);
+    // 5 from the burst, the other 15 at 50 per second
+    EXPECT_GE(elapsedMs, 250);
+}
+
+TEST_F(HttpPoolTest, FullQueueRejectsWithTooMany) {
+    HttpPoolConfig config = Config();
+    config.requestsPerSecond = 1;
+    config.burst = 1;
+    config.maxQueued = 2;
+    ASSERT_EQ(pool_->Init(config), kZCSuccess);
+    int rejected = 0;
+    for (int i = 0; i < 6; i++) {
+        if (pool_->Request(Get(server_.Url("/full/" + std::to_string(i))),
+                           responses_.Delegate()) == 0) {
+            rejected++;
+        }
+    }
+
+    // At most the one burst token and the two queue slots were taken
+    EXPECT_GE(rejected, 3);
+    EXPECT_EQ(Stats().rejected, static_cast<uint64>(rejected));
+    int tooMany = 0;
+    for (const auto &context : responses_.Get()) {
+        tooMany += context->error == kZCEHttpReqTooMany ? 1 : 0;
+    }
+    EXPECT_EQ(tooMany, rejected);
+}
+
+TEST_F(HttpPoolTest, ErrorStatusIsReported) {
+    ASSERT_EQ(pool_->Init(Config()), kZCSuccess);
+    pool_->Request(Get(server_.Url("/status/404")), responses_.Delegate());
+    ASSERT_TRUE(responses_.WaitFor(1));
+
+    std::shared_ptr<HttpContext> context = responses_.Get()[0];
+    EXPECT_EQ(context->statusCode, 404);
+    EXPECT_EQ(context->error, kZCEHttpRespondBase + 404);
+    ASSERT_TRUE(context->httpCollectedData);
+    ASSERT_EQ(context->httpCollectedData->detailList.size(), 1u);
+    EXPECT_EQ(context->httpCollectedData->detailList[0].primaryIP, "127.0.0.1");
+}
+
+TEST_F(HttpPoolTest, UnInitFailsPendingRequests) {
+    HttpPoolConfig config = Config();
+    config.requestsPerSecond = 1;
+    config.burst = 1;
+    ASSERT_EQ(pool_->Init(config), kZCSuccess);
+    server_.SetDelayMs(1000);
+    pool_->Request(Get(server_.Url("/slow")), responses_.Delegate());
+    pool_->Request(Get(server_.Url("/queued")), responses_.Delegate());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    pool_->UnInit();
+
+    ASSERT_EQ(responses_.Get().size(), 2u);
+    for (const auto &context : responses_.Get()) {
+        EXPECT_EQ(context->error, kZCENotInited);
+    }
+    Responses after;
+    EXPECT_EQ(pool_->Request(Get(server_.Url("/after")), after.Delegate()), 0u);
+}
+
+TEST_F(HttpPoolTest, PooledHttpsRequestsShareOneFullHandshake) {
+    LocalTlsServer tls;
+    // Long enough that the handshake shows in the millisecond metric
+    tls.SetHandshakeDelayMs(30);
+    HttpPoolConfig config = Config();
+    config.caFile = tls.CertFile();
+    ASSERT_EQ(pool_->Init(config), kZCSuccess);
+
+    const size_t kRequests = 8;
+    for (size_t i = 0; i < kRequests; i++) {
+        ASSERT_NE(pool_->Request(Get(tls.Url("/tls/" + std::to_string(i))), responses_.Delegate()),
+                  0u);
+        ASSERT_TRUE(responses_.WaitFor(i + 1));
+    }
+
+    for (size_t i = 0; i < kRequests; i++) {
+        std::shared_ptr<HttpContext> context = responses_.Get()[i];
+        ASSERT_EQ(context->error, kZCSuccess) << context->errorMessage;
+        EXPECT_EQ(*context->content, "/tls/" + std::to_string(i));
+    }
+    EXPECT_EQ(tls.Connections(), 1);
+    EXPECT_EQ(tls.FullHandshakes(), 1);
+    EXPECT_EQ(tls.Requests(), static_cast<int>(kRequests));
+    HttpPoolStats stats = Stats();
+    EXPECT_EQ(stats.tlsHandshakes, 1u);
+    EXPECT_GE(stats.tlsHandshakeTotalMs, 30u);
+    EXPECT_GE(stats.tlsHandshakeMaxMs, 30u);
+    const HttpDetailData &first = responses_.Get()[0]->httpCollectedData->detailList[0];
+    EXPECT_GE(first.appConnectTime - first.connectTime, 0.03);
+    const HttpDetailData &reused = responses_.Get()[1]->httpCollectedData->detailList[0];
+    EXPECT_FALSE(reused.isForceNewConnection);
+}
+
+TEST_F(HttpPoolTest, NewHttpsConnectionsResumeTheSession) {
+    LocalTlsServer tls;
+    HttpPoolConfig config = Config();
+    config.caFile = tls.CertFile();
+    ASSERT_EQ(pool_->Init(config), kZCSuccess);
+    pool_->Request(Get(tls.Url("/first")), responses_.Delegate());
+    ASSERT_TRUE(responses_.WaitFor(1));
+    ASSERT_EQ(responses_.Get()[0]->error, kZCSuccess) << responses_.Get()[0]->errorMessage;
+
+    // Requests in flight together need connections of their own
+    tls.SetDelayMs(100);
+    for (int i = 0; i < 4; i++) {
+        pool_->Request(Get(tls.Url("/burst/" + std::to_string(i))), responses_.Delegate());
+    }
+    ASSERT_TRUE(responses_.WaitFor(5));
+    for (const auto &context : responses_.Get()) {
+        EXPECT_EQ(context->error, kZCSuccess) << context->errorMessage;
+    }
+    EXPECT_GE(tls.Connections(), 4);
+    EXPECT_EQ(tls.FullHandshakes(), 1);
+    EXPECT_EQ(tls.ResumedHandshakes(), tls.Connections() - 1);
+    EXPECT_EQ(Stats().tlsHandshakes, static_cast<uint64>(tls.Connections()));
+}
+
+} // namespace
@@ -0,0 +1,367 @@
+// In-memory stand-in for the leveldb bundled in ZegoConnection, see zego_connection_fake.h.
+//
+// Only the surface the header-only layers use is implemented: DB::Open/DestroyDB, Put/Get/Delete,
+// Write with a WriteBatch, forward iteration and Status. The data of a path outlives the DB
+// object, so closing and reopening a path behaves like a restart. Failed puts and unreadable
+// keys are injected per path through the FAKE functions.
+
+#include "zego_connection_fake.h"
+
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "leveldb/db.h"
+#include "leveldb/iterator.h"
+#include "leveldb/options.h"
+#include "leveldb/write_batch.h"
+
+namespace {
+
+typedef std::map<std::string, std::string> Table;
+
+struct Store {
+    std::mutex mutex;
+    Table table;
+    int failPuts = 0;
+    // Get answers Corruption for these until they are deleted; iteration still sees them
+    std::set<std::string> unreadable;
+};
+
+std::mutex gStoresMutex;
+std::map<std::string, std::shared_ptr<Store>> gStores;
+std::set<std::string> gCorrupt;
+
+std::shared_ptr<Store> StoreOf(const std::string &path) {
+    std::lock_guard<std::mutex> lock(gStoresMutex);
+    std::shared_ptr<Store> &store = gStores[path];
+    if (!store) {
+        store = std::make_shared<Store>();
+    }
+    return store;
+}
+
+} // namespace
+
+namespace ZEGO {
+namespace CONNECTION {
+namespace FAKE {
+
+void CorruptLevelDB(const std::string &path) {
+    std::lock_guard<std::mutex> lock(gStoresMutex);
+    gCorrupt.insert(path);
+}
+
+void FailLevelDBPuts(const std::string &path, int count) {
+    std::shared_ptr<Store> store = StoreOf(path);
+    std::lock_guard<std::mutex> lock(store->mutex);
+    store->failPuts = count;
+}
+
+void MakeLevelDBKeyUnreadable(const std::string &path, const std::string &key) {
+    std::shared_ptr<Store> store = StoreOf(path);
+    std::lock_guard<std::mutex> lock(store->mutex);
+    store->unreadable.insert(key);
+}
+
+void DestroyAllLevelDB() {
+    std::lock_guard<std::mutex> lock(gStoresMutex);
+    gStores.clear();
+    gCorrupt.clear();
+}
+
+} // namespace FAKE
+} // namespace CONNECTION
+} // namespace ZEGO
+
+namespace leveldb {
+
+// Operations are kept as (tag, key, value) triples: 'P' for Put, 'D' for Delete
+class WriteBatchInternal {
+  public:
+    static void Add(WriteBatch *batch, char tag, const Slice &key, const Slice &value) {
+        AppendField(batch->rep_, Slice(&tag, 1));
+        AppendField(batch->rep_, key);
+        AppendField(batch->rep_, value);
+    }
+
+    static Status Iterate(const WriteBatch *batch, WriteBatch::Handler *handler) {
+        const std::string &rep = batch->rep_;
+        size_t pos = 0;
+        while (pos < rep.size()) {
+            Slice tag, key, value;
+            if (!ReadField(rep, pos, tag) || !ReadField(rep, pos, key) ||
+                !ReadField(rep, pos, value) || tag.size() != 1) {
+                return Status::Corruption("malformed WriteBatch");
+            }
+            if (tag[0] == 'P') {
+                handler->Put(key, value);
+            } else {
+                handler->Delete(key);
+            }
+        }
+        return Status::OK();
+    }
+
+    static const std::string &Contents(const WriteBatch *batch) { return batch->rep_; }
+
+    static std::string &Contents(WriteBatch *batch) { return batch->rep_; }
+
+  private:
+    static void AppendField(std::string &rep, const Slice &field) {
+        uint32_t size = static_cast<uint32_t>(field.size());
+        rep.append(reinterpret_cast<const char *>(&size), sizeof(size));
+        rep.append(field.data(), field.size());
+    }
+
+    static bool ReadField(const std::string &rep, size_t &pos, Slice &field) {
+        uint32_t size = 0;
+        if (rep.size() - pos < sizeof(size)) {
+            return false;
+        }
+        memcpy(&size, rep.data() + pos, sizeof(size));
+        pos += sizeof(size);
+        if (rep.size() - pos < size) {
+            return false;
+        }
+        field = Slice(rep.data() + pos, size);
+        pos += size;
+        return true;
+    }
+};
+
+Options::Options() : env(nullptr) {}
+
+Status::Status(Code code, const Slice &msg, const Slice &msg2) {
+    const uint32_t len1 = static_cast<uint32_t>(msg.size());
+    const uint32_t len2 = static_cast<uint32_t>(msg2.size());
+    const uint32_t size = len1 + (len2 ? (2 + len2) : 0);
+    char *result = new char[size + 5];
+    memcpy(result, &size, sizeof(size));
+    result[4] = static_cast<char>(code);
+    memcpy(result + 5, msg.data(), len1);
+    if (len2) {
+        result[5 + len1] = ':';
+        result[6 + len1] = ' ';
+        memcpy(result + 7 + len1, msg2.data(), len2);
+    }
+    state_ = result;
+}
+
+const char *Status::CopyState(const char *state) {
+    uint32_t size;
+    memcpy(&size, state, sizeof(size));
+    char *result = new char[size + 5];
+    memcpy(result, state, size + 5);
+    return result;
+}
+
+std::string Status::ToString() const {
+    if (state_ == nullptr) {
+        return "OK";
+    }
+    uint32_t size;
+    memcpy(&size, state_, sizeof(size));
+    return std::string(state_ + 5, size);
+}
+
+Iterator::Iterator() {
+    cleanup_head_.function = nullptr;
+    cleanup_head_.next = nullptr;
+}
+
+Iterator::~Iterator() {
+    if (!cleanup_head_.IsEmpty()) {
+        cleanup_head_.Run();
+        for (CleanupNode *node = cleanup_head_.next; node != nullptr;) {
+            node->Run();
+            CleanupNode *next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+}
+
+void Iterator::RegisterCleanup(CleanupFunction function, void *arg1, void *arg2) {
+    CleanupNode *node;
+    if (cleanup_head_.IsEmpty()) {
+        node = &cleanup_head_;
+    } else {
+        node = new CleanupNode();
+        node->next = cleanup_head_.next;
+        cleanup_head_.next = node;
+    }
+    node->function = function;
+    node->arg1 = arg1;
+    node->arg2 = arg2;
+}
+
+WriteBatch::Handler::~Handler() = default;
+
+WriteBatch::WriteBatch() = default;
+
+WriteBatch::~WriteBatch() = default;
+
+void WriteBatch::Put(const Slice &key, const Slice &value) {
+    WriteBatchInternal::Add(this, 'P', key, value);
+}
+
+void WriteBatch::Delete(const Slice &key) { WriteBatchInternal::Add(this, 'D', key, Slice()); }
+
+void WriteBatch::Clear() { rep_.clear(); }
+
+size_t WriteBatch::ApproximateSize() const { return rep_.size(); }
+
+void WriteBatch::Append(const WriteBatch &source) {
+    WriteBatchInternal::Contents(this) += WriteBatchInternal::Contents(&source);
+}
+
+Status WriteBatch::Iterate(Handler *handler) const {
+    return WriteBatchInternal::Iterate(this, handler);
+}
+
+Snapshot::~Snapshot() = default;
+
+DB::~DB() = default;
+
+namespace {
+
+// Iterates over a copy, as a leveldb iterator sees the snapshot it was created on
+class MemIterator : public Iterator {
+  public:
+    explicit MemIterator(Table table) : table_(std::move(table)), it_(table_.end()) {}
+
+    bool Valid() const override { return it_ != table_.end(); }
+    void SeekToFirst() override { it_ = table_.begin(); }
+    void SeekToLast() override { it_ = table_.empty() ? table_.end() : std::prev(table_.end()); }
+    void Seek(const Slice &target) override { it_ = table_.lower_bound(target.ToString()); }
+    void Next() override { ++it_; }
+    void Prev() override { it_ = it_ == table_.begin() ? table_.end() : std::prev(it_); }
+    Slice key() const override { return it_->first; }
+    Slice value() const override { return it_->second; }
+    Status status() const override { return Status::OK(); }
+
+  private:
+    Table table_;
+    Table::const_iterator it_;
+};
+
+class MemDB : public DB {
+  public:
+    explicit MemDB(std::shared_ptr<Store> store) : store_(std::move(store)) {}
+
+    Status Put(const WriteOptions &, const Slice &key, const Slice &value) override {
+        std::lock_guard<std::mutex> lock(store_->mutex);
+        if (store_->failPuts > 0) {
+            store_->failPuts--;
+            return Status::IOError(key, "put failed by the test");
+        }
+        store_->table[key.ToString()] = value.ToString();
+        return Status::OK();
+    }
+
+    Status Delete(const WriteOptions &, const Slice &key) override {
+        std::lock_guard<std::mutex> lock(store_->mutex);
+        store_->table.erase(key.ToString());
+        store_->unreadable.erase(key.ToString());
+        return Status::OK();
+    }
+
+    Status Write(const WriteOptions &, WriteBatch *updates) override {
+        class Apply : public WriteBatch::Handler {
+          public:
+            explicit Apply(Table &table) : table_(table) {}
+            void Put(const Slice &key, const Slice &value) override {
+                table_[key.ToString()] = value.ToString();
+            }
+            void Delete(const Slice &key) override {
+                table_.erase(key.ToString());
+                deleted.push_back(key.ToString());
+            }
+
+            std::vector<std::string> deleted;
+
+          private:
+            Table &table_;
+        };
+        std::lock_guard<std::mutex> lock(store_->mutex);
+        Table table = store_->table;
+        Apply apply(table);
+        Status status = updates->Iterate(&apply);
+        if (status.ok()) {
+            store_->table.swap(table);
+            for (const std::string &key : apply.deleted) {
+                store_->unreadable.erase(key);
+            }
+        }
+        return status;
+    }
+
+    Status Get(const ReadOptions &, const Slice &key, std::string *value) override {
+        std::lock_guard<std::mutex> lock(store_->mutex);
+        auto it = store_->table.find(key.ToString());
+        if (it == store_->table.end()) {
+            return Status::NotFound(key);
+        }
+        if (store_->unreadable.count(it->first) != 0) {
+            return Status::Corruption(key, "made unreadable by the test");
+        }
+        *value = it->second;
+        return Status::OK();
+    }
+
+    Iterator *NewIterator(const ReadOptions &) override {
+        std::lock_guard<std::mutex> lock(store_->mutex);
+        return new MemIterator(store_->table);
+    }
+
+    const Snapshot *GetSnapshot() override { return nullptr; }
+    void ReleaseSnapshot(const Snapshot *) override {}
+    bool GetProperty(const Slice &, std::string *) override { return false; }
+
+    void GetApproximateSizes(const Range *, int n, uint64_t *sizes) override {
+        for (int i = 0; i < n; i++) {
+            sizes[i] = 0;
+        }
+    }
+
+    void CompactRange(const Slice *, const Slice *) override {}
+
+  private:
+    std::shared_ptr<Store> store_;
+};
+
+} // namespace
+
+Status DB::Open(const Options &options, const std::string &name, DB **dbptr) {
+    *dbptr = nullptr;
+    std::lock_guard<std::mutex> lock(gStoresMutex);
+    if (gCorrupt.count(name) != 0) {
+        return Status::Corruption(name, "marked corrupt by the test");
+    }
+    auto it = gStores.find(name);
+    if (it == gStores.end()) {
+        if (!options.create_if_missing) {
+            return Status::InvalidArgument(name, "does not exist (create_if_missing is false)");
+        }
+        it = gStores.emplace(name, std::make_shared<Store>()).first;
+    } else if (options.error_if_exists) {
+        return Status::InvalidArgument(name, "exists (error_if_exists is true)");
+    }
+    *dbptr = new MemDB(it->second);
+    return Status::OK();
+}
+
+Status DestroyDB(const std::string &name, const Options &) {
+    std::lock_guard<std::mutex> lock(gStoresMutex);
+    gStores.erase(name);
+    gCorrupt.erase(name);
+    return Status::OK();
+}
+
+} // namespace leveldb
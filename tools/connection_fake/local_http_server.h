@@ -0,0 +1,153 @@
+// Minimal HTTP/1.1 server on 127.0.0.1 for the HTTP pool test and benchmark.
+//
+// Each connection gets its own detached thread and is kept alive until the client closes it.
+// Requests are answered with 200 and the request path as body, or with the status given by a
+// "/status/<code>" path, after the configured delay. Counts connections and requests so tests can
+// tell reused connections from new ones.
+
+#ifndef LOCAL_HTTP_SERVER_H
+#define LOCAL_HTTP_SERVER_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+class LocalHttpServer {
+  public:
+    LocalHttpServer() {
+        listen_ = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(listen_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        listen(listen_, 128);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_, reinterpret_cast<sockaddr *>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this]() { Accept(); });
+    }
+
+    ~LocalHttpServer() {
+        stopping_.store(true);
+        shutdown(listen_, SHUT_RDWR);
+        close(listen_);
+        acceptor_.join();
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (int fd : connections_) {
+            shutdown(fd, SHUT_RDWR);
+        }
+        closed_.wait(lock, [this]() { return connections_.empty(); });
+    }
+
+    std::string Url(const std::string &path) const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    void SetDelayMs(int delayMs) { delayMs_.store(delayMs); }
+
+    int Connections() const { return connectionCount_.load(); }
+
+    int Requests() const { return requestCount_.load(); }
+
+  private:
+    void Accept() {
+        while (!stopping_.load()) {
+            int fd = accept(listen_, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            connectionCount_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_.load()) {
+                close(fd);
+                return;
+            }
+            connections_.insert(fd);
+            std::thread([this, fd]() {
+                Serve(fd);
+                std::lock_guard<std::mutex> lock(mutex_);
+                close(fd);
+                connections_.erase(fd);
+                closed_.notify_all();
+            }).detach();
+        }
+    }
+
+    void Serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            std::string head = buffer.substr(0, headerEnd);
+            size_t bodySize = 0;
+            size_t lengthAt = head.find("Content-Length: ");
+            if (lengthAt != std::string::npos) {
+                bodySize = static_cast<size_t>(atol(head.c_str() + lengthAt + 16));
+            }
+            while (buffer.size() < headerEnd + 4 + bodySize) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            buffer.erase(0, headerEnd + 4 + bodySize);
+            requestCount_++;
+
+            size_t pathStart = head.find(' ') + 1;
+            std::string path = head.substr(pathStart, head.find(' ', pathStart) - pathStart);
+            int status = 200;
+            if (path.compare(0, 8, "/status/") == 0) {
+                status = atoi(path.c_str() + 8);
+            }
+            int delayMs = delayMs_.load();
+            if (delayMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            }
+            std::string response = "HTTP/1.1 " + std::to_string(status) +
+                                   " X\r\nContent-Length: " + std::to_string(path.size()) +
+                                   "\r\nConnection: keep-alive\r\n\r\n" + path;
+            if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) {
+                return;
+            }
+        }
+    }
+
+    int listen_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> delayMs_{0};
+    std::atomic<int> connectionCount_{0};
+    std::atomic<int> requestCount_{0};
+    std::thread acceptor_;
+    std::mutex mutex_;
+    std::condition_variable closed_;
+    std::set<int> connections_;
+};
+
+#endif // LOCAL_HTTP_SERVER_H
@@ -0,0 +1,239 @@
+// LocalTlsServer of local_tls_server.h.
+
+#include "local_tls_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <openssl/x509v3.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+class LocalTlsServer::Impl {
+  public:
+    Impl() {
+        // OpenSSL writes with plain write(), which raises SIGPIPE once a client has gone
+        signal(SIGPIPE, SIG_IGN);
+        key_ = EVP_EC_gen("P-256");
+        cert_ = SelfSignedCertificate(key_);
+        char path[] = "/tmp/local_tls_server_XXXXXX";
+        int fd = mkstemp(path);
+        certFile_ = path;
+        FILE *file = fdopen(fd, "w");
+        PEM_write_X509(file, cert_);
+        fclose(file);
+
+        ctx_ = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_set_max_proto_version(ctx_, TLS1_2_VERSION);
+        SSL_CTX_use_certificate(ctx_, cert_);
+        SSL_CTX_use_PrivateKey(ctx_, key_);
+
+        listen_ = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(listen_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        listen(listen_, 128);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_, reinterpret_cast<sockaddr *>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this]() { Accept(); });
+    }
+
+    ~Impl() {
+        stopping_.store(true);
+        shutdown(listen_, SHUT_RDWR);
+        close(listen_);
+        acceptor_.join();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (int fd : connections_) {
+                shutdown(fd, SHUT_RDWR);
+            }
+            closed_.wait(lock, [this]() { return connections_.empty(); });
+        }
+        SSL_CTX_free(ctx_);
+        X509_free(cert_);
+        EVP_PKEY_free(key_);
+        unlink(certFile_.c_str());
+    }
+
+    std::string Url(const std::string &path) const {
+        return "https://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    const std::string &CertFile() const { return certFile_; }
+
+    void SetHandshakeDelayMs(int delayMs) { handshakeDelayMs_.store(delayMs); }
+
+    void SetDelayMs(int delayMs) { delayMs_.store(delayMs); }
+
+    int Connections() const { return connectionCount_.load(); }
+
+    int FullHandshakes() const { return fullHandshakes_.load(); }
+
+    int ResumedHandshakes() const { return resumedHandshakes_.load(); }
+
+    int Requests() const { return requestCount_.load(); }
+
+  private:
+    static X509 *SelfSignedCertificate(EVP_PKEY *key) {
+        X509 *cert = X509_new();
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), -60);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME *name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char *>("127.0.0.1"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509V3_CTX v3;
+        X509V3_set_ctx_nodb(&v3);
+        X509V3_set_ctx(&v3, cert, cert, nullptr, nullptr, 0);
+        X509_EXTENSION *san = X509V3_EXT_conf_nid(nullptr, &v3, NID_subject_alt_name,
+                                                  const_cast<char *>("IP:127.0.0.1"));
+        X509_add_ext(cert, san, -1);
+        X509_EXTENSION_free(san);
+        X509_sign(cert, key, EVP_sha256());
+        return cert;
+    }
+
+    void Accept() {
+        while (!stopping_.load()) {
+            int fd = accept(listen_, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            connectionCount_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_.load()) {
+                close(fd);
+                return;
+            }
+            connections_.insert(fd);
+            std::thread([this, fd]() {
+                SSL *ssl = SSL_new(ctx_);
+                SSL_set_fd(ssl, fd);
+                Serve(ssl);
+                SSL_free(ssl);
+                std::lock_guard<std::mutex> lock(mutex_);
+                close(fd);
+                connections_.erase(fd);
+                closed_.notify_all();
+            }).detach();
+        }
+    }
+
+    void Serve(SSL *ssl) {
+        int handshakeDelayMs = handshakeDelayMs_.load();
+        if (handshakeDelayMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(handshakeDelayMs));
+        }
+        if (SSL_accept(ssl) != 1) {
+            return;
+        }
+        (SSL_session_reused(ssl) ? resumedHandshakes_ : fullHandshakes_)++;
+
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            size_t headerEnd;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                int n = SSL_read(ssl, chunk, sizeof(chunk));
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            std::string head = buffer.substr(0, headerEnd);
+            size_t bodySize = 0;
+            size_t lengthAt = head.find("Content-Length: ");
+            if (lengthAt != std::string::npos) {
+                bodySize = static_cast<size_t>(atol(head.c_str() + lengthAt + 16));
+            }
+            while (buffer.size() < headerEnd + 4 + bodySize) {
+                int n = SSL_read(ssl, chunk, sizeof(chunk));
+                if (n <= 0) {
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            buffer.erase(0, headerEnd + 4 + bodySize);
+            requestCount_++;
+
+            size_t pathStart = head.find(' ') + 1;
+            std::string path = head.substr(pathStart, head.find(' ', pathStart) - pathStart);
+            int delayMs = delayMs_.load();
+            if (delayMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+            }
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " +
+                                   std::to_string(path.size()) +
+                                   "\r\nConnection: keep-alive\r\n\r\n" + path;
+            if (SSL_write(ssl, response.data(), static_cast<int>(response.size())) <= 0) {
+                return;
+            }
+        }
+    }
+
+    EVP_PKEY *key_ = nullptr;
+    X509 *cert_ = nullptr;
+    SSL_CTX *ctx_ = nullptr;
+    std::string certFile_;
+    int listen_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> handshakeDelayMs_{0};
+    std::atomic<int> delayMs_{0};
+    std::atomic<int> connectionCount_{0};
+    std::atomic<int> fullHandshakes_{0};
+    std::atomic<int> resumedHandshakes_{0};
+    std::atomic<int> requestCount_{0};
+    std::thread acceptor_;
+    std::mutex mutex_;
+    std::condition_variable closed_;
+    std::set<int> connections_;
+};
+
+LocalTlsServer::LocalTlsServer() : impl_(new Impl()) {}
+
+LocalTlsServer::~LocalTlsServer() = default;
+
+std::string LocalTlsServer::Url(const std::string &path) const { return impl_->Url(path); }
+
+const std::string &LocalTlsServer::CertFile() const { return impl_->CertFile(); }
+
+void LocalTlsServer::SetHandshakeDelayMs(int delayMs) { impl_->SetHandshakeDelayMs(delayMs); }
+
+void LocalTlsServer::SetDelayMs(int delayMs) { impl_->SetDelayMs(delayMs); }
+
+int LocalTlsServer::Connections() const { return impl_->Connections(); }
+
+int LocalTlsServer::FullHandshakes() const { return impl_->FullHandshakes(); }
+
+int LocalTlsServer::ResumedHandshakes() const { return impl_->ResumedHandshakes(); }
+
+int LocalTlsServer::Requests() const { return impl_->Requests(); }
@@ -0,0 +1,51 @@
+// Minimal HTTPS/1.1 server on 127.0.0.1 for the HTTP pool test, the TLS counterpart of
+// LocalHttpServer.
+//
+// The constructor generates a P-256 key and a self-signed certificate for IP 127.0.0.1 and writes
+// the certificate to a temporary file that clients use as their CA file. Each connection gets its
+// own detached thread that completes the handshake, optionally after a delay, and then answers
+// every request with 200 and the request path as body. Counts connections, full and resumed
+// handshakes, and requests.
+//
+// The server speaks up to TLS 1.2, where one session resumes any number of connections. TLS 1.3
+// tickets are single use, and how many a client holds when it opens the next connection depends
+// on timing.
+//
+// Built in local_tls_server.cpp against the system OpenSSL: the ZegoConnection headers carry
+// BoringSSL headers under the same names, so no OpenSSL type appears here.
+
+#ifndef LOCAL_TLS_SERVER_H
+#define LOCAL_TLS_SERVER_H
+
+#include <memory>
+#include <string>
+
+class LocalTlsServer {
+  public:
+    LocalTlsServer();
+    ~LocalTlsServer();
+
+    std::string Url(const std::string &path) const;
+
+    // PEM file of the self-signed certificate, for HttpPoolConfig::caFile
+    const std::string &CertFile() const;
+
+    // Holds every handshake back by |delayMs| after the TCP connection is accepted
+    void SetHandshakeDelayMs(int delayMs);
+
+    void SetDelayMs(int delayMs);
+
+    int Connections() const;
+
+    int FullHandshakes() const;
+
+    int ResumedHandshakes() const;
+
+    int Requests() const;
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+#endif // LOCAL_TLS_SERVER_H
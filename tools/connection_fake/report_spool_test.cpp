@@ -0,0 +1,429 @@
+// ZegoReportSpool (zego_connection_report_spool.hpp) with a recording uploader, the in-memory
+// leveldb of leveldb_fake.cpp and the net type of the fake ZegoConnectionMonitor. Failed writes
+// and damaged records are injected through the leveldb fake.
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "leveldb/db.h"
+#include "local_http_server.h"
+#include "zego_connection_fake.h"
+#include "zego_connection_report_spool.hpp"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+std::string Inflate(const std::string &body, const std::string &dictionary) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit(&stream) != Z_OK) {
+        return std::string();
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(body.data()));
+    stream.avail_in = static_cast<uInt>(body.size());
+    std::string out;
+    char chunk[16384];
+    int ret = Z_OK;
+    while (ret != Z_STREAM_END) {
+        stream.next_out = reinterpret_cast<Bytef *>(chunk);
+        stream.avail_out = sizeof(chunk);
+        ret = inflate(&stream, Z_NO_FLUSH);
+        if (ret == Z_NEED_DICT) {
+            ret = inflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dictionary.data()),
+                                       static_cast<uInt>(dictionary.size()));
+            continue;
+        }
+        if (ret != Z_OK && ret != Z_STREAM_END) {
+            break;
+        }
+        out.append(chunk, sizeof(chunk) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    return ret == Z_STREAM_END ? out : std::string();
+}
+
+// Records decoded batches and answers with the result currently set
+class Server {
+  public:
+    OnReportUploadDelegate Uploader() {
+        return [this](const std::string &body, const std::function<void(bool ok)> &done) {
+            bool accept;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                attempts_.push_back(Clock::now());
+                accept = accept_;
+            }
+            done(accept);
+            // Recorded after |done|, so a waiter also sees the spool stats of this batch
+            if (accept) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                batches_.push_back(Inflate(body, ZegoReportSpool::DefaultDictionary()));
+                cv_.notify_all();
+            }
+        };
+    }
+
+    void SetAccept(bool accept) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        accept_ = accept;
+    }
+
+    bool WaitForBatches(size_t count, int timeoutMs = 5000) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this, count]() { return batches_.size() >= count; });
+    }
+
+    std::vector<std::string> Batches() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+    std::vector<Clock::time_point> Attempts() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return attempts_;
+    }
+
+    // Every "event_name":"..." across the accepted batches, in order
+    std::vector<std::string> EventNames() {
+        std::vector<std::string> names;
+        for (const auto &batch : Batches()) {
+            const std::string marker = "\"event_name\":\"";
+            for (size_t at = batch.find(marker); at != std::string::npos;
+                 at = batch.find(marker, at + 1)) {
+                size_t start = at + marker.size();
+                names.push_back(batch.substr(start, batch.find('"', start) - start));
+            }
+        }
+        return names;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool accept_ = true;
+    std::vector<std::string> batches_;
+    std::vector<Clock::time_point> attempts_;
+};
+
+// The spool's leveldb key of |seq|: "rpt:" and the big-endian sequence number
+std::string SpoolKey(uint64 seq) {
+    std::string key = "rpt:";
+    for (int i = 7; i >= 0; i--) {
+        key.push_back(static_cast<char>((seq >> (i * 8)) & 0xFF));
+    }
+    return key;
+}
+
+// Opens a second handle on the leveldb at |path|, which the fake shares with the spool's
+std::unique_ptr<leveldb::DB> OpenDB(const std::string &path) {
+    leveldb::DB *db = nullptr;
+    leveldb::Options options;
+    options.create_if_missing = true;
+    leveldb::DB::Open(options, path, &db);
+    return std::unique_ptr<leveldb::DB>(db);
+}
+
+const char *kContent = "{\"app_id\":1739272706,\"room_id\":\"room-1\",\"stream_id\":\"stream-1\","
+                       "\"network_type\":\"wifi\",\"platform\":\"android\",\"error\":0,"
+                       "\"time_consumed\":42}";
+
+class ReportSpoolTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        FAKE::DestroyAllLevelDB();
+        FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+    }
+
+    // Long intervals, so only size, instant reports, Flush and reconnects trigger uploads
+    static ReportSpoolConfig Config(const std::string &path = std::string()) {
+        ReportSpoolConfig config;
+        config.path = path;
+        config.wifi = ReportBatchProfile(60 * 1000, 256 * 1024, 100);
+        config.cellular = ReportBatchProfile(60 * 1000, 128 * 1024, 100);
+        config.slow = ReportBatchProfile(120 * 1000, 32 * 1024, 20);
+        return config;
+    }
+
+    static void ReportMany(ZegoReportSpool &spool, int count, int from = 0) {
+        for (int i = from; i < from + count; i++) {
+            spool.Report("event_" + std::to_string(i), kContent, 1);
+        }
+    }
+
+    Server server_;
+};
+
+TEST_F(ReportSpoolTest, FullBatchIsUploadedCompressedWithTheDictionary) {
+    auto spool = ZegoReportSpool::Create();
+    ASSERT_EQ(spool->Init(Config(), server_.Uploader()), kZCSuccess);
+    ReportMany(*spool, 100);
+    ASSERT_TRUE(server_.WaitForBatches(1));
+
+    std::string batch = server_.Batches()[0];
+    ASSERT_FALSE(batch.empty());
+    EXPECT_EQ(batch.compare(0, 11, "{\"events\":["), 0);
+    EXPECT_NE(batch.find(std::string("\"content\":") + kContent), std::string::npos);
+    EXPECT_EQ(server_.EventNames().size(), 100u);
+    ReportSpoolStats stats = spool->GetStats();
+    EXPECT_EQ(stats.uploadedEvents, 100u);
+    EXPECT_EQ(stats.spoolEvents, 0u);
+    EXPECT_GT(stats.CompressionRatio(), 5.0);
+}
+
+TEST_F(ReportSpoolTest, DictionaryBeatsPlainDeflateOnShortBatches) {
+    std::string raw = std::string("{\"events\":[{\"event_name\":\"login\",\"level\":1,\"time\":1,"
+                                  "\"content\":") +
+                      kContent + "}]}";
+    std::string plain = ZegoReportSpool::Compress(raw, std::string());
+    std::string withDictionary = ZegoReportSpool::Compress(raw, ZegoReportSpool::DefaultDictionary());
+    EXPECT_LT(withDictionary.size(), plain.size());
+    EXPECT_EQ(Inflate(withDictionary, ZegoReportSpool::DefaultDictionary()), raw);
+}
+
+TEST_F(ReportSpoolTest, InstantReportAndFlushDoNotWaitForTheInterval) {
+    auto spool = ZegoReportSpool::Create();
+    spool->Init(Config(), server_.Uploader());
+    spool->Report("crash", kContent, 3, true);
+    ASSERT_TRUE(server_.WaitForBatches(1, 1000));
+
+    spool->Report("normal", kContent, 1);
+    spool->Flush();
+    ASSERT_TRUE(server_.WaitForBatches(2, 1000));
+    EXPECT_EQ(server_.EventNames(), std::vector<std::string>({"crash", "normal"}));
+}
+
+TEST_F(ReportSpoolTest, OfflineEventsAreOnlySpooledUntilTheNetworkIsBack) {
+    auto spool = ZegoReportSpool::Create();
+    spool->Init(Config(), server_.Uploader());
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_NONE);
+    ReportMany(*spool, 250);
+    spool->Flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_TRUE(server_.Attempts().empty());
+    EXPECT_EQ(spool->GetStats().spoolEvents, 250u);
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+    // Full batches go out back to back, the remainder waits for the interval
+    ASSERT_TRUE(server_.WaitForBatches(2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(server_.EventNames().size(), 200u);
+    EXPECT_EQ(spool->GetStats().spoolEvents, 50u);
+}
+
+TEST_F(ReportSpoolTest, EventsSurviveARestartUntilAcknowledged) {
+    {
+        auto spool = ZegoReportSpool::Create();
+        ASSERT_EQ(spool->Init(Config("/spool"), server_.Uploader()), kZCSuccess);
+        FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_NONE);
+        ReportMany(*spool, 300);
+    }
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+
+    auto spool = ZegoReportSpool::Create();
+    ASSERT_EQ(spool->Init(Config("/spool"), server_.Uploader()), kZCSuccess);
+    EXPECT_EQ(spool->GetStats().recovered, 300u);
+    spool->Flush();
+    ASSERT_TRUE(server_.WaitForBatches(3));
+
+    std::vector<std::string> names = server_.EventNames();
+    ASSERT_EQ(names.size(), 300u);
+    EXPECT_EQ(std::set<std::string>(names.begin(), names.end()).size(), 300u);
+    EXPECT_EQ(names.front(), "event_0");
+    EXPECT_EQ(names.back(), "event_299");
+    spool->UnInit();
+
+    auto again = ZegoReportSpool::Create();
+    again->Init(Config("/spool"), server_.Uploader());
+    EXPECT_EQ(again->GetStats().recovered, 0u);
+}
+
+TEST_F(ReportSpoolTest, FailedUploadsBackOffExponentially) {
+    ReportSpoolConfig config = Config();
+    config.retryMinMs = 40;
+    config.retryMaxMs = 160;
+    server_.SetAccept(false);
+    auto spool = ZegoReportSpool::Create();
+    spool->Init(config, server_.Uploader());
+    spool->Report("x", kContent, 1, true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    spool->UnInit();
+
+    std::vector<Clock::time_point> attempts = server_.Attempts();
+    ASSERT_GE(attempts.size(), 5u);
+    std::vector<int64_t> gaps;
+    for (size_t i = 1; i < attempts.size(); i++) {
+        gaps.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(attempts[i] -
+                                                                             attempts[i - 1])
+                           .count());
+    }
+    // 40, 80, 160, then capped at 160
+    EXPECT_GE(gaps[0], 40);
+    EXPECT_GE(gaps[1], 80);
+    EXPECT_GE(gaps[2], 160);
+    EXPECT_LT(gaps[3], 320);
+    EXPECT_EQ(spool->GetStats().failedBatches, attempts.size());
+}
+
+TEST_F(ReportSpoolTest, SpoolCapDropsTheOldestEvents) {
+    ReportSpoolConfig config = Config();
+    config.maxSpoolBytes = 20 * 1024;
+    auto spool = ZegoReportSpool::Create();
+    spool->Init(config, server_.Uploader());
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_NONE);
+    ReportMany(*spool, 1000);
+
+    ReportSpoolStats stats = spool->GetStats();
+    EXPECT_LE(stats.spoolBytes, config.maxSpoolBytes);
+    EXPECT_EQ(stats.dropped + stats.spoolEvents, 1000u);
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+    spool->Flush();
+    ASSERT_TRUE(server_.WaitForBatches(1));
+    EXPECT_EQ(server_.EventNames().front(), "event_" + std::to_string(stats.dropped));
+}
+
+TEST_F(ReportSpoolTest, FailedWritesAreNotCounted) {
+    auto spool = ZegoReportSpool::Create();
+    ASSERT_EQ(spool->Init(Config("/spool"), server_.Uploader()), kZCSuccess);
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_NONE);
+    ReportMany(*spool, 2);
+    FAKE::FailLevelDBPuts("/spool", 3);
+    ReportMany(*spool, 8, 2);
+
+    ReportSpoolStats stats = spool->GetStats();
+    EXPECT_EQ(stats.appended, 7u);
+    EXPECT_EQ(stats.writeFailed, 3u);
+    EXPECT_EQ(stats.spoolEvents, 7u);
+    const uint64 spoolBytes = stats.spoolBytes;
+    spool->UnInit();
+
+    // What was counted is what is on disk
+    ASSERT_EQ(spool->Init(Config("/spool"), server_.Uploader()), kZCSuccess);
+    EXPECT_EQ(spool->GetStats().recovered, 7u);
+    EXPECT_EQ(spool->GetStats().spoolBytes, spoolBytes);
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+    spool->Flush();
+    ASSERT_TRUE(server_.WaitForBatches(1));
+    EXPECT_EQ(server_.EventNames(),
+              std::vector<std::string>({"event_0", "event_1", "event_5", "event_6", "event_7",
+                                        "event_8", "event_9"}));
+    stats = spool->GetStats();
+    EXPECT_EQ(stats.spoolEvents, 0u);
+    EXPECT_EQ(stats.spoolBytes, 0u);
+}
+
+TEST_F(ReportSpoolTest, DamagedRecordsAreDeletedAndSkipped) {
+    {
+        auto spool = ZegoReportSpool::Create();
+        ASSERT_EQ(spool->Init(Config("/spool"), server_.Uploader()), kZCSuccess);
+        FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_NONE);
+        ReportMany(*spool, 6);
+    }
+    // Sequence numbers start at 1: event_0 can not be read, event_2 is truncated, event_4 is gone
+    std::unique_ptr<leveldb::DB> db = OpenDB("/spool");
+    ASSERT_TRUE(db);
+    FAKE::MakeLevelDBKeyUnreadable("/spool", SpoolKey(1));
+    ASSERT_TRUE(db->Put(leveldb::WriteOptions(), SpoolKey(3), "trunc").ok());
+    ASSERT_TRUE(db->Delete(leveldb::WriteOptions(), SpoolKey(5)).ok());
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+    auto spool = ZegoReportSpool::Create();
+    ASSERT_EQ(spool->Init(Config("/spool"), server_.Uploader()), kZCSuccess);
+    EXPECT_EQ(spool->GetStats().recovered, 5u);
+    spool->Flush();
+    ASSERT_TRUE(server_.WaitForBatches(1));
+    EXPECT_EQ(server_.EventNames(), std::vector<std::string>({"event_1", "event_3", "event_5"}));
+
+    ReportSpoolStats stats = spool->GetStats();
+    EXPECT_EQ(stats.corrupted, 2u);
+    EXPECT_EQ(stats.uploadedEvents, 3u);
+    EXPECT_EQ(stats.spoolEvents, 0u);
+    EXPECT_EQ(stats.spoolBytes, 0u);
+    std::string value;
+    EXPECT_TRUE(db->Get(leveldb::ReadOptions(), SpoolKey(1), &value).IsNotFound());
+    EXPECT_TRUE(db->Get(leveldb::ReadOptions(), SpoolKey(3), &value).IsNotFound());
+}
+
+TEST_F(ReportSpoolTest, UnreadableQueueDoesNotStallLaterEvents) {
+    ReportSpoolConfig config = Config("/spool");
+    config.retryMinMs = 40;
+    auto spool = ZegoReportSpool::Create();
+    ASSERT_EQ(spool->Init(config, server_.Uploader()), kZCSuccess);
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_NONE);
+    ReportMany(*spool, 3);
+    for (uint64 seq = 1; seq <= 3; seq++) {
+        FAKE::MakeLevelDBKeyUnreadable("/spool", SpoolKey(seq));
+    }
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_WIFI);
+    spool->Flush();
+    Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+    while (spool->GetStats().corrupted < 3 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ReportSpoolStats stats = spool->GetStats();
+    EXPECT_EQ(stats.corrupted, 3u);
+    EXPECT_EQ(stats.spoolEvents, 0u);
+    EXPECT_EQ(stats.spoolBytes, 0u);
+    EXPECT_TRUE(server_.Attempts().empty());
+
+    spool->Report("after", kContent, 1, true);
+    ASSERT_TRUE(server_.WaitForBatches(1, 1000));
+    EXPECT_EQ(server_.EventNames(), std::vector<std::string>({"after"}));
+}
+
+TEST_F(ReportSpoolTest, BatchProfileFollowsTheNetType) {
+    ReportSpoolConfig config = Config();
+    auto spool = ZegoReportSpool::Create();
+    spool->Init(config, server_.Uploader());
+    EXPECT_EQ(spool->GetStats().batchIntervalMs, config.wifi.intervalMs);
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_3G);
+    EXPECT_EQ(spool->GetStats().netType, ZegoConnectionNetType::ZEGO_NT_3G);
+    EXPECT_EQ(spool->GetStats().batchIntervalMs, config.slow.intervalMs);
+    // 2G/3G batches hold at most 20 events
+    ReportMany(*spool, 20);
+    ASSERT_TRUE(server_.WaitForBatches(1));
+    EXPECT_EQ(server_.EventNames().size(), 20u);
+
+    FAKE::SetNetType(ZegoConnectionNetType::ZEGO_NT_5G);
+    EXPECT_EQ(spool->GetStats().batchIntervalMs, config.cellular.intervalMs);
+}
+
+TEST_F(ReportSpoolTest, DefaultUploaderPostsThroughTheHttpPool) {
+    LocalHttpServer http;
+    HttpPoolConfig poolConfig;
+    poolConfig.requestsPerSecond = 0;
+    ASSERT_EQ(ZegoConnectionHttpPool::GetInstance()->Init(poolConfig), kZCSuccess);
+    ReportSpoolConfig config = Config();
+    config.url = http.Url("/report");
+    auto spool = ZegoReportSpool::Create();
+    spool->Init(config);
+    spool->Report("login", kContent, 1, true);
+
+    Clock::time_point deadline = Clock::now() + std::chrono::seconds(5);
+    while (spool->GetStats().uploadedBatches == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(spool->GetStats().uploadedBatches, 1u);
+    EXPECT_EQ(http.Requests(), 1);
+    spool->UnInit();
+    ZegoConnectionHttpPool::GetInstance()->UnInit();
+}
+
+} // namespace
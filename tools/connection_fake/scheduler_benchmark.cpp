@@ -0,0 +1,227 @@
+// ZegoConnectionScheduler (zego_connection_scheduler.hpp) against a pool of the same number of
+// threads sharing one mutex-guarded queue, the shape of the default task it replaces in
+// WorkStealing mode.
+//
+//   BM_FanOut/shared_queue          Post 256 short jobs from the benchmark thread, wait for all.
+//   BM_FanOut/scheduler
+//   BM_FanOutFromWorker/shared_queue  The same burst posted by a job running on the pool, the
+//   BM_FanOutFromWorker/scheduler     case where the scheduler's posting worker keeps the jobs
+//                                     in its own queue and parked workers steal them.
+//   BM_PingPong/shared_queue        One job at a time, posted and waited for: the wake-up latency
+//   BM_PingPong/scheduler           of an idle pool.
+//
+// All pools run 4 threads. allocs/op counts heap allocations of the process per job.
+//
+// Usage:
+//   scheduler_benchmark [benchmark flags]
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_scheduler.hpp"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+std::atomic<unsigned long long> gAllocations{0};
+
+} // namespace
+
+// Counts every allocation of the process. Not inlined, or GCC pairs the free() below with the
+// new expressions it was inlined into and reports a mismatch.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { free(p); }
+
+namespace {
+
+const int kThreads = 4;
+const int kBurst = 256;
+
+// Threads taking jobs from one queue under one mutex
+class SharedQueue {
+  public:
+    SharedQueue() {
+        for (int i = 0; i < kThreads; i++) {
+            threads_.emplace_back([this]() { Loop(); });
+        }
+    }
+
+    ~SharedQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void Post(std::function<void()> &&job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+  private:
+    void Loop() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return !queue_.empty() || stopping_; });
+                if (queue_.empty()) {
+                    return;
+                }
+                job = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+};
+
+struct Scheduler {
+    Scheduler() {
+        ThreadPoolSchedulerConfig config;
+        config.cpuWorkers = kThreads;
+        ZegoConnectionScheduler::GetInstance()->Init(config);
+    }
+
+    ~Scheduler() { ZegoConnectionScheduler::GetInstance()->UnInit(); }
+
+    void Post(std::function<void()> &&job) {
+        ZegoConnectionScheduler::GetInstance()->Post(std::move(job), JOB_RUNNABLE_TYPE::JOB_NO_BLOCK);
+    }
+};
+
+// Wakes the benchmark thread once the last job of a round has run
+class Done {
+  public:
+    void Reset(int count) { remaining_.store(count); }
+
+    void CountDown() {
+        if (remaining_.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_one();
+        }
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return remaining_.load() == 0; });
+    }
+
+  private:
+    std::atomic<int> remaining_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+void Work() {
+    volatile unsigned x = 0;
+    for (int i = 0; i < 200; i++) {
+        x = x + i;
+    }
+}
+
+template <typename Pool>
+void BM_FanOut(benchmark::State &state) {
+    Pool pool;
+    Done done;
+    unsigned long long allocations = gAllocations.load();
+    for (auto _ : state) {
+        done.Reset(kBurst);
+        for (int i = 0; i < kBurst; i++) {
+            pool.Post([&done]() {
+                Work();
+                done.CountDown();
+            });
+        }
+        done.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kBurst);
+    state.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(gAllocations.load() - allocations) / kBurst,
+                           benchmark::Counter::kAvgIterations);
+}
+
+template <typename Pool>
+void BM_FanOutFromWorker(benchmark::State &state) {
+    Pool pool;
+    Done done;
+    unsigned long long allocations = gAllocations.load();
+    for (auto _ : state) {
+        done.Reset(kBurst);
+        pool.Post([&pool, &done]() {
+            for (int i = 0; i < kBurst; i++) {
+                pool.Post([&done]() {
+                    Work();
+                    done.CountDown();
+                });
+            }
+        });
+        done.Wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kBurst);
+    state.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(gAllocations.load() - allocations) / kBurst,
+                           benchmark::Counter::kAvgIterations);
+}
+
+template <typename Pool>
+void BM_PingPong(benchmark::State &state) {
+    Pool pool;
+    Done done;
+    unsigned long long allocations = gAllocations.load();
+    for (auto _ : state) {
+        done.Reset(1);
+        pool.Post([&done]() { done.CountDown(); });
+        done.Wait();
+    }
+    state.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(gAllocations.load() - allocations), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_TEMPLATE(BM_FanOut, SharedQueue)->Name("BM_FanOut/shared_queue")->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FanOut, Scheduler)->Name("BM_FanOut/scheduler")->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FanOutFromWorker, SharedQueue)
+    ->Name("BM_FanOutFromWorker/shared_queue")
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FanOutFromWorker, Scheduler)
+    ->Name("BM_FanOutFromWorker/scheduler")
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, SharedQueue)->Name("BM_PingPong/shared_queue")->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PingPong, Scheduler)->Name("BM_PingPong/scheduler")->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,194 @@
+// ZegoConnectionScheduler (zego_connection_scheduler.hpp) and the WorkStealing mode of
+// ZegoConnectionThreadPool::RunTask over it.
+//
+// The tests check the task ids Post hands out, that parked workers are woken for every job a
+// burst leaves queued rather than by a timer, that blocking jobs do not hold up short ones, and
+// that UnInit runs what was posted before it.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_fake.h"
+#include "zego_connection_thread_pool.hpp"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int kWorkers = 4;
+
+// Releases its waiters once |count| threads have arrived, or gives up after |timeoutMs|
+class Barrier {
+  public:
+    explicit Barrier(int count) : count_(count) {}
+
+    bool Arrive(int timeoutMs) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (++arrived_ >= count_) {
+            cv_.notify_all();
+            return true;
+        }
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this]() { return arrived_ >= count_; });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    const int count_;
+    int arrived_ = 0;
+};
+
+// Counts jobs down and lets the test wait for zero
+class Latch {
+  public:
+    explicit Latch(int count) : count_(count) {}
+
+    void CountDown() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--count_ == 0) {
+            cv_.notify_all();
+        }
+    }
+
+    bool Wait(int timeoutMs) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this]() { return count_ == 0; });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int count_;
+};
+
+class SchedulerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ThreadPoolSchedulerConfig config;
+        config.cpuWorkers = kWorkers;
+        config.blockingMinThreads = 1;
+        config.blockingMaxThreads = 4;
+        config.blockingIdleExitMs = 200;
+        ASSERT_EQ(scheduler_->Init(config), kZCSuccess);
+    }
+
+    void TearDown() override { scheduler_->UnInit(); }
+
+    std::shared_ptr<ZegoConnectionScheduler> scheduler_ = ZegoConnectionScheduler::GetInstance();
+};
+
+TEST_F(SchedulerTest, PostReturnsTaskIds) {
+    std::set<task_id> ids;
+    Latch latch(200);
+    for (int i = 0; i < 100; i++) {
+        ids.insert(scheduler_->Post([&latch]() { latch.CountDown(); }, JOB_NO_BLOCK));
+        ids.insert(scheduler_->Post([&latch]() { latch.CountDown(); }, JOB_MAYBE_BLOCK));
+    }
+    ASSERT_TRUE(latch.Wait(5000));
+    EXPECT_EQ(ids.size(), 200u);
+    EXPECT_EQ(ids.count(INVALID_TASKID), 0u);
+
+    // The pool hands the scheduler's id through in WorkStealing mode
+    std::shared_ptr<ZegoConnectionThreadPool> pool = ZegoConnectionThreadPool::GetInstance();
+    Latch poolLatch(1);
+    const task_id id = pool->RunTask([&poolLatch]() { poolLatch.CountDown(); }, JOB_NO_BLOCK);
+    EXPECT_NE(id, INVALID_TASKID);
+    EXPECT_EQ(ids.count(id), 0u);
+    ASSERT_TRUE(poolLatch.Wait(5000));
+
+    scheduler_->UnInit();
+    EXPECT_EQ(scheduler_->Post([]() {}, JOB_NO_BLOCK), INVALID_TASKID);
+}
+
+TEST_F(SchedulerTest, BurstFromWorkerWakesParkedWorkers) {
+    // A job on one worker posts a burst into its own queue that only completes once every
+    // worker runs a part of it at the same time. Each round starts with the other workers
+    // parked, so a round finishes quickly only if they are woken for the queued jobs.
+    const int kRounds = 50;
+    int stalled = 0;
+    const Clock::time_point start = Clock::now();
+    for (int round = 0; round < kRounds; round++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        Barrier barrier(kWorkers);
+        Latch latch(kWorkers);
+        std::atomic<int> timedOut{0};
+        auto part = [&]() {
+            if (!barrier.Arrive(2000)) {
+                timedOut.fetch_add(1);
+            }
+            latch.CountDown();
+        };
+        scheduler_->Post(
+            [&]() {
+                for (int i = 1; i < kWorkers; i++) {
+                    scheduler_->Post(part, JOB_NO_BLOCK);
+                }
+                part();
+            },
+            JOB_NO_BLOCK);
+        ASSERT_TRUE(latch.Wait(10000));
+        stalled += timedOut.load() > 0 ? 1 : 0;
+    }
+    const long long elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    EXPECT_EQ(stalled, 0);
+    // A worker woken only by a polling timer would cost a multiple of this
+    EXPECT_LT(elapsedMs, kRounds * 40) << elapsedMs;
+    EXPECT_GT(scheduler_->GetStats().steals, 0u);
+}
+
+TEST_F(SchedulerTest, BlockingJobsDoNotDelayShortJobs) {
+    Latch blocked(8);
+    for (int i = 0; i < 8; i++) {
+        scheduler_->Post(
+            [&blocked]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+                blocked.CountDown();
+            },
+            JOB_MAYBE_BLOCK);
+    }
+    std::atomic<bool> ran{false};
+    EXPECT_TRUE(scheduler_->SyncRun([&ran]() { ran.store(true); }, 200, JOB_NO_BLOCK));
+    EXPECT_TRUE(ran.load());
+
+    ThreadPoolSchedulerStats stats = scheduler_->GetStats();
+    EXPECT_EQ(stats.blocking.peakThreads, 4u);
+    ASSERT_TRUE(blocked.Wait(5000));
+}
+
+TEST_F(SchedulerTest, SyncRunOnWorkerRunsInline) {
+    std::atomic<bool> inline_{false};
+    EXPECT_TRUE(scheduler_->SyncRun(
+        [&]() {
+            const std::thread::id outer = std::this_thread::get_id();
+            // Would wait for itself if it were queued behind the running job on one worker
+            scheduler_->SyncRun([&]() { inline_.store(std::this_thread::get_id() == outer); }, -1,
+                                JOB_NO_BLOCK);
+        },
+        5000, JOB_NO_BLOCK));
+    EXPECT_TRUE(inline_.load());
+}
+
+TEST_F(SchedulerTest, UnInitRunsPostedJobs) {
+    const int kJobs = 5000;
+    std::atomic<int> ran{0};
+    for (int i = 0; i < kJobs; i++) {
+        scheduler_->Post([&ran]() { ran.fetch_add(1); }, i % 2 ? JOB_NO_BLOCK : JOB_MAYBE_BLOCK);
+    }
+    scheduler_->UnInit();
+    EXPECT_EQ(ran.load(), kJobs);
+    EXPECT_FALSE(scheduler_->IsInited());
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+// CZegoSmallJob and CZegoTimerWheel against the std::function and ordered map they replace.
+//
+//   BM_Job/<type>                   Construct, move and run a job capturing 40 bytes, as the
+//                                   retry and heartbeat lambdas do. allocs/op counts heap
+//                                   allocations.
+//   BM_ScheduleCancel/<impl>        Schedule a 500 ms timer and cancel it before it fires, the
+//                                   common case for retries and heartbeats. wheel is
+//                                   CZegoTimerWheel, multimap is std::multimap keyed by deadline
+//                                   holding a std::function, behind a mutex.
+//
+// Usage:
+//   timer_wheel_benchmark [benchmark flags]
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <new>
+
+#include "utility/ZegoTimerWheel.hpp"
+
+using namespace ZEGO::BASE;
+
+namespace {
+
+std::atomic<unsigned long long> gAllocations{0};
+
+} // namespace
+
+// Not inlined, or GCC pairs the free() below with the new expressions it was inlined into and
+// reports a mismatch.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { free(p); }
+
+namespace {
+
+struct Capture {
+    void *owner;
+    long long seq;
+    int retry;
+    int code;
+    double backoff;
+    void *context;
+};
+
+static_assert(sizeof(Capture) == 40, "capture of a typical retry lambda");
+
+template <typename Job> void BM_Job(benchmark::State &state) {
+    Capture capture = {nullptr, 0, 0, 0, 1.5, nullptr};
+    long long sum = 0;
+    unsigned long long allocations = gAllocations.load();
+    for (auto _ : state) {
+        capture.seq++;
+        Job job([capture, &sum]() { sum += capture.seq + capture.retry; });
+        Job moved(std::move(job));
+        moved();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(gAllocations.load() - allocations), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_TEMPLATE(BM_Job, std::function<void()>)->Name("BM_Job/std_function");
+BENCHMARK_TEMPLATE(BM_Job, CZegoSmallJob)->Name("BM_Job/small_job");
+
+// The ordered map the queue runner's delayed jobs used to wait in
+class MultimapTimers {
+  public:
+    typedef std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> Map;
+
+    Map::iterator Schedule(int64_t delayMs, std::function<void()> job) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return timers_.emplace(std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs),
+                               std::move(job));
+    }
+
+    void Cancel(Map::iterator it) {
+        std::function<void()> job;
+        std::lock_guard<std::mutex> lock(mutex_);
+        job = std::move(it->second);
+        timers_.erase(it);
+    }
+
+  private:
+    std::mutex mutex_;
+    Map timers_;
+};
+
+void BM_ScheduleCancelWheel(benchmark::State &state) {
+    CZegoTimerWheel wheel;
+    Capture capture = {nullptr, 0, 0, 0, 1.5, nullptr};
+    // Warm the slab so the steady state is measured
+    for (int i = 0; i < 1024; i++) {
+        wheel.Cancel(wheel.Schedule(500, []() {}));
+    }
+    unsigned long long allocations = gAllocations.load();
+    for (auto _ : state) {
+        capture.seq++;
+        CZegoTimerWheel::TimerID id = wheel.Schedule(500, [capture]() { (void)capture; });
+        wheel.Cancel(id);
+    }
+    state.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(gAllocations.load() - allocations), benchmark::Counter::kAvgIterations);
+}
+
+void BM_ScheduleCancelMultimap(benchmark::State &state) {
+    MultimapTimers timers;
+    Capture capture = {nullptr, 0, 0, 0, 1.5, nullptr};
+    unsigned long long allocations = gAllocations.load();
+    for (auto _ : state) {
+        capture.seq++;
+        timers.Cancel(timers.Schedule(500, [capture]() { (void)capture; }));
+    }
+    state.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(gAllocations.load() - allocations), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ScheduleCancelWheel)->Name("BM_ScheduleCancel/wheel");
+BENCHMARK(BM_ScheduleCancelMultimap)->Name("BM_ScheduleCancel/multimap");
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,208 @@
+// CZegoTimerWheel and CZegoSmallJob (utility/ZegoTimerWheel.hpp, utility/ZegoSmallJob.hpp).
+//
+// Every test runs its own wheel, so timers of one test never fire in another.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "utility/ZegoTimerWheel.hpp"
+
+using namespace ZEGO::BASE;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+int64_t ElapsedMs(Clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - since).count();
+}
+
+template <typename Predicate> bool WaitFor(Predicate predicate, int timeoutMs) {
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(SmallJob, StoresSmallCapturesInline) {
+    int calls = 0;
+    char padding[32] = {0};
+    CZegoSmallJob job([&calls, padding]() { calls += 1 + padding[0]; });
+    EXPECT_TRUE(job.IsInline());
+    CZegoSmallJob moved(std::move(job));
+    EXPECT_FALSE(job);
+    moved();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(SmallJob, MovesLargeCapturesToTheHeap) {
+    int calls = 0;
+    char padding[CZegoSmallJob::kInlineSize] = {0};
+    CZegoSmallJob job([&calls, padding]() { calls += 1 + padding[0]; });
+    EXPECT_FALSE(job.IsInline());
+    job();
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(SmallJob, DestroysCapturesOnReset) {
+    std::shared_ptr<int> owned = std::make_shared<int>(0);
+    CZegoSmallJob job([owned]() {});
+    EXPECT_EQ(owned.use_count(), 2);
+    job.Reset();
+    EXPECT_EQ(owned.use_count(), 1);
+}
+
+// Covers levels 0 to 2: one tick, within the first 64 ticks, within 4096 ticks and beyond
+TEST(TimerWheel, NeverFiresEarly) {
+    CZegoTimerWheel wheel;
+    const int64_t delays[] = {0, 1, 5, 63, 64, 65, 300, 4100};
+    const size_t count = sizeof(delays) / sizeof(delays[0]);
+    std::atomic<int64_t> fired[count];
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < count; i++) {
+        fired[i].store(-1);
+        wheel.Schedule(delays[i], [&fired, i, start]() { fired[i].store(ElapsedMs(start)); });
+    }
+    ASSERT_TRUE(WaitFor(
+        [&]() {
+            for (size_t i = 0; i < count; i++) {
+                if (fired[i].load() < 0) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        10000));
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_GE(fired[i].load(), delays[i]) << "delay " << delays[i];
+        EXPECT_LT(fired[i].load(), delays[i] + 200) << "delay " << delays[i];
+    }
+    EXPECT_EQ(wheel.PendingCount(), 0u);
+}
+
+TEST(TimerWheel, CancelledTimersNeverFire) {
+    // Delays of a second and more, so a slow runner cannot let a timer expire before its Cancel
+    // and every Cancel has to find the timer still pending on level 1
+    CZegoTimerWheel wheel;
+    std::atomic<int> fired{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&wheel, &fired, t]() {
+            for (int i = 0; i < 20000; i++) {
+                CZegoTimerWheel::TimerID id =
+                    wheel.Schedule(1000 + (i + t) % 3000, [&fired]() { fired++; });
+                EXPECT_TRUE(wheel.Cancel(id));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(fired.load(), 0);
+    EXPECT_EQ(wheel.PendingCount(), 0u);
+}
+
+TEST(TimerWheel, StaleIdDoesNotCancelReusedNode) {
+    CZegoTimerWheel wheel;
+    std::atomic<int> fired{0};
+    CZegoTimerWheel::TimerID first = wheel.Schedule(1000, []() {});
+    ASSERT_TRUE(wheel.Cancel(first));
+    CZegoTimerWheel::TimerID second = wheel.Schedule(1, [&fired]() { fired++; });
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(wheel.Cancel(first));
+    ASSERT_TRUE(WaitFor([&]() { return fired.load() == 1; }, 1000));
+    EXPECT_FALSE(wheel.Cancel(second));
+}
+
+TEST(TimerWheel, CancelAllOnlyTouchesItsContext) {
+    CZegoTimerWheel wheel;
+    int a = 0;
+    int b = 0;
+    std::atomic<int> fired{0};
+    auto dispatcher = [](void *, void *target, CZegoSmallJob &&job) {
+        (void)target;
+        job();
+    };
+    for (int i = 0; i < 10; i++) {
+        wheel.Schedule(50, [&fired]() { fired++; }, dispatcher, &a);
+        wheel.Schedule(50, [&fired]() { fired += 100; }, dispatcher, &b);
+    }
+    EXPECT_EQ(wheel.CancelAll(&a), 10u);
+    EXPECT_EQ(wheel.CancelAll(&a), 0u);
+    ASSERT_TRUE(WaitFor([&]() { return fired.load() == 1000; }, 1000));
+}
+
+struct Owner {
+    std::atomic<bool> entered{false};
+    std::atomic<bool> finished{false};
+    std::atomic<int> dispatched{0};
+};
+
+void SlowDispatch(void *context, void *, CZegoSmallJob &&job) {
+    Owner *owner = static_cast<Owner *>(context);
+    owner->dispatched++;
+    owner->entered.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    job();
+    owner->finished.store(true);
+}
+
+// The owner may be destroyed as soon as CancelAll returns, so a dispatch that already started
+// must have returned by then
+TEST(TimerWheel, CancelAllWaitsForDispatchInProgress) {
+    CZegoTimerWheel wheel;
+    std::unique_ptr<Owner> owner(new Owner());
+    wheel.Schedule(1, []() {}, &SlowDispatch, owner.get());
+    ASSERT_TRUE(WaitFor([&]() { return owner->entered.load(); }, 1000));
+    wheel.CancelAll(owner.get());
+    EXPECT_TRUE(owner->finished.load());
+    owner.reset();
+}
+
+// Timers that are due but still queued behind another dispatch are cancelled as well
+TEST(TimerWheel, CancelAllDropsDueTimersNotDispatchedYet) {
+    CZegoTimerWheel wheel;
+    Owner blocker;
+    Owner owner;
+    std::atomic<int> ran{0};
+    wheel.Schedule(20, []() {}, &SlowDispatch, &blocker);
+    wheel.Schedule(20, [&ran]() { ran++; }, &SlowDispatch, &owner);
+    wheel.Schedule(20, [&ran]() { ran++; }, &SlowDispatch, &owner);
+    ASSERT_TRUE(WaitFor([&]() { return blocker.entered.load() || owner.entered.load(); }, 1000));
+    size_t cancelled = wheel.CancelAll(&owner);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    // Depending on which of the three the wheel dispatched first, zero or one of the owner's
+    // timers had started; everything else must have been cancelled
+    EXPECT_EQ(cancelled + owner.dispatched.load(), 2u);
+    EXPECT_EQ(ran.load(), owner.dispatched.load());
+}
+
+TEST(TimerWheel, CancelAllFromItsOwnDispatchDoesNotWaitForItself) {
+    CZegoTimerWheel wheel;
+    std::atomic<bool> done{false};
+    struct Context {
+        CZegoTimerWheel *wheel;
+        std::atomic<bool> *done;
+    } context{&wheel, &done};
+    wheel.Schedule(
+        1, []() {},
+        [](void *, void *target, CZegoSmallJob &&) {
+            Context *context = static_cast<Context *>(target);
+            context->wheel->CancelAll(context);
+            context->done->store(true);
+        },
+        &context, &context);
+    EXPECT_TRUE(WaitFor([&]() { return done.load(); }, 1000));
+}
+
+} // namespace
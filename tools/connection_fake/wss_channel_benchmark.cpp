@@ -0,0 +1,123 @@
+// ZegoConnectionWssChannel per channel mode, over the echoing ZegoConnectionWssManage of
+// zego_connection_wss_fake.cpp, where every frame is a send() and a recv() on an AF_UNIX
+// SOCK_SEQPACKET pair in each direction.
+//
+//   BM_Echo/<mode>                  1000 signalling messages of about 130 bytes, from the first
+//                                   Send until every echo has been delivered through OnRecv.
+//                                   per_message is one SendWssData per message, coalesce merges
+//                                   messages into batch frames, coalesce_deflate also deflates
+//                                   them. items_per_second is messages per second, frames/op the
+//                                   frames per iteration, compression the bytes sent per wire
+//                                   byte.
+//
+// The echo server adds no network latency, so the gap between the modes is per-frame cost
+// alone; on a real link coalescing also saves WebSocket and TLS record overhead per frame.
+//
+// Usage:
+//   wss_channel_benchmark [benchmark flags]
+
+#include <benchmark/benchmark.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zego_connection_wss_channel.hpp"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+const int kMessages = 1000;
+
+std::string Signal(int seq) {
+    return "{\"cmd\":\"stream_update\",\"seq\":" + std::to_string(seq) +
+           ",\"room_id\":\"room-1\",\"user_id\":\"user-" + std::to_string(seq % 50) +
+           "\",\"stream_id\":\"stream-" + std::to_string(seq % 50) + "\",\"state\":1}";
+}
+
+// Counts echoed messages
+class Counter : public IWssChannelCallback {
+  public:
+    void OnConnect(WssInstanceId, uint32 code, const std::string &, bool) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = code == kZCSuccess;
+        cv_.notify_all();
+    }
+
+    void OnClosed(WssInstanceId, uint32, const std::string &) override {}
+
+    void OnRecv(WssInstanceId, const WssBufferView &) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (++received_ == expected_) {
+            cv_.notify_all();
+        }
+    }
+
+    void WaitConnected() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return connected_; });
+    }
+
+    void Expect(size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        received_ = 0;
+        expected_ = count;
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return received_ >= expected_; });
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool connected_ = false;
+    size_t received_ = 0;
+    size_t expected_ = 0;
+};
+
+void BM_Echo(benchmark::State &state, bool coalesce, bool deflate) {
+    WssChannelConfig config;
+    config.coalesce = coalesce;
+    config.deflate = deflate;
+    std::shared_ptr<Counter> counter = std::make_shared<Counter>();
+    std::shared_ptr<ZegoConnectionWssChannel> channel =
+        ZegoConnectionWssChannel::Create(WssInstanceConfig(), config);
+    if (!channel || !channel->Connect(5000, counter)) {
+        state.SkipWithError("connect failed");
+        return;
+    }
+    counter->WaitConnected();
+
+    std::vector<WssBuffer> messages;
+    for (int i = 0; i < kMessages; i++) {
+        messages.push_back(WssBuffer::FromString(Signal(i)));
+    }
+    for (auto _ : state) {
+        counter->Expect(messages.size());
+        for (const WssBuffer &message : messages) {
+            channel->Send(message);
+        }
+        channel->Flush();
+        counter->Wait();
+    }
+
+    WssChannelStats stats = channel->GetStats();
+    state.SetItemsProcessed(static_cast<int64_t>(stats.messagesSent));
+    state.counters["frames/op"] =
+        benchmark::Counter(static_cast<double>(stats.framesSent), benchmark::Counter::kAvgIterations);
+    state.counters["compression"] = stats.SendCompressionRatio();
+    channel->Close();
+}
+
+BENCHMARK_CAPTURE(BM_Echo, per_message, false, false)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Echo, coalesce, true, false)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Echo, coalesce_deflate, true, true)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,289 @@
+// ZegoConnectionWssChannel (zego_connection_wss_channel.hpp) over the echoing
+// ZegoConnectionWssManage of zego_connection_wss_fake.cpp: every frame the channel sends comes
+// back through OnRecv, so sent and received messages can be compared one to one.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_fake.h"
+#include "zego_connection_wss_channel.hpp"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+// A room signalling message of about 130 bytes
+std::string Signal(int seq) {
+    return "{\"cmd\":\"stream_update\",\"seq\":" + std::to_string(seq) +
+           ",\"room_id\":\"room-1\",\"user_id\":\"user-" + std::to_string(seq % 50) +
+           "\",\"stream_id\":\"stream-" + std::to_string(seq % 50) + "\",\"state\":1}";
+}
+
+// Batch frames, which the server has to accept as well, so they are off by default
+WssChannelConfig Batched(bool deflate) {
+    WssChannelConfig config;
+    config.coalesce = true;
+    config.deflate = deflate;
+    return config;
+}
+
+class Recorder : public IWssChannelCallback {
+  public:
+    void OnConnect(WssInstanceId, uint32 code, const std::string &, bool) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = code == kZCSuccess;
+        cv_.notify_all();
+    }
+
+    void OnClosed(WssInstanceId, uint32 code, const std::string &) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closedCode_ = code;
+        closed_ = true;
+        cv_.notify_all();
+    }
+
+    void OnRecv(WssInstanceId, const WssBufferView &view) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        messages_.push_back(view.ToString());
+        if (retain_) {
+            retained_.push_back(view.Retain());
+        }
+        cv_.notify_all();
+    }
+
+    bool WaitConnected() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::seconds(5), [this]() { return connected_; });
+    }
+
+    bool WaitMessages(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::seconds(5),
+                            [this, count]() { return messages_.size() >= count; });
+    }
+
+    bool WaitClosed(uint32 &code) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool closed = cv_.wait_for(lock, std::chrono::seconds(5), [this]() { return closed_; });
+        code = closedCode_;
+        return closed;
+    }
+
+    void SetRetain(bool retain) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retain_ = retain;
+    }
+
+    std::vector<std::string> Messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+    std::vector<WssBuffer> Retained() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return retained_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool connected_ = false;
+    bool closed_ = false;
+    uint32 closedCode_ = 0;
+    bool retain_ = false;
+    std::vector<std::string> messages_;
+    std::vector<WssBuffer> retained_;
+};
+
+class WssChannelTest : public ::testing::Test {
+  protected:
+    void TearDown() override {
+        channel_.reset();
+        FAKE::SetWssConnectFails(false);
+        FAKE::FailWssSends(0);
+        // The reader thread may hold the channel for the last OnRecv and destroy it from there
+        std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (FAKE::WssInstanceCount() != 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(FAKE::WssInstanceCount(), 0u);
+    }
+
+    void Open(const WssChannelConfig &config) {
+        WssInstanceConfig instanceConfig;
+        instanceConfig.url = "wss://echo.local";
+        channel_ = ZegoConnectionWssChannel::Create(instanceConfig, config);
+        ASSERT_TRUE(channel_);
+        ASSERT_TRUE(channel_->Connect(5000, recorder_));
+        ASSERT_TRUE(recorder_->WaitConnected());
+    }
+
+    std::vector<std::string> EchoAll(int count) {
+        std::vector<std::string> sent;
+        for (int i = 0; i < count; i++) {
+            sent.push_back(Signal(i));
+            EXPECT_TRUE(channel_->Send(std::string(sent.back())));
+        }
+        channel_->Flush();
+        EXPECT_TRUE(recorder_->WaitMessages(sent.size()));
+        return sent;
+    }
+
+    std::shared_ptr<Recorder> recorder_ = std::make_shared<Recorder>();
+    std::shared_ptr<ZegoConnectionWssChannel> channel_;
+};
+
+TEST_F(WssChannelTest, FailedConnectStopsTheSendThread) {
+    FAKE::SetWssConnectFails(true);
+    WssInstanceConfig instanceConfig;
+    channel_ = ZegoConnectionWssChannel::Create(instanceConfig, WssChannelConfig());
+    ASSERT_TRUE(channel_);
+    EXPECT_FALSE(channel_->Connect(5000, recorder_));
+    EXPECT_FALSE(channel_->Connect(5000, recorder_));
+    EXPECT_FALSE(channel_->Send(Signal(0)));
+    channel_->Close();
+    // Destroying the channel must not find its coalescing thread still joinable
+    channel_.reset();
+}
+
+TEST_F(WssChannelTest, PerMessageFramesEchoInOrder) {
+    // The defaults send every message as a frame of its own, as servers without batching expect
+    Open(WssChannelConfig());
+    std::vector<std::string> sent = EchoAll(500);
+    EXPECT_EQ(recorder_->Messages(), sent);
+    WssChannelStats stats = channel_->GetStats();
+    EXPECT_EQ(stats.framesSent, 500u);
+    EXPECT_EQ(stats.framesRecv, 500u);
+    EXPECT_EQ(stats.wireBytesSent, stats.bytesSent);
+}
+
+TEST_F(WssChannelTest, CoalescedFramesEchoInOrder) {
+    Open(Batched(false));
+    std::vector<std::string> sent = EchoAll(2000);
+    EXPECT_EQ(recorder_->Messages(), sent);
+    WssChannelStats stats = channel_->GetStats();
+    EXPECT_EQ(stats.messagesSent, 2000u);
+    EXPECT_LT(stats.framesSent, 100u);
+    EXPECT_EQ(stats.messagesRecv, 2000u);
+}
+
+TEST_F(WssChannelTest, DeflatedFramesEchoInOrderAndShrink) {
+    Open(Batched(true));
+    std::vector<std::string> sent = EchoAll(2000);
+    EXPECT_EQ(recorder_->Messages(), sent);
+    WssChannelStats stats = channel_->GetStats();
+    EXPECT_GT(stats.SendCompressionRatio(), 5.0);
+    EXPECT_EQ(stats.bytesRecv, stats.bytesSent);
+    EXPECT_EQ(stats.decodeErrors, 0u);
+}
+
+TEST_F(WssChannelTest, DelayFlushesWithoutAnExplicitFlush) {
+    WssChannelConfig config = Batched(true);
+    config.coalesceDelayMs = 2;
+    Open(config);
+    channel_->Send(Signal(1));
+    channel_->Send(Signal(2));
+    ASSERT_TRUE(recorder_->WaitMessages(2));
+    EXPECT_EQ(channel_->GetStats().framesSent, 1u);
+}
+
+TEST_F(WssChannelTest, ChainsAreSentAsOneMessage) {
+    WssChannelConfig config;
+    config.coalesce = false;
+    config.deflate = false;
+    Open(config);
+    std::shared_ptr<const std::string> body = std::make_shared<const std::string>("--body--");
+    WssBufferChain chain = {WssBuffer::FromString("head:"), WssBuffer(body, 2, 4)};
+    EXPECT_TRUE(channel_->Send(chain));
+    ASSERT_TRUE(recorder_->WaitMessages(1));
+    EXPECT_EQ(recorder_->Messages()[0], "head:body");
+}
+
+TEST_F(WssChannelTest, RetainedViewsOutliveTheCallback) {
+    Open(Batched(true));
+    recorder_->SetRetain(true);
+    std::vector<std::string> sent = EchoAll(300);
+    std::vector<WssBuffer> retained = recorder_->Retained();
+    ASSERT_EQ(retained.size(), sent.size());
+    // Drop the channel and with it the buffer pool; retained messages stay readable
+    channel_.reset();
+    for (size_t i = 0; i < sent.size(); i++) {
+        EXPECT_EQ(std::string(retained[i].Data(), retained[i].Size()), sent[i]);
+    }
+}
+
+TEST_F(WssChannelTest, CorruptBatchFrameDisconnects) {
+    Open(Batched(true));
+    channel_->OnRecv(channel_->GetInstanceId(), std::string("ZW\x01\x01not deflate", 15));
+    uint32 code = 0;
+    ASSERT_TRUE(recorder_->WaitClosed(code));
+    EXPECT_EQ(code, static_cast<uint32>(kZCEAgentTCPNetReportWssDecodeError));
+    EXPECT_EQ(channel_->GetStats().decodeErrors, 1u);
+    EXPECT_FALSE(channel_->Send(Signal(0)));
+}
+
+TEST_F(WssChannelTest, FailedFlushClosesAndCountsTheLostMessages) {
+    // Send already returned true for the queued messages, so the loss is reported through OnClosed
+    Open(Batched(true));
+    FAKE::FailWssSends(1);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(channel_->Send(Signal(i)));
+    }
+    channel_->Flush();
+    uint32 code = 0;
+    ASSERT_TRUE(recorder_->WaitClosed(code));
+    EXPECT_EQ(code, static_cast<uint32>(kZCEAgentTCPWSocketSendFail));
+    WssChannelStats stats = channel_->GetStats();
+    EXPECT_EQ(stats.sendErrors, 1u);
+    EXPECT_EQ(stats.messagesLost, 10u);
+    EXPECT_EQ(stats.messagesSent, 0u);
+    EXPECT_FALSE(channel_->Send(Signal(10)));
+}
+
+TEST_F(WssChannelTest, FailedDeflatedSendCloses) {
+    // The deflate context already holds the lost frame, the peer's inflater could not follow on
+    WssChannelConfig config;
+    config.deflate = true;
+    config.deflateMinBytes = 0;
+    Open(config);
+    FAKE::FailWssSends(1);
+    EXPECT_FALSE(channel_->Send(Signal(0)));
+    uint32 code = 0;
+    ASSERT_TRUE(recorder_->WaitClosed(code));
+    EXPECT_EQ(code, static_cast<uint32>(kZCEAgentTCPWSocketSendFail));
+    EXPECT_EQ(channel_->GetStats().sendErrors, 1u);
+    EXPECT_FALSE(channel_->Send(Signal(1)));
+}
+
+TEST_F(WssChannelTest, FailedPlainSendOnlyReturnsFalse) {
+    // Nothing was queued or compressed: the caller sees the failure and the channel stays usable
+    Open(WssChannelConfig());
+    FAKE::FailWssSends(1);
+    EXPECT_FALSE(channel_->Send(Signal(0)));
+    EXPECT_TRUE(channel_->Send(Signal(1)));
+    ASSERT_TRUE(recorder_->WaitMessages(1));
+    EXPECT_EQ(recorder_->Messages()[0], Signal(1));
+    WssChannelStats stats = channel_->GetStats();
+    EXPECT_EQ(stats.sendErrors, 1u);
+    EXPECT_EQ(stats.messagesLost, 1u);
+    EXPECT_EQ(stats.messagesSent, 1u);
+}
+
+TEST_F(WssChannelTest, CloseDestroysTheInstance) {
+    Open(WssChannelConfig());
+    EXPECT_EQ(FAKE::WssInstanceCount(), 1u);
+    channel_->Send(Signal(0));
+    channel_->Close();
+    EXPECT_EQ(FAKE::WssInstanceCount(), 0u);
+    EXPECT_FALSE(channel_->Send(Signal(1)));
+}
+
+} // namespace
@@ -0,0 +1,202 @@
+// Offline stand-ins for the ZegoConnection library classes, see zego_connection_fake.h.
+
+#include "zego_connection_fake.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_dns.hpp"
+#include "zego_connection_monitor.hpp"
+#include "zego_connection_thread_pool.hpp"
+
+namespace ZEGO {
+namespace CONNECTION {
+
+namespace {
+
+std::atomic<bool> gRejectJobs{false};
+std::atomic<unsigned> gDNSResolveCount{0};
+
+// The default task: one thread running jobs in order
+class Worker {
+  public:
+    Worker() : thread_([this]() { Run(); }) {}
+
+    ~Worker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void Post(ZegoJobRunnable &&job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+  private:
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;
+            }
+            ZegoJobRunnable job = std::move(jobs_.front());
+            jobs_.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<ZegoJobRunnable> jobs_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+Worker &DefaultTask() {
+    static Worker worker;
+    return worker;
+}
+
+struct Monitor {
+    std::mutex mutex;
+    ZegoConnectionNetType type = ZegoConnectionNetType::ZEGO_NT_WIFI;
+    ZCSeq lastSeq = 0;
+    std::map<ZCSeq, OnNetStateChangedDelegate> delegates;
+};
+
+Monitor &TheMonitor() {
+    static Monitor monitor;
+    return monitor;
+}
+
+} // namespace
+
+namespace FAKE {
+
+void SetThreadPoolRejectsJobs(bool reject) { gRejectJobs.store(reject); }
+
+unsigned DNSResolveCount() { return gDNSResolveCount.load(); }
+
+void SetNetType(ZegoConnectionNetType type) {
+    std::vector<OnNetStateChangedDelegate> delegates;
+    {
+        std::lock_guard<std::mutex> lock(TheMonitor().mutex);
+        TheMonitor().type = type;
+        for (const auto &item : TheMonitor().delegates) {
+            delegates.push_back(item.second);
+        }
+    }
+    for (const auto &delegate : delegates) {
+        delegate(type);
+    }
+}
+
+} // namespace FAKE
+
+std::shared_ptr<ZegoConnectionDNS> ZegoConnectionDNS::GetInstance() {
+    static std::shared_ptr<ZegoConnectionDNS> instance(new ZegoConnectionDNS());
+    return instance;
+}
+
+ZegoConnectionDNS::ZegoConnectionDNS() = default;
+
+ZegoConnectionDNS::~ZegoConnectionDNS() = default;
+
+DNSData ZegoConnectionDNS::DNSResolve(const std::string &domain, int32, bool) {
+    gDNSResolveCount++;
+    DNSData data;
+    data.domain = domain;
+    return data;
+}
+
+std::shared_ptr<ZegoConnectionMonitor> ZegoConnectionMonitor::GetInstance() {
+    static std::shared_ptr<ZegoConnectionMonitor> instance(new ZegoConnectionMonitor());
+    return instance;
+}
+
+ZegoConnectionMonitor::ZegoConnectionMonitor() = default;
+
+ZegoConnectionMonitor::~ZegoConnectionMonitor() = default;
+
+ZCSeq ZegoConnectionMonitor::RegisterMonitorDelegate(const OnNetStateChangedDelegate &delegate) {
+    std::lock_guard<std::mutex> lock(TheMonitor().mutex);
+    ZCSeq seq = ++TheMonitor().lastSeq;
+    TheMonitor().delegates[seq] = delegate;
+    return seq;
+}
+
+void ZegoConnectionMonitor::UnRegisterMonitorDelegate(ZCSeq seq) {
+    std::lock_guard<std::mutex> lock(TheMonitor().mutex);
+    TheMonitor().delegates.erase(seq);
+}
+
+ZegoConnectionNetType ZegoConnectionMonitor::GetCurrentNetType() {
+    std::lock_guard<std::mutex> lock(TheMonitor().mutex);
+    return TheMonitor().type;
+}
+
+std::shared_ptr<ZegoConnectionThreadPool> ZegoConnectionThreadPool::GetInstance() {
+    static std::shared_ptr<ZegoConnectionThreadPool> instance(new ZegoConnectionThreadPool());
+    return instance;
+}
+
+ZegoConnectionThreadPool::ZegoConnectionThreadPool() = default;
+
+ZegoConnectionThreadPool::~ZegoConnectionThreadPool() = default;
+
+task_id ZegoConnectionThreadPool::AnsycRunTaskInDefaultTask(ZegoJobRunnable &&job,
+                                                            JOB_RUNNABLE_TYPE) {
+    if (gRejectJobs.load()) {
+        return INVALID_TASKID;
+    }
+    DefaultTask().Post(std::move(job));
+    static std::atomic<task_id> nextId{1};
+    task_id id = nextId.fetch_add(1);
+    return id != INVALID_TASKID ? id : nextId.fetch_add(1);
+}
+
+bool ZegoConnectionThreadPool::SyncRunTaskInDefaultTask(ZegoJobRunnable &&job, int waitMs,
+                                                        JOB_RUNNABLE_TYPE) {
+    if (gRejectJobs.load()) {
+        return false;
+    }
+    struct Done {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+    };
+    std::shared_ptr<Done> done = std::make_shared<Done>();
+    DefaultTask().Post([job, done]() {
+        job();
+        std::lock_guard<std::mutex> lock(done->mutex);
+        done->done = true;
+        done->cv.notify_all();
+    });
+    std::unique_lock<std::mutex> lock(done->mutex);
+    if (waitMs < 0) {
+        done->cv.wait(lock, [&done]() { return done->done; });
+        return true;
+    }
+    return done->cv.wait_for(lock, std::chrono::milliseconds(waitMs),
+                             [&done]() { return done->done; });
+}
+
+} // namespace CONNECTION
+} // namespace ZEGO
@@ -0,0 +1,134 @@
+// Offline stand-ins for the parts of the prebuilt ZegoConnection library that the header-only
+// layers call into, and the hooks tests use to steer them.
+//
+//   aes_fake.cpp                    aes_key_setup and aes_encrypt of utility/aes.h.
+//   leveldb_fake.cpp                The bundled leveldb, kept in memory per path.
+//   zego_connection_fake.cpp        ZegoConnectionDNS, which resolves nothing,
+//                                   ZegoConnectionThreadPool, whose default task is one worker
+//                                   thread, and ZegoConnectionMonitor, whose net type tests set.
+//   zego_json_fake.cpp              ZegoJson over the bundled nlohmann::json.
+//   zego_connection_wss_fake.cpp    ZegoConnectionWssManage, whose instances connect to an
+//                                   in-process server that echoes every frame.
+//   zego_connection_net_detect_fake.cpp
+//                                   ZegoConnectionNetDetect, whose detects answer after the RTT
+//                                   set per edge.
+//   zlogger_fake.cpp                zlogger_fmt and zlogger_write_to, plus CaptureLogger.
+
+#ifndef ZEGO_CONNECTION_FAKE_H
+#define ZEGO_CONNECTION_FAKE_H
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "zego_connection_define.hpp"
+#include "zlogger/zlogger-interface.h"
+
+namespace ZEGO {
+namespace CONNECTION {
+namespace FAKE {
+
+// The next leveldb::DB::Open of |path| fails with Corruption until DestroyDB(path)
+void CorruptLevelDB(const std::string &path);
+
+// The next |count| Puts into the leveldb at |path| fail with IOError
+void FailLevelDBPuts(const std::string &path, int count);
+
+// Get of |key| in the leveldb at |path| fails with Corruption until the key is deleted. Iterators
+// still see the key and its value.
+void MakeLevelDBKeyUnreadable(const std::string &path, const std::string &key);
+
+// Drops the data of every path, as if each test started on a fresh disk
+void DestroyAllLevelDB();
+
+// While set, ZegoConnectionThreadPool::RunTask drops jobs and returns 0, as when the pool is not
+// initialised
+void SetThreadPoolRejectsJobs(bool reject);
+
+// Number of ZegoConnectionDNS::DNSResolve calls so far
+unsigned DNSResolveCount();
+
+// Changes ZegoConnectionMonitor's current net type and calls the registered delegates on the
+// calling thread. Starts as ZEGO_NT_WIFI.
+void SetNetType(ZegoConnectionNetType type);
+
+// While set, ZegoConnectionWssManage::ConnectWssServer deletes the instance and returns false
+void SetWssConnectFails(bool fail);
+
+// The next |count| ZegoConnectionWssManage::SendWssData calls on connected instances send
+// nothing and return false
+void FailWssSends(unsigned count);
+
+// Number of wss instances created and not yet destroyed
+size_t WssInstanceCount();
+
+// Simulates the edge at |ip|:|port|: connects and UDP packets are answered after |rttMs|, every
+// second sample |jitterMs| later, and a |loss| share of them time out. Detects of other targets
+// fail at once.
+void SetEdge(const std::string &ip, uint32 port, uint32 rttMs, uint32 jitterMs = 0, double loss = 0);
+
+// Forgets every edge and resets the detect counters
+void ClearEdges();
+
+// Detects started, and stopped before they called back, since ClearEdges
+unsigned DetectsStarted();
+unsigned DetectsStopped();
+
+// Detects that have neither called back nor been stopped
+size_t DetectsInFlight();
+
+// A zlogger::ILogger that keeps every line written to it, for the deferred logger tests and
+// benchmark. Only level filtering and the write functions do anything.
+class CaptureLogger : public zlogger::ILogger {
+  public:
+    struct Line {
+        std::vector<std::string> tag;
+        zlogger::level_enum level;
+        std::string module;
+        int line;
+        std::string msg;
+    };
+
+    // With |keep| false lines are only counted
+    explicit CaptureLogger(bool keep = true) : keep_(keep) {}
+
+    std::vector<Line> Lines();
+    size_t Count();
+    void Clear();
+
+    void set_level(zlogger::level_enum log_level) override { level_ = log_level; }
+    void set_headinfo(const std::string &) override {}
+    void set_encrypt_key(const std::string &) override {}
+    void set_limitlog_cfg(int64_t) override {}
+    void set_callback_logfull(std::function<void(void)>) override {}
+    zlogger::level_enum level() const override { return level_; }
+    void write(std::vector<std::string> tag, zlogger::level_enum lvl, const char *module, int line,
+               const std::string &msg) override;
+    void write(std::vector<std::string> tag, zlogger::level_enum lvl, const char *module, int line,
+               std::string &&msg) override;
+    void write_raw(zlogger::level_enum lvl, const std::string &msg) override;
+    void write_raw(zlogger::level_enum lvl, std::string &&msg) override;
+    void write_limit(const std::string &, std::vector<std::string> tag, zlogger::level_enum lvl,
+                     const char *module, int line, const std::string &msg) override;
+    void debug_buffer_dump(zlogger::ILogbuffer_ptr, size_t) override {}
+    void flush() override {}
+    void flush_on(zlogger::level_enum) override {}
+    zlogger::level_enum flush_level() const override { return zlogger::level_enum::off; }
+    void change_file(const std::string &) override {}
+    void change_limit(std::size_t, std::size_t) override {}
+    void set_threadname_callback(std::function<std::string(void)>) override {}
+
+  private:
+    const bool keep_;
+    zlogger::level_enum level_ = zlogger::level_enum::debug;
+    std::mutex mutex_;
+    std::vector<Line> lines_;
+    size_t count_ = 0;
+};
+
+} // namespace FAKE
+} // namespace CONNECTION
+} // namespace ZEGO
+
+#endif // ZEGO_CONNECTION_FAKE_H
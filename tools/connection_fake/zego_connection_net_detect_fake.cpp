@@ -0,0 +1,278 @@
+// ZegoConnectionNetDetect against simulated edges, see zego_connection_fake.h.
+//
+// Each ip:port has an RTT, a jitter and a loss rate set through FAKE::SetEdge. A detect completes
+// on one timer thread after its simulated RTT, or after the request timeout when lost; a stopped
+// detect never calls back. Samples alternate between rtt and rtt + jitter, and every
+// 1/loss-th packet or connect is lost, so results are the same on every run.
+
+#include "zego_connection_fake.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "zego_connection_net_detect.hpp"
+
+namespace ZEGO {
+namespace CONNECTION {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Edge {
+    uint32 rttMs = 0;
+    uint32 jitterMs = 0;
+    double loss = 0;
+    uint64 samples = 0;     // packets or connects so far, for jitter and loss
+
+    // Takes the next sample; false when it is lost
+    bool Next(uint32 &rttMs) {
+        uint64 n = samples++;
+        rttMs = this->rttMs + (n % 2 == 1 ? jitterMs : 0);
+        return std::floor((n + 1) * loss) == std::floor(n * loss);
+    }
+};
+
+// Runs jobs at their due time on one thread; a job removed before then never runs
+class Timer {
+  public:
+    Timer() : thread_([this]() { Run(); }) {}
+
+    ~Timer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void Add(ZCSeq seq, uint32 delayMs, std::function<void()> &&job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            due_.emplace(Clock::now() + std::chrono::milliseconds(delayMs), seq);
+            jobs_[seq] = std::move(job);
+        }
+        cv_.notify_all();
+    }
+
+    bool Remove(ZCSeq seq) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return jobs_.erase(seq) != 0;
+    }
+
+    size_t Pending() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return jobs_.size();
+    }
+
+  private:
+    void Run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            if (due_.empty()) {
+                cv_.wait(lock);
+                continue;
+            }
+            if (Clock::now() < due_.begin()->first) {
+                cv_.wait_until(lock, due_.begin()->first);
+                continue;
+            }
+            ZCSeq seq = due_.begin()->second;
+            due_.erase(due_.begin());
+            auto it = jobs_.find(seq);
+            if (it == jobs_.end()) {
+                continue;
+            }
+            std::function<void()> job = std::move(it->second);
+            jobs_.erase(it);
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::multimap<Clock::time_point, ZCSeq> due_;
+    std::map<ZCSeq, std::function<void()>> jobs_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+struct Network {
+    std::mutex mutex;
+    std::map<std::pair<std::string, uint32>, Edge> edges;
+    ZCSeq lastSeq = 0;
+    unsigned started = 0;
+    unsigned stopped = 0;
+};
+
+Network &TheNetwork() {
+    static Network network;
+    return network;
+}
+
+Timer &TheTimer() {
+    static Timer timer;
+    return timer;
+}
+
+uint64 NowMs() {
+    return static_cast<uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count());
+}
+
+// One connect to |ip|:|port|, as TCP and HTTP detects measure
+ZCSeq StartConnect(const std::string &ip, uint32 port, uint32 timeoutMs, const std::string &tag,
+                   const std::function<void(const std::shared_ptr<ZegoNetDetectResult> &)> &delegate) {
+    std::shared_ptr<ZegoNetDetectResult> result = std::make_shared<ZegoNetDetectResult>();
+    result->ip = ip;
+    result->port = port;
+    result->tag = tag;
+    uint32 delayMs = 1;
+    {
+        std::lock_guard<std::mutex> lock(TheNetwork().mutex);
+        result->uSeq = ++TheNetwork().lastSeq;
+        TheNetwork().started++;
+        auto it = TheNetwork().edges.find(std::make_pair(ip, port));
+        uint32 rttMs = 0;
+        if (it == TheNetwork().edges.end()) {
+            result->error = kZCETCPDetectConnectFailed;
+        } else if (!it->second.Next(rttMs) || rttMs >= timeoutMs) {
+            result->error = kZCETCPDetectTimeout;
+            delayMs = timeoutMs;
+        } else {
+            result->consumeTime = rttMs;
+            delayMs = rttMs;
+        }
+    }
+    result->startTime = NowMs();
+    result->finishTime = result->startTime + delayMs;
+    TheTimer().Add(result->uSeq, delayMs, [delegate, result]() { delegate(result); });
+    return result->uSeq;
+}
+
+void StopDetect(ZCSeq seq) {
+    if (TheTimer().Remove(seq)) {
+        std::lock_guard<std::mutex> lock(TheNetwork().mutex);
+        TheNetwork().stopped++;
+    }
+}
+
+} // namespace
+
+namespace FAKE {
+
+void SetEdge(const std::string &ip, uint32 port, uint32 rttMs, uint32 jitterMs, double loss) {
+    std::lock_guard<std::mutex> lock(TheNetwork().mutex);
+    Edge &edge = TheNetwork().edges[std::make_pair(ip, port)];
+    edge.rttMs = rttMs;
+    edge.jitterMs = jitterMs;
+    edge.loss = loss;
+    edge.samples = 0;
+}
+
+void ClearEdges() {
+    std::lock_guard<std::mutex> lock(TheNetwork().mutex);
+    TheNetwork().edges.clear();
+    TheNetwork().started = 0;
+    TheNetwork().stopped = 0;
+}
+
+unsigned DetectsStarted() {
+    std::lock_guard<std::mutex> lock(TheNetwork().mutex);
+    return TheNetwork().started;
+}
+
+unsigned DetectsStopped() {
+    std::lock_guard<std::mutex> lock(TheNetwork().mutex);
+    return TheNetwork().stopped;
+}
+
+size_t DetectsInFlight() { return TheTimer().Pending(); }
+
+} // namespace FAKE
+
+std::shared_ptr<ZegoConnectionNetDetect> ZegoConnectionNetDetect::GetInstance() {
+    static std::shared_ptr<ZegoConnectionNetDetect> instance(new ZegoConnectionNetDetect());
+    return instance;
+}
+
+ZegoConnectionNetDetect::ZegoConnectionNetDetect() = default;
+
+ZegoConnectionNetDetect::~ZegoConnectionNetDetect() = default;
+
+ZCError ZegoConnectionNetDetect::Init() { return kZCSuccess; }
+
+void ZegoConnectionNetDetect::UnInit() {}
+
+void ZegoConnectionNetDetect::SetAppInfo(const ZegoAppInfo &) {}
+
+void ZegoConnectionNetDetect::StopAllDetect() {}
+
+void ZegoConnectionNetDetect::SetReportDetectDelegate(const OnReportDetectDelegate &) {}
+
+ZCSeq ZegoConnectionNetDetect::StartTCPDetect(const ZegoNetDetectRequest &request,
+                                              const OnTCPDetectDelegate &delegate) {
+    return StartConnect(request.target, request.port, request.timeout, "", delegate);
+}
+
+void ZegoConnectionNetDetect::StopTCPDetect(ZCSeq uSeq) { StopDetect(uSeq); }
+
+ZCSeq ZegoConnectionNetDetect::StartHTTPDetect(const ZegoHttpDetectRequest &request,
+                                               const OnHTTPDetectDelegate &delegate) {
+    return StartConnect(request.ip, request.port, request.timeout, request.tag, delegate);
+}
+
+void ZegoConnectionNetDetect::StopHTTPDetect(ZCSeq uSeq) { StopDetect(uSeq); }
+
+// All packets go out together; the detect completes once the last answer is in, or at the
+// timeout when one is lost
+ZCSeq ZegoConnectionNetDetect::StartUDPDetect(const ZegoNetDetectRequest &request,
+                                              const OnUDPDetectDelegate &delegate) {
+    std::shared_ptr<ZegoNetDetectResult> result = std::make_shared<ZegoNetDetectResult>();
+    result->ip = request.target;
+    result->port = request.port;
+    result->startTime = NowMs();
+    uint32 delayMs = 1;
+    {
+        std::lock_guard<std::mutex> lock(TheNetwork().mutex);
+        result->uSeq = ++TheNetwork().lastSeq;
+        TheNetwork().started++;
+        auto it = TheNetwork().edges.find(std::make_pair(request.target, request.port));
+        if (it == TheNetwork().edges.end()) {
+            result->error = kZCEDetectSendDataError;
+        } else {
+            for (size_t i = 0; i < request.config.size(); i++) {
+                ZegoNetDetectDataResultNode node;
+                node.uSendTime = result->startTime;
+                uint32 rttMs = 0;
+                if (it->second.Next(rttMs) && rttMs < request.timeout) {
+                    node.uRecvTime = node.uSendTime + rttMs;
+                    delayMs = std::max(delayMs, rttMs);
+                } else {
+                    node.uCode = kZCETCPDetectTimeout;
+                    delayMs = request.timeout;
+                }
+                result->data.dataDetail.push_back(node);
+            }
+        }
+    }
+    result->finishTime = result->startTime + delayMs;
+    TheTimer().Add(result->uSeq, delayMs, [delegate, result]() { delegate(result); });
+    return result->uSeq;
+}
+
+void ZegoConnectionNetDetect::StopUDPDetect(ZCSeq uSeq) { StopDetect(uSeq); }
+
+} // namespace CONNECTION
+} // namespace ZEGO
@@ -0,0 +1,230 @@
+// ZegoConnectionWssManage against an in-process echo server, see zego_connection_fake.h.
+//
+// A connected instance owns an AF_UNIX SOCK_SEQPACKET socket pair, so every SendWssData is one
+// send() that keeps its frame boundary. An echo thread sends each frame back and a reader thread
+// delivers it through IWssInstanceCallback::OnRecv, the way WssImpl calls back from its own
+// thread.
+
+#include "zego_connection_fake.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_wss.hpp"
+
+namespace ZEGO {
+namespace CONNECTION {
+
+namespace {
+
+const size_t kMaxFrame = 256 * 1024;
+
+std::atomic<bool> gWssConnectFails{false};
+std::atomic<unsigned> gWssSendFailures{0};
+
+struct WssConnection {
+    ~WssConnection() {
+        close(client);
+        close(server);
+    }
+
+    int client = -1;
+    int server = -1;
+    std::atomic<bool> disconnected{false};
+    std::thread echo;
+    std::thread reader;
+};
+
+struct WssInstance {
+    WssInstanceConfig config;
+    std::shared_ptr<WssConnection> connection;
+};
+
+struct WssState {
+    std::mutex mutex;
+    WssInstanceId lastId = WssInstanceInvaildId;
+    std::map<WssInstanceId, WssInstance> instances;
+};
+
+WssState &TheWss() {
+    static WssState state;
+    return state;
+}
+
+void Echo(std::shared_ptr<WssConnection> connection) {
+    std::vector<char> frame(kMaxFrame);
+    while (true) {
+        ssize_t n = recv(connection->server, frame.data(), frame.size(), 0);
+        if (n <= 0 || send(connection->server, frame.data(), static_cast<size_t>(n), MSG_NOSIGNAL) < 0) {
+            return;
+        }
+    }
+}
+
+void Read(std::shared_ptr<WssConnection> connection, WssInstanceId id,
+          std::weak_ptr<IWssInstanceCallback> weakCallback) {
+    if (std::shared_ptr<IWssInstanceCallback> callback = weakCallback.lock()) {
+        callback->OnConnect(id, kZCSuccess, "", true);
+    }
+    std::vector<char> frame(kMaxFrame);
+    while (true) {
+        ssize_t n = recv(connection->client, frame.data(), frame.size(), 0);
+        std::shared_ptr<IWssInstanceCallback> callback = weakCallback.lock();
+        if (n <= 0) {
+            // Closing on our own side is not reported, as with DisConnectWssServer
+            if (callback && !connection->disconnected.load()) {
+                callback->OnClosed(id, kZCSuccess, "closed by server");
+            }
+            return;
+        }
+        if (callback) {
+            callback->OnRecv(id, std::string(frame.data(), static_cast<size_t>(n)));
+        }
+    }
+}
+
+// Stops both threads; a thread cannot join itself, so a disconnect from a callback detaches
+void Disconnect(std::shared_ptr<WssConnection> connection) {
+    if (!connection) {
+        return;
+    }
+    connection->disconnected.store(true);
+    shutdown(connection->client, SHUT_RDWR);
+    shutdown(connection->server, SHUT_RDWR);
+    for (std::thread *thread : {&connection->echo, &connection->reader}) {
+        if (thread->get_id() == std::this_thread::get_id()) {
+            thread->detach();
+        } else if (thread->joinable()) {
+            thread->join();
+        }
+    }
+}
+
+std::shared_ptr<WssConnection> TakeConnection(WssInstanceId id, bool erase) {
+    std::lock_guard<std::mutex> lock(TheWss().mutex);
+    auto it = TheWss().instances.find(id);
+    if (it == TheWss().instances.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<WssConnection> connection = std::move(it->second.connection);
+    if (erase) {
+        TheWss().instances.erase(it);
+    }
+    return connection;
+}
+
+} // namespace
+
+namespace FAKE {
+
+void SetWssConnectFails(bool fail) { gWssConnectFails.store(fail); }
+
+void FailWssSends(unsigned count) { gWssSendFailures.store(count); }
+
+size_t WssInstanceCount() {
+    std::lock_guard<std::mutex> lock(TheWss().mutex);
+    return TheWss().instances.size();
+}
+
+} // namespace FAKE
+
+std::shared_ptr<ZegoConnectionWssManage> ZegoConnectionWssManage::GetInstance() {
+    static std::shared_ptr<ZegoConnectionWssManage> instance(new ZegoConnectionWssManage());
+    return instance;
+}
+
+ZegoConnectionWssManage::ZegoConnectionWssManage() = default;
+
+ZegoConnectionWssManage::~ZegoConnectionWssManage() = default;
+
+ZCError ZegoConnectionWssManage::Init() { return kZCSuccess; }
+
+void ZegoConnectionWssManage::UnInit() {}
+
+void ZegoConnectionWssManage::SetIPStackMode(IPStackMode) {}
+
+void ZegoConnectionWssManage::UpdateLocalTimeOffset(int64) {}
+
+WssInstanceId ZegoConnectionWssManage::CreateWssInstance(const WssInstanceConfig &instance_config) {
+    std::lock_guard<std::mutex> lock(TheWss().mutex);
+    WssInstanceId id = ++TheWss().lastId;
+    TheWss().instances[id].config = instance_config;
+    return id;
+}
+
+void ZegoConnectionWssManage::DestroyWssInstance(WssInstanceId instance_id) {
+    Disconnect(TakeConnection(instance_id, true));
+}
+
+bool ZegoConnectionWssManage::ConnectWssServer(WssInstanceId instance_id, int,
+                                               std::weak_ptr<IWssInstanceCallback> instance_callback) {
+    if (gWssConnectFails.load()) {
+        DestroyWssInstance(instance_id);
+        return false;
+    }
+    std::shared_ptr<WssConnection> connection = std::make_shared<WssConnection>();
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0) {
+        DestroyWssInstance(instance_id);
+        return false;
+    }
+    connection->client = fds[0];
+    connection->server = fds[1];
+    for (int fd : fds) {
+        int size = static_cast<int>(kMaxFrame) * 4;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    }
+
+    std::shared_ptr<WssConnection> previous;
+    {
+        std::lock_guard<std::mutex> lock(TheWss().mutex);
+        auto it = TheWss().instances.find(instance_id);
+        if (it == TheWss().instances.end()) {
+            return false;
+        }
+        previous = std::move(it->second.connection);
+        it->second.connection = connection;
+        // Started under the lock, so a concurrent Destroy only sees joinable threads
+        connection->echo = std::thread(&Echo, connection);
+        connection->reader = std::thread(&Read, connection, instance_id, instance_callback);
+    }
+    Disconnect(previous);
+    return true;
+}
+
+bool ZegoConnectionWssManage::SendWssData(WssInstanceId instance_id, const std::string &send_data) {
+    std::shared_ptr<WssConnection> connection;
+    {
+        std::lock_guard<std::mutex> lock(TheWss().mutex);
+        auto it = TheWss().instances.find(instance_id);
+        if (it == TheWss().instances.end() || !it->second.connection) {
+            return false;
+        }
+        connection = it->second.connection;
+    }
+    if (send_data.size() > kMaxFrame || connection->disconnected.load()) {
+        return false;
+    }
+    unsigned failures = gWssSendFailures.load();
+    while (failures > 0 && !gWssSendFailures.compare_exchange_weak(failures, failures - 1)) {
+    }
+    if (failures > 0) {
+        return false;
+    }
+    return send(connection->client, send_data.data(), send_data.size(), MSG_NOSIGNAL) ==
+           static_cast<ssize_t>(send_data.size());
+}
+
+void ZegoConnectionWssManage::DisConnectWssServer(WssInstanceId instance_id) {
+    Disconnect(TakeConnection(instance_id, false));
+}
+
+} // namespace CONNECTION
+} // namespace ZEGO
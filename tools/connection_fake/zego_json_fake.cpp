@@ -0,0 +1,111 @@
+// ZegoJson on top of the bundled nlohmann::json, see zego_connection_fake.h. Invalid content
+// leaves the json discarded, so IsObject and IsArray are false.
+
+#include "ZegoJson.hpp"
+
+ZegoJson::ZegoJson(const std::string &content)
+    : json_(nlohmann::json::parse(content, nullptr, false)) {}
+
+ZegoJson::ZegoJson(const char *content)
+    : json_(content ? nlohmann::json::parse(content, nullptr, false) : nlohmann::json()) {}
+
+ZegoJson::ZegoJson(const nlohmann::json &json) : json_(json) {}
+
+ZegoJson::~ZegoJson() = default;
+
+std::string ZegoJson::Dump() { return json_.is_discarded() ? std::string() : json_.dump(); }
+
+ZegoJson::operator nlohmann::json() { return json_; }
+
+nlohmann::json &ZegoJson::operator[](const char *key) {
+    if (!json_.is_object()) {
+        json_ = nlohmann::json::object();
+    }
+    return json_[key];
+}
+
+bool ZegoJson::IsObject() const { return json_.is_object(); }
+
+bool ZegoJson::Contains(const char *key) const { return json_.is_object() && json_.contains(key); }
+
+void ZegoJson::Remove(const char *key) {
+    if (json_.is_object()) {
+        json_.erase(key);
+    }
+}
+
+namespace {
+
+const nlohmann::json &Value(const nlohmann::json &json, const nlohmann::json &null, const char *key) {
+    if (key == nullptr) {
+        return json;
+    }
+    if (!json.is_object()) {
+        return null;
+    }
+    auto it = json.find(key);
+    return it == json.end() ? null : *it;
+}
+
+template <typename T> T Number(const nlohmann::json &value) {
+    return value.is_number() ? value.get<T>() : T();
+}
+
+} // namespace
+
+bool ZegoJson::GetBool(const char *key) const {
+    const nlohmann::json &value = Value(json_, null_json_, key);
+    return value.is_boolean() ? value.get<bool>() : false;
+}
+
+int ZegoJson::GetInt32(const char *key) const { return Number<int>(Value(json_, null_json_, key)); }
+
+unsigned int ZegoJson::GetUint32(const char *key) const {
+    return Number<unsigned int>(Value(json_, null_json_, key));
+}
+
+long long ZegoJson::GetInt64(const char *key) const {
+    return Number<long long>(Value(json_, null_json_, key));
+}
+
+unsigned long long ZegoJson::GetUint64(const char *key) const {
+    return Number<unsigned long long>(Value(json_, null_json_, key));
+}
+
+float ZegoJson::GetFloat(const char *key) const { return Number<float>(Value(json_, null_json_, key)); }
+
+double ZegoJson::GetDouble(const char *key) const {
+    return Number<double>(Value(json_, null_json_, key));
+}
+
+std::string ZegoJson::GetString(const char *key) const {
+    const nlohmann::json &value = Value(json_, null_json_, key);
+    return value.is_string() ? value.get<std::string>() : std::string();
+}
+
+ZegoJson ZegoJson::GetObject(const char *key) const {
+    const nlohmann::json &value = Value(json_, null_json_, key);
+    return value.is_object() ? ZegoJson(value) : ZegoJson();
+}
+
+ZegoJson ZegoJson::GetArrayItem(unsigned int index) const {
+    return json_.is_array() && index < json_.size() ? ZegoJson(json_[index]) : ZegoJson();
+}
+
+ZegoJson ZegoJson::GetArray(const char *key) const {
+    const nlohmann::json &value = Value(json_, null_json_, key);
+    return value.is_array() ? ZegoJson(value) : ZegoJson();
+}
+
+void ZegoJson::AppendToArray(const ZegoJson &zego_json) {
+    if (!json_.is_array()) {
+        json_ = nlohmann::json::array();
+    }
+    json_.push_back(zego_json.json_);
+}
+
+bool ZegoJson::IsArray() const { return json_.is_array(); }
+
+unsigned int ZegoJson::GetSize() const {
+    return json_.is_array() || json_.is_object() ? static_cast<unsigned int>(json_.size()) : 0;
+}
@@ -0,0 +1,441 @@
+// The mmap segment logger (zlogger/factory/factory_mmap_segment.h) written through its ILogger
+// and read back with the zlog_decode tool and zlogger::segment::decode_file, with the AES of
+// aes_fake.cpp.
+//
+// The tests write known lines into a temporary directory and check that they decode back one
+// for one: compressed, encrypted with a per-file nonce, split across blocks when longer than a
+// block, recovered from the tail of a writer that died without sealing it, and, when the last
+// block of a segment is cut short or damaged, that every block before it still decodes. The
+// log-full callback has to be free to write to the logger it is called for.
+
+#include <gtest/gtest.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zlogger/factory/factory_mmap_segment.h"
+
+using namespace zlogger::segment;
+
+namespace {
+
+const char *const kKey = "0123456789abcdef";
+
+std::string ReadFile(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void WriteFile(const std::string &path, const std::string &data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+}
+
+std::vector<std::string> ListFiles(const std::string &directory, const char *suffix) {
+    std::vector<std::string> files;
+    if (DIR *dir = opendir(directory.c_str())) {
+        while (struct dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > strlen(suffix) &&
+                name.compare(name.size() - strlen(suffix), strlen(suffix), suffix) == 0) {
+                files.push_back(directory + "/" + name);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// The message part of each decoded line, after "[time][level][thread][tags][module:line] "
+std::vector<std::string> Messages(const std::string &text) {
+    std::vector<std::string> messages;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t start = line.find(":0] ");
+        messages.push_back(start == std::string::npos ? "<bad line> " + line
+                                                      : line.substr(start + 4));
+    }
+    return messages;
+}
+
+// A typical status line of about 110 bytes, different on every call
+std::string Status(int i) {
+    return "stream status room:room-" + std::to_string(i % 7) + " stream:stream-" +
+           std::to_string(i % 13) + " seq:" + std::to_string(i) +
+           " kbps:" + std::to_string(800 + i % 97) + " fps:15 rtt:" + std::to_string(i % 50);
+}
+
+class ZlogSegmentTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        char path[] = "/tmp/zlog_segment_test.XXXXXX";
+        ASSERT_NE(mkdtemp(path), nullptr);
+        dir_ = path;
+    }
+
+    void TearDown() override { EXPECT_EQ(system(("rm -rf " + dir_).c_str()), 0); }
+
+    std::shared_ptr<zlogger::ILogger> Open(const std::string &key, size_t blockSize = 4096,
+                                           size_t segmentSize = 16 * 1024) {
+        return zlogger::factory::sync_logger::mmap_segment(dir_, "sdk", segmentSize, 0, key,
+                                                           blockSize);
+    }
+
+    static void Write(zlogger::ILogger &logger, const std::string &msg) {
+        logger.write({}, zlogger::level_enum::info, "seg", 0, msg);
+    }
+
+    // Runs zlog_decode on a directory, returns its exit code and the decoded text
+    int Decode(const std::string &key, std::string &text, std::string dir = std::string()) {
+        if (dir.empty()) {
+            dir = dir_;
+        }
+        const std::string out = dir_ + "/decoded.log";
+        std::string command = std::string(ZLOG_DECODE) + " -o " + out;
+        if (!key.empty()) {
+            command += " -k " + key;
+        }
+        command += " " + dir + " 2>/dev/null";
+        const int status = system(command.c_str());
+        text = ReadFile(out);
+        unlink(out.c_str());
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    // Decodes one segment file with the library, as zlog_decode does per file
+    static bool DecodeSegment(const std::string &path, const std::string &key, std::string &text,
+                              std::string &error) {
+        uint64_t last = 0;
+        return decode_file(path, key, 1, text, last, error);
+    }
+
+    std::string dir_;
+};
+
+TEST_F(ZlogSegmentTest, AesMatchesFips197) {
+    // FIPS-197 appendix C.1
+    ZEGO::BASE::BYTE key[16];
+    ZEGO::BASE::BYTE in[16];
+    for (int i = 0; i < 16; i++) {
+        key[i] = static_cast<ZEGO::BASE::BYTE>(i);
+        in[i] = static_cast<ZEGO::BASE::BYTE>(i * 0x11);
+    }
+    ZEGO::BASE::AES_WORD schedule[60];
+    ZEGO::BASE::BYTE out[16];
+    ZEGO::BASE::aes_key_setup(key, schedule, 128);
+    ZEGO::BASE::aes_encrypt(in, out, schedule, 128);
+    const unsigned char expected[16] = {0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+                                        0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a};
+    EXPECT_EQ(memcmp(out, expected, sizeof(expected)), 0);
+}
+
+TEST_F(ZlogSegmentTest, CompressRoundTrip) {
+    std::string text;
+    for (int i = 0; i < 500; i++) {
+        text += Status(i) + "\n";
+    }
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(text.data());
+    std::vector<uint8_t> compressed(text.size() + text.size() / 255 + 16);
+    const size_t size = compress(src, text.size(), compressed.data(), compressed.size());
+    ASSERT_GT(size, 0u);
+    EXPECT_LT(size, text.size() / 2);
+
+    std::vector<uint8_t> raw(text.size());
+    ASSERT_TRUE(decompress(compressed.data(), size, raw.data(), raw.size()));
+    EXPECT_EQ(std::string(raw.begin(), raw.end()), text);
+    // A cut off block is refused rather than read past
+    EXPECT_FALSE(decompress(compressed.data(), size / 2, raw.data(), raw.size()));
+
+    // Data that does not compress is stored as is
+    std::vector<uint8_t> noise(4096);
+    uint32_t state = 12345;
+    for (uint8_t &byte : noise) {
+        state = state * 1103515245u + 12345u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    EXPECT_EQ(compress(noise.data(), noise.size(), compressed.data(), compressed.size()), 0u);
+}
+
+TEST_F(ZlogSegmentTest, PlainRoundTrip) {
+    std::vector<std::string> expected;
+    size_t textSize = 0;
+    {
+        std::shared_ptr<zlogger::ILogger> logger = Open("");
+        for (int i = 0; i < 3000; i++) {
+            expected.push_back(Status(i));
+            textSize += expected.back().size();
+            Write(*logger, expected.back());
+        }
+    }
+    // Several blocks in several segments
+    const std::vector<std::string> segments = ListFiles(dir_, ".zseg");
+    ASSERT_GT(segments.size(), 1u);
+    size_t stored = 0;
+    for (const std::string &segment : segments) {
+        stored += ReadFile(segment).size();
+    }
+    EXPECT_LT(stored, textSize / 2);
+
+    std::string text;
+    EXPECT_EQ(Decode("", text), 0);
+    EXPECT_EQ(Messages(text), expected);
+}
+
+TEST_F(ZlogSegmentTest, EncryptedRoundTrip) {
+    std::vector<std::string> expected;
+    {
+        std::shared_ptr<zlogger::ILogger> logger = Open(kKey);
+        for (int i = 0; i < 3000; i++) {
+            expected.push_back(Status(i));
+            Write(*logger, expected.back());
+        }
+    }
+    for (const std::string &file : ListFiles(dir_, ".zseg")) {
+        EXPECT_EQ(ReadFile(file).find("stream status"), std::string::npos) << file;
+    }
+
+    std::string text;
+    EXPECT_EQ(Decode(kKey, text), 0);
+    EXPECT_EQ(Messages(text), expected);
+
+    // Without the key nothing comes out, with a wrong one the blocks do not decompress
+    EXPECT_EQ(Decode("", text), 1);
+    EXPECT_TRUE(text.empty());
+    EXPECT_EQ(Decode("fedcba9876543210", text), 1);
+    EXPECT_EQ(text.find("stream status"), std::string::npos);
+}
+
+TEST_F(ZlogSegmentTest, FilesUseDistinctNonces) {
+    // The same text under the same key before and after change_file: block sequence numbers
+    // restart in the new directory, the nonce keeps the keystreams apart
+    const std::string other = dir_ + "/other";
+    ASSERT_EQ(mkdir(other.c_str(), 0755), 0);
+    const std::string line = Status(1) + "\n";
+    std::shared_ptr<zlogger::ILogger> logger = Open(kKey);
+    logger->write_raw(zlogger::level_enum::info, line);
+    logger->flush();
+    logger->change_file(other + "/sdk");
+    logger->write_raw(zlogger::level_enum::info, line);
+    logger->flush();
+    logger.reset();
+
+    const std::string first = ReadFile(dir_ + "/sdk.000001.zseg");
+    const std::string second = ReadFile(other + "/sdk.000001.zseg");
+    ASSERT_GT(first.size(), kFileHeaderSize + sizeof(block_header));
+    ASSERT_EQ(first.size(), second.size());
+    file_header firstHeader;
+    file_header secondHeader;
+    memcpy(&firstHeader, first.data(), sizeof(firstHeader));
+    memcpy(&secondHeader, second.data(), sizeof(secondHeader));
+    EXPECT_NE(firstHeader.nonce, secondHeader.nonce);
+    block_header firstBlock;
+    block_header secondBlock;
+    memcpy(&firstBlock, first.data() + kFileHeaderSize, sizeof(firstBlock));
+    memcpy(&secondBlock, second.data() + kFileHeaderSize, sizeof(secondBlock));
+    EXPECT_EQ(firstBlock.block_seq, 1u);
+    EXPECT_EQ(secondBlock.block_seq, 1u);
+    ASSERT_EQ(firstBlock.stored_len, secondBlock.stored_len);
+    const size_t payload = kFileHeaderSize + sizeof(block_header);
+    EXPECT_NE(first.compare(payload, firstBlock.stored_len, second, payload,
+                            secondBlock.stored_len),
+              0);
+
+    std::string text;
+    EXPECT_EQ(Decode(kKey, text), 0);
+    EXPECT_EQ(text, line);
+    EXPECT_EQ(Decode(kKey, text, other), 0);
+    EXPECT_EQ(text, line);
+}
+
+TEST_F(ZlogSegmentTest, LinesLongerThanBlock) {
+    const std::string longLine = std::string(5000, 'x') + "-end";
+    const std::vector<std::string> expected = {Status(1), longLine, Status(2), longLine};
+    {
+        std::shared_ptr<zlogger::ILogger> logger = Open(kKey, 1024);
+        for (const std::string &msg : expected) {
+            Write(*logger, msg);
+        }
+    }
+    std::string text;
+    EXPECT_EQ(Decode(kKey, text), 0);
+    EXPECT_EQ(Messages(text), expected);
+}
+
+TEST_F(ZlogSegmentTest, LogFullCallbackRunsWithoutTheLock) {
+    // The callback writes from another thread and waits for it, which only finishes when the
+    // logger is not locked around the callback
+    std::shared_ptr<zlogger::ILogger> logger = Open("");
+    int calls = 0;
+    int blocked = 0;
+    std::atomic<int> written{0};
+    std::vector<std::thread> writers;
+    logger->set_callback_logfull([&]() {
+        const int call = ++calls;
+        writers.emplace_back([&, call]() {
+            Write(*logger, "full " + std::to_string(call));
+            written.fetch_add(1);
+        });
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (written.load() < call && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        blocked += written.load() < call ? 1 : 0;
+    });
+    for (int i = 0; i < 1000; i++) {
+        Write(*logger, Status(i));
+    }
+    // Joined out here, a writer still waiting for the lock would never finish inside the callback
+    for (std::thread &writer : writers) {
+        writer.join();
+    }
+    logger.reset();
+
+    EXPECT_GT(calls, 0);
+    EXPECT_EQ(blocked, 0);
+    std::string text;
+    EXPECT_EQ(Decode("", text), 0);
+    const std::vector<std::string> messages = Messages(text);
+    EXPECT_EQ(std::count(messages.begin(), messages.end(), "full 1"), 1);
+}
+
+TEST_F(ZlogSegmentTest, RecoversTailOfCrashedWriter) {
+    const int kSealed = 200;
+    const int kUnsealed = 20;
+    std::vector<std::string> expected;
+    for (int i = 0; i < kSealed + kUnsealed; i++) {
+        expected.push_back(Status(i));
+    }
+
+    // The child dies without running a destructor: the last lines are only in the tail
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::shared_ptr<zlogger::ILogger> logger = Open(kKey);
+        for (int i = 0; i < kSealed; i++) {
+            Write(*logger, expected[i]);
+        }
+        logger->flush();
+        for (int i = kSealed; i < kSealed + kUnsealed; i++) {
+            Write(*logger, expected[i]);
+        }
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+
+    // zlog_decode reads the tail as well
+    std::string text;
+    EXPECT_EQ(Decode(kKey, text), 0);
+    EXPECT_EQ(Messages(text), expected);
+
+    // The next start seals it into the segment, and it is not decoded twice
+    {
+        std::shared_ptr<zlogger::ILogger> logger = Open(kKey);
+        Write(*logger, "after restart");
+    }
+    expected.push_back("after restart");
+    EXPECT_EQ(Decode(kKey, text), 0);
+    EXPECT_EQ(Messages(text), expected);
+}
+
+class ZlogSegmentDamageTest : public ZlogSegmentTest {
+  protected:
+    // One segment of several blocks. Returns the offset of the last block's header.
+    size_t WriteBlocks(std::vector<std::string> &expected) {
+        std::shared_ptr<zlogger::ILogger> logger = Open(kKey, 4096, 1024 * 1024);
+        for (int i = 0; i < 400; i++) {
+            expected.push_back(Status(i));
+            Write(*logger, expected.back());
+        }
+        logger.reset();
+        const std::string data = ReadFile(Segment());
+        size_t offset = kFileHeaderSize;
+        size_t last = 0;
+        block_header block;
+        while (offset + sizeof(block) <= data.size()) {
+            memcpy(&block, data.data() + offset, sizeof(block));
+            if (block.magic != kBlockMagic) {
+                break;
+            }
+            last = offset;
+            offset += sizeof(block) + ((block.stored_len + 7) & ~7u);
+        }
+        return last;
+    }
+
+    std::string Segment() const { return dir_ + "/sdk.000001.zseg"; }
+
+    // Everything decoded is in order and from the blocks before the damaged one
+    static void ExpectEarlierBlocks(const std::vector<std::string> &decoded,
+                                    const std::vector<std::string> &expected) {
+        ASSERT_GT(decoded.size(), expected.size() / 2);
+        ASSERT_LT(decoded.size(), expected.size());
+        EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), expected.begin()));
+    }
+};
+
+TEST_F(ZlogSegmentDamageTest, TruncatedLastBlock) {
+    std::vector<std::string> expected;
+    const size_t last = WriteBlocks(expected);
+    ASSERT_GT(last, kFileHeaderSize);
+    std::string data = ReadFile(Segment());
+    block_header block;
+    memcpy(&block, data.data() + last, sizeof(block));
+    data.resize(last + sizeof(block) + block.stored_len / 2);
+    WriteFile(Segment(), data);
+
+    std::string text;
+    std::string error;
+    EXPECT_TRUE(DecodeSegment(Segment(), kKey, text, error));
+    EXPECT_EQ(error, "corrupt block " + std::to_string(block.block_seq));
+    ExpectEarlierBlocks(Messages(text), expected);
+
+    // zlog_decode reports the damage but still writes what it could read
+    EXPECT_EQ(Decode(kKey, text), 1);
+    ExpectEarlierBlocks(Messages(text), expected);
+}
+
+TEST_F(ZlogSegmentDamageTest, CorruptLastBlock) {
+    std::vector<std::string> expected;
+    const size_t last = WriteBlocks(expected);
+    ASSERT_GT(last, kFileHeaderSize);
+    std::string data = ReadFile(Segment());
+    data[last + sizeof(block_header) + 10] ^= 0x5A;
+    WriteFile(Segment(), data);
+
+    std::string text;
+    std::string error;
+    EXPECT_TRUE(DecodeSegment(Segment(), kKey, text, error));
+    EXPECT_EQ(error.compare(0, 14, "corrupt block "), 0) << error;
+    ExpectEarlierBlocks(Messages(text), expected);
+
+    // A header cut off mid-way reads as the unwritten end of the segment
+    data.resize(last + sizeof(block_header) / 2);
+    WriteFile(Segment(), data);
+    text.clear();
+    error.clear();
+    EXPECT_TRUE(DecodeSegment(Segment(), kKey, text, error));
+    EXPECT_TRUE(error.empty()) << error;
+    ExpectEarlierBlocks(Messages(text), expected);
+}
+
+} // namespace
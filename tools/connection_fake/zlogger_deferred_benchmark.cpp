@@ -0,0 +1,139 @@
+// The deferred logger (zlogger/zlogger-deferred.h) against the zlog_* write path it sits in
+// front of. Both write into a CaptureLogger of zlogger_fake.cpp that only counts lines, so no
+// file I/O is measured.
+//
+//   BM_Log/write                    zlog_info: zlogger_fmt on the calling thread, the tags built
+//                                   as a std::vector<std::string>, then ILogger::write.
+//   BM_Log/deferred                 zlog_dfr_info: the fmt pointer and the argument values go
+//                                   into the thread's ring, formatting happens on the logger's
+//                                   worker. Every 4096 records the run waits, untimed, for the
+//                                   worker to catch up, so no record is dropped.
+//   BM_Log/deferred_flushed         The same with the wait timed: what the worker sustains.
+//
+// All run with 1 and 4 logging threads. allocs/op counts heap allocations on the logging
+// threads and the worker together; those of the deferred runs are all on the worker, the tag
+// vector ILogger::write takes by value and the copy CaptureLogger makes of the line.
+// dropped/op counts records lost to a full ring.
+//
+// Usage:
+//   zlogger_deferred_benchmark [benchmark flags]
+
+#define __MODULE__ "zlogger_benchmark"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "zego_connection_fake.h"
+#include "zlogger/zlogger-deferred.h"
+#include "zlogger/zlogger-macro.h"
+
+using namespace ZEGO::CONNECTION;
+
+namespace {
+
+std::atomic<unsigned long long> gAllocations{0};
+
+} // namespace
+
+// Counts every allocation of the process. Not inlined, or GCC pairs the free() below with the
+// new expressions it was inlined into and reports a mismatch.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { free(p); }
+
+namespace {
+
+const char *const kRoom = "room-0123456789";
+
+// Shared by the threads of a run; created once, the benchmark threads start together
+std::shared_ptr<zlogger::ILogger> WriteLogger() {
+    static std::shared_ptr<zlogger::ILogger> logger = std::make_shared<FAKE::CaptureLogger>(false);
+    return logger;
+}
+
+std::shared_ptr<zlogger::deferred::logger> DeferredLogger() {
+    static std::shared_ptr<zlogger::deferred::logger> logger =
+        zlogger::factory::deferred_logger::wrap(std::make_shared<FAKE::CaptureLogger>(false),
+                                                1024 * 1024);
+    return logger;
+}
+
+void BM_LogWrite(benchmark::State &state) {
+    std::shared_ptr<zlogger::ILogger> logger = WriteLogger();
+    unsigned int seq = 0;
+    unsigned long long allocations = gAllocations.load();
+    for (auto _ : state) {
+        seq++;
+        zlog_info(logger, (std::vector<std::string>{"room", "login"}),
+                  "login seq:%u code:%d room:%s rtt:%.2f", seq, -1, kRoom, 12.5);
+    }
+    if (state.thread_index() == 0) {
+        state.counters["allocs/op"] =
+            benchmark::Counter(static_cast<double>(gAllocations.load() - allocations),
+                               benchmark::Counter::kAvgIterations);
+    }
+}
+
+// Logs in batches that fit the ring, flushing between them, so no record is dropped. With
+// |timedFlush| the flush is timed as well, which is the throughput of the worker.
+void LogDeferred(benchmark::State &state, bool timedFlush) {
+    const unsigned int kBatch = 4096;
+    std::shared_ptr<zlogger::deferred::logger> logger = DeferredLogger();
+    unsigned int seq = 0;
+    unsigned long long allocations = gAllocations.load();
+    const uint64_t dropped = logger->dropped_count();
+    for (auto _ : state) {
+        if (++seq % kBatch == 0) {
+            if (!timedFlush) {
+                state.PauseTiming();
+            }
+            logger->flush();
+            if (!timedFlush) {
+                state.ResumeTiming();
+            }
+        }
+        zlog_dfr_info(logger, ztag_id("room", "login"), "login seq:%u code:%d room:%s rtt:%.2f",
+                      seq, -1, kRoom, 12.5);
+    }
+    // So allocs/op also covers the worker formatting the last batch
+    logger->flush();
+    if (state.thread_index() == 0) {
+        state.counters["allocs/op"] =
+            benchmark::Counter(static_cast<double>(gAllocations.load() - allocations),
+                               benchmark::Counter::kAvgIterations);
+        state.counters["dropped/op"] =
+            benchmark::Counter(static_cast<double>(logger->dropped_count() - dropped),
+                               benchmark::Counter::kAvgIterations);
+    }
+}
+
+void BM_LogDeferred(benchmark::State &state) { LogDeferred(state, false); }
+
+void BM_LogDeferredFlushed(benchmark::State &state) { LogDeferred(state, true); }
+
+BENCHMARK(BM_LogWrite)->Name("BM_Log/write")->Threads(1)->Threads(4)->UseRealTime();
+BENCHMARK(BM_LogDeferred)->Name("BM_Log/deferred")->Threads(1)->Threads(4)->UseRealTime();
+BENCHMARK(BM_LogDeferredFlushed)
+    ->Name("BM_Log/deferred_flushed")
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
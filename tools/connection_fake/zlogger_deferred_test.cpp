@@ -0,0 +1,342 @@
+// The deferred logger (zlogger/zlogger-deferred.h): record_formatter against vsnprintf,
+// spsc_ring on its own, and the logger writing into the CaptureLogger of
+// zlogger_fake.cpp.
+//
+// The formatter tests encode the arguments the way zlog_dfr does and compare the result with
+// zlogger_fmt for the same format, so every length modifier the formatter rewrites is checked
+// against the C library. The logger tests check per-thread order, drop counting and that the
+// rings of exited threads are drained.
+
+#define __MODULE__ "zlogger_test"
+
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zego_connection_fake.h"
+#include "zlogger/zlogger-deferred.h"
+
+using namespace ZEGO::CONNECTION;
+using namespace zlogger::deferred;
+
+namespace {
+
+// Encodes |args| as zlog_dfr does and formats them
+template <typename... Args> std::string Format(const char *fmt, const Args &...args) {
+    std::vector<uint8_t> buffer(args_size(args...));
+    uint8_t *p = buffer.data();
+    args_write(p, args...);
+    record_formatter formatter;
+    std::string out;
+    formatter.format(fmt, buffer.data(), buffer.data() + buffer.size(), out);
+    return out;
+}
+
+#define EXPECT_LIKE_PRINTF(fmt, ...) \
+    EXPECT_EQ(Format(fmt, ##__VA_ARGS__), zlogger::zlogger_fmt(fmt, ##__VA_ARGS__))
+
+TEST(RecordFormatterTest, IntegersMatchPrintf) {
+    EXPECT_LIKE_PRINTF("%d %i %u %x %X %o %c|", -42, 7, 42u, 255u, 255u, 8u, 'A');
+    EXPECT_LIKE_PRINTF("%5d|%-5d|%05d|%+d|% d|%#x|%#o", 42, 42, 42, 42, 42, 255u, 8u);
+    EXPECT_LIKE_PRINTF("%ld %lu %lld %llu %zu", -5L, 5UL, LLONG_MIN, ULLONG_MAX, sizeof(int));
+    EXPECT_LIKE_PRINTF("%hd %hhu", static_cast<short>(-3), static_cast<unsigned char>(200));
+    EXPECT_LIKE_PRINTF("%d %u", INT_MIN, UINT_MAX);
+    EXPECT_LIKE_PRINTF("%.3d|%8.3d|%-8.3x", 5, -5, 10u);
+}
+
+TEST(RecordFormatterTest, LengthFollowsTheArgument) {
+    // A 64-bit argument under a plain %d is still printed in full
+    EXPECT_EQ(Format("%d", static_cast<int64_t>(1) << 40), "1099511627776");
+    EXPECT_EQ(Format("%x", static_cast<uint64_t>(0xFFFFFFFF00000000ull)), "ffffffff00000000");
+    // And a 32-bit argument under %lld is not read past its end
+    EXPECT_EQ(Format("%lld|%d", 7, 8), "7|8");
+}
+
+TEST(RecordFormatterTest, FloatsMatchPrintf) {
+    EXPECT_LIKE_PRINTF("%f %e %g %a", 3.14159, -2.5e-10, 1e20, 1.0);
+    EXPECT_LIKE_PRINTF("%+08.3f|%-10.2f|%.0f|%#.0f", 3.14159, 2.5, 2.5, 2.0);
+    EXPECT_LIKE_PRINTF("%f %E %G", 1.5f, 1e300, 1e-300);
+}
+
+TEST(RecordFormatterTest, StringsAndPointersMatchPrintf) {
+    const char *null = nullptr;
+    int value = 0;
+    EXPECT_LIKE_PRINTF("[%s] [%10s] [%-10s] [%.3s] [%10.2s]", "room", "room", "room", "room-1",
+                       "room-1");
+    EXPECT_EQ(Format("[%s] [%8s]", null, null), "[(null)] [  (null)]");
+    EXPECT_LIKE_PRINTF("%p", static_cast<void *>(&value));
+    EXPECT_LIKE_PRINTF("100%% done %s", "now");
+    EXPECT_LIKE_PRINTF("no arguments at all");
+}
+
+TEST(RecordFormatterTest, StarWidthAndPrecision) {
+    EXPECT_LIKE_PRINTF("[%*d] [%-*d] [%.*f] [%*.*s]", 6, 42, 6, 42, 2, 3.14159, 8, 3, "room-1");
+    // A negative width left-adjusts
+    EXPECT_LIKE_PRINTF("[%*d]", -6, 42);
+    // A negative precision is taken as if it were missing
+    EXPECT_LIKE_PRINTF("[%.*f] [%.*s] [%.*d]", -1, 1.5, -3, "room", -2, 7);
+    EXPECT_EQ(Format("[%.*f]", -1, 1.5), "[1.500000]");
+}
+
+TEST(RecordFormatterTest, LongestConversionSpec) {
+    // Seven flags, both fields from '*' at their longest, a length modifier: the spec fills
+    // everything the formatter reserved for it. The width does not fit an int, so the C library
+    // rejects it and the conversion prints nothing, but the next one still comes out right.
+    EXPECT_EQ(Format("a%-+ #0-+*.*lldb%d", INT_MIN, INT_MIN, 42LL, 7), "ab7");
+    EXPECT_EQ(Format("a%-+ #0-+*.*lldb%d", INT_MIN, INT_MAX, 42LL, 7), "ab7");
+    // Longer digit runs are cut to six digits, so they cannot overrun the spec either
+    const std::string wide = Format("%-+ #0-+00000000000000000004d|%d", 42, 7);
+    EXPECT_EQ(wide.substr(wide.size() - 2), "|7");
+    EXPECT_LIKE_PRINTF("%+*.*d|%-+*.*d|%#*.*x|", 20, 10, 42, 20, 10, 42, 20, 10, 42u);
+}
+
+TEST(RecordFormatterTest, OutputLongerThanStackBuffer) {
+    EXPECT_LIKE_PRINTF("%300d|%-200s|%.150f", 42, "room", 1.0 / 3);
+    const std::string longString(5000, 'x');
+    // Strings are cut at kMaxStringArg when recorded
+    EXPECT_EQ(Format("%s", longString.c_str()), std::string(kMaxStringArg, 'x'));
+    EXPECT_EQ(Format("%8s", longString.c_str()), std::string(kMaxStringArg, 'x'));
+}
+
+TEST(RecordFormatterTest, MismatchAndMissingArguments) {
+    EXPECT_EQ(Format("%s", 42), "<?>");
+    EXPECT_EQ(Format("%d", "room"), "<?>");
+    EXPECT_EQ(Format("%f", 42), "<?>");
+    EXPECT_EQ(Format("%c", 42LL), "<?>");
+    // The mismatched argument is consumed, the next conversion takes the next one
+    EXPECT_EQ(Format("%s|%d", 1, 2), "<?>|2");
+    EXPECT_EQ(Format("%d %d", 5), "5 <?>");
+    // A '*' without its argument ends the line
+    EXPECT_EQ(Format("a%*d"), "a");
+    // A spec cut off by the end of the format
+    EXPECT_EQ(Format("a%-5", 1), "a");
+}
+
+// A record of |size| bytes carrying |seq| after its size field, as the logger writes them
+void Push(spsc_ring &ring, uint32_t size, uint32_t seq) {
+    uint8_t *p = ring.reserve(size);
+    ASSERT_NE(p, nullptr);
+    memcpy(p, &size, sizeof(size));
+    memcpy(p + sizeof(size), &seq, sizeof(seq));
+    ring.commit();
+}
+
+uint32_t Pop(spsc_ring &ring) {
+    const uint8_t *p = ring.front();
+    if (!p) {
+        return UINT32_MAX;
+    }
+    uint32_t size = 0;
+    uint32_t seq = 0;
+    memcpy(&size, p, sizeof(size));
+    memcpy(&seq, p + sizeof(size), sizeof(seq));
+    ring.pop(size);
+    return seq;
+}
+
+TEST(SpscRingTest, CapacityIsPowerOfTwo) {
+    EXPECT_EQ(spsc_ring(0).capacity(), 1024u);
+    EXPECT_EQ(spsc_ring(1024).capacity(), 1024u);
+    EXPECT_EQ(spsc_ring(1025).capacity(), 2048u);
+    EXPECT_EQ(spsc_ring(64 * 1024 - 8).capacity(), 64u * 1024);
+}
+
+TEST(SpscRingTest, FullUntilPopped) {
+    spsc_ring ring(1024);
+    for (uint32_t i = 0; i < 16; i++) {
+        Push(ring, 64, i);
+    }
+    EXPECT_EQ(ring.pending(), 1024u);
+    EXPECT_EQ(ring.reserve(8), nullptr);
+
+    EXPECT_EQ(Pop(ring), 0u);
+    // Freed by the consumer, so the producer sees it once it reloads the tail
+    Push(ring, 64, 16);
+    EXPECT_EQ(ring.reserve(8), nullptr);
+    for (uint32_t i = 1; i <= 16; i++) {
+        EXPECT_EQ(Pop(ring), i);
+    }
+    EXPECT_EQ(ring.front(), nullptr);
+    EXPECT_EQ(ring.pending(), 0u);
+}
+
+TEST(SpscRingTest, WrapMarkerSkipsTheTail) {
+    spsc_ring ring(1024);
+    for (uint32_t i = 0; i < 5; i++) {
+        Push(ring, 200, i);
+    }
+    for (uint32_t i = 0; i < 5; i++) {
+        EXPECT_EQ(Pop(ring), i);
+    }
+
+    // 24 bytes are left before the end: the record goes to the start behind a wrap marker
+    uint8_t *p = ring.reserve(200);
+    ASSERT_NE(p, nullptr);
+    const uint32_t size = 200;
+    const uint32_t seq = 5;
+    memcpy(p, &size, sizeof(size));
+    memcpy(p + sizeof(size), &seq, sizeof(seq));
+    ring.commit();
+    EXPECT_EQ(ring.pending(), 224u);
+    EXPECT_EQ(ring.front(), p);
+    EXPECT_EQ(Pop(ring), 5u);
+    EXPECT_EQ(ring.pending(), 0u);
+
+    // The skipped tail counts as used: a record that would not fit in front of it is refused
+    spsc_ring small(1024);
+    Push(small, 1000, 0);
+    EXPECT_EQ(Pop(small), 0u);
+    Push(small, 512, 1);
+    EXPECT_EQ(small.reserve(504), nullptr);
+    EXPECT_EQ(Pop(small), 1u);
+}
+
+TEST(SpscRingTest, ProducerAndConsumerThreads) {
+    const uint32_t kRecords = 200000;
+    spsc_ring ring(4096);
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < kRecords;) {
+            // Sizes from 8 to 256, so the wrap point moves around
+            const uint32_t size = 8 + (i % 32) * 8;
+            uint8_t *p = ring.reserve(size);
+            if (!p) {
+                std::this_thread::yield();
+                continue;
+            }
+            memcpy(p, &size, sizeof(size));
+            memcpy(p + sizeof(size), &i, sizeof(i));
+            ring.commit();
+            i++;
+        }
+    });
+    uint32_t next = 0;
+    uint32_t outOfOrder = 0;
+    while (next < kRecords) {
+        const uint32_t seq = Pop(ring);
+        if (seq == UINT32_MAX) {
+            std::this_thread::yield();
+            continue;
+        }
+        outOfOrder += seq != next ? 1 : 0;
+        next = seq + 1;
+    }
+    producer.join();
+    EXPECT_EQ(outOfOrder, 0u);
+    EXPECT_EQ(ring.pending(), 0u);
+}
+
+class DeferredLoggerTest : public ::testing::Test {
+  protected:
+    void SetUp() override { inner_ = std::make_shared<FAKE::CaptureLogger>(); }
+
+    std::shared_ptr<FAKE::CaptureLogger> inner_;
+};
+
+TEST_F(DeferredLoggerTest, WritesFormattedLinesWithTags) {
+    auto logger = zlogger::factory::deferred_logger::wrap(inner_);
+    zlog_dfr_info(logger, ztag_id("room", "login"), "login seq:%u code:%d room:%s", 3u, -1,
+                  "room-1");
+    zlog_dfr_warn(logger, ztag_id(), "no tags %.1f", 0.5);
+    logger->flush();
+
+    const std::vector<FAKE::CaptureLogger::Line> lines = inner_->Lines();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].msg, "login seq:3 code:-1 room:room-1");
+    EXPECT_EQ(lines[0].tag, (std::vector<std::string>{"room", "login"}));
+    EXPECT_EQ(lines[0].level, zlogger::level_enum::info);
+    EXPECT_EQ(lines[0].module, "zlogger_test");
+    EXPECT_GT(lines[0].line, 0);
+    EXPECT_EQ(lines[1].msg, "no tags 0.5");
+    EXPECT_TRUE(lines[1].tag.empty());
+    EXPECT_EQ(lines[1].level, zlogger::level_enum::warn);
+    EXPECT_EQ(logger->pending_bytes(), 0u);
+}
+
+TEST_F(DeferredLoggerTest, FiltersBelowLevel) {
+    inner_->set_level(zlogger::level_enum::info);
+    auto logger = zlogger::factory::deferred_logger::wrap(inner_);
+    zlog_dfr_debug(logger, ztag_id(), "debug %d", 1);
+    zlog_dfr_info(logger, ztag_id(), "info %d", 2);
+    logger->set_level(zlogger::level_enum::err);
+    zlog_dfr_warn(logger, ztag_id(), "warn %d", 3);
+    zlog_dfr_error(logger, ztag_id(), "error %d", 4);
+    logger->flush();
+
+    const std::vector<FAKE::CaptureLogger::Line> lines = inner_->Lines();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].msg, "info 2");
+    EXPECT_EQ(lines[1].msg, "error 4");
+}
+
+TEST_F(DeferredLoggerTest, KeepsOrderPerThread) {
+    const int kThreads = 4;
+    const int kPerThread = 5000;
+    auto logger = zlogger::factory::deferred_logger::wrap(inner_, 1024 * 1024);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < kPerThread; i++) {
+                zlog_dfr_info(logger, ztag_id("order"), "%d %d", t, i);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    logger->flush();
+
+    ASSERT_EQ(logger->dropped_count(), 0u);
+    const std::vector<FAKE::CaptureLogger::Line> lines = inner_->Lines();
+    ASSERT_EQ(lines.size(), static_cast<size_t>(kThreads * kPerThread));
+    std::vector<int> next(kThreads, 0);
+    int outOfOrder = 0;
+    for (const FAKE::CaptureLogger::Line &line : lines) {
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(sscanf(line.msg.c_str(), "%d %d", &t, &i), 2) << line.msg;
+        ASSERT_TRUE(t >= 0 && t < kThreads);
+        outOfOrder += next[t] != i ? 1 : 0;
+        next[t] = i + 1;
+    }
+    EXPECT_EQ(outOfOrder, 0);
+    // The rings of the exited threads are drained and handed back
+    EXPECT_EQ(logger->pending_bytes(), 0u);
+}
+
+TEST_F(DeferredLoggerTest, CountsAndReportsDrops) {
+    const int kRecords = 20000;
+    // The smallest ring and a long interval, so the writer outruns the drain
+    auto logger = zlogger::factory::deferred_logger::wrap(inner_, 1024, 1000);
+    for (int i = 0; i < kRecords; i++) {
+        zlog_dfr_info(logger, ztag_id(), "record %d of %d", i, kRecords);
+    }
+    // Records of more than a quarter of the ring are never written
+    const std::string large(512, 'x');
+    zlog_dfr_info(logger, ztag_id(), "%s", large.c_str());
+    logger->flush();
+
+    const uint64_t dropped = logger->dropped_count();
+    EXPECT_GT(dropped, 0u);
+    size_t written = 0;
+    uint64_t reported = 0;
+    for (const FAKE::CaptureLogger::Line &line : inner_->Lines()) {
+        unsigned long long count = 0;
+        if (sscanf(line.msg.c_str(), "deferred logger dropped %llu records", &count) == 1) {
+            EXPECT_EQ(line.level, zlogger::level_enum::warn);
+            reported += count;
+        } else {
+            written++;
+        }
+    }
+    EXPECT_EQ(written + dropped, static_cast<uint64_t>(kRecords + 1));
+    EXPECT_EQ(reported, dropped);
+}
+
+} // namespace
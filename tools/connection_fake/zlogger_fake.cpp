@@ -0,0 +1,99 @@
+// zlogger_fmt, zlogger_write_to and CaptureLogger, see zego_connection_fake.h.
+
+#include "zego_connection_fake.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <utility>
+
+#include "zlogger/zlogger-macro.h"
+
+namespace zlogger {
+
+std::string zlogger_fmt_va(const char *fmt, va_list args_fmt) {
+    va_list copy;
+    va_copy(copy, args_fmt);
+    char buf[256];
+    int len = vsnprintf(buf, sizeof(buf), fmt, copy);
+    va_end(copy);
+    if (len < 0) {
+        return std::string();
+    }
+    if (static_cast<size_t>(len) < sizeof(buf)) {
+        return std::string(buf, len);
+    }
+    std::string out(len + 1, '\0');
+    vsnprintf(&out[0], out.size(), fmt, args_fmt);
+    out.resize(len);
+    return out;
+}
+
+std::string zlogger_fmt(const char *fmt, ...) {
+    va_list args_fmt;
+    va_start(args_fmt, fmt);
+    std::string ret = zlogger_fmt_va(fmt, args_fmt);
+    va_end(args_fmt);
+    return ret;
+}
+
+} // namespace zlogger
+
+void zlogger_write_to(std::shared_ptr<zlogger::ILogger> logger, std::vector<std::string> tag,
+                      zlogger::level_enum lvl, const char *module, int line,
+                      const std::string &&log) {
+    if (logger && lvl >= logger->level()) {
+        logger->write(std::move(tag), lvl, module, line, log);
+    }
+}
+
+namespace ZEGO {
+namespace CONNECTION {
+namespace FAKE {
+
+std::vector<CaptureLogger::Line> CaptureLogger::Lines() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lines_;
+}
+
+size_t CaptureLogger::Count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+void CaptureLogger::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_.clear();
+    count_ = 0;
+}
+
+void CaptureLogger::write(std::vector<std::string> tag, zlogger::level_enum lvl,
+                          const char *module, int line, const std::string &msg) {
+    write(std::move(tag), lvl, module, line, std::string(msg));
+}
+
+void CaptureLogger::write(std::vector<std::string> tag, zlogger::level_enum lvl,
+                          const char *module, int line, std::string &&msg) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_++;
+    if (keep_) {
+        lines_.push_back(Line{std::move(tag), lvl, module ? module : "", line, std::move(msg)});
+    }
+}
+
+void CaptureLogger::write_raw(zlogger::level_enum lvl, const std::string &msg) {
+    write({}, lvl, "", 0, msg);
+}
+
+void CaptureLogger::write_raw(zlogger::level_enum lvl, std::string &&msg) {
+    write({}, lvl, "", 0, std::move(msg));
+}
+
+void CaptureLogger::write_limit(const std::string &, std::vector<std::string> tag,
+                                zlogger::level_enum lvl, const char *module, int line,
+                                const std::string &msg) {
+    write(std::move(tag), lvl, module, line, msg);
+}
+
+} // namespace FAKE
+} // namespace CONNECTION
+} // namespace ZEGO
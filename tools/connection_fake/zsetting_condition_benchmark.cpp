@@ -0,0 +1,196 @@
+// env_condition_index and setting_snapshot (zsetting/zsetting_condition.h) against the pairwise
+// env_condition::operator== and map copies they replace, on a cloud env list of 8 envs with 32
+// conditions each, 2-4 condition values and a ~1 KB condition_config per condition.
+//
+//   BM_ChangeCheck/<method>         Whether the list from a poll differs from the cached one; the
+//                                   lists are equal, which is the common case and the slowest.
+//                                   operator_eq is cloud_env::operator==, build_index compiles
+//                                   the polled list and compares it with a prebuilt index,
+//                                   prebuilt compares two prebuilt indexes.
+//   BM_Match/<method>               Looks up the config of each of the 256 conditions set through
+//                                   set_env_list. pairwise scans the list with
+//                                   env_condition::operator== per candidate, as matching did
+//                                   before the index; index is env_condition_index::match.
+//   BM_ReadCache/<method>           One read of a 64-entry settings cache. copy is
+//                                   ISetting::local_cache(), snapshot is setting_snapshot.
+//
+// Usage:
+//   zsetting_condition_benchmark [benchmark flags]
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zsetting/zsetting_condition.h"
+
+using namespace zego::zegosetting;
+
+namespace {
+
+const int kEnvs = 8;
+const int kConditionsPerEnv = 32;
+
+std::string Config(int env, int condition) {
+    std::string config = "{\"env\":" + std::to_string(env) +
+                         ",\"condition\":" + std::to_string(condition) + ",\"params\":{";
+    for (int i = 0; config.size() < 1000; i++) {
+        if (i > 0) {
+            config += ",";
+        }
+        config += "\"param_" + std::to_string(i) + "\":{\"enable\":true,\"value\":" +
+                  std::to_string(i * 7 % 100) + ",\"name\":\"n" + std::to_string(i) + "\"}";
+    }
+    return config + "}}";
+}
+
+env_condition Condition(int env, int condition, bool withConfig) {
+    env_condition result;
+    int values = 2 + condition % 3;
+    for (int i = 0; i < values; i++) {
+        result.env_condition_value_list.push_back(
+            {"key_" + std::to_string(i), "value_" + std::to_string(condition * 3 + i)});
+    }
+    if (withConfig) {
+        result.condition_config = Config(env, condition);
+    }
+    return result;
+}
+
+// The cloud env list, or with |withConfig| false the request passed to set_env_list
+std::vector<cloud_env> EnvList(bool withConfig) {
+    std::vector<cloud_env> list;
+    for (int env = 0; env < kEnvs; env++) {
+        cloud_env item;
+        item.env_name = "env_" + std::to_string(env);
+        for (int condition = 0; condition < kConditionsPerEnv; condition++) {
+            item.env_condition_list.push_back(Condition(env, condition, withConfig));
+        }
+        list.push_back(item);
+    }
+    return list;
+}
+
+void BM_ChangeCheckOperatorEq(benchmark::State &state) {
+    std::vector<cloud_env> cached = EnvList(true);
+    std::vector<cloud_env> polled = EnvList(true);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cached == polled);
+    }
+}
+
+void BM_ChangeCheckBuildIndex(benchmark::State &state) {
+    env_condition_index cached(EnvList(true));
+    std::vector<cloud_env> polled = EnvList(true);
+    for (auto _ : state) {
+        env_condition_index index(polled);
+        benchmark::DoNotOptimize(cached.equals(index));
+    }
+}
+
+void BM_ChangeCheckPrebuilt(benchmark::State &state) {
+    env_condition_index cached(EnvList(true));
+    env_condition_index polled(EnvList(true));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cached.equals(polled));
+    }
+}
+
+BENCHMARK(BM_ChangeCheckOperatorEq)->Name("BM_ChangeCheck/operator_eq")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ChangeCheckBuildIndex)->Name("BM_ChangeCheck/build_index")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ChangeCheckPrebuilt)->Name("BM_ChangeCheck/prebuilt")->Unit(benchmark::kMillisecond);
+
+void BM_MatchPairwise(benchmark::State &state) {
+    std::vector<cloud_env> list = EnvList(true);
+    std::vector<cloud_env> request = EnvList(false);
+    for (auto _ : state) {
+        int found = 0;
+        for (const auto &wanted : request) {
+            for (const auto &condition : wanted.env_condition_list) {
+                for (const auto &env : list) {
+                    if (env.env_name != wanted.env_name) {
+                        continue;
+                    }
+                    for (const auto &candidate : env.env_condition_list) {
+                        // operator== needs a config on both sides, the request borrows the
+                        // candidate's the way matching filled it in
+                        env_condition probe = condition;
+                        probe.condition_config = candidate.condition_config;
+                        if (probe == candidate) {
+                            found++;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+void BM_MatchIndex(benchmark::State &state) {
+    env_condition_index index(EnvList(true));
+    std::vector<cloud_env> request = EnvList(false);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.match(request));
+    }
+}
+
+BENCHMARK(BM_MatchPairwise)->Name("BM_Match/pairwise")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MatchIndex)->Name("BM_Match/index")->Unit(benchmark::kMillisecond);
+
+// ISetting holding a settings cache; only local_cache/get_request_kv do anything
+class CachedSetting : public ISetting {
+  public:
+    CachedSetting() {
+        for (int i = 0; i < 64; i++) {
+            cache_["cloud_file_" + std::to_string(i)] = Config(0, i);
+        }
+    }
+    int32_t init(const init_options_t &) override { return 0; }
+    void uninit() override {}
+    void stop_polling() override {}
+    void start_polling() override {}
+    void set_token(const std::string &) override {}
+    void set_userid(const std::string &) override {}
+    void set_request_kv(const std::string &, int32_t) override {}
+    void set_request_kv(const std::string &, uint32_t) override {}
+    void set_request_kv(const std::string &, const std::string &) override {}
+    void set_request_kv(const std::string &, float) override {}
+    void set_env_list(const std::vector<cloud_env> &) override {}
+    std::map<std::string, std::string> get_request_kv() override { return {}; }
+    std::map<std::string, std::string> local_cache() override { return cache_; }
+    std::map<std::string, std::string> local_versions() override { return {}; }
+    std::map<std::string, uint32_t> local_number_versions() override { return {}; }
+    std::map<std::string, cloud_local_config_data> local_cache_v2() override { return {}; }
+    void fetch_bypass(const std::vector<std::string> &, fetch_callback_t, bool,
+                      std::string) override {}
+
+  private:
+    std::map<std::string, std::string> cache_;
+};
+
+void BM_ReadCacheCopy(benchmark::State &state) {
+    ISetting_ptr setting = std::make_shared<CachedSetting>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(setting->local_cache().size());
+    }
+}
+
+void BM_ReadCacheSnapshot(benchmark::State &state) {
+    ISetting_ptr setting = std::make_shared<CachedSetting>();
+    setting_snapshot snapshot;
+    snapshot.refresh(setting);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(snapshot.local_cache()->size());
+    }
+}
+
+BENCHMARK(BM_ReadCacheCopy)->Name("BM_ReadCache/copy");
+BENCHMARK(BM_ReadCacheSnapshot)->Name("BM_ReadCache/snapshot");
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,207 @@
+// compiled_env_condition, env_condition_index and setting_snapshot (zsetting/zsetting_condition.h)
+// against the pairwise env_condition::operator== they replace.
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zsetting/zsetting_condition.h"
+
+using namespace zego::zegosetting;
+
+namespace {
+
+env_condition Condition(const std::vector<std::pair<std::string, std::string>> &values,
+                        const std::string &config) {
+    env_condition condition;
+    for (const auto &value : values) {
+        condition.env_condition_value_list.push_back({value.first, value.second});
+    }
+    condition.condition_config = config;
+    return condition;
+}
+
+cloud_env Env(const std::string &name, const std::vector<env_condition> &conditions) {
+    cloud_env env;
+    env.env_name = name;
+    env.env_condition_list = conditions;
+    return env;
+}
+
+std::vector<cloud_env> CloudEnvList() {
+    return {Env("gpu", {Condition({{"vendor", "qcom"}, {"model", "adreno640"}},
+                                  "{\"hw_decode\":true,\"max_fps\":30}"),
+                        Condition({{"vendor", "arm"}}, "{\"hw_decode\":false}")}),
+            Env("os", {Condition({{"name", "android"}, {"version", "12"}},
+                                 "{\"audio\":{\"aec\":2,\"ns\":1}}")})};
+}
+
+// ISetting whose local_cache/get_request_kv return fixed maps and count calls
+class CountingSetting : public ISetting {
+  public:
+    int32_t init(const init_options_t &) override { return 0; }
+    void uninit() override {}
+    void stop_polling() override {}
+    void start_polling() override {}
+    void set_token(const std::string &) override {}
+    void set_userid(const std::string &) override {}
+    void set_request_kv(const std::string &, int32_t) override {}
+    void set_request_kv(const std::string &, uint32_t) override {}
+    void set_request_kv(const std::string &key, const std::string &value) override {
+        requestKv_[key] = value;
+    }
+    void set_request_kv(const std::string &, float) override {}
+    void set_env_list(const std::vector<cloud_env> &) override {}
+    std::map<std::string, std::string> get_request_kv() override {
+        copies++;
+        return requestKv_;
+    }
+    std::map<std::string, std::string> local_cache() override {
+        copies++;
+        return cache;
+    }
+    std::map<std::string, std::string> local_versions() override { return {}; }
+    std::map<std::string, uint32_t> local_number_versions() override { return {}; }
+    std::map<std::string, cloud_local_config_data> local_cache_v2() override { return {}; }
+    void fetch_bypass(const std::vector<std::string> &, fetch_callback_t, bool,
+                      std::string) override {}
+
+    std::map<std::string, std::string> cache;
+    int copies = 0;
+
+  private:
+    std::map<std::string, std::string> requestKv_;
+};
+
+TEST(CompiledEnvCondition, ValueOrderDoesNotMatter) {
+    env_condition a = Condition({{"vendor", "qcom"}, {"model", "adreno640"}}, "{}");
+    env_condition b = Condition({{"model", "adreno640"}, {"vendor", "qcom"}}, "{}");
+    compiled_env_condition ca = compiled_env_condition::compile("gpu", a);
+    compiled_env_condition cb = compiled_env_condition::compile("gpu", b);
+    EXPECT_EQ(ca.key_hash, cb.key_hash);
+    EXPECT_TRUE(ca.same_condition("gpu", cb.values));
+    EXPECT_FALSE(ca.same_condition("cpu", cb.values));
+}
+
+TEST(CompiledEnvCondition, ConfigHashFollowsJsonEquality) {
+    compiled_env_condition a =
+        compiled_env_condition::compile("x", Condition({}, "{\"a\":1,\"b\":[true,\"s\"]}"));
+    compiled_env_condition b =
+        compiled_env_condition::compile("x", Condition({}, "{ \"b\": [true, \"s\"], \"a\": 1.0 }"));
+    compiled_env_condition c =
+        compiled_env_condition::compile("x", Condition({}, "{\"a\":2,\"b\":[true,\"s\"]}"));
+    ASSERT_TRUE(a.config && b.config && c.config);
+    EXPECT_EQ(*a.config == *b.config, true);
+    EXPECT_EQ(a.config_hash, b.config_hash);
+    EXPECT_TRUE(a.same_config(b));
+    EXPECT_NE(a.config_hash, c.config_hash);
+    EXPECT_FALSE(a.same_config(c));
+}
+
+TEST(CompiledEnvCondition, NonObjectConfigIsNotParsed) {
+    compiled_env_condition empty = compiled_env_condition::compile("x", Condition({}, ""));
+    compiled_env_condition array = compiled_env_condition::compile("x", Condition({}, "[1]"));
+    EXPECT_FALSE(empty.config);
+    EXPECT_FALSE(array.config);
+    EXPECT_FALSE(array.same_config(compiled_env_condition::compile("x", Condition({}, "[ 1 ]"))));
+    EXPECT_TRUE(array.same_config(compiled_env_condition::compile("x", Condition({}, "[1]"))));
+}
+
+TEST(EnvConditionIndex, MatchFindsConfigsForTheRequestedConditions) {
+    env_condition_index index(CloudEnvList());
+    EXPECT_EQ(index.size(), 3u);
+
+    std::vector<cloud_env> request = {
+        Env("os", {Condition({{"version", "12"}, {"name", "android"}}, "")}),
+        Env("gpu", {Condition({{"vendor", "apple"}}, ""), Condition({{"vendor", "arm"}}, "")})};
+    std::vector<const compiled_env_condition *> matched = index.match(request);
+    ASSERT_EQ(matched.size(), 3u);
+    ASSERT_NE(matched[0], nullptr);
+    EXPECT_EQ(matched[0]->config_text, "{\"audio\":{\"aec\":2,\"ns\":1}}");
+    EXPECT_EQ(matched[1], nullptr);
+    ASSERT_NE(matched[2], nullptr);
+    EXPECT_EQ(matched[2]->config_text, "{\"hw_decode\":false}");
+}
+
+TEST(EnvConditionIndex, EnvNameIsPartOfTheKey) {
+    env_condition_index index(CloudEnvList());
+    EXPECT_EQ(index.find("os", {{"vendor", "arm"}}), nullptr);
+    EXPECT_NE(index.find("gpu", {{"vendor", "arm"}}), nullptr);
+}
+
+TEST(EnvConditionIndex, FirstDuplicateWins) {
+    std::vector<cloud_env> list = {Env("gpu", {Condition({{"vendor", "arm"}}, "{\"v\":1}"),
+                                               Condition({{"vendor", "arm"}}, "{\"v\":2}")})};
+    env_condition_index index(list);
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_EQ(index.find("gpu", {{"vendor", "arm"}})->config_text, "{\"v\":1}");
+}
+
+TEST(EnvConditionIndex, EqualsAgreesWithCloudEnvOperatorEq) {
+    std::vector<cloud_env> list = CloudEnvList();
+    std::vector<cloud_env> reformatted = CloudEnvList();
+    reformatted[0].env_condition_list[0].condition_config = "{ \"max_fps\": 30, \"hw_decode\": true }";
+    std::vector<cloud_env> changed = CloudEnvList();
+    changed[1].env_condition_list[0].condition_config = "{\"audio\":{\"aec\":2,\"ns\":2}}";
+
+    EXPECT_TRUE(list == reformatted);
+    EXPECT_TRUE(env_condition_index(list).equals(env_condition_index(reformatted)));
+    EXPECT_FALSE(list == changed);
+    EXPECT_FALSE(env_condition_index(list).equals(env_condition_index(changed)));
+}
+
+TEST(EnvConditionIndex, EqualsIgnoresConditionOrder) {
+    std::vector<cloud_env> list = CloudEnvList();
+    std::vector<cloud_env> reordered = {list[1], list[0]};
+    std::swap(reordered[1].env_condition_list[0], reordered[1].env_condition_list[1]);
+    EXPECT_TRUE(env_condition_index(list).equals(env_condition_index(reordered)));
+
+    std::vector<cloud_env> fewer = {list[0]};
+    EXPECT_FALSE(env_condition_index(list).equals(env_condition_index(fewer)));
+}
+
+TEST(EnvConditionIndex, ClearEmptiesTheIndex) {
+    env_condition_index index(CloudEnvList());
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_EQ(index.find("gpu", {{"vendor", "arm"}}), nullptr);
+    EXPECT_TRUE(index.equals(env_condition_index()));
+}
+
+TEST(SettingSnapshot, ReadersShareOneCopyUntilRefresh) {
+    std::shared_ptr<CountingSetting> setting = std::make_shared<CountingSetting>();
+    setting->cache["RTC"] = "{\"a\":1}";
+    setting->set_request_kv("gpu", "adreno640");
+
+    setting_snapshot snapshot;
+    EXPECT_TRUE(snapshot.local_cache()->empty());
+    snapshot.refresh(setting);
+    EXPECT_EQ(setting->copies, 2);
+
+    setting_snapshot::map_ptr first = snapshot.local_cache();
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(snapshot.local_cache().get(), first.get());
+    }
+    EXPECT_EQ(snapshot.request_kv()->at("gpu"), "adreno640");
+    EXPECT_EQ(setting->copies, 2);
+
+    // A held snapshot keeps its content across refreshes
+    setting->cache["RTC"] = "{\"a\":2}";
+    snapshot.refresh(setting);
+    EXPECT_EQ(first->at("RTC"), "{\"a\":1}");
+    EXPECT_EQ(snapshot.local_cache()->at("RTC"), "{\"a\":2}");
+}
+
+TEST(SettingSnapshot, NullSettingKeepsTheSnapshot) {
+    std::shared_ptr<CountingSetting> setting = std::make_shared<CountingSetting>();
+    setting->cache["RTC"] = "{}";
+    setting_snapshot snapshot;
+    snapshot.refresh(setting);
+    snapshot.refresh(nullptr);
+    EXPECT_EQ(snapshot.local_cache()->size(), 1u);
+}
+
+} // namespace
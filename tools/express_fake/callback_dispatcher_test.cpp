@@ -0,0 +1,243 @@
+// ZegoExpressCallbackDispatcher (internal/ZegoInternalDispatcher.hpp) on its own, driven directly
+// through post() as ZEGO_SWITCH_THREAD_ING does, with its Linux worker thread as the consumer.
+//
+// The tests check that callbacks from several SDK threads run in post order per thread and never
+// on the posting thread, that a full queue blocks or drops according to the overflow policy, and
+// that the callback thread may post into a full queue without waiting for itself.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ZegoExpressSDK.h"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Predicate> bool WaitFor(Predicate predicate, int timeoutMs) {
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Holds the callback thread inside a callback until opened.
+class Gate {
+  public:
+    void enter() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        entered_ = true;
+        changed_.notify_all();
+        changed_.wait(lock, [this]() { return open_; });
+    }
+
+    void waitEntered() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]() { return entered_; });
+    }
+
+    void open() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        changed_.notify_all();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool entered_ = false;
+    bool open_ = false;
+};
+
+class CallbackDispatcherTest : public ::testing::Test {
+  protected:
+    void SetUp() override { configure(8, ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK); }
+
+    void TearDown() override {
+        configure(4096, ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK);
+        flush();
+    }
+
+    static void configure(unsigned int maxQueueDepth, ZegoCallbackOverflowPolicy policy) {
+        ZegoCallbackDispatcherConfig config;
+        config.maxQueueDepth = maxQueueDepth;
+        config.overflowPolicy = policy;
+        oInternalCallbackDispatcher->setConfig(config);
+    }
+
+    // Returns once every callback posted before has run
+    static void flush() {
+        std::atomic<bool> done{false};
+        oInternalCallbackDispatcher->post(nullptr, [&done]() { done.store(true); });
+        ASSERT_TRUE(WaitFor([&]() { return done.load(); }, 10000));
+    }
+
+    // Occupies the callback thread with a gate callback and fills the queue behind it. The
+    // running callback still counts toward the depth, so 7 more fill it.
+    static void fillQueue(Gate &gate, std::vector<int> &ran, std::mutex &ranMutex) {
+        oInternalCallbackDispatcher->post(nullptr, [&gate]() { gate.enter(); });
+        gate.waitEntered();
+        for (int i = 0; i < 7; i++) {
+            oInternalCallbackDispatcher->post(nullptr, [i, &ran, &ranMutex]() {
+                std::lock_guard<std::mutex> lock(ranMutex);
+                ran.push_back(i);
+            });
+        }
+        ASSERT_EQ(oInternalCallbackDispatcher->getStats().queueDepth, 8u);
+    }
+};
+
+TEST_F(CallbackDispatcherTest, KeepsPostOrderPerThreadWhileBlocking) {
+    const int kThreads = 4;
+    const int kPerThread = 2000;
+    const ZegoCallbackDispatcherStats before = oInternalCallbackDispatcher->getStats();
+
+    std::vector<int> next(kThreads, 0);
+    std::atomic<int> outOfOrder{0};
+    std::atomic<int> onPoster{0};
+    std::atomic<int> ran{0};
+    std::vector<std::thread::id> posters(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t]() {
+            posters[t] = std::this_thread::get_id();
+            for (int i = 0; i < kPerThread; i++) {
+                oInternalCallbackDispatcher->post(nullptr, [&, t, i]() {
+                    // Only the callback thread touches next, no lock needed
+                    if (next[t] != i) {
+                        outOfOrder.fetch_add(1);
+                    }
+                    next[t] = i + 1;
+                    if (std::this_thread::get_id() == posters[t]) {
+                        onPoster.fetch_add(1);
+                    }
+                    if (i % 256 == 0) {
+                        // A slow handler now and then, so the queue fills up
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    ran.fetch_add(1);
+                });
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    ASSERT_TRUE(WaitFor([&]() { return ran.load() == kThreads * kPerThread; }, 10000));
+
+    const ZegoCallbackDispatcherStats after = oInternalCallbackDispatcher->getStats();
+    EXPECT_EQ(outOfOrder.load(), 0);
+    EXPECT_EQ(onPoster.load(), 0);
+    EXPECT_GT(after.blockedCount, before.blockedCount);
+    EXPECT_EQ(after.droppedCount, before.droppedCount);
+}
+
+TEST_F(CallbackDispatcherTest, BlockedPostRunsAfterQueuedCallbacks) {
+    Gate gate;
+    std::vector<int> ran;
+    std::mutex ranMutex;
+    fillQueue(gate, ran, ranMutex);
+
+    std::atomic<bool> posted{false};
+    std::thread poster([&]() {
+        oInternalCallbackDispatcher->post(nullptr, [&]() {
+            std::lock_guard<std::mutex> lock(ranMutex);
+            ran.push_back(7);
+        });
+        posted.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(posted.load());
+
+    gate.open();
+    poster.join();
+    flush();
+    std::lock_guard<std::mutex> lock(ranMutex);
+    EXPECT_EQ(ran, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+}
+
+TEST_F(CallbackDispatcherTest, LargerQueueReleasesBlockedPost) {
+    Gate gate;
+    std::vector<int> ran;
+    std::mutex ranMutex;
+    fillQueue(gate, ran, ranMutex);
+
+    std::atomic<bool> posted{false};
+    std::thread poster([&]() {
+        oInternalCallbackDispatcher->post(nullptr, []() {});
+        posted.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(posted.load());
+
+    configure(16, ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK);
+    EXPECT_TRUE(WaitFor([&]() { return posted.load(); }, 5000));
+    gate.open();
+    poster.join();
+    flush();
+    std::lock_guard<std::mutex> lock(ranMutex);
+    EXPECT_EQ(ran.size(), 7u);
+}
+
+TEST_F(CallbackDispatcherTest, DropNewestCountsAndKeepsQueuedOrder) {
+    configure(8, ZEGO_CALLBACK_OVERFLOW_POLICY_DROP_NEWEST);
+    Gate gate;
+    std::vector<int> ran;
+    std::mutex ranMutex;
+    fillQueue(gate, ran, ranMutex);
+
+    const unsigned long long dropped = oInternalCallbackDispatcher->getStats().droppedCount;
+    for (int i = 7; i < 12; i++) {
+        oInternalCallbackDispatcher->post(nullptr, [i, &ran, &ranMutex]() {
+            std::lock_guard<std::mutex> lock(ranMutex);
+            ran.push_back(i);
+        });
+    }
+    EXPECT_EQ(oInternalCallbackDispatcher->getStats().droppedCount, dropped + 5);
+
+    // Or the flush below could be dropped as well
+    configure(8, ZEGO_CALLBACK_OVERFLOW_POLICY_BLOCK);
+    gate.open();
+    flush();
+    std::lock_guard<std::mutex> lock(ranMutex);
+    EXPECT_EQ(ran, (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST_F(CallbackDispatcherTest, CallbackThreadPostsIntoFullQueue) {
+    std::vector<int> ran;
+    std::mutex ranMutex;
+    std::atomic<bool> reposted{false};
+    // The callback thread itself fills the queue past the limit and must not wait for itself
+    oInternalCallbackDispatcher->post(nullptr, [&]() {
+        for (int i = 0; i < 16; i++) {
+            oInternalCallbackDispatcher->post(nullptr, [i, &ran, &ranMutex]() {
+                std::lock_guard<std::mutex> lock(ranMutex);
+                ran.push_back(i);
+            });
+        }
+        reposted.store(true);
+    });
+    ASSERT_TRUE(WaitFor([&]() { return reposted.load(); }, 5000));
+    flush();
+
+    std::lock_guard<std::mutex> lock(ranMutex);
+    std::vector<int> expected;
+    for (int i = 0; i < 16; i++) {
+        expected.push_back(i);
+    }
+    EXPECT_EQ(ran, expected);
+}
+
+} // namespace
@@ -0,0 +1,470 @@
+// Measures the C++ wrapper's callback path against libzego_express_fake.
+//
+// The wrapper is built with ZEGOEXP_EXPLICIT and loads the fake library lazily, so every event
+// takes the same route as with the real SDK: C callback, ZegoInternalCallbackCenter, conversion
+// to the C++ types, the callback dispatcher where the family uses it, and finally the handler.
+// For each callback family:
+//
+//   BM_Latency/<family>             One event at a time, from raising it on the benchmark thread
+//                                   (standing in for an SDK thread) until the handler has run.
+//                                   Reports p50/p99 in microseconds and allocations per event.
+//   BM_Latency/<family>/loaded      The same while every other family runs at the rates of a
+//                                   four party call (kBackgroundRates) on the fake's own thread.
+//   BM_Throughput/<family>/<batch>  Bursts of |batch| events; items_per_second is the sustained
+//                                   callback rate, plus allocations and dispatcher wakeups per
+//                                   event.
+//
+// And for real-time sequential data:
+//
+//   BM_RtsdSend/<completion>/<api>/<count>
+//                                   |count| messages of kRtsdPayloadSize bytes, sent one
+//                                   sendRealTimeSequentialData call each (single) or with one
+//                                   sendRealTimeSequentialDataBatch call (batch), until every
+//                                   sent callback has run. <completion> is async, from the fake's
+//                                   completion thread, or inline, before the send returns.
+//                                   items_per_second is messages per second.
+//
+// sound_level_table is sound_level with ZegoExpressSDK::enableSoundLevelTable, where the
+// callback only updates the table and no handler runs.
+//
+// Usage:
+//   express_callback_benchmark [--fake_library=<path>] [benchmark flags]
+//
+// ZEGO_FAKE_STREAMS, ZEGO_FAKE_SEI_SIZE and ZEGO_FAKE_VIDEO_SIZE shape the events, see
+// zego_express_fake.h. ZEGO_FAKE_RATES is ignored, rates are set per benchmark.
+
+#include <dlfcn.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ZegoExpressSDK.h"
+#include "zego_express_fake.h"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+std::atomic<unsigned long long> gAllocations{0};
+
+} // namespace
+
+// Counts every allocation of the process, the wrapper's included. Not inlined, or GCC pairs the
+// free() below with the new expressions it was inlined into and reports a mismatch.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { free(p); }
+
+namespace {
+
+struct Family {
+    const char *name;
+    zego_fake_event event;
+    bool soundLevelTable;
+};
+
+const Family kFamilies[] = {
+    {"sound_level", zego_fake_event_sound_level, false},
+    {"sound_level_table", zego_fake_event_sound_level, true},
+    {"quality", zego_fake_event_quality, false},
+    {"sei", zego_fake_event_sei, false},
+    {"audio_frame", zego_fake_event_audio_frame, false},
+    {"video_frame", zego_fake_event_video_frame, false},
+    {"room_update", zego_fake_event_room_update, false},
+};
+
+// Callbacks per second of a four party call: sound levels every 100 ms, quality every two
+// seconds, SEI at 15 fps, 10 ms audio frames and 30 fps video per stream.
+const double kBackgroundRates[zego_fake_event_count] = {10, 2, 60, 400, 120, 1};
+
+const unsigned int kRtsdPayloadSize = 64;
+
+struct FakeLibrary {
+    pfnzego_fake_set_config setConfig = nullptr;
+    pfnzego_fake_set_event_rate setEventRate = nullptr;
+    pfnzego_fake_emit emit = nullptr;
+    pfnzego_fake_get_emitted getEmitted = nullptr;
+    pfnzego_fake_set_rtsd_completion setRtsdCompletion = nullptr;
+    pfnzego_fake_get_rtsd_sent getRtsdSent = nullptr;
+};
+
+FakeLibrary gFake;
+
+std::atomic<unsigned long long> gDelivered[zego_fake_event_count];
+
+void deliver(zego_fake_event event) { gDelivered[event].fetch_add(1, std::memory_order_release); }
+
+unsigned long long delivered(zego_fake_event event) {
+    return gDelivered[event].load(std::memory_order_acquire);
+}
+
+std::atomic<unsigned long long> gRtsdDelivered{0};
+std::atomic<unsigned long long> gRtsdFailed{0};
+
+class CountingEventHandler : public IZegoEventHandler {
+  public:
+    void onRemoteSoundLevelUpdate(const std::unordered_map<std::string, float> &) override {
+        deliver(zego_fake_event_sound_level);
+    }
+
+    void onPlayerQualityUpdate(const std::string &, const ZegoPlayStreamQuality &) override {
+        deliver(zego_fake_event_quality);
+    }
+
+    void onPlayerRecvSEI(const std::string &, const unsigned char *, unsigned int) override {
+        deliver(zego_fake_event_sei);
+    }
+
+    void onRoomStreamUpdate(const std::string &, ZegoUpdateType, const std::vector<ZegoStream> &,
+                            const std::string &) override {
+        deliver(zego_fake_event_room_update);
+    }
+};
+
+class CountingAudioDataHandler : public IZegoAudioDataHandler {
+  public:
+    void onPlayerAudioData(const unsigned char *, unsigned int, ZegoAudioFrameParam,
+                           const std::string &) override {
+        deliver(zego_fake_event_audio_frame);
+    }
+};
+
+class CountingVideoRenderHandler : public IZegoCustomVideoRenderHandler {
+  public:
+    void onRemoteVideoFrameRawData(unsigned char **, unsigned int *, ZegoVideoFrameParam,
+                                   const std::string &) override {
+        deliver(zego_fake_event_video_frame);
+    }
+};
+
+// Waits until |target| events of |event| reached their handler. The sound level table has no
+// handler; its callback is done when emit returns.
+void waitDelivered(const Family &family, unsigned long long target) {
+    if (family.soundLevelTable) {
+        return;
+    }
+    while (delivered(family.event) < target) {
+        std::this_thread::yield();
+    }
+}
+
+void setBackground(zego_fake_event except, bool enable) {
+    for (int i = 0; i < zego_fake_event_count; i++) {
+        if (i != except) {
+            gFake.setEventRate(zego_fake_event(i), enable ? kBackgroundRates[i] : 0);
+        }
+    }
+}
+
+double percentile(std::vector<double> &samples, double fraction) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(samples.size() * fraction));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+void BM_Latency(benchmark::State &state, const Family &family, bool loaded) {
+    ZegoExpressSDK::enableSoundLevelTable(family.soundLevelTable);
+    setBackground(family.event, loaded);
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(state.max_iterations));
+    const unsigned long long allocations = gAllocations.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        const unsigned long long target = delivered(family.event) + 1;
+        auto begin = std::chrono::steady_clock::now();
+        if (gFake.emit(family.event, 1) != 1) {
+            state.SkipWithError("event not raised, callback not registered");
+            break;
+        }
+        waitDelivered(family, target);
+        samples.push_back(std::chrono::duration<double, std::micro>(
+                              std::chrono::steady_clock::now() - begin)
+                              .count());
+    }
+    const unsigned long long allocated =
+        gAllocations.load(std::memory_order_relaxed) - allocations;
+
+    setBackground(family.event, false);
+    ZegoExpressSDK::enableSoundLevelTable(false);
+
+    state.counters["p50_us"] = percentile(samples, 0.50);
+    state.counters["p99_us"] = percentile(samples, 0.99);
+    if (!loaded && !samples.empty()) {
+        // The background families allocate too, so this is only meaningful unloaded.
+        state.counters["allocs/event"] = static_cast<double>(allocated) / samples.size();
+    }
+}
+
+void BM_Throughput(benchmark::State &state, const Family &family) {
+    ZegoExpressSDK::enableSoundLevelTable(family.soundLevelTable);
+    const unsigned int batch = static_cast<unsigned int>(state.range(0));
+
+    const unsigned long long allocations = gAllocations.load(std::memory_order_relaxed);
+    const ZegoCallbackDispatcherStats stats = ZegoExpressSDK::getCallbackDispatcherStats();
+    unsigned long long events = 0;
+    for (auto _ : state) {
+        const unsigned long long target = delivered(family.event) + batch;
+        if (gFake.emit(family.event, batch) != batch) {
+            state.SkipWithError("event not raised, callback not registered");
+            break;
+        }
+        waitDelivered(family, target);
+        events += batch;
+    }
+    const unsigned long long allocated =
+        gAllocations.load(std::memory_order_relaxed) - allocations;
+    const ZegoCallbackDispatcherStats after = ZegoExpressSDK::getCallbackDispatcherStats();
+
+    ZegoExpressSDK::enableSoundLevelTable(false);
+
+    state.SetItemsProcessed(static_cast<int64_t>(events));
+    if (events > 0) {
+        state.counters["allocs/event"] = static_cast<double>(allocated) / events;
+        state.counters["wakeups/event"] =
+            static_cast<double>(after.wakeupCount - stats.wakeupCount) / events;
+        state.counters["pool_miss/event"] =
+            static_cast<double>(after.poolMissCount - stats.poolMissCount) / events;
+    }
+}
+
+void BM_RtsdSend(benchmark::State &state, IZegoRealTimeSequentialDataManager *manager,
+                 zego_fake_rtsd_completion completion, bool batched) {
+    gFake.setRtsdCompletion(completion, 0);
+    const unsigned int count = static_cast<unsigned int>(state.range(0));
+    std::vector<unsigned char> payload(kRtsdPayloadSize, 0x5a);
+    std::vector<ZegoRealTimeSequentialDataMessage> messages(count);
+    for (ZegoRealTimeSequentialDataMessage &message : messages) {
+        message.data = payload.data();
+        message.dataLength = kRtsdPayloadSize;
+    }
+    const std::string streamID = "fake-rtsd";
+
+    const unsigned long long allocations = gAllocations.load(std::memory_order_relaxed);
+    const unsigned long long failed = gRtsdFailed.load(std::memory_order_relaxed);
+    unsigned long long sent = 0;
+    for (auto _ : state) {
+        unsigned long long target = gRtsdDelivered.load(std::memory_order_acquire);
+        if (batched) {
+            manager->sendRealTimeSequentialDataBatch(
+                messages.data(), count, streamID, [](int errorCode, unsigned int failedCount) {
+                    if (errorCode != 0) {
+                        gRtsdFailed.fetch_add(failedCount, std::memory_order_relaxed);
+                    }
+                    gRtsdDelivered.fetch_add(1, std::memory_order_release);
+                });
+            target += 1;
+        } else {
+            for (const ZegoRealTimeSequentialDataMessage &message : messages) {
+                manager->sendRealTimeSequentialData(
+                    message.data, message.dataLength, streamID, [](int errorCode) {
+                        if (errorCode != 0) {
+                            gRtsdFailed.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        gRtsdDelivered.fetch_add(1, std::memory_order_release);
+                    });
+            }
+            target += count;
+        }
+        while (gRtsdDelivered.load(std::memory_order_acquire) < target) {
+            std::this_thread::yield();
+        }
+        sent += count;
+    }
+    const unsigned long long allocated =
+        gAllocations.load(std::memory_order_relaxed) - allocations;
+
+    gFake.setRtsdCompletion(zego_fake_rtsd_completion_async, 0);
+
+    if (gRtsdFailed.load(std::memory_order_relaxed) != failed) {
+        state.SkipWithError("sends completed with an error");
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+    if (sent > 0) {
+        state.counters["allocs/message"] = static_cast<double>(allocated) / sent;
+    }
+}
+
+template <typename T> bool resolve(void *library, const char *name, T &function) {
+    function = reinterpret_cast<T>(dlsym(library, name));
+    if (function == nullptr) {
+        fprintf(stderr, "%s not found in the fake library\n", name);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string library = EXPRESS_FAKE_LIBRARY;
+    // Measures the cost of the callback profiler itself
+    ZegoCallbackProfilerConfig profilerConfig;
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        const char *libraryFlag = "--fake_library=";
+        const char *traceFlag = "--trace_file=";
+        if (strncmp(argv[i], libraryFlag, strlen(libraryFlag)) == 0) {
+            library = argv[i] + strlen(libraryFlag);
+        } else if (strcmp(argv[i], "--latency_stats") == 0) {
+            profilerConfig.enableLatencyStats = true;
+        } else if (strncmp(argv[i], traceFlag, strlen(traceFlag)) == 0) {
+            profilerConfig.traceFilePath = argv[i] + strlen(traceFlag);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+
+    ZegoLoadLibraryConfig loadConfig;
+    loadConfig.bindingMode = ZEGO_LIBRARY_BINDING_MODE_LAZY;
+    int error = ZegoExpressSDK::loadLibrary(library, loadConfig);
+    if (error != 0) {
+        fprintf(stderr, "loadLibrary(%s) failed: %d\n", library.c_str(), error);
+        return 1;
+    }
+    // The wrapper holds the library open; this only looks up the control functions.
+    void *handle = dlopen(library.c_str(), RTLD_NOW | RTLD_NOLOAD);
+    if (handle == nullptr || !resolve(handle, "zego_fake_set_config", gFake.setConfig) ||
+        !resolve(handle, "zego_fake_set_event_rate", gFake.setEventRate) ||
+        !resolve(handle, "zego_fake_emit", gFake.emit) ||
+        !resolve(handle, "zego_fake_get_emitted", gFake.getEmitted) ||
+        !resolve(handle, "zego_fake_set_rtsd_completion", gFake.setRtsdCompletion) ||
+        !resolve(handle, "zego_fake_get_rtsd_sent", gFake.getRtsdSent)) {
+        return 1;
+    }
+
+    ZegoEngineProfile profile;
+    profile.appID = 1;
+    profile.scenario = ZEGO_SCENARIO_DEFAULT;
+    auto eventHandler = std::make_shared<CountingEventHandler>();
+    auto audioDataHandler = std::make_shared<CountingAudioDataHandler>();
+    auto videoRenderHandler = std::make_shared<CountingVideoRenderHandler>();
+    IZegoExpressEngine *engine = ZegoExpressSDK::createEngine(profile, eventHandler);
+    if (engine == nullptr) {
+        fprintf(stderr, "createEngine failed\n");
+        return 1;
+    }
+    for (int i = 0; i < zego_fake_event_count; i++) {
+        gFake.setEventRate(zego_fake_event(i), 0);
+    }
+
+    ZegoCustomVideoRenderConfig renderConfig;
+    renderConfig.bufferType = ZEGO_VIDEO_BUFFER_TYPE_RAW_DATA;
+    renderConfig.frameFormatSeries = ZEGO_VIDEO_FRAME_FORMAT_SERIES_YUV;
+    renderConfig.enableEngineRender = false;
+    engine->enableCustomVideoRender(true, &renderConfig);
+    engine->setCustomVideoRenderHandler(videoRenderHandler);
+    engine->setAudioDataHandler(audioDataHandler);
+    ZegoAudioFrameParam audioParam;
+    audioParam.sampleRate = ZEGO_AUDIO_SAMPLE_RATE_48K;
+    audioParam.channel = ZEGO_AUDIO_CHANNEL_STEREO;
+    engine->startAudioDataObserver(ZEGO_AUDIO_DATA_CALLBACK_BIT_MASK_PLAYER, audioParam);
+    engine->startSoundLevelMonitor(100);
+    engine->loginRoom("fake-room", ZegoUser("benchmark", "benchmark"));
+    IZegoRealTimeSequentialDataManager *rtsdManager =
+        engine->createRealTimeSequentialDataManager("fake-room");
+    rtsdManager->startBroadcasting("fake-rtsd");
+
+    ZegoExpressSDK::setCallbackProfilerConfig(profilerConfig);
+
+    ZegoLibraryLoadReport report = ZegoExpressSDK::getLibraryLoadReport();
+    benchmark::AddCustomContext("fake_library", library);
+    benchmark::AddCustomContext("latency_stats", profilerConfig.enableLatencyStats ? "on" : "off");
+    benchmark::AddCustomContext("trace_file", profilerConfig.traceFilePath);
+    benchmark::AddCustomContext("resolved_symbols", std::to_string(report.resolvedSymbolCount) +
+                                                        "/" +
+                                                        std::to_string(report.totalSymbolCount));
+
+    for (const Family &family : kFamilies) {
+        std::string name = family.name;
+        benchmark::RegisterBenchmark(("BM_Latency/" + name).c_str(), BM_Latency, family, false)
+            ->UseRealTime();
+        benchmark::RegisterBenchmark(("BM_Latency/" + name + "/loaded").c_str(), BM_Latency,
+                                     family, true)
+            ->UseRealTime();
+        benchmark::RegisterBenchmark(("BM_Throughput/" + name).c_str(), BM_Throughput, family)
+            ->Arg(1)
+            ->Arg(64)
+            ->UseRealTime();
+    }
+    const struct {
+        const char *name;
+        zego_fake_rtsd_completion completion;
+    } rtsdCompletions[] = {{"async", zego_fake_rtsd_completion_async},
+                           {"inline", zego_fake_rtsd_completion_inline}};
+    for (const auto &completion : rtsdCompletions) {
+        for (bool batched : {false, true}) {
+            std::string name = std::string("BM_RtsdSend/") + completion.name +
+                               (batched ? "/batch" : "/single");
+            benchmark::RegisterBenchmark(name.c_str(), BM_RtsdSend, rtsdManager,
+                                         completion.completion, batched)
+                ->Arg(1)
+                ->Arg(64)
+                ->Arg(1024)
+                ->UseRealTime();
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    if (profilerConfig.enableLatencyStats) {
+        printf("\n%-44s %10s %10s %10s %10s %10s\n", "callback", "count", "queue p50",
+               "queue p99", "run p50", "run p99");
+        for (const ZegoCallbackLatencyStats &stats : ZegoExpressSDK::getCallbackLatencyStats()) {
+            printf("%-44s %10llu %8.2fus %8.2fus %8.2fus %8.2fus\n", stats.callbackName.c_str(),
+                   stats.count, stats.queueDelay.p50, stats.queueDelay.p99,
+                   stats.handlerRuntime.p50, stats.handlerRuntime.p99);
+        }
+    }
+    // Completes the trace file
+    ZegoExpressSDK::setCallbackProfilerConfig(ZegoCallbackProfilerConfig());
+
+    rtsdManager->stopBroadcasting("fake-rtsd");
+    engine->destroyRealTimeSequentialDataManager(rtsdManager);
+
+    std::mutex mutex;
+    std::condition_variable destroyed;
+    bool done = false;
+    ZegoExpressSDK::destroyEngine(engine, [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        destroyed.notify_one();
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        destroyed.wait(lock, [&]() { return done; });
+    }
+    dlclose(handle);
+    ZegoExpressSDK::unLoadLibrary();
+    return 0;
+}
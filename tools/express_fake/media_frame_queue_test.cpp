@@ -0,0 +1,411 @@
+// ZegoMediaFrameQueue (internal/ZegoInternalMediaFrameQueue.hpp) on its own, and behind the
+// media player's setFrameDeliveryConfig and getFrameDeliveryStats with frames fed in as the C
+// callbacks do. No library is loaded, the player's calls into it fail harmlessly.
+//
+// The tests hold the consumer in its sink to fill the ring, then check which frames each drop
+// policy keeps, that stop() discards what is queued and returns only once the consumer thread is
+// done, that the delivered, dropped and late counters match what the sink saw, and that no frame
+// is delivered twice. The C callbacks of the callback center reach a player only while it is
+// registered there.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ZegoExpressSDK.h"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+typedef ZegoMediaFrameQueue<ZegoQueuedAudioFrame> Queue;
+typedef std::chrono::steady_clock Clock;
+
+template <typename Predicate> bool WaitFor(Predicate predicate, int timeoutMs) {
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Sink recording the frame ids it got, optionally held at the first frame until released
+class Sink {
+  public:
+    explicit Sink(bool hold) : held_(hold) {}
+
+    void operator()(ZegoQueuedAudioFrame &frame) {
+        int id = -1;
+        if (frame.data.size() == sizeof(id)) {
+            memcpy(&id, frame.data.data(), sizeof(id));
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        ids_.push_back(id);
+        cv_.notify_all();
+        cv_.wait(lock, [this]() { return !held_; });
+        returned_++;
+    }
+
+    // Waits until the sink is called with |count| frames in total
+    bool waitCalls(size_t count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, std::chrono::seconds(5), [&]() { return ids_.size() >= count; });
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = false;
+        cv_.notify_all();
+    }
+
+    std::vector<int> ids() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ids_;
+    }
+
+    size_t returned() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return returned_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool held_;
+    std::vector<int> ids_;
+    size_t returned_ = 0;
+};
+
+std::shared_ptr<Queue> MakeQueue(unsigned int capacity, ZegoMediaPlayerFrameDropPolicy policy,
+                                 unsigned int lateThresholdMs, std::shared_ptr<Sink> sink) {
+    auto queue = std::make_shared<Queue>(capacity, policy, lateThresholdMs,
+                                         [sink](ZegoQueuedAudioFrame &frame) { (*sink)(frame); });
+    queue->start();
+    return queue;
+}
+
+void Push(Queue &queue, int id) {
+    queue.push([id](ZegoQueuedAudioFrame &frame) {
+        frame.data.resize(sizeof(id));
+        memcpy(frame.data.data(), &id, sizeof(id));
+    });
+}
+
+// Frame 0 is taken by the held sink, 1 to |pushed| - 1 go into a ring of |capacity|
+void FillWhileHeld(Queue &queue, Sink &sink, int pushed) {
+    Push(queue, 0);
+    ASSERT_TRUE(sink.waitCalls(1));
+    for (int id = 1; id < pushed; id++) {
+        Push(queue, id);
+    }
+}
+
+TEST(MediaFrameQueueTest, DropOldestKeepsTheNewestFrames) {
+    auto sink = std::make_shared<Sink>(true);
+    auto queue = MakeQueue(3, ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_OLDEST, 0, sink);
+    FillWhileHeld(*queue, *sink, 6);
+    EXPECT_EQ(queue->droppedCount(), 2u);
+    sink->release();
+    ASSERT_TRUE(sink->waitCalls(4));
+    ASSERT_TRUE(WaitFor([&]() { return queue->deliveredCount() == 4; }, 5000));
+    queue->stop();
+    EXPECT_EQ(sink->ids(), (std::vector<int>{0, 3, 4, 5}));
+    EXPECT_EQ(queue->droppedCount(), 2u);
+}
+
+TEST(MediaFrameQueueTest, DropNewestKeepsTheQueuedFrames) {
+    auto sink = std::make_shared<Sink>(true);
+    auto queue = MakeQueue(3, ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_NEWEST, 0, sink);
+    FillWhileHeld(*queue, *sink, 6);
+    EXPECT_EQ(queue->droppedCount(), 2u);
+    sink->release();
+    ASSERT_TRUE(sink->waitCalls(4));
+    ASSERT_TRUE(WaitFor([&]() { return queue->deliveredCount() == 4; }, 5000));
+    queue->stop();
+    EXPECT_EQ(sink->ids(), (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(queue->droppedCount(), 2u);
+}
+
+TEST(MediaFrameQueueTest, StopDiscardsQueuedFramesAndJoins) {
+    auto sink = std::make_shared<Sink>(true);
+    auto queue = MakeQueue(3, ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_OLDEST, 0, sink);
+    FillWhileHeld(*queue, *sink, 4);
+
+    // stop() waits for the sink call in progress, then the consumer exits without the rest
+    std::atomic<bool> stopped{false};
+    std::thread stopper([&]() {
+        queue->stop();
+        stopped.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(stopped.load());
+    sink->release();
+    stopper.join();
+    EXPECT_EQ(sink->returned(), 1u);
+    EXPECT_EQ(queue->deliveredCount(), 1u);
+
+    // Frames pushed after the stop are ignored
+    Push(*queue, 4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(sink->ids(), std::vector<int>{0});
+    EXPECT_EQ(queue->droppedCount(), 0u);
+}
+
+TEST(MediaFrameQueueTest, CountsLateFrames) {
+    auto sink = std::make_shared<Sink>(true);
+    auto queue = MakeQueue(3, ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_OLDEST, 200, sink);
+    FillWhileHeld(*queue, *sink, 2);
+    // Frame 1 waits behind the held sink for longer than the threshold
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    sink->release();
+    ASSERT_TRUE(WaitFor([&]() { return queue->deliveredCount() == 2; }, 5000));
+
+    // Frame 2 finds the consumer idle
+    Push(*queue, 2);
+    ASSERT_TRUE(WaitFor([&]() { return queue->deliveredCount() == 3; }, 5000));
+    queue->stop();
+    EXPECT_EQ(queue->lateCount(), 1u);
+    EXPECT_EQ(queue->droppedCount(), 0u);
+}
+
+TEST(MediaFrameQueueTest, DeliversEveryFrameAtMostOnce) {
+    const int kFrames = 20000;
+    auto sink = std::make_shared<Sink>(false);
+    auto queue = MakeQueue(4, ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_OLDEST, 0, sink);
+    for (int id = 0; id < kFrames; id++) {
+        Push(*queue, id);
+    }
+    ASSERT_TRUE(WaitFor(
+        [&]() { return queue->deliveredCount() + queue->droppedCount() == kFrames; }, 10000));
+    queue->stop();
+
+    std::vector<int> ids = sink->ids();
+    EXPECT_EQ(ids.size(), queue->deliveredCount());
+    EXPECT_GT(ids.size(), 0u);
+    // In push order, so a frame delivered twice would show up as a step that is not forward
+    for (size_t i = 1; i < ids.size(); i++) {
+        ASSERT_LT(ids[i - 1], ids[i]) << i;
+    }
+    EXPECT_EQ(ids.back(), kFrames - 1);
+}
+
+// Handlers of the media player tests, recording the first byte of every frame and its thread
+class FrameHandler : public IZegoMediaPlayerVideoHandler, public IZegoMediaPlayerAudioHandler {
+  public:
+    void onVideoFrame(IZegoMediaPlayer *, const unsigned char **data, unsigned int *dataLength,
+                      ZegoVideoFrameParam param, const char *extraInfo) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        video.push_back(dataLength[0] > 0 ? data[0][0] : -1);
+        widths.push_back(param.width);
+        extraInfos.push_back(extraInfo ? extraInfo : "");
+        threads.push_back(std::this_thread::get_id());
+    }
+
+    void onAudioFrame(IZegoMediaPlayer *, const unsigned char *data, unsigned int dataLength,
+                      ZegoAudioFrameParam) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        audio.push_back(dataLength > 0 ? data[0] : -1);
+        threads.push_back(std::this_thread::get_id());
+    }
+
+    size_t videoCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return video.size();
+    }
+
+    size_t audioCount() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return audio.size();
+    }
+
+    std::mutex mutex_;
+    std::vector<int> video;
+    std::vector<int> widths;
+    std::vector<std::string> extraInfos;
+    std::vector<int> audio;
+    std::vector<std::thread::id> threads;
+};
+
+// Feeds one RGBA video frame and one audio frame whose bytes are all |value|, as the C callbacks
+// do, and overwrites the buffers once the calls return
+void FeedFrames(ZegoExpressMediaPlayerImp &player, unsigned char value) {
+    std::vector<unsigned char> pixels(16 * 16 * 4, value);
+    const unsigned char *data[4] = {pixels.data(), nullptr, nullptr, nullptr};
+    unsigned int dataLength[4] = {static_cast<unsigned int>(pixels.size()), 0, 0, 0};
+    zego_video_frame_param videoParam;
+    memset(&videoParam, 0, sizeof(videoParam));
+    videoParam.format = zego_video_frame_format(ZEGO_VIDEO_FRAME_FORMAT_RGBA32);
+    videoParam.width = 16;
+    videoParam.height = 16;
+    videoParam.strides[0] = 16 * 4;
+    player.zego_on_media_player_video_frame(data, dataLength, videoParam, "extra");
+
+    std::vector<unsigned char> samples(960, value);
+    zego_audio_frame_param audioParam;
+    audioParam.sample_rate = zego_audio_sample_rate(ZEGO_AUDIO_SAMPLE_RATE_48K);
+    audioParam.channel = zego_audio_channel(ZEGO_AUDIO_CHANNEL_STEREO);
+    player.zego_on_media_player_audio_frame(samples.data(), ZegoUInt(samples.size()), audioParam);
+
+    std::fill(pixels.begin(), pixels.end(), 0xFF);
+    std::fill(samples.begin(), samples.end(), 0xFF);
+}
+
+TEST(MediaFrameQueueTest, MediaPlayerQueuesCopiesAndCountsFrames) {
+    auto player = std::make_shared<ZegoExpressMediaPlayerImp>(0);
+    auto handler = std::make_shared<FrameHandler>();
+    player->setVideoHandler(handler, ZEGO_VIDEO_FRAME_FORMAT_RGBA32);
+    player->setAudioHandler(handler);
+
+    ZegoMediaPlayerFrameDeliveryConfig config;
+    config.mode = ZEGO_MEDIA_PLAYER_FRAME_DELIVERY_MODE_QUEUED;
+    config.videoQueueCapacity = 100;
+    config.audioQueueCapacity = 100;
+    config.lateThreshold = 0;
+    player->setFrameDeliveryConfig(config);
+    for (int i = 0; i < 10; i++) {
+        FeedFrames(*player, static_cast<unsigned char>(i));
+    }
+    ASSERT_TRUE(WaitFor(
+        [&]() { return handler->videoCount() == 10 && handler->audioCount() == 10; }, 5000));
+
+    ZegoMediaPlayerFrameDeliveryStats stats = player->getFrameDeliveryStats();
+    EXPECT_EQ(stats.videoFrameCount, 10u);
+    EXPECT_EQ(stats.audioFrameCount, 10u);
+    EXPECT_EQ(stats.droppedVideoFrameCount, 0u);
+    EXPECT_EQ(stats.droppedAudioFrameCount, 0u);
+    {
+        std::lock_guard<std::mutex> lock(handler->mutex_);
+        // Copied before the caller reused its buffers, delivered off the calling thread
+        for (int i = 0; i < 10; i++) {
+            EXPECT_EQ(handler->video[i], i);
+            EXPECT_EQ(handler->audio[i], i);
+            EXPECT_EQ(handler->widths[i], 16);
+            EXPECT_EQ(handler->extraInfos[i], "extra");
+        }
+        for (const std::thread::id &thread : handler->threads) {
+            EXPECT_NE(thread, std::this_thread::get_id());
+        }
+        handler->threads.clear();
+    }
+
+    // Back to synchronous delivery: the counters start over and frames arrive on this thread
+    player->setFrameDeliveryConfig(ZegoMediaPlayerFrameDeliveryConfig());
+    FeedFrames(*player, 42);
+    stats = player->getFrameDeliveryStats();
+    EXPECT_EQ(stats.videoFrameCount, 1u);
+    EXPECT_EQ(stats.audioFrameCount, 1u);
+    std::lock_guard<std::mutex> lock(handler->mutex_);
+    ASSERT_EQ(handler->threads.size(), 2u);
+    EXPECT_EQ(handler->threads[0], std::this_thread::get_id());
+    EXPECT_EQ(handler->video.back(), 42);
+}
+
+TEST(MediaFrameQueueTest, MediaPlayerReportsDroppedFrames) {
+    auto player = std::make_shared<ZegoExpressMediaPlayerImp>(0);
+    auto handler = std::make_shared<FrameHandler>();
+    player->setVideoHandler(handler, ZEGO_VIDEO_FRAME_FORMAT_RGBA32);
+    player->setAudioHandler(handler);
+
+    // Taking the handler's lock holds both consumers in their first frame
+    ZegoMediaPlayerFrameDeliveryConfig config;
+    config.mode = ZEGO_MEDIA_PLAYER_FRAME_DELIVERY_MODE_QUEUED;
+    config.videoQueueCapacity = 2;
+    config.audioQueueCapacity = 4;
+    config.dropPolicy = ZEGO_MEDIA_PLAYER_FRAME_DROP_POLICY_DROP_NEWEST;
+    player->setFrameDeliveryConfig(config);
+    {
+        std::unique_lock<std::mutex> lock(handler->mutex_);
+        FeedFrames(*player, 0);
+        // Both consumers are taken off the queue before the next ones are fed
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        for (int i = 1; i < 10; i++) {
+            FeedFrames(*player, static_cast<unsigned char>(i));
+        }
+    }
+    ASSERT_TRUE(WaitFor(
+        [&]() { return handler->videoCount() == 3 && handler->audioCount() == 5; }, 5000));
+    ZegoMediaPlayerFrameDeliveryStats stats = player->getFrameDeliveryStats();
+    EXPECT_EQ(stats.videoFrameCount, 3u);
+    EXPECT_EQ(stats.droppedVideoFrameCount, 7u);
+    EXPECT_EQ(stats.audioFrameCount, 5u);
+    EXPECT_EQ(stats.droppedAudioFrameCount, 5u);
+    player->setFrameDeliveryConfig(ZegoMediaPlayerFrameDeliveryConfig());
+
+    std::lock_guard<std::mutex> lock(handler->mutex_);
+    EXPECT_EQ(handler->video, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(handler->audio, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+// Records the playing progress events of the callback center test, on the dispatcher
+class ProgressHandler : public IZegoMediaPlayerEventHandler {
+  public:
+    void onMediaPlayerPlayingProgress(IZegoMediaPlayer *, unsigned long long millisecond) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        progress.push_back(millisecond);
+    }
+
+    std::vector<unsigned long long> wait(size_t count) {
+        WaitFor(
+            [&]() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return progress.size() >= count;
+            },
+            2000);
+        // Anything delivered after the player went away shows up once the dispatcher has drained
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::lock_guard<std::mutex> lock(mutex_);
+        return progress;
+    }
+
+    std::mutex mutex_;
+    std::vector<unsigned long long> progress;
+};
+
+TEST(MediaFrameQueueTest, CallbackCenterReachesRegisteredPlayersOnly) {
+    const zego_media_player_instance_index index = zego_media_player_instance_index(3);
+    auto player = std::make_shared<ZegoExpressMediaPlayerImp>(index);
+    auto events = std::make_shared<ProgressHandler>();
+    auto frames = std::make_shared<FrameHandler>();
+    player->setEventHandler(events);
+    player->setVideoHandler(frames, ZEGO_VIDEO_FRAME_FORMAT_RGBA32);
+    oInternalCallbackCenter->insertZegoExpressMediaPlayerImp(index, player);
+
+    std::vector<unsigned char> pixels(16 * 16 * 4, 7);
+    const unsigned char *data[4] = {pixels.data(), nullptr, nullptr, nullptr};
+    unsigned int dataLength[4] = {static_cast<unsigned int>(pixels.size()), 0, 0, 0};
+    zego_video_frame_param param;
+    memset(&param, 0, sizeof(param));
+    param.format = zego_video_frame_format(ZEGO_VIDEO_FRAME_FORMAT_RGBA32);
+    param.width = 16;
+    param.height = 16;
+    param.strides[0] = 16 * 4;
+
+    ZegoInternalCallbackCenter::zego_on_media_player_playing_progress(100, index, nullptr);
+    ZegoInternalCallbackCenter::zego_on_media_player_video_frame(data, dataLength, param, "",
+                                                                 index, nullptr);
+    // Another index has no player behind it
+    ZegoInternalCallbackCenter::zego_on_media_player_playing_progress(
+        200, zego_media_player_instance_index(4), nullptr);
+    EXPECT_EQ(events->wait(1), std::vector<unsigned long long>{100});
+    EXPECT_EQ(frames->videoCount(), 1u);
+
+    oInternalCallbackCenter->eraseZegoExpressMediaPlayerImp(index);
+    ZegoInternalCallbackCenter::zego_on_media_player_playing_progress(300, index, nullptr);
+    ZegoInternalCallbackCenter::zego_on_media_player_video_frame(data, dataLength, param, "",
+                                                                 index, nullptr);
+    EXPECT_EQ(events->wait(1), std::vector<unsigned long long>{100});
+    EXPECT_EQ(frames->videoCount(), 1u);
+}
+
+} // namespace
@@ -0,0 +1,386 @@
+// ZegoQualityMetricsStore (internal/ZegoInternalMetricsStore.hpp), fed samples with chosen
+// timestamps through add().
+//
+// The tests check the min/avg/max/p95 of a known minute and of a known ten minute window, both
+// flushed into their rings and while still in progress, that the rings overwrite their oldest
+// rows without allocating once a series exists, and that the ZQM export decodes back to what
+// the queries return.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "internal/ZegoInternalMetricsStore.hpp"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+std::atomic<unsigned long long> gAllocations{0};
+
+} // namespace
+
+// Counts every allocation of the process. Not inlined, or GCC pairs the free() below with the
+// new expressions it was inlined into and reports a mismatch.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { free(p); }
+
+namespace {
+
+typedef ZegoQualityMetricsStore Store;
+
+const int64_t kMinute = 60000;
+const int64_t kTenMinutes = 600000;
+// A ten minute boundary, and so a minute boundary as well
+const int64_t kStart = 1700000000000LL - 1700000000000LL % kTenMinutes;
+
+// One publish sample: |value| in the send fps column, twice that in the rtt column
+void AddPublish(const char *id, int64_t timestamp, float value) {
+    float values[6] = {value, 0, 0, value * 2, 0, 0};
+    oInternalQualityMetricsStore->add(Store::KIND_PUBLISH, id, timestamp, values);
+}
+
+std::vector<ZegoQualityMetricsPoint> Query(const char *id, ZegoQualityMetric metric,
+                                           ZegoQualityMetricsResolution resolution,
+                                           int64_t beginTime, int64_t endTime) {
+    std::vector<ZegoQualityMetricsPoint> points(1024);
+    points.resize(oInternalQualityMetricsStore->query(id, metric, resolution, beginTime, endTime,
+                                                      points.data(),
+                                                      static_cast<unsigned int>(points.size())));
+    return points;
+}
+
+void ExpectPoint(const ZegoQualityMetricsPoint &point, int64_t timestamp, unsigned int count,
+                 float min, float avg, float max, float p95) {
+    EXPECT_EQ(point.timestamp, timestamp);
+    EXPECT_EQ(point.count, count);
+    EXPECT_FLOAT_EQ(point.min, min);
+    EXPECT_FLOAT_EQ(point.avg, avg);
+    EXPECT_FLOAT_EQ(point.max, max);
+    EXPECT_FLOAT_EQ(point.p95, p95);
+}
+
+// A tier of a decoded ZQM series. values[column][stat][row], raw tiers have one stat.
+struct Tier {
+    std::vector<int64_t> timestamps;
+    std::vector<unsigned int> counts;
+    std::vector<std::vector<std::vector<float>>> values;
+};
+
+struct Series {
+    unsigned int kind = 0;
+    unsigned int columns = 0;
+    std::string id;
+    Tier tiers[3];
+};
+
+// Reads the export format documented at ZegoQualityMetricsStore::exportBlob
+class Decoder {
+  public:
+    explicit Decoder(const std::vector<unsigned char> &blob) : blob_(blob) {}
+
+    bool Decode(std::vector<Series> &out) {
+        if (blob_.size() < 4 || std::memcmp(blob_.data(), "ZQM", 3) != 0 || blob_[3] != 1) {
+            return false;
+        }
+        pos_ = 4;
+        uint64_t count = 0;
+        if (!Varint(count)) {
+            return false;
+        }
+        for (uint64_t s = 0; s < count; s++) {
+            Series series;
+            uint64_t idLength = 0;
+            if (!Byte(series.kind) || !Byte(series.columns) || !Varint(idLength) ||
+                blob_.size() - pos_ < idLength) {
+                return false;
+            }
+            series.id.assign(blob_.begin() + pos_, blob_.begin() + pos_ + idLength);
+            pos_ += idLength;
+            for (int t = 0; t < 3; t++) {
+                if (!ReadTier(series.tiers[t], series.columns, t == 0 ? 1 : 4)) {
+                    return false;
+                }
+            }
+            out.push_back(series);
+        }
+        return pos_ == blob_.size();
+    }
+
+  private:
+    bool ReadTier(Tier &tier, unsigned int columns, unsigned int stats) {
+        uint64_t rows = 0;
+        if (!Varint(rows)) {
+            return false;
+        }
+        int64_t previous = 0;
+        for (uint64_t i = 0; i < rows; i++) {
+            uint64_t zigzag = 0;
+            if (!Varint(zigzag)) {
+                return false;
+            }
+            previous += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+            tier.timestamps.push_back(previous);
+        }
+        for (uint64_t i = 0; stats > 1 && i < rows; i++) {
+            uint64_t count = 0;
+            if (!Varint(count)) {
+                return false;
+            }
+            tier.counts.push_back(static_cast<unsigned int>(count));
+        }
+        tier.values.assign(columns, std::vector<std::vector<float>>(stats));
+        for (unsigned int c = 0; c < columns; c++) {
+            for (unsigned int s = 0; s < stats; s++) {
+                for (uint64_t i = 0; i < rows; i++) {
+                    float value = 0;
+                    if (!Float(value)) {
+                        return false;
+                    }
+                    tier.values[c][s].push_back(value);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool Byte(unsigned int &value) {
+        if (pos_ >= blob_.size()) {
+            return false;
+        }
+        value = blob_[pos_++];
+        return true;
+    }
+
+    bool Varint(uint64_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= blob_.size()) {
+                return false;
+            }
+            unsigned char byte = blob_[pos_++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Float(float &value) {
+        if (blob_.size() - pos_ < 4) {
+            return false;
+        }
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++) {
+            bits |= static_cast<uint32_t>(blob_[pos_++]) << (8 * i);
+        }
+        std::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    const std::vector<unsigned char> &blob_;
+    size_t pos_ = 0;
+};
+
+class MetricsStoreTest : public ::testing::Test {
+  protected:
+    void SetUp() override { Configure(600, 360, 288); }
+
+    void TearDown() override {
+        oInternalQualityMetricsStore->setConfig(ZegoQualityMetricsStoreConfig());
+    }
+
+    // Drops every series and starts over with the given capacities
+    void Configure(unsigned int raw, unsigned int minute, unsigned int tenMinute) {
+        oInternalQualityMetricsStore->setConfig(ZegoQualityMetricsStoreConfig());
+        ZegoQualityMetricsStoreConfig config;
+        config.enable = true;
+        config.maxSeries = 4;
+        config.rawCapacity = raw;
+        config.minuteCapacity = minute;
+        config.tenMinuteCapacity = tenMinute;
+        oInternalQualityMetricsStore->setConfig(config);
+    }
+};
+
+TEST_F(MetricsStoreTest, MinuteAndTenMinuteStatsAreExact) {
+    // Ten minutes of six samples each, 1 to 60 in order, then one sample of the next ten minutes
+    for (int m = 0; m < 10; m++) {
+        for (int k = 0; k < 6; k++) {
+            AddPublish("stream", kStart + m * kMinute + k * 10000,
+                       static_cast<float>(m * 6 + k + 1));
+        }
+    }
+
+    // The fourth minute, flushed into the minute ring: 19 to 24
+    std::vector<ZegoQualityMetricsPoint> points =
+        Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+              ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE, kStart + 3 * kMinute, kStart + 4 * kMinute);
+    ASSERT_EQ(points.size(), 1u);
+    ExpectPoint(points[0], kStart + 3 * kMinute, 6, 19, 21.5f, 24, 24);
+
+    // The same minute in another column
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_RTT,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE, kStart + 3 * kMinute,
+                   kStart + 4 * kMinute);
+    ASSERT_EQ(points.size(), 1u);
+    ExpectPoint(points[0], kStart + 3 * kMinute, 6, 38, 43, 48, 48);
+
+    // The last minute, still in progress
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE, kStart + 9 * kMinute,
+                   kStart + kTenMinutes);
+    ASSERT_EQ(points.size(), 1u);
+    ExpectPoint(points[0], kStart + 9 * kMinute, 6, 55, 57.5f, 60, 60);
+
+    // The ten minutes in progress: the p95 of 60 samples is the 57th smallest
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_TEN_MINUTES, kStart, kStart + kTenMinutes);
+    ASSERT_EQ(points.size(), 1u);
+    ExpectPoint(points[0], kStart, 60, 1, 30.5f, 60, 57);
+
+    // Flushed into the ten minute ring by the next period, and queried from inside the window
+    AddPublish("stream", kStart + kTenMinutes, 100);
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_TEN_MINUTES, kStart + 5 * kMinute,
+                   kStart + 2 * kTenMinutes);
+    ASSERT_EQ(points.size(), 2u);
+    ExpectPoint(points[0], kStart, 60, 1, 30.5f, 60, 57);
+    ExpectPoint(points[1], kStart + kTenMinutes, 1, 100, 100, 100, 100);
+
+    // Every minute is there, the last one flushed by the new sample
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE, kStart, kStart + kTenMinutes);
+    ASSERT_EQ(points.size(), 10u);
+    for (int m = 0; m < 10; m++) {
+        const float first = static_cast<float>(m * 6 + 1);
+        ExpectPoint(points[m], kStart + m * kMinute, 6, first, first + 2.5f, first + 5, first + 5);
+    }
+
+    // Raw samples come back unchanged
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_RAW, kStart + 2 * kMinute, kStart + 3 * kMinute);
+    ASSERT_EQ(points.size(), 6u);
+    for (int k = 0; k < 6; k++) {
+        const float value = static_cast<float>(12 + k + 1);
+        ExpectPoint(points[k], kStart + 2 * kMinute + k * 10000, 1, value, value, value, value);
+    }
+}
+
+TEST_F(MetricsStoreTest, RingsWrapWithoutAllocating) {
+    Configure(8, 4, 2);
+    AddPublish("stream", kStart, 0);
+
+    // A sample every 20 s for 3 h: every ring wraps many times over. The second half of the
+    // samples only overwrites rows.
+    const int kSamples = 3 * 180;
+    for (int i = 1; i < kSamples / 2; i++) {
+        AddPublish("stream", kStart + i * 20000LL, static_cast<float>(i));
+    }
+    const size_t exportSize = oInternalQualityMetricsStore->exportBlob().size();
+    const unsigned long long allocations = gAllocations.load();
+    for (int i = kSamples / 2; i < kSamples; i++) {
+        AddPublish("stream", kStart + i * 20000LL, static_cast<float>(i));
+    }
+    EXPECT_EQ(gAllocations.load() - allocations, 0u);
+    EXPECT_EQ(oInternalQualityMetricsStore->exportBlob().size(), exportSize);
+
+    const int64_t last = kStart + (kSamples - 1) * 20000LL;
+    std::vector<ZegoQualityMetricsPoint> points =
+        Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+              ZEGO_QUALITY_METRICS_RESOLUTION_RAW, 0, last + 1);
+    ASSERT_EQ(points.size(), 8u);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(points[i].timestamp, last - (7 - i) * 20000LL);
+        EXPECT_FLOAT_EQ(points[i].avg, static_cast<float>(kSamples - 8 + i));
+    }
+
+    // The 4 newest flushed minutes and the one in progress
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE, 0, last + 1);
+    ASSERT_EQ(points.size(), 5u);
+    const int64_t lastMinute = last - (last - kStart) % kMinute;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(points[i].timestamp, lastMinute - (4 - i) * kMinute);
+    }
+
+    points = Query("stream", ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS,
+                   ZEGO_QUALITY_METRICS_RESOLUTION_TEN_MINUTES, 0, last + 1);
+    ASSERT_EQ(points.size(), 3u);
+    const int64_t lastTenMinutes = last - (last - kStart) % kTenMinutes;
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(points[i].timestamp, lastTenMinutes - (2 - i) * kTenMinutes);
+        EXPECT_EQ(points[i].count, 30u);
+    }
+}
+
+TEST_F(MetricsStoreTest, ExportDecodesToTheQueriedPoints) {
+    Configure(16, 8, 4);
+    for (int i = 0; i < 100; i++) {
+        const int64_t timestamp = kStart + i * 9000LL;
+        AddPublish("publish", timestamp, static_cast<float>(i % 17));
+        float levels[2] = {static_cast<float>(i % 3), static_cast<float>(i % 5)};
+        oInternalQualityMetricsStore->add(Store::KIND_NETWORK, "user", timestamp, levels);
+    }
+
+    std::vector<Series> decoded;
+    ASSERT_TRUE(Decoder(oInternalQualityMetricsStore->exportBlob()).Decode(decoded));
+    ASSERT_EQ(decoded.size(), 2u);
+
+    const ZegoQualityMetricsResolution resolutions[3] = {
+        ZEGO_QUALITY_METRICS_RESOLUTION_RAW, ZEGO_QUALITY_METRICS_RESOLUTION_MINUTE,
+        ZEGO_QUALITY_METRICS_RESOLUTION_TEN_MINUTES};
+    for (const Series &series : decoded) {
+        const bool publish = series.id == "publish";
+        ASSERT_TRUE(publish || series.id == "user") << series.id;
+        EXPECT_EQ(series.kind,
+                  static_cast<unsigned int>(publish ? Store::KIND_PUBLISH : Store::KIND_NETWORK));
+        ASSERT_EQ(series.columns, Store::columnCount(publish ? Store::KIND_PUBLISH
+                                                             : Store::KIND_NETWORK));
+        const int firstMetric = publish ? ZEGO_QUALITY_METRIC_PUBLISH_VIDEO_SEND_FPS
+                                        : ZEGO_QUALITY_METRIC_NETWORK_UPSTREAM_LEVEL;
+        for (int t = 0; t < 3; t++) {
+            const Tier &tier = series.tiers[t];
+            for (unsigned int c = 0; c < series.columns; c++) {
+                std::vector<ZegoQualityMetricsPoint> points =
+                    Query(series.id.c_str(), static_cast<ZegoQualityMetric>(firstMetric + c),
+                          resolutions[t], 0, INT64_MAX);
+                ASSERT_EQ(points.size(), tier.timestamps.size()) << series.id << " tier " << t;
+                for (size_t i = 0; i < points.size(); i++) {
+                    EXPECT_EQ(points[i].timestamp, tier.timestamps[i]);
+                    if (t == 0) {
+                        EXPECT_EQ(points[i].avg, tier.values[c][0][i]);
+                        continue;
+                    }
+                    EXPECT_EQ(points[i].count, tier.counts[i]);
+                    EXPECT_EQ(points[i].min, tier.values[c][0][i]);
+                    EXPECT_EQ(points[i].avg, tier.values[c][1][i]);
+                    EXPECT_EQ(points[i].max, tier.values[c][2][i]);
+                    EXPECT_EQ(points[i].p95, tier.values[c][3][i]);
+                }
+            }
+        }
+    }
+    // Wrapped rings export their newest rows only
+    EXPECT_EQ(decoded[0].tiers[0].timestamps.size(), 16u);
+    EXPECT_EQ(decoded[0].tiers[0].timestamps.back(), kStart + 99 * 9000LL);
+}
+
+} // namespace
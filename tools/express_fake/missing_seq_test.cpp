@@ -0,0 +1,130 @@
+// Calls that hand out a seq when the loaded library lacks their function
+// (internal/ZegoInternalExplicit.hpp, ZegoMissingSeq in internal/ZegoInternalBase.h). No library
+// is loaded, so every function is missing.
+//
+// The tests check that a seq-returning symbol and the bridge's seq calls give ZEGOEXP_MISSING_SEQ
+// rather than an error code or 0 that would pass for a seq, and that the callbacks of such calls
+// fail at once with the missing function's error instead of waiting for a completion that never
+// comes, for the real-time sequential data manager's singles and batches as well.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ZegoExpressSDK.h"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int kNotFound = ZEGO_ERRCODE_COMMON_LOAD_LIBRARY_FUNC_NOT_FOUND;
+
+template <typename Predicate> bool WaitFor(Predicate predicate, int timeoutMs) {
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Error codes the callbacks of one test were called with. Static, callbacks run on the dispatcher.
+struct Calls {
+    std::mutex mutex;
+    std::vector<int> errors;
+
+    void add(int errorCode) {
+        std::lock_guard<std::mutex> lock(mutex);
+        errors.push_back(errorCode);
+    }
+
+    std::vector<int> wait(size_t count) {
+        WaitFor(
+            [&]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                return errors.size() >= count;
+            },
+            2000);
+        // Anything called twice shows up once the dispatcher has drained
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::lock_guard<std::mutex> lock(mutex);
+        return errors;
+    }
+};
+
+TEST(MissingSeqTest, SeqSymbolsReturnTheMissingSeq) {
+    void *handle = nullptr;
+    ZegoExplicitRegistry registry(&handle);
+    ZegoExplicitSymbol<pfnzego_express_get_increase_seq, ZegoExplicitMissingSeq> getSeq(
+        "zego_express_get_increase_seq", &registry);
+    ZegoExplicitSymbol<pfnzego_express_upload_log> uploadLog("zego_express_upload_log", &registry);
+
+    EXPECT_EQ(getSeq(), ZEGOEXP_MISSING_SEQ);
+    // Error-returning symbols keep returning the error
+    zego_seq seq = 0;
+    EXPECT_EQ(uploadLog(&seq), kNotFound);
+    EXPECT_EQ(seq, 0);
+}
+
+TEST(MissingSeqTest, BridgeSeqCallsReturnTheMissingSeq) {
+    EXPECT_EQ(oInternalOriginBridge->getIncreaseSeq(), ZEGOEXP_MISSING_SEQ);
+    EXPECT_EQ(oInternalOriginBridge->uploadLog(), ZEGOEXP_MISSING_SEQ);
+    EXPECT_EQ(oInternalOriginBridge->sendBroadcastMessage("room", "message"), ZEGOEXP_MISSING_SEQ);
+    const unsigned char data[4] = {1, 2, 3, 4};
+    EXPECT_EQ(oInternalOriginBridge->realTimeSequentialDataSendData(data, 4, "stream", 0),
+              ZEGOEXP_MISSING_SEQ);
+}
+
+TEST(MissingSeqTest, FailCallsOnlyTheCallbacksOfMissingSeqs) {
+    static Calls calls;
+    static std::string lyrics = "unset";
+    ZegoCopyrightedMusicGetLrcLyricCallback callback = [](int errorCode, std::string result) {
+        lyrics = result;
+        calls.add(errorCode);
+    };
+    EXPECT_FALSE(ZegoMissingSeq::fail(7, callback));
+    EXPECT_TRUE(ZegoMissingSeq::fail(ZEGOEXP_MISSING_SEQ, callback));
+    EXPECT_EQ(calls.wait(1), std::vector<int>{kNotFound});
+    EXPECT_EQ(lyrics, "");
+}
+
+TEST(MissingSeqTest, MediaPlayerSeekFailsAtOnce) {
+    static Calls calls;
+    ZegoExpressMediaPlayerImp player(0);
+    player.seekTo(1000, [](int errorCode) { calls.add(errorCode); });
+    EXPECT_EQ(calls.wait(1), std::vector<int>{kNotFound});
+}
+
+TEST(MissingSeqTest, RealTimeSequentialDataSendsFailAtOnce) {
+    static Calls calls;
+    static std::atomic<unsigned int> batchFailed{0};
+    ZegoExpressRealTimeSequentialDataManagerImp manager(0);
+    const unsigned char data[4] = {1, 2, 3, 4};
+    for (int i = 0; i < 3; i++) {
+        manager.sendRealTimeSequentialData(data, 4, "stream",
+                                           [](int errorCode) { calls.add(errorCode); });
+    }
+    ZegoRealTimeSequentialDataMessage messages[5];
+    for (ZegoRealTimeSequentialDataMessage &message : messages) {
+        message.data = data;
+        message.dataLength = 4;
+    }
+    manager.sendRealTimeSequentialDataBatch(messages, 5, "stream",
+                                            [](int errorCode, unsigned int failedCount) {
+                                                batchFailed.store(failedCount);
+                                                calls.add(errorCode);
+                                            });
+    EXPECT_EQ(calls.wait(4), std::vector<int>(4, kNotFound));
+    EXPECT_EQ(batchFailed.load(), 5u);
+}
+
+} // namespace
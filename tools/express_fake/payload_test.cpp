@@ -0,0 +1,155 @@
+// ZegoPayloadRef and ZegoPayloadPool (internal/ZegoInternalPayload.hpp).
+//
+// The pool hands blocks of a size class back last in, first out, so whether a block went back
+// to the pool shows up as the next payload of that class reusing its address. The tests check
+// which class each length lands in, that copies share one block which returns to the pool once
+// the last copy is gone, also when copies are made and dropped on several threads at once, and
+// that a null source gives an empty payload.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "internal/ZegoInternalPayload.hpp"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+ZegoPayloadPool *Pool() { return ZegoPayloadPool::GetInstance(); }
+
+std::vector<unsigned char> Bytes(unsigned int length) {
+    std::vector<unsigned char> bytes(length);
+    for (unsigned int i = 0; i < length; i++) {
+        bytes[i] = static_cast<unsigned char>(i * 7);
+    }
+    return bytes;
+}
+
+ZegoPayloadRef CopyOf(const std::vector<unsigned char> &bytes) {
+    return ZegoPayloadRef::copyFrom(bytes.data(), static_cast<unsigned int>(bytes.size()));
+}
+
+TEST(PayloadPoolTest, LengthsMapToSizeClasses) {
+    struct Case {
+        unsigned int length;
+        unsigned int capacity;
+        int sizeClass;
+    };
+    const Case cases[] = {{0, 256, 0},        {1, 256, 0},        {256, 256, 0},
+                          {257, 1024, 1},     {1024, 1024, 1},    {1025, 4096, 2},
+                          {4096, 4096, 2},    {4097, 16384, 3},   {16384, 16384, 3},
+                          {16385, 16385, -1}, {100000, 100000, -1}};
+    for (const Case &c : cases) {
+        ZegoPayloadBuffer *buffer = Pool()->acquire(c.length);
+        ASSERT_NE(buffer, nullptr);
+        EXPECT_EQ(buffer->length, c.length);
+        EXPECT_EQ(buffer->capacity, c.capacity) << c.length;
+        EXPECT_EQ(buffer->sizeClass, c.sizeClass) << c.length;
+        EXPECT_EQ(buffer->refCount.load(), 1u);
+        Pool()->recycle(buffer);
+    }
+}
+
+TEST(PayloadPoolTest, RecycledBlocksServeTheirClassOnly) {
+    ZegoPayloadBuffer *small = Pool()->acquire(10);
+    Pool()->recycle(small);
+
+    // Another length of the same class gets the block back, with its own length
+    ZegoPayloadBuffer *same = Pool()->acquire(250);
+    EXPECT_EQ(same, small);
+    EXPECT_EQ(same->length, 250u);
+    EXPECT_EQ(same->capacity, 256u);
+
+    // A length of the next class does not
+    Pool()->recycle(same);
+    ZegoPayloadBuffer *larger = Pool()->acquire(300);
+    EXPECT_NE(larger, small);
+    Pool()->recycle(larger);
+    EXPECT_EQ(Pool()->acquire(1), small);
+    Pool()->recycle(small);
+}
+
+TEST(PayloadRefTest, CopyFromCopiesTheBytes) {
+    std::vector<unsigned char> bytes = Bytes(1000);
+    ZegoPayloadRef ref = CopyOf(bytes);
+    ASSERT_EQ(ref.size(), bytes.size());
+    EXPECT_FALSE(ref.empty());
+    EXPECT_NE(ref.data(), bytes.data());
+    EXPECT_EQ(std::vector<unsigned char>(ref.data(), ref.data() + ref.size()), bytes);
+}
+
+TEST(PayloadRefTest, NullSourceGivesAnEmptyPayload) {
+    ZegoPayloadRef ref = ZegoPayloadRef::copyFrom(nullptr, 100);
+    EXPECT_TRUE(ref.empty());
+    EXPECT_EQ(ref.size(), 0u);
+    EXPECT_EQ(ref.data(), nullptr);
+    ZegoPayloadRef copy = ref;
+    EXPECT_TRUE(copy.empty());
+}
+
+TEST(PayloadRefTest, CopiesShareTheBlockUntilTheLastOneGoes) {
+    std::vector<unsigned char> bytes = Bytes(100);
+    ZegoPayloadRef ref = CopyOf(bytes);
+    const unsigned char *block = ref.data();
+
+    ZegoPayloadRef copy(ref);
+    ZegoPayloadRef assigned;
+    assigned = copy;
+    ZegoPayloadRef &alias = assigned;
+    assigned = alias;
+    ZegoPayloadRef moved(std::move(copy));
+    EXPECT_EQ(copy.data(), nullptr);
+    EXPECT_EQ(assigned.data(), block);
+    EXPECT_EQ(moved.data(), block);
+
+    // Each remaining holder keeps the block out of the pool
+    ref = ZegoPayloadRef();
+    assigned = std::move(moved);
+    ZegoPayloadRef other = CopyOf(bytes);
+    EXPECT_NE(other.data(), block);
+    other = ZegoPayloadRef();
+    EXPECT_EQ(std::vector<unsigned char>(assigned.data(), assigned.data() + assigned.size()),
+              bytes);
+
+    // Gone with the last holder, the next payload of its class gets it, the one after does not
+    {
+        ZegoPayloadRef last = std::move(assigned);
+    }
+    ZegoPayloadRef next = ZegoPayloadRef::copyFrom(bytes.data(), 1);
+    EXPECT_EQ(next.data(), block);
+    ZegoPayloadRef following = ZegoPayloadRef::copyFrom(bytes.data(), 1);
+    EXPECT_NE(following.data(), block);
+}
+
+TEST(PayloadRefTest, ConcurrentCopiesReturnTheBlockOnce) {
+    // A block recycled twice would sit in the free list twice and serve two payloads at once
+    std::vector<unsigned char> bytes = Bytes(3000);
+    ZegoPayloadRef ref = ZegoPayloadRef::copyFrom(bytes.data(), 2000);
+    const unsigned char *block = ref.data();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([ref]() {
+            for (int i = 0; i < 100000; i++) {
+                ZegoPayloadRef copy = ref;
+                ZegoPayloadRef moved = std::move(copy);
+                if (moved.data()[1] != 7) {
+                    ADD_FAILURE() << "payload changed";
+                    return;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    ref = ZegoPayloadRef();
+
+    ZegoPayloadRef first = ZegoPayloadRef::copyFrom(bytes.data(), 3000);
+    ZegoPayloadRef second = ZegoPayloadRef::copyFrom(bytes.data(), 3000);
+    EXPECT_EQ(first.data(), block);
+    EXPECT_NE(second.data(), block);
+}
+
+} // namespace
@@ -0,0 +1,243 @@
+// ZegoThreadCpuReader, ZegoAllocationCounter and ZegoPerformanceSampler
+// (internal/ZegoInternalPerfSampler.hpp), with this file installing the ZEGOEXP_ALLOCATION_HOOK
+// operator new and delete as an app would.
+//
+// The tests check that the /proc/self/task reader finds every thread, reads a thread name with
+// spaces and parentheses, and reports the CPU time the thread measured for itself, and that the
+// hook counts allocations, bytes and bytes in flight across threads, aligned ones included, and
+// feeds the sampler.
+
+#include <pthread.h>
+#include <time.h>
+
+#include <dirent.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#define ZEGOEXP_ALLOCATION_HOOK
+#include "ZegoExpressSDK.h"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// CPU time of the calling thread in microseconds
+unsigned long long ThreadCpuUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+unsigned int CountTasks() {
+    unsigned int count = 0;
+    DIR *dir = opendir("/proc/self/task");
+    while (struct dirent *entry = dir ? readdir(dir) : nullptr) {
+        count += entry->d_name[0] >= '0' && entry->d_name[0] <= '9' ? 1 : 0;
+    }
+    if (dir) {
+        closedir(dir);
+    }
+    return count;
+}
+
+// A named thread that burns |cpuUs| of CPU time and then sleeps until released
+class Spinner {
+  public:
+    Spinner(const char *name, unsigned long long cpuUs) {
+        thread_ = std::thread([this, name, cpuUs]() {
+            pthread_setname_np(pthread_self(), name);
+            volatile unsigned long long x = 0;
+            while (ThreadCpuUs() < cpuUs) {
+                for (int i = 0; i < 10000; i++) {
+                    x = x + i;
+                }
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            tid_ = static_cast<int>(gettid());
+            cpuUs_ = ThreadCpuUs();
+            cv_.notify_all();
+            cv_.wait(lock, [this]() { return released_; });
+        });
+    }
+
+    ~Spinner() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            released_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    // Waits until the CPU time is spent, the thread's id and CPU time as it measured it
+    void wait(int &tid, unsigned long long &cpuUs) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return tid_ != 0; });
+        tid = tid_;
+        cpuUs = cpuUs_;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    int tid_ = 0;
+    unsigned long long cpuUs_ = 0;
+    bool released_ = false;
+    std::thread thread_;
+};
+
+TEST(PerfSamplerTest, ThreadCpuReaderReadsProcSelfTask) {
+    ZegoThreadCpuReader reader;
+    ZegoExtendedPerformanceStatus status;
+    ASSERT_TRUE(reader.read(0, status));
+
+    // Split at the last ')', not the first one or a space
+    const char *kName = "spin (a) b)";
+    const Clock::time_point start = Clock::now();
+    Spinner spinner(kName, 300000);
+    int tid = 0;
+    unsigned long long cpuUs = 0;
+    spinner.wait(tid, cpuUs);
+    const double periodUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    ASSERT_TRUE(reader.read(periodUs, status));
+    EXPECT_EQ(status.totalThreadCount, CountTasks());
+    ASSERT_GT(status.threadCount, 0u);
+    ASSERT_LE(status.threadCount, static_cast<unsigned int>(ZEGO_PERFORMANCE_MAX_THREADS));
+
+    // Started after the first read, so all of its CPU time falls into this period and it is the
+    // busiest thread by far
+    const ZegoThreadCpuSample &busiest = status.threads[0];
+    EXPECT_EQ(busiest.threadID, tid);
+    EXPECT_STREQ(busiest.name, kName);
+    // utime and stime come in clock ticks, 10 ms on most kernels
+    EXPECT_NEAR(static_cast<double>(busiest.cpuTime), static_cast<double>(cpuUs), 25000.0);
+    EXPECT_NEAR(busiest.cpuUsage, cpuUs / periodUs, 0.15);
+
+    bool foundMain = false;
+    for (unsigned int i = 0; i < status.threadCount; i++) {
+        foundMain |= status.threads[i].threadID == static_cast<int>(getpid());
+        if (i > 0) {
+            EXPECT_LE(status.threads[i].cpuUsage, busiest.cpuUsage);
+        }
+    }
+    EXPECT_TRUE(foundMain);
+
+    // Idle since: its share of the next period is nothing, its total stays
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(reader.read(50000, status));
+    for (unsigned int i = 0; i < status.threadCount; i++) {
+        if (status.threads[i].threadID == tid) {
+            EXPECT_FLOAT_EQ(status.threads[i].cpuUsage, 0.0f);
+            EXPECT_NEAR(static_cast<double>(status.threads[i].cpuTime),
+                        static_cast<double>(cpuUs), 25000.0);
+        }
+    }
+}
+
+TEST(PerfSamplerTest, AllocationHookCountsAcrossThreads) {
+    ASSERT_TRUE(ZegoAllocationCounter::isInstalled());
+
+    const int kBlocks = 100;
+    const size_t kSize = 1000;
+    std::vector<char *> blocks;
+    blocks.reserve(kBlocks);
+    const ZegoAllocationCounter::Totals before = ZegoAllocationCounter::totals();
+    for (int i = 0; i < kBlocks; i++) {
+        blocks.push_back(new char[kSize]);
+    }
+    const ZegoAllocationCounter::Totals allocated = ZegoAllocationCounter::totals();
+    EXPECT_EQ(allocated.count - before.count, static_cast<unsigned long long>(kBlocks));
+    // Usable sizes, at least what was asked for
+    const unsigned long long bytes = allocated.bytes - before.bytes;
+    EXPECT_GE(bytes, kBlocks * kSize);
+    EXPECT_LT(bytes, kBlocks * (kSize + 64));
+    EXPECT_EQ(allocated.inFlight - before.inFlight, static_cast<long long>(bytes));
+
+    // Freed on another thread, with another stripe: the total in flight still drops back
+    std::thread([&blocks]() {
+        for (char *block : blocks) {
+            delete[] block;
+        }
+    }).join();
+    const ZegoAllocationCounter::Totals freed = ZegoAllocationCounter::totals();
+    // The thread's own state is freed again as well
+    EXPECT_EQ(freed.inFlight, before.inFlight);
+}
+
+// Over-aligned, so new and delete take their std::align_val_t forms
+struct alignas(256) Wide {
+    char bytes[300];
+};
+
+TEST(PerfSamplerTest, AllocationHookCountsAlignedAllocations) {
+    const std::align_val_t kAlignment = std::align_val_t(alignof(Wide));
+    std::vector<void *> blocks;
+    blocks.reserve(8);
+    const ZegoAllocationCounter::Totals before = ZegoAllocationCounter::totals();
+    blocks.push_back(new Wide);
+    blocks.push_back(new Wide[3]);
+    blocks.push_back(::operator new(sizeof(Wide), kAlignment, std::nothrow));
+    blocks.push_back(::operator new[](sizeof(Wide), kAlignment, std::nothrow));
+    blocks.push_back(::operator new(sizeof(Wide), kAlignment));
+    blocks.push_back(::operator new[](sizeof(Wide), kAlignment));
+    blocks.push_back(::operator new(sizeof(Wide), kAlignment));
+    blocks.push_back(::operator new[](sizeof(Wide), kAlignment));
+    for (void *block : blocks) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignof(Wide), 0u);
+    }
+    const ZegoAllocationCounter::Totals allocated = ZegoAllocationCounter::totals();
+    EXPECT_EQ(allocated.count - before.count, blocks.size());
+    EXPECT_GE(allocated.bytes - before.bytes, (blocks.size() + 2) * sizeof(Wide));
+    EXPECT_EQ(allocated.inFlight - before.inFlight,
+              static_cast<long long>(allocated.bytes - before.bytes));
+
+    // Every aligned delete gives back what its new counted: plain, array, nothrow and sized
+    delete static_cast<Wide *>(blocks[0]);
+    delete[] static_cast<Wide *>(blocks[1]);
+    ::operator delete(blocks[2], kAlignment, std::nothrow);
+    ::operator delete[](blocks[3], kAlignment, std::nothrow);
+    ::operator delete(blocks[4], kAlignment);
+    ::operator delete[](blocks[5], kAlignment);
+    ::operator delete(blocks[6], sizeof(Wide), kAlignment);
+    ::operator delete[](blocks[7], sizeof(Wide), kAlignment);
+    EXPECT_EQ(ZegoAllocationCounter::totals().inFlight, before.inFlight);
+}
+
+TEST(PerfSamplerTest, SamplerReportsAllocationRates) {
+    oInternalPerformanceSampler->enable(true);
+    const int kBlocks = 1000;
+    std::vector<std::vector<char>> blocks;
+    blocks.reserve(kBlocks);
+    for (int i = 0; i < kBlocks; i++) {
+        blocks.emplace_back(256);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    ZegoExtendedPerformanceStatus status;
+    oInternalPerformanceSampler->sample(status);
+    const ZegoAllocationCounter::Totals totals = ZegoAllocationCounter::totals();
+    oInternalPerformanceSampler->enable(false);
+
+    EXPECT_TRUE(status.allocationHookInstalled);
+    const double periodSeconds = status.period / 1e6;
+    ASSERT_GT(periodSeconds, 0.09);
+    EXPECT_GE(status.allocationRate * periodSeconds, kBlocks - 0.5);
+    EXPECT_GE(status.allocationBytesRate * periodSeconds, kBlocks * 256 - 0.5);
+    EXPECT_EQ(status.bytesInFlight, totals.inFlight);
+    EXPECT_GT(status.totalThreadCount, 0u);
+}
+
+} // namespace
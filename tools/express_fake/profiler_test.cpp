@@ -0,0 +1,241 @@
+// ZegoCallbackProfiler and ZegoTraceWriter (internal/ZegoInternalProfiler.hpp), fed through
+// onCallback and add with chosen timestamps.
+//
+// The tests check that interval statistics only cover the callbacks measured since the previous
+// interval while the cumulative ones keep everything, that the trace writer drops what does not
+// fit its ring, counts it, and writes every accepted event once it is stopped, also while
+// producers keep adding during the stop.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "internal/ZegoInternalProfiler.hpp"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+typedef ZegoLatencyHistogram Histogram;
+
+// What a value reads back as from a summary, the upper bound of its bucket in microseconds
+double Reported(int64_t valueNs) {
+    return Histogram::upperBound(Histogram::bucketOf(static_cast<uint64_t>(valueNs))) / 1000.0;
+}
+
+// Every distribution value of |distribution| is |valueNs| and the mean is |meanUs|
+void ExpectAll(const ZegoLatencyDistribution &distribution, int64_t valueNs, double meanUs) {
+    EXPECT_DOUBLE_EQ(distribution.mean, meanUs);
+    EXPECT_DOUBLE_EQ(distribution.p50, Reported(valueNs));
+    EXPECT_DOUBLE_EQ(distribution.p90, Reported(valueNs));
+    EXPECT_DOUBLE_EQ(distribution.p99, Reported(valueNs));
+    EXPECT_DOUBLE_EQ(distribution.p999, Reported(valueNs));
+    EXPECT_DOUBLE_EQ(distribution.max, Reported(valueNs));
+}
+
+// The stats of |name| in |stats|, count 0 if absent
+ZegoCallbackLatencyStats Find(const std::vector<ZegoCallbackLatencyStats> &stats,
+                              const char *name) {
+    for (const ZegoCallbackLatencyStats &entry : stats) {
+        if (entry.callbackName == name) {
+            return entry;
+        }
+    }
+    return ZegoCallbackLatencyStats();
+}
+
+// Runs |count| callbacks of |site| that waited |queueNs| and ran |runNs|
+void Measure(ZegoCallbackSite *site, int count, int64_t queueNs, int64_t runNs) {
+    for (int i = 0; i < count; i++) {
+        const int64_t posted = 1000000000LL + i * 10000000LL;
+        oInternalCallbackProfiler->onCallback(site, posted, posted + queueNs,
+                                              posted + queueNs + runNs);
+    }
+}
+
+// The events of a trace file, by writer thread id in file order, and its dropped event count
+struct Trace {
+    bool complete = false;
+    std::map<unsigned int, std::vector<double>> timestamps;
+    size_t events = 0;
+    unsigned long long dropped = 0;
+};
+
+Trace ReadTrace(const std::string &path) {
+    Trace trace;
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string text = content.str();
+    trace.complete = text.find("{\"displayTimeUnit\"") == 0 && text.size() >= 4 &&
+                     text.compare(text.size() - 4, 4, "\n]}\n") == 0;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const char *tid = strstr(line.c_str(), "\"tid\":");
+        const char *count = strstr(line.c_str(), "\"count\":");
+        unsigned int id = 0;
+        double ts = 0;
+        if (line.find("\"ph\":\"X\"") != std::string::npos && tid &&
+            sscanf(tid, "\"tid\":%u,\"ts\":%lf", &id, &ts) == 2) {
+            trace.timestamps[id].push_back(ts);
+            trace.events++;
+        } else if (line.find("\"dropped_events\"") != std::string::npos && count) {
+            sscanf(count, "\"count\":%llu", &trace.dropped);
+        }
+    }
+    return trace;
+}
+
+std::string TracePath(const char *name) {
+    return ::testing::TempDir() + "profiler_test_" + name + ".json";
+}
+
+class ProfilerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ZegoCallbackProfilerConfig config;
+        config.enableLatencyStats = true;
+        oInternalCallbackProfiler->setConfig(config);
+        oInternalCallbackProfiler->reset();
+    }
+
+    void TearDown() override {
+        oInternalCallbackProfiler->setConfig(ZegoCallbackProfilerConfig());
+    }
+};
+
+TEST_F(ProfilerTest, IntervalStatsCoverOnlyTheNewCallbacks) {
+    const char *kName = "profiler_test_interval";
+    ZegoCallbackSite *site = oInternalCallbackProfiler->site(kName);
+
+    Measure(site, 100, 5000, 1000);
+    ZegoCallbackLatencyStats stats = Find(oInternalCallbackProfiler->getIntervalStats(), kName);
+    EXPECT_EQ(stats.count, 100u);
+    ExpectAll(stats.queueDelay, 5000, 5);
+    ExpectAll(stats.handlerRuntime, 1000, 1);
+
+    // Slower callbacks afterwards: the interval holds them alone, none of the earlier fast ones
+    Measure(site, 10, 200000, 1000000);
+    stats = Find(oInternalCallbackProfiler->getIntervalStats(), kName);
+    EXPECT_EQ(stats.count, 10u);
+    ExpectAll(stats.queueDelay, 200000, 200);
+    ExpectAll(stats.handlerRuntime, 1000000, 1000);
+
+    // The cumulative statistics keep both and do not move the interval baseline
+    stats = Find(oInternalCallbackProfiler->getStats(), kName);
+    EXPECT_EQ(stats.count, 110u);
+    EXPECT_DOUBLE_EQ(stats.handlerRuntime.mean, (100 * 1000 + 10 * 1000000) / 110.0 / 1000);
+    EXPECT_DOUBLE_EQ(stats.handlerRuntime.p50, Reported(1000));
+    EXPECT_DOUBLE_EQ(stats.handlerRuntime.max, Reported(1000000));
+
+    // An interval without callbacks leaves the site out
+    EXPECT_EQ(Find(oInternalCallbackProfiler->getIntervalStats(), kName).count, 0u);
+
+    Measure(site, 3, 0, 40000);
+    stats = Find(oInternalCallbackProfiler->getIntervalStats(), kName);
+    EXPECT_EQ(stats.count, 3u);
+    ExpectAll(stats.handlerRuntime, 40000, 40);
+
+    // A reset starts both over
+    oInternalCallbackProfiler->reset();
+    Measure(site, 7, 0, 3000);
+    stats = Find(oInternalCallbackProfiler->getIntervalStats(), kName);
+    EXPECT_EQ(stats.count, 7u);
+    ExpectAll(stats.handlerRuntime, 3000, 3);
+    EXPECT_EQ(Find(oInternalCallbackProfiler->getStats(), kName).count, 7u);
+}
+
+TEST_F(ProfilerTest, TraceWriterDrainsOnStop) {
+    // Stopped well within the writer's first 100 ms wait, so the final drain writes them
+    const std::string path = TracePath("drain");
+    ZegoTraceWriter writer;
+    ASSERT_TRUE(writer.start(path, 1024));
+    for (int i = 0; i < 100; i++) {
+        writer.add("test", "event", i * 1000LL, 500, -1);
+    }
+    writer.stop();
+
+    Trace trace = ReadTrace(path);
+    EXPECT_TRUE(trace.complete);
+    EXPECT_EQ(trace.events, 100u);
+    EXPECT_EQ(trace.dropped, 0u);
+    std::remove(path.c_str());
+}
+
+TEST_F(ProfilerTest, TraceWriterDropsWhatDoesNotFit) {
+    // Ten rings' worth in a burst, faster than the 100 ms drain can keep up with
+    const std::string path = TracePath("drop");
+    const int kEvents = 10 * 1024;
+    ZegoTraceWriter writer;
+    ASSERT_TRUE(writer.start(path, 1000));
+    for (int i = 0; i < kEvents; i++) {
+        writer.add("test", "event", i * 1000LL, 500, 0);
+    }
+    writer.stop();
+
+    Trace trace = ReadTrace(path);
+    EXPECT_TRUE(trace.complete);
+    EXPECT_GE(trace.events, 1024u);
+    EXPECT_GT(trace.dropped, 0u);
+    EXPECT_EQ(trace.events + trace.dropped, static_cast<unsigned long long>(kEvents));
+    ASSERT_EQ(trace.timestamps.size(), 1u);
+    const std::vector<double> &timestamps = trace.timestamps.begin()->second;
+    for (size_t i = 1; i < timestamps.size(); i++) {
+        ASSERT_LT(timestamps[i - 1], timestamps[i]) << i;
+    }
+    std::remove(path.c_str());
+}
+
+TEST_F(ProfilerTest, TraceWriterStopsWhileProducersAdd) {
+    const std::string path = TracePath("stop");
+    const int kProducers = 4;
+    ZegoTraceWriter writer;
+    for (int round = 0; round < 5; round++) {
+        ASSERT_TRUE(writer.start(path, 1024));
+        std::atomic<bool> done{false};
+        std::vector<unsigned long long> added(kProducers, 0);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; p++) {
+            producers.emplace_back([&, p]() {
+                while (!done.load()) {
+                    writer.add("test", "event", static_cast<int64_t>(added[p]++) * 1000, 500, 0);
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        writer.stop();
+        // Adds after the stop are ignored, and the file is already complete
+        Trace trace = ReadTrace(path);
+        done.store(true);
+        for (std::thread &producer : producers) {
+            producer.join();
+        }
+
+        EXPECT_TRUE(trace.complete) << "round " << round;
+        EXPECT_GT(trace.events, 0u);
+        unsigned long long total = 0;
+        for (unsigned long long count : added) {
+            total += count;
+        }
+        EXPECT_LE(trace.events + trace.dropped, total);
+        // Every producer's events come out in order and at most once
+        for (const auto &entry : trace.timestamps) {
+            for (size_t i = 1; i < entry.second.size(); i++) {
+                ASSERT_LT(entry.second[i - 1], entry.second[i]) << "round " << round;
+            }
+        }
+    }
+    std::remove(path.c_str());
+}
+
+} // namespace
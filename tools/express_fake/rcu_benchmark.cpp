@@ -0,0 +1,149 @@
+// Handler lookup under contention: the callback center's former recursive_mutex + shared_ptr copy
+// getter against the RCU slots of ZegoInternalRcu.hpp.
+//
+//   BM_HandlerLookup/<getter>/threads:<n>
+//                                   |n| reader threads each look up the handler and call it,
+//                                   while a writer thread replaces the handler every
+//                                   kWriterPeriodUs. <getter> is mutex (the old getter), rcu_get
+//                                   (lock-free, still copies the shared_ptr) or rcu_peek (raw
+//                                   pointer under a ZegoRcuReadGuard, as on the per-frame paths).
+//                                   items_per_second is lookups per second over all readers;
+//                                   use_after_free counts lookups that saw a destroyed handler and
+//                                   must stay 0.
+//
+// Usage:
+//   rcu_benchmark [benchmark flags]
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "internal/ZegoInternalRcu.hpp"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+const int kWriterPeriodUs = 500;
+const unsigned int kAlive = 0x600DF00Du;
+
+std::atomic<unsigned long long> gUseAfterFree{0};
+
+class Handler {
+  public:
+    ~Handler() { magic_.store(0, std::memory_order_relaxed); }
+
+    void onEvent() {
+        if (magic_.load(std::memory_order_relaxed) != kAlive) {
+            gUseAfterFree.fetch_add(1, std::memory_order_relaxed);
+        }
+        calls_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<unsigned int> magic_{kAlive};
+    std::atomic<unsigned long long> calls_{0};
+};
+
+// The getter the callback center used before the RCU slots
+class MutexSlot {
+  public:
+    void set(std::shared_ptr<Handler> value) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        value_ = std::move(value);
+    }
+
+    std::shared_ptr<Handler> get() {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        return value_;
+    }
+
+  private:
+    std::recursive_mutex mutex_;
+    std::shared_ptr<Handler> value_;
+};
+
+MutexSlot gMutexSlot;
+ZegoRcuSharedSlot<Handler> gRcuSlot;
+
+enum Getter { kMutex, kRcuGet, kRcuPeek };
+
+// Replaces the handler of both slots until stopped
+class Writer {
+  public:
+    void start() {
+        running_.store(true);
+        thread_ = std::thread([this]() {
+            while (running_.load(std::memory_order_relaxed)) {
+                gMutexSlot.set(std::make_shared<Handler>());
+                gRcuSlot.set(std::make_shared<Handler>());
+                std::this_thread::sleep_for(std::chrono::microseconds(kWriterPeriodUs));
+            }
+        });
+    }
+
+    void stop() {
+        running_.store(false);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+  private:
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+Writer gWriter;
+
+void BM_HandlerLookup(benchmark::State &state, Getter getter) {
+    if (state.thread_index() == 0) {
+        gMutexSlot.set(std::make_shared<Handler>());
+        gRcuSlot.set(std::make_shared<Handler>());
+        gUseAfterFree.store(0);
+        gWriter.start();
+    }
+    for (auto _ : state) {
+        switch (getter) {
+        case kMutex: {
+            std::shared_ptr<Handler> handler = gMutexSlot.get();
+            if (handler) {
+                handler->onEvent();
+            }
+            break;
+        }
+        case kRcuGet: {
+            std::shared_ptr<Handler> handler = gRcuSlot.get();
+            if (handler) {
+                handler->onEvent();
+            }
+            break;
+        }
+        case kRcuPeek: {
+            ZegoRcuReadGuard guard;
+            Handler *handler = gRcuSlot.peek();
+            if (handler) {
+                handler->onEvent();
+            }
+            break;
+        }
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        gWriter.stop();
+        state.counters["use_after_free"] = static_cast<double>(gUseAfterFree.load());
+    }
+}
+
+BENCHMARK_CAPTURE(BM_HandlerLookup, mutex, kMutex)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_CAPTURE(BM_HandlerLookup, rcu_get, kRcuGet)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_CAPTURE(BM_HandlerLookup, rcu_peek, kRcuPeek)->ThreadRange(1, 8)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
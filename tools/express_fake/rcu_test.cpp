@@ -0,0 +1,155 @@
+// ZegoRcuDomain and ZegoRcuSharedSlot / ZegoRcuSharedMap (internal/ZegoInternalRcu.hpp).
+//
+// Handlers record the thread their destructor ran on. The tests replace handlers while reader
+// threads peek at them, as the per-frame callbacks do, and check that no destructor runs on a
+// reader thread, that no reader sees a destroyed handler, and that every replaced handler is
+// still destroyed once its readers have left, also when no later write comes along.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "internal/ZegoInternalRcu.hpp"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Predicate> bool WaitFor(Predicate predicate, int timeoutMs) {
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+const unsigned int kAlive = 0x600DF00Du;
+
+std::mutex gReaderMutex;
+std::set<std::thread::id> gReaders;
+std::atomic<unsigned long long> gDestroyed{0};
+std::atomic<unsigned long long> gDestroyedOnReader{0};
+std::atomic<unsigned long long> gUseAfterFree{0};
+
+class Handler {
+  public:
+    ~Handler() {
+        magic_.store(0, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(gReaderMutex);
+        if (gReaders.count(std::this_thread::get_id()) != 0) {
+            gDestroyedOnReader.fetch_add(1);
+        }
+        gDestroyed.fetch_add(1);
+    }
+
+    void onEvent() {
+        if (magic_.load(std::memory_order_relaxed) != kAlive) {
+            gUseAfterFree.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    std::atomic<unsigned int> magic_{kAlive};
+};
+
+class RcuTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        std::lock_guard<std::mutex> lock(gReaderMutex);
+        gReaders.clear();
+        gDestroyed = 0;
+        gDestroyedOnReader = 0;
+        gUseAfterFree = 0;
+    }
+
+    static void registerReader() {
+        std::lock_guard<std::mutex> lock(gReaderMutex);
+        gReaders.insert(std::this_thread::get_id());
+    }
+};
+
+TEST_F(RcuTest, ReaderLeavingLastDoesNotDestroy) {
+    ZegoRcuSharedSlot<Handler> slot;
+    slot.set(std::make_shared<Handler>());
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> replaced{false};
+    std::thread reader([&]() {
+        registerReader();
+        {
+            ZegoRcuReadGuard guard;
+            Handler *handler = slot.peek();
+            entered.store(true);
+            while (!replaced.load()) {
+                std::this_thread::yield();
+            }
+            // Still the old handler, parked rather than freed by the writer
+            handler->onEvent();
+        }
+        // The reader was the last one to leave, yet the destructor is not its job
+    });
+    ASSERT_TRUE(WaitFor([&]() { return entered.load(); }, 5000));
+    slot.set(std::make_shared<Handler>());
+    EXPECT_EQ(gDestroyed.load(), 0u);
+    replaced.store(true);
+    reader.join();
+
+    // No further write, the reclaimer frees it
+    EXPECT_TRUE(WaitFor([&]() { return gDestroyed.load() == 1; }, 5000));
+    EXPECT_EQ(gDestroyedOnReader.load(), 0u);
+    EXPECT_EQ(gUseAfterFree.load(), 0u);
+}
+
+TEST_F(RcuTest, ReplaceWhileReadersPeek) {
+    const int kReaders = 4;
+    const int kReplacements = 2000;
+    ZegoRcuSharedSlot<Handler> slot;
+    ZegoRcuSharedMap<int, Handler> map;
+    slot.set(std::make_shared<Handler>());
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; i++) {
+        readers.emplace_back([&]() {
+            registerReader();
+            while (!stop.load(std::memory_order_relaxed)) {
+                ZegoRcuReadGuard guard;
+                if (Handler *handler = slot.peek()) {
+                    handler->onEvent();
+                }
+                if (Handler *handler = map.peek(1)) {
+                    handler->onEvent();
+                }
+            }
+        });
+    }
+    for (int i = 0; i < kReplacements; i++) {
+        slot.set(std::make_shared<Handler>());
+        map.insert(1, std::make_shared<Handler>());
+        map.erase(1);
+    }
+    stop.store(true);
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    slot.set(nullptr);
+
+    // The first handler and one per replacement of the slot, one per insert into the map
+    EXPECT_TRUE(WaitFor([&]() { return gDestroyed.load() == 2 * kReplacements + 1; }, 5000))
+        << gDestroyed.load();
+    EXPECT_EQ(gDestroyedOnReader.load(), 0u);
+    EXPECT_EQ(gUseAfterFree.load(), 0u);
+}
+
+} // namespace
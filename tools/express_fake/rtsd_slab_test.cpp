@@ -0,0 +1,528 @@
+// ZegoRealTimeSequentialDataSentSlab (internal/ZegoInternalRealTimeSequentialDataManager.hpp),
+// on its own and behind a real-time sequential data manager sending to libzego_express_fake.
+//
+// The slab tests drive registerSent and complete in the orders the SDK can produce, the
+// overflow and early maps included, and check the maps stay bounded when sends without a
+// callback never complete or completions never see their sender. The manager tests send singles
+// and batches from several threads with every completion mode of the fake, more than kSlots of
+// them in flight for the held mode, and check every sent callback ran exactly once with the
+// expected error counts.
+
+#include <dlfcn.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ZegoExpressSDK.h"
+#include "zego_express_fake.h"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+typedef ZegoRealTimeSequentialDataSentSlab Slab;
+
+const unsigned int kThreads = 4;
+const char *kStreamID = "fake-rtsd";
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Predicate> bool WaitFor(Predicate predicate, int timeoutMs) {
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!predicate()) {
+        if (Clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// An entry whose callback records the error code it was called with.
+Slab::Entry MakeEntry(std::shared_ptr<std::vector<int>> calls) {
+    Slab::Entry entry;
+    entry.callback = [calls](int errorCode) { calls->push_back(errorCode); };
+    return entry;
+}
+
+TEST(RtsdSentSlab, CompletionAfterRegisterHandsBackTheEntry) {
+    Slab slab;
+    auto calls = std::make_shared<std::vector<int>>();
+    Slab::Entry entry = MakeEntry(calls);
+    int errorCode = -1;
+    EXPECT_FALSE(slab.registerSent(7, entry, errorCode));
+
+    Slab::Entry completed;
+    ASSERT_TRUE(slab.complete(7, 12, completed));
+    ASSERT_TRUE(completed.callback);
+    completed.callback(12);
+    EXPECT_EQ(*calls, std::vector<int>{12});
+
+    // A second completion of the same seq finds nothing
+    Slab::Entry duplicate;
+    EXPECT_FALSE(slab.complete(7, 12, duplicate));
+}
+
+TEST(RtsdSentSlab, CompletionBeforeRegisterIsDeliveredBySender) {
+    Slab slab;
+    Slab::Entry completed;
+    EXPECT_FALSE(slab.complete(9, 34, completed));
+
+    auto calls = std::make_shared<std::vector<int>>();
+    Slab::Entry entry = MakeEntry(calls);
+    int errorCode = -1;
+    ASSERT_TRUE(slab.registerSent(9, entry, errorCode));
+    EXPECT_EQ(errorCode, 34);
+    ASSERT_TRUE(entry.callback);
+
+    // The slot is free for the seq kSlots later
+    Slab::Entry next = MakeEntry(calls);
+    EXPECT_FALSE(slab.registerSent(9 + Slab::kSlots, next, errorCode));
+    ASSERT_TRUE(slab.complete(9 + Slab::kSlots, 0, completed));
+}
+
+TEST(RtsdSentSlab, SendIntoHeldSlotOverflows) {
+    Slab slab;
+    auto older = std::make_shared<std::vector<int>>();
+    auto newer = std::make_shared<std::vector<int>>();
+    int errorCode = -1;
+    Slab::Entry entry = MakeEntry(older);
+    EXPECT_FALSE(slab.registerSent(5, entry, errorCode));
+    entry = MakeEntry(newer);
+    EXPECT_FALSE(slab.registerSent(5 + Slab::kSlots, entry, errorCode));
+
+    // Newest first, the overflow entry is found while the slot is still held
+    Slab::Entry completed;
+    ASSERT_TRUE(slab.complete(5 + Slab::kSlots, 1, completed));
+    completed.callback(1);
+    ASSERT_TRUE(slab.complete(5, 2, completed));
+    completed.callback(2);
+    EXPECT_EQ(*older, std::vector<int>{2});
+    EXPECT_EQ(*newer, std::vector<int>{1});
+}
+
+TEST(RtsdSentSlab, OverflowCompletedAfterSlotIsFreed) {
+    Slab slab;
+    auto calls = std::make_shared<std::vector<int>>();
+    int errorCode = -1;
+    Slab::Entry entry = MakeEntry(calls);
+    EXPECT_FALSE(slab.registerSent(5, entry, errorCode));
+    entry = MakeEntry(calls);
+    EXPECT_FALSE(slab.registerSent(5 + Slab::kSlots, entry, errorCode));
+
+    Slab::Entry completed;
+    ASSERT_TRUE(slab.complete(5, 0, completed));
+    // The slot is free now but the entry of the newer seq sits in the overflow map
+    ASSERT_TRUE(slab.complete(5 + Slab::kSlots, 3, completed));
+    ASSERT_TRUE(completed.callback);
+}
+
+TEST(RtsdSentSlab, EarlyCompletionForHeldSlot) {
+    Slab slab;
+    auto calls = std::make_shared<std::vector<int>>();
+    int errorCode = -1;
+    Slab::Entry entry = MakeEntry(calls);
+    EXPECT_FALSE(slab.registerSent(5, entry, errorCode));
+
+    // Completes before its sender registered, while the slot is held by seq 5
+    Slab::Entry completed;
+    EXPECT_FALSE(slab.complete(5 + Slab::kSlots, 56, completed));
+
+    entry = MakeEntry(calls);
+    ASSERT_TRUE(slab.registerSent(5 + Slab::kSlots, entry, errorCode));
+    EXPECT_EQ(errorCode, 56);
+    ASSERT_TRUE(slab.complete(5, 0, completed));
+}
+
+TEST(RtsdSentSlab, EarlyCompletionTakenOnceSlotIsFreed) {
+    Slab slab;
+    auto calls = std::make_shared<std::vector<int>>();
+    int errorCode = -1;
+    Slab::Entry entry = MakeEntry(calls);
+    EXPECT_FALSE(slab.registerSent(5, entry, errorCode));
+    Slab::Entry completed;
+    EXPECT_FALSE(slab.complete(5 + Slab::kSlots, 78, completed));
+    ASSERT_TRUE(slab.complete(5, 0, completed));
+
+    // The sender now finds the slot free, registers and still picks up the early completion
+    entry = MakeEntry(calls);
+    ASSERT_TRUE(slab.registerSent(5 + Slab::kSlots, entry, errorCode));
+    EXPECT_EQ(errorCode, 78);
+}
+
+// Holds every slot with a send that never completes, so later seqs go to the maps
+void HoldAllSlots(Slab &slab) {
+    for (unsigned int i = 0; i < Slab::kSlots; i++) {
+        auto calls = std::make_shared<std::vector<int>>();
+        Slab::Entry entry = MakeEntry(calls);
+        int errorCode = -1;
+        ASSERT_FALSE(slab.registerSent(zego_seq(i), entry, errorCode));
+    }
+}
+
+TEST(RtsdSentSlab, StaleEntriesWithoutCallbackAreDropped) {
+    Slab slab;
+    HoldAllSlots(slab);
+    auto calls = std::make_shared<std::vector<int>>();
+    const zego_seq kept = Slab::kSlots;
+    int errorCode = -1;
+    Slab::Entry entry = MakeEntry(calls);
+    EXPECT_FALSE(slab.registerSent(kept, entry, errorCode));
+
+    // Sends without a callback whose completion never comes
+    const zego_seq last = kept + 4 * Slab::kStaleSeqs;
+    for (zego_seq seq = kept + 1; seq <= last; seq++) {
+        Slab::Entry empty;
+        EXPECT_FALSE(slab.registerSent(seq, empty, errorCode));
+    }
+    EXPECT_LE(slab.parkedCount(), 2 * (Slab::kStaleSeqs + 1));
+
+    // The entry with a callback stayed, and so did the recent ones
+    Slab::Entry completed;
+    ASSERT_TRUE(slab.complete(kept, 9, completed));
+    completed.callback(9);
+    EXPECT_EQ(*calls, std::vector<int>{9});
+    EXPECT_TRUE(slab.complete(last, 0, completed));
+}
+
+TEST(RtsdSentSlab, StaleEarlyCompletionsAreDropped) {
+    Slab slab;
+    HoldAllSlots(slab);
+
+    // Completions of seqs whose sender never registers
+    const zego_seq last = Slab::kSlots + 4 * Slab::kStaleSeqs;
+    Slab::Entry completed;
+    for (zego_seq seq = Slab::kSlots; seq <= last; seq++) {
+        EXPECT_FALSE(slab.complete(seq, 1, completed));
+    }
+    EXPECT_LE(slab.parkedCount(), 2 * (Slab::kStaleSeqs + 1));
+
+    // A recent one is still picked up by its sender
+    auto calls = std::make_shared<std::vector<int>>();
+    Slab::Entry entry = MakeEntry(calls);
+    int errorCode = -1;
+    ASSERT_TRUE(slab.registerSent(last, entry, errorCode));
+    EXPECT_EQ(errorCode, 1);
+}
+
+TEST(RtsdSentSlab, StaleCompletionLeftInSlotIsReclaimed) {
+    Slab slab;
+    Slab::Entry completed;
+    EXPECT_FALSE(slab.complete(5, 1, completed));
+
+    // A recent seq of the slot still leaves it to the sender of seq 5
+    auto calls = std::make_shared<std::vector<int>>();
+    Slab::Entry entry = MakeEntry(calls);
+    int errorCode = -1;
+    EXPECT_FALSE(slab.registerSent(5 + Slab::kSlots, entry, errorCode));
+    EXPECT_EQ(slab.parkedCount(), 1u);
+    ASSERT_TRUE(slab.complete(5 + Slab::kSlots, 0, completed));
+
+    // One kStaleSeqs later takes the slot instead of the map
+    const zego_seq later = 5 + Slab::kStaleSeqs + Slab::kSlots;
+    entry = MakeEntry(calls);
+    EXPECT_FALSE(slab.registerSent(later, entry, errorCode));
+    EXPECT_EQ(slab.parkedCount(), 0u);
+    ASSERT_TRUE(slab.complete(later, 2, completed));
+    completed.callback(2);
+    EXPECT_EQ(*calls, std::vector<int>{2});
+}
+
+// Every seq of [first, first + count) is registered on a sender thread and completed on a
+// completer thread in a scrambled order, so both sides race on every path.
+TEST(RtsdSentSlab, ConcurrentRegisterAndComplete) {
+    const unsigned int kCount = Slab::kSlots * 4;
+    const zego_seq first = 1;
+    Slab slab;
+    std::atomic<unsigned int> delivered{0};
+    std::atomic<unsigned int> failed{0};
+    std::atomic<unsigned int> registered{0};
+
+    std::thread sender([&]() {
+        for (unsigned int i = 0; i < kCount; i++) {
+            Slab::Entry entry;
+            entry.callback = [](int) {};
+            int errorCode = 0;
+            if (slab.registerSent(first + zego_seq(i), entry, errorCode)) {
+                delivered.fetch_add(1);
+                failed.fetch_add(errorCode != 0 ? 1 : 0);
+            }
+            registered.store(i + 1, std::memory_order_release);
+        }
+    });
+    std::thread completer([&]() {
+        // Runs ahead of the sender by up to two slab lengths and completes in reverse within
+        // windows of 97 seqs
+        const unsigned int kWindow = 97;
+        for (unsigned int base = 0; base < kCount; base += kWindow) {
+            unsigned int end = std::min(kCount, base + kWindow);
+            while (registered.load(std::memory_order_acquire) + 2 * Slab::kSlots < end) {
+                std::this_thread::yield();
+            }
+            for (unsigned int i = end; i-- > base;) {
+                Slab::Entry entry;
+                int errorCode = i % 3 == 0 ? 1 : 0;
+                if (slab.complete(first + zego_seq(i), errorCode, entry)) {
+                    delivered.fetch_add(1);
+                    failed.fetch_add(errorCode != 0 ? 1 : 0);
+                }
+            }
+        }
+    });
+    sender.join();
+    completer.join();
+    EXPECT_EQ(delivered.load(), kCount);
+    EXPECT_EQ(failed.load(), (kCount + 2) / 3);
+}
+
+// Loads the fake and creates one engine and manager for the manager tests.
+struct Fake {
+    pfnzego_fake_set_rtsd_completion setRtsdCompletion = nullptr;
+    pfnzego_fake_release_rtsd releaseRtsd = nullptr;
+    pfnzego_fake_get_rtsd_sent getRtsdSent = nullptr;
+    void *handle = nullptr;
+    IZegoExpressEngine *engine = nullptr;
+    IZegoRealTimeSequentialDataManager *manager = nullptr;
+};
+
+Fake gFake;
+
+class FakeEnvironment : public ::testing::Environment {
+  public:
+    void SetUp() override {
+        ZegoLoadLibraryConfig loadConfig;
+        loadConfig.bindingMode = ZEGO_LIBRARY_BINDING_MODE_LAZY;
+        ASSERT_EQ(ZegoExpressSDK::loadLibrary(EXPRESS_FAKE_LIBRARY, loadConfig), 0);
+        gFake.handle = dlopen(EXPRESS_FAKE_LIBRARY, RTLD_NOW | RTLD_NOLOAD);
+        ASSERT_NE(gFake.handle, nullptr);
+        gFake.setRtsdCompletion = reinterpret_cast<pfnzego_fake_set_rtsd_completion>(
+            dlsym(gFake.handle, "zego_fake_set_rtsd_completion"));
+        gFake.releaseRtsd =
+            reinterpret_cast<pfnzego_fake_release_rtsd>(dlsym(gFake.handle, "zego_fake_release_rtsd"));
+        gFake.getRtsdSent =
+            reinterpret_cast<pfnzego_fake_get_rtsd_sent>(dlsym(gFake.handle, "zego_fake_get_rtsd_sent"));
+        ASSERT_NE(gFake.setRtsdCompletion, nullptr);
+        ASSERT_NE(gFake.releaseRtsd, nullptr);
+        ASSERT_NE(gFake.getRtsdSent, nullptr);
+
+        ZegoEngineProfile profile;
+        profile.appID = 1;
+        profile.scenario = ZEGO_SCENARIO_DEFAULT;
+        gFake.engine = ZegoExpressSDK::createEngine(profile, nullptr);
+        ASSERT_NE(gFake.engine, nullptr);
+        gFake.engine->loginRoom("fake-room", ZegoUser("test", "test"));
+        gFake.manager = gFake.engine->createRealTimeSequentialDataManager("fake-room");
+        ASSERT_NE(gFake.manager, nullptr);
+        gFake.manager->startBroadcasting(kStreamID);
+    }
+
+    void TearDown() override {
+        if (gFake.manager != nullptr) {
+            gFake.manager->stopBroadcasting(kStreamID);
+            gFake.engine->destroyRealTimeSequentialDataManager(gFake.manager);
+        }
+        if (gFake.engine != nullptr) {
+            std::mutex mutex;
+            std::condition_variable destroyed;
+            bool done = false;
+            ZegoExpressSDK::destroyEngine(gFake.engine, [&]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                done = true;
+                destroyed.notify_one();
+            });
+            std::unique_lock<std::mutex> lock(mutex);
+            destroyed.wait(lock, [&]() { return done; });
+        }
+        if (gFake.handle != nullptr) {
+            dlclose(gFake.handle);
+        }
+        ZegoExpressSDK::unLoadLibrary();
+    }
+};
+
+::testing::Environment *const gEnvironment =
+    ::testing::AddGlobalTestEnvironment(new FakeEnvironment());
+
+// What the sent callbacks of one test saw. Static, callbacks may run on the dispatcher.
+struct Totals {
+    std::atomic<unsigned long long> singles{0};
+    std::atomic<unsigned long long> singlesFailed{0};
+    std::atomic<unsigned long long> batches{0};
+    std::atomic<unsigned long long> batchesFailed{0};
+    std::atomic<unsigned long long> wrongError{0};
+
+    void reset() {
+        singles = 0;
+        singlesFailed = 0;
+        batches = 0;
+        batchesFailed = 0;
+        wrongError = 0;
+    }
+};
+
+Totals gTotals;
+
+class RtsdManagerTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_NE(gFake.manager, nullptr);
+        gTotals.reset();
+        payload_.assign(32, 0x5a);
+        sentBefore_ = gFake.getRtsdSent();
+    }
+
+    void TearDown() override {
+        gFake.setRtsdCompletion(zego_fake_rtsd_completion_async, 0);
+        gFake.releaseRtsd(0);
+    }
+
+    void sendSingles(unsigned int count) {
+        for (unsigned int i = 0; i < count; i++) {
+            gFake.manager->sendRealTimeSequentialData(
+                payload_.data(), static_cast<unsigned int>(payload_.size()), kStreamID,
+                [](int errorCode) {
+                    if (errorCode != 0) {
+                        gTotals.singlesFailed.fetch_add(1);
+                        if (errorCode != ZEGO_FAKE_RTSD_ERROR) {
+                            gTotals.wrongError.fetch_add(1);
+                        }
+                    }
+                    gTotals.singles.fetch_add(1);
+                });
+        }
+    }
+
+    void sendBatches(unsigned int batches, unsigned int size) {
+        std::vector<ZegoRealTimeSequentialDataMessage> messages(size);
+        for (ZegoRealTimeSequentialDataMessage &message : messages) {
+            message.data = payload_.data();
+            message.dataLength = static_cast<unsigned int>(payload_.size());
+        }
+        for (unsigned int i = 0; i < batches; i++) {
+            gFake.manager->sendRealTimeSequentialDataBatch(
+                messages.data(), size, kStreamID, [](int errorCode, unsigned int failedCount) {
+                    if ((errorCode != 0) != (failedCount != 0) ||
+                        (errorCode != 0 && errorCode != ZEGO_FAKE_RTSD_ERROR)) {
+                        gTotals.wrongError.fetch_add(1);
+                    }
+                    gTotals.batchesFailed.fetch_add(failedCount);
+                    gTotals.batches.fetch_add(1);
+                });
+        }
+    }
+
+    // |singles| single sends and |batches| batches of |batchSize| on each of kThreads threads
+    void sendFromThreads(unsigned int singles, unsigned int batches, unsigned int batchSize) {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < kThreads; t++) {
+            threads.emplace_back([=]() {
+                // Interleaved, so singles and batches share the slab
+                for (unsigned int i = 0; i < batches; i++) {
+                    sendSingles(singles / batches);
+                    sendBatches(1, batchSize);
+                }
+                sendSingles(singles % batches);
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    bool waitForTotals(unsigned long long singles, unsigned long long batches) {
+        return WaitFor(
+            [&]() {
+                return gTotals.singles.load() >= singles && gTotals.batches.load() >= batches;
+            },
+            10000);
+    }
+
+    // Sends since SetUp that the fake failed with every |failEvery|th send
+    unsigned long long expectedFailures(unsigned int failEvery) const {
+        const unsigned long long sent = gFake.getRtsdSent();
+        return sent / failEvery - sentBefore_ / failEvery;
+    }
+
+    void expectExactTotals(unsigned long long singles, unsigned long long batches,
+                           unsigned int failEvery) {
+        ASSERT_TRUE(waitForTotals(singles, batches))
+            << gTotals.singles.load() << "/" << singles << " singles, " << gTotals.batches.load()
+            << "/" << batches << " batches";
+        // Anything delivered twice shows up once the dispatcher has drained
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(gTotals.singles.load(), singles);
+        EXPECT_EQ(gTotals.batches.load(), batches);
+        EXPECT_EQ(gTotals.wrongError.load(), 0u);
+        EXPECT_EQ(gTotals.singlesFailed.load() + gTotals.batchesFailed.load(),
+                  expectedFailures(failEvery));
+    }
+
+    std::vector<unsigned char> payload_;
+    unsigned long long sentBefore_ = 0;
+};
+
+TEST_F(RtsdManagerTest, AsyncSinglesAndBatchesFromThreads) {
+    gFake.setRtsdCompletion(zego_fake_rtsd_completion_async, 7);
+    sendFromThreads(600, 12, 50);
+    EXPECT_EQ(gFake.getRtsdSent() - sentBefore_, kThreads * (600 + 12 * 50));
+    expectExactTotals(kThreads * 600, kThreads * 12, 7);
+}
+
+TEST_F(RtsdManagerTest, InlineSinglesAndBatchesFromThreads) {
+    gFake.setRtsdCompletion(zego_fake_rtsd_completion_inline, 5);
+    sendFromThreads(600, 12, 50);
+    expectExactTotals(kThreads * 600, kThreads * 12, 5);
+}
+
+TEST_F(RtsdManagerTest, HeldBeyondSlabCapacityReleasedInOrder) {
+    gFake.setRtsdCompletion(zego_fake_rtsd_completion_held, 3);
+    sendFromThreads(400, 4, 100);
+    const unsigned long long inFlight = gFake.getRtsdSent() - sentBefore_;
+    ASSERT_GT(inFlight, 2ull * Slab::kSlots);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(gTotals.singles.load() + gTotals.batches.load(), 0u);
+
+    EXPECT_EQ(gFake.releaseRtsd(0), inFlight);
+    expectExactTotals(kThreads * 400, kThreads * 4, 3);
+}
+
+TEST_F(RtsdManagerTest, HeldBeyondSlabCapacityReleasedNewestFirst) {
+    gFake.setRtsdCompletion(zego_fake_rtsd_completion_held, 4);
+    sendFromThreads(400, 4, 100);
+    const unsigned long long inFlight = gFake.getRtsdSent() - sentBefore_;
+    ASSERT_GT(inFlight, 2ull * Slab::kSlots);
+
+    // The newest seqs find their slots held by older ones and complete from the overflow map
+    EXPECT_EQ(gFake.releaseRtsd(1), inFlight);
+    expectExactTotals(kThreads * 400, kThreads * 4, 4);
+}
+
+TEST_F(RtsdManagerTest, InlineCompletionsWhileEverySlotIsHeld) {
+    gFake.setRtsdCompletion(zego_fake_rtsd_completion_held, 6);
+    sendSingles(Slab::kSlots + 100);
+
+    // Every slot is held now, so these complete into the early map before their sender
+    // registers, from several threads at once
+    gFake.setRtsdCompletion(zego_fake_rtsd_completion_inline, 6);
+    sendFromThreads(200, 2, 30);
+    ASSERT_TRUE(waitForTotals(kThreads * 200, kThreads * 2));
+    EXPECT_EQ(gTotals.singles.load(), kThreads * 200);
+
+    EXPECT_EQ(gFake.releaseRtsd(1), Slab::kSlots + 100);
+    expectExactTotals(Slab::kSlots + 100 + kThreads * 200, kThreads * 2, 6);
+}
+
+TEST_F(RtsdManagerTest, EmptyBatchReportsSuccess) {
+    sendBatches(1, 0);
+    expectExactTotals(0, 1, 1);
+}
+
+} // namespace
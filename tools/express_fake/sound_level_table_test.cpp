@@ -0,0 +1,229 @@
+// ZegoExpressSoundLevelTable (internal/ZegoInternalSoundLevelTable.hpp) on its own, written through
+// the update functions the C callbacks call and read as readSoundLevelSnapshot does.
+//
+// Every update writes one value into all of its streams, so a snapshot mixing two updates shows
+// up as unequal values. The tests read while a writer publishes, check that the reader never sees
+// such a mix or a sequence going back, and that reads into a reused snapshot do not allocate.
+// Run under -fsanitize=thread to have the copy itself checked as well.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "ZegoExpressSDK.h"
+
+using namespace ZEGO::EXPRESS;
+
+namespace {
+
+std::atomic<unsigned long long> gAllocations{0};
+
+} // namespace
+
+// Counts every allocation of the process. Not inlined, or GCC pairs the free() below with the
+// new expressions it was inlined into and reports a mismatch.
+__attribute__((noinline)) void *operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+
+__attribute__((noinline)) void operator delete(void *p, std::size_t) noexcept { free(p); }
+
+namespace {
+
+const unsigned int kStreams = 64;
+const unsigned int kBins = 16;
+const unsigned int kMixerEntries = 8;
+
+// One update's worth of C structs, every value set to |value|
+struct Update {
+    std::vector<zego_sound_level_info> levels;
+    std::vector<zego_audio_spectrum_info> spectrums;
+    std::vector<zego_mixer_sound_level_info> mixer;
+    std::vector<float> bins;
+
+    Update() : levels(kStreams), spectrums(kStreams), mixer(kMixerEntries), bins(kBins) {
+        for (unsigned int i = 0; i < kStreams; i++) {
+            snprintf(levels[i].stream_id, sizeof(levels[i].stream_id), "level-stream-%u", i);
+            snprintf(spectrums[i].stream_id, sizeof(spectrums[i].stream_id), "level-stream-%u",
+                     i);
+            spectrums[i].spectrum_list = bins.data();
+            spectrums[i].spectrum_count = kBins;
+        }
+        for (unsigned int i = 0; i < kMixerEntries; i++) {
+            mixer[i].sound_level_id = i + 1;
+        }
+    }
+
+    void publish(float value) {
+        for (zego_sound_level_info &info : levels) {
+            info.sound_level = value;
+            info.vad = static_cast<int>(value);
+        }
+        for (float &bin : bins) {
+            bin = value;
+        }
+        for (zego_mixer_sound_level_info &info : mixer) {
+            info.sound_level = value;
+        }
+        oInternalSoundLevelTable->updateSoundLevels(levels.data(), kStreams, true);
+        oInternalSoundLevelTable->updateSpectrums(spectrums.data(), kStreams);
+        oInternalSoundLevelTable->updateMixerSoundLevels(mixer.data(), kMixerEntries);
+    }
+};
+
+// All values of a section are the same, or the copy mixed two updates
+template <typename T> bool Uniform(const std::vector<T> &values, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        if (values[i] != values[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class SoundLevelTableTest : public ::testing::Test {
+  protected:
+    static void SetUpTestCase() { oInternalSoundLevelTable->enable(true); }
+};
+
+TEST_F(SoundLevelTableTest, SnapshotMatchesLastUpdate) {
+    Update update;
+    update.publish(42.0f);
+
+    ZegoSoundLevelSnapshot snapshot;
+    oInternalSoundLevelTable->read(snapshot);
+    ZegoStreamHandle handle = oInternalSoundLevelTable->find("level-stream-5");
+    ASSERT_NE(handle, ZEGO_STREAM_HANDLE_INVALID);
+    ASSERT_GT(snapshot.soundLevels.size(), handle);
+    EXPECT_EQ(snapshot.soundLevels[handle], 42.0f);
+    EXPECT_EQ(snapshot.vad[handle], 42);
+    EXPECT_EQ(snapshot.spectrums[handle * snapshot.spectrumStride + kBins - 1], 42.0f);
+    // Bins the update did not fill read 0
+    EXPECT_EQ(snapshot.spectrums[handle * snapshot.spectrumStride + kBins], 0.0f);
+    ASSERT_EQ(snapshot.mixerSoundLevels.size(), kMixerEntries);
+    EXPECT_EQ(snapshot.mixerSoundLevelIDs[kMixerEntries - 1], kMixerEntries);
+    EXPECT_EQ(snapshot.mixerSoundLevels[0], 42.0f);
+
+    // No new update, same sequences
+    ZegoSoundLevelSnapshot again;
+    oInternalSoundLevelTable->read(again);
+    EXPECT_EQ(again.sequence, snapshot.sequence);
+    EXPECT_EQ(again.spectrumSequence, snapshot.spectrumSequence);
+    EXPECT_EQ(again.mixerSequence, snapshot.mixerSequence);
+}
+
+TEST_F(SoundLevelTableTest, StreamsLeftOutOfAnUpdateReadZero) {
+    Update update;
+    update.publish(9.0f);
+    ZegoStreamHandle last = oInternalSoundLevelTable->find("level-stream-63");
+    ASSERT_NE(last, ZEGO_STREAM_HANDLE_INVALID);
+
+    // Only the first stream, twice so both buffers held all streams before, then only the last:
+    // every stream in between reads 0 although neither update wrote it
+    update.levels.resize(1);
+    update.spectrums.resize(1);
+    for (int i = 0; i < 2; i++) {
+        oInternalSoundLevelTable->updateSoundLevels(update.levels.data(), 1, true);
+        oInternalSoundLevelTable->updateSpectrums(update.spectrums.data(), 1);
+    }
+    Update only;
+    only.levels[kStreams - 1].sound_level = 3.0f;
+    for (int i = 0; i < 2; i++) {
+        oInternalSoundLevelTable->updateSoundLevels(&only.levels[kStreams - 1], 1, true);
+        oInternalSoundLevelTable->updateSpectrums(&only.spectrums[kStreams - 1], 1);
+    }
+
+    ZegoSoundLevelSnapshot snapshot;
+    oInternalSoundLevelTable->read(snapshot);
+    ASSERT_GT(snapshot.soundLevels.size(), last);
+    for (size_t i = 0; i < snapshot.soundLevels.size(); i++) {
+        if (i != last) {
+            EXPECT_EQ(snapshot.soundLevels[i], 0.0f) << i;
+            EXPECT_EQ(snapshot.vad[i], 0) << i;
+            EXPECT_EQ(snapshot.spectrums[i * snapshot.spectrumStride], 0.0f) << i;
+        }
+    }
+    EXPECT_EQ(snapshot.soundLevels[last], 3.0f);
+    EXPECT_EQ(snapshot.overflowCount, 0u);
+}
+
+TEST_F(SoundLevelTableTest, ReadsNeverMixUpdates) {
+    Update first;
+    first.publish(0.0f);
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&]() {
+        Update update;
+        float value = 1.0f;
+        while (!stop.load(std::memory_order_relaxed)) {
+            update.publish(value);
+            value = value < 100.0f ? value + 1.0f : 1.0f;
+        }
+    });
+
+    ZegoSoundLevelSnapshot snapshot;
+    unsigned long long lastSequence = 0;
+    unsigned int mixed = 0;
+    unsigned int backwards = 0;
+    unsigned int changed = 0;
+    for (int i = 0; i < 20000; i++) {
+        oInternalSoundLevelTable->read(snapshot);
+        const size_t streams = snapshot.soundLevels.size();
+        if (!Uniform(snapshot.soundLevels, streams) || !Uniform(snapshot.vad, streams) ||
+            !Uniform(snapshot.mixerSoundLevels, snapshot.mixerSoundLevels.size())) {
+            mixed++;
+        }
+        // Only the filled bins of each stream carry the value
+        const size_t spectrumStreams = snapshot.spectrums.size() / snapshot.spectrumStride;
+        for (size_t s = 0; s < spectrumStreams; s++) {
+            const float *bins = &snapshot.spectrums[s * snapshot.spectrumStride];
+            if (bins[0] != snapshot.spectrums[0] || bins[kBins - 1] != snapshot.spectrums[0]) {
+                mixed++;
+                break;
+            }
+        }
+        if (snapshot.sequence < lastSequence) {
+            backwards++;
+        }
+        changed += snapshot.sequence != lastSequence ? 1 : 0;
+        lastSequence = snapshot.sequence;
+    }
+    stop.store(true);
+    writer.join();
+
+    EXPECT_EQ(mixed, 0u);
+    EXPECT_EQ(backwards, 0u);
+    EXPECT_GT(changed, 1u);
+}
+
+TEST_F(SoundLevelTableTest, ReusedSnapshotReadsWithoutAllocating) {
+    Update update;
+    update.publish(7.0f);
+    ZegoSoundLevelSnapshot snapshot;
+    oInternalSoundLevelTable->read(snapshot);
+
+    unsigned long long allocations = 0;
+    for (int i = 0; i < 100; i++) {
+        update.publish(static_cast<float>(i));
+        const unsigned long long before = gAllocations.load();
+        oInternalSoundLevelTable->read(snapshot);
+        allocations += gAllocations.load() - before;
+    }
+    EXPECT_EQ(allocations, 0u);
+    ASSERT_FALSE(snapshot.soundLevels.empty());
+    EXPECT_EQ(snapshot.soundLevels.back(), 99.0f);
+}
+
+} // namespace
@@ -0,0 +1,792 @@
+// Offline stand-in for the Express SDK library, see zego_express_fake.h.
+//
+// The C API headers are included without ZEGOEXP_EXPLICIT, so every function below is checked
+// against the prototype the wrapper loads it as.
+
+#include "zego_express_fake.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "internal/ZegoInternalPrivate.h"
+#include "internal/include/zego-express-custom-audio-io.h"
+#include "internal/include/zego-express-custom-video-io.h"
+#include "internal/include/zego-express-device.h"
+#include "internal/include/zego-express-engine.h"
+#include "internal/include/zego-express-im.h"
+#include "internal/include/zego-express-player.h"
+#include "internal/include/zego-express-publisher.h"
+#include "internal/include/zego-express-room.h"
+
+namespace {
+
+const unsigned int kMaxStreams = 64;
+const unsigned int kAudioFrameBytes = 480 * 2 * sizeof(short); // 10 ms of 48 kHz stereo
+
+// A registered C callback. The wrapper re-registers (and clears) callbacks while events may be
+// raised on other threads, so both halves are atomic; a stale context only ever pairs with the
+// function registered next to it, since the wrapper always passes the same one.
+template <typename F> struct Registration {
+    std::atomic<F> func{nullptr};
+    std::atomic<void *> context{nullptr};
+
+    void set(F f, void *c) {
+        context.store(c, std::memory_order_relaxed);
+        func.store(f, std::memory_order_release);
+    }
+};
+
+struct Stream {
+    zego_stream info;
+    bool listed = true;
+};
+
+class FakeEngine {
+  public:
+    static FakeEngine *instance() {
+        static FakeEngine engine;
+        return &engine;
+    }
+
+    Registration<zego_on_engine_uninit> uninitCallback;
+    Registration<zego_on_remote_sound_level_update> soundLevelCallback;
+    Registration<zego_on_player_quality_update> qualityCallback;
+    Registration<zego_on_player_recv_media_side_info> seiCallback;
+    Registration<zego_on_player_audio_data> audioFrameCallback;
+    Registration<zego_on_custom_video_render_remote_frame_data> videoFrameCallback;
+    Registration<zego_on_room_stream_update> roomUpdateCallback;
+    Registration<zego_on_real_time_sequential_data_sent> rtsdSentCallback;
+
+    std::atomic<bool> soundLevelMonitor{false};
+    std::atomic<unsigned int> audioObserverMask{0};
+    std::atomic<bool> customVideoRender{false};
+    std::atomic<long long> sequence{0};
+    std::atomic<int> rtsdManagers{0};
+
+    void setConfig(const zego_fake_config &config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = config;
+    }
+
+    void initialize() {
+        stop();
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = pending_;
+        applyEnvironment(config_);
+        config_.stream_count = std::max(1u, std::min(config_.stream_count, kMaxStreams));
+        config_.video_width = std::max(2, config_.video_width) & ~1;
+        config_.video_height = std::max(2, config_.video_height) & ~1;
+
+        streams_.assign(config_.stream_count, Stream());
+        soundLevels_.assign(config_.stream_count, zego_sound_level_info());
+        for (unsigned int i = 0; i < config_.stream_count; i++) {
+            Stream &stream = streams_[i];
+            memset(&stream.info, 0, sizeof(stream.info));
+            snprintf(stream.info.stream_id, sizeof(stream.info.stream_id), "fake-stream-%u", i);
+            snprintf(stream.info.user.user_id, sizeof(stream.info.user.user_id), "fake-user-%u", i);
+            snprintf(stream.info.user.user_name, sizeof(stream.info.user.user_name),
+                     "Fake User %u", i);
+            memcpy(soundLevels_[i].stream_id, stream.info.stream_id,
+                   sizeof(soundLevels_[i].stream_id));
+        }
+        sei_.assign(config_.sei_size, 0x5a);
+        audio_.assign(kAudioFrameBytes, 0);
+        const size_t lumaSize = static_cast<size_t>(config_.video_width) * config_.video_height;
+        video_.assign(lumaSize * 3 / 2, 0x80);
+
+        for (int i = 0; i < zego_fake_event_count; i++) {
+            cursor_[i].store(0, std::memory_order_relaxed);
+            emitted_[i].store(0, std::memory_order_relaxed);
+        }
+        const char *rates = getenv("ZEGO_FAKE_RATES");
+        if (rates != nullptr) {
+            parseRates(rates);
+        }
+        stop_ = false;
+        thread_ = std::thread(&FakeEngine::run, this);
+
+        std::lock_guard<std::mutex> rtsdLock(rtsdMutex_);
+        rtsdStop_ = false;
+        rtsdThread_ = std::thread(&FakeEngine::runRtsd, this);
+    }
+
+    void uninitialize() {
+        stop();
+        soundLevelMonitor = false;
+        audioObserverMask = 0;
+        customVideoRender = false;
+        auto func = uninitCallback.func.load(std::memory_order_acquire);
+        if (func != nullptr) {
+            func(uninitCallback.context.load(std::memory_order_relaxed));
+        }
+    }
+
+    void setRate(zego_fake_event event, double perSecond) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rates_[event] = perSecond > 0 ? perSecond : 0;
+            due_[event] = std::chrono::steady_clock::now() + period(event);
+        }
+        wakeup_.notify_one();
+    }
+
+    unsigned int emit(zego_fake_event event, unsigned int count) {
+        unsigned int invoked = 0;
+        for (unsigned int i = 0; i < count; i++) {
+            if (!emitOne(event)) {
+                break;
+            }
+            invoked++;
+        }
+        emitted_[event].fetch_add(invoked, std::memory_order_relaxed);
+        return invoked;
+    }
+
+    unsigned long long emitted(zego_fake_event event) {
+        return emitted_[event].load(std::memory_order_relaxed);
+    }
+
+    void setRtsdCompletion(zego_fake_rtsd_completion mode, unsigned int failEvery) {
+        rtsdMode_.store(mode, std::memory_order_relaxed);
+        rtsdFailEvery_.store(failEvery, std::memory_order_relaxed);
+    }
+
+    zego_seq sendRtsd(int instanceIndex) {
+        RtsdCompletion completion;
+        completion.instanceIndex = instanceIndex;
+        completion.seq = static_cast<zego_seq>(sequence.fetch_add(1) + 1);
+        const unsigned long long sent = rtsdSent_.fetch_add(1, std::memory_order_relaxed) + 1;
+        const unsigned int failEvery = rtsdFailEvery_.load(std::memory_order_relaxed);
+        completion.errorCode = failEvery != 0 && sent % failEvery == 0 ? ZEGO_FAKE_RTSD_ERROR : 0;
+        const zego_fake_rtsd_completion mode = rtsdMode_.load(std::memory_order_relaxed);
+        if (mode == zego_fake_rtsd_completion_inline) {
+            completeRtsd(completion);
+            return completion.seq;
+        }
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(rtsdMutex_);
+            if (mode == zego_fake_rtsd_completion_held) {
+                rtsdHeld_.push_back(completion);
+                return completion.seq;
+            }
+            wake = rtsdPending_.empty();
+            rtsdPending_.push_back(completion);
+        }
+        if (wake) {
+            rtsdWakeup_.notify_one();
+        }
+        return completion.seq;
+    }
+
+    unsigned int releaseRtsd(bool reverse) {
+        std::vector<RtsdCompletion> completions;
+        {
+            std::lock_guard<std::mutex> lock(rtsdMutex_);
+            completions.swap(rtsdHeld_);
+        }
+        if (reverse) {
+            std::reverse(completions.begin(), completions.end());
+        }
+        for (const RtsdCompletion &completion : completions) {
+            completeRtsd(completion);
+        }
+        return static_cast<unsigned int>(completions.size());
+    }
+
+    unsigned long long rtsdSent() { return rtsdSent_.load(std::memory_order_relaxed); }
+
+  private:
+    FakeEngine() {
+        pending_.stream_count = 4;
+        pending_.sei_size = 64;
+        pending_.video_width = 640;
+        pending_.video_height = 360;
+        config_ = pending_;
+        for (int i = 0; i < zego_fake_event_count; i++) {
+            rates_[i] = 0;
+        }
+    }
+
+    ~FakeEngine() { stop(); }
+
+    static void applyEnvironment(zego_fake_config &config) {
+        const char *value = getenv("ZEGO_FAKE_STREAMS");
+        if (value != nullptr) {
+            config.stream_count = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+        }
+        value = getenv("ZEGO_FAKE_SEI_SIZE");
+        if (value != nullptr) {
+            config.sei_size = static_cast<unsigned int>(strtoul(value, nullptr, 10));
+        }
+        value = getenv("ZEGO_FAKE_VIDEO_SIZE");
+        int width = 0;
+        int height = 0;
+        if (value != nullptr && sscanf(value, "%dx%d", &width, &height) == 2) {
+            config.video_width = width;
+            config.video_height = height;
+        }
+    }
+
+    // "name=rate,name=rate", called with |mutex_| held.
+    void parseRates(const char *rates) {
+        static const char *const names[zego_fake_event_count] = {
+            "sound_level", "quality", "sei", "audio_frame", "video_frame", "room_update"};
+        std::string list = rates;
+        size_t begin = 0;
+        while (begin < list.size()) {
+            size_t end = list.find(',', begin);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            std::string item = list.substr(begin, end - begin);
+            size_t equals = item.find('=');
+            for (int i = 0; equals != std::string::npos && i < zego_fake_event_count; i++) {
+                if (item.compare(0, equals, names[i]) == 0) {
+                    rates_[i] = std::max(0.0, atof(item.c_str() + equals + 1));
+                }
+            }
+            begin = end + 1;
+        }
+        auto now = std::chrono::steady_clock::now();
+        for (int i = 0; i < zego_fake_event_count; i++) {
+            due_[i] = now + period(zego_fake_event(i));
+        }
+    }
+
+    std::chrono::steady_clock::duration period(zego_fake_event event) const {
+        if (rates_[event] <= 0) {
+            return std::chrono::hours(1);
+        }
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / rates_[event]));
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wakeup_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(rtsdMutex_);
+            // Held completions are drained with the rest
+            rtsdPending_.insert(rtsdPending_.end(), rtsdHeld_.begin(), rtsdHeld_.end());
+            rtsdHeld_.clear();
+            rtsdStop_ = true;
+        }
+        rtsdWakeup_.notify_one();
+        if (rtsdThread_.joinable()) {
+            rtsdThread_.join();
+        }
+    }
+
+    // The event thread, standing in for the SDK's internal threads. Events that fall behind
+    // schedule are raised back to back until caught up, but never more than a second's worth.
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            auto now = std::chrono::steady_clock::now();
+            auto next = now + std::chrono::hours(1);
+            for (int i = 0; i < zego_fake_event_count; i++) {
+                if (rates_[i] <= 0) {
+                    continue;
+                }
+                zego_fake_event event = zego_fake_event(i);
+                if (due_[i] <= now) {
+                    due_[i] = std::max(due_[i], now - std::chrono::seconds(1)) + period(event);
+                    lock.unlock();
+                    emit(event, 1);
+                    lock.lock();
+                }
+                next = std::min(next, due_[i]);
+            }
+            wakeup_.wait_until(lock, next);
+        }
+    }
+
+    struct RtsdCompletion {
+        zego_error errorCode;
+        int instanceIndex;
+        zego_seq seq;
+    };
+
+    void completeRtsd(const RtsdCompletion &completion) {
+        auto func = rtsdSentCallback.func.load(std::memory_order_acquire);
+        if (func != nullptr) {
+            func(completion.errorCode, completion.instanceIndex, completion.seq,
+                 rtsdSentCallback.context.load(std::memory_order_relaxed));
+        }
+    }
+
+    // The completion thread. Takes whatever has been queued at once and drains the queue
+    // before it exits.
+    void runRtsd() {
+        std::vector<RtsdCompletion> completions;
+        std::unique_lock<std::mutex> lock(rtsdMutex_);
+        for (;;) {
+            rtsdWakeup_.wait(lock, [this]() { return rtsdStop_ || !rtsdPending_.empty(); });
+            if (rtsdPending_.empty()) {
+                return;
+            }
+            completions.swap(rtsdPending_);
+            lock.unlock();
+            for (const RtsdCompletion &completion : completions) {
+                completeRtsd(completion);
+            }
+            completions.clear();
+            lock.lock();
+        }
+    }
+
+    unsigned int nextStream(zego_fake_event event) {
+        return static_cast<unsigned int>(cursor_[event].fetch_add(1, std::memory_order_relaxed) %
+                                         streams_.size());
+    }
+
+    bool emitOne(zego_fake_event event) {
+        switch (event) {
+        case zego_fake_event_sound_level: {
+            auto func = soundLevelCallback.func.load(std::memory_order_acquire);
+            if (func == nullptr || !soundLevelMonitor.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(emitMutex_);
+            unsigned int tick = nextStream(event);
+            for (size_t i = 0; i < soundLevels_.size(); i++) {
+                soundLevels_[i].sound_level = static_cast<float>((tick + i * 7) % 100);
+            }
+            func(soundLevels_.data(), static_cast<unsigned int>(soundLevels_.size()),
+                 soundLevelCallback.context.load(std::memory_order_relaxed));
+            return true;
+        }
+        case zego_fake_event_quality: {
+            auto func = qualityCallback.func.load(std::memory_order_acquire);
+            if (func == nullptr) {
+                return false;
+            }
+            const Stream &stream = streams_[nextStream(event)];
+            zego_play_stream_quality playQuality;
+            memset(&playQuality, 0, sizeof(playQuality));
+            playQuality.video_recv_fps = 30;
+            playQuality.video_dejitter_fps = 30;
+            func(stream.info.stream_id, playQuality,
+                 qualityCallback.context.load(std::memory_order_relaxed));
+            return true;
+        }
+        case zego_fake_event_sei: {
+            auto func = seiCallback.func.load(std::memory_order_acquire);
+            if (func == nullptr) {
+                return false;
+            }
+            const Stream &stream = streams_[nextStream(event)];
+            zego_media_side_info info;
+            memset(&info, 0, sizeof(info));
+            memcpy(info.stream_id, stream.info.stream_id, sizeof(info.stream_id));
+            info.sei_data = sei_.data();
+            info.sei_data_length = static_cast<unsigned int>(sei_.size());
+            info.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count();
+            func(info, seiCallback.context.load(std::memory_order_relaxed));
+            return true;
+        }
+        case zego_fake_event_audio_frame: {
+            auto func = audioFrameCallback.func.load(std::memory_order_acquire);
+            if (func == nullptr || (audioObserverMask.load(std::memory_order_relaxed) &
+                                    zego_audio_data_callback_bit_mask_player) == 0) {
+                return false;
+            }
+            const Stream &stream = streams_[nextStream(event)];
+            zego_audio_frame_param param;
+            param.sample_rate = zego_audio_sample_rate_48k;
+            param.channel = zego_audio_channel_stereo;
+            func(audio_.data(), static_cast<unsigned int>(audio_.size()), param,
+                 stream.info.stream_id, audioFrameCallback.context.load(std::memory_order_relaxed));
+            return true;
+        }
+        case zego_fake_event_video_frame: {
+            auto func = videoFrameCallback.func.load(std::memory_order_acquire);
+            if (func == nullptr || !customVideoRender.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            const Stream &stream = streams_[nextStream(event)];
+            const int width = config_.video_width;
+            const int height = config_.video_height;
+            const unsigned int lumaSize = static_cast<unsigned int>(width * height);
+            unsigned char *planes[4] = {video_.data(), video_.data() + lumaSize,
+                                        video_.data() + lumaSize * 5 / 4, nullptr};
+            unsigned int lengths[4] = {lumaSize, lumaSize / 4, lumaSize / 4, 0};
+            zego_video_frame_param param;
+            memset(&param, 0, sizeof(param));
+            param.format = zego_video_frame_format_i420;
+            param.strides[0] = width;
+            param.strides[1] = width / 2;
+            param.strides[2] = width / 2;
+            param.width = width;
+            param.height = height;
+            func(stream.info.stream_id, planes, lengths, param,
+                 videoFrameCallback.context.load(std::memory_order_relaxed));
+            return true;
+        }
+        case zego_fake_event_room_update: {
+            auto func = roomUpdateCallback.func.load(std::memory_order_acquire);
+            if (func == nullptr) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(emitMutex_);
+            Stream &stream = streams_[nextStream(event)];
+            stream.listed = !stream.listed;
+            func("fake-room", stream.listed ? zego_update_type_add : zego_update_type_delete,
+                 &stream.info, 1, "", roomUpdateCallback.context.load(std::memory_order_relaxed));
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::thread thread_;
+    bool stop_ = true;
+    zego_fake_config pending_;
+    zego_fake_config config_;
+    double rates_[zego_fake_event_count];
+    std::chrono::steady_clock::time_point due_[zego_fake_event_count];
+
+    // Built by init() before the event thread starts and only read afterwards.
+    std::vector<Stream> streams_;
+    std::vector<zego_sound_level_info> soundLevels_;
+    std::vector<unsigned char> sei_;
+    std::vector<unsigned char> audio_;
+    std::vector<unsigned char> video_;
+
+    // Serializes the events that update shared state: sound levels and stream listing.
+    std::mutex emitMutex_;
+    std::atomic<unsigned long long> cursor_[zego_fake_event_count];
+    std::atomic<unsigned long long> emitted_[zego_fake_event_count];
+
+    std::mutex rtsdMutex_;
+    std::condition_variable rtsdWakeup_;
+    std::thread rtsdThread_;
+    bool rtsdStop_ = true;
+    std::vector<RtsdCompletion> rtsdPending_;
+    std::vector<RtsdCompletion> rtsdHeld_;
+    std::atomic<zego_fake_rtsd_completion> rtsdMode_{zego_fake_rtsd_completion_async};
+    std::atomic<unsigned int> rtsdFailEvery_{0};
+    std::atomic<unsigned long long> rtsdSent_{0};
+};
+
+#define oFakeEngine FakeEngine::instance()
+
+} // namespace
+
+// Control interface.
+
+void zego_fake_set_config(const struct zego_fake_config *config) {
+    oFakeEngine->setConfig(*config);
+}
+
+void zego_fake_set_event_rate(enum zego_fake_event event, double per_second) {
+    if (event >= 0 && event < zego_fake_event_count) {
+        oFakeEngine->setRate(event, per_second);
+    }
+}
+
+unsigned int zego_fake_emit(enum zego_fake_event event, unsigned int count) {
+    if (event < 0 || event >= zego_fake_event_count) {
+        return 0;
+    }
+    return oFakeEngine->emit(event, count);
+}
+
+unsigned long long zego_fake_get_emitted(enum zego_fake_event event) {
+    if (event < 0 || event >= zego_fake_event_count) {
+        return 0;
+    }
+    return oFakeEngine->emitted(event);
+}
+
+void zego_fake_set_rtsd_completion(enum zego_fake_rtsd_completion mode, unsigned int fail_every) {
+    oFakeEngine->setRtsdCompletion(mode, fail_every);
+}
+
+unsigned int zego_fake_release_rtsd(int reverse) { return oFakeEngine->releaseRtsd(reverse != 0); }
+
+unsigned long long zego_fake_get_rtsd_sent(void) { return oFakeEngine->rtsdSent(); }
+
+// Engine lifecycle, the functions ZEGOEXP_LOAD_CORE_FUNC_PTR requires.
+
+zego_error zego_express_get_version(const char **version) {
+    *version = "fake";
+    return 0;
+}
+
+__attribute__((visibility("default"))) void
+zego_express_set_platform_language(enum zego_platform_language language) {
+    (void)language;
+}
+
+__attribute__((visibility("default"))) void
+zego_express_handle_api_call_result(const char *func_name, int error_code) {
+    (void)func_name;
+    (void)error_code;
+}
+
+zego_error zego_express_set_engine_config(struct zego_engine_config config) {
+    (void)config;
+    return 0;
+}
+
+zego_error zego_express_set_log_config(struct zego_log_config config) {
+    (void)config;
+    return 0;
+}
+
+zego_error zego_express_set_room_mode(enum zego_room_mode mode) {
+    (void)mode;
+    return 0;
+}
+
+zego_error zego_express_engine_init(unsigned int app_id, const char *app_sign, bool is_test_env,
+                                    enum zego_scenario scenario) {
+    (void)app_id;
+    (void)app_sign;
+    (void)is_test_env;
+    (void)scenario;
+    oFakeEngine->initialize();
+    return 0;
+}
+
+zego_error zego_express_engine_init_with_profile(struct zego_engine_profile profile) {
+    (void)profile;
+    oFakeEngine->initialize();
+    return 0;
+}
+
+// Stops the event thread, then reports completion on the calling thread.
+zego_error zego_express_engine_uninit_async(void) {
+    oFakeEngine->uninitialize();
+    return 0;
+}
+
+zego_seq zego_express_get_increase_seq() {
+    return static_cast<zego_seq>(oFakeEngine->sequence.fetch_add(1) + 1);
+}
+
+zego_error zego_express_login_room(const char *room_id, struct zego_user user,
+                                   struct zego_room_config *config) {
+    (void)room_id;
+    (void)user;
+    (void)config;
+    return 0;
+}
+
+zego_error zego_express_login_room_with_callback(const char *room_id, struct zego_user user,
+                                                 struct zego_room_config *config,
+                                                 zego_seq *sequence) {
+    *sequence = zego_express_get_increase_seq();
+    return zego_express_login_room(room_id, user, config);
+}
+
+zego_error zego_express_logout_room(const char *room_id) {
+    (void)room_id;
+    return 0;
+}
+
+zego_error zego_express_start_preview(struct zego_canvas *canvas,
+                                      enum zego_publish_channel channel) {
+    (void)canvas;
+    (void)channel;
+    return 0;
+}
+
+zego_error zego_express_stop_preview(enum zego_publish_channel channel) {
+    (void)channel;
+    return 0;
+}
+
+zego_error zego_express_start_publishing_stream(const char *stream_id,
+                                                enum zego_publish_channel channel) {
+    (void)stream_id;
+    (void)channel;
+    return 0;
+}
+
+zego_error zego_express_start_publishing_stream_with_config(const char *stream_id,
+                                                            struct zego_publisher_config config,
+                                                            enum zego_publish_channel channel) {
+    (void)stream_id;
+    (void)config;
+    (void)channel;
+    return 0;
+}
+
+zego_error zego_express_stop_publishing_stream(enum zego_publish_channel channel) {
+    (void)channel;
+    return 0;
+}
+
+zego_error zego_express_start_playing_stream(const char *stream_id, struct zego_canvas *canvas) {
+    (void)stream_id;
+    (void)canvas;
+    return 0;
+}
+
+zego_error zego_express_start_playing_stream_with_config(const char *stream_id,
+                                                         struct zego_canvas *canvas,
+                                                         struct zego_player_config config) {
+    (void)stream_id;
+    (void)canvas;
+    (void)config;
+    return 0;
+}
+
+zego_error zego_express_stop_playing_stream(const char *stream_id) {
+    (void)stream_id;
+    return 0;
+}
+
+// Features that gate events.
+
+zego_error zego_express_start_sound_level_monitor(unsigned int millisecond) {
+    (void)millisecond;
+    oFakeEngine->soundLevelMonitor = true;
+    return 0;
+}
+
+zego_error zego_express_start_sound_level_monitor_with_config(struct zego_sound_level_config config) {
+    return zego_express_start_sound_level_monitor(config.millisecond);
+}
+
+zego_error zego_express_stop_sound_level_monitor() {
+    oFakeEngine->soundLevelMonitor = false;
+    return 0;
+}
+
+zego_error zego_express_start_audio_data_observer(unsigned int observer_bit_mask,
+                                                  struct zego_audio_frame_param param) {
+    (void)param;
+    oFakeEngine->audioObserverMask = observer_bit_mask;
+    return 0;
+}
+
+zego_error zego_express_stop_audio_data_observer() {
+    oFakeEngine->audioObserverMask = 0;
+    return 0;
+}
+
+zego_error zego_express_enable_custom_video_render(bool enable,
+                                                   struct zego_custom_video_render_config *config) {
+    oFakeEngine->customVideoRender =
+        enable && config != nullptr && config->buffer_type == zego_video_buffer_type_raw_data;
+    return 0;
+}
+
+// Real-time sequential data.
+
+zego_error zego_express_create_real_time_sequential_data_manager(const char *room_id,
+                                                                 int *instance_index) {
+    (void)room_id;
+    *instance_index = oFakeEngine->rtsdManagers.fetch_add(1);
+    return 0;
+}
+
+zego_error zego_express_destroy_real_time_sequential_data_manager(int instance_index) {
+    (void)instance_index;
+    return 0;
+}
+
+zego_error zego_express_real_time_sequential_data_start_broadcasting(const char *stream_id,
+                                                                     int instance_index) {
+    (void)stream_id;
+    (void)instance_index;
+    return 0;
+}
+
+zego_error zego_express_real_time_sequential_data_stop_broadcasting(const char *stream_id,
+                                                                    int instance_index) {
+    (void)stream_id;
+    (void)instance_index;
+    return 0;
+}
+
+zego_error zego_express_real_time_sequential_data_start_subscribing(const char *stream_id,
+                                                                    int instance_index) {
+    (void)stream_id;
+    (void)instance_index;
+    return 0;
+}
+
+zego_error zego_express_real_time_sequential_data_stop_subscribing(const char *stream_id,
+                                                                   int instance_index) {
+    (void)stream_id;
+    (void)instance_index;
+    return 0;
+}
+
+zego_error zego_express_send_real_time_sequential_data(const unsigned char *data,
+                                                       unsigned int data_length,
+                                                       const char *stream_id, int instance_index,
+                                                       zego_seq *sequence) {
+    (void)data;
+    (void)data_length;
+    (void)stream_id;
+    *sequence = oFakeEngine->sendRtsd(instance_index);
+    return 0;
+}
+
+// Callback registration.
+
+void zego_register_engine_uninit_callback(zego_on_engine_uninit callback_func,
+                                          void *user_context) {
+    oFakeEngine->uninitCallback.set(callback_func, user_context);
+}
+
+void zego_register_remote_sound_level_update_callback(
+    zego_on_remote_sound_level_update callback_func, void *user_context) {
+    oFakeEngine->soundLevelCallback.set(callback_func, user_context);
+}
+
+void zego_register_player_quality_update_callback(zego_on_player_quality_update callback_func,
+                                                  void *user_context) {
+    oFakeEngine->qualityCallback.set(callback_func, user_context);
+}
+
+void zego_register_player_recv_media_side_info_callback(
+    zego_on_player_recv_media_side_info callback_func, void *user_context) {
+    oFakeEngine->seiCallback.set(callback_func, user_context);
+}
+
+void zego_register_player_audio_data_callback(zego_on_player_audio_data callback_func,
+                                              void *user_context) {
+    oFakeEngine->audioFrameCallback.set(callback_func, user_context);
+}
+
+void zego_register_custom_video_render_remote_frame_data_callback(
+    zego_on_custom_video_render_remote_frame_data callback_func, void *user_context) {
+    oFakeEngine->videoFrameCallback.set(callback_func, user_context);
+}
+
+void zego_register_room_stream_update_callback(zego_on_room_stream_update callback_func,
+                                               void *user_context) {
+    oFakeEngine->roomUpdateCallback.set(callback_func, user_context);
+}
+
+void zego_register_real_time_sequential_data_sent_callback(
+    zego_on_real_time_sequential_data_sent callback_func, void *user_context) {
+    oFakeEngine->rtsdSentCallback.set(callback_func, user_context);
+}
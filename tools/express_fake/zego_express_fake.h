@@ -0,0 +1,107 @@
+#ifndef __ZEGO_EXPRESS_FAKE_H__
+#define __ZEGO_EXPRESS_FAKE_H__
+
+// Control interface of libzego_express_fake, an offline stand-in for the Express SDK library.
+//
+// The library exports the engine lifecycle, room, publish, play and real-time sequential data
+// functions of the C API and the registration functions of the callbacks below, so the C++
+// wrapper can load it through ZegoExpressSDK::loadLibrary with ZEGOEXP_EXPLICIT and
+// ZEGO_LIBRARY_BINDING_MODE_LAZY. Every other function is left unexported and reported missing by
+// getLibraryLoadReport.
+//
+// The fake models a room with a fixed set of remote streams, "fake-stream-0" onwards, that are
+// all being played. Events are raised either synchronously with zego_fake_emit or at a steady
+// rate by the fake's own event thread. As with the real SDK, sound levels need
+// startSoundLevelMonitor, audio frames need startAudioDataObserver with the player bit and
+// video frames need enableCustomVideoRender with raw data before the engine is created.
+//
+// Real-time sequential data managers accept every send and report it with
+// zego_on_real_time_sequential_data_sent, see zego_fake_set_rtsd_completion for when.
+//
+// Resolve these functions with dlsym on the handle of the same library file.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum zego_fake_event {
+    /// zego_on_remote_sound_level_update carrying every stream.
+    zego_fake_event_sound_level = 0,
+    /// zego_on_player_quality_update of the next stream.
+    zego_fake_event_quality = 1,
+    /// zego_on_player_recv_media_side_info of the next stream.
+    zego_fake_event_sei = 2,
+    /// zego_on_player_audio_data of the next stream, 10 ms of 48 kHz stereo PCM.
+    zego_fake_event_audio_frame = 3,
+    /// zego_on_custom_video_render_remote_frame_data of the next stream, one I420 frame.
+    zego_fake_event_video_frame = 4,
+    /// zego_on_room_stream_update deleting or re-adding the next stream.
+    zego_fake_event_room_update = 5,
+    zego_fake_event_count = 6
+};
+
+struct zego_fake_config {
+    /// Remote streams in the room, 1 to 64. Default 4.
+    unsigned int stream_count;
+    /// SEI payload bytes. Default 64.
+    unsigned int sei_size;
+    /// Remote video frame size. Default 640x360.
+    int video_width;
+    int video_height;
+};
+
+enum zego_fake_rtsd_completion {
+    /// From the fake's completion thread, in send order, like the SDK's network thread. Default.
+    zego_fake_rtsd_completion_async = 0,
+    /// On the sending thread before zego_express_send_real_time_sequential_data returns, that is
+    /// before the caller has the seq.
+    zego_fake_rtsd_completion_inline = 1,
+    /// Not until zego_fake_release_rtsd, so any number of sends can be kept in flight.
+    zego_fake_rtsd_completion_held = 2
+};
+
+/// Error code of the sends zego_fake_set_rtsd_completion makes fail.
+#define ZEGO_FAKE_RTSD_ERROR 1000001
+
+typedef void (*pfnzego_fake_set_config)(const struct zego_fake_config *config);
+typedef void (*pfnzego_fake_set_event_rate)(enum zego_fake_event event, double per_second);
+typedef unsigned int (*pfnzego_fake_emit)(enum zego_fake_event event, unsigned int count);
+typedef unsigned long long (*pfnzego_fake_get_emitted)(enum zego_fake_event event);
+typedef void (*pfnzego_fake_set_rtsd_completion)(enum zego_fake_rtsd_completion mode,
+                                                 unsigned int fail_every);
+typedef unsigned long long (*pfnzego_fake_get_rtsd_sent)(void);
+typedef unsigned int (*pfnzego_fake_release_rtsd)(int reverse);
+
+/// Takes effect on the next engine init. The environment variables ZEGO_FAKE_STREAMS,
+/// ZEGO_FAKE_SEI_SIZE and ZEGO_FAKE_VIDEO_SIZE (e.g. "1280x720") override the defaults.
+void zego_fake_set_config(const struct zego_fake_config *config);
+
+/// Callbacks per second raised by the event thread while the engine exists, 0 to stop. Rates
+/// can also be given as ZEGO_FAKE_RATES, e.g. "sound_level=10,quality=2,video_frame=60", which
+/// is read on engine init.
+void zego_fake_set_event_rate(enum zego_fake_event event, double per_second);
+
+/// Raises |count| events on the calling thread and returns how many callbacks were invoked,
+/// which is 0 when the callback is not registered or its feature is not enabled.
+unsigned int zego_fake_emit(enum zego_fake_event event, unsigned int count);
+
+/// Callbacks invoked for |event| since the engine was created, from either source.
+unsigned long long zego_fake_get_emitted(enum zego_fake_event event);
+
+/// How sends of real-time sequential data complete from now on. Every |fail_every|th send
+/// completes with ZEGO_FAKE_RTSD_ERROR, 0 for none. Completions still queued when the engine is
+/// destroyed are delivered before the engine uninit callback.
+void zego_fake_set_rtsd_completion(enum zego_fake_rtsd_completion mode, unsigned int fail_every);
+
+/// Completes the sends held so far on the calling thread, in send order or, when |reverse| is
+/// non-zero, newest first. Returns how many were completed.
+unsigned int zego_fake_release_rtsd(int reverse);
+
+/// Real-time sequential data sends accepted since the library was loaded.
+unsigned long long zego_fake_get_rtsd_sent(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ZEGO_EXPRESS_FAKE_H__
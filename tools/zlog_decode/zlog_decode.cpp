@@ -0,0 +1,100 @@
+// Decodes zlogger mmap segment logs (<base>.NNNNNN.zseg and <base>.tail) back into text.
+//
+// Build against the ZegoConnection headers and library, which provide the AES routines:
+//   c++ -std=c++11 -O2 -I<ZegoConnection.framework/Headers> zlog_decode.cpp -o zlog_decode <ZegoConnection library>
+// or, without the library, as the zlog_decode target of tools/connection_fake.
+//
+// Usage:
+//   zlog_decode [-k key] [-o out.log] <file or directory>...
+//
+// Directories are expanded to their .zseg and .tail files. Segments are decoded in name order, and a
+// .tail file only contributes blocks that were not already sealed into a segment.
+// Encrypted files are decrypted with the per-file nonce stored in their header.
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "zlogger/factory/factory_mmap_segment.h"
+
+namespace {
+
+bool HasSuffix(const std::string &s, const char *suffix) {
+    size_t n = strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+void CollectFiles(const std::string &path, std::vector<std::string> &segments,
+                  std::vector<std::string> &tails) {
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        if (DIR *dir = opendir(path.c_str())) {
+            while (struct dirent *entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (HasSuffix(name, ".zseg") || HasSuffix(name, ".tail")) {
+                    CollectFiles(path + "/" + name, segments, tails);
+                }
+            }
+            closedir(dir);
+        }
+        return;
+    }
+    (HasSuffix(path, ".tail") ? tails : segments).push_back(path);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::string key;
+    const char *output = nullptr;
+    std::vector<std::string> segments;
+    std::vector<std::string> tails;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            key = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            CollectFiles(argv[i], segments, tails);
+        }
+    }
+    if (segments.empty() && tails.empty()) {
+        fprintf(stderr, "usage: %s [-k key] [-o out.log] <file or directory>...\n", argv[0]);
+        return 2;
+    }
+    std::sort(segments.begin(), segments.end());
+    std::sort(tails.begin(), tails.end());
+
+    FILE *out = output ? fopen(output, "wb") : stdout;
+    if (!out) {
+        fprintf(stderr, "cannot open %s\n", output);
+        return 1;
+    }
+
+    int failures = 0;
+    uint64_t last_block_seq = 0;
+    std::string text;
+    for (const auto &files : {segments, tails}) {
+        for (const auto &file : files) {
+            std::string error;
+            text.clear();
+            uint64_t min_block_seq = last_block_seq + 1;
+            bool ok = zlogger::segment::decode_file(file, key, min_block_seq, text, last_block_seq,
+                                                    error);
+            fwrite(text.data(), 1, text.size(), out);
+            if (!ok || !error.empty()) {
+                fprintf(stderr, "%s: %s\n", file.c_str(), error.c_str());
+                failures++;
+            }
+        }
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    return failures == 0 ? 0 : 1;
+}